@@ -32,6 +32,12 @@
 #include "kernel/fcall.h"
 #include "kernel/operators.h"
 #include "kernel/exception.h"
+#include "kernel/concat.h"
+#include "kernel/time.h"
+
+#include <math.h>
+#include <float.h>
+#include <ext/standard/php_lcg.h>
 
 /**
  * Phalcon\Cache\Backend
@@ -50,16 +56,49 @@ PHP_METHOD(Phalcon_Cache_Backend, isStarted);
 PHP_METHOD(Phalcon_Cache_Backend, getLifetime);
 PHP_METHOD(Phalcon_Cache_Backend, setPrefix);
 PHP_METHOD(Phalcon_Cache_Backend, getPrefix);
+PHP_METHOD(Phalcon_Cache_Backend, getMultiple);
+PHP_METHOD(Phalcon_Cache_Backend, saveMultiple);
+PHP_METHOD(Phalcon_Cache_Backend, deleteMultiple);
+PHP_METHOD(Phalcon_Cache_Backend, getOrCompute);
+PHP_METHOD(Phalcon_Cache_Backend, getComputeStats);
+PHP_METHOD(Phalcon_Cache_Backend, _acquireLock);
+PHP_METHOD(Phalcon_Cache_Backend, _releaseLock);
+PHP_METHOD(Phalcon_Cache_Backend, saveTagged);
+PHP_METHOD(Phalcon_Cache_Backend, getTagged);
+PHP_METHOD(Phalcon_Cache_Backend, invalidateTags);
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_backend___construct, 0, 0, 1)
 	ZEND_ARG_INFO(0, frontend)
 	ZEND_ARG_TYPE_INFO(0, options, IS_ARRAY, 1)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_backend_savetagged, 0, 0, 3)
+	ZEND_ARG_INFO(0, keyName)
+	ZEND_ARG_INFO(0, content)
+	ZEND_ARG_TYPE_INFO(0, tags, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO(0, lifetime, IS_LONG, 1)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_backend_gettagged, 0, 0, 1)
+	ZEND_ARG_INFO(0, keyName)
+	ZEND_ARG_INFO(0, defaultValue)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_backend_invalidatetags, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, tags, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_backend_setprefix, 0, 0, 1)
 	ZEND_ARG_INFO(0, prefix)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_backend_getorcompute, 0, 0, 2)
+	ZEND_ARG_INFO(0, keyName)
+	ZEND_ARG_CALLABLE_INFO(0, computer, 0)
+	ZEND_ARG_TYPE_INFO(0, lifetime, IS_LONG, 1)
+	ZEND_ARG_TYPE_INFO(0, options, IS_ARRAY, 1)
+ZEND_END_ARG_INFO()
+
 static const zend_function_entry phalcon_cache_backend_method_entry[] = {
 	PHP_ME(Phalcon_Cache_Backend, __construct, arginfo_phalcon_cache_backend___construct, ZEND_ACC_PUBLIC|ZEND_ACC_CTOR)
 	PHP_ME(Phalcon_Cache_Backend, start, arginfo_phalcon_cache_backendinterface_start, ZEND_ACC_PUBLIC)
@@ -71,6 +110,16 @@ static const zend_function_entry phalcon_cache_backend_method_entry[] = {
 	PHP_ME(Phalcon_Cache_Backend, getLifetime, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend, setPrefix, arginfo_phalcon_cache_backend_setprefix, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend, getPrefix, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend, getMultiple, arginfo_phalcon_cache_backendinterface_getmultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend, saveMultiple, arginfo_phalcon_cache_backendinterface_savemultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend, deleteMultiple, arginfo_phalcon_cache_backendinterface_deletemultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend, getOrCompute, arginfo_phalcon_cache_backend_getorcompute, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend, getComputeStats, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend, _acquireLock, arginfo_phalcon_cache_backend__acquirelock, ZEND_ACC_PROTECTED)
+	PHP_ME(Phalcon_Cache_Backend, _releaseLock, arginfo_phalcon_cache_backend__releaselock, ZEND_ACC_PROTECTED)
+	PHP_ME(Phalcon_Cache_Backend, saveTagged, arginfo_phalcon_cache_backend_savetagged, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend, getTagged, arginfo_phalcon_cache_backend_gettagged, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend, invalidateTags, arginfo_phalcon_cache_backend_invalidatetags, ZEND_ACC_PUBLIC)
 	PHP_FE_END
 };
 
@@ -88,12 +137,113 @@ PHALCON_INIT_CLASS(Phalcon_Cache_Backend){
 	zend_declare_property_null(phalcon_cache_backend_ce, SL("_lastLifetime"), ZEND_ACC_PROTECTED);
 	zend_declare_property_bool(phalcon_cache_backend_ce, SL("_fresh"), 0, ZEND_ACC_PROTECTED);
 	zend_declare_property_bool(phalcon_cache_backend_ce, SL("_started"), 0, ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_cache_backend_ce, SL("_computeStats"), ZEND_ACC_PROTECTED);
 
 	zend_class_implements(phalcon_cache_backend_ce, 1, phalcon_cache_backendinterface_ce);
 
 	return SUCCESS;
 }
 
+/**
+ * Maps the prefixed keys to the keys passed to a *Multiple() method, prefixed key => key
+ */
+void phalcon_cache_backend_prefix_keys(zval *return_value, zval *prefix, zval *keys)
+{
+	zval *key_name;
+
+	array_init_size(return_value, zend_hash_num_elements(Z_ARRVAL_P(keys)));
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(keys), key_name) {
+		zval prefixed_key = {};
+
+		PHALCON_CONCAT_VV(&prefixed_key, prefix, key_name);
+		phalcon_array_update(return_value, &prefixed_key, key_name, PH_COPY);
+		zval_ptr_dtor(&prefixed_key);
+	} ZEND_HASH_FOREACH_END();
+}
+
+/**
+ * Prepares the contents passed to saveMultiple() in the frontend, prefixed key => prepared content.
+ * Numeric contents are stored as they are, like in save()
+ */
+int phalcon_cache_backend_encode_multiple(zval *return_value, zval *frontend, zval *prefix, zval *values)
+{
+	zval *content;
+	zend_string *str_key;
+	ulong idx;
+	int flag;
+
+	array_init_size(return_value, zend_hash_num_elements(Z_ARRVAL_P(values)));
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(values), idx, str_key, content) {
+		zval key_name = {}, prefixed_key = {}, prepared_content = {};
+
+		if (str_key) {
+			ZVAL_STR(&key_name, str_key);
+		} else {
+			ZVAL_LONG(&key_name, idx);
+		}
+
+		if (phalcon_is_numeric(content)) {
+			ZVAL_COPY(&prepared_content, content);
+		} else {
+			PHALCON_CALL_METHOD_FLAG(flag, &prepared_content, frontend, "beforestore", content);
+			if (flag == FAILURE) {
+				return FAILURE;
+			}
+		}
+
+		PHALCON_CONCAT_VV(&prefixed_key, prefix, &key_name);
+		phalcon_array_update(return_value, &prefixed_key, &prepared_content, 0);
+		zval_ptr_dtor(&prefixed_key);
+	} ZEND_HASH_FOREACH_END();
+
+	return SUCCESS;
+}
+
+/**
+ * Builds the result of getMultiple() from the contents read by prefixed key, the keys missing or read as
+ * false get the default value
+ */
+int phalcon_cache_backend_decode_multiple(zval *return_value, zval *frontend, zval *prefixed_keys, zval *contents, zval *default_value)
+{
+	zval *key_name;
+	zend_string *str_key;
+	ulong idx;
+	int flag;
+
+	array_init_size(return_value, zend_hash_num_elements(Z_ARRVAL_P(prefixed_keys)));
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(prefixed_keys), idx, str_key, key_name) {
+		zval cached_content = {}, content = {};
+		int found;
+
+		if (str_key) {
+			found = phalcon_array_isset_fetch_string(&cached_content, contents, str_key, PH_READONLY);
+		} else {
+			found = phalcon_array_isset_fetch_long(&cached_content, contents, idx, PH_READONLY);
+		}
+
+		if (!found || Z_TYPE(cached_content) == IS_NULL || PHALCON_IS_FALSE(&cached_content)) {
+			phalcon_array_update(return_value, key_name, default_value, PH_COPY);
+			continue;
+		}
+
+		if (phalcon_is_numeric(&cached_content)) {
+			phalcon_array_update(return_value, key_name, &cached_content, PH_COPY);
+			continue;
+		}
+
+		PHALCON_CALL_METHOD_FLAG(flag, &content, frontend, "afterretrieve", &cached_content);
+		if (flag == FAILURE) {
+			return FAILURE;
+		}
+		phalcon_array_update(return_value, key_name, &content, 0);
+	} ZEND_HASH_FOREACH_END();
+
+	return SUCCESS;
+}
+
 /**
  * Phalcon\Cache\Backend constructor
  *
@@ -268,3 +418,615 @@ PHP_METHOD(Phalcon_Cache_Backend, getPrefix){
 
 	RETURN_MEMBER(getThis(), "_prefix");
 }
+
+/**
+ * Returns the cached contents of several keys, as key => content, with $defaultValue for the
+ * missing keys. Adapters able to read several keys in one round trip override it
+ *
+ * @param array $keys
+ * @param mixed $defaultValue
+ * @return array
+ */
+PHP_METHOD(Phalcon_Cache_Backend, getMultiple){
+
+	zval *keys, *default_value = NULL, *key_name;
+
+	phalcon_fetch_params(0, 1, 1, &keys, &default_value);
+
+	if (!default_value) {
+		default_value = &PHALCON_GLOBAL(z_null);
+	}
+
+	array_init(return_value);
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(keys), key_name) {
+		zval content = {};
+
+		PHALCON_CALL_METHOD(&content, getThis(), "get", key_name);
+		if (Z_TYPE(content) == IS_NULL) {
+			phalcon_array_update(return_value, key_name, default_value, PH_COPY);
+		} else {
+			phalcon_array_update(return_value, key_name, &content, 0);
+		}
+	} ZEND_HASH_FOREACH_END();
+}
+
+/**
+ * Stores several contents at once, as key => content
+ *
+ * @param array $values
+ * @param long $lifetime
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend, saveMultiple){
+
+	zval *values, *lifetime = NULL, *content;
+	zend_string *str_key;
+	ulong idx;
+
+	phalcon_fetch_params(0, 1, 1, &values, &lifetime);
+
+	if (!lifetime) {
+		lifetime = &PHALCON_GLOBAL(z_null);
+	}
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(values), idx, str_key, content) {
+		zval key_name = {}, success = {};
+
+		if (str_key) {
+			ZVAL_STR(&key_name, str_key);
+		} else {
+			ZVAL_LONG(&key_name, idx);
+		}
+
+		PHALCON_CALL_METHOD(&success, getThis(), "save", &key_name, content, lifetime, &PHALCON_GLOBAL(z_false));
+		if (!zend_is_true(&success)) {
+			RETURN_FALSE;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	RETURN_TRUE;
+}
+
+/**
+ * Deletes several values from the cache by their keys, the keys not cached are ignored
+ *
+ * @param array $keys
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend, deleteMultiple){
+
+	zval *keys, *key_name;
+
+	phalcon_fetch_params(0, 1, 0, &keys);
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(keys), key_name) {
+		PHALCON_CALL_METHOD(NULL, getThis(), "delete", key_name);
+	} ZEND_HASH_FOREACH_END();
+
+	RETURN_TRUE;
+}
+
+/**
+ * Increments one of the counters returned by getComputeStats()
+ */
+static void phalcon_cache_backend_count(zval *backend, const char *name, uint name_length)
+{
+	zval stats = {}, count = {};
+
+	phalcon_read_property(&stats, backend, SL("_computeStats"), PH_READONLY);
+	if (Z_TYPE(stats) != IS_ARRAY || !phalcon_array_isset_fetch_str(&count, &stats, name, name_length, PH_READONLY)) {
+		ZVAL_LONG(&count, 0);
+	}
+
+	ZVAL_LONG(&count, phalcon_get_intval(&count) + 1);
+	phalcon_update_property_array_str(backend, SL("_computeStats"), name, name_length, &count);
+}
+
+/**
+ * Reads the value, the computation time and the logical expiration out of an entry stored by getOrCompute()
+ */
+static int phalcon_cache_backend_unwrap(zval *cached, zval *value, double *delta, double *expiry)
+{
+	zval computed = {}, expires = {};
+
+	if (Z_TYPE_P(cached) != IS_ARRAY
+		|| !phalcon_array_isset_fetch_long(value, cached, 0, PH_READONLY)
+		|| !phalcon_array_isset_fetch_long(&computed, cached, 1, PH_READONLY)
+		|| !phalcon_array_isset_fetch_long(&expires, cached, 2, PH_READONLY)) {
+		return 0;
+	}
+
+	*delta = phalcon_get_numberval(&computed);
+	*expiry = phalcon_get_numberval(&expires);
+	return 1;
+}
+
+/**
+ * Releases the regeneration lock keeping the exception thrown by the computer, if any
+ */
+static void phalcon_cache_backend_unlock(zval *backend, zval *lock_key, zval *token)
+{
+	zend_object *exception = EG(exception);
+	zval *params[] = { lock_key, token };
+
+	EG(exception) = NULL;
+	phalcon_call_method(NULL, backend, "_releaselock", 2, params);
+	if (exception) {
+		if (EG(exception)) {
+			zend_object_release(EG(exception));
+		}
+		EG(exception) = exception;
+	}
+}
+
+/**
+ * Returns a cached content or computes and stores it, protecting the key against cache stampedes.
+ *
+ * Entries are refreshed before they expire with a probability growing as the expiration gets
+ * closer and the computation gets slower (XFetch), only the worker holding the regeneration lock
+ * computes the content while the others wait for it or, inside the 'stale' window, keep serving
+ * the previous content. The lock holds a random token, a worker whose lock expired while computing
+ * doesn't release the lock taken since by another one. Entries are stored wrapped, so the frontend must be able to store arrays.
+ *
+ * Options:
+ *  - beta: weight of the early refresh, 0 disables it, 1 by default
+ *  - stale: seconds the previous content is served while another worker refreshes it, 0 by default
+ *  - lockLifetime: milliseconds the regeneration lock is held at most, 10000 by default
+ *  - wait: milliseconds to wait for another worker before computing without the lock, 3000 by default
+ *  - interval: milliseconds between two reads while waiting, 50 by default
+ *
+ *<code>
+ *	$robots = $cache->getOrCompute('robots', function () use ($db) {
+ *		return $db->fetchAll('SELECT * FROM robots');
+ *	}, 300, array('stale' => 30));
+ *</code>
+ *
+ * @param int|string $keyName
+ * @param callable $computer
+ * @param long $lifetime
+ * @param array $options
+ * @return mixed
+ */
+PHP_METHOD(Phalcon_Cache_Backend, getOrCompute){
+
+	zval *key_name, *computer, *lifetime = NULL, *options = NULL, ttl = {}, option = {}, lock_key = {}, lock_lifetime = {}, cached = {}, value = {};
+	zval content = {}, entry = {}, stored_lifetime = {}, acquired = {}, token = {}, token_type = {}, token_length = {};
+	double beta = 1.0, delta = 0, expiry = 0, now, start, deadline;
+	long stale = 0, wait = 3000, interval = 50;
+	int has_value, waited = 0, flag;
+
+	phalcon_fetch_params(0, 2, 2, &key_name, &computer, &lifetime, &options);
+
+	if (!phalcon_is_callable(computer)) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_cache_exception_ce, "The computer must be callable");
+		return;
+	}
+
+	if (!lifetime || Z_TYPE_P(lifetime) != IS_LONG) {
+		PHALCON_CALL_METHOD(&ttl, getThis(), "getlifetime");
+	} else {
+		ZVAL_COPY_VALUE(&ttl, lifetime);
+	}
+
+	ZVAL_LONG(&lock_lifetime, 10000);
+	if (options && Z_TYPE_P(options) == IS_ARRAY) {
+		if (phalcon_array_isset_fetch_str(&option, options, SL("beta"), PH_READONLY)) {
+			beta = phalcon_get_numberval(&option);
+		}
+		if (phalcon_array_isset_fetch_str(&option, options, SL("stale"), PH_READONLY)) {
+			stale = phalcon_get_intval(&option);
+		}
+		if (phalcon_array_isset_fetch_str(&option, options, SL("lockLifetime"), PH_READONLY)) {
+			ZVAL_LONG(&lock_lifetime, phalcon_get_intval(&option));
+		}
+		if (phalcon_array_isset_fetch_str(&option, options, SL("wait"), PH_READONLY)) {
+			wait = phalcon_get_intval(&option);
+		}
+		if (phalcon_array_isset_fetch_str(&option, options, SL("interval"), PH_READONLY)) {
+			interval = phalcon_get_intval(&option) > 0 ? phalcon_get_intval(&option) : 1;
+		}
+	}
+
+	PHALCON_CALL_METHOD(&cached, getThis(), "get", key_name);
+	has_value = phalcon_cache_backend_unwrap(&cached, &value, &delta, &expiry);
+
+	now = phalcon_get_microtime();
+	if (has_value) {
+		/**
+		 * XFetch: -log(rand) is exponentially distributed, so a slow computation is refreshed earlier
+		 */
+		double rnd = php_combined_lcg();
+		if (now - delta * beta * log(rnd > 0 ? rnd : DBL_MIN) < expiry) {
+			phalcon_cache_backend_count(getThis(), SL("hits"));
+			RETVAL_ZVAL(&value, 1, 0);
+			zval_ptr_dtor(&cached);
+			return;
+		}
+	} else {
+		phalcon_cache_backend_count(getThis(), SL("misses"));
+	}
+
+	PHALCON_CONCAT_VS(&lock_key, key_name, ":lock");
+
+	ZVAL_LONG(&token_type, PHALCON_RANDOM_ALNUM);
+	ZVAL_LONG(&token_length, 24);
+	phalcon_random_string(&token, &token_type, &token_length);
+
+	deadline = now + wait / 1000.0;
+	while (1) {
+		PHALCON_CALL_METHOD_FLAG(flag, &acquired, getThis(), "_acquirelock", &lock_key, &lock_lifetime, &token);
+		if (flag == FAILURE) {
+			zval_ptr_dtor(&cached);
+			zval_ptr_dtor(&lock_key);
+			zval_ptr_dtor(&token);
+			return;
+		}
+
+		if (zend_is_true(&acquired)) {
+			if (has_value && now < expiry) {
+				phalcon_cache_backend_count(getThis(), SL("earlyRefreshes"));
+			}
+			break;
+		}
+
+		/**
+		 * Another worker is refreshing the key, serve the previous content while it is allowed
+		 */
+		if (has_value && now < expiry + stale) {
+			if (now >= expiry) {
+				phalcon_cache_backend_count(getThis(), SL("staleServes"));
+			} else {
+				phalcon_cache_backend_count(getThis(), SL("hits"));
+			}
+			RETVAL_ZVAL(&value, 1, 0);
+			zval_ptr_dtor(&cached);
+			zval_ptr_dtor(&lock_key);
+			zval_ptr_dtor(&token);
+			return;
+		}
+
+		if (now >= deadline) {
+			phalcon_cache_backend_count(getThis(), SL("lockTimeouts"));
+			break;
+		}
+
+		if (!waited) {
+			phalcon_cache_backend_count(getThis(), SL("lockWaits"));
+			waited = 1;
+		}
+		usleep(interval * 1000);
+
+		zval_ptr_dtor(&cached);
+		PHALCON_CALL_METHOD_FLAG(flag, &cached, getThis(), "get", key_name);
+		if (flag == FAILURE) {
+			zval_ptr_dtor(&lock_key);
+			zval_ptr_dtor(&token);
+			return;
+		}
+
+		now = phalcon_get_microtime();
+		has_value = phalcon_cache_backend_unwrap(&cached, &value, &delta, &expiry);
+		if (has_value && now < expiry) {
+			phalcon_cache_backend_count(getThis(), SL("hits"));
+			RETVAL_ZVAL(&value, 1, 0);
+			zval_ptr_dtor(&cached);
+			zval_ptr_dtor(&lock_key);
+			zval_ptr_dtor(&token);
+			return;
+		}
+	}
+	zval_ptr_dtor(&cached);
+
+	start = phalcon_get_microtime();
+	PHALCON_CALL_USER_FUNC_FLAG(flag, &content, computer, key_name);
+	if (flag == FAILURE || EG(exception)) {
+		if (zend_is_true(&acquired)) {
+			phalcon_cache_backend_unlock(getThis(), &lock_key, &token);
+		}
+		zval_ptr_dtor(&content);
+		zval_ptr_dtor(&lock_key);
+		zval_ptr_dtor(&token);
+		return;
+	}
+	now = phalcon_get_microtime();
+
+	phalcon_cache_backend_count(getThis(), SL("computes"));
+
+	/**
+	 * The entry outlives its logical expiration by the stale window
+	 */
+	array_init_size(&entry, 3);
+	phalcon_array_append(&entry, &content, PH_COPY);
+	add_next_index_double(&entry, now - start);
+	add_next_index_double(&entry, now + phalcon_get_intval(&ttl));
+
+	ZVAL_LONG(&stored_lifetime, phalcon_get_intval(&ttl) + stale);
+	PHALCON_CALL_METHOD_FLAG(flag, NULL, getThis(), "save", key_name, &entry, &stored_lifetime, &PHALCON_GLOBAL(z_false));
+	zval_ptr_dtor(&entry);
+
+	if (zend_is_true(&acquired)) {
+		phalcon_cache_backend_unlock(getThis(), &lock_key, &token);
+	}
+	zval_ptr_dtor(&lock_key);
+	zval_ptr_dtor(&token);
+
+	if (flag == FAILURE) {
+		zval_ptr_dtor(&content);
+		return;
+	}
+
+	RETURN_ZVAL(&content, 0, 0);
+}
+
+/**
+ * Returns the counters of getOrCompute() for this instance: hits, misses, computes, earlyRefreshes,
+ * lockWaits, lockTimeouts and staleServes
+ *
+ * @return array
+ */
+PHP_METHOD(Phalcon_Cache_Backend, getComputeStats){
+
+	zval stats = {};
+
+	phalcon_read_property(&stats, getThis(), SL("_computeStats"), PH_READONLY);
+	if (Z_TYPE(stats) != IS_ARRAY) {
+		RETURN_EMPTY_ARRAY();
+	}
+
+	RETURN_CTOR(&stats);
+}
+
+/**
+ * Acquires the regeneration lock of getOrCompute(), the lock holds the token of its owner. Adapters
+ * with an atomic primitive override it, this implementation checks and sets the lock in two steps
+ *
+ * @param string $lockKey
+ * @param int $lifetime milliseconds
+ * @param string $token
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend, _acquireLock){
+
+	zval *lock_key, *lifetime, *token, exists = {}, seconds = {};
+
+	phalcon_fetch_params(0, 3, 0, &lock_key, &lifetime, &token);
+
+	PHALCON_CALL_METHOD(&exists, getThis(), "exists", lock_key);
+	if (zend_is_true(&exists)) {
+		RETURN_FALSE;
+	}
+
+	ZVAL_LONG(&seconds, (phalcon_get_intval(lifetime) + 999) / 1000);
+	PHALCON_CALL_METHOD(return_value, getThis(), "save", lock_key, token, &seconds, &PHALCON_GLOBAL(z_false));
+}
+
+/**
+ * Releases the regeneration lock of getOrCompute() if it still holds the token, a lock that expired
+ * and was taken by another worker is left alone. Adapters with an atomic primitive override it
+ *
+ * @param string $lockKey
+ * @param string $token
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend, _releaseLock){
+
+	zval *lock_key, *token, owner = {};
+
+	phalcon_fetch_params(0, 2, 0, &lock_key, &token);
+
+	PHALCON_CALL_METHOD(&owner, getThis(), "get", lock_key);
+	if (Z_TYPE_P(token) != IS_STRING || Z_TYPE(owner) != IS_STRING || !zend_string_equals(Z_STR(owner), Z_STR_P(token))) {
+		zval_ptr_dtor(&owner);
+		RETURN_FALSE;
+	}
+	zval_ptr_dtor(&owner);
+
+	PHALCON_RETURN_CALL_METHOD(getThis(), "delete", lock_key);
+}
+
+/**
+ * Reads the current versions of the tags, tag => version. With create the missing versions are
+ * initialized and stored, otherwise the missing tags are left out
+ */
+static int phalcon_cache_backend_tag_versions(zval *return_value, zval *backend, zval *tags, int create)
+{
+	zval tag_keys = {}, versions = {}, created = {}, *tag;
+	long now = (long)(phalcon_get_microtime() * 1000000);
+	int flag = SUCCESS;
+
+	array_init_size(&tag_keys, zend_hash_num_elements(Z_ARRVAL_P(tags)));
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(tags), tag) {
+		zval tag_key = {};
+		PHALCON_CONCAT_SV(&tag_key, PHALCON_CACHE_BACKEND_TAG_PREFIX, tag);
+		phalcon_array_append(&tag_keys, &tag_key, 0);
+	} ZEND_HASH_FOREACH_END();
+
+	/**
+	 * One round trip for all the tags on the adapters with a native getMultiple()
+	 */
+	PHALCON_CALL_METHOD_FLAG(flag, &versions, backend, "getmultiple", &tag_keys);
+	zval_ptr_dtor(&tag_keys);
+	if (flag == FAILURE) {
+		return FAILURE;
+	}
+
+	array_init(return_value);
+	array_init(&created);
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(tags), tag) {
+		zval tag_key = {}, version = {};
+
+		PHALCON_CONCAT_SV(&tag_key, PHALCON_CACHE_BACKEND_TAG_PREFIX, tag);
+		if (Z_TYPE(versions) == IS_ARRAY && phalcon_array_isset_fetch(&version, &versions, &tag_key, PH_READONLY) && Z_TYPE(version) > IS_FALSE) {
+			phalcon_array_update_zval_long(return_value, tag, phalcon_get_intval(&version), 0);
+		} else if (create) {
+			phalcon_array_update_zval_long(return_value, tag, now, 0);
+			phalcon_array_update_zval_long(&created, &tag_key, now, 0);
+		}
+		zval_ptr_dtor(&tag_key);
+	} ZEND_HASH_FOREACH_END();
+	zval_ptr_dtor(&versions);
+
+	if (zend_hash_num_elements(Z_ARRVAL(created))) {
+		zval lifetime = {};
+
+		ZVAL_LONG(&lifetime, PHALCON_CACHE_BACKEND_TAG_LIFETIME);
+		PHALCON_CALL_METHOD_FLAG(flag, NULL, backend, "savemultiple", &created, &lifetime);
+	}
+	zval_ptr_dtor(&created);
+
+	return flag;
+}
+
+/**
+ * Stores a content tagged with one or more tags, invalidateTags() invalidates it along with every
+ * content sharing one of its tags. The versions of the tags are stored with the content, so the
+ * frontend must be able to store arrays
+ *
+ *<code>
+ *	$cache->saveTagged('robot-1', $robot, array('robots', 'user-10'));
+ *	$cache->invalidateTags(array('robots'));
+ *	$cache->getTagged('robot-1'); // null
+ *</code>
+ *
+ * @param int|string $keyName
+ * @param mixed $content
+ * @param array $tags
+ * @param long $lifetime
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend, saveTagged){
+
+	zval *key_name, *content, *tags, *lifetime = NULL, versions = {}, entry = {};
+	int flag;
+
+	phalcon_fetch_params(0, 3, 1, &key_name, &content, &tags, &lifetime);
+
+	if (!lifetime) {
+		lifetime = &PHALCON_GLOBAL(z_null);
+	}
+
+	if (phalcon_cache_backend_tag_versions(&versions, getThis(), tags, 1) == FAILURE) {
+		zval_ptr_dtor(&versions);
+		return;
+	}
+
+	array_init_size(&entry, 2);
+	phalcon_array_append(&entry, content, PH_COPY);
+	phalcon_array_append(&entry, &versions, 0);
+
+	PHALCON_CALL_METHOD_FLAG(flag, return_value, getThis(), "save", key_name, &entry, lifetime, &PHALCON_GLOBAL(z_false));
+	zval_ptr_dtor(&entry);
+	if (flag == FAILURE) {
+		return;
+	}
+}
+
+/**
+ * Returns a content stored by saveTagged(), or $defaultValue when it is missing or one of its tags
+ * was invalidated after it was stored
+ *
+ * @param int|string $keyName
+ * @param mixed $defaultValue
+ * @return mixed
+ */
+PHP_METHOD(Phalcon_Cache_Backend, getTagged){
+
+	zval *key_name, *default_value = NULL, cached = {}, content = {}, stored = {}, tags = {}, versions = {}, *version;
+	zend_string *str_key;
+	ulong idx;
+	int fresh = 1;
+
+	phalcon_fetch_params(0, 1, 1, &key_name, &default_value);
+
+	if (!default_value) {
+		default_value = &PHALCON_GLOBAL(z_null);
+	}
+
+	PHALCON_CALL_METHOD(&cached, getThis(), "get", key_name);
+	if (Z_TYPE(cached) != IS_ARRAY
+		|| !phalcon_array_isset_fetch_long(&content, &cached, 0, PH_READONLY)
+		|| !phalcon_array_isset_fetch_long(&stored, &cached, 1, PH_READONLY)
+		|| Z_TYPE(stored) != IS_ARRAY) {
+		zval_ptr_dtor(&cached);
+		RETURN_CTOR(default_value);
+	}
+
+	phalcon_array_keys(&tags, &stored);
+	if (phalcon_cache_backend_tag_versions(&versions, getThis(), &tags, 0) == FAILURE) {
+		zval_ptr_dtor(&tags);
+		zval_ptr_dtor(&versions);
+		zval_ptr_dtor(&cached);
+		return;
+	}
+	zval_ptr_dtor(&tags);
+
+	/**
+	 * A tag invalidated or evicted since the content was stored makes it stale
+	 */
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(stored), idx, str_key, version) {
+		zval current = {};
+		int found;
+
+		if (str_key) {
+			found = phalcon_array_isset_fetch_string(&current, &versions, str_key, PH_READONLY);
+		} else {
+			found = phalcon_array_isset_fetch_long(&current, &versions, idx, PH_READONLY);
+		}
+
+		if (!found || phalcon_get_intval(&current) != phalcon_get_intval(version)) {
+			fresh = 0;
+			break;
+		}
+	} ZEND_HASH_FOREACH_END();
+	zval_ptr_dtor(&versions);
+
+	if (fresh) {
+		RETVAL_ZVAL(&content, 1, 0);
+	} else {
+		RETVAL_ZVAL(default_value, 1, 0);
+	}
+	zval_ptr_dtor(&cached);
+}
+
+/**
+ * Invalidates every content stored by saveTagged() with one of the tags, bumping the version of each
+ * tag instead of deleting the contents
+ *
+ * @param array $tags
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend, invalidateTags){
+
+	zval *tags, versions = {}, bumped = {}, lifetime = {}, *tag;
+	long now;
+
+	phalcon_fetch_params(0, 1, 0, &tags);
+
+	if (phalcon_cache_backend_tag_versions(&versions, getThis(), tags, 0) == FAILURE) {
+		zval_ptr_dtor(&versions);
+		return;
+	}
+
+	now = (long)(phalcon_get_microtime() * 1000000);
+
+	array_init_size(&bumped, zend_hash_num_elements(Z_ARRVAL_P(tags)));
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(tags), tag) {
+		zval tag_key = {}, version = {};
+		long next = now;
+
+		if (phalcon_array_isset_fetch(&version, &versions, tag, PH_READONLY) && phalcon_get_intval(&version) >= now) {
+			next = phalcon_get_intval(&version) + 1;
+		}
+
+		PHALCON_CONCAT_SV(&tag_key, PHALCON_CACHE_BACKEND_TAG_PREFIX, tag);
+		phalcon_array_update_zval_long(&bumped, &tag_key, next, 0);
+		zval_ptr_dtor(&tag_key);
+	} ZEND_HASH_FOREACH_END();
+	zval_ptr_dtor(&versions);
+
+	ZVAL_LONG(&lifetime, PHALCON_CACHE_BACKEND_TAG_LIFETIME);
+	PHALCON_CALL_METHOD(return_value, getThis(), "savemultiple", &bumped, &lifetime);
+	zval_ptr_dtor(&bumped);
+}
@@ -24,6 +24,24 @@
 
 extern zend_class_entry *phalcon_cache_backend_ce;
 
+#define PHALCON_CACHE_BACKEND_TAG_PREFIX "_PHCT"
+#define PHALCON_CACHE_BACKEND_TAG_LIFETIME 2592000
+
+void phalcon_cache_backend_prefix_keys(zval *return_value, zval *prefix, zval *keys);
+int phalcon_cache_backend_encode_multiple(zval *return_value, zval *frontend, zval *prefix, zval *values);
+int phalcon_cache_backend_decode_multiple(zval *return_value, zval *frontend, zval *prefixed_keys, zval *contents, zval *default_value);
+
 PHALCON_INIT_CLASS(Phalcon_Cache_Backend);
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_backend__acquirelock, 0, 0, 3)
+	ZEND_ARG_INFO(0, lockKey)
+	ZEND_ARG_TYPE_INFO(0, lifetime, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO(0, token, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_backend__releaselock, 0, 0, 2)
+	ZEND_ARG_INFO(0, lockKey)
+	ZEND_ARG_TYPE_INFO(0, token, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
 #endif /* PHALCON_CACHE_BACKEND_H */
@@ -76,6 +76,9 @@ PHP_METHOD(Phalcon_Cache_Backend_Lmdb, __construct);
 PHP_METHOD(Phalcon_Cache_Backend_Lmdb, get);
 PHP_METHOD(Phalcon_Cache_Backend_Lmdb, save);
 PHP_METHOD(Phalcon_Cache_Backend_Lmdb, delete);
+PHP_METHOD(Phalcon_Cache_Backend_Lmdb, getMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Lmdb, saveMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Lmdb, deleteMultiple);
 PHP_METHOD(Phalcon_Cache_Backend_Lmdb, queryKeys);
 PHP_METHOD(Phalcon_Cache_Backend_Lmdb, exists);
 PHP_METHOD(Phalcon_Cache_Backend_Lmdb, increment);
@@ -92,6 +95,9 @@ static const zend_function_entry phalcon_cache_backend_lmdb_method_entry[] = {
 	PHP_ME(Phalcon_Cache_Backend_Lmdb, get, arginfo_phalcon_cache_backendinterface_get, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Lmdb, save, arginfo_phalcon_cache_backendinterface_save, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Lmdb, delete, arginfo_phalcon_cache_backendinterface_delete, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Lmdb, getMultiple, arginfo_phalcon_cache_backendinterface_getmultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Lmdb, saveMultiple, arginfo_phalcon_cache_backendinterface_savemultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Lmdb, deleteMultiple, arginfo_phalcon_cache_backendinterface_deletemultiple, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Lmdb, queryKeys, arginfo_phalcon_cache_backendinterface_querykeys, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Lmdb, exists, arginfo_phalcon_cache_backendinterface_exists, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Lmdb, increment, arginfo_phalcon_cache_backendinterface_increment, ZEND_ACC_PUBLIC)
@@ -315,6 +321,203 @@ PHP_METHOD(Phalcon_Cache_Backend_Lmdb, delete){
 	PHALCON_CALL_METHOD(NULL, &lmdb, "commit");
 }
 
+/**
+ * Returns the cached contents of several keys, read inside a single transaction
+ *
+ * @param array $keys
+ * @param mixed $defaultValue
+ * @return array
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Lmdb, getMultiple){
+
+	zval *keys, *default_value = NULL, lmdb = {}, frontend = {}, *key_name;
+	long now;
+
+	phalcon_fetch_params(0, 1, 1, &keys, &default_value);
+
+	if (!default_value) {
+		default_value = &PHALCON_GLOBAL(z_null);
+	}
+
+	phalcon_read_property(&lmdb, getThis(), SL("_lmdb"), PH_READONLY);
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+
+	array_init(return_value);
+
+	now = (long)time(NULL);
+
+	PHALCON_CALL_METHOD(NULL, &lmdb, "begin");
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(keys), key_name) {
+		zval cached_content = {}, val = {}, expired = {}, content = {};
+		int flag;
+
+		PHALCON_CALL_METHOD_FLAG(flag, &cached_content, &lmdb, "get", key_name);
+		if (flag == FAILURE) {
+			break;
+		}
+
+		if (Z_TYPE(cached_content) != IS_ARRAY || !phalcon_array_isset_fetch_long(&val, &cached_content, 0, PH_READONLY)) {
+			phalcon_array_update(return_value, key_name, default_value, PH_COPY);
+			zval_ptr_dtor(&cached_content);
+			continue;
+		}
+
+		if (phalcon_array_isset_fetch_long(&expired, &cached_content, 1, PH_READONLY) && phalcon_get_intval(&expired) < now) {
+			PHALCON_CALL_METHOD_FLAG(flag, NULL, &lmdb, "delete", key_name);
+			if (flag == FAILURE) {
+				zval_ptr_dtor(&cached_content);
+				break;
+			}
+		}
+
+		if (PHALCON_IS_NOT_EMPTY(&val)) {
+			PHALCON_CALL_METHOD_FLAG(flag, &content, &frontend, "afterretrieve", &val);
+			if (flag == FAILURE) {
+				zval_ptr_dtor(&cached_content);
+				break;
+			}
+			phalcon_array_update(return_value, key_name, &content, 0);
+		} else {
+			phalcon_array_update(return_value, key_name, &val, PH_COPY);
+		}
+		zval_ptr_dtor(&cached_content);
+	} ZEND_HASH_FOREACH_END();
+
+	if (EG(exception)) {
+		zend_object *exception = EG(exception);
+		EG(exception) = NULL;
+		phalcon_call_method(NULL, &lmdb, "commit", 0, NULL);
+		if (EG(exception)) {
+			zend_object_release(EG(exception));
+		}
+		EG(exception) = exception;
+		return;
+	}
+	PHALCON_CALL_METHOD(NULL, &lmdb, "commit");
+}
+
+/**
+ * Stores several contents at once inside a single transaction
+ *
+ * @param array $values
+ * @param long $lifetime
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Lmdb, saveMultiple){
+
+	zval *values, *lifetime = NULL, lmdb = {}, frontend = {}, ttl = {}, items = {}, *content, *cached_content;
+	zend_string *str_key;
+	ulong idx;
+	long now_time;
+	int flag;
+
+	phalcon_fetch_params(0, 1, 1, &values, &lifetime);
+
+	if (!lifetime || Z_TYPE_P(lifetime) != IS_LONG) {
+		PHALCON_CALL_METHOD(&ttl, getThis(), "getlifetime");
+	} else {
+		ZVAL_COPY_VALUE(&ttl, lifetime);
+	}
+	now_time = (long)time(NULL);
+
+	phalcon_read_property(&lmdb, getThis(), SL("_lmdb"), PH_READONLY);
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+
+	/**
+	 * Prepare every content in the frontend before the write transaction is opened
+	 */
+	array_init_size(&items, zend_hash_num_elements(Z_ARRVAL_P(values)));
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(values), idx, str_key, content) {
+		zval prepared_val = {}, item = {};
+
+		PHALCON_CALL_METHOD_FLAG(flag, &prepared_val, &frontend, "beforestore", content);
+		if (flag == FAILURE) {
+			zval_ptr_dtor(&items);
+			return;
+		}
+
+		array_init_size(&item, 3);
+		phalcon_array_append(&item, &prepared_val, 0);
+		phalcon_array_append_long(&item, now_time + phalcon_get_intval(&ttl), 0);
+		phalcon_array_append_long(&item, now_time, 0);
+
+		if (str_key) {
+			phalcon_array_update_string(&items, str_key, &item, 0);
+		} else {
+			phalcon_array_update_long(&items, idx, &item, 0);
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	PHALCON_CALL_METHOD(NULL, &lmdb, "begin");
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(items), idx, str_key, cached_content) {
+		zval key_name = {}, success = {};
+
+		if (str_key) {
+			ZVAL_STR(&key_name, str_key);
+		} else {
+			ZVAL_LONG(&key_name, idx);
+		}
+
+		PHALCON_CALL_METHOD_FLAG(flag, &success, &lmdb, "put", &key_name, cached_content);
+		if (flag == FAILURE || !zend_is_true(&success)) {
+			zend_object *exception = EG(exception);
+			EG(exception) = NULL;
+			phalcon_call_method(NULL, &lmdb, "commit", 0, NULL);
+			if (EG(exception)) {
+				zend_object_release(EG(exception));
+			}
+			EG(exception) = exception;
+			zval_ptr_dtor(&items);
+			if (!exception) {
+				PHALCON_THROW_EXCEPTION_STR(phalcon_cache_exception_ce, "Failed to store data in lmdb");
+			}
+			return;
+		}
+	} ZEND_HASH_FOREACH_END();
+	zval_ptr_dtor(&items);
+
+	PHALCON_CALL_METHOD(NULL, &lmdb, "commit");
+	RETURN_TRUE;
+}
+
+/**
+ * Deletes several values from the cache by their keys inside a single transaction
+ *
+ * @param array $keys
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Lmdb, deleteMultiple){
+
+	zval *keys, lmdb = {}, *key_name;
+	int flag = SUCCESS;
+
+	phalcon_fetch_params(0, 1, 0, &keys);
+
+	phalcon_read_property(&lmdb, getThis(), SL("_lmdb"), PH_READONLY);
+
+	PHALCON_CALL_METHOD(NULL, &lmdb, "begin");
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(keys), key_name) {
+		PHALCON_CALL_METHOD_FLAG(flag, NULL, &lmdb, "delete", key_name);
+		if (flag == FAILURE) {
+			break;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	if (flag == FAILURE) {
+		zend_object *exception = EG(exception);
+		EG(exception) = NULL;
+		phalcon_call_method(NULL, &lmdb, "commit", 0, NULL);
+		if (EG(exception)) {
+			zend_object_release(EG(exception));
+		}
+		EG(exception) = exception;
+		return;
+	}
+
+	PHALCON_CALL_METHOD(NULL, &lmdb, "commit");
+	RETURN_TRUE;
+}
+
 /**
  * Query the existing cached keys
  *
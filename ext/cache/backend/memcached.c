@@ -78,6 +78,11 @@ PHP_METHOD(Phalcon_Cache_Backend_Memcached, _connect);
 PHP_METHOD(Phalcon_Cache_Backend_Memcached, get);
 PHP_METHOD(Phalcon_Cache_Backend_Memcached, save);
 PHP_METHOD(Phalcon_Cache_Backend_Memcached, delete);
+PHP_METHOD(Phalcon_Cache_Backend_Memcached, getMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Memcached, saveMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Memcached, deleteMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Memcached, _acquireLock);
+PHP_METHOD(Phalcon_Cache_Backend_Memcached, _releaseLock);
 PHP_METHOD(Phalcon_Cache_Backend_Memcached, queryKeys);
 PHP_METHOD(Phalcon_Cache_Backend_Memcached, exists);
 PHP_METHOD(Phalcon_Cache_Backend_Memcached, increment);
@@ -101,6 +106,11 @@ static const zend_function_entry phalcon_cache_backend_memcached_method_entry[]
 	PHP_ME(Phalcon_Cache_Backend_Memcached, get, arginfo_phalcon_cache_backendinterface_get, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Memcached, save, arginfo_phalcon_cache_backendinterface_save, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Memcached, delete, arginfo_phalcon_cache_backendinterface_delete, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Memcached, getMultiple, arginfo_phalcon_cache_backendinterface_getmultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Memcached, saveMultiple, arginfo_phalcon_cache_backendinterface_savemultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Memcached, deleteMultiple, arginfo_phalcon_cache_backendinterface_deletemultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Memcached, _acquireLock, arginfo_phalcon_cache_backend__acquirelock, ZEND_ACC_PROTECTED)
+	PHP_ME(Phalcon_Cache_Backend_Memcached, _releaseLock, arginfo_phalcon_cache_backend__releaselock, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Cache_Backend_Memcached, queryKeys, arginfo_phalcon_cache_backendinterface_querykeys, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Memcached, exists, arginfo_phalcon_cache_backendinterface_exists, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Memcached, increment, arginfo_phalcon_cache_backendinterface_increment, ZEND_ACC_PUBLIC)
@@ -476,6 +486,252 @@ PHP_METHOD(Phalcon_Cache_Backend_Memcached, delete){
 	zval_ptr_dtor(&memcache);
 }
 
+/**
+ * Returns the cached contents of several keys with a single Memcached::getMulti()
+ *
+ * @param array $keys
+ * @param mixed $defaultValue
+ * @return array
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Memcached, getMultiple){
+
+	zval *keys, *default_value = NULL, memcache = {}, frontend = {}, prefix = {}, prefixed_keys = {}, list = {}, contents = {};
+
+	phalcon_fetch_params(1, 1, 1, &keys, &default_value);
+
+	if (!default_value) {
+		default_value = &PHALCON_GLOBAL(z_null);
+	}
+
+	phalcon_read_property(&memcache, getThis(), SL("_memcache"), PH_READONLY);
+	if (Z_TYPE(memcache) != IS_OBJECT) {
+		PHALCON_MM_CALL_METHOD(&memcache, getThis(), "_connect");
+		PHALCON_MM_ADD_ENTRY(&memcache);
+	}
+
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+
+	phalcon_cache_backend_prefix_keys(&prefixed_keys, &prefix, keys);
+	PHALCON_MM_ADD_ENTRY(&prefixed_keys);
+
+	if (!zend_hash_num_elements(Z_ARRVAL(prefixed_keys))) {
+		RETURN_MM_EMPTY_ARRAY();
+	}
+
+	phalcon_array_keys(&list, &prefixed_keys);
+	PHALCON_MM_ADD_ENTRY(&list);
+
+	PHALCON_MM_CALL_METHOD(&contents, &memcache, "getmulti", &list);
+	PHALCON_MM_ADD_ENTRY(&contents);
+	if (Z_TYPE(contents) != IS_ARRAY) {
+		array_init(&contents);
+	}
+
+	phalcon_cache_backend_decode_multiple(return_value, &frontend, &prefixed_keys, &contents, default_value);
+	RETURN_MM();
+}
+
+/**
+ * Stores several contents at once with a single Memcached::setMulti()
+ *
+ * @param array $values
+ * @param long $lifetime
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Memcached, saveMultiple){
+
+	zval *values, *lifetime = NULL, memcache = {}, frontend = {}, prefix = {}, ttl = {}, prepared_contents = {}, success = {};
+	zval options = {}, special_key = {}, keys = {};
+	zend_string *str_key;
+	ulong idx;
+
+	phalcon_fetch_params(1, 1, 1, &values, &lifetime);
+
+	if (!zend_hash_num_elements(Z_ARRVAL_P(values))) {
+		RETURN_MM_TRUE;
+	}
+
+	phalcon_read_property(&memcache, getThis(), SL("_memcache"), PH_READONLY);
+	if (Z_TYPE(memcache) != IS_OBJECT) {
+		PHALCON_MM_CALL_METHOD(&memcache, getThis(), "_connect");
+		PHALCON_MM_ADD_ENTRY(&memcache);
+	}
+
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+
+	if (!lifetime || Z_TYPE_P(lifetime) != IS_LONG) {
+		PHALCON_MM_CALL_METHOD(&ttl, getThis(), "getlifetime");
+		PHALCON_MM_ADD_ENTRY(&ttl);
+	} else {
+		ZVAL_COPY_VALUE(&ttl, lifetime);
+	}
+
+	if (phalcon_cache_backend_encode_multiple(&prepared_contents, &frontend, &prefix, values) == FAILURE) {
+		zval_ptr_dtor(&prepared_contents);
+		RETURN_MM();
+	}
+	PHALCON_MM_ADD_ENTRY(&prepared_contents);
+
+	PHALCON_MM_CALL_METHOD(&success, &memcache, "setmulti", &prepared_contents, &ttl);
+	PHALCON_MM_ADD_ENTRY(&success);
+
+	if (!zend_is_true(&success)) {
+		PHALCON_MM_THROW_EXCEPTION_STR(phalcon_cache_exception_ce, "Failed storing data in memcached");
+		return;
+	}
+
+	phalcon_read_property(&options, getThis(), SL("_options"), PH_READONLY);
+
+	if (phalcon_array_isset_fetch_str(&special_key, &options, SL("statsKey"), PH_READONLY) && PHALCON_IS_NOT_EMPTY_STRING(&special_key)) {
+		/* Update the stats key once for every key */
+		PHALCON_MM_CALL_METHOD(&keys, &memcache, "get", &special_key);
+		PHALCON_MM_ADD_ENTRY(&keys);
+		if (Z_TYPE(keys) != IS_ARRAY) {
+			array_init(&keys);
+			PHALCON_MM_ADD_ENTRY(&keys);
+		}
+
+		ZEND_HASH_FOREACH_KEY(Z_ARRVAL(prepared_contents), idx, str_key) {
+			if (str_key) {
+				phalcon_array_update_string(&keys, str_key, &ttl, PH_COPY);
+			} else {
+				phalcon_array_update_long(&keys, idx, &ttl, PH_COPY);
+			}
+		} ZEND_HASH_FOREACH_END();
+
+		PHALCON_MM_CALL_METHOD(NULL, &memcache, "set", &special_key, &keys);
+	}
+
+	RETURN_MM_TRUE;
+}
+
+/**
+ * Deletes several values from the cache by their keys with a single Memcached::deleteMulti()
+ *
+ * @param array $keys
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Memcached, deleteMultiple){
+
+	zval *keys, memcache = {}, prefix = {}, prefixed_keys = {}, list = {}, options = {}, special_key = {}, tracked_keys = {}, *prefixed_key;
+
+	phalcon_fetch_params(1, 1, 0, &keys);
+
+	if (!zend_hash_num_elements(Z_ARRVAL_P(keys))) {
+		RETURN_MM_TRUE;
+	}
+
+	phalcon_read_property(&memcache, getThis(), SL("_memcache"), PH_READONLY);
+	if (Z_TYPE(memcache) != IS_OBJECT) {
+		PHALCON_MM_CALL_METHOD(&memcache, getThis(), "_connect");
+		PHALCON_MM_ADD_ENTRY(&memcache);
+	}
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+
+	phalcon_cache_backend_prefix_keys(&prefixed_keys, &prefix, keys);
+	PHALCON_MM_ADD_ENTRY(&prefixed_keys);
+
+	phalcon_array_keys(&list, &prefixed_keys);
+	PHALCON_MM_ADD_ENTRY(&list);
+
+	phalcon_read_property(&options, getThis(), SL("_options"), PH_READONLY);
+
+	if (phalcon_array_isset_fetch_str(&special_key, &options, SL("statsKey"), PH_READONLY) && PHALCON_IS_NOT_EMPTY_STRING(&special_key)) {
+		PHALCON_MM_CALL_METHOD(&tracked_keys, &memcache, "get", &special_key);
+		PHALCON_MM_ADD_ENTRY(&tracked_keys);
+		if (Z_TYPE(tracked_keys) == IS_ARRAY) {
+			ZEND_HASH_FOREACH_VAL(Z_ARRVAL(list), prefixed_key) {
+				phalcon_array_unset(&tracked_keys, prefixed_key, 0);
+			} ZEND_HASH_FOREACH_END();
+			PHALCON_MM_CALL_METHOD(NULL, &memcache, "set", &special_key, &tracked_keys);
+		}
+	}
+
+	/* Keys not found are reported per key, they are not a failure */
+	PHALCON_MM_CALL_METHOD(NULL, &memcache, "deletemulti", &list);
+	RETURN_MM_TRUE;
+}
+
+/**
+ * Acquires the regeneration lock of getOrCompute() with Memcached::add(), the lock holds the token
+ *
+ * @param string $lockKey
+ * @param int $lifetime milliseconds
+ * @param string $token
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Memcached, _acquireLock){
+
+	zval *lock_key, *lifetime, *token, memcache = {}, prefix = {}, prefixed_key = {}, seconds = {};
+
+	phalcon_fetch_params(0, 3, 0, &lock_key, &lifetime, &token);
+
+	phalcon_read_property(&memcache, getThis(), SL("_memcache"), PH_COPY);
+	if (Z_TYPE(memcache) != IS_OBJECT) {
+		PHALCON_CALL_METHOD(&memcache, getThis(), "_connect");
+	}
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+
+	PHALCON_CONCAT_VV(&prefixed_key, &prefix, lock_key);
+
+	/**
+	 * Memcached expirations have a granularity of one second
+	 */
+	ZVAL_LONG(&seconds, (phalcon_get_intval(lifetime) + 999) / 1000);
+
+	PHALCON_RETURN_CALL_METHOD(&memcache, "add", &prefixed_key, token, &seconds);
+	zval_ptr_dtor(&prefixed_key);
+	zval_ptr_dtor(&memcache);
+}
+
+/**
+ * Releases the regeneration lock of getOrCompute() if it still holds the token. The lock is expired
+ * with Memcached::cas(), it fails if another worker took the lock since it was read
+ *
+ * @param string $lockKey
+ * @param string $token
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Memcached, _releaseLock){
+
+	zval *lock_key, *token, memcache = {}, prefix = {}, prefixed_key = {}, flags = {}, lock = {}, owner = {}, cas = {}, expired = {};
+
+	phalcon_fetch_params(0, 2, 0, &lock_key, &token);
+
+	phalcon_read_property(&memcache, getThis(), SL("_memcache"), PH_COPY);
+	if (Z_TYPE(memcache) != IS_OBJECT) {
+		PHALCON_CALL_METHOD(&memcache, getThis(), "_connect");
+	}
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+
+	PHALCON_CONCAT_VV(&prefixed_key, &prefix, lock_key);
+
+	phalcon_get_class_constant(&flags, Z_OBJCE(memcache), SL("GET_EXTENDED"));
+
+	PHALCON_CALL_METHOD(&lock, &memcache, "get", &prefixed_key, &PHALCON_GLOBAL(z_null), &flags);
+
+	RETVAL_FALSE;
+	if (phalcon_array_isset_fetch_str(&owner, &lock, SL("value"), PH_READONLY)
+		&& phalcon_array_isset_fetch_str(&cas, &lock, SL("cas"), PH_READONLY)
+		&& Z_TYPE_P(token) == IS_STRING && Z_TYPE(owner) == IS_STRING && zend_string_equals(Z_STR(owner), Z_STR_P(token))
+	) {
+		/**
+		 * A negative expiration expires the item right away
+		 */
+		ZVAL_LONG(&expired, -1);
+		PHALCON_CALL_METHOD(return_value, &memcache, "cas", &cas, &prefixed_key, token, &expired);
+	}
+
+	zval_ptr_dtor(&lock);
+	zval_ptr_dtor(&prefixed_key);
+	zval_ptr_dtor(&memcache);
+}
+
 /**
  * Query the existing cached keys
  *
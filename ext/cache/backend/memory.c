@@ -55,6 +55,9 @@ zend_class_entry *phalcon_cache_backend_memory_ce;
 PHP_METHOD(Phalcon_Cache_Backend_Memory, get);
 PHP_METHOD(Phalcon_Cache_Backend_Memory, save);
 PHP_METHOD(Phalcon_Cache_Backend_Memory, delete);
+PHP_METHOD(Phalcon_Cache_Backend_Memory, getMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Memory, saveMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Memory, deleteMultiple);
 PHP_METHOD(Phalcon_Cache_Backend_Memory, queryKeys);
 PHP_METHOD(Phalcon_Cache_Backend_Memory, exists);
 PHP_METHOD(Phalcon_Cache_Backend_Memory, increment);
@@ -65,6 +68,9 @@ static const zend_function_entry phalcon_cache_backend_memory_method_entry[] = {
 	PHP_ME(Phalcon_Cache_Backend_Memory, get, arginfo_phalcon_cache_backendinterface_get, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Memory, save, arginfo_phalcon_cache_backendinterface_save, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Memory, delete, arginfo_phalcon_cache_backendinterface_delete, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Memory, getMultiple, arginfo_phalcon_cache_backendinterface_getmultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Memory, saveMultiple, arginfo_phalcon_cache_backendinterface_savemultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Memory, deleteMultiple, arginfo_phalcon_cache_backendinterface_deletemultiple, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Memory, queryKeys, arginfo_phalcon_cache_backendinterface_querykeys, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Memory, exists, arginfo_phalcon_cache_backendinterface_exists, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Memory, increment, arginfo_phalcon_cache_backendinterface_increment, ZEND_ACC_PUBLIC)
@@ -201,6 +207,113 @@ PHP_METHOD(Phalcon_Cache_Backend_Memory, delete){
 	zval_ptr_dtor(&key);
 }
 
+/**
+ * Returns the cached contents of several keys
+ *
+ * @param array $keys
+ * @param mixed $defaultValue
+ * @return array
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Memory, getMultiple){
+
+	zval *keys, *default_value = NULL, prefix = {}, prefixed_keys = {}, data = {}, frontend = {};
+
+	phalcon_fetch_params(0, 1, 1, &keys, &default_value);
+
+	if (!default_value) {
+		default_value = &PHALCON_GLOBAL(z_null);
+	}
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+	phalcon_read_property(&data, getThis(), SL("_data"), PH_READONLY);
+
+	phalcon_cache_backend_prefix_keys(&prefixed_keys, &prefix, keys);
+
+	if (Z_TYPE(data) == IS_ARRAY) {
+		phalcon_cache_backend_decode_multiple(return_value, &frontend, &prefixed_keys, &data, default_value);
+	} else {
+		zval empty = {};
+		array_init(&empty);
+		phalcon_cache_backend_decode_multiple(return_value, &frontend, &prefixed_keys, &empty, default_value);
+		zval_ptr_dtor(&empty);
+	}
+	zval_ptr_dtor(&prefixed_keys);
+}
+
+/**
+ * Stores several contents at once
+ *
+ * @param array $values
+ * @param long $lifetime
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Memory, saveMultiple){
+
+	zval *values, *lifetime = NULL, prefix = {}, frontend = {}, prepared_contents = {}, *prepared_content;
+	zend_string *str_key;
+	ulong idx;
+
+	phalcon_fetch_params(0, 1, 1, &values, &lifetime);
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+
+	if (phalcon_cache_backend_encode_multiple(&prepared_contents, &frontend, &prefix, values) == FAILURE) {
+		zval_ptr_dtor(&prepared_contents);
+		return;
+	}
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(prepared_contents), idx, str_key, prepared_content) {
+		zval prefixed_key = {};
+		if (str_key) {
+			ZVAL_STR(&prefixed_key, str_key);
+		} else {
+			ZVAL_LONG(&prefixed_key, idx);
+		}
+		phalcon_update_property_array(getThis(), SL("_data"), &prefixed_key, prepared_content);
+	} ZEND_HASH_FOREACH_END();
+	zval_ptr_dtor(&prepared_contents);
+
+	RETURN_TRUE;
+}
+
+/**
+ * Deletes several values from the cache by their keys
+ *
+ * @param array $keys
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Memory, deleteMultiple){
+
+	zval *keys, prefix = {}, prefixed_keys = {}, data = {};
+	zend_string *str_key;
+	ulong idx;
+
+	phalcon_fetch_params(0, 1, 0, &keys);
+
+	phalcon_read_property(&data, getThis(), SL("_data"), PH_READONLY);
+	if (Z_TYPE(data) != IS_ARRAY) {
+		RETURN_TRUE;
+	}
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+	phalcon_cache_backend_prefix_keys(&prefixed_keys, &prefix, keys);
+
+	ZEND_HASH_FOREACH_KEY(Z_ARRVAL(prefixed_keys), idx, str_key) {
+		zval prefixed_key = {};
+		if (str_key) {
+			ZVAL_STR(&prefixed_key, str_key);
+		} else {
+			ZVAL_LONG(&prefixed_key, idx);
+		}
+		phalcon_unset_property_array(getThis(), SL("_data"), &prefixed_key);
+	} ZEND_HASH_FOREACH_END();
+	zval_ptr_dtor(&prefixed_keys);
+
+	RETURN_TRUE;
+}
+
 /**
  * Query the existing cached keys
  *
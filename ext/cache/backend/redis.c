@@ -73,6 +73,11 @@ PHP_METHOD(Phalcon_Cache_Backend_Redis, _connect);
 PHP_METHOD(Phalcon_Cache_Backend_Redis, get);
 PHP_METHOD(Phalcon_Cache_Backend_Redis, save);
 PHP_METHOD(Phalcon_Cache_Backend_Redis, delete);
+PHP_METHOD(Phalcon_Cache_Backend_Redis, getMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Redis, saveMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Redis, deleteMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Redis, _acquireLock);
+PHP_METHOD(Phalcon_Cache_Backend_Redis, _releaseLock);
 PHP_METHOD(Phalcon_Cache_Backend_Redis, queryKeys);
 PHP_METHOD(Phalcon_Cache_Backend_Redis, exists);
 PHP_METHOD(Phalcon_Cache_Backend_Redis, increment);
@@ -97,6 +102,11 @@ static const zend_function_entry phalcon_cache_backend_redis_method_entry[] = {
 	PHP_ME(Phalcon_Cache_Backend_Redis, get, arginfo_phalcon_cache_backendinterface_get, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Redis, save, arginfo_phalcon_cache_backendinterface_save, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Redis, delete, arginfo_phalcon_cache_backendinterface_delete, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Redis, getMultiple, arginfo_phalcon_cache_backendinterface_getmultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Redis, saveMultiple, arginfo_phalcon_cache_backendinterface_savemultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Redis, deleteMultiple, arginfo_phalcon_cache_backendinterface_deletemultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Redis, _acquireLock, arginfo_phalcon_cache_backend__acquirelock, ZEND_ACC_PROTECTED)
+	PHP_ME(Phalcon_Cache_Backend_Redis, _releaseLock, arginfo_phalcon_cache_backend__releaselock, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Cache_Backend_Redis, queryKeys, arginfo_phalcon_cache_backendinterface_querykeys, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Redis, exists, arginfo_phalcon_cache_backendinterface_exists, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Redis, increment, arginfo_phalcon_cache_backendinterface_increment, ZEND_ACC_PUBLIC)
@@ -413,6 +423,285 @@ PHP_METHOD(Phalcon_Cache_Backend_Redis, delete){
 	RETURN_MM_FALSE;
 }
 
+/**
+ * Returns the cached contents of several keys with a single MGET
+ *
+ * @param array $keys
+ * @param mixed $defaultValue
+ * @return array
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Redis, getMultiple){
+
+	zval *keys, *default_value = NULL, redis = {}, frontend = {}, prefix = {}, prefixed_keys = {}, list = {}, cached_contents = {}, contents = {};
+	zval *prefixed_key;
+	uint32_t i = 0;
+
+	phalcon_fetch_params(1, 1, 1, &keys, &default_value);
+
+	if (!default_value) {
+		default_value = &PHALCON_GLOBAL(z_null);
+	}
+
+	phalcon_read_property(&redis, getThis(), SL("_redis"), PH_READONLY);
+	if (Z_TYPE(redis) != IS_OBJECT) {
+		PHALCON_MM_CALL_METHOD(&redis, getThis(), "_connect");
+		PHALCON_MM_ADD_ENTRY(&redis);
+	}
+
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+
+	phalcon_cache_backend_prefix_keys(&prefixed_keys, &prefix, keys);
+	PHALCON_MM_ADD_ENTRY(&prefixed_keys);
+
+	if (!zend_hash_num_elements(Z_ARRVAL(prefixed_keys))) {
+		RETURN_MM_EMPTY_ARRAY();
+	}
+
+	phalcon_array_keys(&list, &prefixed_keys);
+	PHALCON_MM_ADD_ENTRY(&list);
+
+	PHALCON_MM_CALL_METHOD(&cached_contents, &redis, "mget", &list);
+	PHALCON_MM_ADD_ENTRY(&cached_contents);
+
+	/**
+	 * MGET answers in the order of the keys
+	 */
+	array_init(&contents);
+	PHALCON_MM_ADD_ENTRY(&contents);
+	if (Z_TYPE(cached_contents) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(list), prefixed_key) {
+			zval cached_content = {};
+			if (phalcon_array_isset_fetch_long(&cached_content, &cached_contents, i++, PH_READONLY)) {
+				phalcon_array_update(&contents, prefixed_key, &cached_content, PH_COPY);
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	phalcon_cache_backend_decode_multiple(return_value, &frontend, &prefixed_keys, &contents, default_value);
+	RETURN_MM();
+}
+
+/**
+ * Stores several contents at once, the SET commands are pipelined in a single round trip
+ *
+ * @param array $values
+ * @param long $lifetime
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Redis, saveMultiple){
+
+	zval *values, *lifetime = NULL, redis = {}, frontend = {}, prefix = {}, ttl = {}, prepared_contents = {}, mode = {}, results = {};
+	zval options = {}, special_key = {}, *prepared_content, *result;
+	zend_string *str_key;
+	ulong idx;
+	uint32_t i = 0, count;
+
+	phalcon_fetch_params(1, 1, 1, &values, &lifetime);
+
+	if (!zend_hash_num_elements(Z_ARRVAL_P(values))) {
+		RETURN_MM_TRUE;
+	}
+
+	phalcon_read_property(&redis, getThis(), SL("_redis"), PH_READONLY);
+	if (Z_TYPE(redis) != IS_OBJECT) {
+		PHALCON_MM_CALL_METHOD(&redis, getThis(), "_connect");
+		PHALCON_MM_ADD_ENTRY(&redis);
+	}
+
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+
+	if (!lifetime || Z_TYPE_P(lifetime) != IS_LONG) {
+		PHALCON_MM_CALL_METHOD(&ttl, getThis(), "getlifetime");
+		PHALCON_MM_ADD_ENTRY(&ttl);
+	} else {
+		ZVAL_COPY_VALUE(&ttl, lifetime);
+	}
+
+	if (phalcon_cache_backend_encode_multiple(&prepared_contents, &frontend, &prefix, values) == FAILURE) {
+		zval_ptr_dtor(&prepared_contents);
+		RETURN_MM();
+	}
+	PHALCON_MM_ADD_ENTRY(&prepared_contents);
+
+	phalcon_read_property(&options, getThis(), SL("_options"), PH_READONLY);
+	phalcon_array_isset_fetch_str(&special_key, &options, SL("statsKey"), PH_READONLY);
+
+	phalcon_get_class_constant(&mode, Z_OBJCE(redis), SL("PIPELINE"));
+	PHALCON_MM_CALL_METHOD(NULL, &redis, "multi", &mode);
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(prepared_contents), idx, str_key, prepared_content) {
+		zval prefixed_key = {};
+		if (str_key) {
+			ZVAL_STR(&prefixed_key, str_key);
+		} else {
+			ZVAL_LONG(&prefixed_key, idx);
+		}
+		PHALCON_MM_CALL_METHOD(NULL, &redis, "set", &prefixed_key, prepared_content, &ttl);
+	} ZEND_HASH_FOREACH_END();
+
+	if (PHALCON_IS_NOT_EMPTY_STRING(&special_key)) {
+		ZEND_HASH_FOREACH_KEY(Z_ARRVAL(prepared_contents), idx, str_key) {
+			zval prefixed_key = {};
+			if (str_key) {
+				ZVAL_STR(&prefixed_key, str_key);
+			} else {
+				ZVAL_LONG(&prefixed_key, idx);
+			}
+			PHALCON_MM_CALL_METHOD(NULL, &redis, "sadd", &special_key, &prefixed_key);
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	PHALCON_MM_CALL_METHOD(&results, &redis, "exec");
+	PHALCON_MM_ADD_ENTRY(&results);
+
+	if (Z_TYPE(results) != IS_ARRAY) {
+		PHALCON_MM_THROW_EXCEPTION_STR(phalcon_cache_exception_ce, "Failed to store data in redisd");
+		return;
+	}
+
+	/**
+	 * The replies of the SET commands come first
+	 */
+	count = zend_hash_num_elements(Z_ARRVAL(prepared_contents));
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(results), result) {
+		if (i++ >= count) {
+			break;
+		}
+		if (!zend_is_true(result)) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_cache_exception_ce, "Failed to store data in redisd");
+			return;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	RETURN_MM_TRUE;
+}
+
+/**
+ * Deletes several values from the cache by their keys with a single DEL
+ *
+ * @param array $keys
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Redis, deleteMultiple){
+
+	zval *keys, redis = {}, prefix = {}, prefixed_keys = {}, list = {}, options = {}, special_key = {}, mode = {}, *prefixed_key;
+
+	phalcon_fetch_params(1, 1, 0, &keys);
+
+	if (!zend_hash_num_elements(Z_ARRVAL_P(keys))) {
+		RETURN_MM_TRUE;
+	}
+
+	phalcon_read_property(&redis, getThis(), SL("_redis"), PH_READONLY);
+	if (Z_TYPE(redis) != IS_OBJECT) {
+		PHALCON_MM_CALL_METHOD(&redis, getThis(), "_connect");
+		PHALCON_MM_ADD_ENTRY(&redis);
+	}
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+
+	phalcon_cache_backend_prefix_keys(&prefixed_keys, &prefix, keys);
+	PHALCON_MM_ADD_ENTRY(&prefixed_keys);
+
+	phalcon_array_keys(&list, &prefixed_keys);
+	PHALCON_MM_ADD_ENTRY(&list);
+
+	phalcon_read_property(&options, getThis(), SL("_options"), PH_READONLY);
+
+	phalcon_get_class_constant(&mode, Z_OBJCE(redis), SL("PIPELINE"));
+	PHALCON_MM_CALL_METHOD(NULL, &redis, "multi", &mode);
+
+	if (phalcon_array_isset_fetch_str(&special_key, &options, SL("statsKey"), PH_READONLY) && PHALCON_IS_NOT_EMPTY_STRING(&special_key)) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(list), prefixed_key) {
+			PHALCON_MM_CALL_METHOD(NULL, &redis, "srem", &special_key, prefixed_key);
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	PHALCON_MM_CALL_METHOD(NULL, &redis, "delete", &list);
+	PHALCON_MM_CALL_METHOD(return_value, &redis, "exec");
+
+	RETVAL_BOOL(Z_TYPE_P(return_value) == IS_ARRAY);
+	RETURN_MM();
+}
+
+/**
+ * Acquires the regeneration lock of getOrCompute() with SET NX PX, the lock holds the token
+ *
+ * @param string $lockKey
+ * @param int $lifetime milliseconds
+ * @param string $token
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Redis, _acquireLock){
+
+	zval *lock_key, *lifetime, *token, redis = {}, prefix = {}, prefixed_key = {}, set_options = {}, ret = {};
+
+	phalcon_fetch_params(1, 3, 0, &lock_key, &lifetime, &token);
+
+	phalcon_read_property(&redis, getThis(), SL("_redis"), PH_READONLY);
+	if (Z_TYPE(redis) != IS_OBJECT) {
+		PHALCON_MM_CALL_METHOD(&redis, getThis(), "_connect");
+		PHALCON_MM_ADD_ENTRY(&redis);
+	}
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+
+	PHALCON_CONCAT_VV(&prefixed_key, &prefix, lock_key);
+	PHALCON_MM_ADD_ENTRY(&prefixed_key);
+
+	array_init_size(&set_options, 2);
+	phalcon_array_append_str(&set_options, SL("nx"), 0);
+	phalcon_array_update_str_long(&set_options, SL("px"), phalcon_get_intval(lifetime), 0);
+	PHALCON_MM_ADD_ENTRY(&set_options);
+
+	PHALCON_MM_CALL_METHOD(&ret, &redis, "set", &prefixed_key, token, &set_options);
+	PHALCON_MM_ADD_ENTRY(&ret);
+
+	RETURN_MM_BOOL(zend_is_true(&ret));
+}
+
+/**
+ * Releases the regeneration lock of getOrCompute(), a script compares the token and deletes the
+ * lock atomically so a lock taken by another worker after this one expired is left alone
+ *
+ * @param string $lockKey
+ * @param string $token
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Redis, _releaseLock){
+
+	zval *lock_key, *token, redis = {}, prefix = {}, prefixed_key = {}, script = {}, args = {}, num_keys = {}, ret = {};
+
+	phalcon_fetch_params(1, 2, 0, &lock_key, &token);
+
+	phalcon_read_property(&redis, getThis(), SL("_redis"), PH_READONLY);
+	if (Z_TYPE(redis) != IS_OBJECT) {
+		PHALCON_MM_CALL_METHOD(&redis, getThis(), "_connect");
+		PHALCON_MM_ADD_ENTRY(&redis);
+	}
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_READONLY);
+
+	PHALCON_CONCAT_VV(&prefixed_key, &prefix, lock_key);
+	PHALCON_MM_ADD_ENTRY(&prefixed_key);
+
+	PHALCON_MM_ZVAL_STRING(&script, "if redis.call('get', KEYS[1]) == ARGV[1] then return redis.call('del', KEYS[1]) else return 0 end");
+
+	array_init_size(&args, 2);
+	phalcon_array_append(&args, &prefixed_key, PH_COPY);
+	phalcon_array_append(&args, token, PH_COPY);
+	PHALCON_MM_ADD_ENTRY(&args);
+
+	ZVAL_LONG(&num_keys, 1);
+
+	PHALCON_MM_CALL_METHOD(&ret, &redis, "eval", &script, &args, &num_keys);
+	PHALCON_MM_ADD_ENTRY(&ret);
+
+	RETURN_MM_BOOL(zend_is_true(&ret));
+}
+
 /**
  * Query the existing cached keys
  *
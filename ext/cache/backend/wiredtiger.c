@@ -71,6 +71,9 @@ PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, __construct);
 PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, get);
 PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, save);
 PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, delete);
+PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, getMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, saveMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, deleteMultiple);
 PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, queryKeys);
 PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, exists);
 PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, increment);
@@ -87,6 +90,9 @@ static const zend_function_entry phalcon_cache_backend_wiredtiger_method_entry[]
 	PHP_ME(Phalcon_Cache_Backend_Wiredtiger, get, arginfo_phalcon_cache_backendinterface_get, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Wiredtiger, save, arginfo_phalcon_cache_backendinterface_save, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Wiredtiger, delete, arginfo_phalcon_cache_backendinterface_delete, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Wiredtiger, getMultiple, arginfo_phalcon_cache_backendinterface_getmultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Wiredtiger, saveMultiple, arginfo_phalcon_cache_backendinterface_savemultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Wiredtiger, deleteMultiple, arginfo_phalcon_cache_backendinterface_deletemultiple, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Wiredtiger, queryKeys, arginfo_phalcon_cache_backendinterface_querykeys, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Wiredtiger, exists, arginfo_phalcon_cache_backendinterface_exists, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Wiredtiger, increment, arginfo_phalcon_cache_backendinterface_increment, ZEND_ACC_PUBLIC)
@@ -300,6 +306,173 @@ PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, delete){
 	PHALCON_CALL_METHOD(return_value, &cursor, "delete", key_name);
 }
 
+/**
+ * Returns several cached contents at once
+ *
+ * @param array $keys
+ * @param mixed $defaultValue
+ * @return array
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, getMultiple){
+
+	zval *keys, *default_value = NULL, cursor = {}, frontend = {}, cached_contents = {}, *key_name;
+	zend_string *str_key;
+	ulong idx;
+	long int now;
+
+	phalcon_fetch_params(0, 1, 1, &keys, &default_value);
+
+	if (!default_value) {
+		default_value = &PHALCON_GLOBAL(z_null);
+	}
+
+	phalcon_read_property(&cursor, getThis(), SL("_cursor"), PH_READONLY);
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+
+	/**
+	 * The cursor returns the stored items indexed by the position of their keys
+	 */
+	PHALCON_CALL_METHOD(&cached_contents, &cursor, "gets", keys);
+
+	array_init(return_value);
+
+	now = (long int)time(NULL);
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(keys), idx, str_key, key_name) {
+		zval cached_content = {}, val = {}, expired = {}, content = {};
+		int flag;
+
+		if (str_key) {
+			phalcon_array_isset_fetch_string(&cached_content, &cached_contents, str_key, PH_READONLY);
+		} else {
+			phalcon_array_isset_fetch_long(&cached_content, &cached_contents, idx, PH_READONLY);
+		}
+
+		if (Z_TYPE(cached_content) != IS_ARRAY || !phalcon_array_isset_fetch_long(&val, &cached_content, 0, PH_READONLY)) {
+			phalcon_array_update(return_value, key_name, default_value, PH_COPY);
+			continue;
+		}
+
+		if (phalcon_array_isset_fetch_long(&expired, &cached_content, 1, PH_READONLY) && phalcon_get_intval(&expired) < now) {
+			PHALCON_CALL_METHOD_FLAG(flag, NULL, &cursor, "delete", key_name);
+			if (flag == FAILURE) {
+				break;
+			}
+		}
+
+		if (PHALCON_IS_NOT_EMPTY(&val)) {
+			PHALCON_CALL_METHOD_FLAG(flag, &content, &frontend, "afterretrieve", &val);
+			if (flag == FAILURE) {
+				break;
+			}
+			phalcon_array_update(return_value, key_name, &content, 0);
+		} else {
+			phalcon_array_update(return_value, key_name, &val, PH_COPY);
+		}
+	} ZEND_HASH_FOREACH_END();
+	zval_ptr_dtor(&cached_contents);
+}
+
+/**
+ * Stores several contents at once inside a single transaction
+ *
+ * @param array $values
+ * @param long $lifetime
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, saveMultiple){
+
+	zval *values, *lifetime = NULL, cursor = {}, frontend = {}, ttl = {}, expired = {}, items = {}, success = {}, *content;
+	zend_string *str_key;
+	ulong idx;
+
+	phalcon_fetch_params(0, 1, 1, &values, &lifetime);
+
+	if (!lifetime || Z_TYPE_P(lifetime) != IS_LONG) {
+		PHALCON_CALL_METHOD(&ttl, getThis(), "getlifetime");
+	} else {
+		ZVAL_COPY_VALUE(&ttl, lifetime);
+	}
+	ZVAL_LONG(&expired, (time(NULL) + phalcon_get_intval(&ttl)));
+
+	phalcon_read_property(&cursor, getThis(), SL("_cursor"), PH_READONLY);
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+
+	array_init_size(&items, zend_hash_num_elements(Z_ARRVAL_P(values)));
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(values), idx, str_key, content) {
+		zval prepared_val = {}, cached_content = {};
+		int flag;
+
+		PHALCON_CALL_METHOD_FLAG(flag, &prepared_val, &frontend, "beforestore", content);
+		if (flag == FAILURE) {
+			zval_ptr_dtor(&items);
+			return;
+		}
+
+		array_init_size(&cached_content, 2);
+		phalcon_array_append(&cached_content, &prepared_val, 0);
+		phalcon_array_append(&cached_content, &expired, 0);
+
+		if (str_key) {
+			phalcon_array_update_string(&items, str_key, &cached_content, 0);
+		} else {
+			phalcon_array_update_long(&items, idx, &cached_content, 0);
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	/**
+	 * The cursor writes every item inside one transaction and rolls it back on failure
+	 */
+	PHALCON_CALL_METHOD(&success, &cursor, "sets", &items);
+	zval_ptr_dtor(&items);
+
+	if (PHALCON_IS_FALSE(&success)) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_cache_exception_ce, "Failed to store data in wiredtiger");
+		return;
+	}
+
+	RETURN_TRUE;
+}
+
+/**
+ * Deletes several values from the cache by their keys inside a single transaction
+ *
+ * @param array $keys
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Wiredtiger, deleteMultiple){
+
+	zval *keys, wiredtiger = {}, cursor = {}, *key_name;
+	int flag = SUCCESS;
+
+	phalcon_fetch_params(0, 1, 0, &keys);
+
+	phalcon_read_property(&wiredtiger, getThis(), SL("_wiredtiger"), PH_READONLY);
+	phalcon_read_property(&cursor, getThis(), SL("_cursor"), PH_READONLY);
+
+	PHALCON_CALL_METHOD(NULL, &wiredtiger, "begin");
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(keys), key_name) {
+		PHALCON_CALL_METHOD_FLAG(flag, NULL, &cursor, "delete", key_name);
+		if (flag == FAILURE) {
+			break;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	if (flag == FAILURE) {
+		zend_object *exception = EG(exception);
+		EG(exception) = NULL;
+		phalcon_call_method(NULL, &wiredtiger, "rollback", 0, NULL);
+		if (EG(exception)) {
+			zend_object_release(EG(exception));
+		}
+		EG(exception) = exception;
+		return;
+	}
+
+	PHALCON_CALL_METHOD(NULL, &wiredtiger, "commit");
+	RETURN_TRUE;
+}
+
 /**
  * Query the existing cached keys
  *
@@ -71,6 +71,9 @@ PHP_METHOD(Phalcon_Cache_Backend_Yac, _connect);
 PHP_METHOD(Phalcon_Cache_Backend_Yac, get);
 PHP_METHOD(Phalcon_Cache_Backend_Yac, save);
 PHP_METHOD(Phalcon_Cache_Backend_Yac, delete);
+PHP_METHOD(Phalcon_Cache_Backend_Yac, getMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Yac, saveMultiple);
+PHP_METHOD(Phalcon_Cache_Backend_Yac, deleteMultiple);
 PHP_METHOD(Phalcon_Cache_Backend_Yac, queryKeys);
 PHP_METHOD(Phalcon_Cache_Backend_Yac, exists);
 PHP_METHOD(Phalcon_Cache_Backend_Yac, increment);
@@ -94,6 +97,9 @@ static const zend_function_entry phalcon_cache_backend_yac_method_entry[] = {
 	PHP_ME(Phalcon_Cache_Backend_Yac, get, arginfo_phalcon_cache_backendinterface_get, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Yac, save, arginfo_phalcon_cache_backendinterface_save, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Yac, delete, arginfo_phalcon_cache_backendinterface_delete, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Yac, getMultiple, arginfo_phalcon_cache_backendinterface_getmultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Yac, saveMultiple, arginfo_phalcon_cache_backendinterface_savemultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Backend_Yac, deleteMultiple, arginfo_phalcon_cache_backendinterface_deletemultiple, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Yac, queryKeys, arginfo_phalcon_cache_backendinterface_querykeys, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Yac, exists, arginfo_phalcon_cache_backendinterface_exists, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Backend_Yac, increment, arginfo_phalcon_cache_backendinterface_increment, ZEND_ACC_PUBLIC)
@@ -349,6 +355,175 @@ PHP_METHOD(Phalcon_Cache_Backend_Yac, delete){
 	zval_ptr_dtor(&yac);
 }
 
+/**
+ * Returns the cached contents of several keys with a single Yac::get()
+ *
+ * @param array $keys
+ * @param mixed $defaultValue
+ * @return array
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Yac, getMultiple){
+
+	zval *keys, *default_value = NULL, yac = {}, frontend = {}, prefix = {}, prefixed_keys = {}, list = {}, contents = {};
+
+	phalcon_fetch_params(0, 1, 1, &keys, &default_value);
+
+	if (!default_value) {
+		default_value = &PHALCON_GLOBAL(z_null);
+	}
+
+	ZVAL_STRING(&prefix, "_PHCY");
+	phalcon_cache_backend_prefix_keys(&prefixed_keys, &prefix, keys);
+	zval_ptr_dtor(&prefix);
+
+	if (!zend_hash_num_elements(Z_ARRVAL(prefixed_keys))) {
+		zval_ptr_dtor(&prefixed_keys);
+		RETURN_EMPTY_ARRAY();
+	}
+
+	phalcon_read_property(&yac, getThis(), SL("_yac"), PH_COPY);
+	if (Z_TYPE(yac) != IS_OBJECT) {
+		PHALCON_CALL_METHOD(&yac, getThis(), "_connect");
+	}
+
+	phalcon_array_keys(&list, &prefixed_keys);
+
+	PHALCON_CALL_METHOD(&contents, &yac, "get", &list);
+	zval_ptr_dtor(&list);
+	zval_ptr_dtor(&yac);
+
+	if (Z_TYPE(contents) != IS_ARRAY) {
+		zval_ptr_dtor(&contents);
+		array_init(&contents);
+	}
+
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+	phalcon_cache_backend_decode_multiple(return_value, &frontend, &prefixed_keys, &contents, default_value);
+	zval_ptr_dtor(&prefixed_keys);
+	zval_ptr_dtor(&contents);
+}
+
+/**
+ * Stores several contents at once with a single Yac::set()
+ *
+ * @param array $values
+ * @param long $lifetime
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Yac, saveMultiple){
+
+	zval *values, *lifetime = NULL, yac = {}, frontend = {}, prefix = {}, ttl = {}, prepared_contents = {}, success = {};
+	zval options = {}, special_key = {}, keys = {}, *content;
+	zend_string *str_key;
+	ulong idx;
+
+	phalcon_fetch_params(0, 1, 1, &values, &lifetime);
+
+	if (!zend_hash_num_elements(Z_ARRVAL_P(values))) {
+		RETURN_TRUE;
+	}
+
+	if (!lifetime || Z_TYPE_P(lifetime) != IS_LONG) {
+		PHALCON_CALL_METHOD(&ttl, getThis(), "getlifetime");
+	} else {
+		ZVAL_COPY(&ttl, lifetime);
+	}
+
+	phalcon_read_property(&frontend, getThis(), SL("_frontend"), PH_READONLY);
+
+	ZVAL_STRING(&prefix, "_PHCY");
+	if (phalcon_cache_backend_encode_multiple(&prepared_contents, &frontend, &prefix, values) == FAILURE) {
+		zval_ptr_dtor(&prefix);
+		zval_ptr_dtor(&prepared_contents);
+		return;
+	}
+	zval_ptr_dtor(&prefix);
+
+	phalcon_read_property(&yac, getThis(), SL("_yac"), PH_COPY);
+	if (Z_TYPE(yac) != IS_OBJECT) {
+		PHALCON_CALL_METHOD(&yac, getThis(), "_connect");
+	}
+
+	/* The yac extension reads the lifetime of an array of keys from the second argument */
+	PHALCON_CALL_METHOD(&success, &yac, "set", &prepared_contents, &ttl, &ttl);
+	zval_ptr_dtor(&prepared_contents);
+
+	if (!zend_is_true(&success)) {
+		zval_ptr_dtor(&yac);
+		PHALCON_THROW_EXCEPTION_STR(phalcon_cache_exception_ce, "Failed to store data in yac");
+		return;
+	}
+
+	phalcon_read_property(&options, getThis(), SL("_options"), PH_READONLY);
+
+	if (phalcon_array_isset_fetch_str(&special_key, &options, SL("statsKey"), PH_READONLY) && PHALCON_IS_NOT_EMPTY_STRING(&special_key)) {
+		PHALCON_CALL_METHOD(&keys, &yac, "get", &special_key);
+		if (Z_TYPE(keys) != IS_ARRAY) {
+			array_init(&keys);
+		}
+
+		ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(values), idx, str_key, content) {
+			if (str_key) {
+				phalcon_array_update_string(&keys, str_key, &ttl, PH_COPY);
+			} else {
+				phalcon_array_update_long(&keys, idx, &ttl, PH_COPY);
+			}
+		} ZEND_HASH_FOREACH_END();
+
+		PHALCON_CALL_METHOD(NULL, &yac, "set", &special_key, &keys);
+		zval_ptr_dtor(&keys);
+	}
+	zval_ptr_dtor(&yac);
+	zval_ptr_dtor(&ttl);
+
+	RETURN_TRUE;
+}
+
+/**
+ * Deletes several values from the cache by their keys with a single Yac::delete()
+ *
+ * @param array $keys
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Backend_Yac, deleteMultiple){
+
+	zval *keys, yac = {}, prefix = {}, prefixed_keys = {}, list = {}, options = {}, special_key = {}, tracked_keys = {}, *key_name;
+
+	phalcon_fetch_params(0, 1, 0, &keys);
+
+	if (!zend_hash_num_elements(Z_ARRVAL_P(keys))) {
+		RETURN_TRUE;
+	}
+
+	phalcon_read_property(&yac, getThis(), SL("_yac"), PH_COPY);
+	if (Z_TYPE(yac) != IS_OBJECT) {
+		PHALCON_CALL_METHOD(&yac, getThis(), "_connect");
+	}
+
+	ZVAL_STRING(&prefix, "_PHCY");
+	phalcon_cache_backend_prefix_keys(&prefixed_keys, &prefix, keys);
+	phalcon_array_keys(&list, &prefixed_keys);
+	zval_ptr_dtor(&prefix);
+	zval_ptr_dtor(&prefixed_keys);
+
+	PHALCON_CALL_METHOD(return_value, &yac, "delete", &list);
+	zval_ptr_dtor(&list);
+
+	phalcon_read_property(&options, getThis(), SL("_options"), PH_READONLY);
+
+	if (phalcon_array_isset_fetch_str(&special_key, &options, SL("statsKey"), PH_READONLY) && PHALCON_IS_NOT_EMPTY_STRING(&special_key)) {
+		PHALCON_CALL_METHOD(&tracked_keys, &yac, "get", &special_key);
+		if (Z_TYPE(tracked_keys) == IS_ARRAY) {
+			ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(keys), key_name) {
+				phalcon_array_unset(&tracked_keys, key_name, 0);
+			} ZEND_HASH_FOREACH_END();
+			PHALCON_CALL_METHOD(NULL, &yac, "set", &special_key, &tracked_keys);
+		}
+		zval_ptr_dtor(&tracked_keys);
+	}
+	zval_ptr_dtor(&yac);
+}
+
 /**
  * Query the existing cached keys
  *
@@ -431,7 +606,7 @@ PHP_METHOD(Phalcon_Cache_Backend_Yac, exists){
  */
 PHP_METHOD(Phalcon_Cache_Backend_Yac, increment){
 
-	zval *key_name, *value = NULL, yac = {}, last_key = {}, cached_content = {}, tmp = {};
+	zval *key_name, *value = NULL, yac = {}, last_key = {};
 
 	phalcon_fetch_params(0, 1, 1, &key_name, &value);
 
@@ -449,11 +624,7 @@ PHP_METHOD(Phalcon_Cache_Backend_Yac, increment){
 		PHALCON_CALL_METHOD(&yac, getThis(), "_connect");
 	}
 
-	PHALCON_CALL_METHOD(&cached_content, &yac, "get", &last_key);
-	phalcon_add_function(&tmp, &cached_content, value);
-	zval_ptr_dtor(&cached_content);
-
-	PHALCON_RETURN_CALL_METHOD(&yac, "set", &last_key, &tmp);
+	PHALCON_RETURN_CALL_METHOD(&yac, "increment", &last_key, value);
 	zval_ptr_dtor(&last_key);
 	zval_ptr_dtor(&yac);
 }
@@ -467,7 +638,7 @@ PHP_METHOD(Phalcon_Cache_Backend_Yac, increment){
  */
 PHP_METHOD(Phalcon_Cache_Backend_Yac, decrement){
 
-	zval *key_name, *value = NULL, yac = {}, last_key = {}, cached_content = {}, tmp = {};
+	zval *key_name, *value = NULL, yac = {}, last_key = {};
 
 	phalcon_fetch_params(0, 1, 1, &key_name, &value);
 
@@ -485,11 +656,8 @@ PHP_METHOD(Phalcon_Cache_Backend_Yac, decrement){
 		PHALCON_CALL_METHOD(&yac, getThis(), "_connect");
 	}
 
-	PHALCON_CALL_METHOD(&cached_content, &yac, "get", &last_key);
-	phalcon_sub_function(&tmp, &cached_content, value);
-	zval_ptr_dtor(&cached_content);
-
-	PHALCON_RETURN_CALL_METHOD(&yac, "set", &last_key, &tmp);
+	PHALCON_RETURN_CALL_METHOD(&yac, "decrement", &last_key, value);
+	zval_ptr_dtor(&last_key);
 	zval_ptr_dtor(&yac);
 }
 
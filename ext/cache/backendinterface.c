@@ -32,6 +32,9 @@ static const zend_function_entry phalcon_cache_backendinterface_method_entry[] =
 	PHP_ABSTRACT_ME(Phalcon_Cache_BackendInterface, get, arginfo_phalcon_cache_backendinterface_get)
 	PHP_ABSTRACT_ME(Phalcon_Cache_BackendInterface, save, arginfo_phalcon_cache_backendinterface_save)
 	PHP_ABSTRACT_ME(Phalcon_Cache_BackendInterface, delete, arginfo_phalcon_cache_backendinterface_delete)
+	PHP_ABSTRACT_ME(Phalcon_Cache_BackendInterface, getMultiple, arginfo_phalcon_cache_backendinterface_getmultiple)
+	PHP_ABSTRACT_ME(Phalcon_Cache_BackendInterface, saveMultiple, arginfo_phalcon_cache_backendinterface_savemultiple)
+	PHP_ABSTRACT_ME(Phalcon_Cache_BackendInterface, deleteMultiple, arginfo_phalcon_cache_backendinterface_deletemultiple)
 	PHP_ABSTRACT_ME(Phalcon_Cache_BackendInterface, queryKeys, arginfo_phalcon_cache_backendinterface_querykeys)
 	PHP_ABSTRACT_ME(Phalcon_Cache_BackendInterface, exists, arginfo_phalcon_cache_backendinterface_exists)
 	PHP_ABSTRACT_ME(Phalcon_Cache_BackendInterface, flush, NULL)
@@ -118,6 +121,33 @@ PHALCON_DOC_METHOD(Phalcon_Cache_BackendInterface, save);
  */
 PHALCON_DOC_METHOD(Phalcon_Cache_BackendInterface, delete);
 
+/**
+ * Returns the cached contents of several keys, as key => content, with $defaultValue for the
+ * missing keys
+ *
+ * @param array $keys
+ * @param mixed $defaultValue
+ * @return array
+ */
+PHALCON_DOC_METHOD(Phalcon_Cache_BackendInterface, getMultiple);
+
+/**
+ * Stores several contents at once, as key => content
+ *
+ * @param array $values
+ * @param long $lifetime
+ * @return boolean
+ */
+PHALCON_DOC_METHOD(Phalcon_Cache_BackendInterface, saveMultiple);
+
+/**
+ * Deletes several values from the cache by their keys
+ *
+ * @param array $keys
+ * @return boolean
+ */
+PHALCON_DOC_METHOD(Phalcon_Cache_BackendInterface, deleteMultiple);
+
 /**
  * Query the existing cached keys
  *
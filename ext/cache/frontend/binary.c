@@ -0,0 +1,909 @@
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2014 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  |          ZhuZongXin <dreamsxin@qq.com>                                 |
+  +------------------------------------------------------------------------+
+*/
+
+#include "cache/frontend/binary.h"
+#include "cache/frontend/data.h"
+#include "cache/frontendinterface.h"
+#include "cache/exception.h"
+#include "mvc/model.h"
+#include "mvc/model/resultset.h"
+#include "mvc/model/resultset/simple.h"
+
+#include <ext/standard/php_var.h>
+
+#include "kernel/main.h"
+#include "kernel/memory.h"
+#include "kernel/fcall.h"
+#include "kernel/array.h"
+#include "kernel/object.h"
+#include "kernel/operators.h"
+#include "kernel/exception.h"
+
+/**
+ * Phalcon\Cache\Frontend\Binary
+ *
+ * Allows to cache native PHP data in a compact binary form, without depending on any extension
+ *
+ * Integers are stored as variable length numbers, repeated short strings (array keys, column names,
+ * class names) are written once and referenced later by their position, lists are stored without keys,
+ * and models and simple resultsets are stored as their attributes. The decoder creates every array
+ * with its final size.
+ *
+ * Unlike serialize() no back-references are kept: an object or an array found twice in the data, or a
+ * PHP reference, is written twice and decoded as two independent copies.
+ *
+ *<code>
+ *
+ *	// Cache the resultsets for 2 days using the Binary frontend
+ *	$frontCache = new Phalcon\Cache\Frontend\Binary(array(
+ *		"lifetime" => 172800
+ *	));
+ *
+ *	$cache = new Phalcon\Cache\Backend\File($frontCache, array(
+ *		"cacheDir" => "../app/cache/"
+ *	));
+ *
+ *	$robots = $cache->get('robots_order_id.cache');
+ *	if ($robots === null) {
+ *		$robots = Robots::find(array("order" => "id"));
+ *		$cache->save('robots_order_id.cache', $robots);
+ *	}
+ *</code>
+ */
+zend_class_entry *phalcon_cache_frontend_binary_ce;
+
+PHP_METHOD(Phalcon_Cache_Frontend_Binary, beforeStore);
+PHP_METHOD(Phalcon_Cache_Frontend_Binary, afterRetrieve);
+
+static const zend_function_entry phalcon_cache_frontend_binary_method_entry[] = {
+	PHP_ME(Phalcon_Cache_Frontend_Binary, beforeStore, arginfo_phalcon_cache_frontendinterface_beforestore, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Frontend_Binary, afterRetrieve, arginfo_phalcon_cache_frontendinterface_afterretrieve, ZEND_ACC_PUBLIC)
+	PHP_FE_END
+};
+
+/**
+ * Phalcon\Cache\Frontend\Binary initializer
+ */
+PHALCON_INIT_CLASS(Phalcon_Cache_Frontend_Binary){
+
+	PHALCON_REGISTER_CLASS_EX(Phalcon\\Cache\\Frontend, Binary, cache_frontend_binary, phalcon_cache_frontend_data_ce, phalcon_cache_frontend_binary_method_entry, 0);
+
+	zend_class_implements(phalcon_cache_frontend_binary_ce, 1, phalcon_cache_frontendinterface_ce);
+
+	return SUCCESS;
+}
+
+typedef struct {
+	smart_str *buf;
+	HashTable strings;
+	uint32_t depth;
+} phalcon_cache_frontend_binary_encoder;
+
+typedef struct {
+	const unsigned char *p;
+	const unsigned char *end;
+	zend_string **strings;
+	uint32_t strings_num;
+	uint32_t strings_size;
+	uint32_t depth;
+} phalcon_cache_frontend_binary_decoder;
+
+#define PHALCON_CACHE_FRONTEND_BINARY_ZIGZAG(l)    (((zend_ulong)(l) << 1) ^ (zend_ulong)((l) >> (SIZEOF_ZEND_LONG * 8 - 1)))
+#define PHALCON_CACHE_FRONTEND_BINARY_UNZIGZAG(u)  ((zend_long)(((u) >> 1) ^ (~((u) & 1) + 1)))
+
+static int phalcon_cache_frontend_binary_write_value(phalcon_cache_frontend_binary_encoder *e, zval *value);
+static int phalcon_cache_frontend_binary_read_value(phalcon_cache_frontend_binary_decoder *d, zval *rv);
+
+static void phalcon_cache_frontend_binary_write_varint(smart_str *buf, zend_ulong v)
+{
+	unsigned char tmp[10];
+	int n = 0;
+
+	while (v >= 0x80) {
+		tmp[n++] = (unsigned char)(v | 0x80);
+		v >>= 7;
+	}
+	tmp[n++] = (unsigned char)v;
+
+	smart_str_appendl(buf, (const char *)tmp, n);
+}
+
+static void phalcon_cache_frontend_binary_write_string(phalcon_cache_frontend_binary_encoder *e, zend_string *str)
+{
+	if (ZSTR_LEN(str) <= PHALCON_CACHE_FRONTEND_BINARY_MAX_SHARED_LEN) {
+		zval *id, tmp = {};
+
+		if ((id = zend_hash_find(&e->strings, str)) != NULL) {
+			smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_STRING_REF);
+			phalcon_cache_frontend_binary_write_varint(e->buf, (zend_ulong)Z_LVAL_P(id));
+			return;
+		}
+
+		ZVAL_LONG(&tmp, zend_hash_num_elements(&e->strings));
+		zend_hash_add_new(&e->strings, str, &tmp);
+	}
+
+	smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_STRING);
+	phalcon_cache_frontend_binary_write_varint(e->buf, ZSTR_LEN(str));
+	smart_str_appendl(e->buf, ZSTR_VAL(str), ZSTR_LEN(str));
+}
+
+static int phalcon_cache_frontend_binary_write_array(phalcon_cache_frontend_binary_encoder *e, HashTable *ht, int allow_list)
+{
+	zend_string *key;
+	zend_ulong idx, expected = 0;
+	zval *value;
+	uint32_t count = zend_hash_num_elements(ht);
+	int is_list = allow_list;
+
+	if (++e->depth > PHALCON_CACHE_FRONTEND_BINARY_MAX_DEPTH) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_cache_exception_ce, "Nesting level too deep, recursive dependency?");
+		return FAILURE;
+	}
+
+	/* A packed array without holes is a list already, anything else has to be checked */
+	if (is_list && !((ht->u.flags & HASH_FLAG_PACKED) && ht->nNumUsed == count)) {
+		ZEND_HASH_FOREACH_KEY(ht, idx, key) {
+			if (key || idx != expected++) {
+				is_list = 0;
+				break;
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	if (is_list) {
+		smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_LIST);
+		phalcon_cache_frontend_binary_write_varint(e->buf, count);
+
+		ZEND_HASH_FOREACH_VAL_IND(ht, value) {
+			if (phalcon_cache_frontend_binary_write_value(e, value) == FAILURE) {
+				return FAILURE;
+			}
+		} ZEND_HASH_FOREACH_END();
+	} else {
+		smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_HASH);
+		phalcon_cache_frontend_binary_write_varint(e->buf, count);
+
+		ZEND_HASH_FOREACH_KEY_VAL_IND(ht, idx, key, value) {
+			if (key) {
+				phalcon_cache_frontend_binary_write_string(e, key);
+			} else {
+				smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_LONG);
+				phalcon_cache_frontend_binary_write_varint(e->buf, PHALCON_CACHE_FRONTEND_BINARY_ZIGZAG((zend_long)idx));
+			}
+
+			if (phalcon_cache_frontend_binary_write_value(e, value) == FAILURE) {
+				return FAILURE;
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	e->depth--;
+	return SUCCESS;
+}
+
+static int phalcon_cache_frontend_binary_write_serialized(phalcon_cache_frontend_binary_encoder *e, zval *value)
+{
+	php_serialize_data_t var_hash;
+	smart_str buf = {0};
+
+	PHP_VAR_SERIALIZE_INIT(var_hash);
+	php_var_serialize(&buf, value, &var_hash);
+	PHP_VAR_SERIALIZE_DESTROY(var_hash);
+
+	if (EG(exception) || !buf.s) {
+		smart_str_free(&buf);
+		return FAILURE;
+	}
+
+	smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_SERIALIZED);
+	phalcon_cache_frontend_binary_write_varint(e->buf, ZSTR_LEN(buf.s));
+	smart_str_appendl(e->buf, ZSTR_VAL(buf.s), ZSTR_LEN(buf.s));
+	smart_str_free(&buf);
+
+	return SUCCESS;
+}
+
+/**
+ * Models and resultsets overriding serialize()/unserialize() are left to their own methods
+ */
+static int phalcon_cache_frontend_binary_is_native(zend_class_entry *ce, zend_class_entry *base)
+{
+	zend_function *serialize, *unserialize;
+
+	serialize = zend_hash_str_find_ptr(&ce->function_table, SL("serialize"));
+	unserialize = zend_hash_str_find_ptr(&ce->function_table, SL("unserialize"));
+
+	return serialize && unserialize && serialize->common.scope == base && unserialize->common.scope == base;
+}
+
+/**
+ * Collects the same attributes Phalcon\Mvc\Model::serialize() does
+ */
+static int phalcon_cache_frontend_binary_model_data(zval *data, zval *model)
+{
+	zval attributes = {}, column_map = {}, *attribute;
+	int ret = SUCCESS;
+
+	if (phalcon_call_method(&attributes, model, "getattributes", 0, NULL) == FAILURE || Z_TYPE(attributes) != IS_ARRAY) {
+		zval_ptr_dtor(&attributes);
+		return FAILURE;
+	}
+
+	if (phalcon_call_method(&column_map, model, "getcolumnmap", 0, NULL) == FAILURE) {
+		zval_ptr_dtor(&attributes);
+		return FAILURE;
+	}
+
+	array_init_size(data, zend_hash_num_elements(Z_ARRVAL(attributes)));
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(attributes), attribute) {
+		zval attribute_field = {}, attribute_value = {};
+
+		if (Z_TYPE(column_map) == IS_ARRAY) {
+			if (!phalcon_array_isset_fetch(&attribute_field, &column_map, attribute, PH_READONLY)) {
+				ret = FAILURE;
+				break;
+			}
+		} else {
+			ZVAL_COPY_VALUE(&attribute_field, attribute);
+		}
+
+		if (phalcon_property_isset_fetch_zval(&attribute_value, model, &attribute_field, PH_READONLY)) {
+			phalcon_array_update(data, &attribute_field, &attribute_value, PH_COPY);
+		} else {
+			phalcon_array_update(data, &attribute_field, &PHALCON_GLOBAL(z_null), PH_COPY);
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	zval_ptr_dtor(&column_map);
+	zval_ptr_dtor(&attributes);
+
+	if (ret == FAILURE) {
+		zval_ptr_dtor(data);
+		ZVAL_UNDEF(data);
+	}
+
+	return ret;
+}
+
+/**
+ * Collects the same state Phalcon\Mvc\Model\Resultset\Simple::serialize() does
+ */
+static int phalcon_cache_frontend_binary_resultset_data(zval *data, zval *resultset)
+{
+	zval records = {}, count = {}, model = {}, cache = {}, column_map = {}, hydrate_mode = {}, *params[] = { &PHALCON_GLOBAL(z_false) };
+
+	if (phalcon_call_method(&records, resultset, "toarray", 1, params) == FAILURE) {
+		return FAILURE;
+	}
+	phalcon_fast_count(&count, &records);
+
+	phalcon_read_property(&model, resultset, SL("_model"), PH_NOISY|PH_READONLY);
+	phalcon_read_property(&cache, resultset, SL("_cache"), PH_NOISY|PH_READONLY);
+	phalcon_read_property(&column_map, resultset, SL("_columnMap"), PH_NOISY|PH_READONLY);
+	phalcon_read_property(&hydrate_mode, resultset, SL("_hydrateMode"), PH_NOISY|PH_READONLY);
+
+	array_init_size(data, 6);
+	phalcon_array_update_str(data, SL("model"), &model, PH_COPY);
+	phalcon_array_update_str(data, SL("cache"), &cache, PH_COPY);
+	phalcon_array_update_str(data, SL("rows"), &records, 0);
+	phalcon_array_update_str(data, SL("columnMap"), &column_map, PH_COPY);
+	phalcon_array_update_str(data, SL("hydrateMode"), &hydrate_mode, PH_COPY);
+	phalcon_array_update_str(data, SL("count"), &count, 0);
+
+	/**
+	 * Force to re-execute the query
+	 */
+	phalcon_update_property_bool(resultset, SL("_activeRow"), 0);
+
+	return SUCCESS;
+}
+
+static int phalcon_cache_frontend_binary_write_object(phalcon_cache_frontend_binary_encoder *e, zval *object)
+{
+	zend_class_entry *ce = Z_OBJCE_P(object);
+	zval data = {};
+	int ret, tag;
+
+	if (ce == zend_standard_class_def) {
+		/* A properties table must never be decoded as a packed array, so it is always written with its keys */
+		smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_STDCLASS);
+		return phalcon_cache_frontend_binary_write_array(e, Z_OBJPROP_P(object), 0);
+	}
+
+	if (instanceof_function(ce, phalcon_mvc_model_ce) && phalcon_cache_frontend_binary_is_native(ce, phalcon_mvc_model_ce)) {
+		ret = phalcon_cache_frontend_binary_model_data(&data, object);
+		tag = PHALCON_CACHE_FRONTEND_BINARY_MODEL;
+	} else if (instanceof_function(ce, phalcon_mvc_model_resultset_simple_ce) && phalcon_cache_frontend_binary_is_native(ce, phalcon_mvc_model_resultset_simple_ce)) {
+		ret = phalcon_cache_frontend_binary_resultset_data(&data, object);
+		tag = PHALCON_CACHE_FRONTEND_BINARY_RESULTSET;
+	} else {
+		return phalcon_cache_frontend_binary_write_serialized(e, object);
+	}
+
+	if (ret == FAILURE) {
+		/* serialize() reports the error, if there is one to report */
+		return EG(exception) ? FAILURE : phalcon_cache_frontend_binary_write_serialized(e, object);
+	}
+
+	smart_str_appendc(e->buf, tag);
+	phalcon_cache_frontend_binary_write_string(e, ce->name);
+	ret = phalcon_cache_frontend_binary_write_array(e, Z_ARRVAL(data), 1);
+	zval_ptr_dtor(&data);
+
+	return ret;
+}
+
+static int phalcon_cache_frontend_binary_write_value(phalcon_cache_frontend_binary_encoder *e, zval *value)
+{
+	unsigned char tmp[8];
+	uint64_t bits;
+	double d;
+	int i;
+
+again:
+	switch (Z_TYPE_P(value)) {
+		case IS_UNDEF:
+		case IS_NULL:
+			smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_NULL);
+			break;
+
+		case IS_FALSE:
+			smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_FALSE);
+			break;
+
+		case IS_TRUE:
+			smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_TRUE);
+			break;
+
+		case IS_LONG:
+			smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_LONG);
+			phalcon_cache_frontend_binary_write_varint(e->buf, PHALCON_CACHE_FRONTEND_BINARY_ZIGZAG(Z_LVAL_P(value)));
+			break;
+
+		case IS_DOUBLE:
+			d = Z_DVAL_P(value);
+			memcpy(&bits, &d, sizeof(bits));
+			for (i = 0; i < 8; i++) {
+				tmp[i] = (unsigned char)(bits >> (i * 8));
+			}
+			smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_DOUBLE);
+			smart_str_appendl(e->buf, (const char *)tmp, 8);
+			break;
+
+		case IS_STRING:
+			phalcon_cache_frontend_binary_write_string(e, Z_STR_P(value));
+			break;
+
+		case IS_ARRAY:
+			return phalcon_cache_frontend_binary_write_array(e, Z_ARRVAL_P(value), 1);
+
+		case IS_OBJECT:
+			return phalcon_cache_frontend_binary_write_object(e, value);
+
+		case IS_REFERENCE:
+			value = Z_REFVAL_P(value);
+			goto again;
+
+		default:
+			/* Resources are stored as serialize() does */
+			smart_str_appendc(e->buf, PHALCON_CACHE_FRONTEND_BINARY_LONG);
+			phalcon_cache_frontend_binary_write_varint(e->buf, 0);
+			break;
+	}
+
+	return SUCCESS;
+}
+
+static int phalcon_cache_frontend_binary_read_varint(phalcon_cache_frontend_binary_decoder *d, zend_ulong *v)
+{
+	zend_ulong result = 0;
+	unsigned int shift = 0;
+
+	while (d->p < d->end && shift < sizeof(zend_ulong) * 8) {
+		unsigned char c = *d->p++;
+
+		result |= (zend_ulong)(c & 0x7f) << shift;
+		if (!(c & 0x80)) {
+			*v = result;
+			return SUCCESS;
+		}
+		shift += 7;
+	}
+
+	return FAILURE;
+}
+
+static int phalcon_cache_frontend_binary_read_string(phalcon_cache_frontend_binary_decoder *d, unsigned char tag, zend_string **str)
+{
+	zend_ulong len;
+
+	if (phalcon_cache_frontend_binary_read_varint(d, &len) == FAILURE) {
+		return FAILURE;
+	}
+
+	if (tag == PHALCON_CACHE_FRONTEND_BINARY_STRING_REF) {
+		if (len >= d->strings_num) {
+			return FAILURE;
+		}
+		*str = zend_string_copy(d->strings[len]);
+		return SUCCESS;
+	}
+
+	if (len > (zend_ulong)(d->end - d->p)) {
+		return FAILURE;
+	}
+
+	*str = zend_string_init((const char *)d->p, len, 0);
+	d->p += len;
+
+	if (len <= PHALCON_CACHE_FRONTEND_BINARY_MAX_SHARED_LEN) {
+		if (d->strings_num == d->strings_size) {
+			d->strings_size = d->strings_size ? d->strings_size * 2 : 16;
+			d->strings = erealloc(d->strings, sizeof(zend_string *) * d->strings_size);
+		}
+		d->strings[d->strings_num++] = zend_string_copy(*str);
+	}
+
+	return SUCCESS;
+}
+
+static int phalcon_cache_frontend_binary_read_count(phalcon_cache_frontend_binary_decoder *d, zend_ulong *count)
+{
+	if (phalcon_cache_frontend_binary_read_varint(d, count) == FAILURE) {
+		return FAILURE;
+	}
+
+	/* Every element takes one byte at least, this also bounds the preallocation */
+	if (*count > (zend_ulong)(d->end - d->p) || ++d->depth > PHALCON_CACHE_FRONTEND_BINARY_MAX_DEPTH) {
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+static int phalcon_cache_frontend_binary_read_list(phalcon_cache_frontend_binary_decoder *d, zval *rv)
+{
+	zend_ulong count, i;
+
+	if (phalcon_cache_frontend_binary_read_count(d, &count) == FAILURE) {
+		return FAILURE;
+	}
+
+	array_init_size(rv, (uint32_t)count);
+	if (count) {
+		zend_hash_real_init(Z_ARRVAL_P(rv), 1);
+	}
+
+	for (i = 0; i < count; i++) {
+		zval value = {};
+
+		if (phalcon_cache_frontend_binary_read_value(d, &value) == FAILURE) {
+			zval_ptr_dtor(rv);
+			return FAILURE;
+		}
+		zend_hash_next_index_insert_new(Z_ARRVAL_P(rv), &value);
+	}
+
+	d->depth--;
+	return SUCCESS;
+}
+
+static int phalcon_cache_frontend_binary_read_hash(phalcon_cache_frontend_binary_decoder *d, zval *rv)
+{
+	zend_ulong count, i, idx;
+
+	if (phalcon_cache_frontend_binary_read_count(d, &count) == FAILURE) {
+		return FAILURE;
+	}
+
+	array_init_size(rv, (uint32_t)count);
+
+	for (i = 0; i < count; i++) {
+		zend_string *key = NULL;
+		zval value = {};
+		unsigned char tag;
+
+		if (d->p >= d->end) {
+			zval_ptr_dtor(rv);
+			return FAILURE;
+		}
+
+		tag = *d->p++;
+		if (tag == PHALCON_CACHE_FRONTEND_BINARY_LONG) {
+			if (phalcon_cache_frontend_binary_read_varint(d, &idx) == FAILURE) {
+				zval_ptr_dtor(rv);
+				return FAILURE;
+			}
+		} else if (tag != PHALCON_CACHE_FRONTEND_BINARY_STRING && tag != PHALCON_CACHE_FRONTEND_BINARY_STRING_REF) {
+			zval_ptr_dtor(rv);
+			return FAILURE;
+		} else if (phalcon_cache_frontend_binary_read_string(d, tag, &key) == FAILURE) {
+			zval_ptr_dtor(rv);
+			return FAILURE;
+		}
+
+		if (phalcon_cache_frontend_binary_read_value(d, &value) == FAILURE) {
+			if (key) {
+				zend_string_release(key);
+			}
+			zval_ptr_dtor(rv);
+			return FAILURE;
+		}
+
+		if (key) {
+			zend_hash_update(Z_ARRVAL_P(rv), key, &value);
+			zend_string_release(key);
+		} else {
+			zend_hash_index_update(Z_ARRVAL_P(rv), (zend_ulong)PHALCON_CACHE_FRONTEND_BINARY_UNZIGZAG(idx), &value);
+		}
+	}
+
+	d->depth--;
+	return SUCCESS;
+}
+
+/**
+ * Restores the object the way Phalcon\Mvc\Model::unserialize() does
+ */
+static int phalcon_cache_frontend_binary_model_init(zval *rv, zval *data)
+{
+	zval models_manager = {}, *params[] = { rv }, *value;
+	zend_string *str_key;
+
+	if (phalcon_call_method(&models_manager, rv, "getmodelsmanager", 0, NULL) == FAILURE) {
+		return FAILURE;
+	}
+
+	if (phalcon_call_method(NULL, &models_manager, "initialize", 1, params) == FAILURE) {
+		zval_ptr_dtor(&models_manager);
+		return FAILURE;
+	}
+	zval_ptr_dtor(&models_manager);
+
+	ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(data), str_key, value) {
+		if (str_key) {
+			phalcon_update_property_string_zval(rv, str_key, value);
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	return SUCCESS;
+}
+
+/**
+ * Restores the object the way Phalcon\Mvc\Model\Resultset\Simple::unserialize() does
+ */
+static int phalcon_cache_frontend_binary_resultset_init(zval *rv, zval *data)
+{
+	zval model = {}, rows = {}, count = {}, cache = {}, column_map = {}, hydrate_mode = {};
+
+	if (!phalcon_array_isset_fetch_str(&model, data, SL("model"), PH_READONLY)
+		|| !phalcon_array_isset_fetch_str(&rows, data, SL("rows"), PH_READONLY)
+		|| !phalcon_array_isset_fetch_str(&count, data, SL("count"), PH_READONLY)
+		|| !phalcon_array_isset_fetch_str(&cache, data, SL("cache"), PH_READONLY)
+		|| !phalcon_array_isset_fetch_str(&column_map, data, SL("columnMap"), PH_READONLY)
+		|| !phalcon_array_isset_fetch_str(&hydrate_mode, data, SL("hydrateMode"), PH_READONLY)) {
+		return FAILURE;
+	}
+
+	phalcon_update_property_long(rv, SL("_type"), PHALCON_MVC_MODEL_RESULTSET_TYPE_FULL);
+	phalcon_update_property(rv, SL("_model"), &model);
+	phalcon_update_property(rv, SL("_rows"), &rows);
+	phalcon_update_property(rv, SL("_count"), &count);
+	phalcon_update_property(rv, SL("_cache"), &cache);
+	phalcon_update_property(rv, SL("_columnMap"), &column_map);
+	phalcon_update_property(rv, SL("_hydrateMode"), &hydrate_mode);
+
+	return SUCCESS;
+}
+
+static int phalcon_cache_frontend_binary_read_object(phalcon_cache_frontend_binary_decoder *d, unsigned char tag, zval *rv)
+{
+	zend_class_entry *ce, *base;
+	zend_string *class_name;
+	zval data = {};
+	int ret;
+
+	if (d->p >= d->end || (*d->p != PHALCON_CACHE_FRONTEND_BINARY_STRING && *d->p != PHALCON_CACHE_FRONTEND_BINARY_STRING_REF)) {
+		return FAILURE;
+	}
+
+	if (tag == PHALCON_CACHE_FRONTEND_BINARY_MODEL) {
+		base = phalcon_mvc_model_ce;
+	} else {
+		base = phalcon_mvc_model_resultset_simple_ce;
+	}
+
+	if (phalcon_cache_frontend_binary_read_string(d, *d->p++, &class_name) == FAILURE) {
+		return FAILURE;
+	}
+
+	ce = zend_lookup_class(class_name);
+	zend_string_release(class_name);
+
+	if (!ce || !instanceof_function(ce, base) || EG(exception)) {
+		return FAILURE;
+	}
+
+	if (phalcon_cache_frontend_binary_read_value(d, &data) == FAILURE) {
+		return FAILURE;
+	}
+
+	if (Z_TYPE(data) != IS_ARRAY) {
+		zval_ptr_dtor(&data);
+		return FAILURE;
+	}
+
+	object_init_ex(rv, ce);
+
+	if (tag == PHALCON_CACHE_FRONTEND_BINARY_MODEL) {
+		ret = phalcon_cache_frontend_binary_model_init(rv, &data);
+	} else {
+		ret = phalcon_cache_frontend_binary_resultset_init(rv, &data);
+	}
+	zval_ptr_dtor(&data);
+
+	if (ret == FAILURE) {
+		zval_ptr_dtor(rv);
+		ZVAL_UNDEF(rv);
+	}
+
+	return ret;
+}
+
+static int phalcon_cache_frontend_binary_read_serialized(phalcon_cache_frontend_binary_decoder *d, zval *rv)
+{
+	php_unserialize_data_t var_hash;
+	const unsigned char *p;
+	zend_ulong len;
+
+	if (phalcon_cache_frontend_binary_read_varint(d, &len) == FAILURE || len > (zend_ulong)(d->end - d->p)) {
+		return FAILURE;
+	}
+
+	p = d->p;
+	ZVAL_NULL(rv);
+
+	PHP_VAR_UNSERIALIZE_INIT(var_hash);
+	if (!php_var_unserialize(rv, &p, d->p + len, &var_hash)) {
+		PHP_VAR_UNSERIALIZE_DESTROY(var_hash);
+		zval_ptr_dtor(rv);
+		ZVAL_UNDEF(rv);
+		return FAILURE;
+	}
+	PHP_VAR_UNSERIALIZE_DESTROY(var_hash);
+
+	d->p += len;
+	return SUCCESS;
+}
+
+static int phalcon_cache_frontend_binary_read_value(phalcon_cache_frontend_binary_decoder *d, zval *rv)
+{
+	zend_string *str;
+	zend_ulong u;
+	uint64_t bits = 0;
+	double dval;
+	unsigned char tag;
+	int i;
+
+	if (d->p >= d->end) {
+		return FAILURE;
+	}
+
+	tag = *d->p++;
+	switch (tag) {
+		case PHALCON_CACHE_FRONTEND_BINARY_NULL:
+			ZVAL_NULL(rv);
+			break;
+
+		case PHALCON_CACHE_FRONTEND_BINARY_FALSE:
+			ZVAL_FALSE(rv);
+			break;
+
+		case PHALCON_CACHE_FRONTEND_BINARY_TRUE:
+			ZVAL_TRUE(rv);
+			break;
+
+		case PHALCON_CACHE_FRONTEND_BINARY_LONG:
+			if (phalcon_cache_frontend_binary_read_varint(d, &u) == FAILURE) {
+				return FAILURE;
+			}
+			ZVAL_LONG(rv, PHALCON_CACHE_FRONTEND_BINARY_UNZIGZAG(u));
+			break;
+
+		case PHALCON_CACHE_FRONTEND_BINARY_DOUBLE:
+			if (d->end - d->p < 8) {
+				return FAILURE;
+			}
+			for (i = 0; i < 8; i++) {
+				bits |= (uint64_t)d->p[i] << (i * 8);
+			}
+			d->p += 8;
+			memcpy(&dval, &bits, sizeof(dval));
+			ZVAL_DOUBLE(rv, dval);
+			break;
+
+		case PHALCON_CACHE_FRONTEND_BINARY_STRING:
+		case PHALCON_CACHE_FRONTEND_BINARY_STRING_REF:
+			if (phalcon_cache_frontend_binary_read_string(d, tag, &str) == FAILURE) {
+				return FAILURE;
+			}
+			ZVAL_STR(rv, str);
+			break;
+
+		case PHALCON_CACHE_FRONTEND_BINARY_LIST:
+			return phalcon_cache_frontend_binary_read_list(d, rv);
+
+		case PHALCON_CACHE_FRONTEND_BINARY_HASH:
+			return phalcon_cache_frontend_binary_read_hash(d, rv);
+
+		case PHALCON_CACHE_FRONTEND_BINARY_STDCLASS:
+			{
+				zval properties = {};
+
+				if (d->p >= d->end || *d->p != PHALCON_CACHE_FRONTEND_BINARY_HASH) {
+					return FAILURE;
+				}
+
+				d->p++;
+				if (phalcon_cache_frontend_binary_read_hash(d, &properties) == FAILURE) {
+					return FAILURE;
+				}
+
+				/* The properties table is handed over to the object */
+				object_and_properties_init(rv, zend_standard_class_def, Z_ARRVAL(properties));
+			}
+			break;
+
+		case PHALCON_CACHE_FRONTEND_BINARY_MODEL:
+		case PHALCON_CACHE_FRONTEND_BINARY_RESULTSET:
+			return phalcon_cache_frontend_binary_read_object(d, tag, rv);
+
+		case PHALCON_CACHE_FRONTEND_BINARY_SERIALIZED:
+			return phalcon_cache_frontend_binary_read_serialized(d, rv);
+
+		default:
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Encodes a value, the buffer is not terminated
+ */
+int phalcon_cache_frontend_binary_pack(smart_str *buf, zval *data)
+{
+	phalcon_cache_frontend_binary_encoder e;
+	int ret;
+
+	e.buf = buf;
+	e.depth = 0;
+	zend_hash_init(&e.strings, 16, NULL, NULL, 0);
+
+	smart_str_appendc(buf, PHALCON_CACHE_FRONTEND_BINARY_MAGIC);
+	smart_str_appendc(buf, PHALCON_CACHE_FRONTEND_BINARY_VERSION);
+
+	ret = phalcon_cache_frontend_binary_write_value(&e, data);
+
+	zend_hash_destroy(&e.strings);
+
+	return ret;
+}
+
+/**
+ * Decodes a value, on failure offset points to the byte where the decoding stopped
+ */
+int phalcon_cache_frontend_binary_unpack(zval *rv, const char *data, size_t len, size_t *offset)
+{
+	phalcon_cache_frontend_binary_decoder d;
+	uint32_t i;
+	int ret;
+
+	ZVAL_NULL(rv);
+
+	if (len < 2 || data[0] != PHALCON_CACHE_FRONTEND_BINARY_MAGIC || data[1] != PHALCON_CACHE_FRONTEND_BINARY_VERSION) {
+		if (offset) {
+			*offset = 0;
+		}
+		return FAILURE;
+	}
+
+	d.p = (const unsigned char *)data + 2;
+	d.end = (const unsigned char *)data + len;
+	d.strings = NULL;
+	d.strings_num = 0;
+	d.strings_size = 0;
+	d.depth = 0;
+
+	ret = phalcon_cache_frontend_binary_read_value(&d, rv);
+	if (ret == SUCCESS && d.p != d.end) {
+		zval_ptr_dtor(rv);
+		ret = FAILURE;
+	}
+
+	if (ret == FAILURE) {
+		ZVAL_NULL(rv);
+	}
+
+	if (offset) {
+		*offset = (const char *)d.p - data;
+	}
+
+	for (i = 0; i < d.strings_num; i++) {
+		zend_string_release(d.strings[i]);
+	}
+	if (d.strings) {
+		efree(d.strings);
+	}
+
+	return ret;
+}
+
+/**
+ * Serializes data before storing them
+ *
+ * @param mixed $data
+ * @return string
+ */
+PHP_METHOD(Phalcon_Cache_Frontend_Binary, beforeStore){
+
+	zval *data;
+	smart_str buf = {0};
+
+	phalcon_fetch_params(0, 1, 0, &data);
+
+	if (phalcon_cache_frontend_binary_pack(&buf, data) == FAILURE) {
+		smart_str_free(&buf);
+		if (!EG(exception)) {
+			PHALCON_THROW_EXCEPTION_STR(phalcon_cache_exception_ce, "The data can't be serialized");
+		}
+		return;
+	}
+
+	smart_str_0(&buf);
+	RETURN_STR(buf.s);
+}
+
+/**
+ * Unserializes data after retrieval
+ *
+ * @param mixed $data
+ * @return mixed
+ */
+PHP_METHOD(Phalcon_Cache_Frontend_Binary, afterRetrieve){
+
+	zval *data;
+	size_t offset = 0;
+
+	phalcon_fetch_params(0, 1, 0, &data);
+
+	if (Z_TYPE_P(data) != IS_STRING) {
+		RETURN_FALSE;
+	}
+
+	if (phalcon_cache_frontend_binary_unpack(return_value, Z_STRVAL_P(data), Z_STRLEN_P(data), &offset) == FAILURE) {
+		if (!EG(exception)) {
+			php_error_docref(NULL, E_NOTICE, "Error at offset %ld of %lu bytes", (long)offset, (unsigned long)Z_STRLEN_P(data));
+		}
+		RETURN_FALSE;
+	}
+}
@@ -0,0 +1,56 @@
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2014 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  |          ZhuZongXin <dreamsxin@qq.com>                                 |
+  +------------------------------------------------------------------------+
+*/
+
+#ifndef PHALCON_CACHE_FRONTEND_BINARY_H
+#define PHALCON_CACHE_FRONTEND_BINARY_H
+
+#include "php_phalcon.h"
+
+#include <Zend/zend_smart_str.h>
+
+#define PHALCON_CACHE_FRONTEND_BINARY_MAGIC          'B'
+#define PHALCON_CACHE_FRONTEND_BINARY_VERSION        1
+
+#define PHALCON_CACHE_FRONTEND_BINARY_NULL           0x00
+#define PHALCON_CACHE_FRONTEND_BINARY_FALSE          0x01
+#define PHALCON_CACHE_FRONTEND_BINARY_TRUE           0x02
+#define PHALCON_CACHE_FRONTEND_BINARY_LONG           0x03
+#define PHALCON_CACHE_FRONTEND_BINARY_DOUBLE         0x04
+#define PHALCON_CACHE_FRONTEND_BINARY_STRING         0x05
+#define PHALCON_CACHE_FRONTEND_BINARY_STRING_REF     0x06
+#define PHALCON_CACHE_FRONTEND_BINARY_LIST           0x07
+#define PHALCON_CACHE_FRONTEND_BINARY_HASH           0x08
+#define PHALCON_CACHE_FRONTEND_BINARY_STDCLASS       0x09
+#define PHALCON_CACHE_FRONTEND_BINARY_MODEL          0x0a
+#define PHALCON_CACHE_FRONTEND_BINARY_RESULTSET      0x0b
+#define PHALCON_CACHE_FRONTEND_BINARY_SERIALIZED     0x0c
+
+/* Only short strings are worth a lookup in the dedup table, they are the ones repeated: keys, class names, enums */
+#define PHALCON_CACHE_FRONTEND_BINARY_MAX_SHARED_LEN 64
+#define PHALCON_CACHE_FRONTEND_BINARY_MAX_DEPTH      512
+
+extern zend_class_entry *phalcon_cache_frontend_binary_ce;
+
+PHALCON_INIT_CLASS(Phalcon_Cache_Frontend_Binary);
+
+int phalcon_cache_frontend_binary_pack(smart_str *buf, zval *data);
+int phalcon_cache_frontend_binary_unpack(zval *rv, const char *data, size_t len, size_t *offset);
+
+#endif /* PHALCON_CACHE_FRONTEND_BINARY_H */
@@ -23,6 +23,7 @@
 
 #include "kernel/main.h"
 #include "kernel/memory.h"
+#include "kernel/array.h"
 #include "kernel/exception.h"
 #include "kernel/object.h"
 #include "kernel/fcall.h"
@@ -79,6 +80,9 @@ PHP_METHOD(Phalcon_Cache_Multiple, get);
 PHP_METHOD(Phalcon_Cache_Multiple, start);
 PHP_METHOD(Phalcon_Cache_Multiple, save);
 PHP_METHOD(Phalcon_Cache_Multiple, delete);
+PHP_METHOD(Phalcon_Cache_Multiple, getMultiple);
+PHP_METHOD(Phalcon_Cache_Multiple, saveMultiple);
+PHP_METHOD(Phalcon_Cache_Multiple, deleteMultiple);
 PHP_METHOD(Phalcon_Cache_Multiple, exists);
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_multiple___construct, 0, 0, 0)
@@ -122,6 +126,9 @@ static const zend_function_entry phalcon_cache_multiple_method_entry[] = {
 	PHP_ME(Phalcon_Cache_Multiple, start, arginfo_phalcon_cache_multiple_start, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Multiple, save, arginfo_phalcon_cache_multiple_save, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Multiple, delete, arginfo_phalcon_cache_multiple_delete, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Multiple, getMultiple, arginfo_phalcon_cache_backendinterface_getmultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Multiple, saveMultiple, arginfo_phalcon_cache_backendinterface_savemultiple, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Multiple, deleteMultiple, arginfo_phalcon_cache_backendinterface_deletemultiple, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Multiple, exists, arginfo_phalcon_cache_multiple_exists, ZEND_ACC_PUBLIC)
 	PHP_FE_END
 };
@@ -286,6 +293,120 @@ PHP_METHOD(Phalcon_Cache_Multiple, delete){
 	}
 }
 
+/**
+ * Returns several cached contents, asking each backend only for the keys still missing
+ *
+ * @param array $keys
+ * @param mixed $defaultValue
+ * @return array
+ */
+PHP_METHOD(Phalcon_Cache_Multiple, getMultiple){
+
+	zval *keys, *default_value = NULL, backends = {}, pending = {}, found = {}, *backend, *key_name;
+
+	phalcon_fetch_params(0, 1, 1, &keys, &default_value);
+
+	if (!default_value) {
+		default_value = &PHALCON_GLOBAL(z_null);
+	}
+
+	ZVAL_COPY(&pending, keys);
+	array_init(&found);
+
+	phalcon_read_property(&backends, getThis(), SL("_backends"), PH_NOISY|PH_READONLY);
+	if (Z_TYPE(backends) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(backends), backend) {
+			zval contents = {}, missing = {};
+			int flag;
+
+			if (!zend_hash_num_elements(Z_ARRVAL(pending))) {
+				break;
+			}
+
+			PHALCON_CALL_METHOD_FLAG(flag, &contents, backend, "getmultiple", &pending);
+			if (flag == FAILURE) {
+				zval_ptr_dtor(&pending);
+				zval_ptr_dtor(&found);
+				return;
+			}
+
+			array_init(&missing);
+			ZEND_HASH_FOREACH_VAL(Z_ARRVAL(pending), key_name) {
+				zval content = {};
+				if (Z_TYPE(contents) == IS_ARRAY && phalcon_array_isset_fetch(&content, &contents, key_name, PH_READONLY) && Z_TYPE(content) > IS_NULL) {
+					phalcon_array_update(&found, key_name, &content, PH_COPY);
+				} else {
+					phalcon_array_append(&missing, key_name, PH_COPY);
+				}
+			} ZEND_HASH_FOREACH_END();
+			zval_ptr_dtor(&contents);
+			zval_ptr_dtor(&pending);
+			ZVAL_COPY_VALUE(&pending, &missing);
+		} ZEND_HASH_FOREACH_END();
+	}
+	zval_ptr_dtor(&pending);
+
+	array_init(return_value);
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(keys), key_name) {
+		zval content = {};
+		if (phalcon_array_isset_fetch(&content, &found, key_name, PH_READONLY)) {
+			phalcon_array_update(return_value, key_name, &content, PH_COPY);
+		} else {
+			phalcon_array_update(return_value, key_name, default_value, PH_COPY);
+		}
+	} ZEND_HASH_FOREACH_END();
+	zval_ptr_dtor(&found);
+}
+
+/**
+ * Stores several contents into all backends
+ *
+ * @param array $values
+ * @param long $lifetime
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Multiple, saveMultiple){
+
+	zval *values, *lifetime = NULL, backends = {}, *backend;
+
+	phalcon_fetch_params(0, 1, 1, &values, &lifetime);
+
+	if (!lifetime) {
+		lifetime = &PHALCON_GLOBAL(z_null);
+	}
+
+	phalcon_read_property(&backends, getThis(), SL("_backends"), PH_NOISY|PH_READONLY);
+	if (Z_TYPE(backends) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(backends), backend) {
+			PHALCON_CALL_METHOD(NULL, backend, "savemultiple", values, lifetime);
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	RETURN_TRUE;
+}
+
+/**
+ * Deletes several values from each backend
+ *
+ * @param array $keys
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Multiple, deleteMultiple){
+
+	zval *keys, backends = {}, *backend;
+
+	phalcon_fetch_params(0, 1, 0, &keys);
+
+	phalcon_read_property(&backends, getThis(), SL("_backends"), PH_NOISY|PH_READONLY);
+	if (Z_TYPE(backends) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(backends), backend) {
+			PHALCON_CALL_METHOD(NULL, backend, "deletemultiple", keys);
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	RETURN_TRUE;
+}
+
 /**
  * Checks if cache exists in at least one backend
  *
@@ -50,6 +50,9 @@ PHP_METHOD(Phalcon_Cache_Yac, add);
 PHP_METHOD(Phalcon_Cache_Yac, set);
 PHP_METHOD(Phalcon_Cache_Yac, get);
 PHP_METHOD(Phalcon_Cache_Yac, delete);
+PHP_METHOD(Phalcon_Cache_Yac, increment);
+PHP_METHOD(Phalcon_Cache_Yac, decrement);
+PHP_METHOD(Phalcon_Cache_Yac, cas);
 PHP_METHOD(Phalcon_Cache_Yac, flush);
 PHP_METHOD(Phalcon_Cache_Yac, dump);
 PHP_METHOD(Phalcon_Cache_Yac, __set);
@@ -74,6 +77,18 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_yac_delete, 0, 0, 1)
 	ZEND_ARG_TYPE_INFO(0, lifetime, IS_LONG, 1)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_yac_increment, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, key, IS_STRING, 0)
+	ZEND_ARG_TYPE_INFO(0, step, IS_LONG, 1)
+	ZEND_ARG_TYPE_INFO(0, lifetime, IS_LONG, 1)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_yac_cas, 0, 0, 3)
+	ZEND_ARG_TYPE_INFO(0, key, IS_STRING, 0)
+	ZEND_ARG_TYPE_INFO(0, expected, IS_LONG, 0)
+	ZEND_ARG_TYPE_INFO(0, desired, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_cache_yac_dump, 0, 0, 0)
 	ZEND_ARG_TYPE_INFO(0, limit, IS_LONG, 1)
 ZEND_END_ARG_INFO()
@@ -92,6 +107,9 @@ static const zend_function_entry phalcon_cache_yac_method_entry[] = {
 	PHP_ME(Phalcon_Cache_Yac, set, arginfo_phalcon_cache_yac_set, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Yac, get, arginfo_phalcon_cache_yac_get, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Yac, delete, arginfo_phalcon_cache_yac_delete, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Yac, increment, arginfo_phalcon_cache_yac_increment, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Yac, decrement, arginfo_phalcon_cache_yac_increment, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Cache_Yac, cas, arginfo_phalcon_cache_yac_cas, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Yac, flush, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Yac, dump, arginfo_phalcon_cache_yac_dump, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Cache_Yac, __set, arginfo_phalcon_cache_yac___set, ZEND_ACC_PUBLIC)
@@ -111,20 +129,20 @@ PHALCON_INIT_CLASS(Phalcon_Cache_Yac){
 	return SUCCESS;
 }
 
-static int phalcon_cache_yac_add_impl(zend_string *prefix, zend_string *key, zval *value, int ttl, int add) /* {{{ */ {
+int phalcon_cache_yac_add_impl(zend_string *prefix, zend_string *key, zval *value, int ttl, int add) /* {{{ */ {
 	int ret = 0, flag = Z_TYPE_P(value);
 	char *msg;
 	time_t tv;
 	zend_string *prefix_key;
 
-	if ((ZSTR_LEN(key) + prefix->len) > PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN) {
+	if ((ZSTR_LEN(key) + prefix->len) > PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN) {
 		php_error_docref(NULL, E_WARNING, "Key%s can not be longer than %d bytes",
-				prefix->len? "(include prefix)" : "", PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN);
+				prefix->len? "(include prefix)" : "", PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN);
 		return ret;
 	}
 
 	if (prefix->len) {
-		prefix_key = strpprintf(PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN, "%s%s", ZSTR_VAL(prefix), ZSTR_VAL(key));
+		prefix_key = strpprintf(0, "%s%s", ZSTR_VAL(prefix), ZSTR_VAL(key));
 		key = prefix_key;
 	}
 
@@ -225,55 +243,57 @@ static int phalcon_cache_yac_add_multi_impl(zend_string *prefix, zval *kvs, int
 	return 1;
 }
 
-static zval * phalcon_cache_yac_get_impl(zend_string *prefix, zend_string *key, zval *rv) /* {{{ */ {
+zval * phalcon_cache_yac_get_impl(zend_string *prefix, zend_string *key, zval *rv) /* {{{ */ {
 	uint32_t flag, size = 0;
-	char *data, *msg;
+	zend_string *data;
+	char *msg;
 	time_t tv;
 	zend_string *prefix_key;
 
-	if ((ZSTR_LEN(key) + prefix->len) > PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN) {
+	if ((ZSTR_LEN(key) + prefix->len) > PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN) {
 		php_error_docref(NULL, E_WARNING, "Key%s can not be longer than %d bytes",
-				prefix->len? "(include prefix)" : "", PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN);
+				prefix->len? "(include prefix)" : "", PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN);
 		return NULL;
 	}
 
 	if (prefix->len) {
-		prefix_key = strpprintf(PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN, "%s%s", ZSTR_VAL(prefix), ZSTR_VAL(key));
+		prefix_key = strpprintf(0, "%s%s", ZSTR_VAL(prefix), ZSTR_VAL(key));
 		key = prefix_key;
 	}
 
 	tv = time(NULL);
-	if (phalcon_cache_yac_storage_find(ZSTR_VAL(key), ZSTR_LEN(key), &data, &size, &flag, tv)) {
+	if (phalcon_cache_yac_storage_find(ZSTR_VAL(key), ZSTR_LEN(key), &data, &flag, tv)) {
+		size = ZSTR_LEN(data);
 		switch ((flag & PHALCON_CACHE_YAC_ENTRY_TYPE_MASK)) {
 			case IS_NULL:
 				if (size == sizeof(int)) {
 					ZVAL_NULL(rv);
 				}
-				efree(data);
+				zend_string_release(data);
 				break;
 			case IS_TRUE:
 				if (size == sizeof(int)) {
 					ZVAL_TRUE(rv);
 				}
-				efree(data);
+				zend_string_release(data);
 				break;
 			case IS_FALSE:
 				if (size == sizeof(int)) {
 					ZVAL_FALSE(rv);
 				}
-				efree(data);
+				zend_string_release(data);
 				break;
 			case IS_LONG:
 				if (size == sizeof(long)) {
-					ZVAL_LONG(rv, *(long*)data);
+					ZVAL_LONG(rv, *(long*)ZSTR_VAL(data));
 				}
-				efree(data);
+				zend_string_release(data);
 				break;
 			case IS_DOUBLE:
 				if (size == sizeof(double)) {
-					ZVAL_DOUBLE(rv, *(double*)data);
+					ZVAL_DOUBLE(rv, *(double*)ZSTR_VAL(data));
 				}
-				efree(data);
+				zend_string_release(data);
 				break;
 			case IS_STRING:
 #if PHP_VERSION_ID >= 70200
@@ -282,22 +302,23 @@ static zval * phalcon_cache_yac_get_impl(zend_string *prefix, zend_string *key,
 			case IS_CONSTANT:
 #endif
 				{
-					ZVAL_STRINGL(rv, data, size);
-					efree(data);
+					/* The storage copied the content into a string already */
+					ZVAL_STR(rv, data);
 				}
 				break;
 			case IS_ARRAY:
 			case IS_OBJECT:
 				{
-					rv = phalcon_cache_yac_serializer_php_unpack(data, size, &msg, rv);
+					rv = phalcon_cache_yac_serializer_php_unpack(ZSTR_VAL(data), size, &msg, rv);
 					if (!rv) {
 						php_error_docref(NULL, E_WARNING, "Unserialization failed");
 					}
-					efree(data);
+					zend_string_release(data);
 				}
 				break;
 			default:
 				php_error_docref(NULL, E_WARNING, "Unexpected valued type '%d'", flag);
+				zend_string_release(data);
 				rv = NULL;
 				break;
 		}
@@ -351,12 +372,12 @@ static zval * phalcon_cache_yac_get_multi_impl(zend_string *prefix, zval *keys,
 }
 
 void phalcon_cache_yac_delete_impl(char *prefix, uint32_t prefix_len, char *key, uint32_t len, int ttl) {
-	char buf[PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN];
+	char buf[PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN + 1];
 	time_t tv = 0;
 
-	if ((len + prefix_len) > PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN) {
+	if ((len + prefix_len) > PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN) {
 		php_error_docref(NULL, E_WARNING, "Key%s can not be longer than %d bytes",
-				prefix_len? "(include prefix)" : "", PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN);
+				prefix_len? "(include prefix)" : "", PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN);
 		return;
 	}
 
@@ -393,6 +414,56 @@ static void phalcon_cache_yac_delete_multi_impl(char *prefix, uint32_t prefix_le
 	} ZEND_HASH_FOREACH_END();
 }
 
+int phalcon_cache_yac_incr_impl(zend_string *prefix, zend_string *key, long step, int ttl, long *result) /* {{{ */ {
+	int ret;
+	zend_string *prefix_key = NULL;
+
+	if ((ZSTR_LEN(key) + prefix->len) > PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN) {
+		php_error_docref(NULL, E_WARNING, "Key%s can not be longer than %d bytes",
+				prefix->len? "(include prefix)" : "", PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN);
+		return 0;
+	}
+
+	if (prefix->len) {
+		prefix_key = strpprintf(0, "%s%s", ZSTR_VAL(prefix), ZSTR_VAL(key));
+		key = prefix_key;
+	}
+
+	ret = phalcon_cache_yac_storage_incr(ZSTR_VAL(key), ZSTR_LEN(key), step, ttl, result, (ulong)time(NULL));
+
+	if (prefix_key) {
+		zend_string_release(prefix_key);
+	}
+
+	return ret;
+}
+/* }}} */
+
+static int phalcon_cache_yac_cas_impl(zend_string *prefix, zend_string *key, long expected, long desired) /* {{{ */ {
+	int ret;
+	zend_string *prefix_key = NULL;
+
+	if ((ZSTR_LEN(key) + prefix->len) > PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN) {
+		php_error_docref(NULL, E_WARNING, "Key%s can not be longer than %d bytes",
+				prefix->len? "(include prefix)" : "", PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN);
+		return 0;
+	}
+
+	if (prefix->len) {
+		prefix_key = strpprintf(0, "%s%s", ZSTR_VAL(prefix), ZSTR_VAL(key));
+		key = prefix_key;
+	}
+
+	ret = phalcon_cache_yac_storage_cas(ZSTR_VAL(key), ZSTR_LEN(key), expected, desired, (ulong)time(NULL));
+
+	if (prefix_key) {
+		zend_string_release(prefix_key);
+	}
+
+	return ret;
+}
+/* }}} */
+
 /**
  * Phalcon\Cache\Yac constructor
  *
@@ -528,6 +599,95 @@ PHP_METHOD(Phalcon_Cache_Yac, delete)
 	RETURN_TRUE;
 }
 
+/**
+ * Atomically increments a counter, the counter is created when it doesn't exist
+ *
+ *<code>
+ *	$yac = new Phalcon\Cache\Yac();
+ *	$hits = $yac->increment('hits');
+ *</code>
+ *
+ * @param string $key
+ * @param long $step
+ * @param long $lifetime
+ * @return long|boolean
+ */
+PHP_METHOD(Phalcon_Cache_Yac, increment)
+{
+	zval *key, *step = NULL, *lifetime = NULL, prefix = {};
+	long result;
+
+	if (!PHALCON_GLOBAL(cache).enable_yac) {
+		RETURN_FALSE;
+	}
+
+	phalcon_fetch_params(0, 1, 2, &key, &step, &lifetime);
+	PHALCON_ENSURE_IS_STRING(key);
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_NOISY|PH_READONLY);
+
+	if (!phalcon_cache_yac_incr_impl(Z_STR(prefix), Z_STR_P(key), step && Z_TYPE_P(step) == IS_LONG ? Z_LVAL_P(step) : 1,
+			lifetime && Z_TYPE_P(lifetime) == IS_LONG ? Z_LVAL_P(lifetime) : 0, &result)) {
+		RETURN_FALSE;
+	}
+
+	RETURN_LONG(result);
+}
+
+/**
+ * Atomically decrements a counter, the counter is created when it doesn't exist
+ *
+ * @param string $key
+ * @param long $step
+ * @param long $lifetime
+ * @return long|boolean
+ */
+PHP_METHOD(Phalcon_Cache_Yac, decrement)
+{
+	zval *key, *step = NULL, *lifetime = NULL, prefix = {};
+	long result;
+
+	if (!PHALCON_GLOBAL(cache).enable_yac) {
+		RETURN_FALSE;
+	}
+
+	phalcon_fetch_params(0, 1, 2, &key, &step, &lifetime);
+	PHALCON_ENSURE_IS_STRING(key);
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_NOISY|PH_READONLY);
+
+	if (!phalcon_cache_yac_incr_impl(Z_STR(prefix), Z_STR_P(key), step && Z_TYPE_P(step) == IS_LONG ? -Z_LVAL_P(step) : -1,
+			lifetime && Z_TYPE_P(lifetime) == IS_LONG ? Z_LVAL_P(lifetime) : 0, &result)) {
+		RETURN_FALSE;
+	}
+
+	RETURN_LONG(result);
+}
+
+/**
+ * Replaces the value of a counter only when it still holds the expected value
+ *
+ * @param string $key
+ * @param long $expected
+ * @param long $desired
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Cache_Yac, cas)
+{
+	zval *key, *expected, *desired, prefix = {};
+
+	if (!PHALCON_GLOBAL(cache).enable_yac) {
+		RETURN_FALSE;
+	}
+
+	phalcon_fetch_params(0, 3, 0, &key, &expected, &desired);
+	PHALCON_ENSURE_IS_STRING(key);
+
+	phalcon_read_property(&prefix, getThis(), SL("_prefix"), PH_NOISY|PH_READONLY);
+
+	RETURN_BOOL(phalcon_cache_yac_cas_impl(Z_STR(prefix), Z_STR_P(key), phalcon_get_intval(expected), phalcon_get_intval(desired)));
+}
+
 PHP_METHOD(Phalcon_Cache_Yac, flush) {
 
 	if (!PHALCON_GLOBAL(cache).enable_yac) {
@@ -33,4 +33,9 @@ extern zend_class_entry *phalcon_cache_yac_ce;
 
 PHALCON_INIT_CLASS(Phalcon_Cache_Yac);
 
+int phalcon_cache_yac_add_impl(zend_string *prefix, zend_string *key, zval *value, int ttl, int add);
+zval * phalcon_cache_yac_get_impl(zend_string *prefix, zend_string *key, zval *rv);
+int phalcon_cache_yac_incr_impl(zend_string *prefix, zend_string *key, long step, int ttl, long *result);
+void phalcon_cache_yac_delete_impl(char *prefix, uint32_t prefix_len, char *key, uint32_t len, int ttl);
+
 #endif /* PHALCON_CACHE_YAC_H */
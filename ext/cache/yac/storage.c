@@ -290,50 +290,136 @@ static inline unsigned int phalcon_cache_yac_crc32(char *data, unsigned int size
 }
 /* }}} */
 
-int phalcon_cache_yac_storage_find(char *key, unsigned int len, char **data, unsigned int *size, unsigned int *flag, unsigned long tv) /* {{{ */ {
+#ifdef PHP_WIN32
+# define PHALCON_CACHE_YAC_ATOMIC_ADD(p, v)       (InterlockedExchangeAdd((volatile LONG *)(p), (v)) + (v))
+# define PHALCON_CACHE_YAC_ATOMIC_CAS(p, o, n)    (InterlockedCompareExchange((volatile LONG *)(p), (n), (o)) == (o))
+#else
+# define PHALCON_CACHE_YAC_ATOMIC_ADD(p, v)       __sync_add_and_fetch((p), (v))
+# define PHALCON_CACHE_YAC_ATOMIC_CAS(p, o, n)    __sync_bool_compare_and_swap((p), (o), (n))
+#endif
+
+/* Counters live at the first aligned address after the key stored out of line, if any */
+#define PHALCON_CACHE_YAC_COUNTER(v, extra)       ((volatile long *)PHALCON_CACHE_YAC_SMM_ALIGNED_SIZE((zend_uintptr_t)((v)->data + (extra))))
+#define PHALCON_CACHE_YAC_COUNTER_SIZE            (sizeof(long) + PHALCON_CACHE_YAC_SMM_ALIGNMENT)
+
+/* {{{ Keys longer than a slot are stored out of line, in front of the value, the slot keeps a
+ * fingerprint made of a second hash and the tail of the key
+ */
+static inline unsigned char *phalcon_cache_yac_storage_fingerprint(char *key, unsigned int len, unsigned char *buf) {
+	ulong h2;
+
+	if (!PHALCON_CACHE_YAC_KEY_IS_LONG(len)) {
+		return (unsigned char *)key;
+	}
+
+	h2 = phalcon_cache_yac_inline_hash_func2(key, len);
+	memcpy(buf, &h2, sizeof(ulong));
+	memcpy(buf + sizeof(ulong), key + len - (PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN - sizeof(ulong)), PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN - sizeof(ulong));
+
+	return buf;
+}
+/* }}} */
+
+static inline int phalcon_cache_yac_storage_match(phalcon_cache_yac_kv_key *k, ulong hash, unsigned int len, unsigned char *fp) /* {{{ */ {
+	return k->val && k->h == hash && PHALCON_CACHE_YAC_KEY_KLEN(*k) == len
+		&& !memcmp(k->key, fp, MIN(len, PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN));
+}
+/* }}} */
+
+/* {{{ Writes the key and the value straight into the allocated value, readers racing with an in place
+ * write copy a content that fails the crc check of the slot
+ */
+static inline void phalcon_cache_yac_storage_write(phalcon_cache_yac_kv_key *k, phalcon_cache_yac_kv_val *val, ulong hash, char *key, unsigned int len, unsigned char *fp, char *data, unsigned int size, unsigned int flag, int ttl, unsigned long tv) {
+	unsigned int extra = PHALCON_CACHE_YAC_KEY_IS_LONG(len) ? len : 0;
+
+	if (extra) {
+		memcpy(val->data, key, len);
+	}
+	if (flag & PHALCON_CACHE_YAC_STORAGE_ATOMIC) {
+		/* The data of a counter is its initial value, it is moved to the aligned address */
+		long initial;
+
+		memcpy(&initial, data, sizeof(long));
+		memset(val->data + extra, 0, size);
+		*PHALCON_CACHE_YAC_COUNTER(val, extra) = initial;
+	} else {
+		memcpy(val->data + extra, data, size);
+	}
+	val->atime = tv;
+	PHALCON_CACHE_YAC_KEY_SET_LEN(*val, len, extra + size);
+
+	k->h = hash;
+	k->val = val;
+	k->flag = flag;
+	k->ttl = ttl ? tv + ttl : 0;
+	k->crc = phalcon_cache_yac_crc32(val->data, extra + size);
+	memcpy(k->key, fp, MIN(len, PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN));
+	PHALCON_CACHE_YAC_KEY_SET_LEN(*k, len, extra + size);
+}
+/* }}} */
+
+/* {{{ Copies a value once, straight into the string handed to PHP, and validates the copy */
+static int phalcon_cache_yac_storage_read(phalcon_cache_yac_kv_key *k, char *key, unsigned int len, zend_string **data, unsigned int *flag, unsigned long tv) {
+	unsigned int extra = PHALCON_CACHE_YAC_KEY_IS_LONG(len) ? len : 0, size = PHALCON_CACHE_YAC_KEY_VLEN(*k), v_len;
+	zend_string *s;
+
+	if ((k->ttl && k->ttl <= tv) || size < extra) {
+		++PHALCON_CACHE_YAC_SG(miss);
+		return 0;
+	}
+
+	v_len = k->val->len;
+
+	if (k->flag & PHALCON_CACHE_YAC_STORAGE_ATOMIC) {
+		/* Counters are only changed by atomic instructions, there is no crc to verify */
+		long value = *PHALCON_CACHE_YAC_COUNTER(k->val, extra);
+
+		if (k->len != v_len || (extra && memcmp(k->val->data, key, len))) {
+			++PHALCON_CACHE_YAC_SG(miss);
+			return 0;
+		}
+
+		s = zend_string_alloc(sizeof(long), 0);
+		memcpy(ZSTR_VAL(s), &value, sizeof(long));
+	} else {
+		s = zend_string_alloc(size, 0);
+		memcpy(ZSTR_VAL(s), k->val->data, size);
+
+		if (k->len != v_len || k->crc != phalcon_cache_yac_crc32(ZSTR_VAL(s), size) || (extra && memcmp(ZSTR_VAL(s), key, len))) {
+			zend_string_free(s);
+			++PHALCON_CACHE_YAC_SG(miss);
+			return 0;
+		}
+
+		if (extra) {
+			memmove(ZSTR_VAL(s), ZSTR_VAL(s) + extra, size - extra);
+			ZSTR_LEN(s) = size - extra;
+		}
+	}
+
+	ZSTR_VAL(s)[ZSTR_LEN(s)] = '\0';
+	k->val->atime = tv;
+	*data = s;
+	*flag = k->flag;
+	++PHALCON_CACHE_YAC_SG(hits);
+
+	return 1;
+}
+/* }}} */
+
+int phalcon_cache_yac_storage_find(char *key, unsigned int len, zend_string **data, unsigned int *flag, unsigned long tv) /* {{{ */ {
 	ulong h, hash, seed;
 	phalcon_cache_yac_kv_key k, *p;
-	phalcon_cache_yac_kv_val v;
+	unsigned char buf[PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN], *fp;
 
+	fp = phalcon_cache_yac_storage_fingerprint(key, len, buf);
 	hash = h = phalcon_cache_yac_inline_hash_func1(key, len);
 	p = &(PHALCON_CACHE_YAC_SG(slots)[h & PHALCON_CACHE_YAC_SG(slots_mask)]);
 	k = *p;
 	if (k.val) {
-		char *s;
 		uint i;
-		if (k.h == hash && PHALCON_CACHE_YAC_KEY_KLEN(k) == len) {
-			v = *(k.val);
-			if (!memcmp(k.key, key, len)) {
-				s = emalloc(PHALCON_CACHE_YAC_KEY_VLEN(k) + 1);
-				memcpy(s, (char *)k.val->data, PHALCON_CACHE_YAC_KEY_VLEN(k));
-do_verify:
-				if (k.len != v.len) {
-					efree(s);
-					++PHALCON_CACHE_YAC_SG(miss);
-					return 0;
-				}
-
-				if (k.ttl) {
-					if (k.ttl <= tv) {
-						++PHALCON_CACHE_YAC_SG(miss);
-						efree(s);
-						return 0;
-					}
-				}
-
-				if (k.crc != phalcon_cache_yac_crc32(s, PHALCON_CACHE_YAC_KEY_VLEN(k))) {
-					efree(s);
-					++PHALCON_CACHE_YAC_SG(miss);
-					return 0;
-				}
-				s[PHALCON_CACHE_YAC_KEY_VLEN(k)] = '\0';
-				k.val->atime = tv;
-				*data = s;
-				*size = PHALCON_CACHE_YAC_KEY_VLEN(k);
-				*flag = k.flag;
-				++PHALCON_CACHE_YAC_SG(hits);
-				return 1;
-			}
+		if (phalcon_cache_yac_storage_match(&k, hash, len, fp)) {
+			return phalcon_cache_yac_storage_read(&k, key, len, data, flag, tv);
 		}
 
 		seed = phalcon_cache_yac_inline_hash_func2(key, len);
@@ -341,13 +427,8 @@ do_verify:
 			h += seed & PHALCON_CACHE_YAC_SG(slots_mask);
 			p = &(PHALCON_CACHE_YAC_SG(slots)[h & PHALCON_CACHE_YAC_SG(slots_mask)]);
 			k = *p;
-			if (k.h == hash && PHALCON_CACHE_YAC_KEY_KLEN(k) == len) {
-				v = *(k.val);
-				if (!memcmp(k.key, key, len)) {
-					s = emalloc(PHALCON_CACHE_YAC_KEY_VLEN(k) + 1);
-					memcpy(s, (char *)k.val->data, PHALCON_CACHE_YAC_KEY_VLEN(k));
-					goto do_verify;
-				}
+			if (phalcon_cache_yac_storage_match(&k, hash, len, fp)) {
+				return phalcon_cache_yac_storage_read(&k, key, len, data, flag, tv);
 			}
 		}
 	}
@@ -361,21 +442,21 @@ do_verify:
 void phalcon_cache_yac_storage_delete(char *key, unsigned int len, int ttl, unsigned long tv) /* {{{ */ {
 	ulong hash, h, seed;
 	phalcon_cache_yac_kv_key k, *p;
+	unsigned char buf[PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN], *fp;
 
+	fp = phalcon_cache_yac_storage_fingerprint(key, len, buf);
 	hash = h = phalcon_cache_yac_inline_hash_func1(key, len);
 	p = &(PHALCON_CACHE_YAC_SG(slots)[h & PHALCON_CACHE_YAC_SG(slots_mask)]);
 	k = *p;
 	if (k.val) {
 		uint i;
-		if (k.h == hash && PHALCON_CACHE_YAC_KEY_KLEN(k) == len) {
-			if (!memcmp((char *)k.key, key, len)) {
-				if (ttl == 0) {
-					p->ttl = 1;
-				} else {
-					p->ttl = ttl + tv;
-				}
-				return;
+		if (phalcon_cache_yac_storage_match(&k, hash, len, fp)) {
+			if (ttl == 0) {
+				p->ttl = 1;
+			} else {
+				p->ttl = ttl + tv;
 			}
+			return;
 		}
 
 		seed = phalcon_cache_yac_inline_hash_func2(key, len);
@@ -385,7 +466,7 @@ void phalcon_cache_yac_storage_delete(char *key, unsigned int len, int ttl, unsi
 			k = *p;
 			if (k.val == NULL) {
 				return;
-			} else if (k.h == hash && PHALCON_CACHE_YAC_KEY_KLEN(k) == len && !memcmp((char *)k.key, key, len)) {
+			} else if (phalcon_cache_yac_storage_match(&k, hash, len, fp)) {
 				p->ttl = 1;
 				return;
 			}
@@ -398,73 +479,44 @@ int phalcon_cache_yac_storage_update(char *key, unsigned int len, char *data, un
 	ulong hash, h;
 	int idx = 0, is_valid;
 	phalcon_cache_yac_kv_key *p, k, *paths[4];
-	phalcon_cache_yac_kv_val *val, *s;
+	phalcon_cache_yac_kv_val *val;
 	unsigned long real_size;
+	unsigned char buf[PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN], *fp;
+	unsigned int msize = sizeof(phalcon_cache_yac_kv_val) + (PHALCON_CACHE_YAC_KEY_IS_LONG(len) ? len : 0) + size - 1;
 
+	fp = phalcon_cache_yac_storage_fingerprint(key, len, buf);
 	hash = h = phalcon_cache_yac_inline_hash_func1(key, len);
 	paths[idx++] = p = &(PHALCON_CACHE_YAC_SG(slots)[h & PHALCON_CACHE_YAC_SG(slots_mask)]);
 	k = *p;
 	if (k.val) {
 		/* Found the exact match */
-		if (k.h == hash && PHALCON_CACHE_YAC_KEY_KLEN(k) == len && !memcmp((char *)k.key, key, len)) {
+		if (phalcon_cache_yac_storage_match(&k, hash, len, fp)) {
 do_update:
 			is_valid = 0;
-			if (k.crc == phalcon_cache_yac_crc32(k.val->data, PHALCON_CACHE_YAC_KEY_VLEN(k))) {
+			if ((k.flag & PHALCON_CACHE_YAC_STORAGE_ATOMIC) || k.crc == phalcon_cache_yac_crc32(k.val->data, PHALCON_CACHE_YAC_KEY_VLEN(k))) {
 				is_valid = 1;
 			}
 			if (add && (!k.ttl || k.ttl > tv) && is_valid) {
 				return 0;
 			}
-			if (k.size >= size && is_valid) {
-				s = emalloc(sizeof(phalcon_cache_yac_kv_val) + size - 1);
-				memcpy(s->data, data, size);
-				if (ttl) {
-					k.ttl = (ulong)tv + ttl;
-				} else {
-					k.ttl = 0;
-				}
-				s->atime = tv;
-				PHALCON_CACHE_YAC_KEY_SET_LEN(*s, len, size);
-				memcpy((char *)k.val, (char *)s, sizeof(phalcon_cache_yac_kv_val) + size - 1);
-				k.crc = phalcon_cache_yac_crc32(s->data, size);
-				k.flag = flag;
-				memcpy(k.key, key, len);
-				PHALCON_CACHE_YAC_KEY_SET_LEN(k, len, size);
+			if (k.size >= msize && is_valid) {
+				phalcon_cache_yac_storage_write(&k, k.val, hash, key, len, fp, data, size, flag, ttl, tv);
 				*p = k;
-				efree(s);
 				return 1;
 			} else {
-				uint msize;
-				real_size = phalcon_cache_yac_allocator_real_size(sizeof(phalcon_cache_yac_kv_val) + (size * PHALCON_CACHE_YAC_STORAGE_FACTOR) - 1);
+				real_size = phalcon_cache_yac_allocator_real_size(msize + (size * (PHALCON_CACHE_YAC_STORAGE_FACTOR - 1)));
 				if (!real_size) {
 					++PHALCON_CACHE_YAC_SG(fails);
 					return 0;
 				}
-				msize = sizeof(phalcon_cache_yac_kv_val) + size - 1;
-				s = emalloc(sizeof(phalcon_cache_yac_kv_val) + size - 1);
-				memcpy(s->data, data, size);
-				s->atime = tv;
-				PHALCON_CACHE_YAC_KEY_SET_LEN(*s, len, size);
 				val = phalcon_cache_yac_allocator_raw_alloc(real_size, (int)hash);
 				if (val) {
-					memcpy((char *)val, (char *)s, msize);
-					if (ttl) {
-						k.ttl = tv + ttl;
-					} else {
-						k.ttl = 0;
-					}
-					k.crc = phalcon_cache_yac_crc32(s->data, size);
-					k.val = val;
-					k.flag = flag;
+					phalcon_cache_yac_storage_write(&k, val, hash, key, len, fp, data, size, flag, ttl, tv);
 					k.size = real_size;
-					memcpy(k.key, key, len);
-					PHALCON_CACHE_YAC_KEY_SET_LEN(k, len, size);
 					*p = k;
-					efree(s);
 					return 1;
 				}
 				++PHALCON_CACHE_YAC_SG(fails);
-				efree(s);
 				return 0;
 			}
 		} else {
@@ -478,7 +530,7 @@ do_update:
 				k = *p;
 				if (k.val == NULL) {
 					goto do_add;
-				} else if (k.h == hash && PHALCON_CACHE_YAC_KEY_KLEN(k) == len && !memcmp((char *)k.key, key, len)) {
+				} else if (phalcon_cache_yac_storage_match(&k, hash, len, fp)) {
 					/* Found the exact match */
 					goto do_update;
 				}
@@ -503,45 +555,153 @@ do_update:
 		}
 	} else {
 do_add:
-		real_size = phalcon_cache_yac_allocator_real_size(sizeof(phalcon_cache_yac_kv_val) + (size * PHALCON_CACHE_YAC_STORAGE_FACTOR) - 1);
+		real_size = phalcon_cache_yac_allocator_real_size(msize + (size * (PHALCON_CACHE_YAC_STORAGE_FACTOR - 1)));
 		if (!real_size) {
 			++PHALCON_CACHE_YAC_SG(fails);
 			return 0;
 		}
-		s = emalloc(sizeof(phalcon_cache_yac_kv_val) + size - 1);
-		memcpy(s->data, data, size);
-		s->atime = tv;
-		PHALCON_CACHE_YAC_KEY_SET_LEN(*s, len, size);
 		val = phalcon_cache_yac_allocator_raw_alloc(real_size, (int)hash);
 		if (val) {
-			memcpy((char *)val, (char *)s, sizeof(phalcon_cache_yac_kv_val) + size - 1);
 			if (p->val == NULL) {
 				++PHALCON_CACHE_YAC_SG(slots_num);
 			}
-			k.h = hash;
-			k.val = val;
-			k.flag = flag;
+			phalcon_cache_yac_storage_write(&k, val, hash, key, len, fp, data, size, flag, ttl, tv);
 			k.size = real_size;
-			k.crc = phalcon_cache_yac_crc32(s->data, size);
-			memcpy(k.key, key, len);
-			PHALCON_CACHE_YAC_KEY_SET_LEN(k, len, size);
-			if (ttl) {
-				k.ttl = tv + ttl;
-			} else {
-				k.ttl = 0;
-			}
 			*p = k;
-			efree(s);
 			return 1;
 		}
 		++PHALCON_CACHE_YAC_SG(fails);
-		efree(s);
 	}
 
 	return 0;
 }
 /* }}} */
 
+/* {{{ Returns the slot of a live entry, the out of line keys are compared in full */
+static phalcon_cache_yac_kv_key *phalcon_cache_yac_storage_lookup(char *key, unsigned int len, unsigned long tv) {
+	ulong h, hash, seed;
+	phalcon_cache_yac_kv_key *p;
+	unsigned char buf[PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN], *fp;
+	uint i;
+
+	fp = phalcon_cache_yac_storage_fingerprint(key, len, buf);
+	hash = h = phalcon_cache_yac_inline_hash_func1(key, len);
+	seed = phalcon_cache_yac_inline_hash_func2(key, len);
+
+	for (i = 0; i < 4; i++) {
+		phalcon_cache_yac_kv_key k;
+
+		if (i) {
+			h += seed & PHALCON_CACHE_YAC_SG(slots_mask);
+		}
+		p = &(PHALCON_CACHE_YAC_SG(slots)[h & PHALCON_CACHE_YAC_SG(slots_mask)]);
+		k = *p;
+		if (k.val == NULL) {
+			return NULL;
+		}
+		if (phalcon_cache_yac_storage_match(&k, hash, len, fp)) {
+			if ((k.ttl && k.ttl <= tv) || k.len != k.val->len
+				|| (PHALCON_CACHE_YAC_KEY_IS_LONG(len) && memcmp(k.val->data, key, len))) {
+				return NULL;
+			}
+			return p;
+		}
+	}
+
+	return NULL;
+}
+/* }}} */
+
+/* {{{ Adds the step to a counter and returns the new value. A missing counter is created with the ttl,
+ * an integer stored by update() is turned into a counter
+ */
+int phalcon_cache_yac_storage_incr(char *key, unsigned int len, long step, int ttl, long *result, unsigned long tv) {
+	phalcon_cache_yac_kv_key *p, k;
+	char counter[PHALCON_CACHE_YAC_COUNTER_SIZE] = {0};
+	unsigned int extra = PHALCON_CACHE_YAC_KEY_IS_LONG(len) ? len : 0;
+	long base;
+	int retry, spins = 0;
+
+	for (retry = 0; retry < 3; retry++) {
+		p = phalcon_cache_yac_storage_lookup(key, len, tv);
+		if (p == NULL) {
+			/* Only one worker creates it, the others add their step to the one created */
+			phalcon_cache_yac_storage_update(key, len, counter, sizeof(counter), IS_LONG | PHALCON_CACHE_YAC_STORAGE_ATOMIC, ttl, 1, tv);
+			continue;
+		}
+
+		k = *p;
+		if (k.flag & PHALCON_CACHE_YAC_STORAGE_ATOMIC) {
+			*result = PHALCON_CACHE_YAC_ATOMIC_ADD(PHALCON_CACHE_YAC_COUNTER(k.val, extra), step);
+			k.val->atime = tv;
+			return 1;
+		} else if (k.flag & PHALCON_CACHE_YAC_STORAGE_CONVERTING) {
+			/* Another worker is turning the integer into a counter, the passes waiting for it are not retries */
+			if (++spins < PHALCON_CACHE_YAC_STORAGE_MAX_SPINS) {
+				retry--;
+			}
+			continue;
+		} else {
+			zend_string *data;
+			unsigned int flag;
+
+			if (!phalcon_cache_yac_storage_find(key, len, &data, &flag, tv)) {
+				continue;
+			}
+
+			if ((flag & ~(PHALCON_CACHE_YAC_STORAGE_ATOMIC | PHALCON_CACHE_YAC_STORAGE_CONVERTING)) != IS_LONG || ZSTR_LEN(data) != sizeof(long)) {
+				zend_string_release(data);
+				return 0;
+			}
+
+			memcpy(&base, ZSTR_VAL(data), sizeof(long));
+			zend_string_release(data);
+
+			/**
+			 * The counter is created holding the integer, the step is added on the next pass like any
+			 * other worker does. Only the worker marking the slot as converting, while it still holds
+			 * the integer read, writes the counter, the others wait for it and add their step to it
+			 */
+			if (p->val != k.val || p->crc != k.crc
+				|| !PHALCON_CACHE_YAC_ATOMIC_CAS(&p->flag, k.flag, k.flag | PHALCON_CACHE_YAC_STORAGE_CONVERTING)) {
+				continue;
+			}
+
+			memcpy(counter, &base, sizeof(long));
+			if (!phalcon_cache_yac_storage_update(key, len, counter, sizeof(counter), IS_LONG | PHALCON_CACHE_YAC_STORAGE_ATOMIC, k.ttl ? (int)(k.ttl - tv) : 0, 0, tv)) {
+				PHALCON_CACHE_YAC_ATOMIC_CAS(&p->flag, k.flag | PHALCON_CACHE_YAC_STORAGE_CONVERTING, k.flag);
+			}
+			memset(counter, 0, sizeof(counter));
+		}
+	}
+
+	return 0;
+}
+/* }}} */
+
+/* {{{ Replaces the value of a counter only if it is still the expected one */
+int phalcon_cache_yac_storage_cas(char *key, unsigned int len, long expected, long desired, unsigned long tv) {
+	phalcon_cache_yac_kv_key *p, k;
+
+	p = phalcon_cache_yac_storage_lookup(key, len, tv);
+	if (p == NULL) {
+		return 0;
+	}
+
+	k = *p;
+	if (!(k.flag & PHALCON_CACHE_YAC_STORAGE_ATOMIC)) {
+		return 0;
+	}
+
+	if (!PHALCON_CACHE_YAC_ATOMIC_CAS(PHALCON_CACHE_YAC_COUNTER(k.val, PHALCON_CACHE_YAC_KEY_IS_LONG(len) ? len : 0), expected, desired)) {
+		return 0;
+	}
+	k.val->atime = tv;
+
+	return 1;
+}
+/* }}} */
+
 void phalcon_cache_yac_storage_flush(void) /* {{{ */ {
 	PHALCON_CACHE_YAC_SG(slots_num) = 0;
 	memset((char *)PHALCON_CACHE_YAC_SG(slots), 0, sizeof(phalcon_cache_yac_kv_key) * PHALCON_CACHE_YAC_SG(slots_size));
@@ -590,7 +750,12 @@ phalcon_cache_yac_item_list * phalcon_cache_yac_storage_dump(unsigned int limit)
 				item->v_len = PHALCON_CACHE_YAC_KEY_VLEN(k);
 				item->flag = k.flag;
 				item->size = k.size;
-				memcpy(item->key, k.key, PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN);
+				if (PHALCON_CACHE_YAC_KEY_IS_LONG(item->k_len)) {
+					memcpy(item->key, k.val->data, item->k_len);
+				} else {
+					memcpy(item->key, k.key, item->k_len);
+				}
+				item->key[item->k_len] = '\0';
 				item->next = list;
 				list = item;
 				++n;
@@ -21,12 +21,18 @@
 
 #define PHALCON_CACHE_YAC_STORAGE_MAX_ENTRY_LEN  	(1 << 20)
 #define PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN		(48)
+#define PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN	(PHALCON_CACHE_YAC_KEY_KLEN_MASK)
+#define PHALCON_CACHE_YAC_STORAGE_ATOMIC			(0x0040)
+/* An integer being turned into a counter, integers are never compressed so the bit is free */
+#define PHALCON_CACHE_YAC_STORAGE_CONVERTING		(0x0080)
+#define PHALCON_CACHE_YAC_STORAGE_MAX_SPINS		(1024)
 #define PHALCON_CACHE_YAC_STORAGE_FACTOR 			(1.25)
 #define PHALCON_CACHE_YAC_KEY_KLEN_MASK			    (255)
 #define PHALCON_CACHE_YAC_KEY_VLEN_BITS			    (8)
 #define PHALCON_CACHE_YAC_KEY_KLEN(k)				((k).len & PHALCON_CACHE_YAC_KEY_KLEN_MASK)
 #define PHALCON_CACHE_YAC_KEY_VLEN(k)				((k).len >> PHALCON_CACHE_YAC_KEY_VLEN_BITS)
 #define PHALCON_CACHE_YAC_KEY_SET_LEN(k, kl, vl)	    ((k).len = (vl << PHALCON_CACHE_YAC_KEY_VLEN_BITS) | (kl & PHALCON_CACHE_YAC_KEY_KLEN_MASK))
+#define PHALCON_CACHE_YAC_KEY_IS_LONG(l)			((l) > PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN)
 #define PHALCON_CACHE_YAC_FULL_CRC_THRESHOLD         256
 
 typedef struct {
@@ -55,7 +61,7 @@ typedef struct _phalcon_cache_yac_item_list {
 	unsigned int v_len;
 	unsigned int flag;
 	unsigned int size;
-	unsigned char key[PHALCON_CACHE_YAC_STORAGE_MAX_KEY_LEN];
+	unsigned char key[PHALCON_CACHE_YAC_STORAGE_MAX_LONG_KEY_LEN + 1];
 	struct _phalcon_cache_yac_item_list *next;
 } phalcon_cache_yac_item_list;
 
@@ -101,15 +107,16 @@ extern phalcon_cache_yac_storage_globals *phalcon_cache_yac_storage;
 
 int phalcon_cache_yac_storage_startup(unsigned long first_size, unsigned long size, char **err);
 void phalcon_cache_yac_storage_shutdown(void);
-int phalcon_cache_yac_storage_find(char *key, unsigned int len, char **data, unsigned int *size, unsigned int *flag, unsigned long tv);
+int phalcon_cache_yac_storage_find(char *key, unsigned int len, zend_string **data, unsigned int *flag, unsigned long tv);
 int phalcon_cache_yac_storage_update(char *key, unsigned int len, char *data, unsigned int size, unsigned int falg, int ttl, int add, unsigned long tv);
 void phalcon_cache_yac_storage_delete(char *key, unsigned int len, int ttl, unsigned long tv);
+int phalcon_cache_yac_storage_incr(char *key, unsigned int len, long step, int ttl, long *result, unsigned long tv);
+int phalcon_cache_yac_storage_cas(char *key, unsigned int len, long expected, long desired, unsigned long tv);
 void phalcon_cache_yac_storage_flush(void);
 const char * phalcon_cache_yac_storage_shared_yac_name(void);
 phalcon_cache_yac_storage_info * phalcon_cache_yac_storage_get_info(void);
 void phalcon_cache_yac_storage_free_info(phalcon_cache_yac_storage_info *info);
 phalcon_cache_yac_item_list * phalcon_cache_yac_storage_dump(unsigned int limit);
 void phalcon_cache_yac_storage_free_list(phalcon_cache_yac_item_list *list);
-#define phalcon_cache_yac_storage_exists(ht, key, len)  phalcon_cache_yac_storage_find(ht, key, len, NULL)
 
 #endif	/* PHALCON_CACHE_YAC_STORAGE_H */
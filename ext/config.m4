@@ -539,6 +539,8 @@ db/builder/select.c \
 db/builder/update.c \
 db/builder/insert.c \
 db/builder/delete.c \
+db/router.c \
+db/pool.c \
 forms/form.c \
 forms/manager.c \
 forms/element/file.c \
@@ -772,6 +774,7 @@ cache/frontend/none.c \
 cache/frontend/base64.c \
 cache/frontend/json.c \
 cache/frontend/igbinary.c \
+cache/frontend/binary.c \
 cache/frontend/data.c \
 cache/frontend/output.c \
 cache/backend/file.c \
@@ -812,6 +815,7 @@ paginator/adapter.c \
 paginator/adapter/model.c \
 paginator/adapter/nativearray.c \
 paginator/adapter/querybuilder.c \
+paginator/adapter/keyset.c \
 paginator/adapter/dbbuilder.c \
 paginator/adapter/sql.c \
 paginator/exception.c \
@@ -911,7 +915,7 @@ aop.c"
 		AC_DEFINE([PHALCON_USE_AOP_PROPERTY], 1, [ ])
 	fi
 	if test "$PHP_CACHE_YAC" = "yes"; then
-		phalcon_sources="$phalcon_sources cache/yac/allocators/mmap.c cache/yac/allocators/shm.c cache/yac/serializer.c cache/yac/storage.c cache/yac/allocator.c cache/yac.c"
+		phalcon_sources="$phalcon_sources cache/yac/allocators/mmap.c cache/yac/allocators/shm.c cache/yac/serializer.c cache/yac/storage.c cache/yac/allocator.c cache/yac.c mvc/model/metadata/shm.c"
 	fi
 
 	if test "$PHP_CHART" = "yes"; then
@@ -1545,7 +1549,7 @@ aop.c"
 			LDFLAGS="$LDFLAGS -lfreebsd-glue"
 		])
 
-		phalcon_sources="$phalcon_sources $async_source_files $UV_SRC"
+		phalcon_sources="$phalcon_sources $async_source_files $UV_SRC db/async/postgresql.c"
 		AC_DEFINE(PHALCON_USE_ASYNC, 1, [Have async support])
 	fi
 
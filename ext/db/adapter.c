@@ -60,6 +60,7 @@ PHP_METHOD(Phalcon_Db_Adapter, fetchOne);
 PHP_METHOD(Phalcon_Db_Adapter, fetchAll);
 PHP_METHOD(Phalcon_Db_Adapter, insert);
 PHP_METHOD(Phalcon_Db_Adapter, insertAsDict);
+PHP_METHOD(Phalcon_Db_Adapter, insertMultiple);
 PHP_METHOD(Phalcon_Db_Adapter, update);
 PHP_METHOD(Phalcon_Db_Adapter, delete);
 PHP_METHOD(Phalcon_Db_Adapter, getColumnList);
@@ -123,6 +124,13 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_adapter_insertasdict, 0, 0, 2)
 	ZEND_ARG_INFO(0, dataTypes)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_adapter_insertmultiple, 0, 0, 2)
+	ZEND_ARG_INFO(0, table)
+	ZEND_ARG_TYPE_INFO(0, rows, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO(0, columns, IS_ARRAY, 1)
+	ZEND_ARG_TYPE_INFO(0, options, IS_ARRAY, 1)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_adapter_createselectbuilder, 0, 0, 1)
 	ZEND_ARG_INFO(0, tables)
 ZEND_END_ARG_INFO()
@@ -149,6 +157,7 @@ static const zend_function_entry phalcon_db_adapter_method_entry[] = {
 	PHP_ME(Phalcon_Db_Adapter, fetchAll, arginfo_phalcon_db_adapterinterface_fetchall, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Adapter, insert, arginfo_phalcon_db_adapterinterface_insert, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Adapter, insertAsDict, arginfo_phalcon_db_adapter_insertasdict, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Adapter, insertMultiple, arginfo_phalcon_db_adapter_insertmultiple, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Adapter, update, arginfo_phalcon_db_adapterinterface_update, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Adapter, delete, arginfo_phalcon_db_adapterinterface_delete, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Adapter, getColumnList, arginfo_phalcon_db_adapterinterface_getcolumnlist, ZEND_ACC_PUBLIC)
@@ -218,6 +227,7 @@ PHALCON_INIT_CLASS(Phalcon_Db_Adapter){
 	zend_declare_property_null(phalcon_db_adapter_ce, SL("_sqlVariables"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_db_adapter_ce, SL("_sqlBindTypes"), ZEND_ACC_PROTECTED);
 	zend_declare_property_long(phalcon_db_adapter_ce, SL("_transactionLevel"), 0, ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_adapter_ce, SL("_lastWrite"), ZEND_ACC_PROTECTED);
 	zend_declare_property_long(phalcon_db_adapter_ce, SL("_transactionsWithSavepoints"), 0, ZEND_ACC_PROTECTED);
 	zend_declare_property_long(phalcon_db_adapter_ce, SL("_connectionConsecutive"), 0, ZEND_ACC_PROTECTED|ZEND_ACC_STATIC);
 
@@ -477,6 +487,38 @@ PHP_METHOD(Phalcon_Db_Adapter, fetchAll){
 	}
 }
 
+/**
+ * Sends one chunk of rows built by insertMultiple and accumulates the affected rows
+ */
+static int phalcon_db_adapter_insert_chunk(zval *object, zval *escaped_table, zval *joined_fields, zval *rows_placeholders, zval *insert_values, zval *bind_data_types, zval *on_conflict, zend_long *affected_rows)
+{
+	zval joined_rows = {}, insert_sql = {}, affected = {};
+	int flag;
+
+	phalcon_fast_join_str(&joined_rows, SL(", "), rows_placeholders);
+	PHALCON_CONCAT_SVSVSV(&insert_sql, "INSERT INTO ", escaped_table, " (", joined_fields, ") VALUES ", &joined_rows);
+	zval_ptr_dtor(&joined_rows);
+
+	if (Z_TYPE_P(on_conflict) == IS_STRING) {
+		phalcon_concat_self(&insert_sql, on_conflict);
+	}
+
+	PHALCON_CALL_METHOD_FLAG(flag, NULL, object, "execute", &insert_sql, insert_values, bind_data_types);
+	zval_ptr_dtor(&insert_sql);
+	if (flag == FAILURE) {
+		return FAILURE;
+	}
+
+	PHALCON_CALL_METHOD_FLAG(flag, &affected, object, "affectedrows");
+	if (flag == FAILURE) {
+		return FAILURE;
+	}
+
+	*affected_rows += phalcon_get_intval(&affected);
+	zval_ptr_dtor(&affected);
+	return SUCCESS;
+}
+
 /**
  * Inserts data into a table using custom RBDM SQL syntax
  *
@@ -674,6 +716,261 @@ PHP_METHOD(Phalcon_Db_Adapter, insertAsDict){
 	zval_ptr_dtor(&fields);
 }
 
+/**
+ * Inserts several rows into a table using multi-row INSERT statements. The rows are sent in chunks
+ * sized to stay below the bound parameters limit of the database system, wrap the call in a
+ * transaction if the rows must be inserted atomically
+ *
+ * <code>
+ * //Inserting two robots, updating the year of the existing ones
+ * $affectedRows = $connection->insertMultiple(
+ *	 "robots",
+ *	 array(
+ *		 array(1, "Astro Boy", 1952),
+ *		 array(2, "Terminator", 1984)
+ *	 ),
+ *	 array("id", "name", "year"),
+ *	 array("conflict" => array("id"), "update" => array("year"))
+ * );
+ *
+ * //Next SQL sentence is sent to the database system (MySQL)
+ * INSERT INTO `robots` (`id`, `name`, `year`) VALUES (?, ?, ?), (?, ?, ?) ON DUPLICATE KEY UPDATE `year` = VALUES(`year`)
+ * </code>
+ *
+ * The columns are taken from the keys of the first row when they are not passed. Available options:
+ * 'dataTypes' (bind types indexed by column name or position), 'chunkSize' (rows per statement),
+ * 'conflict' (unique columns), 'update' (columns to update on conflict, true for all the columns
+ * not in 'conflict') and 'ignore' (keep the existing rows on conflict)
+ *
+ * @param string $table
+ * @param array $rows
+ * @param array $columns
+ * @param array $options
+ * @return int
+ */
+PHP_METHOD(Phalcon_Db_Adapter, insertMultiple){
+
+	zval *table, *rows, *columns = NULL, *options = NULL, fields = {}, data_types = {}, conflict = {}, update = {}, update_fields = {}, ignore = {};
+	zval chunk_size = {}, dialect = {}, dialect_type = {}, on_conflict = {}, escaped_table = {}, escaped_fields = {}, joined_fields = {};
+	zval rows_placeholders = {}, insert_values = {}, bind_data_types = {}, exception_message = {}, *row, *field;
+	zend_long number_fields, rows_per_chunk, max_params, number_rows = 0, affected_rows = 0;
+	zend_string *str_key;
+
+	phalcon_fetch_params(1, 2, 2, &table, &rows, &columns, &options);
+
+	if (unlikely(Z_TYPE_P(rows) != IS_ARRAY)) {
+		PHALCON_MM_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The second parameter for insertMultiple isn't an Array");
+		return;
+	}
+
+	if (!phalcon_fast_count_ev(rows)) {
+		PHALCON_CONCAT_SVS(&exception_message, "Unable to insert into ", table, " without data");
+		PHALCON_MM_ADD_ENTRY(&exception_message);
+		PHALCON_MM_THROW_EXCEPTION_ZVAL(phalcon_db_exception_ce, &exception_message);
+		return;
+	}
+
+	/**
+	 * Use the keys of the first row when the columns are not passed
+	 */
+	if (columns && Z_TYPE_P(columns) == IS_ARRAY && phalcon_fast_count_ev(columns)) {
+		ZVAL_COPY_VALUE(&fields, columns);
+	} else {
+		array_init(&fields);
+		PHALCON_MM_ADD_ENTRY(&fields);
+
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(rows), row) {
+			if (Z_TYPE_P(row) == IS_ARRAY) {
+				ZEND_HASH_FOREACH_STR_KEY(Z_ARRVAL_P(row), str_key) {
+					if (str_key) {
+						phalcon_array_append_str(&fields, str_key->val, str_key->len, 0);
+					}
+				} ZEND_HASH_FOREACH_END();
+			}
+			break;
+		} ZEND_HASH_FOREACH_END();
+
+		if (!phalcon_fast_count_ev(&fields)) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The columns are required when the rows are not associative arrays");
+			return;
+		}
+	}
+
+	number_fields = phalcon_fast_count_int(&fields);
+
+	ZVAL_NULL(&conflict);
+	ZVAL_NULL(&update_fields);
+	ZVAL_NULL(&bind_data_types);
+
+	if (options && Z_TYPE_P(options) == IS_ARRAY) {
+		phalcon_array_isset_fetch_str(&data_types, options, SL("dataTypes"), PH_READONLY);
+		phalcon_array_isset_fetch_str(&chunk_size, options, SL("chunkSize"), PH_READONLY);
+		if (!phalcon_array_isset_fetch_str(&conflict, options, SL("conflict"), PH_READONLY)) {
+			ZVAL_NULL(&conflict);
+		}
+		phalcon_array_isset_fetch_str(&update, options, SL("update"), PH_READONLY);
+		phalcon_array_isset_fetch_str(&ignore, options, SL("ignore"), PH_READONLY);
+	}
+
+	/**
+	 * Build the upsert clause through the dialect, 'update' => true updates every column not used to detect the conflict
+	 */
+	if (PHALCON_IS_TRUE(&update)) {
+		array_init(&update_fields);
+		PHALCON_MM_ADD_ENTRY(&update_fields);
+
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(fields), field) {
+			if (Z_TYPE(conflict) != IS_ARRAY || !phalcon_fast_in_array(field, &conflict)) {
+				phalcon_array_append(&update_fields, field, PH_COPY);
+			}
+		} ZEND_HASH_FOREACH_END();
+	} else if (Z_TYPE(update) == IS_ARRAY) {
+		ZVAL_COPY_VALUE(&update_fields, &update);
+	}
+
+	if ((Z_TYPE(update_fields) == IS_ARRAY && phalcon_fast_count_ev(&update_fields)) || zend_is_true(&ignore)) {
+		phalcon_read_property(&dialect, getThis(), SL("_dialect"), PH_NOISY|PH_READONLY);
+		PHALCON_MM_CALL_METHOD(&on_conflict, &dialect, "onconflict", &fields, &conflict, &update_fields);
+		PHALCON_MM_ADD_ENTRY(&on_conflict);
+	}
+
+	/**
+	 * Every row takes one placeholder per column, keep the chunks under the limit of the database system
+	 */
+	if (Z_TYPE(chunk_size) > IS_NULL && phalcon_get_intval(&chunk_size) > 0) {
+		rows_per_chunk = phalcon_get_intval(&chunk_size);
+	} else {
+		phalcon_read_property(&dialect_type, getThis(), SL("_dialectType"), PH_NOISY|PH_READONLY);
+		if (PHALCON_IS_STRING(&dialect_type, "sqlite")) {
+			max_params = 999;
+		} else if (PHALCON_IS_STRING(&dialect_type, "postgresql")) {
+			max_params = 32767;
+		} else {
+			max_params = 65535;
+		}
+
+		rows_per_chunk = max_params / number_fields;
+		if (rows_per_chunk > 1000) {
+			rows_per_chunk = 1000;
+		} else if (rows_per_chunk < 1) {
+			rows_per_chunk = 1;
+		}
+	}
+
+	if (PHALCON_GLOBAL(db).escape_identifiers) {
+		PHALCON_MM_CALL_METHOD(&escaped_table, getThis(), "escapeidentifier", table);
+		PHALCON_MM_ADD_ENTRY(&escaped_table);
+
+		array_init(&escaped_fields);
+		PHALCON_MM_ADD_ENTRY(&escaped_fields);
+
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(fields), field) {
+			zval escaped_field = {};
+			PHALCON_MM_CALL_METHOD(&escaped_field, getThis(), "escapeidentifier", field);
+			phalcon_array_append(&escaped_fields, &escaped_field, 0);
+		} ZEND_HASH_FOREACH_END();
+	} else {
+		ZVAL_COPY_VALUE(&escaped_table, table);
+		ZVAL_COPY_VALUE(&escaped_fields, &fields);
+	}
+
+	phalcon_fast_join_str(&joined_fields, SL(", "), &escaped_fields);
+	PHALCON_MM_ADD_ENTRY(&joined_fields);
+
+	array_init(&rows_placeholders);
+	PHALCON_MM_ADD_ENTRY(&rows_placeholders);
+	array_init(&insert_values);
+	PHALCON_MM_ADD_ENTRY(&insert_values);
+	if (Z_TYPE(data_types) == IS_ARRAY) {
+		array_init(&bind_data_types);
+		PHALCON_MM_ADD_ENTRY(&bind_data_types);
+	}
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(rows), row) {
+		zval placeholders = {}, joined_placeholders = {}, row_placeholders = {}, *value;
+		zend_long position = 0;
+
+		if (Z_TYPE_P(row) != IS_ARRAY) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "Every row to insert must be an array");
+			return;
+		}
+
+		array_init(&placeholders);
+
+		/**
+		 * Values are looked up by column name first and then by position, objects are casted
+		 * using __toString and null values are converted to 'null' as insert() does
+		 */
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(fields), field) {
+			zval bind_type = {};
+
+			value = Z_TYPE_P(field) == IS_STRING ? zend_hash_find(Z_ARRVAL_P(row), Z_STR_P(field)) : NULL;
+			if (!value) {
+				value = zend_hash_index_find(Z_ARRVAL_P(row), position);
+			}
+
+			if (!value) {
+				zval_ptr_dtor(&placeholders);
+				PHALCON_CONCAT_SVS(&exception_message, "The row doesn't contain a value for the column '", field, "'");
+				PHALCON_MM_ADD_ENTRY(&exception_message);
+				PHALCON_MM_THROW_EXCEPTION_ZVAL(phalcon_db_exception_ce, &exception_message);
+				return;
+			}
+			ZVAL_DEREF(value);
+
+			if (Z_TYPE_P(value) == IS_OBJECT) {
+				zval str_value = {};
+				phalcon_strval(&str_value, value);
+				phalcon_array_append(&placeholders, &str_value, 0);
+			} else if (Z_TYPE_P(value) == IS_NULL) {
+				phalcon_array_append_str(&placeholders, SL("null"), 0);
+			} else {
+				phalcon_array_append_str(&placeholders, SL("?"), 0);
+				phalcon_array_append(&insert_values, value, PH_COPY);
+
+				if (Z_TYPE(data_types) == IS_ARRAY) {
+					if (!phalcon_array_isset_fetch(&bind_type, &data_types, field, PH_READONLY)
+						&& !phalcon_array_isset_fetch_long(&bind_type, &data_types, position, PH_READONLY)) {
+						zval_ptr_dtor(&placeholders);
+						PHALCON_MM_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "Incomplete number of bind types");
+						return;
+					}
+					phalcon_array_append(&bind_data_types, &bind_type, PH_COPY);
+				}
+			}
+			position++;
+		} ZEND_HASH_FOREACH_END();
+
+		phalcon_fast_join_str(&joined_placeholders, SL(", "), &placeholders);
+		zval_ptr_dtor(&placeholders);
+
+		PHALCON_CONCAT_SVS(&row_placeholders, "(", &joined_placeholders, ")");
+		zval_ptr_dtor(&joined_placeholders);
+		phalcon_array_append(&rows_placeholders, &row_placeholders, 0);
+
+		if (++number_rows == rows_per_chunk) {
+			if (phalcon_db_adapter_insert_chunk(getThis(), &escaped_table, &joined_fields, &rows_placeholders, &insert_values, &bind_data_types, &on_conflict, &affected_rows) == FAILURE) {
+				RETURN_MM();
+			}
+
+			zend_hash_clean(Z_ARRVAL(rows_placeholders));
+			zend_hash_clean(Z_ARRVAL(insert_values));
+			if (Z_TYPE(bind_data_types) == IS_ARRAY) {
+				zend_hash_clean(Z_ARRVAL(bind_data_types));
+			}
+			number_rows = 0;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	if (number_rows > 0) {
+		if (phalcon_db_adapter_insert_chunk(getThis(), &escaped_table, &joined_fields, &rows_placeholders, &insert_values, &bind_data_types, &on_conflict, &affected_rows) == FAILURE) {
+			RETURN_MM();
+		}
+	}
+
+	RETURN_MM_LONG(affected_rows);
+}
+
 /**
  * Updates data on a table using custom RBDM SQL syntax
  *
@@ -39,6 +39,7 @@
 #include "kernel/string.h"
 #include "kernel/operators.h"
 #include "kernel/debug.h"
+#include "kernel/time.h"
 
 #include "interned-strings.h"
 
@@ -79,6 +80,8 @@ PHP_METHOD(Phalcon_Db_Adapter_Pdo, getTransactionLevel);
 PHP_METHOD(Phalcon_Db_Adapter_Pdo, isUnderTransaction);
 PHP_METHOD(Phalcon_Db_Adapter_Pdo, getInternalHandler);
 PHP_METHOD(Phalcon_Db_Adapter_Pdo, getErrorInfo);
+PHP_METHOD(Phalcon_Db_Adapter_Pdo, clearStatementCache);
+PHP_METHOD(Phalcon_Db_Adapter_Pdo, getStatementCacheStats);
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_adapter_pdo___construct, 0, 0, 1)
 	ZEND_ARG_INFO(0, descriptor)
@@ -127,6 +130,8 @@ static const zend_function_entry phalcon_db_adapter_pdo_method_entry[] = {
 	PHP_ME(Phalcon_Db_Adapter_Pdo, isUnderTransaction, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Adapter_Pdo, getInternalHandler, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Adapter_Pdo, getErrorInfo, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Adapter_Pdo, clearStatementCache, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Adapter_Pdo, getStatementCacheStats, NULL, ZEND_ACC_PUBLIC)
 	PHP_FE_END
 };
 
@@ -141,10 +146,45 @@ PHALCON_INIT_CLASS(Phalcon_Db_Adapter_Pdo){
 	zend_declare_property_null(phalcon_db_adapter_pdo_ce, SL("_affectedRows"), ZEND_ACC_PROTECTED);
 	zend_declare_property_long(phalcon_db_adapter_pdo_ce, SL("_transactionLevel"), 0, ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_db_adapter_pdo_ce, SL("_schema"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_adapter_pdo_ce, SL("_statements"), ZEND_ACC_PROTECTED);
+	zend_declare_property_long(phalcon_db_adapter_pdo_ce, SL("_statementCacheSize"), 32, ZEND_ACC_PROTECTED);
+	zend_declare_property_long(phalcon_db_adapter_pdo_ce, SL("_statementCacheHits"), 0, ZEND_ACC_PROTECTED);
+	zend_declare_property_long(phalcon_db_adapter_pdo_ce, SL("_statementCacheMisses"), 0, ZEND_ACC_PROTECTED);
+	zend_declare_property_long(phalcon_db_adapter_pdo_ce, SL("_defaultFetchMode"), PDO_FETCH_BOTH, ZEND_ACC_PROTECTED);
 
 	return SUCCESS;
 }
 
+/**
+ * Statements changing the schema or the session invalidate the prepared statements
+ */
+static int phalcon_db_adapter_pdo_is_schema_change(zval *sql_statement)
+{
+	static const char *keywords[] = { "CREATE", "ALTER", "DROP", "TRUNCATE", "RENAME", "SET", "USE", NULL };
+	const char *sql;
+	size_t len, i;
+
+	if (Z_TYPE_P(sql_statement) != IS_STRING) {
+		return 0;
+	}
+
+	sql = Z_STRVAL_P(sql_statement);
+	len = Z_STRLEN_P(sql_statement);
+	while (len && isspace((unsigned char)*sql)) {
+		sql++;
+		len--;
+	}
+
+	for (i = 0; keywords[i]; i++) {
+		size_t keyword_len = strlen(keywords[i]);
+		if (len > keyword_len && !strncasecmp(sql, keywords[i], keyword_len) && isspace((unsigned char)sql[keyword_len])) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
 /**
  * Constructor for Phalcon\Db\Adapter\Pdo
  *
@@ -188,6 +228,7 @@ PHP_METHOD(Phalcon_Db_Adapter_Pdo, __construct){
 PHP_METHOD(Phalcon_Db_Adapter_Pdo, connect)
 {
 	zval *desc = NULL, descriptor = {}, username = {}, password = {}, options = {}, dsn_parts = {}, *value, dsn_attributes = {}, pdo_type = {}, dsn = {}, persistent = {}, pdo = {};
+	zval cache_size = {}, attribute = {}, fetch_mode = {};
 	zend_class_entry *ce;
 	zend_string *str_key;
 	ulong idx;
@@ -234,6 +275,19 @@ PHP_METHOD(Phalcon_Db_Adapter_Pdo, connect)
 		phalcon_array_unset_str(&descriptor, SL("dialectClass"), 0);
 	}
 
+	/**
+	 * Number of prepared statements kept for reuse, zero disables the cache
+	 */
+	if (phalcon_array_isset_fetch_str(&cache_size, &descriptor, SL("statementCacheSize"), PH_READONLY)) {
+		phalcon_update_property_long(getThis(), SL("_statementCacheSize"), phalcon_get_intval(&cache_size));
+		phalcon_array_unset_str(&descriptor, SL("statementCacheSize"), 0);
+	}
+
+	/**
+	 * Statements prepared by a previous connection can't be reused
+	 */
+	PHALCON_MM_CALL_METHOD(NULL, getThis(), "clearstatementcache");
+
 	/**
 	 * Default options
 	 */
@@ -285,6 +339,15 @@ PHP_METHOD(Phalcon_Db_Adapter_Pdo, connect)
 	PHALCON_MM_ADD_ENTRY(&pdo);
 	PHALCON_MM_CALL_METHOD(NULL, &pdo, "__construct", &dsn, &username, &password, &options);
 
+	/**
+	 * Reused statements are restored to the default fetch mode of the connection
+	 */
+	ZVAL_LONG(&attribute, PDO_ATTR_DEFAULT_FETCH_MODE);
+	PHALCON_MM_CALL_METHOD(&fetch_mode, &pdo, "getattribute", &attribute);
+	if (Z_TYPE(fetch_mode) == IS_LONG) {
+		phalcon_update_property(getThis(), SL("_defaultFetchMode"), &fetch_mode);
+	}
+
 	phalcon_update_property(getThis(), SL("_pdo"), &pdo);
 	RETURN_MM();
 }
@@ -302,14 +365,65 @@ PHP_METHOD(Phalcon_Db_Adapter_Pdo, connect)
  */
 PHP_METHOD(Phalcon_Db_Adapter_Pdo, prepare){
 
-	zval *sql_statement, pdo = {};
+	zval *sql_statement, pdo = {}, cache_size = {}, statements = {}, statement = {}, fetch_mode = {};
+	zend_string *str_key;
+	zend_ulong idx;
 
 	phalcon_fetch_params(0, 1, 0, &sql_statement);
 
 	phalcon_update_property(getThis(), SL("_sqlStatement"), sql_statement);
 
 	phalcon_read_property(&pdo, getThis(), SL("_pdo"), PH_NOISY|PH_READONLY);
-	PHALCON_RETURN_CALL_METHOD(&pdo, "prepare", sql_statement);
+	phalcon_read_property(&cache_size, getThis(), SL("_statementCacheSize"), PH_NOISY|PH_READONLY);
+
+	if (Z_TYPE_P(sql_statement) != IS_STRING || phalcon_get_intval(&cache_size) <= 0) {
+		PHALCON_RETURN_CALL_METHOD(&pdo, "prepare", sql_statement);
+		return;
+	}
+
+	phalcon_read_property(&statements, getThis(), SL("_statements"), PH_NOISY|PH_READONLY);
+
+	if (Z_TYPE(statements) == IS_ARRAY && phalcon_array_isset_fetch(&statement, &statements, sql_statement, PH_READONLY)) {
+		/**
+		 * The statement is only reused when no result is still reading from it
+		 */
+		if (Z_TYPE(statement) == IS_OBJECT && Z_REFCOUNT(statement) == 1) {
+			ZVAL_COPY(return_value, &statement);
+
+			/**
+			 * Move the statement to the tail, the head is the least recently used
+			 */
+			phalcon_unset_property_array(getThis(), SL("_statements"), sql_statement);
+			phalcon_update_property_array(getThis(), SL("_statements"), sql_statement, return_value);
+			phalcon_property_incr(getThis(), SL("_statementCacheHits"));
+
+			phalcon_read_property(&fetch_mode, getThis(), SL("_defaultFetchMode"), PH_NOISY|PH_READONLY);
+			PHALCON_CALL_METHOD(NULL, return_value, "closecursor");
+			PHALCON_CALL_METHOD(NULL, return_value, "setfetchmode", &fetch_mode);
+			return;
+		}
+
+		phalcon_unset_property_array(getThis(), SL("_statements"), sql_statement);
+	} else if (Z_TYPE(statements) == IS_ARRAY && zend_hash_num_elements(Z_ARRVAL(statements)) >= phalcon_get_intval(&cache_size)) {
+		ZEND_HASH_FOREACH_KEY(Z_ARRVAL(statements), idx, str_key) {
+			zval key = {};
+			if (str_key) {
+				ZVAL_STR_COPY(&key, str_key);
+			} else {
+				ZVAL_LONG(&key, idx);
+			}
+			phalcon_unset_property_array(getThis(), SL("_statements"), &key);
+			zval_ptr_dtor(&key);
+			break;
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	phalcon_property_incr(getThis(), SL("_statementCacheMisses"));
+
+	PHALCON_CALL_METHOD(return_value, &pdo, "prepare", sql_statement);
+	if (Z_TYPE_P(return_value) == IS_OBJECT) {
+		phalcon_update_property_array(getThis(), SL("_statements"), sql_statement, return_value);
+	}
 }
 
 /**
@@ -527,6 +641,10 @@ PHP_METHOD(Phalcon_Db_Adapter_Pdo, query){
 		ZVAL_COPY_VALUE(&statement, &new_statement);
 	}
 
+	if (phalcon_db_adapter_pdo_is_schema_change(sql_statement)) {
+		PHALCON_MM_CALL_METHOD(NULL, getThis(), "clearstatementcache");
+	}
+
 	PHALCON_MM_ZVAL_STRING(&event_name, "db:afterQuery");
 	PHALCON_MM_CALL_METHOD(NULL, getThis(), "fireevent", &event_name, &new_statement);
 
@@ -620,6 +738,19 @@ PHP_METHOD(Phalcon_Db_Adapter_Pdo, execute){
 		phalcon_update_property(getThis(), SL("_affectedRows"), &affected_rows);
 	}
 
+	/**
+	 * Phalcon\Db\Router keeps the reads on the primary for a while after this
+	 */
+	if (Z_TYPE(new_statement) == IS_OBJECT) {
+		zval now = {};
+		ZVAL_DOUBLE(&now, phalcon_get_microtime());
+		phalcon_update_property(getThis(), SL("_lastWrite"), &now);
+	}
+
+	if (phalcon_db_adapter_pdo_is_schema_change(sql_statement)) {
+		PHALCON_MM_CALL_METHOD(NULL, getThis(), "clearstatementcache");
+	}
+
 	PHALCON_MM_ZVAL_STRING(&event_name, "db:afterExecute");
 	PHALCON_MM_CALL_METHOD(NULL, getThis(), "fireevent", &event_name, bind_params);
 
@@ -652,6 +783,11 @@ PHP_METHOD(Phalcon_Db_Adapter_Pdo, close){
 
 	zval pdo = {};
 
+	/**
+	 * Cached statements keep a reference to the connection
+	 */
+	PHALCON_CALL_METHOD(NULL, getThis(), "clearstatementcache");
+
 	phalcon_read_property(&pdo, getThis(), SL("_pdo"), PH_NOISY|PH_READONLY);
 	if (likely(Z_TYPE(pdo) == IS_OBJECT)) {
 		phalcon_update_property(getThis(), SL("_pdo"), &PHALCON_GLOBAL(z_null));
@@ -1178,3 +1314,44 @@ PHP_METHOD(Phalcon_Db_Adapter_Pdo, getErrorInfo){
 	phalcon_read_property(&pdo, getThis(), SL("_pdo"), PH_NOISY|PH_READONLY);
 	PHALCON_RETURN_CALL_METHOD(&pdo, "errorinfo");
 }
+
+/**
+ * Discards the cached prepared statements
+ *
+ *<code>
+ *	$connection->clearStatementCache();
+ *</code>
+ */
+PHP_METHOD(Phalcon_Db_Adapter_Pdo, clearStatementCache){
+
+	phalcon_update_property_null(getThis(), SL("_statements"));
+}
+
+/**
+ * Returns the hits, misses and hit rate of the prepared statements cache
+ *
+ *<code>
+ *	print_r($connection->getStatementCacheStats());
+ *</code>
+ *
+ * @return array
+ */
+PHP_METHOD(Phalcon_Db_Adapter_Pdo, getStatementCacheStats){
+
+	zval size = {}, hits = {}, misses = {}, statements = {};
+	zend_long total;
+
+	phalcon_read_property(&size, getThis(), SL("_statementCacheSize"), PH_NOISY|PH_READONLY);
+	phalcon_read_property(&hits, getThis(), SL("_statementCacheHits"), PH_NOISY|PH_READONLY);
+	phalcon_read_property(&misses, getThis(), SL("_statementCacheMisses"), PH_NOISY|PH_READONLY);
+	phalcon_read_property(&statements, getThis(), SL("_statements"), PH_NOISY|PH_READONLY);
+
+	total = phalcon_get_intval(&hits) + phalcon_get_intval(&misses);
+
+	array_init_size(return_value, 5);
+	phalcon_array_update_str_long(return_value, SL("size"), phalcon_get_intval(&size), 0);
+	phalcon_array_update_str_long(return_value, SL("entries"), Z_TYPE(statements) == IS_ARRAY ? zend_hash_num_elements(Z_ARRVAL(statements)) : 0, 0);
+	phalcon_array_update_str_long(return_value, SL("hits"), phalcon_get_intval(&hits), 0);
+	phalcon_array_update_str_long(return_value, SL("misses"), phalcon_get_intval(&misses), 0);
+	add_assoc_double_ex(return_value, SL("hitRate"), total ? (double)phalcon_get_intval(&hits) / total : 0.0);
+}
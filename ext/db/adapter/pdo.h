@@ -26,4 +26,7 @@ extern zend_class_entry *phalcon_db_adapter_pdo_ce;
 
 PHALCON_INIT_CLASS(Phalcon_Db_Adapter_Pdo);
 
+/* PDO::MYSQL_ATTR_USE_BUFFERED_QUERY, the first driver specific attribute of pdo_mysql */
+#define PHALCON_PDO_MYSQL_ATTR_USE_BUFFERED_QUERY 1000
+
 #endif /* PHALCON_DB_ADAPTER_PDO_H */
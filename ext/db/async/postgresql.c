@@ -0,0 +1,711 @@
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2014 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+#include "db/async/postgresql.h"
+#include "db/exception.h"
+
+#if PHALCON_USE_ASYNC
+
+#include "async/core.h"
+
+#include <Zend/zend_smart_str.h>
+
+#include "kernel/main.h"
+#include "kernel/memory.h"
+#include "kernel/fcall.h"
+#include "kernel/object.h"
+#include "kernel/array.h"
+#include "kernel/operators.h"
+#include "kernel/exception.h"
+
+/**
+ * Phalcon\Db\Async\Postgresql
+ *
+ * PostgreSQL connection for Phalcon\Async that never blocks the event loop. It uses the
+ * asynchronous API of libpq exposed by the pgsql extension, while a query runs the task waits
+ * on a Phalcon\Async\Poll watcher for the socket of the connection and the other tasks keep running.
+ *
+ * Every connection runs one query at a time, independent queries run concurrently on connections of their own
+ *
+ *<code>
+ *
+ *	$descriptor = array(
+ *		'host' => 'localhost',
+ *		'username' => 'postgres',
+ *		'password' => 'secret',
+ *		'dbname' => 'invo'
+ *	);
+ *
+ *	$tasks = array();
+ *	foreach (array('robots', 'parts', 'robots_parts') as $table) {
+ *		$tasks[$table] = Phalcon\Async\Task::async(function() use ($descriptor, $table) {
+ *			$connection = new Phalcon\Db\Async\Postgresql($descriptor);
+ *			return $connection->fetchOne('SELECT COUNT(*) AS total FROM ' . $table);
+ *		});
+ *	}
+ *
+ *	foreach ($tasks as $table => $task) {
+ *		$row = Phalcon\Async\Task::await($task);
+ *		echo $table, ': ', $row['total'], PHP_EOL;
+ *	}
+ *
+ *</code>
+ */
+zend_class_entry *phalcon_db_async_postgresql_ce;
+
+PHP_METHOD(Phalcon_Db_Async_Postgresql, __construct);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, connect);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, query);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, fetchOne);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, execute);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, affectedRows);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, begin);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, commit);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, rollback);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, isUnderTransaction);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, escapeString);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, close);
+PHP_METHOD(Phalcon_Db_Async_Postgresql, getInternalHandler);
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_async_postgresql___construct, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, descriptor, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_async_postgresql_query, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, sqlStatement, IS_STRING, 0)
+	ZEND_ARG_TYPE_INFO(0, placeholders, IS_ARRAY, 1)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_async_postgresql_escapestring, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, str, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+static const zend_function_entry phalcon_db_async_postgresql_method_entry[] = {
+	PHP_ME(Phalcon_Db_Async_Postgresql, __construct, arginfo_phalcon_db_async_postgresql___construct, ZEND_ACC_PUBLIC|ZEND_ACC_CTOR)
+	PHP_ME(Phalcon_Db_Async_Postgresql, connect, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Async_Postgresql, query, arginfo_phalcon_db_async_postgresql_query, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Async_Postgresql, fetchOne, arginfo_phalcon_db_async_postgresql_query, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Async_Postgresql, execute, arginfo_phalcon_db_async_postgresql_query, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Async_Postgresql, affectedRows, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Async_Postgresql, begin, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Async_Postgresql, commit, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Async_Postgresql, rollback, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Async_Postgresql, isUnderTransaction, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Async_Postgresql, escapeString, arginfo_phalcon_db_async_postgresql_escapestring, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Async_Postgresql, close, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Async_Postgresql, getInternalHandler, NULL, ZEND_ACC_PUBLIC)
+	PHP_FE_END
+};
+
+/**
+ * Phalcon\Db\Async\Postgresql initializer
+ */
+PHALCON_INIT_CLASS(Phalcon_Db_Async_Postgresql){
+
+	PHALCON_REGISTER_CLASS(Phalcon\\Db\\Async, Postgresql, db_async_postgresql, phalcon_db_async_postgresql_method_entry, 0);
+
+	zend_declare_property_null(phalcon_db_async_postgresql_ce, SL("_descriptor"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_async_postgresql_ce, SL("_connection"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_async_postgresql_ce, SL("_poll"), ZEND_ACC_PROTECTED);
+	zend_declare_property_bool(phalcon_db_async_postgresql_ce, SL("_busy"), 0, ZEND_ACC_PROTECTED);
+	zend_declare_property_long(phalcon_db_async_postgresql_ce, SL("_affectedRows"), 0, ZEND_ACC_PROTECTED);
+
+	return SUCCESS;
+}
+
+/**
+ * Reads a constant of the pgsql extension
+ */
+static zend_long phalcon_db_async_postgresql_constant(const char *name, size_t name_length, zend_long default_value)
+{
+	zval *constant = zend_get_constant_str(name, name_length);
+
+	return constant ? zval_get_long(constant) : default_value;
+}
+
+/**
+ * Appends a keyword of the connection string quoting its value
+ */
+static void phalcon_db_async_postgresql_keyword(smart_str *conninfo, const char *keyword, zval *value)
+{
+	zend_string *str = zval_get_string(value);
+	size_t i;
+
+	if (conninfo->s) {
+		smart_str_appendc(conninfo, ' ');
+	}
+	smart_str_appends(conninfo, keyword);
+	smart_str_appendl(conninfo, "='", 2);
+	for (i = 0; i < ZSTR_LEN(str); i++) {
+		if (ZSTR_VAL(str)[i] == '\'' || ZSTR_VAL(str)[i] == '\\') {
+			smart_str_appendc(conninfo, '\\');
+		}
+		smart_str_appendc(conninfo, ZSTR_VAL(str)[i]);
+	}
+	smart_str_appendc(conninfo, '\'');
+	zend_string_release(str);
+}
+
+/**
+ * Suspends the current task until the socket of the connection is ready
+ */
+static int phalcon_db_async_postgresql_await(zval *object, int writable)
+{
+	zval poll = {};
+	int status;
+
+	phalcon_read_property(&poll, object, SL("_poll"), PH_READONLY);
+	if (Z_TYPE(poll) != IS_OBJECT) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The connection is closed");
+		return FAILURE;
+	}
+
+	if (writable) {
+		PHALCON_CALL_METHOD_FLAG(status, NULL, &poll, "awaitwritable");
+	} else {
+		PHALCON_CALL_METHOD_FLAG(status, NULL, &poll, "awaitreadable");
+	}
+
+	return status == FAILURE || EG(exception) ? FAILURE : SUCCESS;
+}
+
+/**
+ * Throws the last error of the connection
+ */
+static void phalcon_db_async_postgresql_error(zval *connection, const char *message)
+{
+	zval error = {};
+	int status;
+
+	PHALCON_CALL_FUNCTION_FLAG(status, &error, "pg_last_error", connection);
+	if (status == SUCCESS && Z_TYPE(error) == IS_STRING && Z_STRLEN(error)) {
+		PHALCON_THROW_EXCEPTION_FORMAT(phalcon_db_exception_ce, "%s: %s", message, Z_STRVAL(error));
+	} else if (!EG(exception)) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, message);
+	}
+	zval_ptr_dtor(&error);
+}
+
+/**
+ * Closes a connection left with a statement in flight, the server aborts the statement and the
+ * next one opens a new connection. The current exception is kept
+ */
+static void phalcon_db_async_postgresql_abandon(zval *object)
+{
+	zend_object *exception = EG(exception);
+
+	EG(exception) = NULL;
+	phalcon_call_method(NULL, object, "close", 0, NULL);
+	if (EG(exception)) {
+		zend_object_release(EG(exception));
+	}
+	EG(exception) = exception;
+}
+
+/**
+ * Sends a statement and suspends the task until its result arrives
+ */
+static int phalcon_db_async_postgresql_send(zval *return_value, zval *object, zval *sql, zval *placeholders)
+{
+	zval connection = {}, busy = {}, sent = {}, result = {}, extra = {}, result_status = {}, message = {};
+	zend_long fatal_error, bad_response;
+	int status = SUCCESS;
+
+	ZVAL_NULL(return_value);
+
+	phalcon_read_property(&connection, object, SL("_connection"), PH_READONLY);
+	if (Z_TYPE(connection) == IS_NULL) {
+		PHALCON_CALL_METHOD_FLAG(status, NULL, object, "connect");
+		if (status == FAILURE || EG(exception)) {
+			return FAILURE;
+		}
+		phalcon_read_property(&connection, object, SL("_connection"), PH_READONLY);
+	}
+
+	phalcon_read_property(&busy, object, SL("_busy"), PH_READONLY);
+	if (zend_is_true(&busy)) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The connection is running another statement, every task needs a connection of its own");
+		return FAILURE;
+	}
+
+	if (placeholders && Z_TYPE_P(placeholders) == IS_ARRAY) {
+		PHALCON_CALL_FUNCTION_FLAG(status, &sent, "pg_send_query_params", &connection, sql, placeholders);
+	} else {
+		PHALCON_CALL_FUNCTION_FLAG(status, &sent, "pg_send_query", &connection, sql);
+	}
+
+	if (status == FAILURE || EG(exception)) {
+		return FAILURE;
+	}
+
+	if (PHALCON_IS_FALSE(&sent)) {
+		phalcon_db_async_postgresql_error(&connection, "The statement cannot be sent");
+		return FAILURE;
+	}
+
+	phalcon_update_property_bool(object, SL("_busy"), 1);
+
+	/**
+	 * pg_connection_busy() consumes the input available, the task waits while the result is not complete
+	 */
+	while (1) {
+		zval is_busy = {};
+
+		PHALCON_CALL_FUNCTION_FLAG(status, &is_busy, "pg_connection_busy", &connection);
+		if (status == FAILURE || EG(exception) || !zend_is_true(&is_busy)) {
+			break;
+		}
+
+		if (phalcon_db_async_postgresql_await(object, 0) == FAILURE) {
+			status = FAILURE;
+			break;
+		}
+	}
+
+	if (status == SUCCESS && !EG(exception)) {
+		PHALCON_CALL_FUNCTION_FLAG(status, &result, "pg_get_result", &connection);
+	}
+
+	/**
+	 * Only one result is expected, the connection accepts new statements once every result is read
+	 */
+	while (status == SUCCESS && !EG(exception)) {
+		PHALCON_CALL_FUNCTION_FLAG(status, &extra, "pg_get_result", &connection);
+		if (status == FAILURE || PHALCON_IS_FALSE(&extra)) {
+			zval_ptr_dtor(&extra);
+			break;
+		}
+		zval_ptr_dtor(&extra);
+	}
+
+	/**
+	 * The results weren't read, the task was cancelled or the wait failed. The statement is still
+	 * running, the connection can't be reused
+	 */
+	if (status == FAILURE || EG(exception)) {
+		phalcon_db_async_postgresql_abandon(object);
+		phalcon_update_property_bool(object, SL("_busy"), 0);
+		zval_ptr_dtor(&result);
+		return FAILURE;
+	}
+
+	phalcon_update_property_bool(object, SL("_busy"), 0);
+
+	if (PHALCON_IS_FALSE(&result)) {
+		phalcon_db_async_postgresql_error(&connection, "The statement did not return a result");
+		return FAILURE;
+	}
+
+	fatal_error = phalcon_db_async_postgresql_constant(SL("PGSQL_FATAL_ERROR"), 7);
+	bad_response = phalcon_db_async_postgresql_constant(SL("PGSQL_BAD_RESPONSE"), 5);
+
+	PHALCON_CALL_FUNCTION_FLAG(status, &result_status, "pg_result_status", &result);
+	if (status == SUCCESS && (phalcon_get_intval(&result_status) == fatal_error || phalcon_get_intval(&result_status) == bad_response)) {
+		PHALCON_CALL_FUNCTION_FLAG(status, &message, "pg_result_error", &result);
+		if (status == SUCCESS && Z_TYPE(message) == IS_STRING) {
+			PHALCON_THROW_EXCEPTION_ZVAL(phalcon_db_exception_ce, &message);
+		} else if (!EG(exception)) {
+			PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The statement failed");
+		}
+		zval_ptr_dtor(&message);
+		zval_ptr_dtor(&result);
+		return FAILURE;
+	}
+
+	ZVAL_COPY_VALUE(return_value, &result);
+	return SUCCESS;
+}
+
+/**
+ * Runs a statement returning all its rows
+ */
+static int phalcon_db_async_postgresql_rows(zval *return_value, zval *object, zval *sql, zval *placeholders)
+{
+	zval result = {}, mode = {};
+	int status;
+
+	if (phalcon_db_async_postgresql_send(&result, object, sql, placeholders) == FAILURE) {
+		return FAILURE;
+	}
+
+	ZVAL_LONG(&mode, phalcon_db_async_postgresql_constant(SL("PGSQL_ASSOC"), 1));
+	PHALCON_CALL_FUNCTION_FLAG(status, return_value, "pg_fetch_all", &result, &mode);
+	PHALCON_CALL_FUNCTION_FLAG(status, NULL, "pg_free_result", &result);
+	zval_ptr_dtor(&result);
+
+	if (Z_TYPE_P(return_value) != IS_ARRAY) {
+		zval_ptr_dtor(return_value);
+		array_init(return_value);
+	}
+
+	return EG(exception) ? FAILURE : SUCCESS;
+}
+
+/**
+ * Phalcon\Db\Async\Postgresql constructor
+ *
+ * The descriptor accepts host, port, dbname, username, password and options, an array of
+ * other keywords of the connection string such as sslmode or connect_timeout
+ *
+ * @param array $descriptor
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, __construct){
+
+	zval *descriptor;
+
+	phalcon_fetch_params(0, 1, 0, &descriptor);
+
+	if (!zend_hash_str_exists(CG(function_table), SL("pg_connect_poll"))) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The pgsql extension is required to run asynchronous queries");
+		return;
+	}
+
+	phalcon_update_property(getThis(), SL("_descriptor"), descriptor);
+}
+
+/**
+ * Opens the connection, the task is suspended while the connection is established.
+ * Statements open the connection when they need it
+ *
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, connect){
+
+	zval descriptor = {}, value = {}, options = {}, conninfo = {}, flags = {}, connection = {}, socket = {}, poll = {}, *option;
+	zend_string *str_key;
+	smart_str buffer = {0};
+	zend_long polling_failed, polling_reading, polling_ok;
+	int status, writable = 1;
+
+	phalcon_read_property(&connection, getThis(), SL("_connection"), PH_READONLY);
+	if (Z_TYPE(connection) != IS_NULL) {
+		RETURN_TRUE;
+	}
+
+	phalcon_read_property(&descriptor, getThis(), SL("_descriptor"), PH_READONLY);
+
+	if (phalcon_array_isset_fetch_str(&value, &descriptor, SL("host"), PH_READONLY)) {
+		phalcon_db_async_postgresql_keyword(&buffer, "host", &value);
+	}
+	if (phalcon_array_isset_fetch_str(&value, &descriptor, SL("port"), PH_READONLY)) {
+		phalcon_db_async_postgresql_keyword(&buffer, "port", &value);
+	}
+	if (phalcon_array_isset_fetch_str(&value, &descriptor, SL("dbname"), PH_READONLY)) {
+		phalcon_db_async_postgresql_keyword(&buffer, "dbname", &value);
+	}
+	if (phalcon_array_isset_fetch_str(&value, &descriptor, SL("username"), PH_READONLY)) {
+		phalcon_db_async_postgresql_keyword(&buffer, "user", &value);
+	}
+	if (phalcon_array_isset_fetch_str(&value, &descriptor, SL("password"), PH_READONLY)) {
+		phalcon_db_async_postgresql_keyword(&buffer, "password", &value);
+	}
+	if (phalcon_array_isset_fetch_str(&options, &descriptor, SL("options"), PH_READONLY) && Z_TYPE(options) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL(options), str_key, option) {
+			if (str_key) {
+				phalcon_db_async_postgresql_keyword(&buffer, ZSTR_VAL(str_key), option);
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+	smart_str_0(&buffer);
+
+	if (buffer.s) {
+		ZVAL_STR(&conninfo, buffer.s);
+	} else {
+		ZVAL_EMPTY_STRING(&conninfo);
+	}
+
+	ZVAL_LONG(&flags, phalcon_db_async_postgresql_constant(SL("PGSQL_CONNECT_FORCE_NEW"), 2) | phalcon_db_async_postgresql_constant(SL("PGSQL_CONNECT_ASYNC"), 4));
+	PHALCON_CALL_FUNCTION_FLAG(status, &connection, "pg_connect", &conninfo, &flags);
+	zval_ptr_dtor(&conninfo);
+
+	if (status == FAILURE || EG(exception)) {
+		return;
+	}
+	if (PHALCON_IS_FALSE(&connection)) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The connection cannot be started");
+		return;
+	}
+
+	PHALCON_CALL_FUNCTION_FLAG(status, &socket, "pg_socket", &connection);
+	if (status == FAILURE || Z_TYPE(socket) != IS_RESOURCE) {
+		zval_ptr_dtor(&socket);
+		zval_ptr_dtor(&connection);
+		if (!EG(exception)) {
+			PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The socket of the connection is not available");
+		}
+		return;
+	}
+
+	object_init_ex(&poll, async_poll_ce);
+	PHALCON_CALL_METHOD_FLAG(status, NULL, &poll, "__construct", &socket);
+	zval_ptr_dtor(&socket);
+	if (status == FAILURE || EG(exception)) {
+		zval_ptr_dtor(&poll);
+		zval_ptr_dtor(&connection);
+		return;
+	}
+
+	phalcon_update_property(getThis(), SL("_poll"), &poll);
+	zval_ptr_dtor(&poll);
+
+	polling_failed = phalcon_db_async_postgresql_constant(SL("PGSQL_POLLING_FAILED"), 0);
+	polling_reading = phalcon_db_async_postgresql_constant(SL("PGSQL_POLLING_READING"), 1);
+	polling_ok = phalcon_db_async_postgresql_constant(SL("PGSQL_POLLING_OK"), 3);
+
+	/**
+	 * libpq tells what the socket has to be waited for until the connection is made
+	 */
+	while (1) {
+		zval polling = {};
+
+		if (phalcon_db_async_postgresql_await(getThis(), writable) == FAILURE) {
+			break;
+		}
+
+		PHALCON_CALL_FUNCTION_FLAG(status, &polling, "pg_connect_poll", &connection);
+		if (status == FAILURE || EG(exception)) {
+			break;
+		}
+
+		if (Z_LVAL(polling) == polling_ok) {
+			phalcon_update_property(getThis(), SL("_connection"), &connection);
+			zval_ptr_dtor(&connection);
+			RETURN_TRUE;
+		}
+
+		if (Z_LVAL(polling) == polling_failed) {
+			phalcon_db_async_postgresql_error(&connection, "The connection failed");
+			break;
+		}
+
+		writable = Z_LVAL(polling) != polling_reading;
+	}
+
+	phalcon_read_property(&poll, getThis(), SL("_poll"), PH_READONLY);
+	if (Z_TYPE(poll) == IS_OBJECT) {
+		PHALCON_CALL_METHOD_FLAG(status, NULL, &poll, "close");
+	}
+	phalcon_update_property_null(getThis(), SL("_poll"));
+	zval_ptr_dtor(&connection);
+}
+
+/**
+ * Runs a statement returning its rows as associative arrays, placeholders are written $1, $2...
+ *
+ *<code>
+ *	$robots = $connection->query('SELECT * FROM robots WHERE type = $1', array('mechanical'));
+ *</code>
+ *
+ * @param string $sqlStatement
+ * @param array $placeholders
+ * @return array
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, query){
+
+	zval *sql, *placeholders = NULL;
+
+	phalcon_fetch_params(0, 1, 1, &sql, &placeholders);
+
+	phalcon_db_async_postgresql_rows(return_value, getThis(), sql, placeholders);
+}
+
+/**
+ * Returns the first row of a statement, false if it returns no rows
+ *
+ * @param string $sqlStatement
+ * @param array $placeholders
+ * @return array
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, fetchOne){
+
+	zval *sql, *placeholders = NULL, rows = {}, row = {};
+
+	phalcon_fetch_params(0, 1, 1, &sql, &placeholders);
+
+	if (phalcon_db_async_postgresql_rows(&rows, getThis(), sql, placeholders) == FAILURE) {
+		zval_ptr_dtor(&rows);
+		return;
+	}
+
+	if (phalcon_array_isset_fetch_long(&row, &rows, 0, PH_READONLY)) {
+		RETVAL_ZVAL(&row, 1, 0);
+	} else {
+		RETVAL_FALSE;
+	}
+	zval_ptr_dtor(&rows);
+}
+
+/**
+ * Runs a statement returning no rows, the number of rows affected is kept for affectedRows()
+ *
+ *<code>
+ *	$connection->execute('UPDATE robots SET year = $1 WHERE id = $2', array(1960, 3));
+ *</code>
+ *
+ * @param string $sqlStatement
+ * @param array $placeholders
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, execute){
+
+	zval *sql, *placeholders = NULL, result = {}, affected_rows = {};
+	int status;
+
+	phalcon_fetch_params(0, 1, 1, &sql, &placeholders);
+
+	if (phalcon_db_async_postgresql_send(&result, getThis(), sql, placeholders) == FAILURE) {
+		return;
+	}
+
+	PHALCON_CALL_FUNCTION_FLAG(status, &affected_rows, "pg_affected_rows", &result);
+	if (status == SUCCESS) {
+		phalcon_update_property_long(getThis(), SL("_affectedRows"), phalcon_get_intval(&affected_rows));
+	}
+	PHALCON_CALL_FUNCTION_FLAG(status, NULL, "pg_free_result", &result);
+	zval_ptr_dtor(&result);
+
+	RETURN_TRUE;
+}
+
+/**
+ * Returns the number of rows affected by the last statement run with execute()
+ *
+ * @return int
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, affectedRows){
+
+	RETURN_MEMBER(getThis(), "_affectedRows");
+}
+
+/**
+ * Starts a transaction
+ *
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, begin){
+
+	zval sql = {};
+
+	ZVAL_STRING(&sql, "BEGIN");
+	PHALCON_CALL_METHOD(return_value, getThis(), "execute", &sql);
+	zval_ptr_dtor(&sql);
+}
+
+/**
+ * Commits the active transaction
+ *
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, commit){
+
+	zval sql = {};
+
+	ZVAL_STRING(&sql, "COMMIT");
+	PHALCON_CALL_METHOD(return_value, getThis(), "execute", &sql);
+	zval_ptr_dtor(&sql);
+}
+
+/**
+ * Rollbacks the active transaction
+ *
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, rollback){
+
+	zval sql = {};
+
+	ZVAL_STRING(&sql, "ROLLBACK");
+	PHALCON_CALL_METHOD(return_value, getThis(), "execute", &sql);
+	zval_ptr_dtor(&sql);
+}
+
+/**
+ * Checks whether the connection is inside a transaction
+ *
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, isUnderTransaction){
+
+	zval connection = {}, transaction_status = {};
+
+	phalcon_read_property(&connection, getThis(), SL("_connection"), PH_READONLY);
+	if (Z_TYPE(connection) == IS_NULL) {
+		RETURN_FALSE;
+	}
+
+	PHALCON_CALL_FUNCTION(&transaction_status, "pg_transaction_status", &connection);
+	RETURN_BOOL(phalcon_get_intval(&transaction_status) != phalcon_db_async_postgresql_constant(SL("PGSQL_TRANSACTION_IDLE"), 0));
+}
+
+/**
+ * Escapes a value as a literal to avoid SQL injections
+ *
+ * @param string $str
+ * @return string
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, escapeString){
+
+	zval *str, connection = {};
+
+	phalcon_fetch_params(0, 1, 0, &str);
+
+	phalcon_read_property(&connection, getThis(), SL("_connection"), PH_READONLY);
+	if (Z_TYPE(connection) == IS_NULL) {
+		PHALCON_CALL_METHOD(NULL, getThis(), "connect");
+		phalcon_read_property(&connection, getThis(), SL("_connection"), PH_READONLY);
+	}
+
+	PHALCON_CALL_FUNCTION(return_value, "pg_escape_literal", &connection, str);
+}
+
+/**
+ * Closes the connection
+ *
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, close){
+
+	zval connection = {}, poll = {};
+
+	phalcon_read_property(&poll, getThis(), SL("_poll"), PH_READONLY);
+	if (Z_TYPE(poll) == IS_OBJECT) {
+		PHALCON_CALL_METHOD(NULL, &poll, "close");
+		phalcon_update_property_null(getThis(), SL("_poll"));
+	}
+
+	phalcon_read_property(&connection, getThis(), SL("_connection"), PH_READONLY);
+	if (Z_TYPE(connection) == IS_NULL) {
+		RETURN_FALSE;
+	}
+
+	PHALCON_CALL_FUNCTION(NULL, "pg_close", &connection);
+	phalcon_update_property_null(getThis(), SL("_connection"));
+	RETURN_TRUE;
+}
+
+/**
+ * Returns the pgsql connection
+ *
+ * @return resource
+ */
+PHP_METHOD(Phalcon_Db_Async_Postgresql, getInternalHandler){
+
+	RETURN_MEMBER(getThis(), "_connection");
+}
+
+#endif
@@ -0,0 +1,33 @@
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2014 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+
+#ifndef PHALCON_DB_ASYNC_POSTGRESQL_H
+#define PHALCON_DB_ASYNC_POSTGRESQL_H
+
+#include "php_phalcon.h"
+
+#if PHALCON_USE_ASYNC
+
+extern zend_class_entry *phalcon_db_async_postgresql_ce;
+
+PHALCON_INIT_CLASS(Phalcon_Db_Async_Postgresql);
+
+#endif
+
+#endif /* PHALCON_DB_ASYNC_POSTGRESQL_H */
@@ -54,6 +54,7 @@ PHP_METHOD(Phalcon_Db_Dialect, getSqlExpressionFunctionCall);
 PHP_METHOD(Phalcon_Db_Dialect, getSqlTable);
 PHP_METHOD(Phalcon_Db_Dialect, select);
 PHP_METHOD(Phalcon_Db_Dialect, insert);
+PHP_METHOD(Phalcon_Db_Dialect, onConflict);
 PHP_METHOD(Phalcon_Db_Dialect, update);
 PHP_METHOD(Phalcon_Db_Dialect, delete);
 PHP_METHOD(Phalcon_Db_Dialect, supportsSavepoints);
@@ -122,6 +123,7 @@ static const zend_function_entry phalcon_db_dialect_method_entry[] = {
 	PHP_ME(Phalcon_Db_Dialect, getSqlTable, arginfo_phalcon_db_dialect_getsqltable, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Dialect, select, arginfo_phalcon_db_dialectinterface_select, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Dialect, insert, arginfo_phalcon_db_dialectinterface_insert, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Dialect, onConflict, arginfo_phalcon_db_dialect_onconflict, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Dialect, update, arginfo_phalcon_db_dialectinterface_update, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Dialect, delete, arginfo_phalcon_db_dialectinterface_delete, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Dialect, supportsSavepoints, NULL, ZEND_ACC_PUBLIC)
@@ -1186,6 +1188,75 @@ PHP_METHOD(Phalcon_Db_Dialect, insert)
 	RETURN_MM();
 }
 
+/**
+ * Builds the clause appended to a INSERT statement to resolve unique key conflicts (upsert).
+ * Without columns to update the conflicting rows are left untouched
+ *
+ *<code>
+ * echo $dialect->onConflict(array('id', 'name'), array('id'), array('name'));
+ * // ON CONFLICT ("id") DO UPDATE SET "name" = EXCLUDED."name"
+ *</code>
+ *
+ * @param array $columns
+ * @param array $conflict
+ * @param array $update
+ * @return string
+ */
+PHP_METHOD(Phalcon_Db_Dialect, onConflict){
+
+	zval *columns, *conflict = NULL, *update = NULL, escaped_columns = {}, joined_columns = {}, updates = {}, joined_updates = {}, *column;
+
+	phalcon_fetch_params(1, 1, 2, &columns, &conflict, &update);
+
+	if (conflict && Z_TYPE_P(conflict) == IS_ARRAY && phalcon_fast_count_ev(conflict)) {
+		array_init(&escaped_columns);
+		PHALCON_MM_ADD_ENTRY(&escaped_columns);
+
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(conflict), column) {
+			zval escaped_column = {};
+			PHALCON_MM_CALL_METHOD(&escaped_column, getThis(), "escape", column);
+			phalcon_array_append(&escaped_columns, &escaped_column, 0);
+		} ZEND_HASH_FOREACH_END();
+
+		phalcon_fast_join_str(&joined_columns, SL(", "), &escaped_columns);
+		PHALCON_MM_ADD_ENTRY(&joined_columns);
+	}
+
+	if (!update || Z_TYPE_P(update) != IS_ARRAY || !phalcon_fast_count_ev(update)) {
+		if (Z_TYPE(joined_columns) == IS_STRING) {
+			PHALCON_CONCAT_SVS(return_value, " ON CONFLICT (", &joined_columns, ") DO NOTHING");
+		} else {
+			ZVAL_STRING(return_value, " ON CONFLICT DO NOTHING");
+		}
+		RETURN_MM();
+	}
+
+	/**
+	 * DO UPDATE requires an explicit conflict target
+	 */
+	if (Z_TYPE(joined_columns) != IS_STRING) {
+		PHALCON_MM_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The conflict columns are required to update the conflicting rows");
+		return;
+	}
+
+	array_init(&updates);
+	PHALCON_MM_ADD_ENTRY(&updates);
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(update), column) {
+		zval escaped_column = {}, set_clause_part = {};
+		PHALCON_MM_CALL_METHOD(&escaped_column, getThis(), "escape", column);
+		PHALCON_CONCAT_VSV(&set_clause_part, &escaped_column, " = EXCLUDED.", &escaped_column);
+		zval_ptr_dtor(&escaped_column);
+		phalcon_array_append(&updates, &set_clause_part, 0);
+	} ZEND_HASH_FOREACH_END();
+
+	phalcon_fast_join_str(&joined_updates, SL(", "), &updates);
+	PHALCON_MM_ADD_ENTRY(&joined_updates);
+
+	PHALCON_CONCAT_SVSV(return_value, " ON CONFLICT (", &joined_columns, ") DO UPDATE SET ", &joined_updates);
+	RETURN_MM();
+}
+
 /**
  * Builds a UPDATE statement
  *
@@ -26,4 +26,10 @@ extern zend_class_entry *phalcon_db_dialect_ce;
 
 PHALCON_INIT_CLASS(Phalcon_Db_Dialect);
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_dialect_onconflict, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, columns, IS_ARRAY, 0)
+	ZEND_ARG_INFO(0, conflict)
+	ZEND_ARG_INFO(0, update)
+ZEND_END_ARG_INFO()
+
 #endif /* PHALCON_DB_DIALECT_H */
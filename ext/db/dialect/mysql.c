@@ -67,6 +67,7 @@ PHP_METHOD(Phalcon_Db_Dialect_Mysql, describeIndexes);
 PHP_METHOD(Phalcon_Db_Dialect_Mysql, describeReferences);
 PHP_METHOD(Phalcon_Db_Dialect_Mysql, tableOptions);
 PHP_METHOD(Phalcon_Db_Dialect_Mysql, getDefaultValue);
+PHP_METHOD(Phalcon_Db_Dialect_Mysql, onConflict);
 
 static const zend_function_entry phalcon_db_dialect_mysql_method_entry[] = {
 	PHP_ME(Phalcon_Db_Dialect_Mysql, getColumnDefinition, arginfo_phalcon_db_dialectinterface_getcolumndefinition, ZEND_ACC_PUBLIC)
@@ -93,6 +94,7 @@ static const zend_function_entry phalcon_db_dialect_mysql_method_entry[] = {
 	PHP_ME(Phalcon_Db_Dialect_Mysql, describeReferences, arginfo_phalcon_db_dialectinterface_describereferences, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Dialect_Mysql, tableOptions, arginfo_phalcon_db_dialectinterface_tableoptions, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Db_Dialect_Mysql, getDefaultValue, arginfo_phalcon_db_dialectinterface_getdefaultvalue, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Dialect_Mysql, onConflict, arginfo_phalcon_db_dialect_onconflict, ZEND_ACC_PUBLIC)
 	PHP_FE_END
 };
 
@@ -1259,3 +1261,59 @@ PHP_METHOD(Phalcon_Db_Dialect_Mysql, getDefaultValue){
 	PHALCON_CONCAT_SVS(return_value, "\"", &value_cslashes, "\"");
 	zval_ptr_dtor(&value_cslashes);
 }
+
+/**
+ * Builds the ON DUPLICATE KEY UPDATE clause appended to a INSERT statement.
+ * MySQL resolves the violated unique key by itself so the conflict columns are ignored
+ *
+ *<code>
+ * echo $dialect->onConflict(array('id', 'name'), array('id'), array('name'));
+ * // ON DUPLICATE KEY UPDATE `name` = VALUES(`name`)
+ *</code>
+ *
+ * @param array $columns
+ * @param array $conflict
+ * @param array $update
+ * @return string
+ */
+PHP_METHOD(Phalcon_Db_Dialect_Mysql, onConflict){
+
+	zval *columns, *conflict = NULL, *update = NULL, updates = {}, joined_updates = {}, *column;
+
+	phalcon_fetch_params(1, 1, 2, &columns, &conflict, &update);
+
+	array_init(&updates);
+	PHALCON_MM_ADD_ENTRY(&updates);
+
+	if (!update || Z_TYPE_P(update) != IS_ARRAY || !phalcon_fast_count_ev(update)) {
+		/**
+		 * A no-op assignment keeps the existing row, INSERT IGNORE would also silence unrelated errors
+		 */
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(columns), column) {
+			zval escaped_column = {}, set_clause_part = {};
+			PHALCON_MM_CALL_METHOD(&escaped_column, getThis(), "escape", column);
+			PHALCON_CONCAT_VSV(&set_clause_part, &escaped_column, " = ", &escaped_column);
+			zval_ptr_dtor(&escaped_column);
+			phalcon_array_append(&updates, &set_clause_part, 0);
+			break;
+		} ZEND_HASH_FOREACH_END();
+	} else {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(update), column) {
+			zval escaped_column = {}, set_clause_part = {};
+			PHALCON_MM_CALL_METHOD(&escaped_column, getThis(), "escape", column);
+			PHALCON_CONCAT_VSVS(&set_clause_part, &escaped_column, " = VALUES(", &escaped_column, ")");
+			zval_ptr_dtor(&escaped_column);
+			phalcon_array_append(&updates, &set_clause_part, 0);
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	if (!phalcon_fast_count_ev(&updates)) {
+		PHALCON_MM_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "At least one column is required to build the ON DUPLICATE KEY clause");
+		return;
+	}
+
+	phalcon_fast_join_str(&joined_updates, SL(", "), &updates);
+	PHALCON_CONCAT_SV(return_value, " ON DUPLICATE KEY UPDATE ", &joined_updates);
+	zval_ptr_dtor(&joined_updates);
+	RETURN_MM();
+}
@@ -0,0 +1,845 @@
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2014 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+#include "db/pool.h"
+#include "db/adapterinterface.h"
+#include "db/exception.h"
+#include "di/injectable.h"
+#include "di/service.h"
+#include "async/core.h"
+
+#include <ext/pdo/php_pdo_driver.h>
+
+#include "kernel/main.h"
+#include "kernel/memory.h"
+#include "kernel/fcall.h"
+#include "kernel/object.h"
+#include "kernel/array.h"
+#include "kernel/operators.h"
+#include "kernel/exception.h"
+#include "kernel/time.h"
+
+/**
+ * Phalcon\Db\Pool
+ *
+ * Keeps a bounded set of connections for long running processes such as Phalcon\Server\Http,
+ * Phalcon\Async or CLI workers. Connections are validated when they are borrowed, broken ones
+ * are discarded and the ones idle for too long are closed.
+ *
+ * With Phalcon\Async every task gets its own connection from get(), the connection is bound to the
+ * task until the task finishes or release() is called, so the models of concurrent tasks never share
+ * a connection. The pool can be registered as the connection service of the models
+ *
+ *<code>
+ *
+ *	$di->set('db', function(){
+ *		return new Phalcon\Db\Pool(array(
+ *			'adapter' => 'Phalcon\Db\Adapter\Pdo\Mysql',
+ *			'descriptor' => array(
+ *				'host' => 'localhost',
+ *				'username' => 'root',
+ *				'password' => 'secret',
+ *				'dbname' => 'invo'
+ *			),
+ *			'max' => 16,
+ *			'timeout' => 2
+ *		));
+ *	}, true);
+ *
+ *	Phalcon\Async\Task::async(function() {
+ *		$robots = Robots::find(); // Uses a connection of its own
+ *	});
+ *
+ *</code>
+ */
+zend_class_entry *phalcon_db_pool_ce;
+
+PHP_METHOD(Phalcon_Db_Pool, __construct);
+PHP_METHOD(Phalcon_Db_Pool, get);
+PHP_METHOD(Phalcon_Db_Pool, checkout);
+PHP_METHOD(Phalcon_Db_Pool, release);
+PHP_METHOD(Phalcon_Db_Pool, evict);
+PHP_METHOD(Phalcon_Db_Pool, close);
+PHP_METHOD(Phalcon_Db_Pool, getStatus);
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_pool___construct, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, options, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_pool_checkout, 0, 0, 0)
+	ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_pool_release, 0, 0, 0)
+	ZEND_ARG_OBJ_INFO(0, connection, Phalcon\\Db\\AdapterInterface, 1)
+ZEND_END_ARG_INFO()
+
+static const zend_function_entry phalcon_db_pool_method_entry[] = {
+	PHP_ME(Phalcon_Db_Pool, __construct, arginfo_phalcon_db_pool___construct, ZEND_ACC_PUBLIC|ZEND_ACC_CTOR)
+	PHP_ME(Phalcon_Db_Pool, get, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Pool, checkout, arginfo_phalcon_db_pool_checkout, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Pool, release, arginfo_phalcon_db_pool_release, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Pool, evict, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Pool, close, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Pool, getStatus, NULL, ZEND_ACC_PUBLIC)
+	PHP_FE_END
+};
+
+zend_object_handlers phalcon_db_pool_object_handlers;
+zend_object* phalcon_db_pool_object_create_handler(zend_class_entry *ce)
+{
+	phalcon_db_pool_object *intern = ecalloc(1, sizeof(phalcon_db_pool_object) + zend_object_properties_size(ce));
+	intern->std.ce = ce;
+
+	zend_object_std_init(&intern->std, ce);
+	object_properties_init(&intern->std, ce);
+	intern->std.handlers = &phalcon_db_pool_object_handlers;
+
+	return &intern->std;
+}
+
+void phalcon_db_pool_object_free_handler(zend_object *object)
+{
+#if PHALCON_USE_ASYNC
+	phalcon_db_pool_object *intern = phalcon_db_pool_object_from_obj(object);
+
+	while (intern->waiting.first) {
+		ASYNC_FINISH_OP(intern->waiting.first);
+	}
+#endif
+	zend_object_std_dtor(object);
+}
+
+/**
+ * Phalcon\Db\Pool initializer
+ */
+PHALCON_INIT_CLASS(Phalcon_Db_Pool){
+
+	PHALCON_REGISTER_CLASS_CREATE_OBJECT_EX(Phalcon\\Db, Pool, db_pool, phalcon_di_injectable_ce, phalcon_db_pool_method_entry, 0);
+
+	zend_declare_property_null(phalcon_db_pool_ce, SL("_service"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_pool_ce, SL("_adapter"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_pool_ce, SL("_descriptor"), ZEND_ACC_PROTECTED);
+	zend_declare_property_long(phalcon_db_pool_ce, SL("_min"), 0, ZEND_ACC_PROTECTED);
+	zend_declare_property_long(phalcon_db_pool_ce, SL("_max"), 10, ZEND_ACC_PROTECTED);
+	zend_declare_property_double(phalcon_db_pool_ce, SL("_timeout"), 5, ZEND_ACC_PROTECTED);
+	zend_declare_property_double(phalcon_db_pool_ce, SL("_idleTimeout"), 60, ZEND_ACC_PROTECTED);
+	zend_declare_property_bool(phalcon_db_pool_ce, SL("_validate"), 1, ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_pool_ce, SL("_idle"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_pool_ce, SL("_busy"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_pool_ce, SL("_bound"), ZEND_ACC_PROTECTED);
+
+	return SUCCESS;
+}
+
+/**
+ * Returns the task running and the key its connection is bound to, outside a task the key is 0
+ */
+static zend_ulong phalcon_db_pool_task(zval *task)
+{
+#if PHALCON_USE_ASYNC
+	if (ASYNC_G(task) != NULL) {
+		ZVAL_OBJ(task, &ASYNC_G(task)->std);
+		return ASYNC_G(task)->std.handle;
+	}
+#endif
+	ZVAL_NULL(task);
+	return 0;
+}
+
+/**
+ * Checks if the task a connection is bound to has finished
+ */
+static int phalcon_db_pool_task_finished(zval *task)
+{
+#if PHALCON_USE_ASYNC
+	if (Z_TYPE_P(task) == IS_OBJECT) {
+		async_task *t = (async_task *)((char *) Z_OBJ_P(task) - XtOffsetOf(async_task, std));
+		return t->status != ASYNC_OP_PENDING;
+	}
+#endif
+	return 0;
+}
+
+/**
+ * Clears the exception thrown if it is a connection error
+ */
+static int phalcon_db_pool_connection_error()
+{
+	if (EG(exception) && (instanceof_function(EG(exception)->ce, php_pdo_get_exception()) || instanceof_function(EG(exception)->ce, phalcon_db_exception_ce))) {
+		zend_clear_exception();
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Checks if a connection is already lent or kept idle by the pool
+ */
+static int phalcon_db_pool_holds(zval *pool, zval *connection)
+{
+	zval key = {}, idle = {}, *entry;
+
+	ZVAL_LONG(&key, Z_OBJ_HANDLE_P(connection));
+	if (phalcon_isset_property_array(pool, SL("_busy"), &key)) {
+		return 1;
+	}
+
+	phalcon_read_property(&idle, pool, SL("_idle"), PH_READONLY);
+	if (Z_TYPE(idle) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(idle), entry) {
+			zval held = {};
+			if (phalcon_array_isset_fetch_long(&held, entry, 0, PH_READONLY) && Z_TYPE(held) == IS_OBJECT && Z_OBJ(held) == Z_OBJ_P(connection)) {
+				return 1;
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	return 0;
+}
+
+/**
+ * Opens a new connection from the service or from the adapter and its descriptor. A shared service
+ * would return the same connection every time, it is built again from its definition
+ */
+static int phalcon_db_pool_create(zval *return_value, zval *pool)
+{
+	zval service = {}, adapter = {}, descriptor = {}, dependency_injector = {}, di_service = {}, shared = {};
+	zend_class_entry *ce;
+	int status = SUCCESS;
+
+	phalcon_read_property(&service, pool, SL("_service"), PH_READONLY);
+	if (Z_TYPE(service) == IS_STRING) {
+		PHALCON_CALL_METHOD_FLAG(status, &dependency_injector, pool, "getdi", &PHALCON_GLOBAL(z_true));
+		if (status == SUCCESS) {
+			PHALCON_CALL_METHOD_FLAG(status, &di_service, &dependency_injector, "getservice", &service);
+		}
+		if (status == SUCCESS) {
+			PHALCON_CALL_METHOD_FLAG(status, &shared, &di_service, "isshared");
+		}
+		if (status == SUCCESS && zend_is_true(&shared)) {
+			zval definition = {}, fresh = {};
+
+			PHALCON_CALL_METHOD_FLAG(status, &definition, &di_service, "getdefinition");
+			if (status == SUCCESS) {
+				object_init_ex(&fresh, phalcon_di_service_ce);
+				PHALCON_CALL_METHOD_FLAG(status, NULL, &fresh, "__construct", &service, &definition);
+				if (status == SUCCESS) {
+					PHALCON_CALL_METHOD_FLAG(status, return_value, &fresh, "resolve", &PHALCON_GLOBAL(z_null), &dependency_injector);
+				}
+				zval_ptr_dtor(&fresh);
+			}
+			zval_ptr_dtor(&definition);
+		} else if (status == SUCCESS) {
+			PHALCON_CALL_METHOD_FLAG(status, return_value, &dependency_injector, "get", &service);
+		}
+		zval_ptr_dtor(&di_service);
+		zval_ptr_dtor(&dependency_injector);
+
+		/**
+		 * A definition holding an instance can't give a new connection
+		 */
+		if (status == SUCCESS && !EG(exception) && Z_TYPE_P(return_value) == IS_OBJECT && phalcon_db_pool_holds(pool, return_value)) {
+			zval_ptr_dtor(return_value);
+			ZVAL_NULL(return_value);
+			PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The service of the pool must return a new connection every time");
+			return FAILURE;
+		}
+	} else {
+		phalcon_read_property(&adapter, pool, SL("_adapter"), PH_READONLY);
+		phalcon_read_property(&descriptor, pool, SL("_descriptor"), PH_READONLY);
+
+		ce = phalcon_fetch_class(&adapter, ZEND_FETCH_CLASS_DEFAULT);
+		if (!ce) {
+			return FAILURE;
+		}
+		object_init_ex(return_value, ce);
+		PHALCON_CALL_METHOD_FLAG(status, NULL, return_value, "__construct", &descriptor);
+	}
+
+	if (status == FAILURE || EG(exception)) {
+		zval_ptr_dtor(return_value);
+		ZVAL_NULL(return_value);
+		return FAILURE;
+	}
+
+	if (Z_TYPE_P(return_value) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(return_value), phalcon_db_adapterinterface_ce)) {
+		zval_ptr_dtor(return_value);
+		ZVAL_NULL(return_value);
+		PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The connections of the pool must implement Phalcon\\Db\\AdapterInterface");
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Closes a connection leaving the pool, errors closing it are ignored
+ */
+static void phalcon_db_pool_discard(zval *connection)
+{
+	int status;
+
+	PHALCON_CALL_METHOD_FLAG(status, NULL, connection, "close");
+	if (status == FAILURE) {
+		phalcon_db_pool_connection_error();
+	}
+}
+
+/**
+ * Checks a connection is alive before lending it
+ */
+static int phalcon_db_pool_validate(zval *pool, zval *connection)
+{
+	zval validate = {}, sql = {}, result = {};
+	int status;
+
+	phalcon_read_property(&validate, pool, SL("_validate"), PH_READONLY);
+	if (!zend_is_true(&validate)) {
+		return 1;
+	}
+
+	ZVAL_STRING(&sql, "SELECT 1");
+	PHALCON_CALL_METHOD_FLAG(status, &result, connection, "query", &sql);
+	zval_ptr_dtor(&sql);
+	zval_ptr_dtor(&result);
+
+	if (status == FAILURE || EG(exception)) {
+		phalcon_db_pool_connection_error();
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * Closes the connections idle for longer than the idle timeout, keeping the minimum of connections open
+ */
+static zend_long phalcon_db_pool_evict(zval *pool, double now)
+{
+	zval idle = {}, busy = {}, min = {}, idle_timeout = {}, kept = {}, *entry;
+	zend_long open, evicted = 0;
+
+	phalcon_read_property(&idle, pool, SL("_idle"), PH_READONLY);
+	if (Z_TYPE(idle) != IS_ARRAY || !zend_hash_num_elements(Z_ARRVAL(idle))) {
+		return 0;
+	}
+
+	phalcon_read_property(&busy, pool, SL("_busy"), PH_READONLY);
+	phalcon_read_property(&min, pool, SL("_min"), PH_READONLY);
+	phalcon_read_property(&idle_timeout, pool, SL("_idleTimeout"), PH_READONLY);
+
+	open = zend_hash_num_elements(Z_ARRVAL(idle)) + (Z_TYPE(busy) == IS_ARRAY ? zend_hash_num_elements(Z_ARRVAL(busy)) : 0);
+
+	/**
+	 * Connections are returned at the end of the list, the ones idle for longer are at the beginning
+	 */
+	array_init(&kept);
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(idle), entry) {
+		zval connection = {}, since = {};
+
+		phalcon_array_fetch_long(&connection, entry, 0, PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_long(&since, entry, 1, PH_NOISY|PH_READONLY);
+
+		if (open > phalcon_get_intval(&min) && now - phalcon_get_numberval(&since) > phalcon_get_numberval(&idle_timeout)) {
+			phalcon_db_pool_discard(&connection);
+			open--;
+			evicted++;
+			continue;
+		}
+		phalcon_array_append(&kept, entry, PH_COPY);
+	} ZEND_HASH_FOREACH_END();
+
+	if (evicted) {
+		phalcon_update_property(pool, SL("_idle"), &kept);
+	}
+	zval_ptr_dtor(&kept);
+
+	return evicted;
+}
+
+#if PHALCON_USE_ASYNC
+typedef struct _phalcon_db_pool_wait_op {
+	async_op base;
+	uv_timer_t timer;
+} phalcon_db_pool_wait_op;
+
+static void phalcon_db_pool_wait_timeout(uv_timer_t *timer)
+{
+	phalcon_db_pool_wait_op *op = (phalcon_db_pool_wait_op *) timer->data;
+
+	if (op->base.status == ASYNC_STATUS_PENDING) {
+		ASYNC_FINISH_OP(op);
+	}
+}
+
+static void phalcon_db_pool_wait_dispose(uv_handle_t *handle)
+{
+	phalcon_db_pool_wait_op *op = (phalcon_db_pool_wait_op *) handle->data;
+
+	ASYNC_FREE_OP(op);
+}
+
+/**
+ * Suspends the task until a connection is given back to the pool or the timeout expires, the tasks
+ * waiting are woken up in order
+ */
+static int phalcon_db_pool_wait(zval *pool, double timeout)
+{
+	phalcon_db_pool_object *intern = phalcon_db_pool_object_from_obj(Z_OBJ_P(pool));
+	async_task_scheduler *scheduler = async_task_scheduler_get();
+	async_context *context = async_context_get();
+	phalcon_db_pool_wait_op *op;
+	int status;
+
+	ASYNC_ALLOC_CUSTOM_OP(op, sizeof(phalcon_db_pool_wait_op));
+	ASYNC_APPEND_OP(&intern->waiting, op);
+
+	uv_timer_init(&scheduler->loop, &op->timer);
+	op->timer.data = op;
+	uv_timer_start(&op->timer, phalcon_db_pool_wait_timeout, (uint64_t) (timeout * 1000) + 1, 0);
+
+	if (!async_context_is_background(context)) {
+		ASYNC_BUSY_ENTER(scheduler);
+	}
+
+	status = async_await_op((async_op *) op);
+	if (status == FAILURE) {
+		ASYNC_FORWARD_OP_ERROR(op);
+	}
+
+	if (!async_context_is_background(context)) {
+		ASYNC_BUSY_EXIT(scheduler);
+	}
+
+	uv_timer_stop(&op->timer);
+	ASYNC_UV_CLOSE(&op->timer, phalcon_db_pool_wait_dispose);
+
+	return status;
+}
+
+/**
+ * Wakes up the first task waiting for a connection
+ */
+static void phalcon_db_pool_notify(zval *pool)
+{
+	phalcon_db_pool_object *intern = phalcon_db_pool_object_from_obj(Z_OBJ_P(pool));
+
+	if (intern->waiting.first) {
+		ASYNC_FINISH_OP(intern->waiting.first);
+	}
+}
+#endif
+
+/**
+ * Takes a connection back, connections left inside a transaction are rolled back and broken ones discarded
+ */
+static int phalcon_db_pool_give(zval *pool, zval *connection)
+{
+	zval key = {}, under_transaction = {}, entry = {};
+	int status;
+
+	ZVAL_LONG(&key, Z_OBJ_HANDLE_P(connection));
+	if (!phalcon_isset_property_array(pool, SL("_busy"), &key)) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The connection was not borrowed from this pool");
+		return FAILURE;
+	}
+	phalcon_unset_property_array(pool, SL("_busy"), &key);
+
+	PHALCON_CALL_METHOD_FLAG(status, &under_transaction, connection, "isundertransaction");
+	if (status == SUCCESS && zend_is_true(&under_transaction)) {
+		PHALCON_CALL_METHOD_FLAG(status, NULL, connection, "rollback", &PHALCON_GLOBAL(z_true));
+	}
+
+	if (status == FAILURE || EG(exception)) {
+		if (phalcon_db_pool_connection_error()) {
+			phalcon_db_pool_discard(connection);
+#if PHALCON_USE_ASYNC
+			phalcon_db_pool_notify(pool);
+#endif
+			return SUCCESS;
+		}
+		return FAILURE;
+	}
+
+	array_init_size(&entry, 2);
+	phalcon_array_append(&entry, connection, PH_COPY);
+	add_next_index_double(&entry, phalcon_get_microtime());
+	phalcon_update_property_array(pool, SL("_idle"), &PHALCON_GLOBAL(z_null), &entry);
+	zval_ptr_dtor(&entry);
+
+#if PHALCON_USE_ASYNC
+	phalcon_db_pool_notify(pool);
+#endif
+	return SUCCESS;
+}
+
+/**
+ * Takes back the connections bound to tasks already finished
+ */
+static void phalcon_db_pool_sweep(zval *pool)
+{
+	zval bound = {}, *binding;
+	zend_ulong idx;
+
+	phalcon_read_property(&bound, pool, SL("_bound"), PH_COPY);
+	if (Z_TYPE(bound) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL(bound), idx, binding) {
+			zval key = {}, task = {}, connection = {};
+
+			phalcon_array_fetch_long(&task, binding, 0, PH_NOISY|PH_READONLY);
+			if (!phalcon_db_pool_task_finished(&task)) {
+				continue;
+			}
+
+			phalcon_array_fetch_long(&connection, binding, 1, PH_NOISY|PH_READONLY);
+			ZVAL_LONG(&key, idx);
+			phalcon_unset_property_array(pool, SL("_bound"), &key);
+			if (phalcon_db_pool_give(pool, &connection) == FAILURE) {
+				break;
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+	zval_ptr_dtor(&bound);
+}
+
+/**
+ * Borrows a connection. When the pool is full the tasks of Phalcon\Async wait up to the timeout for a
+ * connection to be given back, without them nothing can give it back meanwhile
+ */
+static int phalcon_db_pool_take(zval *return_value, zval *pool, double timeout)
+{
+	zval max = {};
+	double deadline = phalcon_get_microtime() + timeout;
+	int status = SUCCESS;
+
+	ZVAL_NULL(return_value);
+	phalcon_read_property(&max, pool, SL("_max"), PH_READONLY);
+
+	while (1) {
+		zval idle = {}, busy = {}, key = {};
+		double now = phalcon_get_microtime();
+
+		phalcon_db_pool_sweep(pool);
+		if (EG(exception)) {
+			status = FAILURE;
+			break;
+		}
+		phalcon_db_pool_evict(pool, now);
+
+		/**
+		 * Reuse the connection released last, it is the least likely to be closed by the server
+		 */
+		phalcon_read_property(&idle, pool, SL("_idle"), PH_COPY);
+		while (Z_TYPE(idle) == IS_ARRAY && zend_hash_num_elements(Z_ARRVAL(idle))) {
+			zval entry = {};
+
+			SEPARATE_ARRAY(&idle);
+			phalcon_array_pop(&entry, &idle);
+			phalcon_update_property(pool, SL("_idle"), &idle);
+			phalcon_array_fetch_long(return_value, &entry, 0, PH_NOISY|PH_COPY);
+			zval_ptr_dtor(&entry);
+
+			if (phalcon_db_pool_validate(pool, return_value)) {
+				break;
+			}
+
+			phalcon_db_pool_discard(return_value);
+			zval_ptr_dtor(return_value);
+			ZVAL_NULL(return_value);
+		}
+		zval_ptr_dtor(&idle);
+
+		if (Z_TYPE_P(return_value) == IS_NULL) {
+			phalcon_read_property(&busy, pool, SL("_busy"), PH_READONLY);
+			if (Z_TYPE(busy) != IS_ARRAY || zend_hash_num_elements(Z_ARRVAL(busy)) < phalcon_get_intval(&max)) {
+				if (phalcon_db_pool_create(return_value, pool) == FAILURE) {
+					status = FAILURE;
+					break;
+				}
+			}
+		}
+
+		if (Z_TYPE_P(return_value) == IS_OBJECT) {
+			ZVAL_LONG(&key, Z_OBJ_HANDLE_P(return_value));
+			phalcon_update_property_array(pool, SL("_busy"), &key, return_value);
+			break;
+		}
+
+#if PHALCON_USE_ASYNC
+		/**
+		 * Let the other tasks run until one of them gives a connection back
+		 */
+		if (now < deadline) {
+			status = phalcon_db_pool_wait(pool, deadline - now);
+			if (status == FAILURE) {
+				break;
+			}
+			continue;
+		}
+
+		if (timeout > 0) {
+			PHALCON_THROW_EXCEPTION_FORMAT(phalcon_db_exception_ce, "No connection was released to the pool within %.3f seconds", timeout);
+			status = FAILURE;
+			break;
+		}
+#endif
+
+		PHALCON_THROW_EXCEPTION_FORMAT(phalcon_db_exception_ce, "The pool is exhausted, its " ZEND_LONG_FMT " connections are in use", phalcon_get_intval(&max));
+		status = FAILURE;
+		break;
+	}
+
+	return status;
+}
+
+/**
+ * Phalcon\Db\Pool constructor
+ *
+ * Available options:
+ * service: Name of a service returning a new connection each time it is resolved
+ * adapter: Class of the adapter, used with descriptor when no service is given
+ * descriptor: Descriptor to connect
+ * min: Connections kept open when evicting idle ones, 0 by default
+ * max: Maximum of connections open, 10 by default
+ * timeout: Seconds a task of Phalcon\Async waits for a connection when the pool is full, 5 by default
+ * idleTimeout: Seconds a connection can be idle before being closed, 60 by default
+ * validate: Whether connections are checked before being lent, true by default
+ *
+ * @param array $options
+ */
+PHP_METHOD(Phalcon_Db_Pool, __construct){
+
+	zval *options, service = {}, adapter = {}, descriptor = {}, option = {};
+
+	phalcon_fetch_params(0, 1, 0, &options);
+
+	if (phalcon_array_isset_fetch_str(&service, options, SL("service"), PH_READONLY) && Z_TYPE(service) == IS_STRING) {
+		phalcon_update_property(getThis(), SL("_service"), &service);
+	} else if (phalcon_array_isset_fetch_str(&adapter, options, SL("adapter"), PH_READONLY) && Z_TYPE(adapter) == IS_STRING
+		&& phalcon_array_isset_fetch_str(&descriptor, options, SL("descriptor"), PH_READONLY) && Z_TYPE(descriptor) == IS_ARRAY) {
+		phalcon_update_property(getThis(), SL("_adapter"), &adapter);
+		phalcon_update_property(getThis(), SL("_descriptor"), &descriptor);
+	} else {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The pool requires a service or an adapter with its descriptor");
+		return;
+	}
+
+	if (phalcon_array_isset_fetch_str(&option, options, SL("min"), PH_READONLY)) {
+		phalcon_update_property_long(getThis(), SL("_min"), phalcon_get_intval(&option));
+	}
+
+	if (phalcon_array_isset_fetch_str(&option, options, SL("max"), PH_READONLY)) {
+		if (phalcon_get_intval(&option) < 1) {
+			PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The pool must allow one connection at least");
+			return;
+		}
+		phalcon_update_property_long(getThis(), SL("_max"), phalcon_get_intval(&option));
+	}
+
+	if (phalcon_array_isset_fetch_str(&option, options, SL("timeout"), PH_READONLY)) {
+		ZVAL_DOUBLE(&option, phalcon_get_numberval(&option));
+		phalcon_update_property(getThis(), SL("_timeout"), &option);
+	}
+
+	if (phalcon_array_isset_fetch_str(&option, options, SL("idleTimeout"), PH_READONLY)) {
+		ZVAL_DOUBLE(&option, phalcon_get_numberval(&option));
+		phalcon_update_property(getThis(), SL("_idleTimeout"), &option);
+	}
+
+	if (phalcon_array_isset_fetch_str(&option, options, SL("validate"), PH_READONLY)) {
+		phalcon_update_property_bool(getThis(), SL("_validate"), zend_is_true(&option));
+	}
+}
+
+/**
+ * Returns the connection of the current task, the first call of a task borrows it from the pool
+ * and it is given back when the task finishes or release() is called
+ *
+ * @return Phalcon\Db\AdapterInterface
+ */
+PHP_METHOD(Phalcon_Db_Pool, get){
+
+	zval task = {}, key = {}, binding = {}, connection = {}, timeout = {};
+
+	phalcon_db_pool_sweep(getThis());
+	if (EG(exception)) {
+		return;
+	}
+
+	ZVAL_LONG(&key, phalcon_db_pool_task(&task));
+	if (phalcon_property_array_isset_fetch(&binding, getThis(), SL("_bound"), &key, PH_READONLY)) {
+		phalcon_array_fetch_long(&connection, &binding, 1, PH_NOISY|PH_READONLY);
+		RETURN_CTOR(&connection);
+	}
+
+	phalcon_read_property(&timeout, getThis(), SL("_timeout"), PH_READONLY);
+	if (phalcon_db_pool_take(return_value, getThis(), phalcon_get_numberval(&timeout)) == FAILURE) {
+		return;
+	}
+
+	array_init_size(&binding, 2);
+	phalcon_array_append(&binding, &task, PH_COPY);
+	phalcon_array_append(&binding, return_value, PH_COPY);
+	phalcon_update_property_array(getThis(), SL("_bound"), &key, &binding);
+	zval_ptr_dtor(&binding);
+}
+
+/**
+ * Borrows a connection not bound to the task, it must be given back with release()
+ *
+ *<code>
+ *	$connection = $pool->checkout(0.5);
+ *	try {
+ *		$connection->execute("UPDATE robots SET status = 'idle'");
+ *	} finally {
+ *		$pool->release($connection);
+ *	}
+ *</code>
+ *
+ * @param double $timeout
+ * @return Phalcon\Db\AdapterInterface
+ */
+PHP_METHOD(Phalcon_Db_Pool, checkout){
+
+	zval *timeout = NULL, default_timeout = {};
+
+	phalcon_fetch_params(0, 0, 1, &timeout);
+
+	if (!timeout || Z_TYPE_P(timeout) == IS_NULL) {
+		phalcon_read_property(&default_timeout, getThis(), SL("_timeout"), PH_READONLY);
+		timeout = &default_timeout;
+	}
+
+	phalcon_db_pool_take(return_value, getThis(), phalcon_get_numberval(timeout));
+}
+
+/**
+ * Gives a connection back to the pool, without connection the one bound to the current task is released
+ *
+ * @param Phalcon\Db\AdapterInterface $connection
+ * @return Phalcon\Db\Pool
+ */
+PHP_METHOD(Phalcon_Db_Pool, release){
+
+	zval *connection = NULL, bound = {}, task = {}, key = {}, binding = {}, bound_connection = {}, *item;
+	zend_ulong idx;
+	int status;
+
+	phalcon_fetch_params(0, 0, 1, &connection);
+
+	if (!connection || Z_TYPE_P(connection) == IS_NULL) {
+		ZVAL_LONG(&key, phalcon_db_pool_task(&task));
+		if (!phalcon_property_array_isset_fetch(&binding, getThis(), SL("_bound"), &key, PH_COPY)) {
+			RETURN_THIS();
+		}
+		phalcon_unset_property_array(getThis(), SL("_bound"), &key);
+		phalcon_array_fetch_long(&bound_connection, &binding, 1, PH_NOISY|PH_READONLY);
+		status = phalcon_db_pool_give(getThis(), &bound_connection);
+		zval_ptr_dtor(&binding);
+		if (status == FAILURE) {
+			return;
+		}
+		RETURN_THIS();
+	}
+
+	/**
+	 * A connection given back explicitly is not bound to its task anymore
+	 */
+	phalcon_read_property(&bound, getThis(), SL("_bound"), PH_COPY);
+	if (Z_TYPE(bound) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL(bound), idx, item) {
+			phalcon_array_fetch_long(&bound_connection, item, 1, PH_NOISY|PH_READONLY);
+			if (Z_TYPE(bound_connection) == IS_OBJECT && Z_OBJ(bound_connection) == Z_OBJ_P(connection)) {
+				ZVAL_LONG(&key, idx);
+				phalcon_unset_property_array(getThis(), SL("_bound"), &key);
+				break;
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+	zval_ptr_dtor(&bound);
+
+	if (phalcon_db_pool_give(getThis(), connection) == FAILURE) {
+		return;
+	}
+
+	RETURN_THIS();
+}
+
+/**
+ * Closes the connections idle for longer than the idle timeout and gives back the connections of
+ * the finished tasks, returns the number of connections closed. Long running servers can call it
+ * from a timer
+ *
+ * @return int
+ */
+PHP_METHOD(Phalcon_Db_Pool, evict){
+
+	phalcon_db_pool_sweep(getThis());
+	if (EG(exception)) {
+		return;
+	}
+
+	RETURN_LONG(phalcon_db_pool_evict(getThis(), phalcon_get_microtime()));
+}
+
+/**
+ * Closes every idle connection, the connections borrowed are closed when they are given back
+ *
+ * @return Phalcon\Db\Pool
+ */
+PHP_METHOD(Phalcon_Db_Pool, close){
+
+	zval idle = {}, *entry;
+
+	phalcon_read_property(&idle, getThis(), SL("_idle"), PH_COPY);
+	phalcon_update_property_empty_array(getThis(), SL("_idle"));
+
+	if (Z_TYPE(idle) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(idle), entry) {
+			zval connection = {};
+
+			phalcon_array_fetch_long(&connection, entry, 0, PH_NOISY|PH_READONLY);
+			phalcon_db_pool_discard(&connection);
+		} ZEND_HASH_FOREACH_END();
+	}
+	zval_ptr_dtor(&idle);
+
+	phalcon_update_property_long(getThis(), SL("_min"), 0);
+	RETURN_THIS();
+}
+
+/**
+ * Returns the number of idle, busy and bound connections and the limit of the pool
+ *
+ * @return array
+ */
+PHP_METHOD(Phalcon_Db_Pool, getStatus){
+
+	zval idle = {}, busy = {}, bound = {}, max = {};
+
+	phalcon_read_property(&idle, getThis(), SL("_idle"), PH_READONLY);
+	phalcon_read_property(&busy, getThis(), SL("_busy"), PH_READONLY);
+	phalcon_read_property(&bound, getThis(), SL("_bound"), PH_READONLY);
+	phalcon_read_property(&max, getThis(), SL("_max"), PH_READONLY);
+
+	array_init_size(return_value, 4);
+	phalcon_array_update_str_long(return_value, SL("idle"), Z_TYPE(idle) == IS_ARRAY ? zend_hash_num_elements(Z_ARRVAL(idle)) : 0, 0);
+	phalcon_array_update_str_long(return_value, SL("busy"), Z_TYPE(busy) == IS_ARRAY ? zend_hash_num_elements(Z_ARRVAL(busy)) : 0, 0);
+	phalcon_array_update_str_long(return_value, SL("bound"), Z_TYPE(bound) == IS_ARRAY ? zend_hash_num_elements(Z_ARRVAL(bound)) : 0, 0);
+	phalcon_array_update_str(return_value, SL("max"), &max, PH_COPY);
+}
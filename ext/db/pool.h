@@ -0,0 +1,41 @@
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2014 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+
+#ifndef PHALCON_DB_POOL_H
+#define PHALCON_DB_POOL_H
+
+#include "php_phalcon.h"
+#include "async/core.h"
+
+typedef struct _phalcon_db_pool_object {
+#if PHALCON_USE_ASYNC
+	async_op_list waiting;
+#endif
+	zend_object std;
+} phalcon_db_pool_object;
+
+static inline phalcon_db_pool_object *phalcon_db_pool_object_from_obj(zend_object *obj) {
+	return (phalcon_db_pool_object*)((char*)(obj) - XtOffsetOf(phalcon_db_pool_object, std));
+}
+
+extern zend_class_entry *phalcon_db_pool_ce;
+
+PHALCON_INIT_CLASS(Phalcon_Db_Pool);
+
+#endif /* PHALCON_DB_POOL_H */
@@ -0,0 +1,921 @@
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2014 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+
+#include "db/router.h"
+#include "db/adapterinterface.h"
+#include "db/exception.h"
+#include "db/pool.h"
+#include "di/injectable.h"
+
+#include <ext/pdo/php_pdo_driver.h>
+
+#ifdef PHALCON_CACHE_YAC
+#include "cache/yac.h"
+#endif
+
+#include "kernel/main.h"
+#include "kernel/memory.h"
+#include "kernel/fcall.h"
+#include "kernel/object.h"
+#include "kernel/array.h"
+#include "kernel/operators.h"
+#include "kernel/exception.h"
+#include "kernel/concat.h"
+#include "kernel/time.h"
+
+/**
+ * Phalcon\Db\Router
+ *
+ * Routes the connections of the ORM between a primary server and a set of weighted
+ * read replicas. Reads are balanced between the healthy replicas by round-robin or
+ * by the lowest latency, replicas that fail to connect are ejected with an exponential
+ * backoff, and reads stick to the primary for a while after a write or during a transaction.
+ *
+ * The router is registered as a connection service, the models manager and transactions
+ * ask it for the read or write connection
+ *
+ *<code>
+ *
+ *	$di->set('dbPrimary', function(){
+ *		return new Phalcon\Db\Adapter\Pdo\Mysql($primaryConfig);
+ *	}, true);
+ *
+ *	$di->set('dbReplica1', function(){
+ *		return new Phalcon\Db\Adapter\Pdo\Mysql($replica1Config);
+ *	}, true);
+ *
+ *	$di->set('dbReplica2', function(){
+ *		return new Phalcon\Db\Adapter\Pdo\Mysql($replica2Config);
+ *	}, true);
+ *
+ *	$di->set('db', function(){
+ *		return new Phalcon\Db\Router(array(
+ *			'primary' => 'dbPrimary',
+ *			'replicas' => array(
+ *				'dbReplica1' => array('weight' => 2),
+ *				'dbReplica2'
+ *			),
+ *			'strategy' => Phalcon\Db\Router::STRATEGY_ROUND_ROBIN,
+ *			'stickiness' => 2
+ *		));
+ *	}, true);
+ *
+ *</code>
+ */
+zend_class_entry *phalcon_db_router_ce;
+
+PHP_METHOD(Phalcon_Db_Router, __construct);
+PHP_METHOD(Phalcon_Db_Router, getReadConnection);
+PHP_METHOD(Phalcon_Db_Router, getWriteConnection);
+PHP_METHOD(Phalcon_Db_Router, markWrite);
+PHP_METHOD(Phalcon_Db_Router, eject);
+PHP_METHOD(Phalcon_Db_Router, restore);
+PHP_METHOD(Phalcon_Db_Router, recordLatency);
+PHP_METHOD(Phalcon_Db_Router, check);
+PHP_METHOD(Phalcon_Db_Router, getLastReplica);
+PHP_METHOD(Phalcon_Db_Router, getStatus);
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_router___construct, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, options, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_router_eject, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, name, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_router_restore, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, name, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_db_router_recordlatency, 0, 0, 2)
+	ZEND_ARG_TYPE_INFO(0, name, IS_STRING, 0)
+	ZEND_ARG_TYPE_INFO(0, seconds, IS_DOUBLE, 0)
+ZEND_END_ARG_INFO()
+
+static const zend_function_entry phalcon_db_router_method_entry[] = {
+	PHP_ME(Phalcon_Db_Router, __construct, arginfo_phalcon_db_router___construct, ZEND_ACC_PUBLIC|ZEND_ACC_CTOR)
+	PHP_ME(Phalcon_Db_Router, getReadConnection, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Router, getWriteConnection, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Router, markWrite, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Router, eject, arginfo_phalcon_db_router_eject, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Router, restore, arginfo_phalcon_db_router_restore, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Router, recordLatency, arginfo_phalcon_db_router_recordlatency, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Router, check, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Router, getLastReplica, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Db_Router, getStatus, NULL, ZEND_ACC_PUBLIC)
+	PHP_FE_END
+};
+
+/**
+ * Phalcon\Db\Router initializer
+ */
+PHALCON_INIT_CLASS(Phalcon_Db_Router){
+
+	PHALCON_REGISTER_CLASS_EX(Phalcon\\Db, Router, db_router, phalcon_di_injectable_ce, phalcon_db_router_method_entry, 0);
+
+	zend_declare_property_null(phalcon_db_router_ce, SL("_primary"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_router_ce, SL("_replicas"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_router_ce, SL("_connection"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_router_ce, SL("_connections"), ZEND_ACC_PROTECTED);
+	zend_declare_property_long(phalcon_db_router_ce, SL("_strategy"), PHALCON_DB_ROUTER_STRATEGY_ROUND_ROBIN, ZEND_ACC_PROTECTED);
+	zend_declare_property_double(phalcon_db_router_ce, SL("_stickiness"), 1, ZEND_ACC_PROTECTED);
+	zend_declare_property_double(phalcon_db_router_ce, SL("_backoff"), 1, ZEND_ACC_PROTECTED);
+	zend_declare_property_double(phalcon_db_router_ce, SL("_maxBackoff"), 60, ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_router_ce, SL("_lastWrite"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_db_router_ce, SL("_lastReplica"), ZEND_ACC_PROTECTED);
+
+	zend_declare_class_constant_long(phalcon_db_router_ce, SL("STRATEGY_ROUND_ROBIN"), PHALCON_DB_ROUTER_STRATEGY_ROUND_ROBIN);
+	zend_declare_class_constant_long(phalcon_db_router_ce, SL("STRATEGY_LEAST_LATENCY"), PHALCON_DB_ROUTER_STRATEGY_LEAST_LATENCY);
+
+	return SUCCESS;
+}
+
+/**
+ * Resolves a connection from a service name or an adapter, with tolerant connection errors
+ * are cleared and reported as FAILURE so the caller can eject the server, other errors are kept.
+ * Connections lent by a pool belong to the current task and must not be kept by the router
+ */
+static int phalcon_db_router_resolve(zval *return_value, zval *router, zval *service, int tolerant, int *pooled, double *elapsed)
+{
+	zval dependency_injector = {};
+	double start = phalcon_get_microtime();
+	int status = SUCCESS;
+
+	ZVAL_NULL(return_value);
+	*pooled = 0;
+
+	if (Z_TYPE_P(service) == IS_OBJECT) {
+		ZVAL_COPY(return_value, service);
+	} else {
+		PHALCON_CALL_METHOD_FLAG(status, &dependency_injector, router, "getdi", &PHALCON_GLOBAL(z_true));
+		if (status == SUCCESS) {
+			PHALCON_CALL_METHOD_FLAG(status, return_value, &dependency_injector, "getshared", service);
+		}
+		zval_ptr_dtor(&dependency_injector);
+	}
+
+	/**
+	 * Servers behind a pool lend the connection of the current task
+	 */
+	if (status == SUCCESS && Z_TYPE_P(return_value) == IS_OBJECT && instanceof_function(Z_OBJCE_P(return_value), phalcon_db_pool_ce)) {
+		zval pool = {};
+		*pooled = 1;
+		ZVAL_COPY_VALUE(&pool, return_value);
+		ZVAL_NULL(return_value);
+		PHALCON_CALL_METHOD_FLAG(status, return_value, &pool, "get");
+		zval_ptr_dtor(&pool);
+	}
+
+	if (status == FAILURE || EG(exception)) {
+		if (tolerant && EG(exception) && (instanceof_function(EG(exception)->ce, php_pdo_get_exception()) || instanceof_function(EG(exception)->ce, phalcon_db_exception_ce))) {
+			zend_clear_exception();
+		}
+		zval_ptr_dtor(return_value);
+		ZVAL_NULL(return_value);
+		return FAILURE;
+	}
+
+	if (Z_TYPE_P(return_value) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(return_value), phalcon_db_adapterinterface_ce)) {
+		zval_ptr_dtor(return_value);
+		ZVAL_NULL(return_value);
+		PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The connection routed must implement Phalcon\\Db\\AdapterInterface");
+		return FAILURE;
+	}
+
+	if (elapsed) {
+		*elapsed = phalcon_get_microtime() - start;
+	}
+	return SUCCESS;
+}
+
+/**
+ * Updates a value in the state of a replica
+ */
+static void phalcon_db_router_update_state(zval *router, zval *name, const char *key, uint32_t key_length, zval *value)
+{
+	zval replica = {}, state = {};
+
+	if (phalcon_property_array_isset_fetch(&replica, router, SL("_replicas"), name, PH_READONLY)) {
+		ZVAL_DUP(&state, &replica);
+		phalcon_array_update_str(&state, key, key_length, value, PH_COPY);
+		phalcon_update_property_array(router, SL("_replicas"), name, &state);
+		zval_ptr_dtor(&state);
+	}
+}
+
+#ifdef PHALCON_CACHE_YAC
+/**
+ * Returns the key of the ejection of a replica shared in yac, replicas given as adapters are not shared
+ */
+static zend_string* phalcon_db_router_shared_key(zval *replica)
+{
+	zval service = {};
+
+	if (!PHALCON_GLOBAL(cache).enable_yac || !phalcon_array_isset_fetch_str(&service, replica, SL("service"), PH_READONLY) || Z_TYPE(service) != IS_STRING) {
+		return NULL;
+	}
+
+	return strpprintf(0, "pdbr_" ZEND_XLONG_FMT, (zend_ulong)zend_inline_hash_func(Z_STRVAL(service), Z_STRLEN(service)));
+}
+#endif
+
+/**
+ * Ejects a replica until its backoff expires, the backoff is doubled on every consecutive failure.
+ * With yac the ejection is shared by every process
+ */
+static void phalcon_db_router_eject(zval *router, zval *name)
+{
+	zval replica = {}, failures = {}, retry_at = {}, backoff = {}, max_backoff = {};
+	double delay;
+
+	if (!phalcon_property_array_isset_fetch(&replica, router, SL("_replicas"), name, PH_COPY)) {
+		return;
+	}
+
+	phalcon_array_fetch_str(&failures, &replica, SL("failures"), PH_NOISY|PH_READONLY);
+	phalcon_read_property(&backoff, router, SL("_backoff"), PH_READONLY);
+	phalcon_read_property(&max_backoff, router, SL("_maxBackoff"), PH_READONLY);
+
+	delay = phalcon_get_numberval(&backoff) * (double) (1L << MIN(phalcon_get_intval(&failures), 16));
+	if (delay > phalcon_get_numberval(&max_backoff)) {
+		delay = phalcon_get_numberval(&max_backoff);
+	}
+
+	ZVAL_LONG(&failures, phalcon_get_intval(&failures) + 1);
+	ZVAL_DOUBLE(&retry_at, phalcon_get_microtime() + delay);
+
+	phalcon_db_router_update_state(router, name, SL("failures"), &failures);
+	phalcon_db_router_update_state(router, name, SL("retryAt"), &retry_at);
+	phalcon_unset_property_array(router, SL("_connections"), name);
+
+#ifdef PHALCON_CACHE_YAC
+	{
+		zend_string *key = phalcon_db_router_shared_key(&replica);
+		if (key) {
+			zval shared = {};
+
+			array_init_size(&shared, 2);
+			phalcon_array_append(&shared, &retry_at, PH_COPY);
+			phalcon_array_append(&shared, &failures, PH_COPY);
+			phalcon_cache_yac_add_impl(ZSTR_EMPTY_ALLOC(), key, &shared, (int) phalcon_get_numberval(&max_backoff) * 2 + 1, 0);
+			zval_ptr_dtor(&shared);
+			zend_string_release(key);
+		}
+	}
+#endif
+	zval_ptr_dtor(&replica);
+}
+
+/**
+ * Restores a replica ejected before
+ */
+static void phalcon_db_router_restore(zval *router, zval *name)
+{
+	zval replica = {}, zero = {};
+
+	if (!phalcon_property_array_isset_fetch(&replica, router, SL("_replicas"), name, PH_COPY)) {
+		return;
+	}
+
+	ZVAL_LONG(&zero, 0);
+	phalcon_db_router_update_state(router, name, SL("failures"), &zero);
+	ZVAL_DOUBLE(&zero, 0);
+	phalcon_db_router_update_state(router, name, SL("retryAt"), &zero);
+
+#ifdef PHALCON_CACHE_YAC
+	{
+		zend_string *key = phalcon_db_router_shared_key(&replica);
+		if (key) {
+			phalcon_cache_yac_delete_impl(NULL, 0, ZSTR_VAL(key), ZSTR_LEN(key), 0);
+			zend_string_release(key);
+		}
+	}
+#endif
+	zval_ptr_dtor(&replica);
+}
+
+/**
+ * Checks if a replica is ejected, ejections made by other processes are taken from yac
+ */
+static int phalcon_db_router_is_ejected(zval *router, zval *name, zval *replica, double now)
+{
+	zval retry_at = {};
+
+	phalcon_array_fetch_str(&retry_at, replica, SL("retryAt"), PH_NOISY|PH_READONLY);
+	if (phalcon_get_numberval(&retry_at) > now) {
+		return 1;
+	}
+
+#ifdef PHALCON_CACHE_YAC
+	{
+		zval shared = {}, shared_retry_at = {}, shared_failures = {};
+		zend_string *key = phalcon_db_router_shared_key(replica);
+		int ejected = 0;
+
+		if (!key) {
+			return 0;
+		}
+
+		if (phalcon_cache_yac_get_impl(ZSTR_EMPTY_ALLOC(), key, &shared) && Z_TYPE(shared) == IS_ARRAY
+			&& phalcon_array_isset_fetch_long(&shared_retry_at, &shared, 0, PH_READONLY)
+			&& phalcon_array_isset_fetch_long(&shared_failures, &shared, 1, PH_READONLY)
+			&& phalcon_get_numberval(&shared_retry_at) > now) {
+			phalcon_db_router_update_state(router, name, SL("retryAt"), &shared_retry_at);
+			phalcon_db_router_update_state(router, name, SL("failures"), &shared_failures);
+			ejected = 1;
+		}
+		zval_ptr_dtor(&shared);
+		zend_string_release(key);
+		return ejected;
+	}
+#endif
+
+	return 0;
+}
+
+/**
+ * Picks the next replica among the healthy ones not tried yet, by smooth weighted round-robin
+ * or by the lowest latency measured, replicas without measures are tried first
+ */
+static int phalcon_db_router_pick(zval *return_value, zval *router, zval *tried, double now)
+{
+	zval replicas = {}, strategy = {}, *replica, best_current = {};
+	zend_string *str_key;
+	zend_ulong idx;
+	zend_long total = 0, best_weight = 0;
+	double best_latency = 0;
+	int found = 0;
+
+	ZVAL_NULL(return_value);
+
+	phalcon_read_property(&replicas, router, SL("_replicas"), PH_COPY);
+	phalcon_read_property(&strategy, router, SL("_strategy"), PH_READONLY);
+	if (Z_TYPE(replicas) != IS_ARRAY) {
+		zval_ptr_dtor(&replicas);
+		return 0;
+	}
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(replicas), idx, str_key, replica) {
+		zval name = {}, weight = {}, current = {}, latency = {};
+
+		if (str_key) {
+			ZVAL_STR(&name, str_key);
+		} else {
+			ZVAL_LONG(&name, idx);
+		}
+
+		if (phalcon_array_isset(tried, &name) || phalcon_db_router_is_ejected(router, &name, replica, now)) {
+			continue;
+		}
+
+		phalcon_array_fetch_str(&weight, replica, SL("weight"), PH_NOISY|PH_READONLY);
+
+		if (phalcon_get_intval(&strategy) == PHALCON_DB_ROUTER_STRATEGY_LEAST_LATENCY) {
+			phalcon_array_fetch_str(&latency, replica, SL("latency"), PH_NOISY|PH_READONLY);
+			if (Z_TYPE(latency) == IS_NULL) {
+				zval_ptr_dtor(return_value);
+				ZVAL_COPY(return_value, &name);
+				found = 1;
+				break;
+			}
+			if (!found || phalcon_get_numberval(&latency) < best_latency
+				|| (phalcon_get_numberval(&latency) == best_latency && phalcon_get_intval(&weight) > best_weight)) {
+				zval_ptr_dtor(return_value);
+				ZVAL_COPY(return_value, &name);
+				best_latency = phalcon_get_numberval(&latency);
+				best_weight = phalcon_get_intval(&weight);
+				found = 1;
+			}
+		} else {
+			phalcon_array_fetch_str(&current, replica, SL("current"), PH_NOISY|PH_READONLY);
+			ZVAL_LONG(&current, phalcon_get_intval(&current) + phalcon_get_intval(&weight));
+			phalcon_db_router_update_state(router, &name, SL("current"), &current);
+			total += phalcon_get_intval(&weight);
+
+			if (!found || Z_LVAL(current) > Z_LVAL(best_current)) {
+				zval_ptr_dtor(return_value);
+				ZVAL_COPY(return_value, &name);
+				ZVAL_LONG(&best_current, Z_LVAL(current));
+				found = 1;
+			}
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	zval_ptr_dtor(&replicas);
+
+	if (found && phalcon_get_intval(&strategy) != PHALCON_DB_ROUTER_STRATEGY_LEAST_LATENCY) {
+		ZVAL_LONG(&best_current, Z_LVAL(best_current) - total);
+		phalcon_db_router_update_state(router, return_value, SL("current"), &best_current);
+	}
+
+	return found;
+}
+
+/**
+ * Adds a measure to the average latency of a replica
+ */
+static void phalcon_db_router_measure(zval *router, zval *name, double elapsed)
+{
+	zval replica = {}, latency = {}, average = {};
+
+	if (phalcon_property_array_isset_fetch(&replica, router, SL("_replicas"), name, PH_READONLY)) {
+		phalcon_array_fetch_str(&latency, &replica, SL("latency"), PH_NOISY|PH_READONLY);
+		if (Z_TYPE(latency) == IS_NULL) {
+			ZVAL_DOUBLE(&average, elapsed);
+		} else {
+			ZVAL_DOUBLE(&average, phalcon_get_numberval(&latency) * 0.8 + elapsed * 0.2);
+		}
+		phalcon_db_router_update_state(router, name, SL("latency"), &average);
+	}
+}
+
+/**
+ * Returns the connection to the primary server
+ */
+static int phalcon_db_router_primary(zval *return_value, zval *router)
+{
+	zval primary = {}, connection = {};
+	int pooled;
+
+	phalcon_read_property(&connection, router, SL("_connection"), PH_READONLY);
+	if (Z_TYPE(connection) == IS_OBJECT) {
+		ZVAL_COPY(return_value, &connection);
+		return SUCCESS;
+	}
+
+	phalcon_read_property(&primary, router, SL("_primary"), PH_READONLY);
+	if (phalcon_db_router_resolve(return_value, router, &primary, 0, &pooled, NULL) == FAILURE) {
+		if (!EG(exception)) {
+			PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The primary connection cannot be established");
+		}
+		return FAILURE;
+	}
+
+	if (!pooled) {
+		phalcon_update_property(router, SL("_connection"), return_value);
+	}
+	return SUCCESS;
+}
+
+/**
+ * Phalcon\Db\Router constructor
+ *
+ * Available options:
+ * primary: Service name or adapter of the primary server
+ * replicas: Replicas by name, each one is a service name, an adapter or an array with "service" and "weight"
+ * strategy: Phalcon\Db\Router::STRATEGY_ROUND_ROBIN or Phalcon\Db\Router::STRATEGY_LEAST_LATENCY, the latency is
+ *           only measured when a replica connects and by check(), see recordLatency() to feed query timings
+ * stickiness: Seconds reads stay on the primary after a write, 1 by default. The window is wall-clock time,
+ *             it also covers the next requests of a worker, as replication lag does
+ * backoff: Seconds a replica is ejected after its first failure, doubled on every new failure
+ * maxBackoff: Maximum seconds a replica is ejected
+ *
+ * @param array $options
+ */
+PHP_METHOD(Phalcon_Db_Router, __construct){
+
+	zval *options, primary = {}, replicas = {}, normalized = {}, strategy = {}, stickiness = {}, backoff = {}, max_backoff = {};
+	zval *replica;
+	zend_string *str_key;
+	zend_ulong idx;
+
+	phalcon_fetch_params(0, 1, 0, &options);
+
+	if (!phalcon_array_isset_fetch_str(&primary, options, SL("primary"), PH_READONLY)
+		|| (Z_TYPE(primary) != IS_STRING && Z_TYPE(primary) != IS_OBJECT)) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The primary connection must be a service name or an adapter");
+		return;
+	}
+	phalcon_update_property(getThis(), SL("_primary"), &primary);
+
+	array_init(&normalized);
+	if (phalcon_array_isset_fetch_str(&replicas, options, SL("replicas"), PH_READONLY) && Z_TYPE(replicas) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(replicas), idx, str_key, replica) {
+			zval name = {}, service = {}, weight = {}, state = {};
+
+			if (Z_TYPE_P(replica) == IS_ARRAY) {
+				if (!phalcon_array_isset_fetch_str(&service, replica, SL("service"), PH_READONLY)) {
+					if (!str_key) {
+						zval_ptr_dtor(&normalized);
+						PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The service of the replica is required");
+						return;
+					}
+					ZVAL_STR(&service, str_key);
+				}
+				if (!phalcon_array_isset_fetch_str(&weight, replica, SL("weight"), PH_READONLY)) {
+					ZVAL_LONG(&weight, 1);
+				}
+			} else {
+				ZVAL_COPY_VALUE(&service, replica);
+				ZVAL_LONG(&weight, 1);
+			}
+
+			if (Z_TYPE(service) != IS_STRING && Z_TYPE(service) != IS_OBJECT) {
+				zval_ptr_dtor(&normalized);
+				PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "The replica must be a service name or an adapter");
+				return;
+			}
+
+			if (str_key) {
+				ZVAL_STR(&name, str_key);
+			} else if (Z_TYPE(service) == IS_STRING) {
+				ZVAL_COPY_VALUE(&name, &service);
+			} else {
+				ZVAL_LONG(&name, idx);
+			}
+
+			array_init_size(&state, 6);
+			phalcon_array_update_str(&state, SL("service"), &service, PH_COPY);
+			phalcon_array_update_str_long(&state, SL("weight"), phalcon_get_intval(&weight) > 0 ? phalcon_get_intval(&weight) : 1, 0);
+			phalcon_array_update_str_long(&state, SL("current"), 0, 0);
+			phalcon_array_update_str(&state, SL("latency"), &PHALCON_GLOBAL(z_null), PH_COPY);
+			phalcon_array_update_str_long(&state, SL("failures"), 0, 0);
+			add_assoc_double_ex(&state, SL("retryAt"), 0);
+			phalcon_array_update(&normalized, &name, &state, 0);
+		} ZEND_HASH_FOREACH_END();
+	}
+	phalcon_update_property(getThis(), SL("_replicas"), &normalized);
+	zval_ptr_dtor(&normalized);
+
+	if (phalcon_array_isset_fetch_str(&strategy, options, SL("strategy"), PH_READONLY)) {
+		if (phalcon_get_intval(&strategy) != PHALCON_DB_ROUTER_STRATEGY_ROUND_ROBIN && phalcon_get_intval(&strategy) != PHALCON_DB_ROUTER_STRATEGY_LEAST_LATENCY) {
+			PHALCON_THROW_EXCEPTION_STR(phalcon_db_exception_ce, "Unknown strategy to balance the replicas");
+			return;
+		}
+		phalcon_update_property_long(getThis(), SL("_strategy"), phalcon_get_intval(&strategy));
+	}
+
+	if (phalcon_array_isset_fetch_str(&stickiness, options, SL("stickiness"), PH_READONLY)) {
+		ZVAL_DOUBLE(&stickiness, phalcon_get_numberval(&stickiness));
+		phalcon_update_property(getThis(), SL("_stickiness"), &stickiness);
+	}
+
+	if (phalcon_array_isset_fetch_str(&backoff, options, SL("backoff"), PH_READONLY)) {
+		ZVAL_DOUBLE(&backoff, phalcon_get_numberval(&backoff));
+		phalcon_update_property(getThis(), SL("_backoff"), &backoff);
+	}
+
+	if (phalcon_array_isset_fetch_str(&max_backoff, options, SL("maxBackoff"), PH_READONLY)) {
+		ZVAL_DOUBLE(&max_backoff, phalcon_get_numberval(&max_backoff));
+		phalcon_update_property(getThis(), SL("_maxBackoff"), &max_backoff);
+	}
+}
+
+/**
+ * Returns the connection to read data. The primary is returned while it runs a transaction,
+ * within the stickiness window after a statement was executed on it or markWrite() was called,
+ * or if no replica is available
+ *
+ * @return Phalcon\Db\AdapterInterface
+ */
+PHP_METHOD(Phalcon_Db_Router, getReadConnection){
+
+	zval last_write = {}, primary_write = {}, stickiness = {}, connection = {}, under_transaction = {}, tried = {};
+	double now = phalcon_get_microtime(), written = 0;
+
+	/**
+	 * Asking for the write connection doesn't stick the reads, only a write made on it does
+	 */
+	phalcon_read_property(&connection, getThis(), SL("_connection"), PH_READONLY);
+	if (Z_TYPE(connection) == IS_OBJECT) {
+		phalcon_read_property(&primary_write, &connection, SL("_lastWrite"), PH_READONLY);
+		if (Z_TYPE(primary_write) != IS_NULL) {
+			written = phalcon_get_numberval(&primary_write);
+		}
+	}
+
+	phalcon_read_property(&last_write, getThis(), SL("_lastWrite"), PH_READONLY);
+	if (Z_TYPE(last_write) != IS_NULL && phalcon_get_numberval(&last_write) > written) {
+		written = phalcon_get_numberval(&last_write);
+	}
+
+	if (written > 0) {
+		phalcon_read_property(&stickiness, getThis(), SL("_stickiness"), PH_READONLY);
+		if (now - written < phalcon_get_numberval(&stickiness)) {
+			phalcon_update_property_null(getThis(), SL("_lastReplica"));
+			phalcon_db_router_primary(return_value, getThis());
+			return;
+		}
+	}
+
+	if (Z_TYPE(connection) == IS_OBJECT) {
+		PHALCON_CALL_METHOD(&under_transaction, &connection, "isundertransaction");
+		if (zend_is_true(&under_transaction)) {
+			phalcon_update_property_null(getThis(), SL("_lastReplica"));
+			RETURN_CTOR(&connection);
+		}
+	}
+
+	array_init(&tried);
+
+	while (1) {
+		zval name = {}, replica = {}, service = {};
+		double elapsed = 0;
+		int pooled;
+
+		if (!phalcon_db_router_pick(&name, getThis(), &tried, now)) {
+			break;
+		}
+
+		phalcon_array_update(&tried, &name, &PHALCON_GLOBAL(z_true), PH_COPY);
+
+		if (phalcon_property_array_isset_fetch(&connection, getThis(), SL("_connections"), &name, PH_READONLY)) {
+			phalcon_update_property(getThis(), SL("_lastReplica"), &name);
+			zval_ptr_dtor(&name);
+			zval_ptr_dtor(&tried);
+			RETURN_CTOR(&connection);
+		}
+
+		phalcon_property_array_isset_fetch(&replica, getThis(), SL("_replicas"), &name, PH_READONLY);
+		phalcon_array_fetch_str(&service, &replica, SL("service"), PH_NOISY|PH_READONLY);
+
+		if (phalcon_db_router_resolve(return_value, getThis(), &service, 1, &pooled, &elapsed) == SUCCESS) {
+			phalcon_db_router_measure(getThis(), &name, elapsed);
+			if (!pooled) {
+				phalcon_update_property_array(getThis(), SL("_connections"), &name, return_value);
+			}
+			phalcon_update_property(getThis(), SL("_lastReplica"), &name);
+			zval_ptr_dtor(&name);
+			zval_ptr_dtor(&tried);
+			return;
+		}
+
+		if (EG(exception)) {
+			zval_ptr_dtor(&name);
+			zval_ptr_dtor(&tried);
+			return;
+		}
+
+		phalcon_db_router_eject(getThis(), &name);
+		zval_ptr_dtor(&name);
+	}
+	zval_ptr_dtor(&tried);
+
+	/**
+	 * Without healthy replicas the primary serves the reads
+	 */
+	phalcon_update_property_null(getThis(), SL("_lastReplica"));
+	phalcon_db_router_primary(return_value, getThis());
+}
+
+/**
+ * Returns the connection to the primary to write data. The reads stick to the primary only once
+ * a statement is executed on it, the ORM asks for it to check existence and uniqueness before
+ * anything is written
+ *
+ * @return Phalcon\Db\AdapterInterface
+ */
+PHP_METHOD(Phalcon_Db_Router, getWriteConnection){
+
+	phalcon_db_router_primary(return_value, getThis());
+}
+
+/**
+ * Notifies a write the primary adapter doesn't see, for instance one made through another
+ * connection or a pooled primary, reads stick to the primary during the stickiness window
+ *
+ * @return Phalcon\Db\Router
+ */
+PHP_METHOD(Phalcon_Db_Router, markWrite){
+
+	zval now = {};
+
+	ZVAL_DOUBLE(&now, phalcon_get_microtime());
+	phalcon_update_property(getThis(), SL("_lastWrite"), &now);
+	RETURN_THIS();
+}
+
+/**
+ * Ejects a replica, for instance after a query failed on it
+ *
+ * @param string $name
+ * @return Phalcon\Db\Router
+ */
+PHP_METHOD(Phalcon_Db_Router, eject){
+
+	zval *name;
+
+	phalcon_fetch_params(0, 1, 0, &name);
+
+	if (!phalcon_isset_property_array(getThis(), SL("_replicas"), name)) {
+		PHALCON_THROW_EXCEPTION_FORMAT(phalcon_db_exception_ce, "Replica '%s' is not registered", Z_STRVAL_P(name));
+		return;
+	}
+
+	phalcon_db_router_eject(getThis(), name);
+	RETURN_THIS();
+}
+
+/**
+ * Restores an ejected replica before its backoff expires
+ *
+ * @param string $name
+ * @return Phalcon\Db\Router
+ */
+PHP_METHOD(Phalcon_Db_Router, restore){
+
+	zval *name;
+
+	phalcon_fetch_params(0, 1, 0, &name);
+
+	if (!phalcon_isset_property_array(getThis(), SL("_replicas"), name)) {
+		PHALCON_THROW_EXCEPTION_FORMAT(phalcon_db_exception_ce, "Replica '%s' is not registered", Z_STRVAL_P(name));
+		return;
+	}
+
+	phalcon_db_router_restore(getThis(), name);
+	RETURN_THIS();
+}
+
+/**
+ * Adds a latency measured by the application to the average of a replica. The router doesn't time
+ * the queries sent through the connections it lends, with STRATEGY_LEAST_LATENCY the application
+ * feeds the timings, or calls check() periodically, to keep the averages current
+ *
+ *<code>
+ *	$di->set('dbReplica1', function() use ($di, $replica1Config) {
+ *		$start = 0;
+ *		$eventsManager = new Phalcon\Events\Manager();
+ *		$eventsManager->attach('db', function($event) use ($di, &$start) {
+ *			if ($event->getType() == 'beforeQuery') {
+ *				$start = microtime(true);
+ *			} elseif ($event->getType() == 'afterQuery') {
+ *				$di->getShared('db')->recordLatency('dbReplica1', microtime(true) - $start);
+ *			}
+ *		});
+ *		$connection = new Phalcon\Db\Adapter\Pdo\Mysql($replica1Config);
+ *		$connection->setEventsManager($eventsManager);
+ *		return $connection;
+ *	}, true);
+ *</code>
+ *
+ * @param string $name
+ * @param double $seconds
+ * @return Phalcon\Db\Router
+ */
+PHP_METHOD(Phalcon_Db_Router, recordLatency){
+
+	zval *name, *seconds;
+
+	phalcon_fetch_params(0, 2, 0, &name, &seconds);
+
+	phalcon_db_router_measure(getThis(), name, phalcon_get_numberval(seconds));
+	RETURN_THIS();
+}
+
+/**
+ * Runs a trivial query on every replica measuring its latency, replicas failing are ejected
+ * and replicas whose backoff expired are restored if they answer. Long running servers can
+ * call it periodically
+ *
+ *<code>
+ *	$router->check();
+ *	print_r($router->getStatus());
+ *</code>
+ *
+ * @return array
+ */
+PHP_METHOD(Phalcon_Db_Router, check){
+
+	zval replicas = {}, sql = {}, *replica;
+	zend_string *str_key;
+	zend_ulong idx;
+	double now = phalcon_get_microtime();
+
+	phalcon_read_property(&replicas, getThis(), SL("_replicas"), PH_COPY);
+	if (Z_TYPE(replicas) != IS_ARRAY) {
+		RETURN_EMPTY_ARRAY();
+	}
+
+	array_init(return_value);
+	ZVAL_STRING(&sql, "SELECT 1");
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(replicas), idx, str_key, replica) {
+		zval name = {}, service = {}, connection = {}, result = {};
+		double start, elapsed = 0;
+		int healthy = 0, pooled = 0;
+
+		if (str_key) {
+			ZVAL_STR(&name, str_key);
+		} else {
+			ZVAL_LONG(&name, idx);
+		}
+
+		if (phalcon_db_router_is_ejected(getThis(), &name, replica, now)) {
+			phalcon_array_update(return_value, &name, &PHALCON_GLOBAL(z_false), PH_COPY);
+			continue;
+		}
+
+		if (phalcon_property_array_isset_fetch(&connection, getThis(), SL("_connections"), &name, PH_READONLY)) {
+			Z_TRY_ADDREF(connection);
+		} else {
+			phalcon_array_fetch_str(&service, replica, SL("service"), PH_NOISY|PH_READONLY);
+			phalcon_db_router_resolve(&connection, getThis(), &service, 1, &pooled, NULL);
+		}
+
+		if (Z_TYPE(connection) == IS_OBJECT) {
+			int status;
+			start = phalcon_get_microtime();
+			PHALCON_CALL_METHOD_FLAG(status, &result, &connection, "query", &sql);
+			elapsed = phalcon_get_microtime() - start;
+			if (status == SUCCESS && !EG(exception)) {
+				healthy = 1;
+				if (!pooled) {
+					phalcon_update_property_array(getThis(), SL("_connections"), &name, &connection);
+				}
+			} else if (EG(exception) && (instanceof_function(EG(exception)->ce, php_pdo_get_exception()) || instanceof_function(EG(exception)->ce, phalcon_db_exception_ce))) {
+				zend_clear_exception();
+			}
+			zval_ptr_dtor(&result);
+		}
+		zval_ptr_dtor(&connection);
+
+		if (EG(exception)) {
+			break;
+		}
+
+		if (healthy) {
+			phalcon_db_router_restore(getThis(), &name);
+			phalcon_db_router_measure(getThis(), &name, elapsed);
+		} else {
+			phalcon_db_router_eject(getThis(), &name);
+		}
+		phalcon_array_update(return_value, &name, healthy ? &PHALCON_GLOBAL(z_true) : &PHALCON_GLOBAL(z_false), PH_COPY);
+	} ZEND_HASH_FOREACH_END();
+
+	zval_ptr_dtor(&sql);
+	zval_ptr_dtor(&replicas);
+}
+
+/**
+ * Returns the name of the replica that served the last read, null if it was the primary
+ *
+ * @return string
+ */
+PHP_METHOD(Phalcon_Db_Router, getLastReplica){
+
+	RETURN_MEMBER(getThis(), "_lastReplica");
+}
+
+/**
+ * Returns the state of every replica: weight, average latency, consecutive failures, the
+ * time until it is ejected and whether it is connected
+ *
+ * @return array
+ */
+PHP_METHOD(Phalcon_Db_Router, getStatus){
+
+	zval replicas = {}, *replica;
+	zend_string *str_key;
+	zend_ulong idx;
+	double now = phalcon_get_microtime();
+
+	phalcon_read_property(&replicas, getThis(), SL("_replicas"), PH_COPY);
+	if (Z_TYPE(replicas) != IS_ARRAY) {
+		RETURN_EMPTY_ARRAY();
+	}
+
+	array_init(return_value);
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(replicas), idx, str_key, replica) {
+		zval name = {}, weight = {}, latency = {}, failures = {}, retry_at = {}, status = {};
+
+		if (str_key) {
+			ZVAL_STR(&name, str_key);
+		} else {
+			ZVAL_LONG(&name, idx);
+		}
+
+		phalcon_array_fetch_str(&weight, replica, SL("weight"), PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_str(&latency, replica, SL("latency"), PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_str(&failures, replica, SL("failures"), PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_str(&retry_at, replica, SL("retryAt"), PH_NOISY|PH_READONLY);
+
+		array_init_size(&status, 6);
+		phalcon_array_update_str(&status, SL("weight"), &weight, PH_COPY);
+		phalcon_array_update_str(&status, SL("latency"), &latency, PH_COPY);
+		phalcon_array_update_str(&status, SL("failures"), &failures, PH_COPY);
+		phalcon_array_update_str_bool(&status, SL("healthy"), !phalcon_db_router_is_ejected(getThis(), &name, replica, now), 0);
+		add_assoc_double_ex(&status, SL("ejectedFor"), MAX(phalcon_get_numberval(&retry_at) - now, 0));
+		phalcon_array_update_str_bool(&status, SL("connected"), phalcon_isset_property_array(getThis(), SL("_connections"), &name), 0);
+		phalcon_array_update(return_value, &name, &status, 0);
+	} ZEND_HASH_FOREACH_END();
+
+	zval_ptr_dtor(&replicas);
+}
@@ -0,0 +1,32 @@
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2014 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+
+#ifndef PHALCON_DB_ROUTER_H
+#define PHALCON_DB_ROUTER_H
+
+#include "php_phalcon.h"
+
+#define PHALCON_DB_ROUTER_STRATEGY_ROUND_ROBIN    0
+#define PHALCON_DB_ROUTER_STRATEGY_LEAST_LATENCY  1
+
+extern zend_class_entry *phalcon_db_router_ce;
+
+PHALCON_INIT_CLASS(Phalcon_Db_Router);
+
+#endif /* PHALCON_DB_ROUTER_H */
@@ -67,6 +67,9 @@ void phalcon_http_parser_data_free(phalcon_http_parser_data *data)
 	zval_ptr_dtor(&data->head);
 	smart_str_free(&data->url);
 	smart_str_free(&data->body);
+	if (data->body_stream) {
+		php_stream_close(data->body_stream);
+	}
 	if (data->last_key) {
 		zend_string_free(data->last_key);
 	}
@@ -48,6 +48,7 @@ typedef struct {
     zval head;
     smart_str url;
     smart_str body;
+    php_stream *body_stream;
     zend_string *last_key;
 } phalcon_http_parser_data;
 
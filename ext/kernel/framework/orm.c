@@ -24,6 +24,16 @@
 #include "kernel/string.h"
 #include "kernel/concat.h"
 #include "kernel/array.h"
+#include "kernel/object.h"
+#include "kernel/fcall.h"
+#include "kernel/exception.h"
+
+#include "mvc/model/exception.h"
+#include "db/column.h"
+
+#ifdef PHALCON_CACHE_YAC
+#include "cache/yac.h"
+#endif
 
 #include <Zend/zend_smart_str.h>
 
@@ -39,6 +49,15 @@ void phalcon_orm_destroy_cache() {
 		FREE_HASHTABLE(phalcon_globals_ptr->orm.ast_cache);
 		phalcon_globals_ptr->orm.ast_cache = NULL;
 	}
+
+	if (phalcon_globals_ptr->orm.statement_cache != NULL) {
+		zend_hash_destroy(phalcon_globals_ptr->orm.statement_cache);
+		FREE_HASHTABLE(phalcon_globals_ptr->orm.statement_cache);
+		phalcon_globals_ptr->orm.statement_cache = NULL;
+	}
+
+	/* Query::clearCache() of another process moves the shared version, read it again next request */
+	phalcon_globals_ptr->orm.statement_cache_version = -1;
 }
 
 /**
@@ -87,6 +106,367 @@ void phalcon_orm_set_prepared_ast(zval *unique_id, zval *prepared_ast) {
 
 }
 
+/**
+ * Returns the version of the statement cache, shared memory keeps it consistent between workers
+ */
+static zend_long phalcon_orm_statement_cache_version() {
+
+	zend_phalcon_globals *phalcon_globals_ptr = PHALCON_VGLOBAL;
+
+	if (phalcon_globals_ptr->orm.statement_cache_version < 0) {
+		phalcon_globals_ptr->orm.statement_cache_version = 0;
+#ifdef PHALCON_CACHE_YAC
+		if (phalcon_globals_ptr->cache.enable_yac) {
+			zval version = {};
+			zend_string *key = zend_string_init(SL("phqlversion"), 0);
+			if (phalcon_cache_yac_get_impl(ZSTR_EMPTY_ALLOC(), key, &version) && Z_TYPE(version) == IS_LONG) {
+				phalcon_globals_ptr->orm.statement_cache_version = Z_LVAL(version);
+			}
+			zend_string_release(key);
+		}
+#endif
+	}
+
+	return phalcon_globals_ptr->orm.statement_cache_version;
+}
+
+/**
+ * Builds the key of a statement, the source is hashed to fit in the shared memory keys. The version
+ * of the models meta-data is part of the key, statements built from a stale meta-data are not reused
+ */
+static zend_string* phalcon_orm_statement_cache_key(char kind, zval *source, zend_long metadata_version) {
+
+	return strpprintf(0, "phql%c_" ZEND_XLONG_FMT "_" ZEND_LONG_FMT "_" ZEND_LONG_FMT, kind,
+		(zend_ulong)zend_inline_hash_func(Z_STRVAL_P(source), Z_STRLEN_P(source)), phalcon_orm_statement_cache_version(), metadata_version);
+}
+
+/**
+ * Obtains a cached intermediate representation or SQL statement, the source is the PHQL (plus the
+ * generation options for SQL statements). Returns 1 on a hit
+ */
+int phalcon_orm_get_cached_statement(zval *return_value, char kind, zval *source, zend_long metadata_version) {
+
+	zend_phalcon_globals *phalcon_globals_ptr = PHALCON_VGLOBAL;
+	zval entry = {}, entry_source = {}, value = {};
+	zend_string *key;
+	zval *cached;
+	int found = 0;
+
+	if (!phalcon_globals_ptr->orm.enable_statement_cache || Z_TYPE_P(source) != IS_STRING) {
+		return 0;
+	}
+
+	key = phalcon_orm_statement_cache_key(kind, source, metadata_version);
+
+	if (phalcon_globals_ptr->orm.statement_cache != NULL && (cached = zend_hash_find(phalcon_globals_ptr->orm.statement_cache, key)) != NULL) {
+		ZVAL_COPY(&entry, cached);
+	}
+#ifdef PHALCON_CACHE_YAC
+	else if (phalcon_globals_ptr->cache.enable_yac) {
+		if (!phalcon_cache_yac_get_impl(ZSTR_EMPTY_ALLOC(), key, &entry)) {
+			ZVAL_UNDEF(&entry);
+		} else if (Z_TYPE(entry) == IS_ARRAY) {
+			if (!phalcon_globals_ptr->orm.statement_cache) {
+				ALLOC_HASHTABLE(phalcon_globals_ptr->orm.statement_cache);
+				zend_hash_init(phalcon_globals_ptr->orm.statement_cache, 0, NULL, ZVAL_PTR_DTOR, 0);
+			}
+			Z_TRY_ADDREF(entry);
+			zend_hash_update(phalcon_globals_ptr->orm.statement_cache, key, &entry);
+		}
+	}
+#endif
+
+	/**
+	 * Different sources can share a hash, the entry keeps the source to discard them
+	 */
+	if (Z_TYPE(entry) == IS_ARRAY
+		&& phalcon_array_isset_fetch_str(&entry_source, &entry, SL("source"), PH_READONLY)
+		&& phalcon_array_isset_fetch_str(&value, &entry, SL("value"), PH_READONLY)
+		&& Z_TYPE(entry_source) == IS_STRING && zend_string_equals(Z_STR(entry_source), Z_STR_P(source))) {
+		ZVAL_COPY(return_value, &value);
+		found = 1;
+	}
+
+	zval_ptr_dtor(&entry);
+	zend_string_release(key);
+
+	if (found) {
+		phalcon_globals_ptr->orm.statement_cache_hits++;
+	} else {
+		phalcon_globals_ptr->orm.statement_cache_misses++;
+	}
+
+	return found;
+}
+
+/**
+ * Stores an intermediate representation or SQL statement in the cache
+ */
+void phalcon_orm_set_cached_statement(char kind, zval *source, zval *value, zend_long metadata_version) {
+
+	zend_phalcon_globals *phalcon_globals_ptr = PHALCON_VGLOBAL;
+	zval entry = {};
+	zend_string *key;
+
+	if (!phalcon_globals_ptr->orm.enable_statement_cache || Z_TYPE_P(source) != IS_STRING) {
+		return;
+	}
+
+	key = phalcon_orm_statement_cache_key(kind, source, metadata_version);
+
+	array_init_size(&entry, 2);
+	phalcon_array_update_str(&entry, SL("source"), source, PH_COPY);
+	phalcon_array_update_str(&entry, SL("value"), value, PH_COPY);
+
+#ifdef PHALCON_CACHE_YAC
+	if (phalcon_globals_ptr->cache.enable_yac) {
+		phalcon_cache_yac_add_impl(ZSTR_EMPTY_ALLOC(), key, &entry, 0, 0);
+	}
+#endif
+
+	if (!phalcon_globals_ptr->orm.statement_cache) {
+		ALLOC_HASHTABLE(phalcon_globals_ptr->orm.statement_cache);
+		zend_hash_init(phalcon_globals_ptr->orm.statement_cache, 0, NULL, ZVAL_PTR_DTOR, 0);
+	}
+
+	zend_hash_update(phalcon_globals_ptr->orm.statement_cache, key, &entry);
+	zend_string_release(key);
+}
+
+/**
+ * Invalidates every cached statement by moving to a new version, the shared version is incremented
+ * atomically so two processes clearing at once don't end on the same version
+ */
+void phalcon_orm_clear_cached_statements() {
+
+	zend_phalcon_globals *phalcon_globals_ptr = PHALCON_VGLOBAL;
+	zend_long version = phalcon_orm_statement_cache_version() + 1;
+
+#ifdef PHALCON_CACHE_YAC
+	if (phalcon_globals_ptr->cache.enable_yac) {
+		zend_string *key = zend_string_init(SL("phqlversion"), 0);
+		long shared_version;
+		if (phalcon_cache_yac_incr_impl(ZSTR_EMPTY_ALLOC(), key, 1, 0, &shared_version)) {
+			version = shared_version;
+		}
+		zend_string_release(key);
+	}
+#endif
+
+	phalcon_globals_ptr->orm.statement_cache_version = version;
+
+	if (phalcon_globals_ptr->orm.statement_cache != NULL) {
+		zend_hash_clean(phalcon_globals_ptr->orm.statement_cache);
+	}
+}
+
+/**
+ * Returns the hits, misses and entries of the statement cache
+ */
+void phalcon_orm_get_statement_cache_stats(zval *return_value) {
+
+	zend_phalcon_globals *phalcon_globals_ptr = PHALCON_VGLOBAL;
+
+	array_init_size(return_value, 5);
+	add_assoc_long_ex(return_value, SL("hits"), phalcon_globals_ptr->orm.statement_cache_hits);
+	add_assoc_long_ex(return_value, SL("misses"), phalcon_globals_ptr->orm.statement_cache_misses);
+	add_assoc_long_ex(return_value, SL("entries"), phalcon_globals_ptr->orm.statement_cache ? zend_hash_num_elements(phalcon_globals_ptr->orm.statement_cache) : 0);
+	add_assoc_long_ex(return_value, SL("version"), phalcon_orm_statement_cache_version());
+	add_assoc_bool_ex(return_value, SL("shared"), phalcon_globals_ptr->cache.enable_yac);
+}
+
+/**
+ * Hydrates a record cloned from the base with a row following a plan built by
+ * Phalcon\Mvc\Model\MetaData::getHydrationPlan, declared properties are written
+ * directly in their slots
+ */
+int phalcon_orm_hydrate(zval *return_value, zval *base, zval *data, zval *plan, zval *dirty_state, zval *source_model) {
+
+	zval class_name = {}, column_map = {}, fields = {}, convert = {}, primary_keys = {}, after_fetch = {};
+	zval connection = {}, snapshot = {}, *value;
+	zend_string *str_key;
+	zend_object *object;
+	int same_class, auto_convert, status = SUCCESS;
+
+	if (phalcon_clone(return_value, base) == FAILURE) {
+		return FAILURE;
+	}
+
+	phalcon_array_fetch_str(&class_name, plan, SL("class"), PH_NOISY|PH_READONLY);
+	phalcon_array_fetch_str(&column_map, plan, SL("columnMap"), PH_NOISY|PH_READONLY);
+	phalcon_array_fetch_str(&fields, plan, SL("fields"), PH_NOISY|PH_READONLY);
+	phalcon_array_fetch_str(&convert, plan, SL("convert"), PH_NOISY|PH_READONLY);
+	phalcon_array_fetch_str(&primary_keys, plan, SL("primaryKeys"), PH_NOISY|PH_READONLY);
+	phalcon_array_fetch_str(&after_fetch, plan, SL("afterFetch"), PH_NOISY|PH_READONLY);
+
+	object = Z_OBJ_P(return_value);
+	same_class = Z_TYPE(class_name) == IS_STRING && zend_string_equals(object->ce->name, Z_STR(class_name));
+	auto_convert = PHALCON_GLOBAL(orm).enable_auto_convert && zend_is_true(&convert) && source_model && Z_TYPE_P(source_model) == IS_OBJECT;
+
+	/**
+	 * Change the dirty state to persistent
+	 */
+	phalcon_update_property(return_value, SL("_dirtyState"), dirty_state);
+
+	array_init_size(&snapshot, zend_hash_num_elements(Z_ARRVAL_P(data)));
+
+	ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(data), str_key, value) {
+		zval key = {}, field = {}, attribute = {}, field_type = {}, offset = {}, convert_value = {}, *slot;
+
+		/**
+		 * Only string keys in the data are valid
+		 */
+		if (!str_key) {
+			continue;
+		}
+
+		ZVAL_STR(&key, str_key);
+		if (phalcon_array_isset_fetch(&field, &fields, &key, PH_READONLY)) {
+			phalcon_array_fetch_long(&attribute, &field, 0, PH_NOISY|PH_READONLY);
+			phalcon_array_fetch_long(&field_type, &field, 1, PH_NOISY|PH_READONLY);
+			phalcon_array_fetch_long(&offset, &field, 2, PH_NOISY|PH_READONLY);
+		} else if (Z_TYPE(column_map) == IS_ARRAY) {
+			zval exception_message = {};
+			/**
+			 * Every field must be part of the column map
+			 */
+			PHALCON_CONCAT_SVS(&exception_message, "Column \"", &key, "\" doesn't make part of the column map");
+			PHALCON_THROW_EXCEPTION_ZVAL(phalcon_mvc_model_exception_ce, &exception_message);
+			zval_ptr_dtor(&exception_message);
+			status = FAILURE;
+			break;
+		} else {
+			ZVAL_COPY_VALUE(&attribute, &key);
+			ZVAL_LONG(&offset, -1);
+		}
+
+		if (auto_convert && Z_TYPE(field_type) == IS_LONG) {
+			switch (Z_LVAL(field_type)) {
+				case PHALCON_DB_COLUMN_TYPE_JSON:
+					status = phalcon_json_decode(&convert_value, value, 1);
+					break;
+				case PHALCON_DB_COLUMN_TYPE_BYTEA:
+				case PHALCON_DB_COLUMN_TYPE_ARRAY:
+				case PHALCON_DB_COLUMN_TYPE_INT_ARRAY:
+					/**
+					 * The connection is only needed to unescape values
+					 */
+					if (Z_TYPE(connection) != IS_OBJECT) {
+						PHALCON_CALL_METHOD_FLAG(status, &connection, source_model, "getreadconnection");
+						if (status == FAILURE) {
+							break;
+						}
+					}
+					if (Z_LVAL(field_type) == PHALCON_DB_COLUMN_TYPE_BYTEA) {
+						PHALCON_CALL_METHOD_FLAG(status, &convert_value, &connection, "unescapebytea", value);
+					} else {
+						PHALCON_CALL_METHOD_FLAG(status, &convert_value, &connection, "unescapearray", value, &field_type);
+					}
+					break;
+				default:
+					ZVAL_COPY(&convert_value, value);
+			}
+			if (status == FAILURE) {
+				zval_ptr_dtor(&convert_value);
+				break;
+			}
+		} else {
+			ZVAL_COPY(&convert_value, value);
+		}
+
+		if (same_class && Z_LVAL(offset) >= 0 && Z_TYPE_P(slot = OBJ_PROP(object, Z_LVAL(offset))) != IS_UNDEF && !Z_ISREF_P(slot)) {
+			zval garbage = {};
+			ZVAL_COPY_VALUE(&garbage, slot);
+			ZVAL_COPY(slot, &convert_value);
+			zval_ptr_dtor(&garbage);
+		} else {
+			phalcon_update_property_zval_zval(return_value, &attribute, &convert_value);
+		}
+
+		phalcon_array_update(&snapshot, &attribute, &convert_value, 0);
+	} ZEND_HASH_FOREACH_END();
+
+	zval_ptr_dtor(&connection);
+
+	if (status == FAILURE) {
+		zval_ptr_dtor(&snapshot);
+		return FAILURE;
+	}
+
+	phalcon_update_property(return_value, SL("_snapshot"), &snapshot);
+
+	if (Z_TYPE(primary_keys) == IS_ARRAY) {
+		zval where_pk = {}, unique_params = {}, unique_types = {}, *part;
+		int not_empty_num = 0;
+
+		array_init(&where_pk);
+		array_init(&unique_params);
+		array_init(&unique_types);
+
+		/**
+		 * The unique key is built from the precomputed conditions
+		 */
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(primary_keys), part) {
+			zval attribute_field = {}, bind_key = {}, pk_condition = {}, null_condition = {}, type = {}, pk_value = {};
+
+			phalcon_array_fetch_long(&attribute_field, part, 0, PH_NOISY|PH_READONLY);
+			phalcon_array_fetch_long(&bind_key, part, 1, PH_NOISY|PH_READONLY);
+			phalcon_array_fetch_long(&pk_condition, part, 2, PH_NOISY|PH_READONLY);
+			phalcon_array_fetch_long(&null_condition, part, 3, PH_NOISY|PH_READONLY);
+			phalcon_array_fetch_long(&type, part, 4, PH_NOISY|PH_READONLY);
+
+			if (unlikely(!PHALCON_GLOBAL(orm).allow_update_primary)
+				|| !phalcon_array_isset_fetch(&pk_value, &snapshot, &attribute_field, PH_READONLY)
+			) {
+				if (phalcon_isset_property_zval(return_value, &attribute_field)) {
+					phalcon_read_property_zval(&pk_value, return_value, &attribute_field, PH_NOISY|PH_READONLY);
+				}
+			}
+
+			if (Z_TYPE(pk_value) <= IS_NULL) {
+				phalcon_array_append(&where_pk, &null_condition, PH_COPY);
+			} else {
+				not_empty_num += 1;
+				phalcon_array_update(&unique_params, &bind_key, &pk_value, PH_COPY);
+				if (Z_TYPE(type) != IS_NULL) {
+					phalcon_array_update(&unique_types, &bind_key, &type, PH_COPY);
+				}
+				phalcon_array_append(&where_pk, &pk_condition, PH_COPY);
+			}
+		} ZEND_HASH_FOREACH_END();
+
+		if (not_empty_num <= 0) {
+			phalcon_update_property_null(return_value, SL("_uniqueKey"));
+			phalcon_update_property_null(return_value, SL("_uniqueParams"));
+			phalcon_update_property_null(return_value, SL("_uniqueTypes"));
+		} else {
+			zval join_where = {};
+			phalcon_fast_join_str(&join_where, SL(" AND "), &where_pk);
+
+			phalcon_update_property(return_value, SL("_uniqueKey"), &join_where);
+			phalcon_update_property(return_value, SL("_uniqueParams"), &unique_params);
+			phalcon_update_property(return_value, SL("_uniqueTypes"), &unique_types);
+			zval_ptr_dtor(&join_where);
+		}
+		zval_ptr_dtor(&where_pk);
+		zval_ptr_dtor(&unique_params);
+		zval_ptr_dtor(&unique_types);
+	} else {
+		PHALCON_CALL_METHOD_FLAG(status, NULL, return_value, "build");
+	}
+	zval_ptr_dtor(&snapshot);
+
+	if (status == SUCCESS && zend_is_true(&after_fetch)) {
+		/**
+		 * Call afterFetch, this allows the developer to execute actions after a record is
+		 * fetched from the database
+		 */
+		PHALCON_CALL_METHOD_FLAG(status, NULL, return_value, "afterfetch");
+	}
+
+	return status;
+}
+
 /**
  * Escapes single quotes into database single quotes
  */
@@ -20,7 +20,16 @@
 void phalcon_orm_destroy_cache();
 void phalcon_orm_get_prepared_ast(zval *return_value, zval *unique_id);
 void phalcon_orm_set_prepared_ast(zval *unique_id, zval *prepared_ast);
+
+#define PHALCON_ORM_CACHE_INTERMEDIATE 'i'
+#define PHALCON_ORM_CACHE_SQL          's'
+
+int phalcon_orm_get_cached_statement(zval *return_value, char kind, zval *source, zend_long metadata_version);
+void phalcon_orm_set_cached_statement(char kind, zval *source, zval *value, zend_long metadata_version);
+void phalcon_orm_clear_cached_statements();
+void phalcon_orm_get_statement_cache_stats(zval *return_value);
 void phalcon_orm_singlequotes(zval *return_value, zval *str);
+int phalcon_orm_hydrate(zval *return_value, zval *base, zval *data, zval *plan, zval *dirty_state, zval *source_model);
 
 void phalcon_orm_phql_build_group(zval *return_value, zval *group);
 void phalcon_orm_phql_build_order(zval *return_value, zval *order);
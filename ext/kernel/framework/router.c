@@ -23,12 +23,13 @@
 #include <Zend/zend_smart_str.h>
 #include <ext/standard/php_string.h>
 
-zval *phalcon_replace_marker(int named, zval *paths, zval *replacements, unsigned long *position, char *cursor, char *marker)
+static zend_string *phalcon_replace_marker_key(int named, zval *paths, unsigned long *position, char *cursor, char *marker)
 {
-	unsigned int length = 0, variable_length, ch, j;
+	unsigned int length = 0, variable_length = 0, ch, j;
 	char *item = NULL, *cursor_var, *variable = NULL;
 	int not_valid = 0;
-	zval *zv, *tmp;
+	zend_string *key = NULL;
+	zval *zv;
 
 	if (named) {
 		length = cursor - marker - 1;
@@ -64,27 +65,14 @@ zval *phalcon_replace_marker(int named, zval *paths, zval *replacements, unsigne
 		if (zend_hash_index_exists(Z_ARRVAL_P(paths), *position)) {
 			if (named) {
 				if (variable) {
-					efree(item);
-					item = variable;
-					length = variable_length;
-				}
-
-				if (zend_hash_str_exists(Z_ARRVAL_P(replacements), item, length)) {
-					if ((zv = zend_hash_str_find(Z_ARRVAL_P(replacements), item, length)) != NULL) {
-						efree(item);
-						(*position)++;
-						return zv;
-					}
+					key = zend_string_init(variable, variable_length, 0);
+				} else {
+					key = zend_string_init(item, length, 0);
 				}
 			} else {
 				if ((zv = zend_hash_index_find(Z_ARRVAL_P(paths), *position)) != NULL) {
 					if (Z_TYPE_P(zv) == IS_STRING) {
-						if (zend_hash_str_exists(Z_ARRVAL_P(replacements), Z_STRVAL_P(zv), Z_STRLEN_P(zv))) {
-							if ((tmp = zend_hash_str_find(Z_ARRVAL_P(replacements), Z_STRVAL_P(zv), Z_STRLEN_P(zv))) != NULL) {
-								(*position)++;
-								return tmp;
-							}
-						}
+						key = zend_string_copy(Z_STR_P(zv));
 					}
 				}
 			}
@@ -97,26 +85,47 @@ zval *phalcon_replace_marker(int named, zval *paths, zval *replacements, unsigne
 		efree(item);
 	}
 
-return NULL;
+	if (variable) {
+		efree(variable);
+	}
+
+	return key;
+}
+
+static void phalcon_reversed_pattern_add_key(zval *template, smart_str *literal, zend_string *key)
+{
+	if (!key) {
+		return;
+	}
+
+	smart_str_0(literal);
+	if (literal->s) {
+		add_next_index_str(template, literal->s);
+		literal->s = NULL;
+	} else {
+		add_next_index_stringl(template, "", 0);
+	}
+
+	add_next_index_str(template, key);
 }
 
 /**
- * Replaces placeholders and named variables with their corresponding values in an array
+ * Splits a route pattern into literal segments and the names of the variables that
+ * replace its placeholders. Literals use the even positions and names the odd ones
  */
-void phalcon_replace_paths(zval *return_value, zval *pattern, zval *paths, zval *replacements){
+void phalcon_compile_reversed_pattern(zval *return_value, zval *pattern, zval *paths){
 
-	zval *replace, replace_copy = {};
 	char *cursor, *marker = NULL;
 	unsigned int bracket_count = 0, parentheses_count = 0, intermediate = 0;
 	unsigned char ch;
-	smart_str route_str = {0};
+	smart_str literal = {0};
 	ulong position = 1;
 	int i;
-	int use_copy, looking_placeholder = 0;
+	int looking_placeholder = 0;
 
-	if (Z_TYPE_P(pattern) != IS_STRING || Z_TYPE_P(replacements) != IS_ARRAY || Z_TYPE_P(paths) != IS_ARRAY) {
+	if (Z_TYPE_P(pattern) != IS_STRING || Z_TYPE_P(paths) != IS_ARRAY) {
 		ZVAL_NULL(return_value);
-		php_error_docref(NULL, E_WARNING, "Invalid arguments supplied for phalcon_replace_paths()");
+		php_error_docref(NULL, E_WARNING, "Invalid arguments supplied for phalcon_compile_reversed_pattern()");
 		return;
 	}
 
@@ -125,6 +134,8 @@ void phalcon_replace_paths(zval *return_value, zval *pattern, zval *paths, zval
 		return;
 	}
 
+	array_init(return_value);
+
 	cursor = Z_STRVAL_P(pattern);
 	if (*cursor == '/') {
 		++cursor;
@@ -135,7 +146,7 @@ void phalcon_replace_paths(zval *return_value, zval *pattern, zval *paths, zval
 	}
 
 	if (!zend_hash_num_elements(Z_ARRVAL_P(paths))) {
-		ZVAL_STRINGL(return_value, Z_STRVAL_P(pattern)+i, Z_STRLEN_P(pattern)-i);
+		add_next_index_stringl(return_value, Z_STRVAL_P(pattern)+i, Z_STRLEN_P(pattern)-i);
 		return;
 	}
 
@@ -158,20 +169,7 @@ void phalcon_replace_paths(zval *return_value, zval *pattern, zval *paths, zval
 					bracket_count--;
 					if (intermediate > 0) {
 						if (bracket_count == 0) {
-							replace = phalcon_replace_marker(1, paths, replacements, &position, cursor, marker);
-							if (replace) {
-								use_copy = 0;
-								if (Z_TYPE_P(replace) != IS_STRING) {
-									use_copy = zend_make_printable_zval(replace, &replace_copy);
-									if (use_copy) {
-										replace = &replace_copy;
-									}
-								}
-								smart_str_appendl(&route_str, Z_STRVAL_P(replace), Z_STRLEN_P(replace));
-								if (use_copy) {
-									zval_dtor(&replace_copy);
-								}
-							}
+							phalcon_reversed_pattern_add_key(return_value, &literal, phalcon_replace_marker_key(1, paths, &position, cursor, marker));
 							cursor++;
 							continue;
 						}
@@ -192,20 +190,7 @@ void phalcon_replace_paths(zval *return_value, zval *pattern, zval *paths, zval
 					parentheses_count--;
 					if (intermediate > 0) {
 						if (parentheses_count == 0) {
-							replace = phalcon_replace_marker(0, paths, replacements, &position, cursor, marker);
-							if (replace) {
-								use_copy = 0;
-								if (Z_TYPE_P(replace) != IS_STRING) {
-									use_copy = zend_make_printable_zval(replace, &replace_copy);
-									if (use_copy) {
-										replace = &replace_copy;
-									}
-								}
-								smart_str_appendl(&route_str, Z_STRVAL_P(replace), Z_STRLEN_P(replace));
-								if (use_copy) {
-									zval_dtor(&replace_copy);
-								}
-							}
+							phalcon_reversed_pattern_add_key(return_value, &literal, phalcon_replace_marker_key(0, paths, &position, cursor, marker));
 							cursor++;
 							continue;
 						}
@@ -218,20 +203,7 @@ void phalcon_replace_paths(zval *return_value, zval *pattern, zval *paths, zval
 			if (looking_placeholder) {
 				if (intermediate > 0) {
 					if (ch < 'a' || ch > 'z' || i == (Z_STRLEN_P(pattern) - 1)) {
-						replace = phalcon_replace_marker(0, paths, replacements, &position, cursor, marker);
-						if (replace) {
-							use_copy = 0;
-							if (Z_TYPE_P(replace) != IS_STRING) {
-								use_copy = zend_make_printable_zval(replace, &replace_copy);
-								if (use_copy) {
-									replace = &replace_copy;
-								}
-							}
-							smart_str_appendl(&route_str, Z_STRVAL_P(replace), Z_STRLEN_P(replace));
-							if (use_copy) {
-								zval_dtor(&replace_copy);
-							}
-						}
+						phalcon_reversed_pattern_add_key(return_value, &literal, phalcon_replace_marker_key(0, paths, &position, cursor, marker));
 						looking_placeholder = 0;
 						continue;
 					}
@@ -248,11 +220,73 @@ void phalcon_replace_paths(zval *return_value, zval *pattern, zval *paths, zval
 		if (bracket_count > 0 || parentheses_count > 0 || looking_placeholder) {
 			intermediate++;
 		} else {
-			smart_str_appendc(&route_str, ch);
+			smart_str_appendc(&literal, ch);
 		}
 
 		cursor++;
 	}
+	smart_str_0(&literal);
+
+	if (literal.s) {
+		add_next_index_str(return_value, literal.s);
+	} else {
+		add_next_index_stringl(return_value, "", 0);
+	}
+}
+
+/**
+ * Builds an URI from a template created by phalcon_compile_reversed_pattern(),
+ * the optional prefix is written first into the same buffer
+ */
+void phalcon_render_reversed_pattern(zval *return_value, zval *template, zval *replacements, zval *prefix){
+
+	zval *token, *replace, replace_copy = {};
+	smart_str route_str = {0};
+	size_t length = 0;
+	int use_copy, is_name = 0;
+
+	if (Z_TYPE_P(template) != IS_ARRAY) {
+		ZVAL_FALSE(return_value);
+		return;
+	}
+
+	if (prefix && Z_TYPE_P(prefix) == IS_STRING) {
+		length = Z_STRLEN_P(prefix);
+	}
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(template), token) {
+		length += is_name ? 16 : Z_STRLEN_P(token);
+		is_name = !is_name;
+	} ZEND_HASH_FOREACH_END();
+
+	if (length) {
+		smart_str_alloc(&route_str, length, 0);
+	}
+
+	if (prefix && Z_TYPE_P(prefix) == IS_STRING) {
+		smart_str_appendl(&route_str, Z_STRVAL_P(prefix), Z_STRLEN_P(prefix));
+	}
+
+	is_name = 0;
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(template), token) {
+		if (!is_name) {
+			smart_str_appendl(&route_str, Z_STRVAL_P(token), Z_STRLEN_P(token));
+		} else if (Z_TYPE_P(replacements) == IS_ARRAY && (replace = zend_hash_find(Z_ARRVAL_P(replacements), Z_STR_P(token))) != NULL) {
+			use_copy = 0;
+			if (Z_TYPE_P(replace) != IS_STRING) {
+				use_copy = zend_make_printable_zval(replace, &replace_copy);
+				if (use_copy) {
+					replace = &replace_copy;
+				}
+			}
+			smart_str_appendl(&route_str, Z_STRVAL_P(replace), Z_STRLEN_P(replace));
+			if (use_copy) {
+				zval_dtor(&replace_copy);
+			}
+		}
+		is_name = !is_name;
+	} ZEND_HASH_FOREACH_END();
+
 	smart_str_0(&route_str);
 
 	if (route_str.s) {
@@ -261,7 +295,24 @@ void phalcon_replace_paths(zval *return_value, zval *pattern, zval *paths, zval
 		smart_str_free(&route_str);
 		RETURN_EMPTY_STRING();
 	}
+}
+
+/**
+ * Replaces placeholders and named variables with their corresponding values in an array
+ */
+void phalcon_replace_paths(zval *return_value, zval *pattern, zval *paths, zval *replacements){
+
+	zval template = {};
+
+	if (Z_TYPE_P(pattern) != IS_STRING || Z_TYPE_P(replacements) != IS_ARRAY || Z_TYPE_P(paths) != IS_ARRAY) {
+		ZVAL_NULL(return_value);
+		php_error_docref(NULL, E_WARNING, "Invalid arguments supplied for phalcon_replace_paths()");
+		return;
+	}
 
+	phalcon_compile_reversed_pattern(&template, pattern, paths);
+	phalcon_render_reversed_pattern(return_value, &template, replacements, NULL);
+	zval_ptr_dtor(&template);
 }
 
 /**
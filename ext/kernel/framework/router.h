@@ -26,4 +26,8 @@
 void phalcon_extract_named_params(zval *return_value, zval *str, zval *matches);
 void phalcon_replace_paths(zval *return_value, zval *pattern, zval *paths, zval *uri);
 
+/* Reversed patterns split once and rendered many times */
+void phalcon_compile_reversed_pattern(zval *return_value, zval *pattern, zval *paths);
+void phalcon_render_reversed_pattern(zval *return_value, zval *template, zval *replacements, zval *prefix);
+
 #endif /* PHALCON_KERNEL_FRAMEWORK_ROUTER_H */
@@ -50,6 +50,8 @@ void php_phalcon_init_globals(zend_phalcon_globals *phalcon_globals) {
 	phalcon_globals->orm.enable_literals = 1;
 	phalcon_globals->orm.cache_level = 3;
 	phalcon_globals->orm.ast_cache = NULL;
+	phalcon_globals->orm.statement_cache = NULL;
+	phalcon_globals->orm.statement_cache_version = -1;
 	phalcon_globals->orm.enable_property_method = 1;
 	phalcon_globals->orm.enable_auto_convert = 1;
 	phalcon_globals->orm.allow_update_primary = 0;
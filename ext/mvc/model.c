@@ -24,6 +24,7 @@
 #include "mvc/model/managerinterface.h"
 #include "mvc/model/manager.h"
 #include "mvc/model/metadatainterface.h"
+#include "mvc/model/metadata.h"
 #include "mvc/model/metadata/memory.h"
 #include "mvc/model/query/builder.h"
 #include "mvc/model/query.h"
@@ -65,6 +66,7 @@
 #include "kernel/file.h"
 #include "kernel/variables.h"
 #include "kernel/debug.h"
+#include "kernel/framework/orm.h"
 
 #include "interned-strings.h"
 
@@ -150,6 +152,7 @@ PHP_METHOD(Phalcon_Mvc_Model, assign);
 PHP_METHOD(Phalcon_Mvc_Model, cloneResultMap);
 PHP_METHOD(Phalcon_Mvc_Model, cloneResultMapHydrate);
 PHP_METHOD(Phalcon_Mvc_Model, cloneResult);
+PHP_METHOD(Phalcon_Mvc_Model, hydrateAll);
 PHP_METHOD(Phalcon_Mvc_Model, find);
 PHP_METHOD(Phalcon_Mvc_Model, findFirst);
 PHP_METHOD(Phalcon_Mvc_Model, query);
@@ -179,10 +182,12 @@ PHP_METHOD(Phalcon_Mvc_Model, _checkForeignKeysReverseCascade);
 PHP_METHOD(Phalcon_Mvc_Model, _preSave);
 PHP_METHOD(Phalcon_Mvc_Model, _postSave);
 PHP_METHOD(Phalcon_Mvc_Model, _doLowInsert);
+PHP_METHOD(Phalcon_Mvc_Model, _getUpdateFields);
 PHP_METHOD(Phalcon_Mvc_Model, _doLowUpdate);
 PHP_METHOD(Phalcon_Mvc_Model, _preSaveRelatedRecords);
 PHP_METHOD(Phalcon_Mvc_Model, _postSaveRelatedRecords);
 PHP_METHOD(Phalcon_Mvc_Model, save);
+PHP_METHOD(Phalcon_Mvc_Model, _finishSave);
 PHP_METHOD(Phalcon_Mvc_Model, create);
 PHP_METHOD(Phalcon_Mvc_Model, update);
 PHP_METHOD(Phalcon_Mvc_Model, delete);
@@ -255,6 +260,12 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_group, 0, 0, 1)
 	ZEND_ARG_TYPE_INFO(0, params, IS_ARRAY, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_hydrateall, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, rows, IS_ARRAY, 0)
+	ZEND_ARG_INFO(0, columnMap)
+	ZEND_ARG_INFO(0, dirtyState)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_validate, 0, 0, 1)
 	ZEND_ARG_INFO(0, validation)
 ZEND_END_ARG_INFO()
@@ -371,6 +382,12 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_filter, 0, 0, 2)
 	ZEND_ARG_TYPE_INFO(0, recursive, _IS_BOOL, 1)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model__finishsave, 0, 0, 2)
+	ZEND_ARG_INFO(0, exists)
+	ZEND_ARG_INFO(0, connection)
+	ZEND_ARG_INFO(0, success)
+ZEND_END_ARG_INFO()
+
 static const zend_function_entry phalcon_mvc_model_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Model, register, arginfo_phalcon_mvc_model_register, ZEND_ACC_PUBLIC|ZEND_ACC_STATIC)
 	PHP_ME(Phalcon_Mvc_Model, __construct, arginfo_phalcon_mvc_model___construct, ZEND_ACC_PUBLIC|ZEND_ACC_FINAL|ZEND_ACC_CTOR)
@@ -420,6 +437,7 @@ static const zend_function_entry phalcon_mvc_model_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Model, cloneResultMap, arginfo_phalcon_mvc_modelinterface_cloneresultmap, ZEND_ACC_PUBLIC|ZEND_ACC_STATIC)
 	PHP_ME(Phalcon_Mvc_Model, cloneResultMapHydrate, arginfo_phalcon_mvc_modelinterface_cloneresultmaphydrate, ZEND_ACC_PUBLIC|ZEND_ACC_STATIC)
 	PHP_ME(Phalcon_Mvc_Model, cloneResult, arginfo_phalcon_mvc_modelinterface_cloneresult, ZEND_ACC_PUBLIC|ZEND_ACC_STATIC)
+	PHP_ME(Phalcon_Mvc_Model, hydrateAll, arginfo_phalcon_mvc_model_hydrateall, ZEND_ACC_PUBLIC|ZEND_ACC_STATIC)
 	PHP_ME(Phalcon_Mvc_Model, find, arginfo_phalcon_mvc_modelinterface_find, ZEND_ACC_PUBLIC|ZEND_ACC_STATIC)
 	PHP_ME(Phalcon_Mvc_Model, findFirst, arginfo_phalcon_mvc_modelinterface_findfirst, ZEND_ACC_PUBLIC|ZEND_ACC_STATIC)
 	PHP_ME(Phalcon_Mvc_Model, query, arginfo_phalcon_mvc_modelinterface_query, ZEND_ACC_PUBLIC|ZEND_ACC_STATIC)
@@ -449,10 +467,12 @@ static const zend_function_entry phalcon_mvc_model_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Model, _preSave, NULL, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Mvc_Model, _postSave, NULL, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Mvc_Model, _doLowInsert, NULL, ZEND_ACC_PROTECTED)
+	PHP_ME(Phalcon_Mvc_Model, _getUpdateFields, NULL, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Mvc_Model, _doLowUpdate, NULL, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Mvc_Model, _preSaveRelatedRecords, NULL, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Mvc_Model, _postSaveRelatedRecords, NULL, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Mvc_Model, save, arginfo_phalcon_mvc_modelinterface_save, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model, _finishSave, arginfo_phalcon_mvc_model__finishsave, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Mvc_Model, create, arginfo_phalcon_mvc_modelinterface_create, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model, update, arginfo_phalcon_mvc_modelinterface_update, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model, delete, NULL, ZEND_ACC_PUBLIC)
@@ -577,6 +597,630 @@ static int phalcon_mvc_model_get_messages_from_model(zval *this_ptr, zval *model
 	return likely(!EG(exception)) ? SUCCESS : FAILURE;
 }
 
+/**
+ * Rolls back the implicit transaction of a save or a delete, the records kept by the identity map
+ * could hold changes that were rolled back
+ */
+static int phalcon_mvc_model_rollback(zval *model, zval *connection, zval *nesting)
+{
+	zval *params[] = { nesting };
+
+	if (phalcon_call_method(NULL, connection, "rollback", 1, params) == FAILURE) {
+		return FAILURE;
+	}
+
+	return phalcon_mvc_model_manager_identity_rollback(model);
+}
+
+/**
+ * Reads the values of the primary key of a record of a batch, the key joins them to look up the
+ * rows found. Fails if any value is empty
+ */
+static int phalcon_mvc_model_batch_key(zval *key, zval *values, zval *model, zval *primary_keys, zval *column_map)
+{
+	smart_str str = {0};
+	zval *primary_key;
+	int i = 0;
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(primary_keys), primary_key) {
+		zval attribute_field = {}, value = {};
+
+		if (Z_TYPE_P(column_map) != IS_ARRAY || !phalcon_array_isset_fetch(&attribute_field, column_map, primary_key, PH_READONLY)) {
+			ZVAL_COPY_VALUE(&attribute_field, primary_key);
+		}
+
+		if (phalcon_isset_property_zval(model, &attribute_field)) {
+			phalcon_read_property_zval(&value, model, &attribute_field, PH_READONLY);
+		}
+
+		if (Z_TYPE(value) <= IS_NULL || Z_TYPE(value) > IS_STRING) {
+			smart_str_free(&str);
+			return FAILURE;
+		}
+
+		if (i++) {
+			smart_str_appendc(&str, '\0');
+		}
+		phalcon_append_printable_zval(&str, &value);
+		if (values) {
+			phalcon_array_append(values, &value, PH_COPY);
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	smart_str_0(&str);
+	ZVAL_STR(key, str.s ? str.s : ZSTR_EMPTY_ALLOC());
+	return SUCCESS;
+}
+
+/**
+ * Runs one lookup of the primary keys of a batch and registers the keys of the rows found
+ */
+static int phalcon_mvc_model_batch_lookup(zval *existing, zval *connection, zval *escaped_table, zval *escaped_keys, zval *conditions, zval *bind_params)
+{
+	zval sql = {}, columns = {}, where = {}, fetch_mode = {}, rows = {}, *row;
+	int status;
+
+	phalcon_fast_join_str(&columns, SL(", "), escaped_keys);
+	phalcon_fast_join_str(&where, SL(" OR "), conditions);
+	PHALCON_CONCAT_SVSVSV(&sql, "SELECT ", &columns, " FROM ", escaped_table, " WHERE ", &where);
+	zval_ptr_dtor(&columns);
+	zval_ptr_dtor(&where);
+
+	ZVAL_LONG(&fetch_mode, PDO_FETCH_NUM);
+	PHALCON_CALL_METHOD_FLAG(status, &rows, connection, "fetchall", &sql, &fetch_mode, bind_params);
+	zval_ptr_dtor(&sql);
+
+	if (status == SUCCESS && Z_TYPE(rows) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(rows), row) {
+			zval key = {};
+			phalcon_fast_join_str(&key, SL("\0"), row);
+			phalcon_array_update(existing, &key, &PHALCON_GLOBAL(z_true), PH_COPY);
+			zval_ptr_dtor(&key);
+		} ZEND_HASH_FOREACH_END();
+	}
+	zval_ptr_dtor(&rows);
+
+	zval_ptr_dtor(conditions);
+	array_init(conditions);
+	zval_ptr_dtor(bind_params);
+	array_init(bind_params);
+	return status;
+}
+
+/**
+ * Finds which upserted records not known as persistent already have a row, from the values of their
+ * primary key. They are looked up in chunks, the rows found tell updates from inserts
+ */
+static int phalcon_mvc_model_batch_existing(zval *existing, zval *connection, zval *table, zval *models, zval *primary_keys, zval *column_map)
+{
+	zval escaped_table = {}, escaped_keys = {}, conditions = {}, bind_params = {}, condition = {}, *model, *primary_key;
+	uint32_t chunk, count = zend_hash_num_elements(Z_ARRVAL_P(primary_keys));
+	int status = SUCCESS;
+
+	array_init(existing);
+	if (!count) {
+		return SUCCESS;
+	}
+
+	chunk = PHALCON_MVC_MODEL_MANAGER_EAGER_CHUNK / count;
+	if (!chunk) {
+		chunk = 1;
+	}
+
+	if (PHALCON_GLOBAL(db).escape_identifiers) {
+		PHALCON_CALL_METHOD_FLAG(status, &escaped_table, connection, "escapeidentifier", table);
+		if (status == FAILURE) {
+			return FAILURE;
+		}
+	} else {
+		ZVAL_COPY(&escaped_table, table);
+	}
+
+	array_init(&escaped_keys);
+	array_init(&condition);
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(primary_keys), primary_key) {
+		zval escaped_key = {}, part = {};
+
+		if (PHALCON_GLOBAL(db).escape_identifiers) {
+			PHALCON_CALL_METHOD_FLAG(status, &escaped_key, connection, "escapeidentifier", primary_key);
+			if (status == FAILURE) {
+				break;
+			}
+		} else {
+			ZVAL_COPY(&escaped_key, primary_key);
+		}
+
+		PHALCON_CONCAT_VS(&part, &escaped_key, " = ?");
+		phalcon_array_append(&condition, &part, 0);
+		phalcon_array_append(&escaped_keys, &escaped_key, 0);
+	} ZEND_HASH_FOREACH_END();
+
+	if (status == SUCCESS) {
+		zval joined = {}, wrapped = {};
+
+		phalcon_fast_join_str(&joined, SL(" AND "), &condition);
+		PHALCON_CONCAT_SVS(&wrapped, "(", &joined, ")");
+		zval_ptr_dtor(&joined);
+
+		array_init(&conditions);
+		array_init(&bind_params);
+
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(models), model) {
+			zval dirty_state = {}, key = {};
+
+			phalcon_read_property(&dirty_state, model, SL("_dirtyState"), PH_READONLY);
+			if (phalcon_get_intval(&dirty_state) == PHALCON_MODEL_DIRTY_STATE_PERSISTEN) {
+				continue;
+			}
+
+			if (phalcon_mvc_model_batch_key(&key, &bind_params, model, primary_keys, column_map) == FAILURE) {
+				continue;
+			}
+			zval_ptr_dtor(&key);
+
+			phalcon_array_append(&conditions, &wrapped, PH_COPY);
+			if (zend_hash_num_elements(Z_ARRVAL(conditions)) >= chunk) {
+				status = phalcon_mvc_model_batch_lookup(existing, connection, &escaped_table, &escaped_keys, &conditions, &bind_params);
+				if (status == FAILURE) {
+					break;
+				}
+			}
+		} ZEND_HASH_FOREACH_END();
+
+		if (status == SUCCESS && zend_hash_num_elements(Z_ARRVAL(conditions))) {
+			status = phalcon_mvc_model_batch_lookup(existing, connection, &escaped_table, &escaped_keys, &conditions, &bind_params);
+		}
+
+		zval_ptr_dtor(&wrapped);
+		zval_ptr_dtor(&conditions);
+		zval_ptr_dtor(&bind_params);
+	}
+
+	zval_ptr_dtor(&condition);
+	zval_ptr_dtor(&escaped_keys);
+	zval_ptr_dtor(&escaped_table);
+	return status;
+}
+
+/**
+ * Gives back the operation the records of a batch had before it was validated, nothing was written
+ */
+static void phalcon_mvc_model_batch_restore(zval *models, zval *operations)
+{
+	zval *operation, *model;
+	zend_ulong idx;
+
+	ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL_P(operations), idx, operation) {
+		if ((model = zend_hash_index_find(Z_ARRVAL_P(models), idx)) != NULL) {
+			phalcon_update_property(model, SL("_operationMade"), operation);
+		}
+	} ZEND_HASH_FOREACH_END();
+}
+
+/**
+ * Validates and hydrates the records of batchCreate()/batchSave() and writes them with
+ * Phalcon\Db\Adapter::insertMultiple inside one transaction
+ */
+static void phalcon_mvc_model_batch(zval *return_value, zval *data, zval *white_list, int upsert)
+{
+	zval dependency_injector = {}, service_name = {}, manager = {}, model_name = {}, models = {}, exists_list = {}, groups = {};
+	zval connection = {}, transaction = {}, assign_map = {}, attributes = {}, automatic_attributes = {}, column_map = {}, bind_data_types = {};
+	zval data_types = {}, identity_field = {}, primary_keys = {}, source = {}, schema = {}, table = {}, event_name = {};
+	zval first_transaction = {}, existing = {}, operations = {};
+	zval *item, *model, *group;
+	zend_ulong idx;
+	int flag = SUCCESS;
+
+	PHALCON_MM_INIT();
+
+	if (Z_TYPE_P(data) != IS_ARRAY) {
+		PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "The records must be passed as an array");
+		return;
+	}
+
+	PHALCON_MM_CALL_CE_STATIC(&dependency_injector, phalcon_di_ce, "getdefault");
+	PHALCON_MM_ADD_ENTRY(&dependency_injector);
+
+	if (Z_TYPE(dependency_injector) != IS_OBJECT) {
+		PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "A dependency injector container is required to obtain the services related to the ORM");
+		return;
+	}
+
+	phalcon_get_called_class(&model_name);
+	PHALCON_MM_ADD_ENTRY(&model_name);
+
+	ZVAL_STR(&service_name, IS(modelsManager));
+
+	PHALCON_MM_CALL_METHOD(&manager, &dependency_injector, "getshared", &service_name);
+	PHALCON_MM_ADD_ENTRY(&manager);
+
+	array_init(&models);
+	PHALCON_MM_ADD_ENTRY(&models);
+
+	/**
+	 * Hydrate the arrays into new instances, models must be instances of the called class
+	 */
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(data), item) {
+		zval record = {};
+		if (Z_TYPE_P(item) == IS_OBJECT) {
+			if (!zend_string_equals_ci(Z_OBJCE_P(item)->name, Z_STR(model_name))) {
+				zval exception_message = {};
+				PHALCON_CONCAT_SVS(&exception_message, "Only instances of '", &model_name, "' can be saved in the batch");
+				PHALCON_MM_ADD_ENTRY(&exception_message);
+				PHALCON_MM_THROW_EXCEPTION_ZVAL(phalcon_mvc_model_exception_ce, &exception_message);
+				return;
+			}
+			phalcon_array_append(&models, item, PH_COPY);
+		} else if (Z_TYPE_P(item) == IS_ARRAY) {
+			PHALCON_MM_CALL_METHOD(&record, &manager, "load", &model_name, &PHALCON_GLOBAL(z_true));
+			phalcon_array_append(&models, &record, 0);
+
+			if (Z_TYPE(assign_map) == IS_UNDEF) {
+				PHALCON_MM_CALL_METHOD(&assign_map, &record, "getcolumnmap");
+				if (Z_TYPE(assign_map) != IS_ARRAY) {
+					PHALCON_MM_CALL_METHOD(&assign_map, &record, "getattributes");
+				}
+				PHALCON_MM_ADD_ENTRY(&assign_map);
+			}
+
+			PHALCON_MM_CALL_METHOD(NULL, &record, "assign", item, &assign_map, white_list);
+		} else {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Every record must be an array or a model instance");
+			return;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	if (!phalcon_fast_count_ev(&models)) {
+		RETURN_MM_EMPTY_ARRAY();
+	}
+
+	/**
+	 * All the records are written through one connection, they can't belong to different transactions
+	 */
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(models), model) {
+		phalcon_read_property(&transaction, model, SL("_transaction"), PH_READONLY);
+		if (Z_TYPE(first_transaction) == IS_UNDEF) {
+			ZVAL_COPY_VALUE(&first_transaction, &transaction);
+		} else if (Z_TYPE(transaction) != Z_TYPE(first_transaction)
+			|| (Z_TYPE(transaction) == IS_OBJECT && Z_OBJ(transaction) != Z_OBJ(first_transaction))) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "All the records of the batch must belong to the same transaction");
+			return;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	/**
+	 * All the records share the metadata and the connection of the first one
+	 */
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(models), model) {
+		phalcon_read_property(&transaction, model, SL("_transaction"), PH_READONLY);
+		if (Z_TYPE(transaction) == IS_OBJECT) {
+			if (instanceof_function_ex(Z_OBJCE(transaction), phalcon_db_adapterinterface_ce, 1)) {
+				PHALCON_MM_ZVAL_COPY(&connection, &transaction);
+			} else {
+				PHALCON_MM_CALL_METHOD(&connection, &transaction, "getconnection");
+				PHALCON_MM_ADD_ENTRY(&connection);
+			}
+		} else {
+			PHALCON_MM_CALL_METHOD(&connection, model, "getwriteconnection");
+			PHALCON_MM_ADD_ENTRY(&connection);
+		}
+		PHALCON_MM_VERIFY_INTERFACE(&connection, phalcon_db_adapterinterface_ce);
+
+		PHALCON_MM_CALL_METHOD(&attributes, model, "getattributes");
+		PHALCON_MM_ADD_ENTRY(&attributes);
+		PHALCON_MM_CALL_METHOD(&automatic_attributes, model, "getautomaticcreateattributes");
+		PHALCON_MM_ADD_ENTRY(&automatic_attributes);
+		PHALCON_MM_CALL_METHOD(&column_map, model, "getcolumnmap");
+		PHALCON_MM_ADD_ENTRY(&column_map);
+		PHALCON_MM_CALL_METHOD(&bind_data_types, model, "getbindtypes");
+		PHALCON_MM_ADD_ENTRY(&bind_data_types);
+		PHALCON_MM_CALL_METHOD(&data_types, model, "getdatatypes");
+		PHALCON_MM_ADD_ENTRY(&data_types);
+		PHALCON_MM_CALL_METHOD(&identity_field, model, "getidentityfield");
+		PHALCON_MM_ADD_ENTRY(&identity_field);
+		PHALCON_MM_CALL_METHOD(&primary_keys, model, "getprimarykeyattributes");
+		PHALCON_MM_ADD_ENTRY(&primary_keys);
+		PHALCON_MM_CALL_METHOD(&source, model, "getsource");
+		PHALCON_MM_ADD_ENTRY(&source);
+		PHALCON_MM_CALL_METHOD(&schema, model, "getschema");
+		PHALCON_MM_ADD_ENTRY(&schema);
+		break;
+	} ZEND_HASH_FOREACH_END();
+
+	if (PHALCON_IS_NOT_EMPTY(&schema)) {
+		if (PHALCON_GLOBAL(db).escape_identifiers) {
+			array_init_size(&table, 2);
+			phalcon_array_append(&table, &schema, PH_COPY);
+			phalcon_array_append(&table, &source, PH_COPY);
+		} else {
+			PHALCON_CONCAT_VSV(&table, &schema, ".", &source);
+		}
+		PHALCON_MM_ADD_ENTRY(&table);
+	} else {
+		ZVAL_COPY_VALUE(&table, &source);
+	}
+
+	/**
+	 * Upserted records are updates if their row exists, whatever their dirty state says: arrays carrying
+	 * the primary key of a row are hydrated into transient records
+	 */
+	if (upsert) {
+		if (phalcon_mvc_model_batch_existing(&existing, &connection, &table, &models, &primary_keys, &column_map) == FAILURE) {
+			zval_ptr_dtor(&existing);
+			RETURN_MM();
+		}
+		PHALCON_MM_ADD_ENTRY(&existing);
+	}
+
+	array_init(&exists_list);
+	PHALCON_MM_ADD_ENTRY(&exists_list);
+	array_init(&groups);
+	PHALCON_MM_ADD_ENTRY(&groups);
+	array_init(&operations);
+	PHALCON_MM_ADD_ENTRY(&operations);
+
+	PHALCON_MM_ZVAL_STRING(&event_name, "beforeOperation");
+
+	/**
+	 * Every record is validated before anything is written, records with the same columns are grouped.
+	 * If a record fails the records validated before it get their previous operation back, the events
+	 * and validations already run on them are not undone, as with a save() of each one
+	 */
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(models), idx, model) {
+		zval dirty_state = {}, exists = {}, status = {}, columns = {}, values = {}, types = {}, key = {}, operation = {}, *field;
+
+		if (upsert) {
+			phalcon_read_property(&dirty_state, model, SL("_dirtyState"), PH_READONLY);
+			if (phalcon_get_intval(&dirty_state) == PHALCON_MODEL_DIRTY_STATE_PERSISTEN) {
+				ZVAL_TRUE(&exists);
+			} else if (phalcon_mvc_model_batch_key(&key, NULL, model, &primary_keys, &column_map) == SUCCESS) {
+				ZVAL_BOOL(&exists, phalcon_array_isset(&existing, &key));
+				zval_ptr_dtor(&key);
+				ZVAL_UNDEF(&key);
+			} else {
+				ZVAL_FALSE(&exists);
+			}
+		} else {
+			ZVAL_FALSE(&exists);
+		}
+		phalcon_array_append(&exists_list, &exists, 0);
+
+		phalcon_read_property(&operation, model, SL("_operationMade"), PH_READONLY);
+		phalcon_array_update_long(&operations, idx, &operation, PH_COPY);
+
+		if (zend_is_true(&exists)) {
+			phalcon_update_property_long(model, SL("_operationMade"), PHALCON_MODEL_OP_UPDATE);
+		} else {
+			phalcon_update_property_long(model, SL("_operationMade"), PHALCON_MODEL_OP_CREATE);
+		}
+
+		PHALCON_MM_CALL_METHOD(&status, model, "fireeventcancel", &event_name);
+		if (PHALCON_IS_FALSE(&status)) {
+			phalcon_mvc_model_batch_restore(&models, &operations);
+			RETURN_MM_FALSE;
+		}
+		zval_ptr_dtor(&status);
+
+		phalcon_update_property_empty_array(model, SL("_errorMessages"));
+
+		PHALCON_MM_CALL_METHOD(&status, model, "_presave", &exists, &identity_field);
+		if (PHALCON_IS_FALSE(&status)) {
+			phalcon_mvc_model_batch_restore(&models, &operations);
+
+			/**
+			 * Throw exceptions on failed saves?
+			 */
+			if (unlikely(PHALCON_GLOBAL(orm).exception_on_failed_save)) {
+				zval error_messages = {}, exception = {};
+				phalcon_read_property(&error_messages, model, SL("_errorMessages"), PH_READONLY);
+
+				object_init_ex(&exception, phalcon_mvc_model_validationfailed_ce);
+				PHALCON_MM_ADD_ENTRY(&exception);
+				PHALCON_MM_CALL_METHOD(NULL, &exception, "__construct", model, &error_messages);
+
+				phalcon_throw_exception(&exception);
+				RETURN_MM();
+			}
+			RETURN_MM_FALSE;
+		}
+		zval_ptr_dtor(&status);
+
+		array_init(&columns);
+		array_init(&values);
+		array_init(&types);
+
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(attributes), field) {
+			zval attribute_field = {}, value = {}, convert_value = {}, field_bind_type = {}, field_type = {};
+
+			if (phalcon_array_isset(&automatic_attributes, field)) {
+				continue;
+			}
+
+			if (Z_TYPE(column_map) == IS_ARRAY) {
+				if (!phalcon_array_isset_fetch(&attribute_field, &column_map, field, PH_READONLY)) {
+					zval exception_message = {};
+					zval_ptr_dtor(&columns);
+					zval_ptr_dtor(&values);
+					zval_ptr_dtor(&types);
+					PHALCON_CONCAT_SVS(&exception_message, "Column '", field, "' isn't part of the column map");
+					PHALCON_MM_ADD_ENTRY(&exception_message);
+					PHALCON_MM_THROW_EXCEPTION_ZVAL(phalcon_mvc_model_exception_ce, &exception_message);
+					return;
+				}
+			} else {
+				ZVAL_COPY_VALUE(&attribute_field, field);
+			}
+
+			if (phalcon_isset_property_zval(model, &attribute_field)) {
+				phalcon_read_property_zval(&value, model, &attribute_field, PH_READONLY);
+			}
+
+			/**
+			 * Null values of new records are left to the database defaults, as _doLowInsert() does.
+			 * Upserted persistent records send them to be able to clear a column
+			 */
+			if (Z_TYPE(value) <= IS_NULL && (!zend_is_true(&exists) || PHALCON_IS_EQUAL(field, &identity_field))) {
+				continue;
+			}
+
+			if (!phalcon_array_isset_fetch(&field_bind_type, &bind_data_types, field, PH_READONLY)) {
+				zval exception_message = {};
+				zval_ptr_dtor(&columns);
+				zval_ptr_dtor(&values);
+				zval_ptr_dtor(&types);
+				PHALCON_CONCAT_SVS(&exception_message, "Column '", field, "' has not defined a bind data type");
+				PHALCON_MM_ADD_ENTRY(&exception_message);
+				PHALCON_MM_THROW_EXCEPTION_ZVAL(phalcon_mvc_model_exception_ce, &exception_message);
+				return;
+			}
+
+			if (PHALCON_GLOBAL(orm).enable_auto_convert && Z_TYPE(value) > IS_NULL
+				&& (Z_TYPE(value) != IS_OBJECT || !instanceof_function(Z_OBJCE(value), phalcon_db_rawvalue_ce))
+				&& phalcon_array_isset_fetch(&field_type, &data_types, field, PH_READONLY) && Z_TYPE(field_type) == IS_LONG) {
+				switch(Z_LVAL(field_type)) {
+					case PHALCON_DB_COLUMN_TYPE_JSON:
+						flag = phalcon_json_encode(&convert_value, &value, 0);
+						break;
+					case PHALCON_DB_COLUMN_TYPE_BYTEA:
+						PHALCON_CALL_METHOD_FLAG(flag, &convert_value, &connection, "escapebytea", &value);
+						break;
+					case PHALCON_DB_COLUMN_TYPE_ARRAY:
+					case PHALCON_DB_COLUMN_TYPE_INT_ARRAY:
+						PHALCON_CALL_METHOD_FLAG(flag, &convert_value, &connection, "escapearray", &value, &field_type);
+						break;
+					default:
+						break;
+				}
+				if (flag == FAILURE) {
+					zval_ptr_dtor(&columns);
+					zval_ptr_dtor(&values);
+					zval_ptr_dtor(&types);
+					RETURN_MM();
+				}
+			}
+
+			if (Z_TYPE(convert_value) == IS_UNDEF) {
+				ZVAL_COPY(&convert_value, &value);
+			}
+
+			phalcon_array_append(&columns, field, PH_COPY);
+			phalcon_array_append(&values, &convert_value, 0);
+			phalcon_array_update(&types, field, &field_bind_type, PH_COPY);
+		} ZEND_HASH_FOREACH_END();
+
+		phalcon_fast_join_str(&key, SL(","), &columns);
+		if (!phalcon_array_isset(&groups, &key)) {
+			zval new_group = {};
+			array_init_size(&new_group, 3);
+			phalcon_array_update_str(&new_group, SL("columns"), &columns, PH_COPY);
+			phalcon_array_update_str(&new_group, SL("dataTypes"), &types, PH_COPY);
+			phalcon_array_update(&groups, &key, &new_group, 0);
+		}
+		phalcon_array_update_zval_str_append_multi_3(&groups, &key, SL("rows"), &values, PH_COPY);
+
+		zval_ptr_dtor(&key);
+		zval_ptr_dtor(&columns);
+		zval_ptr_dtor(&values);
+		zval_ptr_dtor(&types);
+	} ZEND_HASH_FOREACH_END();
+
+	/**
+	 * Send every group through insertMultiple, upserts resolve the conflicts on the primary key
+	 */
+	PHALCON_MM_CALL_METHOD(NULL, &connection, "begin");
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(groups), group) {
+		zval columns = {}, rows = {}, types = {}, options = {}, *primary_key;
+		int has_primary_key = 1;
+
+		phalcon_array_fetch_str(&columns, group, SL("columns"), PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_str(&rows, group, SL("rows"), PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_str(&types, group, SL("dataTypes"), PH_NOISY|PH_READONLY);
+
+		array_init(&options);
+		phalcon_array_update_str(&options, SL("dataTypes"), &types, PH_COPY);
+
+		if (upsert) {
+			ZEND_HASH_FOREACH_VAL(Z_ARRVAL(primary_keys), primary_key) {
+				if (!phalcon_fast_in_array(primary_key, &columns)) {
+					has_primary_key = 0;
+					break;
+				}
+			} ZEND_HASH_FOREACH_END();
+
+			if (has_primary_key && phalcon_fast_count_ev(&primary_keys)) {
+				phalcon_array_update_str(&options, SL("conflict"), &primary_keys, PH_COPY);
+				phalcon_array_update_str(&options, SL("update"), &PHALCON_GLOBAL(z_true), PH_COPY);
+				phalcon_array_update_str(&options, SL("ignore"), &PHALCON_GLOBAL(z_true), PH_COPY);
+			}
+		}
+
+		PHALCON_CALL_METHOD_FLAG(flag, NULL, &connection, "insertmultiple", &table, &rows, &columns, &options);
+		zval_ptr_dtor(&options);
+		if (flag == FAILURE) {
+			break;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	if (flag == FAILURE) {
+		/**
+		 * Keep the original exception while the transaction is rolled back
+		 */
+		zend_object *exception = EG(exception);
+		EG(exception) = NULL;
+		phalcon_call_method(NULL, &connection, "rollback", 0, NULL);
+		if (!EG(exception)) {
+			phalcon_mvc_model_manager_identity_rollback(model);
+		}
+		if (EG(exception)) {
+			zend_object_release(EG(exception));
+		}
+		EG(exception) = exception;
+		RETURN_MM();
+	}
+
+	PHALCON_MM_CALL_METHOD(NULL, &connection, "commit");
+
+	PHALCON_MM_ZVAL_STRING(&event_name, "afterOperation");
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(models), idx, model) {
+		zval exists = {}, status = {};
+
+		phalcon_array_fetch_long(&exists, &exists_list, idx, PH_NOISY|PH_READONLY);
+
+		PHALCON_MM_CALL_METHOD(&status, model, "_postsave", &PHALCON_GLOBAL(z_true), &exists);
+		zval_ptr_dtor(&status);
+
+		/**
+		 * The identities generated by the database aren't read back: with interleaved auto-increment
+		 * locks or upserted rows lastInsertId() can't be mapped to the rows. A new record without its
+		 * identity value can't be updated or deleted, so it stays transient
+		 */
+		if (!zend_is_true(&exists) && Z_TYPE(identity_field) == IS_STRING) {
+			zval attribute_field = {}, identity_value = {};
+
+			if (Z_TYPE(column_map) != IS_ARRAY || !phalcon_array_isset_fetch(&attribute_field, &column_map, &identity_field, PH_READONLY)) {
+				ZVAL_COPY_VALUE(&attribute_field, &identity_field);
+			}
+
+			if (phalcon_isset_property_zval(model, &attribute_field)) {
+				phalcon_read_property_zval(&identity_value, model, &attribute_field, PH_READONLY);
+			}
+
+			if (Z_TYPE(identity_value) <= IS_NULL) {
+				PHALCON_MM_CALL_METHOD(NULL, model, "fireevent", &event_name);
+				continue;
+			}
+		}
+
+		PHALCON_MM_CALL_METHOD(NULL, model, "_rebuild");
+		phalcon_update_property_long(model, SL("_dirtyState"), PHALCON_MODEL_DIRTY_STATE_PERSISTEN);
+		PHALCON_MM_CALL_METHOD(NULL, model, "fireevent", &event_name);
+	} ZEND_HASH_FOREACH_END();
+
+	RETURN_MM_CTOR(&models);
+}
+
 /**
  * register model class
  *
@@ -1685,7 +2329,7 @@ PHP_METHOD(Phalcon_Mvc_Model, cloneResultMap){
 
 	zval *base, *data, *column_map, *dirty_state = NULL, *source_model = NULL;
 	zval data_types = {}, connection = {}, *value, exception_message = {};
-	zval snapshot_data = {};
+	zval snapshot_data = {}, manager = {}, identity_key = {};
 	zend_string *str_key;
 
 	phalcon_fetch_params(1, 3, 3, &base, &data, &column_map, &dirty_state, &source_model);
@@ -1700,6 +2344,39 @@ PHP_METHOD(Phalcon_Mvc_Model, cloneResultMap){
 		return;
 	}
 
+	/**
+	 * Records already kept by the identity map are not hydrated again
+	 */
+	if (PHALCON_GLOBAL(orm).enable_identity_map && PHALCON_IS_LONG(dirty_state, PHALCON_MODEL_DIRTY_STATE_PERSISTEN)) {
+		int status = phalcon_mvc_model_manager_identity_fetch(return_value, &manager, &identity_key, base, data);
+		PHALCON_MM_ADD_ENTRY(&manager);
+		PHALCON_MM_ADD_ENTRY(&identity_key);
+		if (status == FAILURE || Z_TYPE_P(return_value) == IS_OBJECT) {
+			RETURN_MM();
+		}
+	}
+
+	/**
+	 * Records of the source model are hydrated following the plan kept by the meta-data
+	 */
+	if (source_model && Z_TYPE_P(source_model) == IS_OBJECT && Z_OBJCE_P(source_model) == Z_OBJCE_P(base)
+		&& instanceof_function(Z_OBJCE_P(base), phalcon_mvc_model_ce)) {
+		zval meta_data = {}, plan = {}, native = {};
+
+		PHALCON_MM_CALL_METHOD(&meta_data, source_model, "getmodelsmetadata");
+		PHALCON_MM_ADD_ENTRY(&meta_data);
+		if (instanceof_function(Z_OBJCE(meta_data), phalcon_mvc_model_metadata_ce)) {
+			PHALCON_MM_CALL_METHOD(&plan, &meta_data, "gethydrationplan", source_model, column_map);
+			PHALCON_MM_ADD_ENTRY(&plan);
+			if (phalcon_array_isset_fetch_str(&native, &plan, SL("native"), PH_READONLY) && zend_is_true(&native)) {
+				if (phalcon_orm_hydrate(return_value, base, data, &plan, dirty_state, source_model) == SUCCESS) {
+					phalcon_mvc_model_manager_identity_store(&manager, &identity_key, return_value);
+				}
+				RETURN_MM();
+			}
+		}
+	}
+
 	if (phalcon_clone(return_value, base) == FAILURE) {
 		RETURN_MM();
 	}
@@ -1782,6 +2459,8 @@ PHP_METHOD(Phalcon_Mvc_Model, cloneResultMap){
 	if (phalcon_method_exists_ex(return_value, SL("afterfetch")) == SUCCESS) {
 		PHALCON_MM_CALL_METHOD(NULL, return_value, "afterfetch");
 	}
+
+	phalcon_mvc_model_manager_identity_store(&manager, &identity_key, return_value);
 	RETURN_MM();
 }
 
@@ -1907,46 +2586,146 @@ PHP_METHOD(Phalcon_Mvc_Model, cloneResult){
 	zval *base, *data, *dirty_state = NULL, *value = NULL, exception_message = {};
 	zend_string *str_key;
 
-	phalcon_fetch_params(0, 2, 1, &base, &data, &dirty_state);
+	phalcon_fetch_params(0, 2, 1, &base, &data, &dirty_state);
+
+	if (!dirty_state) {
+		dirty_state = &PHALCON_GLOBAL(z_zero);
+	}
+
+	if (Z_TYPE_P(base) != IS_OBJECT) {
+		ZVAL_STRING(&exception_message, "The base must be object");
+		PHALCON_THROW_EXCEPTION_ZVAL(phalcon_mvc_model_exception_ce, &exception_message);
+		zval_ptr_dtor(&exception_message);
+		return;
+	}
+
+	/**
+	 * Clone the base record
+	 */
+	if (phalcon_clone(return_value, base) == FAILURE) {
+		return;
+	}
+
+	/**
+	 * Mark the object as persistent
+	 */
+	PHALCON_CALL_METHOD(NULL, return_value, "setdirtystate", dirty_state);
+
+	ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(data), str_key, value) {
+		if (!str_key) {
+			PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Invalid key in array data provided to dumpResult()");
+			return;
+		}
+		phalcon_update_property_string_zval(return_value, str_key, value);
+	} ZEND_HASH_FOREACH_END();
+
+	/**
+	 * Call afterFetch, this allows the developer to execute actions after a record is
+	 * fetched from the database
+	 */
+	if (phalcon_method_exists_ex(return_value, SL("afterfetch")) == SUCCESS) {
+		PHALCON_CALL_METHOD(NULL, return_value, "afterfetch");
+	}
+}
+
+/**
+ * Hydrates records of the model from rows obtained by other means, the hydration plan
+ * is resolved only once for all the rows
+ *
+ *<code>
+ *$robots = Robots::hydrateAll($connection->fetchAll("SELECT * FROM robots"));
+ *foreach ($robots as $robot) {
+ *	echo $robot->name, PHP_EOL;
+ *}
+ *</code>
+ *
+ * @param array $rows
+ * @param array $columnMap
+ * @param int $dirtyState
+ * @return Phalcon\Mvc\Model[]
+ */
+PHP_METHOD(Phalcon_Mvc_Model, hydrateAll){
+
+	zval *rows, *column_map = NULL, *dirty_state = NULL, dependency_injector = {}, model_name = {}, service_name = {};
+	zval manager = {}, model = {}, model_column_map = {}, meta_data = {}, plan = {}, native = {}, *row;
+	int use_plan = 0;
+
+	phalcon_fetch_params(1, 1, 2, &rows, &column_map, &dirty_state);
+
+	if (!dirty_state) {
+		dirty_state = &PHALCON_GLOBAL(z_zero);
+	}
+
+	PHALCON_MM_CALL_CE_STATIC(&dependency_injector, phalcon_di_ce, "getdefault");
+	PHALCON_MM_ADD_ENTRY(&dependency_injector);
+
+	if (Z_TYPE(dependency_injector) != IS_OBJECT) {
+		PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "A dependency injector container is required to obtain the services related to the ORM");
+		return;
+	}
+
+	phalcon_get_called_class(&model_name);
+	PHALCON_MM_ADD_ENTRY(&model_name);
+
+	ZVAL_STR(&service_name, IS(modelsManager));
+
+	PHALCON_MM_CALL_METHOD(&manager, &dependency_injector, "getshared", &service_name);
+	PHALCON_MM_ADD_ENTRY(&manager);
 
-	if (!dirty_state) {
-		dirty_state = &PHALCON_GLOBAL(z_zero);
-	}
+	PHALCON_MM_CALL_METHOD(&model, &manager, "load", &model_name);
+	PHALCON_MM_ADD_ENTRY(&model);
 
-	if (Z_TYPE_P(base) != IS_OBJECT) {
-		ZVAL_STRING(&exception_message, "The base must be object");
-		PHALCON_THROW_EXCEPTION_ZVAL(phalcon_mvc_model_exception_ce, &exception_message);
-		zval_ptr_dtor(&exception_message);
-		return;
+	if (!column_map || Z_TYPE_P(column_map) == IS_NULL) {
+		PHALCON_MM_CALL_METHOD(&model_column_map, &model, "getcolumnmap");
+		PHALCON_MM_ADD_ENTRY(&model_column_map);
+		column_map = &model_column_map;
 	}
 
-	/**
-	 * Clone the base record
-	 */
-	if (phalcon_clone(return_value, base) == FAILURE) {
-		return;
+	PHALCON_MM_CALL_METHOD(&meta_data, &model, "getmodelsmetadata");
+	PHALCON_MM_ADD_ENTRY(&meta_data);
+	if (instanceof_function(Z_OBJCE(meta_data), phalcon_mvc_model_metadata_ce)) {
+		PHALCON_MM_CALL_METHOD(&plan, &meta_data, "gethydrationplan", &model, column_map);
+		PHALCON_MM_ADD_ENTRY(&plan);
+		use_plan = phalcon_array_isset_fetch_str(&native, &plan, SL("native"), PH_READONLY) && zend_is_true(&native);
 	}
 
-	/**
-	 * Mark the object as persistent
-	 */
-	PHALCON_CALL_METHOD(NULL, return_value, "setdirtystate", dirty_state);
+	array_init_size(return_value, zend_hash_num_elements(Z_ARRVAL_P(rows)));
 
-	ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(data), str_key, value) {
-		if (!str_key) {
-			PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Invalid key in array data provided to dumpResult()");
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(rows), row) {
+		zval record = {};
+
+		if (Z_TYPE_P(row) != IS_ARRAY) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Every row to hydrate must be an array");
 			return;
 		}
-		phalcon_update_property_string_zval(return_value, str_key, value);
+
+		if (use_plan) {
+			zval identity_manager = {}, identity_key = {};
+			int status = SUCCESS;
+
+			if (PHALCON_GLOBAL(orm).enable_identity_map && PHALCON_IS_LONG(dirty_state, PHALCON_MODEL_DIRTY_STATE_PERSISTEN)) {
+				status = phalcon_mvc_model_manager_identity_fetch(&record, &identity_manager, &identity_key, &model, row);
+			}
+			if (status == SUCCESS && Z_TYPE(record) != IS_OBJECT) {
+				zval_ptr_dtor(&record);
+				status = phalcon_orm_hydrate(&record, &model, row, &plan, dirty_state, &model);
+				if (status == SUCCESS) {
+					phalcon_mvc_model_manager_identity_store(&identity_manager, &identity_key, &record);
+				}
+			}
+			zval_ptr_dtor(&identity_manager);
+			zval_ptr_dtor(&identity_key);
+			if (status == FAILURE) {
+				zval_ptr_dtor(&record);
+				RETURN_MM();
+			}
+		} else {
+			PHALCON_MM_CALL_CE_STATIC(&record, Z_OBJCE(model), "cloneresultmap", &model, row, column_map, dirty_state, &model);
+		}
+		phalcon_array_append(return_value, &record, 0);
 	} ZEND_HASH_FOREACH_END();
 
-	/**
-	 * Call afterFetch, this allows the developer to execute actions after a record is
-	 * fetched from the database
-	 */
-	if (phalcon_method_exists_ex(return_value, SL("afterfetch")) == SUCCESS) {
-		PHALCON_CALL_METHOD(NULL, return_value, "afterfetch");
-	}
+	RETURN_MM();
 }
 
 /**
@@ -1978,6 +2757,20 @@ PHP_METHOD(Phalcon_Mvc_Model, cloneResult){
  * foreach ($robots as $robot) {
  *	   echo $robot->name, "\n";
  * }
+ *
+ * //Traverse every robot with a forward-only resultset that doesn't keep the rows in memory
+ * $robots = Robots::find(array("order" => "name", "stream" => true));
+ * foreach ($robots as $robot) {
+ *	   echo $robot->name, "\n";
+ * }
+ *
+ * //Load the parts of every robot with one query per relation
+ * $robots = Robots::find(array("type='virtual'", "with" => "robotsParts.parts"));
+ * foreach ($robots as $robot) {
+ *	   foreach ($robot->robotsParts as $robotPart) {
+ *		   echo $robotPart->parts->name, "\n";
+ *	   }
+ * }
  * </code>
  *
  * @param string|array $conditions
@@ -1988,7 +2781,7 @@ PHP_METHOD(Phalcon_Mvc_Model, cloneResult){
 PHP_METHOD(Phalcon_Mvc_Model, find){
 
 	zval *parameters = NULL, *bind_params = NULL, *options = NULL, params = {},dependency_injector = {}, model_name = {}, service_name = {};
-	zval  manager = {}, model = {}, builder = {}, event_name = {}, query = {}, hydration = {};
+	zval  manager = {}, model = {}, builder = {}, event_name = {}, query = {}, hydration = {}, stream = {};
 
 	phalcon_fetch_params(1, 0, 3, &parameters, &bind_params, &options);
 
@@ -2052,6 +2845,13 @@ PHP_METHOD(Phalcon_Mvc_Model, find){
 	PHALCON_MM_CALL_METHOD(&query, &builder, "getquery");
 	PHALCON_MM_ADD_ENTRY(&query);
 
+	/**
+	 * Read the rows one by one as the resultset is traversed
+	 */
+	if (phalcon_array_isset_fetch_str(&stream, &params, SL("stream"), PH_READONLY) && zend_is_true(&stream)) {
+		PHALCON_MM_CALL_METHOD(NULL, &query, "setstream", &PHALCON_GLOBAL(z_true));
+	}
+
 	/**
 	 * Execute the query passing the bind-params and casting-types
 	 */
@@ -2140,6 +2940,28 @@ PHP_METHOD(Phalcon_Mvc_Model, findFirst){
 	PHALCON_MM_CALL_METHOD(&model, &manager, "load", &model_name, &PHALCON_GLOBAL(z_true));
 	PHALCON_MM_ADD_ENTRY(&model);
 
+	/**
+	 * Records looked up by their identity are taken from the identity map when it already keeps them
+	 */
+	if (PHALCON_GLOBAL(orm).enable_identity_map && !bind_params && phalcon_is_numeric(parameters)
+		&& instanceof_function(Z_OBJCE(manager), phalcon_mvc_model_manager_ce)) {
+		zval identity = {}, primary_keys = {}, primary_key = {}, record = {};
+
+		PHALCON_MM_CALL_METHOD(&identity, &model, "getidentityfield");
+		PHALCON_MM_ADD_ENTRY(&identity);
+		PHALCON_MM_CALL_METHOD(&primary_keys, &model, "getprimarykeyattributes");
+		PHALCON_MM_ADD_ENTRY(&primary_keys);
+
+		if (Z_TYPE(primary_keys) == IS_ARRAY && zend_hash_num_elements(Z_ARRVAL(primary_keys)) == 1
+			&& phalcon_array_isset_fetch_long(&primary_key, &primary_keys, 0, PH_READONLY) && PHALCON_IS_EQUAL(&primary_key, &identity)) {
+			PHALCON_MM_CALL_METHOD(&record, &manager, "getidentity", &model_name, parameters);
+			PHALCON_MM_ADD_ENTRY(&record);
+			if (Z_TYPE(record) == IS_OBJECT) {
+				RETURN_MM_CTOR(&record);
+			}
+		}
+	}
+
 	if (bind_params) {
 		if (options && Z_TYPE_P(options) == IS_ARRAY) {
 			ZVAL_DUP(&params, options);
@@ -4460,20 +5282,18 @@ PHP_METHOD(Phalcon_Mvc_Model, _doLowInsert){
 }
 
 /**
- * Sends a pre-build UPDATE SQL statement to the relational database system
+ * Collects the columns an UPDATE of the record has to write, as column => array(attribute, value, bindType).
+ * Columns without value have a null bind type and are set to NULL, with dynamic update only the columns
+ * changed since the snapshot are returned
  *
- * @param Phalcon\Mvc\Model\MetadataInterface $metaData
  * @param Phalcon\Db\AdapterInterface $connection
- * @param string|array $table
- * @return boolean|int
+ * @return array
  */
-PHP_METHOD(Phalcon_Mvc_Model, _doLowUpdate){
+PHP_METHOD(Phalcon_Mvc_Model, _getUpdateFields){
 
-	zval *connection, read_connection = {}, bind_params = {}, bind_types = {}, models_manager = {}, use_dynamic_update = {}, exception_message = {};
+	zval *connection, read_connection = {}, models_manager = {}, use_dynamic_update = {}, exception_message = {};
 	zval snapshot = {}, bind_data_types = {}, automatic_attributes = {}, data_types = {}, column_map = {}, columns = {};
-	zval model_name = {}, phql = {}, phql_updates = {}, phql_join_updates = {}, *field, attribute_field = {}, value = {};
-	zval unique_key = {}, unique_params = {}, unique_types = {}, merged_params = {}, merged_types = {};
-	zval query = {}, status = {}, type = {}, message = {};
+	zval *field, attribute_field = {}, value = {};
 	int i_use_dynamic_update; /* To keep static code analyzer happy */
 
 	phalcon_fetch_params(1, 1, 0, &connection);
@@ -4524,15 +5344,10 @@ PHP_METHOD(Phalcon_Mvc_Model, _doLowUpdate){
 	}
 	PHALCON_MM_ADD_ENTRY(&columns);
 
-	array_init(&phql_updates);
-	PHALCON_MM_ADD_ENTRY(&phql_updates);
-	array_init(&bind_params);
-	PHALCON_MM_ADD_ENTRY(&bind_params);
-	array_init(&bind_types);
-	PHALCON_MM_ADD_ENTRY(&bind_types);
+	array_init(return_value);
 
 	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(columns), field) {
-		zval field_type = {}, convert_value = {}, bind_type = {}, changed = {}, snapshot_value = {}, phql_update = {};
+		zval field_type = {}, convert_value = {}, bind_type = {}, changed = {}, snapshot_value = {}, update = {};
 		if (!phalcon_array_isset(&automatic_attributes, field)) {
 			/**
 			 * Check a bind type for field to update
@@ -4592,13 +5407,7 @@ PHP_METHOD(Phalcon_Mvc_Model, _doLowUpdate){
 				 * When dynamic update is not used we pass every field to the update
 				 */
 				if (!i_use_dynamic_update || (Z_TYPE(value) == IS_OBJECT && instanceof_function(Z_OBJCE(value), phalcon_db_rawvalue_ce))) {
-					PHALCON_CONCAT_VSVS(&phql_update, &attribute_field, "= :", &attribute_field, ":");
-					phalcon_array_append(&phql_updates, &phql_update, 0);
-
-					phalcon_array_update(&bind_params, &attribute_field, &convert_value, PH_COPY);
-
-					phalcon_array_fetch(&bind_type, &bind_data_types, field, PH_NOISY|PH_READONLY);
-					phalcon_array_update(&bind_types, &attribute_field, &bind_type, PH_COPY);
+					ZVAL_TRUE(&changed);
 				} else {
 					/**
 					 * If the field is not part of the snapshot we add them as changed
@@ -4612,27 +5421,82 @@ PHP_METHOD(Phalcon_Mvc_Model, _doLowUpdate){
 							ZVAL_FALSE(&changed);
 						}
 					}
+				}
 
-					/**
-					 * Only changed values are added to the SQL Update
-					 */
-					if (zend_is_true(&changed)) {
-						PHALCON_CONCAT_VSVS(&phql_update, &attribute_field, "= :", &attribute_field, ":");
-						phalcon_array_append(&phql_updates, &phql_update, 0);
-
-						phalcon_array_update(&bind_params, &attribute_field, &convert_value, PH_COPY);
+				/**
+				 * Only changed values are added to the SQL Update
+				 */
+				if (zend_is_true(&changed)) {
+					phalcon_array_fetch(&bind_type, &bind_data_types, field, PH_NOISY|PH_READONLY);
 
-						phalcon_array_fetch(&bind_type, &bind_data_types, field, PH_NOISY|PH_READONLY);
-						phalcon_array_update(&bind_types, &attribute_field, &bind_type, PH_COPY);
-					}
+					array_init_size(&update, 3);
+					phalcon_array_append(&update, &attribute_field, PH_COPY);
+					phalcon_array_append(&update, &convert_value, PH_COPY);
+					phalcon_array_append(&update, &bind_type, PH_COPY);
+					phalcon_array_update(return_value, field, &update, 0);
 				}
 			} else {
-				PHALCON_CONCAT_VS(&phql_update, &attribute_field, "= NULL");
-				phalcon_array_append(&phql_updates, &phql_update, 0);
+				array_init_size(&update, 3);
+				phalcon_array_append(&update, &attribute_field, PH_COPY);
+				add_next_index_null(&update);
+				add_next_index_null(&update);
+				phalcon_array_update(return_value, field, &update, 0);
 			}
 		}
 	} ZEND_HASH_FOREACH_END();
 
+	RETURN_MM();
+}
+
+/**
+ * Sends a pre-build UPDATE SQL statement to the relational database system
+ *
+ * @param Phalcon\Mvc\Model\MetadataInterface $metaData
+ * @param Phalcon\Db\AdapterInterface $connection
+ * @param string|array $table
+ * @return boolean|int
+ */
+PHP_METHOD(Phalcon_Mvc_Model, _doLowUpdate){
+
+	zval *connection, bind_params = {}, bind_types = {}, models_manager = {}, fields = {}, *field;
+	zval model_name = {}, phql = {}, phql_updates = {}, phql_join_updates = {};
+	zval unique_key = {}, unique_params = {}, unique_types = {}, merged_params = {}, merged_types = {};
+	zval query = {}, status = {}, type = {}, message = {};
+
+	phalcon_fetch_params(1, 1, 0, &connection);
+
+	PHALCON_MM_CALL_METHOD(&models_manager, getThis(), "getmodelsmanager");
+	PHALCON_MM_ADD_ENTRY(&models_manager);
+
+	PHALCON_MM_CALL_METHOD(&fields, getThis(), "_getupdatefields", connection);
+	PHALCON_MM_ADD_ENTRY(&fields);
+
+	array_init(&phql_updates);
+	PHALCON_MM_ADD_ENTRY(&phql_updates);
+	array_init(&bind_params);
+	PHALCON_MM_ADD_ENTRY(&bind_params);
+	array_init(&bind_types);
+	PHALCON_MM_ADD_ENTRY(&bind_types);
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(fields), field) {
+		zval attribute_field = {}, value = {}, bind_type = {}, phql_update = {};
+
+		phalcon_array_fetch_long(&attribute_field, field, 0, PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_long(&value, field, 1, PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_long(&bind_type, field, 2, PH_NOISY|PH_READONLY);
+
+		if (Z_TYPE(bind_type) == IS_NULL) {
+			PHALCON_CONCAT_VS(&phql_update, &attribute_field, "= NULL");
+			phalcon_array_append(&phql_updates, &phql_update, 0);
+		} else {
+			PHALCON_CONCAT_VSVS(&phql_update, &attribute_field, "= :", &attribute_field, ":");
+			phalcon_array_append(&phql_updates, &phql_update, 0);
+
+			phalcon_array_update(&bind_params, &attribute_field, &value, PH_COPY);
+			phalcon_array_update(&bind_types, &attribute_field, &bind_type, PH_COPY);
+		}
+	} ZEND_HASH_FOREACH_END();
+
 	/**
 	 * If there is no fields to update we return true
 	 */
@@ -4738,7 +5602,9 @@ PHP_METHOD(Phalcon_Mvc_Model, _preSaveRelatedRecords){
 				 */
 				if (PHALCON_IS_LONG(&type, 0)) {
 					if (Z_TYPE_P(record) != IS_OBJECT) {
-						PHALCON_CALL_METHOD(NULL, connection, "rollback", nesting);
+						if (phalcon_mvc_model_rollback(getThis(), connection, nesting) == FAILURE) {
+							return;
+						}
 						PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Only objects can be stored as part of belongs-to relations");
 						zval_ptr_dtor(&relation);
 						return;
@@ -4746,7 +5612,9 @@ PHP_METHOD(Phalcon_Mvc_Model, _preSaveRelatedRecords){
 
 					PHALCON_CALL_METHOD(&columns, &relation, "getfields");
 					if (Z_TYPE(columns) == IS_ARRAY) {
-						PHALCON_CALL_METHOD(NULL, connection, "rollback", nesting);
+						if (phalcon_mvc_model_rollback(getThis(), connection, nesting) == FAILURE) {
+							return;
+						}
 						PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Not implemented");
 						zval_ptr_dtor(&columns);
 						zval_ptr_dtor(&relation);
@@ -4768,7 +5636,9 @@ PHP_METHOD(Phalcon_Mvc_Model, _preSaveRelatedRecords){
 						/**
 						 * Rollback the implicit transaction
 						 */
-						PHALCON_CALL_METHOD(NULL, connection, "rollback", nesting);
+						if (phalcon_mvc_model_rollback(getThis(), connection, nesting) == FAILURE) {
+							return;
+						}
 						RETURN_FALSE;
 					}
 
@@ -4827,7 +5697,9 @@ PHP_METHOD(Phalcon_Mvc_Model, _postSaveRelatedRecords){
 		 */
 		PHALCON_CALL_METHOD(&relation, &manager, "getrelationbyalias", &class_name, &tmp);
 		if (Z_TYPE(relation) != IS_OBJECT && Z_TYPE_P(record) != IS_ARRAY) {
-			PHALCON_CALL_METHOD(NULL, connection, "rollback", nesting);
+			if (phalcon_mvc_model_rollback(getThis(), connection, nesting) == FAILURE) {
+				return;
+			}
 
 			PHALCON_CONCAT_SVSVS(&exception_message, "There are no defined relations for the model \"", &class_name, "\" using alias \"", &tmp, "\"");
 			PHALCON_THROW_EXCEPTION_ZVAL(phalcon_mvc_model_exception_ce, &exception_message);
@@ -4847,7 +5719,9 @@ PHP_METHOD(Phalcon_Mvc_Model, _postSaveRelatedRecords){
 		}
 
 		if (Z_TYPE_P(record) != IS_OBJECT && Z_TYPE_P(record) != IS_ARRAY) {
-			PHALCON_CALL_METHOD(NULL, connection, "rollback", nesting);
+			if (phalcon_mvc_model_rollback(getThis(), connection, nesting) == FAILURE) {
+				return;
+			}
 			PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Only objects/arrays can be stored as part of has-many/has-one/has-many-to-many relations");
 			zval_ptr_dtor(&relation);
 			zval_ptr_dtor(&manager);
@@ -4857,7 +5731,9 @@ PHP_METHOD(Phalcon_Mvc_Model, _postSaveRelatedRecords){
 		PHALCON_CALL_METHOD(&columns, &relation, "getfields");
 
 		if (Z_TYPE(columns) == IS_ARRAY) {
-			PHALCON_CALL_METHOD(NULL, connection, "rollback", nesting);
+			if (phalcon_mvc_model_rollback(getThis(), connection, nesting) == FAILURE) {
+				return;
+			}
 			PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Not implemented");
 			zval_ptr_dtor(&relation);
 			zval_ptr_dtor(&manager);
@@ -4877,7 +5753,9 @@ PHP_METHOD(Phalcon_Mvc_Model, _postSaveRelatedRecords){
 		}
 
 		if (!phalcon_isset_property_zval(getThis(), &columns)) {
-			PHALCON_CALL_METHOD(NULL, connection, "rollback", nesting);
+			if (phalcon_mvc_model_rollback(getThis(), connection, nesting) == FAILURE) {
+				return;
+			}
 
 			PHALCON_CONCAT_SVS(&exception_message, "The column '", &columns, "' needs to be present in the model");
 			PHALCON_THROW_EXCEPTION_ZVAL(phalcon_mvc_model_exception_ce, &exception_message);
@@ -4934,7 +5812,9 @@ PHP_METHOD(Phalcon_Mvc_Model, _postSaveRelatedRecords){
 				/**
 				 * Rollback the implicit transaction
 				 */
-				PHALCON_CALL_METHOD(NULL, connection, "rollback", nesting);
+				if (phalcon_mvc_model_rollback(getThis(), connection, nesting) == FAILURE) {
+					return;
+				}
 				RETURN_FALSE;
 			}
 
@@ -4977,7 +5857,9 @@ PHP_METHOD(Phalcon_Mvc_Model, _postSaveRelatedRecords){
 					/**
 					 * Rollback the implicit transaction
 					 */
-					PHALCON_CALL_METHOD(NULL, connection, "rollback", nesting);
+					if (phalcon_mvc_model_rollback(getThis(), connection, nesting) == FAILURE) {
+						return;
+					}
 					zval_ptr_dtor(&intermediate_model);
 					RETURN_FALSE;
 				}
@@ -5028,9 +5910,6 @@ PHP_METHOD(Phalcon_Mvc_Model, save){
 
 	zval *data = NULL, *white_list = NULL, *_exists = NULL, *exists_check = NULL, exists = {}, attributes = {}, bind_params = {}, *attribute;
 	zval type = {}, message = {}, event_name = {}, status = {}, transaction = {}, write_connection = {}, related = {}, identity_field = {};
-	zval success = {}, new_success = {};
-	zend_string *str_key;
-	ulong idx;
 
 	phalcon_fetch_params(1, 0, 4, &data, &white_list, &_exists, &exists_check);
 
@@ -5169,7 +6048,9 @@ PHP_METHOD(Phalcon_Mvc_Model, save){
 		 * Rollback the current transaction if there was validation errors
 		 */
 		if (Z_TYPE(related) == IS_ARRAY && phalcon_fast_count_ev(&related)) {
-			PHALCON_MM_CALL_METHOD(NULL, &write_connection, "rollback", &PHALCON_GLOBAL(z_false));
+			if (phalcon_mvc_model_rollback(getThis(), &write_connection, &PHALCON_GLOBAL(z_false)) == FAILURE) {
+				RETURN_MM();
+			}
 		}
 
 		/**
@@ -5193,27 +6074,80 @@ PHP_METHOD(Phalcon_Mvc_Model, save){
 		RETURN_MM_FALSE;
 	}
 
+	/**
+	 * Inside a unit of work the write is deferred to Phalcon\Mvc\Model\Manager::flush(), records
+	 * with related records to save are written right away
+	 */
+	if (Z_TYPE(related) != IS_ARRAY || !phalcon_fast_count_ev(&related)) {
+		zval models_manager = {}, fields = {};
+
+		PHALCON_MM_CALL_METHOD(&models_manager, getThis(), "getmodelsmanager");
+		PHALCON_MM_ADD_ENTRY(&models_manager);
+
+		if (phalcon_mvc_model_manager_uow_active(&models_manager)) {
+			if (zend_is_true(&exists)) {
+				PHALCON_MM_CALL_METHOD(&fields, getThis(), "_getupdatefields", &write_connection);
+				PHALCON_MM_ADD_ENTRY(&fields);
+			}
+
+			phalcon_mvc_model_manager_uow_add(&models_manager, getThis(), &exists, &write_connection, &fields);
+			RETURN_MM_TRUE;
+		}
+	}
+
+	PHALCON_MM_CALL_METHOD(return_value, getThis(), "_finishsave", &exists, &write_connection);
+	RETURN_MM();
+}
+
+/**
+ * Writes a record validated by save() and completes the save: runs the after* events, saves the
+ * related records and refreshes the snapshot. Phalcon\Mvc\Model\Manager::flush() passes the result
+ * of the statement it already wrote and committed
+ *
+ * @param boolean $exists
+ * @param Phalcon\Db\AdapterInterface $connection
+ * @param boolean $success
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Mvc_Model, _finishSave){
+
+	zval *exists, *write_connection, *_success = NULL, success = {}, new_success = {}, related = {}, identity_field = {};
+	zval event_name = {}, status = {};
+	zend_string *str_key;
+	ulong idx;
+
+	phalcon_fetch_params(1, 2, 1, &exists, &write_connection, &_success);
+
+	phalcon_read_property(&related, getThis(), SL("_related"), PH_READONLY);
+
 	/**
 	 * Depending if the record exists we do an update or an insert operation
 	 */
-	if (zend_is_true(&exists)) {
-		PHALCON_MM_CALL_METHOD(&success, getThis(), "_dolowupdate", &write_connection);
+	if (_success && Z_TYPE_P(_success) != IS_NULL) {
+		PHALCON_MM_ZVAL_COPY(&success, _success);
+	} else if (zend_is_true(exists)) {
+		PHALCON_MM_CALL_METHOD(&success, getThis(), "_dolowupdate", write_connection);
+		PHALCON_MM_ADD_ENTRY(&success);
 	} else {
-		PHALCON_MM_CALL_METHOD(&success, getThis(), "_dolowinsert", &write_connection, &identity_field);
+		PHALCON_MM_CALL_METHOD(&identity_field, getThis(), "getidentityfield");
+		PHALCON_MM_ADD_ENTRY(&identity_field);
+		PHALCON_MM_CALL_METHOD(&success, getThis(), "_dolowinsert", write_connection, &identity_field);
+		PHALCON_MM_ADD_ENTRY(&success);
 	}
-	PHALCON_MM_ADD_ENTRY(&success);
 
 	/**
 	 * _postSave() makes all the validations
 	 */
-	PHALCON_MM_CALL_METHOD(&new_success, getThis(), "_postsave", &success, &exists);
+	PHALCON_MM_CALL_METHOD(&new_success, getThis(), "_postsave", &success, exists);
 
 	if (Z_TYPE(related) == IS_ARRAY && phalcon_fast_count_ev(&related)) {
 		/**
 		 * Rollbacks the implicit transaction if the master save has failed
 		 */
 		if (PHALCON_IS_FALSE(&new_success)) {
-			PHALCON_MM_CALL_METHOD(NULL, &write_connection, "rollback", &PHALCON_GLOBAL(z_false));
+			if (phalcon_mvc_model_rollback(getThis(), write_connection, &PHALCON_GLOBAL(z_false)) == FAILURE) {
+				RETURN_MM();
+			}
 
 			/**
 			 * Throw exceptions on failed saves?
@@ -5239,7 +6173,7 @@ PHP_METHOD(Phalcon_Mvc_Model, save){
 		 * Save the post-related records
 		 */
 		if (Z_TYPE(related) == IS_ARRAY && phalcon_fast_count_ev(&related)) {
-			PHALCON_MM_CALL_METHOD(&status, getThis(), "_postsaverelatedrecords", &write_connection, &related);
+			PHALCON_MM_CALL_METHOD(&status, getThis(), "_postsaverelatedrecords", write_connection, &related);
 			if (PHALCON_IS_FALSE(&status)) {
 				RETURN_MM_FALSE;
 			}
@@ -5262,7 +6196,7 @@ PHP_METHOD(Phalcon_Mvc_Model, save){
 	 * Change the dirty state to persistent
 	 */
 	if (zend_is_true(&new_success)) {
-		if (!zend_is_true(&exists)) {
+		if (!zend_is_true(exists)) {
 			zval default_values = {};
 			PHALCON_MM_CALL_METHOD(&default_values, getThis(), "getdefaultvalues");
 			PHALCON_MM_ADD_ENTRY(&default_values);
@@ -5309,6 +6243,14 @@ PHP_METHOD(Phalcon_Mvc_Model, save){
 		}
 
 		phalcon_update_property_long(getThis(), SL("_dirtyState"), PHALCON_MODEL_DIRTY_STATE_PERSISTEN);
+
+		/**
+		 * The saved record replaces the one kept by the identity map
+		 */
+		if (PHALCON_GLOBAL(orm).enable_identity_map && phalcon_mvc_model_manager_identity_update(getThis(), 0) == FAILURE) {
+			RETURN_MM();
+		}
+
 		PHALCON_MM_ZVAL_STRING(&event_name, "afterOperation");
 		PHALCON_MM_CALL_METHOD(NULL, getThis(), "fireevent", &event_name);
 	} else {
@@ -5339,6 +6281,63 @@ PHP_METHOD(Phalcon_Mvc_Model, save){
 	RETURN_MM_NCTOR(&new_success);
 }
 
+/**
+ * Calls a protected method of a record on behalf of Phalcon\Mvc\Model\Manager
+ */
+static int phalcon_mvc_model_call_internal(zval *retval, zval *record, const char *method, uint nparams, zval **params)
+{
+	zend_class_entry *old_scope;
+	int status;
+
+#if PHP_VERSION_ID >= 70100
+	old_scope = EG(fake_scope);
+	EG(fake_scope) = phalcon_mvc_model_ce;
+#else
+	old_scope = EG(scope);
+	EG(scope) = phalcon_mvc_model_ce;
+#endif
+	status = phalcon_call_method(retval, record, method, nparams, params);
+#if PHP_VERSION_ID >= 70100
+	EG(fake_scope) = old_scope;
+#else
+	EG(scope) = old_scope;
+#endif
+
+	return status;
+}
+
+/**
+ * Runs the statement writing a record deferred by a unit of work, nothing else of the save is done
+ */
+int phalcon_mvc_model_uow_write(zval *return_value, zval *record, zval *exists, zval *connection)
+{
+	zval identity_field = {};
+	int status;
+
+	if (zend_is_true(exists)) {
+		return phalcon_mvc_model_call_internal(return_value, record, "_dolowupdate", 1, &connection);
+	}
+
+	PHALCON_CALL_METHOD_FLAG(status, &identity_field, record, "getidentityfield");
+	if (status == SUCCESS) {
+		zval *params[] = { connection, &identity_field };
+		status = phalcon_mvc_model_call_internal(return_value, record, "_dolowinsert", 2, params);
+	}
+	zval_ptr_dtor(&identity_field);
+
+	return status;
+}
+
+/**
+ * Completes the save of a record whose statement was written and committed by a unit of work
+ */
+int phalcon_mvc_model_uow_finish(zval *return_value, zval *record, zval *exists, zval *connection, zval *success)
+{
+	zval *params[] = { exists, connection, success };
+
+	return phalcon_mvc_model_call_internal(return_value, record, "_finishsave", 3, params);
+}
+
 /**
  * Inserts a model instance. If the instance already exists in the persistance it will throw an exception
  * Returning true on success or false otherwise.
@@ -5429,6 +6428,64 @@ PHP_METHOD(Phalcon_Mvc_Model, update){
 	PHALCON_CALL_SELF(return_value, "save", data, white_list, &PHALCON_GLOBAL(z_true), exists_check);
 }
 
+/**
+ * Validates and inserts several records in one transaction. The records are hydrated from arrays
+ * (or passed as instances of the model) and written with multi-row INSERT statements.
+ * Identity values generated by the database are not read back into the records, the records
+ * inserted without an identity value are left transient
+ *
+ *<code>
+ *	$robots = Robots::batchCreate(array(
+ *		array('type' => 'mechanical', 'name' => 'Astro Boy', 'year' => 1952),
+ *		array('type' => 'virtual', 'name' => 'Terminator', 'year' => 1984)
+ *	));
+ *</code>
+ *
+ * @param array $data
+ * @param array $whiteList
+ * @return Phalcon\Mvc\Model[]|boolean
+ */
+PHP_METHOD(Phalcon_Mvc_Model, batchCreate){
+
+	zval *data, *white_list = NULL;
+
+	phalcon_fetch_params(0, 1, 1, &data, &white_list);
+
+	if (!white_list) {
+		white_list = &PHALCON_GLOBAL(z_null);
+	}
+
+	phalcon_mvc_model_batch(return_value, data, white_list, 0);
+}
+
+/**
+ * Validates and inserts or updates several records in one transaction, like batchCreate() but
+ * the rows conflicting on the primary key are updated (upsert)
+ *
+ *<code>
+ *	$robots = Robots::batchSave(array(
+ *		array('id' => 1, 'type' => 'mechanical', 'name' => 'Astro Boy', 'year' => 1952),
+ *		$robot
+ *	));
+ *</code>
+ *
+ * @param array $data
+ * @param array $whiteList
+ * @return Phalcon\Mvc\Model[]|boolean
+ */
+PHP_METHOD(Phalcon_Mvc_Model, batchSave){
+
+	zval *data, *white_list = NULL;
+
+	phalcon_fetch_params(0, 1, 1, &data, &white_list);
+
+	if (!white_list) {
+		white_list = &PHALCON_GLOBAL(z_null);
+	}
+
+	phalcon_mvc_model_batch(return_value, data, white_list, 1);
+}
+
 /**
  * Deletes a model instance. Returning true on success or false otherwise.
  *
@@ -5545,14 +6602,18 @@ PHP_METHOD(Phalcon_Mvc_Model, delete){
 			PHALCON_MM_CALL_METHOD(&check_foreign_keys, getThis(), "_checkforeignkeysreversecascade");
 			PHALCON_MM_ADD_ENTRY(&check_foreign_keys);
 			if (PHALCON_IS_FALSE(&check_foreign_keys)) {
-				PHALCON_MM_CALL_METHOD(NULL, &write_connection, "rollback", &PHALCON_GLOBAL(z_false));
+				if (phalcon_mvc_model_rollback(getThis(), &write_connection, &PHALCON_GLOBAL(z_false)) == FAILURE) {
+					RETURN_MM();
+				}
 				RETURN_MM_FALSE;
 			}
 		}
 	}
 
 	if (!zend_is_true(&success)) {
-		PHALCON_MM_CALL_METHOD(NULL, &write_connection, "rollback", &PHALCON_GLOBAL(z_false));
+		if (phalcon_mvc_model_rollback(getThis(), &write_connection, &PHALCON_GLOBAL(z_false)) == FAILURE) {
+			RETURN_MM();
+		}
 	} else {
 		PHALCON_MM_CALL_METHOD(NULL, &write_connection, "commit", &PHALCON_GLOBAL(z_false));
 	}
@@ -5563,6 +6624,13 @@ PHP_METHOD(Phalcon_Mvc_Model, delete){
 	phalcon_update_property_long(getThis(), SL("_dirtyState"), PHALCON_MODEL_DIRTY_STATE_DETACHED);
 
 	if (zend_is_true(&success)) {
+		/**
+		 * Deleted records are no longer kept by the identity map
+		 */
+		if (PHALCON_GLOBAL(orm).enable_identity_map && phalcon_mvc_model_manager_identity_update(getThis(), 1) == FAILURE) {
+			RETURN_MM();
+		}
+
 		PHALCON_MM_ZVAL_STRING(&event_name, "afterDelete");
 		PHALCON_MM_CALL_METHOD(NULL, getThis(), "fireevent", &event_name);
 
@@ -7315,6 +8383,7 @@ PHP_METHOD(Phalcon_Mvc_Model, toArray){
  * autoConvert           — Enables/Disables auto convert
  * strict                — Enables/Disables strict mode
  * strict                — Enables/Disables strict mode
+ * identityMap           — Enables/Disables the identity map of the models manager
  *
  * @param array $options
  */
@@ -7323,6 +8392,7 @@ PHP_METHOD(Phalcon_Mvc_Model, setup){
 	zval *options, disable_events = {}, virtual_foreign_keys = {}, not_null_validations = {}, length_validations = {}, use_mb_strlen = {};
 	zval exception_on_failed_save = {};
 	zval phql_literals = {}, property_method = {}, auto_convert = {}, allow_update_primary = {}, enable_strict = {}, must_column = {};
+	zval identity_map = {};
 
 	phalcon_fetch_params(0, 1, 0, &options);
 
@@ -7410,6 +8480,13 @@ PHP_METHOD(Phalcon_Mvc_Model, setup){
 	if (phalcon_array_isset_fetch_str(&must_column, options, SL("mustColumn"), PH_READONLY)) {
 		PHALCON_GLOBAL(orm).must_column = zend_is_true(&must_column);
 	}
+
+	/**
+	 * Enables/Disables the identity map, records with the same primary key are hydrated once
+	 */
+	if (phalcon_array_isset_fetch_str(&identity_map, options, SL("identityMap"), PH_READONLY)) {
+		PHALCON_GLOBAL(orm).enable_identity_map = zend_is_true(&identity_map);
+	}
 }
 
 /**
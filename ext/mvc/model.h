@@ -35,4 +35,7 @@ extern zend_class_entry *phalcon_mvc_model_ce;
 
 PHALCON_INIT_CLASS(Phalcon_Mvc_Model);
 
+int phalcon_mvc_model_uow_write(zval *return_value, zval *record, zval *exists, zval *connection);
+int phalcon_mvc_model_uow_finish(zval *return_value, zval *record, zval *exists, zval *connection, zval *success);
+
 #endif /* PHALCON_MVC_MODEL_H */
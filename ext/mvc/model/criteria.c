@@ -101,6 +101,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Criteria, having);
 PHP_METHOD(Phalcon_Mvc_Model_Criteria, execute);
 PHP_METHOD(Phalcon_Mvc_Model_Criteria, count);
 PHP_METHOD(Phalcon_Mvc_Model_Criteria, cache);
+PHP_METHOD(Phalcon_Mvc_Model_Criteria, with);
 PHP_METHOD(Phalcon_Mvc_Model_Criteria, insert);
 PHP_METHOD(Phalcon_Mvc_Model_Criteria, update);
 PHP_METHOD(Phalcon_Mvc_Model_Criteria, delete);
@@ -141,6 +142,10 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_criteria_cache, 0, 0, 1)
 	ZEND_ARG_ARRAY_INFO(0, options, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_criteria_with, 0, 0, 1)
+	ZEND_ARG_INFO(0, with)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_criteria_count, 0, 0, 0)
 	ZEND_ARG_TYPE_INFO(0, column, IS_STRING, 1)
 ZEND_END_ARG_INFO()
@@ -190,6 +195,7 @@ static const zend_function_entry phalcon_mvc_model_criteria_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Model_Criteria, execute, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Criteria, count, arginfo_phalcon_mvc_model_criteria_count, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Criteria, cache, arginfo_phalcon_mvc_model_criteria_cache, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Criteria, with, arginfo_phalcon_mvc_model_criteria_with, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Criteria, insert, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Criteria, update, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Criteria, delete, NULL, ZEND_ACC_PUBLIC)
@@ -224,6 +230,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Criteria) {
 	zend_declare_property_null(phalcon_mvc_model_criteria_ce, SL("_sharedLock"), ZEND_ACC_PROTECTED);
 	zend_declare_property_long(phalcon_mvc_model_criteria_ce, SL("_hiddenParamNumber"), 0, ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_criteria_ce, SL("_cacheOptions"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_criteria_ce, SL("_with"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_criteria_ce, SL("_group"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_criteria_ce, SL("_having"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_criteria_ce, SL("_uniqueRow"), ZEND_ACC_PROTECTED);
@@ -1240,7 +1247,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Criteria, getOrder) {
  */
 PHP_METHOD(Phalcon_Mvc_Model_Criteria, getParams) {
 
-	zval params = {}, conditions = {}, bind_params = {}, bind_types = {}, order = {}, limit = {}, offset = {}, cache = {};
+	zval params = {}, conditions = {}, bind_params = {}, bind_types = {}, order = {}, limit = {}, offset = {}, cache = {}, with = {};
 
 	array_init(&params);
 
@@ -1279,6 +1286,11 @@ PHP_METHOD(Phalcon_Mvc_Model_Criteria, getParams) {
 		phalcon_array_update_str(&params, SL("cache"), &cache, PH_COPY);
 	}
 
+	phalcon_read_property(&with, getThis(), SL("_with"), PH_NOISY|PH_READONLY);
+	if (Z_TYPE(with) != IS_NULL) {
+		phalcon_array_update_str(&params, SL("with"), &with, PH_COPY);
+	}
+
 	RETVAL_ZVAL(&params, 0, 0);
 }
 
@@ -1425,7 +1437,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Criteria, having) {
  */
 PHP_METHOD(Phalcon_Mvc_Model_Criteria, execute) {
 
-	zval phql = {}, dependency_injector = {}, cache_options = {}, unique_row = {}, index = {};
+	zval phql = {}, dependency_injector = {}, cache_options = {}, unique_row = {}, index = {}, with = {};
 	zval query = {}, bind_params = {}, bind_types = {};
 
 	PHALCON_MM_INIT();
@@ -1437,6 +1449,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Criteria, execute) {
 	phalcon_read_property(&cache_options, getThis(), SL("_cacheOptions"), PH_NOISY|PH_READONLY);
 	phalcon_read_property(&unique_row, getThis(), SL("_uniqueRow"), PH_NOISY|PH_READONLY);
 	phalcon_read_property(&index, getThis(), SL("_index"), PH_NOISY|PH_READONLY);
+	phalcon_read_property(&with, getThis(), SL("_with"), PH_NOISY|PH_READONLY);
 
 	object_init_ex(&query, phalcon_mvc_model_query_ce);
 	PHALCON_MM_ADD_ENTRY(&query);
@@ -1454,6 +1467,10 @@ PHP_METHOD(Phalcon_Mvc_Model_Criteria, execute) {
 		PHALCON_MM_CALL_METHOD(NULL, &query, "setindex", &index);
 	}
 
+	if (Z_TYPE(with) != IS_NULL) {
+		PHALCON_MM_CALL_METHOD(NULL, &query, "setwith", &with);
+	}
+
 	phalcon_read_property(&bind_params, getThis(), SL("_bindParams"), PH_NOISY|PH_READONLY);
 	phalcon_read_property(&bind_types, getThis(), SL("_bindTypes"), PH_NOISY|PH_READONLY);
 
@@ -1526,6 +1543,30 @@ PHP_METHOD(Phalcon_Mvc_Model_Criteria, cache) {
 	RETURN_THIS();
 }
 
+/**
+ * Sets the relations to eager load into the records found, dotted paths load nested relations
+ *
+ *<code>
+ * $robots = Robots::query()
+ *     ->where("type = 'mechanical'")
+ *     ->with(array('robotsParts.parts'))
+ *     ->execute();
+ *</code>
+ *
+ * @param string|array $with
+ * @return Phalcon\Mvc\Model\CriteriaInterface
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Criteria, with) {
+
+	zval *with;
+
+	phalcon_fetch_params(0, 1, 0, &with);
+
+	phalcon_update_property(getThis(), SL("_with"), with);
+
+	RETURN_THIS();
+}
+
 /**
  * Sets insert type of PHQL statement to be executed
  *
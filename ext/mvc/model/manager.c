@@ -24,9 +24,18 @@
 #include "mvc/model/query.h"
 #include "mvc/model/query/builder.h"
 #include "mvc/model/relation.h"
+#include "mvc/model/resultset.h"
+#include "mvc/model/resultsetinterface.h"
+#include "mvc/model/resultset/simple.h"
+#include "mvc/model.h"
+#include "mvc/modelinterface.h"
 #include "diinterface.h"
 #include "di/injectable.h"
 #include "db/adapterinterface.h"
+#include "db/router.h"
+#include "db/pool.h"
+#include "db/rawvalue.h"
+#include "db/column.h"
 
 #include "kernel/main.h"
 #include "kernel/memory.h"
@@ -39,6 +48,7 @@
 #include "kernel/concat.h"
 #include "kernel/operators.h"
 #include "kernel/hash.h"
+#include "kernel/iterator.h"
 #include "kernel/framework/orm.h"
 #include "kernel/debug.h"
 
@@ -102,9 +112,19 @@ PHP_METHOD(Phalcon_Mvc_Model_Manager, existsHasOne);
 PHP_METHOD(Phalcon_Mvc_Model_Manager, existsHasManyToMany);
 PHP_METHOD(Phalcon_Mvc_Model_Manager, getRelationByAlias);
 PHP_METHOD(Phalcon_Mvc_Model_Manager, getRelationRecords);
+PHP_METHOD(Phalcon_Mvc_Model_Manager, eagerLoad);
+PHP_METHOD(Phalcon_Mvc_Model_Manager, _eagerLoadRelation);
 PHP_METHOD(Phalcon_Mvc_Model_Manager, getReusableRecords);
 PHP_METHOD(Phalcon_Mvc_Model_Manager, setReusableRecords);
 PHP_METHOD(Phalcon_Mvc_Model_Manager, clearReusableObjects);
+PHP_METHOD(Phalcon_Mvc_Model_Manager, getIdentity);
+PHP_METHOD(Phalcon_Mvc_Model_Manager, addIdentity);
+PHP_METHOD(Phalcon_Mvc_Model_Manager, removeIdentity);
+PHP_METHOD(Phalcon_Mvc_Model_Manager, clearIdentityMap);
+PHP_METHOD(Phalcon_Mvc_Model_Manager, beginUnitOfWork);
+PHP_METHOD(Phalcon_Mvc_Model_Manager, isInUnitOfWork);
+PHP_METHOD(Phalcon_Mvc_Model_Manager, flush);
+PHP_METHOD(Phalcon_Mvc_Model_Manager, clearUnitOfWork);
 PHP_METHOD(Phalcon_Mvc_Model_Manager, getBelongsToRecords);
 PHP_METHOD(Phalcon_Mvc_Model_Manager, getHasManyRecords);
 PHP_METHOD(Phalcon_Mvc_Model_Manager, getHasOneRecords);
@@ -231,6 +251,17 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_manager_getrelationrecords, 0,
 	ZEND_ARG_INFO(0, parameters)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_manager_eagerload, 0, 0, 2)
+	ZEND_ARG_INFO(0, records)
+	ZEND_ARG_INFO(0, with)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_manager__eagerloadrelation, 0, 0, 3)
+	ZEND_ARG_TYPE_INFO(0, records, IS_ARRAY, 0)
+	ZEND_ARG_INFO(0, relation)
+	ZEND_ARG_TYPE_INFO(0, alias, IS_STRING, 0)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_manager_getreusablerecords, 0, 0, 2)
 	ZEND_ARG_INFO(0, modelName)
 	ZEND_ARG_INFO(0, key)
@@ -242,6 +273,24 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_manager_setreusablerecords, 0,
 	ZEND_ARG_INFO(0, records)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_manager_getidentity, 0, 0, 2)
+	ZEND_ARG_TYPE_INFO(0, modelName, IS_STRING, 0)
+	ZEND_ARG_INFO(0, key)
+	ZEND_ARG_TYPE_INFO(0, connectionService, IS_STRING, 1)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_manager_addidentity, 0, 0, 1)
+	ZEND_ARG_OBJ_INFO(0, record, Phalcon\\Mvc\\ModelInterface, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_manager_removeidentity, 0, 0, 1)
+	ZEND_ARG_OBJ_INFO(0, record, Phalcon\\Mvc\\ModelInterface, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_manager_clearidentitymap, 0, 0, 0)
+	ZEND_ARG_TYPE_INFO(0, modelName, IS_STRING, 1)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_manager_gethasmanytomany, 0, 0, 1)
 	ZEND_ARG_INFO(0, model)
 ZEND_END_ARG_INFO()
@@ -294,9 +343,19 @@ static const zend_function_entry phalcon_mvc_model_manager_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Model_Manager, existsHasManyToMany, arginfo_phalcon_mvc_model_manager_existshasmanytomany, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Manager, getRelationByAlias, arginfo_phalcon_mvc_model_manager_getrelationbyalias, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Manager, getRelationRecords, arginfo_phalcon_mvc_model_manager_getrelationrecords, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Manager, eagerLoad, arginfo_phalcon_mvc_model_manager_eagerload, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Manager, _eagerLoadRelation, arginfo_phalcon_mvc_model_manager__eagerloadrelation, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Mvc_Model_Manager, getReusableRecords, arginfo_phalcon_mvc_model_manager_getreusablerecords, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Manager, setReusableRecords, arginfo_phalcon_mvc_model_manager_setreusablerecords, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Manager, clearReusableObjects, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Manager, getIdentity, arginfo_phalcon_mvc_model_manager_getidentity, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Manager, addIdentity, arginfo_phalcon_mvc_model_manager_addidentity, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Manager, removeIdentity, arginfo_phalcon_mvc_model_manager_removeidentity, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Manager, clearIdentityMap, arginfo_phalcon_mvc_model_manager_clearidentitymap, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Manager, beginUnitOfWork, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Manager, isInUnitOfWork, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Manager, flush, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Manager, clearUnitOfWork, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Manager, getBelongsToRecords, arginfo_phalcon_mvc_model_managerinterface_getbelongstorecords, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Manager, getHasManyRecords, arginfo_phalcon_mvc_model_managerinterface_gethasmanyrecords, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Manager, getHasOneRecords, arginfo_phalcon_mvc_model_managerinterface_gethasonerecords, ZEND_ACC_PUBLIC)
@@ -347,6 +406,9 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Manager){
 	zend_declare_property_null(phalcon_mvc_model_manager_ce, SL("_lastInitialized"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_manager_ce, SL("_lastQuery"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_manager_ce, SL("_reusable"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_manager_ce, SL("_identityMap"), ZEND_ACC_PROTECTED);
+	zend_declare_property_long(phalcon_mvc_model_manager_ce, SL("_identityMapRequest"), 0, ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_manager_ce, SL("_unitOfWork"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_manager_ce, SL("_dynamicUpdate"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_manager_ce, SL("_namespaceAliases"), ZEND_ACC_PROTECTED);
 
@@ -814,7 +876,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Manager, getDefaultReadConnectionService){
  */
 PHP_METHOD(Phalcon_Mvc_Model_Manager, getWriteConnection){
 
-	zval *model, service = {}, dependency_injector = {};
+	zval *model, service = {}, dependency_injector = {}, router = {}, pool = {};
 
 	phalcon_fetch_params(0, 1, 0, &model);
 
@@ -838,6 +900,36 @@ PHP_METHOD(Phalcon_Mvc_Model_Manager, getWriteConnection){
 		return;
 	}
 
+	/**
+	 * A router picks the connection among the primary and the replicas
+	 */
+	if (instanceof_function(Z_OBJCE_P(return_value), phalcon_db_router_ce)) {
+		int status;
+
+		ZVAL_COPY_VALUE(&router, return_value);
+		ZVAL_NULL(return_value);
+		PHALCON_CALL_METHOD_FLAG(status, return_value, &router, "getwriteconnection");
+		zval_ptr_dtor(&router);
+		if (status == FAILURE) {
+			return;
+		}
+	}
+
+	/**
+	 * A pool lends the connection of the current task
+	 */
+	if (Z_TYPE_P(return_value) == IS_OBJECT && instanceof_function(Z_OBJCE_P(return_value), phalcon_db_pool_ce)) {
+		int status;
+
+		ZVAL_COPY_VALUE(&pool, return_value);
+		ZVAL_NULL(return_value);
+		PHALCON_CALL_METHOD_FLAG(status, return_value, &pool, "get");
+		zval_ptr_dtor(&pool);
+		if (status == FAILURE) {
+			return;
+		}
+	}
+
 	PHALCON_VERIFY_INTERFACE(return_value, phalcon_db_adapterinterface_ce);
 }
 
@@ -849,7 +941,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Manager, getWriteConnection){
  */
 PHP_METHOD(Phalcon_Mvc_Model_Manager, getReadConnection){
 
-	zval *model, service = {}, dependency_injector = {};
+	zval *model, service = {}, dependency_injector = {}, router = {}, pool = {};
 
 	phalcon_fetch_params(0, 1, 0, &model);
 
@@ -872,6 +964,36 @@ PHP_METHOD(Phalcon_Mvc_Model_Manager, getReadConnection){
 		return;
 	}
 
+	/**
+	 * A router picks the connection among the primary and the replicas
+	 */
+	if (instanceof_function(Z_OBJCE_P(return_value), phalcon_db_router_ce)) {
+		int status;
+
+		ZVAL_COPY_VALUE(&router, return_value);
+		ZVAL_NULL(return_value);
+		PHALCON_CALL_METHOD_FLAG(status, return_value, &router, "getreadconnection");
+		zval_ptr_dtor(&router);
+		if (status == FAILURE) {
+			return;
+		}
+	}
+
+	/**
+	 * A pool lends the connection of the current task
+	 */
+	if (Z_TYPE_P(return_value) == IS_OBJECT && instanceof_function(Z_OBJCE_P(return_value), phalcon_db_pool_ce)) {
+		int status;
+
+		ZVAL_COPY_VALUE(&pool, return_value);
+		ZVAL_NULL(return_value);
+		PHALCON_CALL_METHOD_FLAG(status, return_value, &pool, "get");
+		zval_ptr_dtor(&pool);
+		if (status == FAILURE) {
+			return;
+		}
+	}
+
 	PHALCON_VERIFY_INTERFACE(return_value, phalcon_db_adapterinterface_ce);
 }
 
@@ -2050,53 +2172,1513 @@ PHP_METHOD(Phalcon_Mvc_Model_Manager, getRelationRecords){
 }
 
 /**
- * Returns a reusable object from the internal list
- *
- * @param string $modelName
- * @param string $key
- * @return object
+ * Groups an eager loading path such as 'orders.items.product' under its first alias
  */
-PHP_METHOD(Phalcon_Mvc_Model_Manager, getReusableRecords){
+static void phalcon_mvc_model_manager_eager_path(zval *tree, const char *path, size_t path_len)
+{
+	zval nested = {}, *sub_paths;
+	zend_string *alias;
+	const char *dot = memchr(path, '.', path_len);
+	size_t alias_len = dot ? (size_t)(dot - path) : path_len;
+
+	if (!alias_len) {
+		return;
+	}
 
-	zval *model_name, *key, reusable = {}, records = {};
+	alias = zend_string_alloc(alias_len, 0);
+	zend_str_tolower_copy(ZSTR_VAL(alias), path, alias_len);
 
-	phalcon_fetch_params(0, 2, 0, &model_name, &key);
+	if ((sub_paths = zend_symtable_find(Z_ARRVAL_P(tree), alias)) == NULL) {
+		array_init(&nested);
+		sub_paths = zend_symtable_update(Z_ARRVAL_P(tree), alias, &nested);
+	}
 
-	phalcon_read_property(&reusable, getThis(), SL("_reusable"), PH_NOISY|PH_READONLY);
-	if (phalcon_array_isset_fetch(&records, &reusable, key, PH_READONLY)) {
-		RETURN_CTOR(&records);
+	if (dot && (size_t)(dot - path) + 1 < path_len) {
+		add_next_index_stringl(sub_paths, dot + 1, path_len - alias_len - 1);
 	}
 
-	RETURN_NULL();
+	zend_string_release(alias);
+}
+
+static void phalcon_mvc_model_manager_eager_paths(zval *tree, zval *with, zend_string *prefix)
+{
+	zval *path;
+	zend_string *str_key, *full;
+
+	if (Z_TYPE_P(with) == IS_STRING) {
+		if (prefix) {
+			full = strpprintf(0, "%s.%s", ZSTR_VAL(prefix), Z_STRVAL_P(with));
+			phalcon_mvc_model_manager_eager_path(tree, ZSTR_VAL(full), ZSTR_LEN(full));
+			zend_string_release(full);
+		} else {
+			phalcon_mvc_model_manager_eager_path(tree, Z_STRVAL_P(with), Z_STRLEN_P(with));
+		}
+	} else if (Z_TYPE_P(with) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(with), str_key, path) {
+			if (str_key) {
+				/**
+				 * array('orders' => array('items.product', 'customer'))
+				 */
+				full = prefix ? strpprintf(0, "%s.%s", ZSTR_VAL(prefix), ZSTR_VAL(str_key)) : zend_string_copy(str_key);
+				phalcon_mvc_model_manager_eager_path(tree, ZSTR_VAL(full), ZSTR_LEN(full));
+				phalcon_mvc_model_manager_eager_paths(tree, path, full);
+				zend_string_release(full);
+			} else {
+				phalcon_mvc_model_manager_eager_paths(tree, path, prefix);
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
 }
 
 /**
- * Stores a reusable record in the internal list
+ * Appends the records held by an array, a resultset or a single record to a list
+ */
+static int phalcon_mvc_model_manager_collect_records(zval *list, zval *records)
+{
+	zend_object_iterator *it;
+	zval *record;
+
+	if (Z_TYPE_P(records) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(records), record) {
+			if (Z_TYPE_P(record) == IS_OBJECT && instanceof_function(Z_OBJCE_P(record), phalcon_mvc_model_ce)) {
+				phalcon_array_append(list, record, PH_COPY);
+			}
+		} ZEND_HASH_FOREACH_END();
+		return SUCCESS;
+	}
+
+	if (Z_TYPE_P(records) != IS_OBJECT) {
+		return SUCCESS;
+	}
+
+	if (instanceof_function(Z_OBJCE_P(records), phalcon_mvc_model_ce)) {
+		phalcon_array_append(list, records, PH_COPY);
+		return SUCCESS;
+	}
+
+	if (!instanceof_function(Z_OBJCE_P(records), zend_ce_traversable) || (it = phalcon_get_iterator(records)) == NULL) {
+		return EG(exception) ? FAILURE : SUCCESS;
+	}
+
+	it->funcs->rewind(it);
+	while (!EG(exception) && it->funcs->valid(it) == SUCCESS) {
+		record = it->funcs->get_current_data(it);
+		if (EG(exception)) {
+			break;
+		}
+
+		if (record && Z_TYPE_P(record) == IS_OBJECT && instanceof_function(Z_OBJCE_P(record), phalcon_mvc_model_ce)) {
+			phalcon_array_append(list, record, PH_COPY);
+		}
+
+		it->funcs->move_forward(it);
+	}
+	zend_iterator_dtor(it);
+
+	return EG(exception) ? FAILURE : SUCCESS;
+}
+
+/**
+ * Appends the records of a model whose field matches any of the values of a chunk
+ */
+static int phalcon_mvc_model_manager_eager_find_chunk(zval *list, zval *entity, zval *condition, zval *chunk)
+{
+	zval bind = {}, params = {}, result = {};
+	int flag;
+
+	array_init_size(&bind, 1);
+	phalcon_array_update_str(&bind, SL("pha_eager"), chunk, PH_COPY);
+
+	array_init_size(&params, 2);
+	phalcon_array_append(&params, condition, PH_COPY);
+	phalcon_array_update_str(&params, SL("bind"), &bind, 0);
+
+	PHALCON_CALL_CE_STATIC_FLAG(flag, &result, Z_OBJCE_P(entity), "find", &params);
+	zval_ptr_dtor(&params);
+
+	if (flag == SUCCESS) {
+		flag = phalcon_mvc_model_manager_collect_records(list, &result);
+	}
+	zval_ptr_dtor(&result);
+
+	return flag;
+}
+
+/**
+ * Returns the records of a model whose field matches any of the values. The values are sent in
+ * chunks, SQLite doesn't accept more than 999 parameters in a statement
+ */
+static int phalcon_mvc_model_manager_eager_find(zval *return_value, zval *entity, zval *field, zval *values)
+{
+	zval condition = {}, chunk = {}, *value;
+	int flag = SUCCESS;
+
+	array_init(return_value);
+
+	PHALCON_CONCAT_SVS(&condition, "[", field, "] IN ({pha_eager:array})");
+
+	array_init_size(&chunk, PHALCON_MVC_MODEL_MANAGER_EAGER_CHUNK);
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(values), value) {
+		phalcon_array_append(&chunk, value, PH_COPY);
+		if (zend_hash_num_elements(Z_ARRVAL(chunk)) < PHALCON_MVC_MODEL_MANAGER_EAGER_CHUNK) {
+			continue;
+		}
+		flag = phalcon_mvc_model_manager_eager_find_chunk(return_value, entity, &condition, &chunk);
+		zval_ptr_dtor(&chunk);
+		if (flag == FAILURE) {
+			ZVAL_UNDEF(&chunk);
+			break;
+		}
+		array_init_size(&chunk, PHALCON_MVC_MODEL_MANAGER_EAGER_CHUNK);
+	} ZEND_HASH_FOREACH_END();
+
+	if (flag == SUCCESS && zend_hash_num_elements(Z_ARRVAL(chunk))) {
+		flag = phalcon_mvc_model_manager_eager_find_chunk(return_value, entity, &condition, &chunk);
+	}
+
+	zval_ptr_dtor(&chunk);
+	zval_ptr_dtor(&condition);
+
+	return flag;
+}
+
+/**
+ * Wraps already hydrated records into a resultset like the one returned by the lazy loading
+ */
+static int phalcon_mvc_model_manager_eager_resultset(zval *return_value, zval *entity, zval *records)
+{
+	zval type = {}, rows = {};
+	uint32_t i, count = zend_hash_num_elements(Z_ARRVAL_P(records));
+	int flag;
+
+	object_init_ex(return_value, phalcon_mvc_model_resultset_simple_ce);
+	PHALCON_CALL_METHOD_FLAG(flag, NULL, return_value, "__construct", &PHALCON_GLOBAL(z_null), entity, &PHALCON_GLOBAL(z_false), &PHALCON_GLOBAL(z_null), entity);
+	if (flag == FAILURE) {
+		return FAILURE;
+	}
+
+	ZVAL_LONG(&type, PHALCON_MVC_MODEL_RESULTSET_TYPE_FULL);
+	PHALCON_CALL_METHOD_FLAG(flag, NULL, return_value, "settype", &type);
+	if (flag == FAILURE) {
+		return FAILURE;
+	}
+
+	/**
+	 * The records are served from _rowsModels, the rows only drive the traversal
+	 */
+	array_init_size(&rows, count);
+	for (i = 0; i < count; i++) {
+		zval row = {};
+		array_init(&row);
+		add_next_index_zval(&rows, &row);
+	}
+
+	phalcon_update_property(return_value, SL("_rows"), &rows);
+	phalcon_update_property(return_value, SL("_rowsModels"), records);
+	zval_ptr_dtor(&rows);
+
+	return SUCCESS;
+}
+
+/**
+ * Loads the related records of several records at once, running one query per relation
+ * instead of one query per record and relation. The related records are stored in the
+ * records as if they were accessed through their magic properties, nested relations are
+ * expressed with dotted paths
  *
- * @param string $modelName
- * @param string $key
- * @param mixed $records
+ *<code>
+ * $robots = Robots::find();
+ * $modelsManager->eagerLoad($robots, array('robotsParts.parts', 'owner'));
+ * foreach ($robots as $robot) {
+ *     foreach ($robot->robotsParts as $robotPart) {
+ *         echo $robotPart->parts->name, PHP_EOL; // No query is sent
+ *     }
+ * }
+ *</code>
+ *
+ * @param array|Phalcon\Mvc\Model\ResultsetInterface|Phalcon\Mvc\ModelInterface $records
+ * @param string|array $with
  */
-PHP_METHOD(Phalcon_Mvc_Model_Manager, setReusableRecords){
+PHP_METHOD(Phalcon_Mvc_Model_Manager, eagerLoad){
 
-	zval *model_name, *key, *records;
+	zval *records, *with, type = {}, tree = {}, parents = {}, model_name = {}, *first, *sub_paths;
+	zend_string *str_key;
 
-	phalcon_fetch_params(0, 3, 0, &model_name, &key, &records);
+	phalcon_fetch_params(1, 2, 0, &records, &with);
 
-	phalcon_update_property_array(getThis(), SL("_reusable"), key, records);
+	if (Z_TYPE_P(records) == IS_OBJECT && instanceof_function(Z_OBJCE_P(records), phalcon_mvc_model_resultset_ce)) {
+		PHALCON_MM_CALL_METHOD(&type, records, "gettype");
+		if (PHALCON_IS_LONG(&type, PHALCON_MVC_MODEL_RESULTSET_TYPE_STREAM)) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Related records cannot be eager loaded into a streaming resultset");
+			return;
+		}
+	}
+
+	array_init(&tree);
+	PHALCON_MM_ADD_ENTRY(&tree);
+	phalcon_mvc_model_manager_eager_paths(&tree, with, NULL);
+	if (!zend_hash_num_elements(Z_ARRVAL(tree))) {
+		RETURN_MM();
+	}
+
+	array_init(&parents);
+	PHALCON_MM_ADD_ENTRY(&parents);
+	if (phalcon_mvc_model_manager_collect_records(&parents, records) == FAILURE) {
+		RETURN_MM();
+	}
+
+	if ((first = zend_hash_index_find(Z_ARRVAL(parents), 0)) == NULL) {
+		RETURN_MM();
+	}
+
+	phalcon_get_class(&model_name, first, 0);
+	PHALCON_MM_ADD_ENTRY(&model_name);
+
+	ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL(tree), str_key, sub_paths) {
+		zval alias = {}, relation = {}, exception_message = {}, related = {};
+		if (!str_key) {
+			continue;
+		}
+
+		ZVAL_STR(&alias, str_key);
+
+		PHALCON_MM_CALL_METHOD(&relation, getThis(), "getrelationbyalias", &model_name, &alias);
+		PHALCON_MM_ADD_ENTRY(&relation);
+		if (Z_TYPE(relation) != IS_OBJECT) {
+			PHALCON_CONCAT_SVSVS(&exception_message, "There is no defined relations for the model \"", &model_name, "\" using alias \"", &alias, "\"");
+			PHALCON_MM_ADD_ENTRY(&exception_message);
+			PHALCON_MM_THROW_EXCEPTION_ZVAL(phalcon_mvc_model_exception_ce, &exception_message);
+			return;
+		}
+
+		PHALCON_MM_CALL_METHOD(&related, getThis(), "_eagerloadrelation", &parents, &relation, &alias);
+		PHALCON_MM_ADD_ENTRY(&related);
+
+		/**
+		 * Nested relations are loaded for all the related records together
+		 */
+		if (zend_hash_num_elements(Z_ARRVAL_P(sub_paths)) && Z_TYPE(related) == IS_ARRAY && zend_hash_num_elements(Z_ARRVAL(related))) {
+			PHALCON_MM_CALL_METHOD(NULL, getThis(), "eagerload", &related, sub_paths);
+		}
+	} ZEND_HASH_FOREACH_END();
 
+	RETURN_MM();
 }
 
 /**
- * Clears the internal reusable list
+ * Loads a relation for a list of records of the same model with a single IN (...) query,
+ * or two for relations through an intermediate model. Returns the related records found
  *
- * @param
+ * @param array $records
+ * @param Phalcon\Mvc\Model\RelationInterface $relation
+ * @param string $alias
+ * @return array
  */
-PHP_METHOD(Phalcon_Mvc_Model_Manager, clearReusableObjects){
+PHP_METHOD(Phalcon_Mvc_Model_Manager, _eagerLoadRelation){
 
+	zval *records, *relation, *alias, *record, *related, lower_alias = {}, type = {}, is_through = {}, fields = {}, referenced_fields = {};
+	zval referenced_model = {}, referenced_entity = {}, intermediate_model = {}, intermediate_entity = {}, intermediate_fields = {};
+	zval intermediate_referenced_fields = {}, keys = {}, values = {}, groups = {}, empty = {};
+	zend_ulong idx;
+	int many, through;
 
-	phalcon_update_property_null(getThis(), SL("_reusable"));
+	phalcon_fetch_params(1, 3, 0, &records, &relation, &alias);
+
+	array_init(return_value);
+
+	phalcon_fast_strtolower(&lower_alias, alias);
+	PHALCON_MM_ADD_ENTRY(&lower_alias);
+
+	PHALCON_MM_CALL_METHOD(&type, relation, "gettype");
+	PHALCON_MM_CALL_METHOD(&is_through, relation, "isthrough");
+
+	/**
+	 * Has-many and through relations are stored as resultsets, the others as a single record
+	 */
+	through = zend_is_true(&is_through);
+	many = through || PHALCON_IS_LONG(&type, 2);
+
+	PHALCON_MM_CALL_METHOD(&fields, relation, "getfields");
+	PHALCON_MM_ADD_ENTRY(&fields);
+	PHALCON_MM_CALL_METHOD(&referenced_fields, relation, "getreferencedfields");
+	PHALCON_MM_ADD_ENTRY(&referenced_fields);
+
+	if (through) {
+		PHALCON_MM_CALL_METHOD(&intermediate_fields, relation, "getintermediatefields");
+		PHALCON_MM_ADD_ENTRY(&intermediate_fields);
+		PHALCON_MM_CALL_METHOD(&intermediate_referenced_fields, relation, "getintermediatereferencedfields");
+		PHALCON_MM_ADD_ENTRY(&intermediate_referenced_fields);
+	}
+
+	/**
+	 * Compound keys can't be batched in a single IN (...), they are resolved record by record
+	 */
+	if (Z_TYPE(fields) == IS_ARRAY || Z_TYPE(referenced_fields) == IS_ARRAY || Z_TYPE(intermediate_fields) == IS_ARRAY || Z_TYPE(intermediate_referenced_fields) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(records), record) {
+			zval result = {};
+			PHALCON_MM_CALL_METHOD(&result, getThis(), "getrelationrecords", relation, &PHALCON_GLOBAL(z_null), record);
+			PHALCON_MM_ADD_ENTRY(&result);
+			if (Z_TYPE(result) == IS_OBJECT) {
+				if (instanceof_function_ex(Z_OBJCE(result), phalcon_mvc_modelinterface_ce, 1)) {
+					phalcon_update_property_array(record, SL("_related"), &lower_alias, &result);
+				} else if (instanceof_function_ex(Z_OBJCE(result), phalcon_mvc_model_resultsetinterface_ce, 1)) {
+					phalcon_update_property_array(record, SL("_relatedResult"), &lower_alias, &result);
+				}
+
+				if (phalcon_mvc_model_manager_collect_records(return_value, &result) == FAILURE) {
+					RETURN_MM();
+				}
+			}
+		} ZEND_HASH_FOREACH_END();
+		RETURN_MM();
+	}
+
+	PHALCON_MM_CALL_METHOD(&referenced_model, relation, "getreferencedmodel");
+	PHALCON_MM_ADD_ENTRY(&referenced_model);
+	PHALCON_MM_CALL_METHOD(&referenced_entity, getThis(), "load", &referenced_model);
+	PHALCON_MM_ADD_ENTRY(&referenced_entity);
+
+	/**
+	 * Collect the distinct values the records point to
+	 */
+	array_init(&keys);
+	PHALCON_MM_ADD_ENTRY(&keys);
+	array_init(&values);
+	PHALCON_MM_ADD_ENTRY(&values);
+
+	ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL_P(records), idx, record) {
+		zval value = {};
+		PHALCON_MM_CALL_METHOD(&value, record, "readattribute", &fields);
+		if (Z_TYPE(value) == IS_LONG || Z_TYPE(value) == IS_STRING) {
+			phalcon_array_update(&values, &value, &value, PH_COPY);
+		}
+		phalcon_array_update_long(&keys, idx, &value, 0);
+	} ZEND_HASH_FOREACH_END();
+
+	array_init(&groups);
+	PHALCON_MM_ADD_ENTRY(&groups);
+
+	if (zend_hash_num_elements(Z_ARRVAL(values)) && !through) {
+		zval result = {};
+		if (phalcon_mvc_model_manager_eager_find(&result, &referenced_entity, &referenced_fields, &values) == FAILURE) {
+			zval_ptr_dtor(&result);
+			RETURN_MM();
+		}
+		PHALCON_MM_ADD_ENTRY(&result);
+
+		if (phalcon_mvc_model_manager_collect_records(return_value, &result) == FAILURE) {
+			RETURN_MM();
+		}
+
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(return_value), related) {
+			zval key = {};
+			PHALCON_MM_CALL_METHOD(&key, related, "readattribute", &referenced_fields);
+			PHALCON_MM_ADD_ENTRY(&key);
+			if (many) {
+				phalcon_array_append_multi_2(&groups, &key, related, PH_COPY);
+			} else if (!phalcon_array_isset(&groups, &key)) {
+				phalcon_array_update(&groups, &key, related, PH_COPY);
+			}
+		} ZEND_HASH_FOREACH_END();
+	} else if (zend_hash_num_elements(Z_ARRVAL(values))) {
+		zval links = {}, targets = {}, by_key = {}, *link;
+
+		PHALCON_MM_CALL_METHOD(&intermediate_model, relation, "getintermediatemodel");
+		PHALCON_MM_ADD_ENTRY(&intermediate_model);
+		PHALCON_MM_CALL_METHOD(&intermediate_entity, getThis(), "load", &intermediate_model);
+		PHALCON_MM_ADD_ENTRY(&intermediate_entity);
+
+		/**
+		 * First the intermediate records, then the records they point to
+		 */
+		if (phalcon_mvc_model_manager_eager_find(&links, &intermediate_entity, &intermediate_fields, &values) == FAILURE) {
+			zval_ptr_dtor(&links);
+			RETURN_MM();
+		}
+		PHALCON_MM_ADD_ENTRY(&links);
+
+		array_init(&targets);
+		PHALCON_MM_ADD_ENTRY(&targets);
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(links), link) {
+			zval value = {};
+			PHALCON_MM_CALL_METHOD(&value, link, "readattribute", &intermediate_referenced_fields);
+			if (Z_TYPE(value) == IS_LONG || Z_TYPE(value) == IS_STRING) {
+				phalcon_array_update(&targets, &value, &value, 0);
+			} else {
+				zval_ptr_dtor(&value);
+			}
+		} ZEND_HASH_FOREACH_END();
+
+		if (zend_hash_num_elements(Z_ARRVAL(targets))) {
+			zval target_result = {};
+			if (phalcon_mvc_model_manager_eager_find(&target_result, &referenced_entity, &referenced_fields, &targets) == FAILURE) {
+				zval_ptr_dtor(&target_result);
+				RETURN_MM();
+			}
+			PHALCON_MM_ADD_ENTRY(&target_result);
+
+			if (phalcon_mvc_model_manager_collect_records(return_value, &target_result) == FAILURE) {
+				RETURN_MM();
+			}
+
+			array_init(&by_key);
+			PHALCON_MM_ADD_ENTRY(&by_key);
+			ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(return_value), related) {
+				zval key = {};
+				PHALCON_MM_CALL_METHOD(&key, related, "readattribute", &referenced_fields);
+				PHALCON_MM_ADD_ENTRY(&key);
+				phalcon_array_update(&by_key, &key, related, PH_COPY);
+			} ZEND_HASH_FOREACH_END();
+
+			ZEND_HASH_FOREACH_VAL(Z_ARRVAL(links), link) {
+				zval key = {}, target_key = {}, target = {};
+				PHALCON_MM_CALL_METHOD(&target_key, link, "readattribute", &intermediate_referenced_fields);
+				PHALCON_MM_ADD_ENTRY(&target_key);
+				if (phalcon_array_isset_fetch(&target, &by_key, &target_key, PH_READONLY)) {
+					PHALCON_MM_CALL_METHOD(&key, link, "readattribute", &intermediate_fields);
+					PHALCON_MM_ADD_ENTRY(&key);
+					phalcon_array_append_multi_2(&groups, &key, &target, PH_COPY);
+				}
+			} ZEND_HASH_FOREACH_END();
+		}
+	}
+
+	/**
+	 * Stitch the related records into the records
+	 */
+	array_init(&empty);
+	PHALCON_MM_ADD_ENTRY(&empty);
+
+	ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL_P(records), idx, record) {
+		zval key = {}, found = {}, resultset = {};
+
+		phalcon_array_fetch_long(&key, &keys, idx, PH_NOISY|PH_READONLY);
+		if (Z_TYPE(key) != IS_NULL && Z_TYPE(key) != IS_LONG && Z_TYPE(key) != IS_STRING) {
+			continue;
+		}
+
+		if (many) {
+			if (Z_TYPE(key) == IS_NULL || !phalcon_array_isset_fetch(&found, &groups, &key, PH_READONLY)) {
+				ZVAL_COPY_VALUE(&found, &empty);
+			}
+
+			if (phalcon_mvc_model_manager_eager_resultset(&resultset, &referenced_entity, &found) == FAILURE) {
+				zval_ptr_dtor(&resultset);
+				RETURN_MM();
+			}
+			phalcon_update_property_array(record, SL("_relatedResult"), &lower_alias, &resultset);
+			zval_ptr_dtor(&resultset);
+		} else {
+			/**
+			 * A missing parent is kept as null, reading it doesn't query again
+			 */
+			if (Z_TYPE(key) == IS_NULL || !phalcon_array_isset_fetch(&found, &groups, &key, PH_READONLY)) {
+				ZVAL_NULL(&found);
+			}
+			phalcon_update_property_array(record, SL("_related"), &lower_alias, &found);
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	RETURN_MM();
+}
+
+/**
+ * Reads the values of the primary key of a model from a row or, without a row, from the record
+ * itself. The values are null if the model doesn't have a primary key or any value is empty
+ */
+static int phalcon_mvc_model_manager_identity_values(zval *return_value, zval *model, zval *row)
+{
+	zval meta_data = {}, primary_keys = {}, column_map = {}, *field;
+	int status;
+
+	ZVAL_NULL(return_value);
+
+	PHALCON_CALL_METHOD_FLAG(status, &meta_data, model, "getmodelsmetadata");
+	if (status == FAILURE) {
+		return FAILURE;
+	}
+
+	PHALCON_CALL_METHOD_FLAG(status, &primary_keys, &meta_data, "getprimarykeyattributes", model);
+	if (status == SUCCESS && !row) {
+		PHALCON_CALL_METHOD_FLAG(status, &column_map, &meta_data, "getcolumnmap", model);
+	}
+	zval_ptr_dtor(&meta_data);
+
+	if (status == SUCCESS && Z_TYPE(primary_keys) == IS_ARRAY && zend_hash_num_elements(Z_ARRVAL(primary_keys)) > 0) {
+		array_init(return_value);
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(primary_keys), field) {
+			zval attribute = {}, value = {};
+
+			if (row) {
+				phalcon_array_isset_fetch(&value, row, field, PH_READONLY);
+			} else {
+				if (Z_TYPE(column_map) != IS_ARRAY) {
+					ZVAL_COPY_VALUE(&attribute, field);
+				} else {
+					phalcon_array_isset_fetch(&attribute, &column_map, field, PH_READONLY);
+				}
+				if (Z_TYPE(attribute) == IS_STRING && phalcon_isset_property_zval(model, &attribute)) {
+					phalcon_read_property_zval(&value, model, &attribute, PH_READONLY);
+				}
+			}
+
+			/**
+			 * Only scalar values identify a record
+			 */
+			if (Z_TYPE(value) <= IS_NULL || Z_TYPE(value) > IS_STRING) {
+				zval_ptr_dtor(return_value);
+				ZVAL_NULL(return_value);
+				break;
+			}
+			phalcon_array_append(return_value, &value, PH_COPY);
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	zval_ptr_dtor(&primary_keys);
+	zval_ptr_dtor(&column_map);
+	return status;
+}
+
+/**
+ * The identity map only lives for a request, a manager kept by a long-lived worker forgets its
+ * records when the worker starts the next request
+ */
+static void phalcon_mvc_model_manager_identity_scope(zval *manager)
+{
+	zval request = {};
+
+	phalcon_read_property(&request, manager, SL("_identityMapRequest"), PH_READONLY);
+	if (Z_TYPE(request) != IS_LONG || (zend_ulong)Z_LVAL(request) != PHALCON_GLOBAL(orm).identity_map_request) {
+		phalcon_update_property_null(manager, SL("_identityMap"));
+		phalcon_update_property_long(manager, SL("_identityMapRequest"), (zend_long)PHALCON_GLOBAL(orm).identity_map_request);
+	}
+}
+
+/**
+ * Builds the key of a record in the identity map from its class, the connection service it is read
+ * from and the values of its primary key
+ */
+static void phalcon_mvc_model_manager_identity_key(zval *return_value, zend_class_entry *ce, zval *service, zval *values)
+{
+	smart_str key = {0};
+	zval *value;
+	int i = 0;
+
+	smart_str_append(&key, ce->name);
+	smart_str_appendc(&key, ':');
+	phalcon_append_printable_zval(&key, service);
+	smart_str_appendc(&key, ':');
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(values), value) {
+		if (i++) {
+			smart_str_appendc(&key, '\0');
+		}
+		phalcon_append_printable_zval(&key, value);
+	} ZEND_HASH_FOREACH_END();
+	smart_str_0(&key);
+
+	RETURN_NEW_STR(key.s);
+}
+
+/**
+ * Looks up in the identity map the record of a row before hydrating it. "manager" and "key" receive
+ * the models manager and the key to register the hydrated record, the key is null if the identity
+ * map doesn't apply to the model
+ */
+int phalcon_mvc_model_manager_identity_fetch(zval *return_value, zval *manager, zval *key, zval *model, zval *row)
+{
+	zval values = {}, service = {}, record = {};
+	int status;
+
+	ZVAL_NULL(return_value);
+	ZVAL_NULL(manager);
+	ZVAL_NULL(key);
+
+	if (!PHALCON_GLOBAL(orm).enable_identity_map || Z_TYPE_P(model) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(model), phalcon_mvc_model_ce)) {
+		return SUCCESS;
+	}
+
+	PHALCON_CALL_METHOD_FLAG(status, manager, model, "getmodelsmanager");
+	if (status == FAILURE || Z_TYPE_P(manager) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(manager), phalcon_mvc_model_manager_ce)) {
+		return status;
+	}
+
+	phalcon_mvc_model_manager_identity_scope(manager);
+
+	if (phalcon_mvc_model_manager_identity_values(&values, model, row) == FAILURE) {
+		return FAILURE;
+	}
+
+	if (Z_TYPE(values) == IS_ARRAY) {
+		/**
+		 * The same primary key can name different rows in different connections (shards)
+		 */
+		PHALCON_CALL_METHOD_FLAG(status, &service, model, "getreadconnectionservice");
+		if (status == FAILURE) {
+			zval_ptr_dtor(&values);
+			return FAILURE;
+		}
+
+		phalcon_mvc_model_manager_identity_key(key, Z_OBJCE_P(model), &service, &values);
+		if (phalcon_property_array_isset_fetch(&record, manager, SL("_identityMap"), key, PH_READONLY)) {
+			ZVAL_COPY(return_value, &record);
+		}
+		zval_ptr_dtor(&service);
+		zval_ptr_dtor(&values);
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Registers a hydrated record in the identity map using the key from phalcon_mvc_model_manager_identity_fetch
+ */
+void phalcon_mvc_model_manager_identity_store(zval *manager, zval *key, zval *record)
+{
+	if (Z_TYPE_P(manager) == IS_OBJECT && Z_TYPE_P(key) == IS_STRING && Z_TYPE_P(record) == IS_OBJECT) {
+		phalcon_mvc_model_manager_identity_scope(manager);
+		phalcon_update_property_array(manager, SL("_identityMap"), key, record);
+	}
+}
+
+/**
+ * Registers, or removes, a record in the identity map of its models manager using the current
+ * values of its primary key
+ */
+int phalcon_mvc_model_manager_identity_update(zval *record, int remove)
+{
+	zval manager = {}, key = {}, current = {};
+	int status;
+
+	if (phalcon_mvc_model_manager_identity_fetch(&current, &manager, &key, record, NULL) == FAILURE) {
+		status = FAILURE;
+	} else {
+		status = SUCCESS;
+		if (Z_TYPE(key) == IS_STRING) {
+			if (remove) {
+				phalcon_unset_property_array(&manager, SL("_identityMap"), &key);
+			} else {
+				phalcon_mvc_model_manager_identity_store(&manager, &key, record);
+			}
+		}
+	}
+
+	zval_ptr_dtor(&current);
+	zval_ptr_dtor(&manager);
+	zval_ptr_dtor(&key);
+	return status;
+}
+
+/**
+ * Forgets the records kept by the identity map after a rollback, they could hold changes that were
+ * rolled back. The models manager is the one registered in the DI of the object rolling back
+ */
+int phalcon_mvc_model_manager_identity_rollback(zval *object)
+{
+	zval dependency_injector = {}, service_name = {}, has = {}, manager = {};
+	int status;
+
+	if (!PHALCON_GLOBAL(orm).enable_identity_map) {
+		return SUCCESS;
+	}
+
+	PHALCON_CALL_METHOD_FLAG(status, &dependency_injector, object, "getdi");
+	if (status == SUCCESS && Z_TYPE(dependency_injector) == IS_OBJECT) {
+		ZVAL_STR(&service_name, IS(modelsManager));
+
+		PHALCON_CALL_METHOD_FLAG(status, &has, &dependency_injector, "has", &service_name);
+		if (status == SUCCESS && zend_is_true(&has)) {
+			PHALCON_CALL_METHOD_FLAG(status, &manager, &dependency_injector, "getshared", &service_name);
+			if (status == SUCCESS && Z_TYPE(manager) == IS_OBJECT && instanceof_function(Z_OBJCE(manager), phalcon_mvc_model_manager_ce)) {
+				phalcon_update_property_null(&manager, SL("_identityMap"));
+			}
+		}
+	}
+
+	zval_ptr_dtor(&dependency_injector);
+	zval_ptr_dtor(&has);
+	zval_ptr_dtor(&manager);
+	return status;
+}
+
+/**
+ * Returns a reusable object from the internal list
+ *
+ * @param string $modelName
+ * @param string $key
+ * @return object
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Manager, getReusableRecords){
+
+	zval *model_name, *key, reusable = {}, records = {};
+
+	phalcon_fetch_params(0, 2, 0, &model_name, &key);
+
+	phalcon_read_property(&reusable, getThis(), SL("_reusable"), PH_NOISY|PH_READONLY);
+	if (phalcon_array_isset_fetch(&records, &reusable, key, PH_READONLY)) {
+		RETURN_CTOR(&records);
+	}
+
+	RETURN_NULL();
+}
+
+/**
+ * Stores a reusable record in the internal list
+ *
+ * @param string $modelName
+ * @param string $key
+ * @param mixed $records
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Manager, setReusableRecords){
+
+	zval *model_name, *key, *records;
+
+	phalcon_fetch_params(0, 3, 0, &model_name, &key, &records);
+
+	phalcon_update_property_array(getThis(), SL("_reusable"), key, records);
+
+}
+
+/**
+ * Clears the internal reusable list
+ *
+ * @param
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Manager, clearReusableObjects){
+
+
+	phalcon_update_property_null(getThis(), SL("_reusable"));
+
+}
+
+/**
+ * Returns the record of a model kept in the identity map by the value(s) of its primary key,
+ * the identity map is enabled by the "identityMap" option of Phalcon\Mvc\Model::setup
+ *
+ *<code>
+ * \Phalcon\Mvc\Model::setup(array('identityMap' => true));
+ *
+ * $robot = Robots::findFirst(1);
+ * $robot === $modelsManager->getIdentity('Robots', 1); // true
+ * $robot === $modelsManager->getIdentity('Robots', 1, 'db'); // true
+ *</code>
+ *
+ * @param string $modelName
+ * @param mixed $key
+ * @param string $connectionService the service the record was read from, by default the read connection service of the model
+ * @return Phalcon\Mvc\ModelInterface
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Manager, getIdentity){
+
+	zval *model_name, *key, *connection_service = NULL, service = {}, connection_services = {}, entity_name = {}, values = {}, identity_key = {}, record = {};
+	zend_class_entry *ce;
+
+	phalcon_fetch_params(0, 2, 1, &model_name, &key, &connection_service);
+
+	if (!PHALCON_GLOBAL(orm).enable_identity_map) {
+		RETURN_NULL();
+	}
+
+	ce = phalcon_fetch_class(model_name, ZEND_FETCH_CLASS_DEFAULT | ZEND_FETCH_CLASS_SILENT);
+	if (!ce) {
+		RETURN_NULL();
+	}
+
+	if (Z_TYPE_P(key) == IS_ARRAY) {
+		ZVAL_COPY(&values, key);
+	} else {
+		array_init_size(&values, 1);
+		phalcon_array_append(&values, key, PH_COPY);
+	}
+
+	if (connection_service && Z_TYPE_P(connection_service) != IS_NULL) {
+		ZVAL_COPY(&service, connection_service);
+	} else {
+		/**
+		 * Same lookup as getReadConnectionService() without an instance of the model
+		 */
+		phalcon_read_property(&connection_services, getThis(), SL("_readConnectionServices"), PH_READONLY);
+		ZVAL_STR(&entity_name, zend_string_tolower(ce->name));
+		if (Z_TYPE(connection_services) != IS_ARRAY || !phalcon_array_isset_fetch(&service, &connection_services, &entity_name, PH_COPY)) {
+			phalcon_read_property(&service, getThis(), SL("_defaultReadConnectionService"), PH_COPY);
+			if (!PHALCON_IS_NOT_EMPTY(&service)) {
+				zval_ptr_dtor(&service);
+				phalcon_read_property(&service, getThis(), SL("_defaultConnectionService"), PH_COPY);
+			}
+		}
+		zval_ptr_dtor(&entity_name);
+	}
+
+	phalcon_mvc_model_manager_identity_scope(getThis());
+
+	phalcon_mvc_model_manager_identity_key(&identity_key, ce, &service, &values);
+	zval_ptr_dtor(&service);
+	zval_ptr_dtor(&values);
+
+	if (phalcon_property_array_isset_fetch(&record, getThis(), SL("_identityMap"), &identity_key, PH_READONLY)) {
+		RETVAL_COPY(&record);
+	}
+	zval_ptr_dtor(&identity_key);
+}
+
+/**
+ * Registers a record in the identity map, replacing the one kept with the same primary key
+ *
+ * @param Phalcon\Mvc\ModelInterface $record
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Manager, addIdentity){
+
+	zval *record;
+
+	phalcon_fetch_params(0, 1, 0, &record);
+
+	phalcon_mvc_model_manager_identity_update(record, 0);
+}
+
+/**
+ * Removes a record from the identity map
+ *
+ * @param Phalcon\Mvc\ModelInterface $record
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Manager, removeIdentity){
+
+	zval *record;
+
+	phalcon_fetch_params(0, 1, 0, &record);
+
+	phalcon_mvc_model_manager_identity_update(record, 1);
+}
+
+/**
+ * Removes every record from the identity map, or only the records of a model
+ *
+ * @param string $modelName
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Manager, clearIdentityMap){
+
+	zval *model_name = NULL, identity_map = {}, records = {}, *record;
+	zend_class_entry *ce;
+	zend_string *str_key;
+
+	phalcon_fetch_params(0, 0, 1, &model_name);
+
+	if (!model_name || Z_TYPE_P(model_name) == IS_NULL) {
+		phalcon_update_property_null(getThis(), SL("_identityMap"));
+		return;
+	}
+
+	phalcon_mvc_model_manager_identity_scope(getThis());
+
+	phalcon_read_property(&identity_map, getThis(), SL("_identityMap"), PH_READONLY);
+	if (Z_TYPE(identity_map) != IS_ARRAY) {
+		return;
+	}
+
+	ce = phalcon_fetch_class(model_name, ZEND_FETCH_CLASS_DEFAULT | ZEND_FETCH_CLASS_SILENT);
+	if (!ce) {
+		return;
+	}
+
+	array_init(&records);
+	ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL(identity_map), str_key, record) {
+		if (!str_key) {
+			continue;
+		}
+		if (ZSTR_LEN(str_key) > ZSTR_LEN(ce->name) && ZSTR_VAL(str_key)[ZSTR_LEN(ce->name)] == ':'
+			&& !memcmp(ZSTR_VAL(str_key), ZSTR_VAL(ce->name), ZSTR_LEN(ce->name))) {
+			continue;
+		}
+		phalcon_array_update_string(&records, str_key, record, PH_COPY);
+	} ZEND_HASH_FOREACH_END();
+
+	phalcon_update_property(getThis(), SL("_identityMap"), &records);
+	zval_ptr_dtor(&records);
+}
+
+/**
+ * Whether the models manager is collecting the records saved into a unit of work
+ */
+int phalcon_mvc_model_manager_uow_active(zval *manager)
+{
+	zval pending = {};
+
+	if (Z_TYPE_P(manager) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(manager), phalcon_mvc_model_manager_ce)) {
+		return 0;
+	}
+
+	phalcon_read_property(&pending, manager, SL("_unitOfWork"), PH_READONLY);
+	return Z_TYPE(pending) == IS_ARRAY;
+}
+
+/**
+ * Defers the write of a record validated by save() to the flush of the unit of work, a record saved
+ * twice keeps its place and the changes of both saves
+ */
+void phalcon_mvc_model_manager_uow_add(zval *manager, zval *record, zval *exists, zval *connection, zval *fields)
+{
+	zval entry = {}, handle = {};
+
+	array_init_size(&entry, 4);
+	phalcon_array_append(&entry, record, PH_COPY);
+	add_next_index_bool(&entry, zend_is_true(exists));
+	phalcon_array_append(&entry, connection, PH_COPY);
+	if (Z_TYPE_P(fields) == IS_ARRAY) {
+		phalcon_array_append(&entry, fields, PH_COPY);
+	} else {
+		add_next_index_null(&entry);
+	}
+
+	ZVAL_LONG(&handle, Z_OBJ_HANDLE_P(record));
+	phalcon_update_property_array(manager, SL("_unitOfWork"), &handle, &entry);
+	zval_ptr_dtor(&entry);
+}
+
+/**
+ * First value of the primary key or the unique params of a record
+ */
+static zval *phalcon_mvc_model_manager_uow_first(zval *arr)
+{
+	HashPosition pos;
+
+	zend_hash_internal_pointer_reset_ex(Z_ARRVAL_P(arr), &pos);
+	return zend_hash_get_current_data_ex(Z_ARRVAL_P(arr), &pos);
+}
+
+/**
+ * Builds the key grouping the deferred updates one statement can write: same model, connection and
+ * changed columns, a single column primary key that is not changed and no raw values
+ */
+static int phalcon_mvc_model_manager_uow_group(zval *return_value, zval *record, zval *connection, zval *fields)
+{
+	zval primary_keys = {}, unique_params = {}, *primary_key, *field;
+	smart_str key = {0};
+	zend_string *str_key;
+	ulong idx;
+	int status, batchable = 1;
+
+	ZVAL_NULL(return_value);
+
+	if (Z_TYPE_P(fields) != IS_ARRAY || !zend_hash_num_elements(Z_ARRVAL_P(fields))) {
+		return SUCCESS;
+	}
+
+	PHALCON_CALL_METHOD_FLAG(status, &primary_keys, record, "getprimarykeyattributes");
+	if (status == FAILURE) {
+		return FAILURE;
+	}
+
+	PHALCON_CALL_METHOD_FLAG(status, &unique_params, record, "getuniqueparams");
+	if (status == FAILURE) {
+		zval_ptr_dtor(&primary_keys);
+		return FAILURE;
+	}
+
+	if (Z_TYPE(primary_keys) != IS_ARRAY || zend_hash_num_elements(Z_ARRVAL(primary_keys)) != 1
+		|| Z_TYPE(unique_params) != IS_ARRAY || zend_hash_num_elements(Z_ARRVAL(unique_params)) != 1
+	) {
+		batchable = 0;
+	} else {
+		primary_key = phalcon_mvc_model_manager_uow_first(&primary_keys);
+		if (phalcon_array_isset(fields, primary_key)) {
+			batchable = 0;
+		}
+	}
+	zval_ptr_dtor(&primary_keys);
+	zval_ptr_dtor(&unique_params);
+
+	if (!batchable) {
+		return SUCCESS;
+	}
+
+	smart_str_append(&key, Z_OBJCE_P(record)->name);
+	smart_str_appendc(&key, ':');
+	smart_str_append_long(&key, Z_OBJ_HANDLE_P(connection));
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(fields), idx, str_key, field) {
+		zval *value = zend_hash_index_find(Z_ARRVAL_P(field), 1);
+		if (value && Z_TYPE_P(value) == IS_OBJECT && instanceof_function(Z_OBJCE_P(value), phalcon_db_rawvalue_ce)) {
+			smart_str_free(&key);
+			return SUCCESS;
+		}
+
+		smart_str_appendc(&key, ':');
+		if (str_key) {
+			smart_str_append(&key, str_key);
+		} else {
+			smart_str_append_long(&key, idx);
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	smart_str_0(&key);
+	ZVAL_STR(return_value, key.s);
+	return SUCCESS;
+}
+
+/**
+ * Writes deferred updates of the same group with a single statement:
+ *
+ * UPDATE t SET c = CASE pk WHEN ? THEN ? WHEN ? THEN ? ELSE c END, ... WHERE pk IN (?, ?)
+ *
+ * The ELSE branch also gives the CASE the type of the column, which PostgreSQL cannot infer from
+ * untyped placeholders
+ */
+static int phalcon_mvc_model_manager_uow_update(zval *return_value, zval *entries, uint32_t offset, uint32_t count)
+{
+	zval *first, record = {}, connection = {}, fields = {}, primary_keys = {}, source = {}, schema = {}, table = {};
+	zval escaped_table = {}, escaped_key = {}, params = {}, types = {}, sql = {}, *field, *entry;
+	smart_str update = {0}, where = {0};
+	zend_string *str_key;
+	ulong idx;
+	uint32_t i;
+	int status = FAILURE, separator = 0;
+
+	first = zend_hash_index_find(Z_ARRVAL_P(entries), offset);
+	phalcon_array_fetch_long(&record, first, 0, PH_NOISY|PH_READONLY);
+	phalcon_array_fetch_long(&connection, first, 2, PH_NOISY|PH_READONLY);
+	phalcon_array_fetch_long(&fields, first, 3, PH_NOISY|PH_READONLY);
+
+	array_init(&params);
+	array_init(&types);
+
+	PHALCON_CALL_METHOD_FLAG(status, &primary_keys, &record, "getprimarykeyattributes");
+	if (status == FAILURE) {
+		goto end;
+	}
+
+	PHALCON_CALL_METHOD_FLAG(status, &source, &record, "getsource");
+	if (status == FAILURE) {
+		goto end;
+	}
+
+	PHALCON_CALL_METHOD_FLAG(status, &schema, &record, "getschema");
+	if (status == FAILURE) {
+		goto end;
+	}
+
+	if (PHALCON_IS_NOT_EMPTY(&schema)) {
+		array_init_size(&table, 2);
+		phalcon_array_append(&table, &schema, PH_COPY);
+		phalcon_array_append(&table, &source, PH_COPY);
+	} else {
+		ZVAL_COPY(&table, &source);
+	}
+
+	PHALCON_CALL_METHOD_FLAG(status, &escaped_table, &connection, "escapeidentifier", &table);
+	if (status == FAILURE) {
+		goto end;
+	}
+
+	PHALCON_CALL_METHOD_FLAG(status, &escaped_key, &connection, "escapeidentifier", phalcon_mvc_model_manager_uow_first(&primary_keys));
+	if (status == FAILURE) {
+		goto end;
+	}
+
+	smart_str_appends(&update, "UPDATE ");
+	smart_str_appendl(&update, Z_STRVAL(escaped_table), Z_STRLEN(escaped_table));
+	smart_str_appends(&update, " SET ");
+
+	ZEND_HASH_FOREACH_KEY(Z_ARRVAL(fields), idx, str_key) {
+		zval column = {}, escaped_column = {};
+
+		if (str_key) {
+			ZVAL_STR(&column, str_key);
+		} else {
+			ZVAL_LONG(&column, idx);
+		}
+
+		PHALCON_CALL_METHOD_FLAG(status, &escaped_column, &connection, "escapeidentifier", &column);
+		if (status == FAILURE) {
+			goto end;
+		}
+
+		if (separator) {
+			smart_str_appends(&update, ", ");
+		}
+		separator = 1;
+		smart_str_appendl(&update, Z_STRVAL(escaped_column), Z_STRLEN(escaped_column));
+		smart_str_appends(&update, " = CASE ");
+		smart_str_appendl(&update, Z_STRVAL(escaped_key), Z_STRLEN(escaped_key));
+
+		for (i = offset; i < offset + count; i++) {
+			zval entry_record = {}, entry_fields = {}, unique_params = {}, unique_types = {}, *value, *type, *key_value, *key_type;
+
+			entry = zend_hash_index_find(Z_ARRVAL_P(entries), i);
+			phalcon_array_fetch_long(&entry_record, entry, 0, PH_NOISY|PH_READONLY);
+			phalcon_array_fetch_long(&entry_fields, entry, 3, PH_NOISY|PH_READONLY);
+
+			phalcon_read_property(&unique_params, &entry_record, SL("_uniqueParams"), PH_READONLY);
+			phalcon_read_property(&unique_types, &entry_record, SL("_uniqueTypes"), PH_READONLY);
+			key_value = phalcon_mvc_model_manager_uow_first(&unique_params);
+			key_type = Z_TYPE(unique_types) == IS_ARRAY ? phalcon_mvc_model_manager_uow_first(&unique_types) : NULL;
+
+			field = str_key ? zend_hash_find(Z_ARRVAL(entry_fields), str_key) : zend_hash_index_find(Z_ARRVAL(entry_fields), idx);
+			value = zend_hash_index_find(Z_ARRVAL_P(field), 1);
+			type = zend_hash_index_find(Z_ARRVAL_P(field), 2);
+
+			smart_str_appends(&update, " WHEN ? THEN ?");
+
+			if (key_type) {
+				phalcon_array_update_long(&types, zend_hash_num_elements(Z_ARRVAL(params)), key_type, PH_COPY);
+			}
+			phalcon_array_append(&params, key_value, PH_COPY);
+
+			if (Z_TYPE_P(type) == IS_NULL) {
+				phalcon_array_update_long_long(&types, zend_hash_num_elements(Z_ARRVAL(params)), PHALCON_DB_COLUMN_BIND_PARAM_NULL, 0);
+			} else {
+				phalcon_array_update_long(&types, zend_hash_num_elements(Z_ARRVAL(params)), type, PH_COPY);
+			}
+			phalcon_array_append(&params, value, PH_COPY);
+		}
+
+		smart_str_appends(&update, " ELSE ");
+		smart_str_appendl(&update, Z_STRVAL(escaped_column), Z_STRLEN(escaped_column));
+		smart_str_appends(&update, " END");
+		zval_ptr_dtor(&escaped_column);
+	} ZEND_HASH_FOREACH_END();
+
+	smart_str_appends(&where, " WHERE ");
+	smart_str_appendl(&where, Z_STRVAL(escaped_key), Z_STRLEN(escaped_key));
+	smart_str_appends(&where, " IN (");
+
+	for (i = offset; i < offset + count; i++) {
+		zval entry_record = {}, unique_params = {}, unique_types = {}, *key_type;
+
+		entry = zend_hash_index_find(Z_ARRVAL_P(entries), i);
+		phalcon_array_fetch_long(&entry_record, entry, 0, PH_NOISY|PH_READONLY);
+		phalcon_read_property(&unique_params, &entry_record, SL("_uniqueParams"), PH_READONLY);
+		phalcon_read_property(&unique_types, &entry_record, SL("_uniqueTypes"), PH_READONLY);
+		key_type = Z_TYPE(unique_types) == IS_ARRAY ? phalcon_mvc_model_manager_uow_first(&unique_types) : NULL;
+
+		smart_str_appends(&where, i == offset ? "?" : ", ?");
+
+		if (key_type) {
+			phalcon_array_update_long(&types, zend_hash_num_elements(Z_ARRVAL(params)), key_type, PH_COPY);
+		}
+		phalcon_array_append(&params, phalcon_mvc_model_manager_uow_first(&unique_params), PH_COPY);
+	}
+
+	smart_str_appendc(&where, ')');
+	smart_str_append_smart_str(&update, &where);
+	smart_str_0(&update);
+	ZVAL_STR(&sql, update.s);
+	update.s = NULL;
+
+	PHALCON_CALL_METHOD_FLAG(status, return_value, &connection, "execute", &sql, &params, &types);
+
+end:
+	smart_str_free(&update);
+	smart_str_free(&where);
+	zval_ptr_dtor(&sql);
+	zval_ptr_dtor(&params);
+	zval_ptr_dtor(&types);
+	zval_ptr_dtor(&primary_keys);
+	zval_ptr_dtor(&source);
+	zval_ptr_dtor(&schema);
+	zval_ptr_dtor(&table);
+	zval_ptr_dtor(&escaped_table);
+	zval_ptr_dtor(&escaped_key);
+	return status;
+}
+
+/**
+ * Rolls back the transactions of a failed flush, keeping the exception that made it fail. The records
+ * kept by the identity map could hold changes that were rolled back
+ */
+static void phalcon_mvc_model_manager_uow_rollback(zval *manager, zval *connections)
+{
+	zend_object *exception = EG(exception);
+	zval *connection;
+
+	EG(exception) = NULL;
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(connections), connection) {
+		phalcon_call_method(NULL, connection, "rollback", 0, NULL);
+		if (EG(exception)) {
+			zend_object_release(EG(exception));
+			EG(exception) = NULL;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	if (PHALCON_GLOBAL(orm).enable_identity_map) {
+		phalcon_update_property_null(manager, SL("_identityMap"));
+	}
+
+	EG(exception) = exception;
+}
+
+/**
+ * Starts a unit of work, until flush() the records saved are validated and their behaviors run but
+ * the statements writing them are deferred
+ *
+ *<code>
+ * $modelsManager->beginUnitOfWork();
+ *
+ * foreach (Robots::find() as $robot) {
+ *     $robot->price *= 1.1;
+ *     $robot->save();
+ * }
+ *
+ * $modelsManager->flush();
+ *</code>
+ *
+ * @return Phalcon\Mvc\Model\Manager
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Manager, beginUnitOfWork){
+
+	zval pending = {};
+
+	phalcon_read_property(&pending, getThis(), SL("_unitOfWork"), PH_READONLY);
+	if (Z_TYPE(pending) != IS_ARRAY) {
+		phalcon_update_property_empty_array(getThis(), SL("_unitOfWork"));
+	}
+
+	RETURN_THIS();
+}
+
+/**
+ * Checks whether a unit of work was started
+ *
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Manager, isInUnitOfWork){
+
+	RETURN_BOOL(phalcon_mvc_model_manager_uow_active(getThis()));
+}
+
+/**
+ * Restores the identity of the records inserted by a flush that was rolled back
+ */
+static void phalcon_mvc_model_manager_uow_restore(zval *identities)
+{
+	zval *identity;
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(identities), identity) {
+		zval record = {}, field = {}, value = {};
+
+		phalcon_array_fetch_long(&record, identity, 0, PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_long(&field, identity, 1, PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_long(&value, identity, 2, PH_NOISY|PH_READONLY);
+		phalcon_update_property_zval_zval(&record, &field, &value);
+	} ZEND_HASH_FOREACH_END();
+}
+
+/**
+ * Writes the records saved since beginUnitOfWork() inside one transaction per connection and ends the
+ * unit of work. Updates of the same model changing the same columns are grouped into multi-row
+ * UPDATE statements, the other records are written one by one. The saves are completed (after*
+ * events, snapshots, identity map) once every transaction is committed
+ *
+ * On failure the transactions are rolled back, the records are left as they were before flush() and
+ * the unit of work keeps its deferred writes, false is returned. A connection already under a
+ * transaction is not committed nor rolled back, that is left to the code that began it
+ *
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Manager, flush){
+
+	zval pending = {}, connections = {}, begun = {}, groups = {}, keys = {}, results = {}, identities = {};
+	zval *entry, *connection, *group;
+	zend_ulong handle;
+	uint32_t offset, count;
+	int status = SUCCESS, success = 1;
+
+	phalcon_read_property(&pending, getThis(), SL("_unitOfWork"), PH_COPY);
+
+	/* The unit of work is over, records saved by the after* events are written right away */
+	phalcon_update_property_null(getThis(), SL("_unitOfWork"));
+
+	if (Z_TYPE(pending) != IS_ARRAY || !zend_hash_num_elements(Z_ARRVAL(pending))) {
+		zval_ptr_dtor(&pending);
+		RETURN_TRUE;
+	}
+
+	array_init(&connections);
+	array_init(&begun);
+	array_init(&groups);
+	array_init(&keys);
+	array_init(&results);
+	array_init(&identities);
+
+	/**
+	 * Group the updates that can share a statement
+	 */
+	ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL(pending), handle, entry) {
+		zval record = {}, connection = {}, fields = {}, key = {};
+
+		phalcon_array_fetch_long(&record, entry, 0, PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_long(&connection, entry, 2, PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_long(&fields, entry, 3, PH_NOISY|PH_READONLY);
+
+		phalcon_array_update_long(&connections, Z_OBJ_HANDLE(connection), &connection, PH_COPY);
+
+		if (phalcon_mvc_model_manager_uow_group(&key, &record, &connection, &fields) == FAILURE) {
+			status = FAILURE;
+			break;
+		}
+
+		if (Z_TYPE(key) == IS_STRING) {
+			phalcon_array_update_long(&keys, handle, &key, PH_COPY);
+			phalcon_array_append_multi_2(&groups, &key, entry, PH_COPY);
+		}
+		zval_ptr_dtor(&key);
+	} ZEND_HASH_FOREACH_END();
+
+	if (status == FAILURE) {
+		goto rollback;
+	}
+
+	ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL(connections), handle, connection) {
+		zval under_transaction = {};
+
+		PHALCON_CALL_METHOD_FLAG(status, &under_transaction, connection, "isundertransaction");
+		if (status == FAILURE) {
+			goto rollback;
+		}
+
+		if (zend_is_true(&under_transaction)) {
+			continue;
+		}
+
+		PHALCON_CALL_METHOD_FLAG(status, NULL, connection, "begin");
+		if (status == FAILURE) {
+			goto rollback;
+		}
+		phalcon_array_update_long(&begun, handle, connection, PH_COPY);
+	} ZEND_HASH_FOREACH_END();
+
+	/**
+	 * Inserts and the updates that cannot be grouped are written in the order they were saved
+	 */
+	ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL(pending), handle, entry) {
+		zval record = {}, exists = {}, connection = {}, key = {}, list = {}, result = {};
+
+		if (phalcon_array_isset_fetch_long(&key, &keys, handle, PH_READONLY)
+			&& phalcon_array_isset_fetch(&list, &groups, &key, PH_READONLY)
+			&& zend_hash_num_elements(Z_ARRVAL(list)) > 1
+		) {
+			phalcon_array_update_long_bool(&results, handle, 1, 0);
+			continue;
+		}
+
+		phalcon_array_fetch_long(&record, entry, 0, PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_long(&exists, entry, 1, PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_long(&connection, entry, 2, PH_NOISY|PH_READONLY);
+
+		/**
+		 * An insert sets the identity of the record, which is put back if the flush fails
+		 */
+		if (!zend_is_true(&exists)) {
+			zval identity_field = {}, identity = {}, value = {};
+
+			PHALCON_CALL_METHOD_FLAG(status, &identity_field, &record, "getidentityfield");
+			if (status == FAILURE) {
+				goto rollback;
+			}
+
+			if (Z_TYPE(identity_field) == IS_STRING) {
+				if (!phalcon_property_isset_fetch_zval(&value, &record, &identity_field, PH_READONLY)) {
+					ZVAL_NULL(&value);
+				}
+
+				array_init_size(&identity, 3);
+				phalcon_array_append(&identity, &record, PH_COPY);
+				phalcon_array_append(&identity, &identity_field, PH_COPY);
+				phalcon_array_append(&identity, &value, PH_COPY);
+				phalcon_array_append(&identities, &identity, 0);
+			}
+			zval_ptr_dtor(&identity_field);
+		}
+
+		status = phalcon_mvc_model_uow_write(&result, &record, &exists, &connection);
+		success = status == SUCCESS && zend_is_true(&result);
+		if (!success) {
+			zval_ptr_dtor(&result);
+			goto rollback;
+		}
+		phalcon_array_update_long(&results, handle, &result, 0);
+	} ZEND_HASH_FOREACH_END();
+
+	/**
+	 * The grouped updates are written in chunks
+	 */
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(groups), group) {
+		uint32_t size = zend_hash_num_elements(Z_ARRVAL_P(group));
+
+		if (size < 2) {
+			continue;
+		}
+
+		for (offset = 0; offset < size; offset += PHALCON_MVC_MODEL_MANAGER_UOW_CHUNK) {
+			zval result = {};
+
+			count = MIN(size - offset, PHALCON_MVC_MODEL_MANAGER_UOW_CHUNK);
+			status = phalcon_mvc_model_manager_uow_update(&result, group, offset, count);
+			success = status == SUCCESS && zend_is_true(&result);
+			zval_ptr_dtor(&result);
+			if (!success) {
+				goto rollback;
+			}
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(begun), connection) {
+		PHALCON_CALL_METHOD_FLAG(status, NULL, connection, "commit");
+		if (status == FAILURE) {
+			goto rollback;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	/**
+	 * Everything is committed, each record completes its save in the order it was saved
+	 */
+	RETVAL_TRUE;
+
+	ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL(pending), handle, entry) {
+		zval record = {}, exists = {}, connection = {}, result = {}, *written;
+
+		phalcon_array_fetch_long(&record, entry, 0, PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_long(&exists, entry, 1, PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_long(&connection, entry, 2, PH_NOISY|PH_READONLY);
+		written = zend_hash_index_find(Z_ARRVAL(results), handle);
+
+		status = phalcon_mvc_model_uow_finish(&result, &record, &exists, &connection, written);
+		if (status == FAILURE) {
+			break;
+		}
+		if (!zend_is_true(&result)) {
+			RETVAL_FALSE;
+		}
+		zval_ptr_dtor(&result);
+	} ZEND_HASH_FOREACH_END();
+
+	goto end;
+
+rollback:
+	phalcon_mvc_model_manager_uow_rollback(getThis(), &begun);
+	phalcon_mvc_model_manager_uow_restore(&identities);
+	phalcon_update_property(getThis(), SL("_unitOfWork"), &pending);
+	RETVAL_FALSE;
+
+end:
+	zval_ptr_dtor(&pending);
+	zval_ptr_dtor(&connections);
+	zval_ptr_dtor(&begun);
+	zval_ptr_dtor(&groups);
+	zval_ptr_dtor(&keys);
+	zval_ptr_dtor(&results);
+	zval_ptr_dtor(&identities);
+}
+
+/**
+ * Ends the unit of work discarding the writes it deferred, the records keep their unsaved changes
+ *
+ * @return Phalcon\Mvc\Model\Manager
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Manager, clearUnitOfWork){
+
+	phalcon_update_property_null(getThis(), SL("_unitOfWork"));
 
+	RETURN_THIS();
 }
 
 /**
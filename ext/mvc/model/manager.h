@@ -22,8 +22,18 @@
 
 #include "php_phalcon.h"
 
+#define PHALCON_MVC_MODEL_MANAGER_UOW_CHUNK 200
+#define PHALCON_MVC_MODEL_MANAGER_EAGER_CHUNK 500
+
 extern zend_class_entry *phalcon_mvc_model_manager_ce;
 
+int phalcon_mvc_model_manager_identity_fetch(zval *return_value, zval *manager, zval *key, zval *model, zval *row);
+void phalcon_mvc_model_manager_identity_store(zval *manager, zval *key, zval *record);
+int phalcon_mvc_model_manager_identity_update(zval *record, int remove);
+int phalcon_mvc_model_manager_identity_rollback(zval *object);
+int phalcon_mvc_model_manager_uow_active(zval *manager);
+void phalcon_mvc_model_manager_uow_add(zval *manager, zval *record, zval *exists, zval *connection, zval *fields);
+
 PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Manager);
 
 #endif /* PHALCON_MVC_MODEL_MANAGER_H */
@@ -21,6 +21,8 @@
 #include "mvc/model/metadata/strategy/introspection.h"
 #include "mvc/model/exception.h"
 #include "mvc/modelinterface.h"
+#include "mvc/model.h"
+#include "db/column.h"
 #include "diinterface.h"
 #include "di/injectable.h"
 
@@ -54,6 +56,44 @@
  */
 zend_class_entry *phalcon_mvc_model_metadata_ce;
 
+/**
+ * Returns the offset of the slot of a declared property, -1 if it must be written through the handlers
+ */
+static zend_long phalcon_mvc_model_metadata_property_offset(zend_class_entry *ce, zval *attribute)
+{
+	zend_property_info *property_info;
+
+	if (Z_TYPE_P(attribute) != IS_STRING) {
+		return -1;
+	}
+
+	property_info = zend_hash_find_ptr(&ce->properties_info, Z_STR_P(attribute));
+	if (!property_info || (property_info->flags & ZEND_ACC_STATIC)) {
+		return -1;
+	}
+#ifdef ZEND_ACC_SHADOW
+	if (property_info->flags & ZEND_ACC_SHADOW) {
+		return -1;
+	}
+#endif
+#if PHP_VERSION_ID >= 70400
+	if (ZEND_TYPE_IS_SET(property_info->type)) {
+		return -1;
+	}
+#endif
+	return property_info->offset;
+}
+
+/**
+ * Checks if a method of the model is still the one implemented by Phalcon\Mvc\Model
+ */
+static int phalcon_mvc_model_metadata_is_native_method(zend_class_entry *ce, const char *method_name, size_t method_length)
+{
+	zend_function *fbc = zend_hash_str_find_ptr(&ce->function_table, method_name, method_length);
+
+	return fbc && fbc->type == ZEND_INTERNAL_FUNCTION && fbc->common.scope == phalcon_mvc_model_ce;
+}
+
 PHP_METHOD(Phalcon_Mvc_Model_MetaData, _initialize);
 PHP_METHOD(Phalcon_Mvc_Model_MetaData, setStrategy);
 PHP_METHOD(Phalcon_Mvc_Model_MetaData, getStrategy);
@@ -93,6 +133,7 @@ PHP_METHOD(Phalcon_Mvc_Model_MetaData, hasRealAttribute);
 PHP_METHOD(Phalcon_Mvc_Model_MetaData, getRealAttribute);
 PHP_METHOD(Phalcon_Mvc_Model_MetaData, isEmpty);
 PHP_METHOD(Phalcon_Mvc_Model_MetaData, reset);
+PHP_METHOD(Phalcon_Mvc_Model_MetaData, getHydrationPlan);
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_metadata_getcachekey, 0, 0, 3)
 	ZEND_ARG_INFO(0, model)
@@ -100,6 +141,11 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_metadata_getcachekey, 0, 0, 3)
 	ZEND_ARG_INFO(0, schema)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_metadata_gethydrationplan, 0, 0, 1)
+	ZEND_ARG_INFO(0, model)
+	ZEND_ARG_INFO(0, columnMap)
+ZEND_END_ARG_INFO()
+
 static const zend_function_entry phalcon_mvc_model_metadata_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Model_MetaData, _initialize, NULL, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Mvc_Model_MetaData, setStrategy, arginfo_phalcon_mvc_model_metadatainterface_setstrategy, ZEND_ACC_PUBLIC)
@@ -140,6 +186,7 @@ static const zend_function_entry phalcon_mvc_model_metadata_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Model_MetaData, getRealAttribute, arginfo_phalcon_mvc_model_metadatainterface_getrealattribute, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_MetaData, isEmpty, arginfo_phalcon_mvc_model_metadatainterface_isempty, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_MetaData, reset, arginfo_phalcon_mvc_model_metadatainterface_reset, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_MetaData, getHydrationPlan, arginfo_phalcon_mvc_model_metadata_gethydrationplan, ZEND_ACC_PUBLIC)
 	PHP_FE_END
 };
 
@@ -153,6 +200,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_MetaData){
 	zend_declare_property_null(phalcon_mvc_model_metadata_ce, SL("_strategy"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_metadata_ce, SL("_metaData"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_metadata_ce, SL("_columnMap"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_metadata_ce, SL("_hydrationPlans"), ZEND_ACC_PROTECTED);
 
 	zend_declare_class_constant_long(phalcon_mvc_model_metadata_ce, SL("MODELS_ATTRIBUTES"),               PHALCON_MVC_MODEL_METADATA_MODELS_ATTRIBUTES              );
 	zend_declare_class_constant_long(phalcon_mvc_model_metadata_ce, SL("MODELS_PRIMARY_KEY"),              PHALCON_MVC_MODEL_METADATA_MODELS_PRIMARY_KEY             );
@@ -1413,4 +1461,189 @@ PHP_METHOD(Phalcon_Mvc_Model_MetaData, reset){
 
 	phalcon_update_property_empty_array(getThis(), SL("_metaData"));
 	phalcon_update_property_empty_array(getThis(), SL("_columnMap"));
+	phalcon_update_property_empty_array(getThis(), SL("_hydrationPlans"));
+}
+
+/**
+ * Returns the plan used to hydrate records of a model from rows: every column with its attribute,
+ * data type and property slot, plus the parts of the unique key built for every record.
+ * Without a primary key, or if the model changes how it is built, "primaryKeys" is false
+ * Plans are kept by the meta-data until it is reset
+ *
+ *<code>
+ *	print_r($metaData->getHydrationPlan(new Robots(), $metaData->getColumnMap(new Robots())));
+ *</code>
+ *
+ * @param Phalcon\Mvc\ModelInterface $model
+ * @param array $columnMap
+ * @return array
+ */
+PHP_METHOD(Phalcon_Mvc_Model_MetaData, getHydrationPlan){
+
+	zval *model, *column_map = NULL, table = {}, schema = {}, key = {}, plan = {}, cached_class = {}, cached_column_map = {};
+	zval data_types = {}, attributes = {}, model_column_map = {}, primary_keys = {}, bind_types = {}, fields = {}, pk_parts = {};
+	zval *attribute, *field;
+	zend_class_entry *ce;
+	zend_string *str_key;
+	int convert = 0, native;
+
+	phalcon_fetch_params(1, 1, 1, &model, &column_map);
+	PHALCON_MM_VERIFY_INTERFACE_EX(model, phalcon_mvc_modelinterface_ce, phalcon_mvc_model_exception_ce);
+
+	if (!column_map) {
+		column_map = &PHALCON_GLOBAL(z_null);
+	}
+
+	ce = Z_OBJCE_P(model);
+
+	PHALCON_MM_CALL_METHOD(&table, model, "getsource");
+	PHALCON_MM_ADD_ENTRY(&table);
+	PHALCON_MM_CALL_METHOD(&schema, model, "getschema");
+	PHALCON_MM_ADD_ENTRY(&schema);
+
+	PHALCON_MM_CALL_METHOD(&key, getThis(), "getcachekey", model, &table, &schema);
+	PHALCON_MM_ADD_ENTRY(&key);
+
+	/**
+	 * A plan is only valid for the same class and column map
+	 */
+	if (phalcon_property_array_isset_fetch(&plan, getThis(), SL("_hydrationPlans"), &key, PH_READONLY)) {
+		phalcon_array_fetch_str(&cached_class, &plan, SL("class"), PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_str(&cached_column_map, &plan, SL("columnMap"), PH_NOISY|PH_READONLY);
+		if (zend_string_equals(Z_STR(cached_class), ce->name) && PHALCON_IS_IDENTICAL(&cached_column_map, column_map)) {
+			RETURN_MM_CTOR(&plan);
+		}
+	}
+
+	PHALCON_MM_CALL_METHOD(&data_types, getThis(), "getdatatypes", model);
+	PHALCON_MM_ADD_ENTRY(&data_types);
+
+	array_init(&fields);
+	PHALCON_MM_ADD_ENTRY(&fields);
+
+	if (Z_TYPE_P(column_map) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(column_map), str_key, attribute) {
+			zval column = {}, type = {}, entry = {};
+			if (!str_key) {
+				continue;
+			}
+			ZVAL_STR(&column, str_key);
+			if (!phalcon_array_isset_fetch(&type, &data_types, &column, PH_READONLY) || Z_TYPE(type) != IS_LONG) {
+				ZVAL_NULL(&type);
+			}
+
+			array_init_size(&entry, 3);
+			phalcon_array_append(&entry, attribute, PH_COPY);
+			phalcon_array_append(&entry, &type, PH_COPY);
+			add_next_index_long(&entry, phalcon_mvc_model_metadata_property_offset(ce, attribute));
+			phalcon_array_update(&fields, &column, &entry, 0);
+		} ZEND_HASH_FOREACH_END();
+	} else {
+		PHALCON_MM_CALL_METHOD(&attributes, getThis(), "getattributes", model);
+		PHALCON_MM_ADD_ENTRY(&attributes);
+		if (Z_TYPE(attributes) == IS_ARRAY) {
+			ZEND_HASH_FOREACH_VAL(Z_ARRVAL(attributes), attribute) {
+				zval type = {}, entry = {};
+				if (Z_TYPE_P(attribute) != IS_STRING) {
+					continue;
+				}
+				if (!phalcon_array_isset_fetch(&type, &data_types, attribute, PH_READONLY) || Z_TYPE(type) != IS_LONG) {
+					ZVAL_NULL(&type);
+				}
+
+				array_init_size(&entry, 3);
+				phalcon_array_append(&entry, attribute, PH_COPY);
+				phalcon_array_append(&entry, &type, PH_COPY);
+				add_next_index_long(&entry, phalcon_mvc_model_metadata_property_offset(ce, attribute));
+				phalcon_array_update(&fields, attribute, &entry, 0);
+			} ZEND_HASH_FOREACH_END();
+		}
+	}
+
+	if (Z_TYPE(data_types) == IS_ARRAY) {
+		zval *type;
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(data_types), type) {
+			if (Z_TYPE_P(type) == IS_LONG) {
+				switch (Z_LVAL_P(type)) {
+					case PHALCON_DB_COLUMN_TYPE_JSON:
+					case PHALCON_DB_COLUMN_TYPE_BYTEA:
+					case PHALCON_DB_COLUMN_TYPE_ARRAY:
+					case PHALCON_DB_COLUMN_TYPE_INT_ARRAY:
+						convert = 1;
+						break;
+					default:
+						break;
+				}
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	/**
+	 * Records are only hydrated natively if the model keeps the standard way to set
+	 * the state, the snapshot and the unique key
+	 */
+	native = phalcon_mvc_model_metadata_is_native_method(ce, SL("setdirtystate"))
+		&& phalcon_mvc_model_metadata_is_native_method(ce, SL("setsnapshotdata"))
+		&& phalcon_mvc_model_metadata_is_native_method(ce, SL("build"))
+		&& phalcon_mvc_model_metadata_is_native_method(ce, SL("_rebuild"))
+		&& phalcon_mvc_model_metadata_is_native_method(ce, SL("getprimarykeyattributes"))
+		&& phalcon_mvc_model_metadata_is_native_method(ce, SL("getbindtypes"))
+		&& phalcon_mvc_model_metadata_is_native_method(ce, SL("getcolumnmap"));
+
+	ZVAL_FALSE(&pk_parts);
+	if (native) {
+		PHALCON_MM_CALL_METHOD(&primary_keys, getThis(), "getprimarykeyattributes", model);
+		PHALCON_MM_ADD_ENTRY(&primary_keys);
+		PHALCON_MM_CALL_METHOD(&bind_types, getThis(), "getbindtypes", model);
+		PHALCON_MM_ADD_ENTRY(&bind_types);
+		PHALCON_MM_CALL_METHOD(&model_column_map, getThis(), "getcolumnmap", model);
+		PHALCON_MM_ADD_ENTRY(&model_column_map);
+
+		if (Z_TYPE(primary_keys) == IS_ARRAY && zend_hash_num_elements(Z_ARRVAL(primary_keys)) > 0) {
+			array_init(&pk_parts);
+			PHALCON_MM_ADD_ENTRY(&pk_parts);
+
+			ZEND_HASH_FOREACH_VAL(Z_ARRVAL(primary_keys), field) {
+				zval attribute_field = {}, bind_key = {}, condition = {}, null_condition = {}, type = {}, part = {};
+				if (Z_TYPE(model_column_map) == IS_ARRAY) {
+					if (!phalcon_array_isset_fetch(&attribute_field, &model_column_map, field, PH_READONLY)) {
+						/**
+						 * build() reports the missing column
+						 */
+						ZVAL_FALSE(&pk_parts);
+						break;
+					}
+				} else {
+					ZVAL_COPY_VALUE(&attribute_field, field);
+				}
+
+				PHALCON_CONCAT_SV(&bind_key, "pha_", &attribute_field);
+				PHALCON_CONCAT_VSVS(&condition, &attribute_field, "= :", &bind_key, ":");
+				PHALCON_CONCAT_VS(&null_condition, &attribute_field, " IS NULL");
+				if (!phalcon_array_isset_fetch(&type, &bind_types, field, PH_READONLY)) {
+					ZVAL_NULL(&type);
+				}
+
+				array_init_size(&part, 5);
+				phalcon_array_append(&part, &attribute_field, PH_COPY);
+				phalcon_array_append(&part, &bind_key, 0);
+				phalcon_array_append(&part, &condition, 0);
+				phalcon_array_append(&part, &null_condition, 0);
+				phalcon_array_append(&part, &type, PH_COPY);
+				phalcon_array_append(&pk_parts, &part, 0);
+			} ZEND_HASH_FOREACH_END();
+		}
+	}
+
+	array_init_size(return_value, 7);
+	phalcon_array_update_str_str(return_value, SL("class"), ZSTR_VAL(ce->name), ZSTR_LEN(ce->name), 0);
+	phalcon_array_update_str_bool(return_value, SL("native"), native, 0);
+	phalcon_array_update_str(return_value, SL("columnMap"), column_map, PH_COPY);
+	phalcon_array_update_str(return_value, SL("fields"), &fields, PH_COPY);
+	phalcon_array_update_str_bool(return_value, SL("convert"), convert, 0);
+	phalcon_array_update_str(return_value, SL("primaryKeys"), &pk_parts, PH_COPY);
+	phalcon_array_update_str_bool(return_value, SL("afterFetch"), zend_hash_str_exists(&ce->function_table, SL("afterfetch")), 0);
+
+	phalcon_update_property_array(getThis(), SL("_hydrationPlans"), &key, return_value);
+	RETURN_MM();
 }
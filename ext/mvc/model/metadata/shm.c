@@ -0,0 +1,683 @@
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2014 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+
+#include "mvc/model/metadata/shm.h"
+#include "mvc/model/metadata.h"
+#include "mvc/model/metadatainterface.h"
+#include "mvc/model/exception.h"
+#include "mvc/modelinterface.h"
+#include "cache/yac.h"
+#include "cache/yac/storage.h"
+
+#include <Zend/zend_smart_str.h>
+
+#include "kernel/main.h"
+#include "kernel/memory.h"
+#include "kernel/array.h"
+#include "kernel/object.h"
+#include "kernel/concat.h"
+#include "kernel/fcall.h"
+#include "kernel/operators.h"
+
+/**
+ * Phalcon\Mvc\Model\MetaData\Shm
+ *
+ * Stores model meta-data and column maps in the shared memory of yac (phalcon.cache.enable_yac).
+ * Every entry is kept in a compact binary layout with an offset for every MODELS_* index, so reading
+ * one index only decodes that index, nothing is unserialized
+ *
+ * Entries are versioned, reset() moves every process to a new version at once, the old entries are
+ * recycled by the shared memory allocator
+ *
+ *<code>
+ *	$metaData = new Phalcon\Mvc\Model\Metadata\Shm(array(
+ *		'prefix' => 'my-app-id'
+ *	));
+ *</code>
+ */
+zend_class_entry *phalcon_mvc_model_metadata_shm_ce;
+
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, __construct);
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, read);
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, write);
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, readMetaDataIndex);
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, readColumnMapIndex);
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, getVersion);
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, reset);
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_metadata_shm___construct, 0, 0, 0)
+	ZEND_ARG_INFO(0, options)
+ZEND_END_ARG_INFO()
+
+static const zend_function_entry phalcon_mvc_model_metadata_shm_method_entry[] = {
+	PHP_ME(Phalcon_Mvc_Model_MetaData_Shm, __construct, arginfo_phalcon_mvc_model_metadata_shm___construct, ZEND_ACC_PUBLIC|ZEND_ACC_CTOR)
+	PHP_ME(Phalcon_Mvc_Model_MetaData_Shm, read, arginfo_phalcon_mvc_model_metadatainterface_read, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_MetaData_Shm, write, arginfo_phalcon_mvc_model_metadatainterface_write, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_MetaData_Shm, readMetaDataIndex, arginfo_phalcon_mvc_model_metadatainterface_readmetadataindex, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_MetaData_Shm, readColumnMapIndex, arginfo_phalcon_mvc_model_metadatainterface_readcolumnmapindex, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_MetaData_Shm, getVersion, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_MetaData_Shm, reset, arginfo_phalcon_mvc_model_metadatainterface_reset, ZEND_ACC_PUBLIC)
+	PHP_FE_END
+};
+
+#define PHALCON_MVC_MODEL_METADATA_SHM_MAGIC       "PMM1"
+#define PHALCON_MVC_MODEL_METADATA_SHM_MAX_INDEXES 64
+
+/**
+ * Phalcon\Mvc\Model\MetaData\Shm initializer
+ */
+PHALCON_INIT_CLASS(Phalcon_Mvc_Model_MetaData_Shm){
+
+	PHALCON_REGISTER_CLASS_EX(Phalcon\\Mvc\\Model\\MetaData, Shm, mvc_model_metadata_shm, phalcon_mvc_model_metadata_ce, phalcon_mvc_model_metadata_shm_method_entry, 0);
+
+	zend_declare_property_string(phalcon_mvc_model_metadata_shm_ce, SL("_prefix"), "", ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_metadata_shm_ce, SL("_version"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_metadata_shm_ce, SL("_segments"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_metadata_shm_ce, SL("_sections"), ZEND_ACC_PROTECTED);
+
+	zend_class_implements(phalcon_mvc_model_metadata_shm_ce, 1, phalcon_mvc_model_metadatainterface_ce);
+
+	return SUCCESS;
+}
+
+static void phalcon_mvc_model_metadata_shm_append_uint32(smart_str *buf, uint32_t value)
+{
+	smart_str_appendl(buf, (const char *)&value, sizeof(uint32_t));
+}
+
+static int phalcon_mvc_model_metadata_shm_read_uint32(uint32_t *value, const char **p, const char *end)
+{
+	if (end - *p < (ptrdiff_t)sizeof(uint32_t)) {
+		return FAILURE;
+	}
+
+	memcpy(value, *p, sizeof(uint32_t));
+	*p += sizeof(uint32_t);
+	return SUCCESS;
+}
+
+/**
+ * Packs a value, the meta-data array itself is indexed: a table with the offset of every
+ * index precedes the values
+ */
+static int phalcon_mvc_model_metadata_shm_pack(smart_str *buf, zval *value, int indexed)
+{
+	zval *v;
+	zend_string *str_key;
+	zend_ulong idx;
+
+	switch (Z_TYPE_P(value)) {
+
+		case IS_NULL:
+			smart_str_appendc(buf, 'N');
+			break;
+
+		case IS_FALSE:
+			smart_str_appendc(buf, 'F');
+			break;
+
+		case IS_TRUE:
+			smart_str_appendc(buf, 'T');
+			break;
+
+		case IS_LONG:
+			smart_str_appendc(buf, 'L');
+			smart_str_appendl(buf, (const char *)&Z_LVAL_P(value), sizeof(zend_long));
+			break;
+
+		case IS_DOUBLE:
+			smart_str_appendc(buf, 'D');
+			smart_str_appendl(buf, (const char *)&Z_DVAL_P(value), sizeof(double));
+			break;
+
+		case IS_STRING:
+			smart_str_appendc(buf, 'S');
+			phalcon_mvc_model_metadata_shm_append_uint32(buf, Z_STRLEN_P(value));
+			smart_str_appendl(buf, Z_STRVAL_P(value), Z_STRLEN_P(value));
+			break;
+
+		case IS_REFERENCE:
+			return phalcon_mvc_model_metadata_shm_pack(buf, Z_REFVAL_P(value), indexed);
+
+		case IS_ARRAY:
+			if (indexed) {
+				ZEND_HASH_FOREACH_KEY(Z_ARRVAL_P(value), idx, str_key) {
+					if (str_key || idx >= PHALCON_MVC_MODEL_METADATA_SHM_MAX_INDEXES) {
+						indexed = 0;
+						break;
+					}
+				} ZEND_HASH_FOREACH_END();
+			}
+
+			if (indexed) {
+				size_t start = ZSTR_LEN(buf->s), i;
+				uint32_t size, offset, count = 0;
+
+				ZEND_HASH_FOREACH_NUM_KEY(Z_ARRVAL_P(value), idx) {
+					if (idx + 1 > count) {
+						count = idx + 1;
+					}
+				} ZEND_HASH_FOREACH_END();
+
+				/**
+				 * 'I', size of the block, number of offsets and the offsets, 0 for missing indexes
+				 */
+				smart_str_appendc(buf, 'I');
+				phalcon_mvc_model_metadata_shm_append_uint32(buf, 0);
+				phalcon_mvc_model_metadata_shm_append_uint32(buf, count);
+				for (i = 0; i < count; i++) {
+					phalcon_mvc_model_metadata_shm_append_uint32(buf, 0);
+				}
+
+				ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL_P(value), idx, v) {
+					offset = ZSTR_LEN(buf->s) - start;
+					memcpy(ZSTR_VAL(buf->s) + start + 1 + 2 * sizeof(uint32_t) + idx * sizeof(uint32_t), &offset, sizeof(uint32_t));
+					if (phalcon_mvc_model_metadata_shm_pack(buf, v, 0) == FAILURE) {
+						return FAILURE;
+					}
+				} ZEND_HASH_FOREACH_END();
+
+				size = ZSTR_LEN(buf->s) - start;
+				memcpy(ZSTR_VAL(buf->s) + start + 1, &size, sizeof(uint32_t));
+				break;
+			}
+
+			smart_str_appendc(buf, 'A');
+			phalcon_mvc_model_metadata_shm_append_uint32(buf, zend_hash_num_elements(Z_ARRVAL_P(value)));
+			ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(value), idx, str_key, v) {
+				if (str_key) {
+					smart_str_appendc(buf, 'S');
+					phalcon_mvc_model_metadata_shm_append_uint32(buf, ZSTR_LEN(str_key));
+					smart_str_appendl(buf, ZSTR_VAL(str_key), ZSTR_LEN(str_key));
+				} else {
+					smart_str_appendc(buf, 'L');
+					smart_str_appendl(buf, (const char *)&idx, sizeof(zend_long));
+				}
+				if (phalcon_mvc_model_metadata_shm_pack(buf, v, 0) == FAILURE) {
+					return FAILURE;
+				}
+			} ZEND_HASH_FOREACH_END();
+			break;
+
+		default:
+			/**
+			 * Objects and resources are not stored, the meta-data is obtained again from the strategy
+			 */
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+static int phalcon_mvc_model_metadata_shm_unpack(zval *return_value, const char **p, const char *end)
+{
+	const char *start = *p;
+	uint32_t size, count, offset, i;
+
+	if (*p >= end) {
+		return FAILURE;
+	}
+
+	switch (*(*p)++) {
+
+		case 'N':
+			ZVAL_NULL(return_value);
+			break;
+
+		case 'F':
+			ZVAL_FALSE(return_value);
+			break;
+
+		case 'T':
+			ZVAL_TRUE(return_value);
+			break;
+
+		case 'L':
+			if (end - *p < (ptrdiff_t)sizeof(zend_long)) {
+				return FAILURE;
+			}
+			ZVAL_LONG(return_value, 0);
+			memcpy(&Z_LVAL_P(return_value), *p, sizeof(zend_long));
+			*p += sizeof(zend_long);
+			break;
+
+		case 'D':
+			if (end - *p < (ptrdiff_t)sizeof(double)) {
+				return FAILURE;
+			}
+			ZVAL_DOUBLE(return_value, 0);
+			memcpy(&Z_DVAL_P(return_value), *p, sizeof(double));
+			*p += sizeof(double);
+			break;
+
+		case 'S':
+			if (phalcon_mvc_model_metadata_shm_read_uint32(&size, p, end) == FAILURE || end - *p < (ptrdiff_t)size) {
+				return FAILURE;
+			}
+			ZVAL_STRINGL(return_value, *p, size);
+			*p += size;
+			break;
+
+		case 'A':
+			if (phalcon_mvc_model_metadata_shm_read_uint32(&count, p, end) == FAILURE) {
+				return FAILURE;
+			}
+			array_init_size(return_value, count);
+			for (i = 0; i < count; i++) {
+				zval key = {}, value = {};
+				if (phalcon_mvc_model_metadata_shm_unpack(&key, p, end) == FAILURE
+					|| (Z_TYPE(key) != IS_LONG && Z_TYPE(key) != IS_STRING)
+					|| phalcon_mvc_model_metadata_shm_unpack(&value, p, end) == FAILURE) {
+					zval_ptr_dtor(&key);
+					zval_ptr_dtor(return_value);
+					return FAILURE;
+				}
+				if (Z_TYPE(key) == IS_LONG) {
+					zend_hash_index_update(Z_ARRVAL_P(return_value), Z_LVAL(key), &value);
+				} else {
+					zend_hash_update(Z_ARRVAL_P(return_value), Z_STR(key), &value);
+				}
+				zval_ptr_dtor(&key);
+			}
+			break;
+
+		case 'I':
+			if (phalcon_mvc_model_metadata_shm_read_uint32(&size, p, end) == FAILURE
+				|| phalcon_mvc_model_metadata_shm_read_uint32(&count, p, end) == FAILURE
+				|| end - start < (ptrdiff_t)size) {
+				return FAILURE;
+			}
+			array_init_size(return_value, count);
+			for (i = 0; i < count; i++) {
+				zval value = {};
+				const char *q;
+				if (phalcon_mvc_model_metadata_shm_read_uint32(&offset, p, end) == FAILURE) {
+					zval_ptr_dtor(return_value);
+					return FAILURE;
+				}
+				if (!offset) {
+					continue;
+				}
+				q = start + offset;
+				if (offset >= size || phalcon_mvc_model_metadata_shm_unpack(&value, &q, start + size) == FAILURE) {
+					zval_ptr_dtor(return_value);
+					return FAILURE;
+				}
+				zend_hash_index_update(Z_ARRVAL_P(return_value), i, &value);
+			}
+			*p = start + size;
+			break;
+
+		default:
+			return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Decodes only one index of an indexed block
+ */
+static int phalcon_mvc_model_metadata_shm_unpack_index(zval *return_value, const char *p, const char *end, zend_long index)
+{
+	const char *start = p, *q;
+	uint32_t size, count, offset;
+
+	if (p >= end || *p++ != 'I') {
+		return FAILURE;
+	}
+
+	if (phalcon_mvc_model_metadata_shm_read_uint32(&size, &p, end) == FAILURE
+		|| phalcon_mvc_model_metadata_shm_read_uint32(&count, &p, end) == FAILURE
+		|| end - start < (ptrdiff_t)size
+		|| index < 0 || index >= count) {
+		return FAILURE;
+	}
+
+	q = p + index * sizeof(uint32_t);
+	if (phalcon_mvc_model_metadata_shm_read_uint32(&offset, &q, end) == FAILURE || !offset || offset >= size) {
+		return FAILURE;
+	}
+
+	q = start + offset;
+	return phalcon_mvc_model_metadata_shm_unpack(return_value, &q, start + size);
+}
+
+/**
+ * The version of the entries is shared by every process using the same prefix
+ */
+static zend_string* phalcon_mvc_model_metadata_shm_version_key(zval *object)
+{
+	zval prefix = {};
+
+	phalcon_read_property(&prefix, object, SL("_prefix"), PH_READONLY);
+	if (Z_TYPE(prefix) != IS_STRING) {
+		return zend_string_init(SL("pmmv_"), 0);
+	}
+
+	return strpprintf(0, "pmmv_" ZEND_XLONG_FMT, (zend_ulong)zend_inline_hash_func(Z_STRVAL(prefix), Z_STRLEN(prefix)));
+}
+
+/**
+ * The version is read from the shared memory every time, a reset() of another process is seen
+ * without waiting for this instance to go away. Without shared memory it is local to the instance
+ */
+static zend_long phalcon_mvc_model_metadata_shm_version(zval *object)
+{
+	zval version = {};
+	zend_string *key;
+	zend_long result = 0;
+
+	if (PHALCON_GLOBAL(cache).enable_yac) {
+		key = phalcon_mvc_model_metadata_shm_version_key(object);
+		if (phalcon_cache_yac_get_impl(ZSTR_EMPTY_ALLOC(), key, &version) && Z_TYPE(version) == IS_LONG) {
+			result = Z_LVAL(version);
+		}
+		zval_ptr_dtor(&version);
+		zend_string_release(key);
+		return result;
+	}
+
+	phalcon_read_property(&version, object, SL("_version"), PH_READONLY);
+	return Z_TYPE(version) == IS_LONG ? Z_LVAL(version) : 0;
+}
+
+/**
+ * Keys are hashed to fit in the shared memory keys, the complete key is kept in the entry
+ */
+static zend_string* phalcon_mvc_model_metadata_shm_key(zval *object, zend_string *real_key)
+{
+	return strpprintf(0, "pmm_" ZEND_XLONG_FMT "_" ZEND_LONG_FMT,
+		(zend_ulong)zend_inline_hash_func(ZSTR_VAL(real_key), ZSTR_LEN(real_key)), phalcon_mvc_model_metadata_shm_version(object));
+}
+
+static zend_string* phalcon_mvc_model_metadata_shm_real_key(zval *object, zval *key)
+{
+	zval prefix = {};
+
+	phalcon_read_property(&prefix, object, SL("_prefix"), PH_READONLY);
+
+	return strpprintf(0, "%s%s", Z_TYPE(prefix) == IS_STRING ? Z_STRVAL(prefix) : "", Z_STRVAL_P(key));
+}
+
+/**
+ * Obtains the packed value of an entry, it is copied once from the shared memory for every request
+ */
+static void phalcon_mvc_model_metadata_shm_segment(zval *return_value, zval *object, zval *key)
+{
+	zval segment = {};
+	zend_string *real_key, *shm_key;
+	zend_string *data;
+	unsigned int flag;
+	uint32_t key_length;
+
+	if (phalcon_property_array_isset_fetch(&segment, object, SL("_segments"), key, PH_READONLY)) {
+		ZVAL_COPY_VALUE(return_value, &segment);
+		return;
+	}
+
+	ZVAL_FALSE(&segment);
+
+	if (PHALCON_GLOBAL(cache).enable_yac && Z_TYPE_P(key) == IS_STRING) {
+		real_key = phalcon_mvc_model_metadata_shm_real_key(object, key);
+		shm_key = phalcon_mvc_model_metadata_shm_key(object, real_key);
+
+		if (phalcon_cache_yac_storage_find(ZSTR_VAL(shm_key), ZSTR_LEN(shm_key), &data, &flag, time(NULL))) {
+			const char *p = ZSTR_VAL(data) + 4, *end = ZSTR_VAL(data) + ZSTR_LEN(data);
+
+			/**
+			 * Different keys can share a hash, the complete key is compared
+			 */
+			if (ZSTR_LEN(data) > 4 && !memcmp(ZSTR_VAL(data), PHALCON_MVC_MODEL_METADATA_SHM_MAGIC, 4)
+				&& phalcon_mvc_model_metadata_shm_read_uint32(&key_length, &p, end) == SUCCESS
+				&& key_length == ZSTR_LEN(real_key) && end - p > (ptrdiff_t)key_length
+				&& !memcmp(p, ZSTR_VAL(real_key), key_length)) {
+				p += key_length;
+				ZVAL_STRINGL(&segment, p, end - p);
+			}
+			zend_string_release(data);
+		}
+
+		zend_string_release(shm_key);
+		zend_string_release(real_key);
+	}
+
+	phalcon_update_property_array(object, SL("_segments"), key, &segment);
+	zval_ptr_dtor(&segment);
+
+	phalcon_property_array_isset_fetch(return_value, object, SL("_segments"), key, PH_READONLY);
+}
+
+/**
+ * Reads an index of an entry without decoding the rest of it
+ */
+static int phalcon_mvc_model_metadata_shm_read_index(zval *return_value, zval *object, zval *key, zval *index)
+{
+	zval sections = {}, section = {}, segment = {}, *cached;
+
+	if (Z_TYPE_P(index) != IS_LONG) {
+		return FAILURE;
+	}
+
+	phalcon_read_property(&sections, object, SL("_sections"), PH_READONLY);
+	if (phalcon_array_isset_fetch(&section, &sections, key, PH_READONLY) && Z_TYPE(section) == IS_ARRAY) {
+		if ((cached = zend_hash_index_find(Z_ARRVAL(section), Z_LVAL_P(index))) != NULL) {
+			ZVAL_COPY(return_value, cached);
+			return SUCCESS;
+		}
+	}
+
+	phalcon_mvc_model_metadata_shm_segment(&segment, object, key);
+	if (Z_TYPE(segment) != IS_STRING) {
+		return FAILURE;
+	}
+
+	if (phalcon_mvc_model_metadata_shm_unpack_index(return_value, Z_STRVAL(segment), Z_STRVAL(segment) + Z_STRLEN(segment), Z_LVAL_P(index)) == FAILURE) {
+		return FAILURE;
+	}
+
+	if (Z_TYPE(sections) == IS_ARRAY) {
+		phalcon_array_update_multi_2(&sections, key, index, return_value, PH_COPY);
+	}
+	return SUCCESS;
+}
+
+/**
+ * Phalcon\Mvc\Model\MetaData\Shm constructor
+ *
+ * @param array $options
+ */
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, __construct){
+
+	zval *options = NULL, prefix = {};
+
+	phalcon_fetch_params(0, 0, 1, &options);
+
+	if (options && Z_TYPE_P(options) == IS_ARRAY) {
+		if (phalcon_array_isset_fetch_str(&prefix, options, SL("prefix"), PH_READONLY)) {
+			phalcon_update_property(getThis(), SL("_prefix"), &prefix);
+		}
+	}
+
+	phalcon_update_property_empty_array(getThis(), SL("_metaData"));
+	phalcon_update_property_empty_array(getThis(), SL("_segments"));
+	phalcon_update_property_empty_array(getThis(), SL("_sections"));
+}
+
+/**
+ * Reads meta-data from the shared memory
+ *
+ * @param string $key
+ * @return array
+ */
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, read){
+
+	zval *key, segment = {};
+	const char *p;
+
+	phalcon_fetch_params(0, 1, 0, &key);
+
+	phalcon_mvc_model_metadata_shm_segment(&segment, getThis(), key);
+	if (Z_TYPE(segment) != IS_STRING) {
+		RETURN_NULL();
+	}
+
+	p = Z_STRVAL(segment);
+	if (phalcon_mvc_model_metadata_shm_unpack(return_value, &p, Z_STRVAL(segment) + Z_STRLEN(segment)) == FAILURE) {
+		RETURN_NULL();
+	}
+}
+
+/**
+ * Writes the meta-data to the shared memory
+ *
+ * @param string $key
+ * @param array $data
+ */
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, write){
+
+	zval *key, *data;
+	zend_string *real_key, *shm_key;
+	smart_str buf = {0};
+
+	phalcon_fetch_params(0, 2, 0, &key, &data);
+
+	if (!PHALCON_GLOBAL(cache).enable_yac || Z_TYPE_P(key) != IS_STRING) {
+		return;
+	}
+
+	real_key = phalcon_mvc_model_metadata_shm_real_key(getThis(), key);
+
+	smart_str_appendl(&buf, PHALCON_MVC_MODEL_METADATA_SHM_MAGIC, 4);
+	phalcon_mvc_model_metadata_shm_append_uint32(&buf, ZSTR_LEN(real_key));
+	smart_str_appendl(&buf, ZSTR_VAL(real_key), ZSTR_LEN(real_key));
+
+	if (phalcon_mvc_model_metadata_shm_pack(&buf, data, 1) == SUCCESS && ZSTR_LEN(buf.s) <= PHALCON_CACHE_YAC_STORAGE_MAX_ENTRY_LEN) {
+		shm_key = phalcon_mvc_model_metadata_shm_key(getThis(), real_key);
+		phalcon_cache_yac_storage_update(ZSTR_VAL(shm_key), ZSTR_LEN(shm_key), ZSTR_VAL(buf.s), ZSTR_LEN(buf.s), IS_STRING, 0, 0, time(NULL));
+		zend_string_release(shm_key);
+	}
+
+	smart_str_free(&buf);
+	zend_string_release(real_key);
+}
+
+/**
+ * Reads meta-data for certain model, the index is read directly from the shared memory
+ * if the meta-data wasn't loaded in this request
+ *
+ * @param Phalcon\Mvc\ModelInterface $model
+ * @param int $index
+ * @return array
+ */
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, readMetaDataIndex){
+
+	zval *model, *index, table = {}, schema = {}, key = {}, meta_data = {}, prefix_key = {};
+
+	phalcon_fetch_params(1, 2, 0, &model, &index);
+	PHALCON_MM_VERIFY_INTERFACE_EX(model, phalcon_mvc_modelinterface_ce, phalcon_mvc_model_exception_ce);
+
+	PHALCON_MM_CALL_METHOD(&table, model, "getsource");
+	PHALCON_MM_ADD_ENTRY(&table);
+	PHALCON_MM_CALL_METHOD(&schema, model, "getschema");
+	PHALCON_MM_ADD_ENTRY(&schema);
+
+	PHALCON_MM_CALL_METHOD(&key, getThis(), "getcachekey", model, &table, &schema);
+	PHALCON_MM_ADD_ENTRY(&key);
+
+	phalcon_read_property(&meta_data, getThis(), SL("_metaData"), PH_NOISY|PH_READONLY);
+	if (!phalcon_array_isset(&meta_data, &key)) {
+		PHALCON_CONCAT_SV(&prefix_key, "meta-", &key);
+		PHALCON_MM_ADD_ENTRY(&prefix_key);
+
+		if (phalcon_mvc_model_metadata_shm_read_index(return_value, getThis(), &prefix_key, index) == SUCCESS) {
+			RETURN_MM();
+		}
+	}
+
+	PHALCON_MM_CALL_PARENT(return_value, phalcon_mvc_model_metadata_shm_ce, getThis(), "readmetadataindex", model, index);
+	RETURN_MM();
+}
+
+/**
+ * Reads column-map information for certain model, the index is read directly from the shared memory
+ * if the column map wasn't loaded in this request
+ *
+ * @param Phalcon\Mvc\ModelInterface $model
+ * @param int $index
+ */
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, readColumnMapIndex){
+
+	zval *model, *index, table = {}, schema = {}, key = {}, column_map = {}, prefix_key = {};
+
+	phalcon_fetch_params(1, 2, 0, &model, &index);
+	PHALCON_MM_VERIFY_INTERFACE_EX(model, phalcon_mvc_modelinterface_ce, phalcon_mvc_model_exception_ce);
+
+	PHALCON_MM_CALL_METHOD(&table, model, "getsource");
+	PHALCON_MM_ADD_ENTRY(&table);
+	PHALCON_MM_CALL_METHOD(&schema, model, "getschema");
+	PHALCON_MM_ADD_ENTRY(&schema);
+
+	PHALCON_MM_CALL_METHOD(&key, getThis(), "getcachekey", model, &table, &schema);
+	PHALCON_MM_ADD_ENTRY(&key);
+
+	phalcon_read_property(&column_map, getThis(), SL("_columnMap"), PH_READONLY);
+	if (Z_TYPE(column_map) != IS_ARRAY || !phalcon_array_isset(&column_map, &key)) {
+		PHALCON_CONCAT_SV(&prefix_key, "map-", &key);
+		PHALCON_MM_ADD_ENTRY(&prefix_key);
+
+		if (phalcon_mvc_model_metadata_shm_read_index(return_value, getThis(), &prefix_key, index) == SUCCESS) {
+			RETURN_MM();
+		}
+	}
+
+	PHALCON_MM_CALL_PARENT(return_value, phalcon_mvc_model_metadata_shm_ce, getThis(), "readcolumnmapindex", model, index);
+	RETURN_MM();
+}
+
+/**
+ * Returns the version of the entries in the shared memory
+ *
+ * @return int
+ */
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, getVersion){
+
+	RETURN_LONG(phalcon_mvc_model_metadata_shm_version(getThis()));
+}
+
+/**
+ * Resets the meta-data, every process moves to a new version of the entries
+ */
+PHP_METHOD(Phalcon_Mvc_Model_MetaData_Shm, reset){
+
+	zend_string *key;
+	long version;
+
+	if (PHALCON_GLOBAL(cache).enable_yac) {
+		key = phalcon_mvc_model_metadata_shm_version_key(getThis());
+		phalcon_cache_yac_incr_impl(ZSTR_EMPTY_ALLOC(), key, 1, 0, &version);
+		zend_string_release(key);
+	} else {
+		phalcon_update_property_long(getThis(), SL("_version"), phalcon_mvc_model_metadata_shm_version(getThis()) + 1);
+	}
+
+	phalcon_update_property_empty_array(getThis(), SL("_segments"));
+	phalcon_update_property_empty_array(getThis(), SL("_sections"));
+
+	PHALCON_CALL_PARENT(NULL, phalcon_mvc_model_metadata_shm_ce, getThis(), "reset");
+}
@@ -26,11 +26,13 @@
 #include "mvc/model/query/status.h"
 #include "mvc/model/resultset/complex.h"
 #include "mvc/model/resultset/simple.h"
+#include "mvc/model/resultset.h"
 #include "mvc/model/query/exception.h"
 #include "mvc/model/manager.h"
 #include "mvc/model/managerinterface.h"
 #include "mvc/model/metadatainterface.h"
 #include "mvc/model/metadata/memory.h"
+#include "mvc/model/metadata/shm.h"
 #include "mvc/model/row.h"
 #include "cache/backendinterface.h"
 #include "cache/frontendinterface.h"
@@ -39,6 +41,7 @@
 #include "db/rawvalue.h"
 #include "db/column.h"
 #include "db/adapterinterface.h"
+#include "db/adapter/pdo.h"
 #include "debug.h"
 
 #include "kernel/main.h"
@@ -57,6 +60,8 @@
 
 #include "interned-strings.h"
 
+#include <Zend/zend_smart_str.h>
+
 /**
  * Phalcon\Mvc\Model\Query
  *
@@ -88,6 +93,10 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, getModelsManager);
 PHP_METHOD(Phalcon_Mvc_Model_Query, getModelsMetaData);
 PHP_METHOD(Phalcon_Mvc_Model_Query, setUniqueRow);
 PHP_METHOD(Phalcon_Mvc_Model_Query, getUniqueRow);
+PHP_METHOD(Phalcon_Mvc_Model_Query, setStream);
+PHP_METHOD(Phalcon_Mvc_Model_Query, getStream);
+PHP_METHOD(Phalcon_Mvc_Model_Query, setWith);
+PHP_METHOD(Phalcon_Mvc_Model_Query, getWith);
 PHP_METHOD(Phalcon_Mvc_Model_Query, _getQualified);
 PHP_METHOD(Phalcon_Mvc_Model_Query, _getCallArgument);
 PHP_METHOD(Phalcon_Mvc_Model_Query, _getCaseExpression);
@@ -140,6 +149,8 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, getConnection);
 PHP_METHOD(Phalcon_Mvc_Model_Query, getReadConnection);
 PHP_METHOD(Phalcon_Mvc_Model_Query, getWriteConnection);
 PHP_METHOD(Phalcon_Mvc_Model_Query, setConflict);
+PHP_METHOD(Phalcon_Mvc_Model_Query, getCacheStats);
+PHP_METHOD(Phalcon_Mvc_Model_Query, clearCache);
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_query___construct, 0, 0, 1)
 	ZEND_ARG_INFO(0, phql)
@@ -153,6 +164,14 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_query_setuniquerow, 0, 0, 1)
 	ZEND_ARG_INFO(0, uniqueRow)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_query_setstream, 0, 0, 1)
+	ZEND_ARG_INFO(0, stream)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_query_setwith, 0, 0, 1)
+	ZEND_ARG_INFO(0, with)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_query_cache, 0, 0, 1)
 	ZEND_ARG_INFO(0, cacheOptions)
 ZEND_END_ARG_INFO()
@@ -227,6 +246,10 @@ static const zend_function_entry phalcon_mvc_model_query_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Model_Query, getModelsMetaData, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Query, setUniqueRow, arginfo_phalcon_mvc_model_query_setuniquerow, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Query, getUniqueRow, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Query, setStream, arginfo_phalcon_mvc_model_query_setstream, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Query, getStream, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Query, setWith, arginfo_phalcon_mvc_model_query_setwith, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Query, getWith, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Query, _getQualified, NULL, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Mvc_Model_Query, _getCallArgument, NULL, ZEND_ACC_PROTECTED)
 	PHP_ME(Phalcon_Mvc_Model_Query, _getCaseExpression, NULL, ZEND_ACC_PROTECTED)
@@ -279,6 +302,8 @@ static const zend_function_entry phalcon_mvc_model_query_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Model_Query, getReadConnection, arginfo_phalcon_mvc_model_query_getreadconnection, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Query, getWriteConnection, arginfo_phalcon_mvc_model_query_getwriteconnection, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Query, setConflict, arginfo_phalcon_mvc_model_query_setconflict, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Query, getCacheStats, NULL, ZEND_ACC_PUBLIC|ZEND_ACC_STATIC)
+	PHP_ME(Phalcon_Mvc_Model_Query, clearCache, NULL, ZEND_ACC_PUBLIC|ZEND_ACC_STATIC)
 	PHP_FE_END
 };
 
@@ -296,6 +321,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Query){
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_phql"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_ast"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_intermediate"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_intermediateSource"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_models"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_sqlAliases"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_sqlAliasesModels"), ZEND_ACC_PROTECTED);
@@ -307,6 +333,8 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Query){
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_cache"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_cacheOptions"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_uniqueRow"), ZEND_ACC_PROTECTED);
+	zend_declare_property_bool(phalcon_mvc_model_query_ce, SL("_stream"), 0, ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_with"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_bindParams"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_bindTypes"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_ce, SL("_mergeBindParams"), ZEND_ACC_PROTECTED);
@@ -352,6 +380,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, setPhql){
 	phalcon_fetch_params(0, 1, 0, &phql);
 
 	phalcon_update_property(getThis(), SL("_phql"), phql);
+	phalcon_update_property_null(getThis(), SL("_intermediateSource"));
 }
 
 PHP_METHOD(Phalcon_Mvc_Model_Query, getPhql){
@@ -468,6 +497,79 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, getUniqueRow){
 	RETURN_MEMBER(getThis(), "_uniqueRow");
 }
 
+/**
+ * Tells to the query to return a forward-only resultset that reads its rows as it is traversed,
+ * without keeping them in memory. On MySQL the rows are read unbuffered, other queries can't
+ * be sent through the same connection until the resultset is completely traversed
+ *
+ *<code>
+ * $query = $manager->createQuery('SELECT * FROM Robots');
+ * foreach ($query->setStream(true)->execute() as $robot) {
+ *	echo $robot->name, PHP_EOL;
+ * }
+ *</code>
+ *
+ * @param boolean $stream
+ * @return Phalcon\Mvc\Model\Query
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Query, setStream){
+
+	zval *stream;
+
+	phalcon_fetch_params(0, 1, 0, &stream);
+
+	phalcon_update_property_bool(getThis(), SL("_stream"), zend_is_true(stream));
+	RETURN_THIS();
+}
+
+/**
+ * Check if the query returns a streaming resultset
+ *
+ * @return boolean
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Query, getStream){
+
+
+	RETURN_MEMBER(getThis(), "_stream");
+}
+
+/**
+ * Sets the relations to eager load into the records returned, one query is sent per relation
+ * instead of one per record when the relations are accessed
+ *
+ *<code>
+ * $query = $manager->createQuery('SELECT * FROM Robots');
+ * foreach ($query->setWith(array('robotsParts.parts'))->execute() as $robot) {
+ *	foreach ($robot->robotsParts as $robotPart) {
+ *		echo $robotPart->parts->name, PHP_EOL;
+ *	}
+ * }
+ *</code>
+ *
+ * @param string|array $with
+ * @return Phalcon\Mvc\Model\Query
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Query, setWith){
+
+	zval *with;
+
+	phalcon_fetch_params(0, 1, 0, &with);
+
+	phalcon_update_property(getThis(), SL("_with"), with);
+	RETURN_THIS();
+}
+
+/**
+ * Returns the relations eager loaded into the records returned
+ *
+ * @return string|array
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Query, getWith){
+
+
+	RETURN_MEMBER(getThis(), "_with");
+}
+
 /**
  * Replaces the model's name to its source name in a qualifed-name expression
  *
@@ -3291,6 +3393,32 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, _prepareDelete){
 	zval_ptr_dtor(&event_name);
 }
 
+/**
+ * Version of the models meta-data the cached statements are built from, only the shared memory
+ * meta-data moves to a new version when it is reset
+ */
+static zend_long phalcon_mvc_model_query_metadata_version(zval *object)
+{
+#ifdef PHALCON_CACHE_YAC
+	zval meta_data = {}, version = {};
+	zend_long result = 0;
+	int status;
+
+	PHALCON_CALL_METHOD_FLAG(status, &meta_data, object, "getmodelsmetadata");
+	if (status == SUCCESS && Z_TYPE(meta_data) == IS_OBJECT && instanceof_function(Z_OBJCE(meta_data), phalcon_mvc_model_metadata_shm_ce)) {
+		PHALCON_CALL_METHOD_FLAG(status, &version, &meta_data, "getversion");
+		if (status == SUCCESS && Z_TYPE(version) == IS_LONG) {
+			result = Z_LVAL(version);
+		}
+	}
+	zval_ptr_dtor(&meta_data);
+
+	return result;
+#else
+	return 0;
+#endif
+}
+
 /**
  * Parses the intermediate code produced by Phalcon\Mvc\Model\Query\Lang generating another
  * intermediate representation that could be executed by Phalcon\Mvc\Model\Query
@@ -3299,8 +3427,12 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, _prepareDelete){
  */
 PHP_METHOD(Phalcon_Mvc_Model_Query, parse){
 
-	zval *_phql = NULL, event_name = {}, intermediate, phql = {}, ast = {}, type = {}, ir_phql = {};
-	zval exception_message = {}, debug_message = {};
+	zval *_phql = NULL, event_name = {}, intermediate, phql = {}, ast = {}, type = {}, ir_phql = {}, cached = {}, models = {};
+	zval bind_types = {}, old_bind_types = {}, value_types = {}, *value, exception_message = {}, debug_message = {};
+	zend_string *str_key;
+	ulong idx;
+	zend_long metadata_version = 0;
+	int cacheable;
 
 	phalcon_fetch_params(1, 0, 1, &_phql);
 
@@ -3332,53 +3464,129 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, parse){
 	}
 
 	/**
-	 * This function parses the PHQL statement
+	 * Statements with array placeholders produce a different IR for every bound value
 	 */
-	if (phql_parse_phql(&ast, &phql) == FAILURE) {
-		RETURN_MM();
-	}
-	PHALCON_MM_ADD_ENTRY(&ast);
+	cacheable = Z_TYPE(phql) == IS_STRING && !phalcon_memnstr_str(&phql, SL(":array"));
 
-	/**
-	 * A valid AST must have a type
-	 */
-	if (Z_TYPE(ast) != IS_ARRAY || !phalcon_array_isset_fetch_string(&type, &ast, IS(type), PH_READONLY)) {
-		PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_query_exception_ce, "Corrupted AST");
-		return;
+	if (cacheable) {
+		metadata_version = phalcon_mvc_model_query_metadata_version(getThis());
+		if (EG(exception)) {
+			RETURN_MM();
+		}
 	}
 
-	phalcon_update_property(getThis(), SL("_ast"), &ast);
-	phalcon_update_property(getThis(), SL("_type"), &type);
+	if (cacheable && phalcon_orm_get_cached_statement(&cached, PHALCON_ORM_CACHE_INTERMEDIATE, &phql, metadata_version)) {
+		PHALCON_MM_ADD_ENTRY(&cached);
 
-	switch (phalcon_get_intval(&type)) {
+		phalcon_array_fetch_str(&type, &cached, SL("type"), PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_str(&ir_phql, &cached, SL("intermediate"), PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_str(&models, &cached, SL("models"), PH_NOISY|PH_READONLY);
+		phalcon_array_fetch_str(&bind_types, &cached, SL("bindTypes"), PH_NOISY|PH_READONLY);
 
-		case PHQL_T_SELECT:
-			PHALCON_MM_CALL_METHOD(&ir_phql, getThis(), "_prepareselect");
-			break;
+		phalcon_update_property(getThis(), SL("_type"), &type);
+		phalcon_update_property(getThis(), SL("_models"), &models);
 
-		case PHQL_T_INSERT:
-			PHALCON_MM_CALL_METHOD(&ir_phql, getThis(), "_prepareinsert");
-			break;
+		/**
+		 * Typed placeholders register their bind types while the statement is prepared
+		 */
+		if (Z_TYPE(bind_types) == IS_ARRAY) {
+			ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(bind_types), idx, str_key, value) {
+				zval name = {};
+				if (str_key) {
+					ZVAL_STR(&name, str_key);
+				} else {
+					ZVAL_LONG(&name, idx);
+				}
+				phalcon_update_property_array(getThis(), SL("_bindTypes"), &name, value);
+			} ZEND_HASH_FOREACH_END();
+		}
+	} else {
+		phalcon_read_property(&old_bind_types, getThis(), SL("_bindTypes"), PH_COPY);
+		PHALCON_MM_ADD_ENTRY(&old_bind_types);
 
-		case PHQL_T_UPDATE:
-			PHALCON_MM_CALL_METHOD(&ir_phql, getThis(), "_prepareupdate");
-			break;
+		/**
+		 * This function parses the PHQL statement
+		 */
+		if (phql_parse_phql(&ast, &phql) == FAILURE) {
+			RETURN_MM();
+		}
+		PHALCON_MM_ADD_ENTRY(&ast);
 
-		case PHQL_T_DELETE:
-			PHALCON_MM_CALL_METHOD(&ir_phql, getThis(), "_preparedelete");
-			break;
+		/**
+		 * A valid AST must have a type
+		 */
+		if (Z_TYPE(ast) != IS_ARRAY || !phalcon_array_isset_fetch_string(&type, &ast, IS(type), PH_READONLY)) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_query_exception_ce, "Corrupted AST");
+			return;
+		}
 
-		default:
-			PHALCON_CONCAT_SVSV(&exception_message, "Unknown statement ", &type, ", when preparing: ", &phql);
-			PHALCON_MM_ADD_ENTRY(&exception_message);
-			PHALCON_MM_THROW_EXCEPTION_ZVAL(phalcon_mvc_model_query_exception_ce, &exception_message);
+		phalcon_update_property(getThis(), SL("_ast"), &ast);
+		phalcon_update_property(getThis(), SL("_type"), &type);
+
+		switch (phalcon_get_intval(&type)) {
+
+			case PHQL_T_SELECT:
+				PHALCON_MM_CALL_METHOD(&ir_phql, getThis(), "_prepareselect");
+				break;
+
+			case PHQL_T_INSERT:
+				PHALCON_MM_CALL_METHOD(&ir_phql, getThis(), "_prepareinsert");
+				break;
+
+			case PHQL_T_UPDATE:
+				PHALCON_MM_CALL_METHOD(&ir_phql, getThis(), "_prepareupdate");
+				break;
+
+			case PHQL_T_DELETE:
+				PHALCON_MM_CALL_METHOD(&ir_phql, getThis(), "_preparedelete");
+				break;
+
+			default:
+				PHALCON_CONCAT_SVSV(&exception_message, "Unknown statement ", &type, ", when preparing: ", &phql);
+				PHALCON_MM_ADD_ENTRY(&exception_message);
+				PHALCON_MM_THROW_EXCEPTION_ZVAL(phalcon_mvc_model_query_exception_ce, &exception_message);
+				return;
+		}
+		PHALCON_MM_ADD_ENTRY(&ir_phql);
+
+		if (Z_TYPE(ir_phql) != IS_ARRAY) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_query_exception_ce, "Corrupted AST");
 			return;
-	}
-	PHALCON_MM_ADD_ENTRY(&ir_phql);
+		}
 
-	if (Z_TYPE(ir_phql) != IS_ARRAY) {
-		PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_query_exception_ce, "Corrupted AST");
-		return;
+		if (cacheable) {
+			array_init_size(&cached, 4);
+			PHALCON_MM_ADD_ENTRY(&cached);
+			array_init(&bind_types);
+			PHALCON_MM_ADD_ENTRY(&bind_types);
+
+			/**
+			 * Only the bind types registered by the preparation belong to the statement
+			 */
+			phalcon_read_property(&value_types, getThis(), SL("_bindTypes"), PH_READONLY);
+			if (Z_TYPE(value_types) == IS_ARRAY) {
+				ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(value_types), idx, str_key, value) {
+					zval name = {};
+					if (str_key) {
+						ZVAL_STR(&name, str_key);
+					} else {
+						ZVAL_LONG(&name, idx);
+					}
+					if (Z_TYPE(old_bind_types) != IS_ARRAY || !phalcon_array_isset(&old_bind_types, &name)) {
+						phalcon_array_update(&bind_types, &name, value, PH_COPY);
+					}
+				} ZEND_HASH_FOREACH_END();
+			}
+
+			phalcon_read_property(&models, getThis(), SL("_models"), PH_READONLY);
+
+			phalcon_array_update_string(&cached, IS(type), &type, PH_COPY);
+			phalcon_array_update_str(&cached, SL("intermediate"), &ir_phql, PH_COPY);
+			phalcon_array_update_str(&cached, SL("models"), &models, PH_COPY);
+			phalcon_array_update_str(&cached, SL("bindTypes"), &bind_types, PH_COPY);
+
+			phalcon_orm_set_cached_statement(PHALCON_ORM_CACHE_INTERMEDIATE, &phql, &cached, metadata_version);
+		}
 	}
 
 	PHALCON_MM_ZVAL_STRING(&event_name, "query:afterParse");
@@ -3386,10 +3594,16 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, parse){
 
 	if (Z_TYPE_P(return_value) == IS_ARRAY) {
 		phalcon_update_property(getThis(), SL("_intermediate"), return_value);
+		phalcon_update_property_null(getThis(), SL("_intermediateSource"));
 		RETURN_MM();
 	}
 	zval_ptr_dtor(return_value);
 	phalcon_update_property(getThis(), SL("_intermediate"), &ir_phql);
+	if (cacheable) {
+		phalcon_update_property(getThis(), SL("_intermediateSource"), &phql);
+	} else {
+		phalcon_update_property_null(getThis(), SL("_intermediateSource"));
+	}
 	RETURN_MM_CTOR(&ir_phql);
 }
 
@@ -3484,11 +3698,12 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, _executeSelect){
 	zval event_name = {}, intermediate = {}, bind_params = {}, bind_types = {}, manager = {}, models = {}, number_models = {}, models_instances = {};
 	zval model_name = {}, model = {}, instance = {}, connection = {}, *model_name2, columns = {}, *column, select_columns = {};
 	zval simple_column_map = {}, dialect = {}, sql_select = {}, processed = {}, *value = NULL, processed_types = {}, tmp = {};
-	zval result = {}, dependency_injector = {}, cache = {};
-	zval service_name = {}, has = {}, service_params = {};
+	zval result = {}, dependency_injector = {}, cache = {}, intermediate_source = {}, sql_source = {};
+	zval service_name = {}, has = {}, service_params = {}, stream = {}, unique_row = {}, pdo = {}, buffered_attribute = {}, buffered = {};
 	zend_string *str_key;
 	ulong idx;
-	int have_scalars = 0, have_objects = 0, is_complex = 0, is_simple_std = 0;
+	zend_long metadata_version = 0;
+	int have_scalars = 0, have_objects = 0, is_complex = 0, is_simple_std = 0, is_stream, flag = SUCCESS;
 	size_t number_objects = 0;
 
 	PHALCON_MM_INIT();
@@ -3715,7 +3930,41 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, _executeSelect){
 	 */
 	PHALCON_MM_CALL_METHOD(&dialect, &connection, "getdialect");
 	PHALCON_MM_ADD_ENTRY(&dialect);
-	PHALCON_MM_CALL_METHOD(&sql_select, &dialect, "select", &intermediate);
+
+	/**
+	 * A statement parsed from PHQL always generates the same SQL for a dialect and an index
+	 */
+	phalcon_read_property(&intermediate_source, getThis(), SL("_intermediateSource"), PH_READONLY);
+	if (Z_TYPE(intermediate_source) == IS_STRING && Z_TYPE(dialect) == IS_OBJECT) {
+		smart_str source = {0};
+		zval index = {};
+
+		smart_str_append(&source, Z_STR(intermediate_source));
+		smart_str_appendc(&source, '\0');
+		smart_str_append(&source, Z_OBJCE(dialect)->name);
+		smart_str_appendc(&source, PHALCON_GLOBAL(db).escape_identifiers ? '1' : '0');
+		if (phalcon_array_isset_fetch_str(&index, &intermediate, SL("index"), PH_READONLY) && Z_TYPE(index) == IS_STRING) {
+			smart_str_append(&source, Z_STR(index));
+		}
+		smart_str_0(&source);
+
+		ZVAL_STR(&sql_source, source.s);
+		PHALCON_MM_ADD_ENTRY(&sql_source);
+	}
+
+	if (Z_TYPE(sql_source) == IS_STRING) {
+		metadata_version = phalcon_mvc_model_query_metadata_version(getThis());
+		if (EG(exception)) {
+			RETURN_MM();
+		}
+	}
+
+	if (Z_TYPE(sql_source) != IS_STRING || !phalcon_orm_get_cached_statement(&sql_select, PHALCON_ORM_CACHE_SQL, &sql_source, metadata_version)) {
+		PHALCON_MM_CALL_METHOD(&sql_select, &dialect, "select", &intermediate);
+		if (Z_TYPE(sql_source) == IS_STRING && Z_TYPE(sql_select) == IS_STRING) {
+			phalcon_orm_set_cached_statement(PHALCON_ORM_CACHE_SQL, &sql_source, &sql_select, metadata_version);
+		}
+	}
 	PHALCON_MM_ADD_ENTRY(&sql_select);
 
 	PHALCON_MM_ZVAL_STRING(&event_name, "query:afterGenerateSQLStatement");
@@ -3812,10 +4061,55 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, _executeSelect){
 		PHALCON_MM_ZVAL_COPY(&processed_types, &bind_types);
 	}
 
+	/**
+	 * Streaming doesn't apply to cached resultsets or single rows
+	 */
+	phalcon_read_property(&cache, getThis(), SL("_cache"), PH_READONLY);
+	phalcon_read_property(&stream, getThis(), SL("_stream"), PH_READONLY);
+	phalcon_read_property(&unique_row, getThis(), SL("_uniqueRow"), PH_READONLY);
+	is_stream = zend_is_true(&stream) && !zend_is_true(&unique_row) && Z_TYPE(cache) == IS_NULL;
+
+	if (is_stream && instanceof_function(Z_OBJCE(connection), phalcon_db_adapter_pdo_ce)) {
+		zval dialect_type = {};
+		PHALCON_MM_CALL_METHOD(&dialect_type, &connection, "gettype");
+		if (PHALCON_IS_STRING(&dialect_type, "mysql")) {
+			/**
+			 * Don't let the MySQL client buffer the complete result, the mode set by the application
+			 * is restored after the query
+			 */
+			PHALCON_MM_CALL_METHOD(&pdo, &connection, "getinternalhandler");
+			PHALCON_MM_ADD_ENTRY(&pdo);
+			ZVAL_LONG(&buffered_attribute, PHALCON_PDO_MYSQL_ATTR_USE_BUFFERED_QUERY);
+			PHALCON_MM_CALL_METHOD(&buffered, &pdo, "getattribute", &buffered_attribute);
+			PHALCON_MM_ADD_ENTRY(&buffered);
+			PHALCON_MM_CALL_METHOD(NULL, &pdo, "setattribute", &buffered_attribute, &PHALCON_GLOBAL(z_false));
+		}
+		zval_ptr_dtor(&dialect_type);
+	}
+
 	/**
 	 * Execute the query
 	 */
-	PHALCON_MM_CALL_METHOD(&result, &connection, "query", &sql_select, &processed, &processed_types);
+	PHALCON_CALL_METHOD_FLAG(flag, &result, &connection, "query", &sql_select, &processed, &processed_types);
+	if (Z_TYPE(pdo) == IS_OBJECT) {
+		/**
+		 * Restore the buffered mode for the next queries, keeping any exception thrown by the query
+		 */
+		zend_object *exception = EG(exception);
+		EG(exception) = NULL;
+		PHALCON_CALL_METHOD_FLAG(flag, NULL, &pdo, "setattribute", &buffered_attribute, &buffered);
+		if (exception) {
+			if (EG(exception)) {
+				zend_object_release(EG(exception));
+			}
+			EG(exception) = exception;
+			flag = FAILURE;
+		}
+	}
+	if (flag == FAILURE) {
+		zval_ptr_dtor(&result);
+		RETURN_MM();
+	}
 	PHALCON_MM_ADD_ENTRY(&result);
 
 	PHALCON_MM_CALL_METHOD(&dependency_injector, getThis(), "getdi");
@@ -3824,7 +4118,6 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, _executeSelect){
 	/**
 	 * Choose a resultset type
 	 */
-	phalcon_read_property(&cache, getThis(), SL("_cache"), PH_READONLY);
 	if (!is_complex) {
 		zval result_object = {};
 		/**
@@ -3902,6 +4195,12 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, _executeSelect){
 		}
 	}
 
+	if (is_stream && Z_TYPE_P(return_value) == IS_OBJECT && instanceof_function(Z_OBJCE_P(return_value), phalcon_mvc_model_resultset_ce)) {
+		zval stream_type = {};
+		ZVAL_LONG(&stream_type, PHALCON_MVC_MODEL_RESULTSET_TYPE_STREAM);
+		PHALCON_MM_CALL_METHOD(NULL, return_value, "settype", &stream_type);
+	}
+
 	PHALCON_MM_ZVAL_STRING(&event_name, "query:afterExecuteSelect");
 	PHALCON_MM_CALL_METHOD(NULL, getThis(), "fireevent", &event_name);
 	RETURN_MM();
@@ -4427,6 +4726,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, execute){
 	zval *bind_params = NULL, *bind_types = NULL, event_name = {}, unique_row = {}, type = {}, debug_message = {};
 	zval cache_options = {}, cache_key = {}, lifetime = {}, cache_service = {}, cache = {}, frontend = {}, result = {}, is_fresh = {};
 	zval default_bind_params = {}, merged_params = {}, default_bind_types = {}, merged_types = {}, exception_message = {}, *value;
+	zval with = {}, manager = {};
 	zend_string *str_key;
 	ulong idx;
 	int cache_options_is_not_null;
@@ -4454,6 +4754,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, execute){
 	cache_options_is_not_null = (Z_TYPE(cache_options) != IS_NULL); /* to keep scan-build happy */
 
 	phalcon_read_property(&unique_row, getThis(), SL("_uniqueRow"), PH_NOISY|PH_READONLY);
+	phalcon_read_property(&with, getThis(), SL("_with"), PH_NOISY|PH_READONLY);
 
 	ZVAL_NULL(&cache);
 	if (cache_options_is_not_null) {
@@ -4521,6 +4822,12 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, execute){
 			ZVAL_BOOL(&is_fresh, 0);
 			PHALCON_MM_CALL_METHOD(NULL, &result, "setisfresh", &is_fresh);
 
+			if (PHALCON_IS_NOT_EMPTY(&with)) {
+				PHALCON_MM_CALL_METHOD(&manager, getThis(), "getmodelsmanager");
+				PHALCON_MM_ADD_ENTRY(&manager);
+				PHALCON_MM_CALL_METHOD(NULL, &manager, "eagerload", &result, &with);
+			}
+
 			/**
 			 * Check if only the first row must be returned
 			 */
@@ -4652,6 +4959,15 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, execute){
 		}
 	}
 
+	/**
+	 * Load the requested relations of all the records, one query per relation
+	 */
+	if (PHALCON_IS_NOT_EMPTY(&with) && Z_TYPE(result) == IS_OBJECT && phalcon_get_intval(&type) == PHQL_T_SELECT) {
+		PHALCON_MM_CALL_METHOD(&manager, getThis(), "getmodelsmanager");
+		PHALCON_MM_ADD_ENTRY(&manager);
+		PHALCON_MM_CALL_METHOD(NULL, &manager, "eagerload", &result, &with);
+	}
+
 	/**
 	 * Check if only the first row must be returned
 	 */
@@ -4947,6 +5263,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, setIntermediate){
 	phalcon_fetch_params(0, 1, 0, &intermediate);
 
 	phalcon_update_property(getThis(), SL("_intermediate"), intermediate);
+	phalcon_update_property_null(getThis(), SL("_intermediateSource"));
 	RETURN_THIS();
 }
 
@@ -5252,3 +5569,27 @@ PHP_METHOD(Phalcon_Mvc_Model_Query, setConflict){
 	phalcon_update_property(getThis(), SL("_conflict"), conflict);
 	RETURN_THIS();
 }
+
+/**
+ * Returns the hits and misses of the PHQL statement cache
+ *
+ *<code>
+ *	ini_set('phalcon.orm.enable_statement_cache', true);
+ *	print_r(Phalcon\Mvc\Model\Query::getCacheStats());
+ *</code>
+ *
+ * @return array
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Query, getCacheStats){
+
+	phalcon_orm_get_statement_cache_stats(return_value);
+}
+
+/**
+ * Discards the cached intermediate representations and SQL statements, in every worker
+ * when the cache is shared. Call it after the models metadata changes
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Query, clearCache){
+
+	phalcon_orm_clear_cached_statements();
+}
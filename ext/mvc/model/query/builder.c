@@ -572,7 +572,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Query_Builder, getPhql){
 PHP_METHOD(Phalcon_Mvc_Model_Query_Builder, getQuery){
 
 	zval phql = {}, bind_params = {}, bind_types = {}, index = {}, dependency_injector = {}, service_name = {};
-	zval cache = {}, has = {}, args = {};
+	zval cache = {}, with = {}, has = {}, args = {};
 
 	PHALCON_MM_INIT();
 	/**
@@ -610,6 +610,10 @@ PHP_METHOD(Phalcon_Mvc_Model_Query_Builder, getQuery){
 		PHALCON_MM_CALL_METHOD(NULL, return_value, "cache", &cache);
 	}
 
+	if (phalcon_property_isset_fetch(&with, getThis(), SL("_with"), PH_READONLY)) {
+		PHALCON_MM_CALL_METHOD(NULL, return_value, "setwith", &with);
+	}
+
 	/**
 	 * Set default bind params
 	 */
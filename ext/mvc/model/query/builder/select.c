@@ -80,6 +80,8 @@ PHP_METHOD(Phalcon_Mvc_Model_Query_Builder_Select, getOffset);
 PHP_METHOD(Phalcon_Mvc_Model_Query_Builder_Select, groupBy);
 PHP_METHOD(Phalcon_Mvc_Model_Query_Builder_Select, getGroupBy);
 PHP_METHOD(Phalcon_Mvc_Model_Query_Builder_Select, cache);
+PHP_METHOD(Phalcon_Mvc_Model_Query_Builder_Select, with);
+PHP_METHOD(Phalcon_Mvc_Model_Query_Builder_Select, getWith);
 PHP_METHOD(Phalcon_Mvc_Model_Query_Builder_Select, _compile);
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_query_builder_select___construct, 0, 0, 0)
@@ -130,6 +132,10 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_query_builder_select_cache, 0,
 	ZEND_ARG_INFO(0, cacheOptions)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_query_builder_select_with, 0, 0, 1)
+	ZEND_ARG_INFO(0, with)
+ZEND_END_ARG_INFO()
+
 static const zend_function_entry phalcon_mvc_model_query_builder_select_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Model_Query_Builder_Select, __construct, arginfo_phalcon_mvc_model_query_builder_select___construct, ZEND_ACC_PUBLIC|ZEND_ACC_CTOR)
 	PHP_ME(Phalcon_Mvc_Model_Query_Builder_Select, distinct, arginfo_phalcon_mvc_model_query_builder_select_distinct, ZEND_ACC_PUBLIC)
@@ -150,6 +156,8 @@ static const zend_function_entry phalcon_mvc_model_query_builder_select_method_e
 	PHP_ME(Phalcon_Mvc_Model_Query_Builder_Select, groupBy, arginfo_phalcon_mvc_model_query_builder_select_groupby, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Query_Builder_Select, getGroupBy, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Query_Builder_Select, cache, arginfo_phalcon_mvc_model_query_builder_select_cache, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Query_Builder_Select, with, arginfo_phalcon_mvc_model_query_builder_select_with, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Query_Builder_Select, getWith, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Query_Builder_Select, _compile, NULL, ZEND_ACC_PROTECTED)
 	PHP_FE_END
 };
@@ -173,6 +181,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Query_Builder_Select){
 	zend_declare_property_null(phalcon_mvc_model_query_builder_select_ce, SL("_sharedLock"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_builder_select_ce, SL("_distinct"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_query_builder_select_ce, SL("_cache"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_query_builder_select_ce, SL("_with"), ZEND_ACC_PROTECTED);
 
 	zend_class_implements(phalcon_mvc_model_query_builder_select_ce, 1, phalcon_mvc_model_query_builderinterface_ce);
 
@@ -200,6 +209,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Query_Builder_Select){
  *    'limit'      => 20,
  *    'offset'     => 20,
  *    // or 'limit' => array(20, 20),
+ *    'with'       => array('robotsParts.parts'),
  * );
  * $queryBuilder = new Phalcon\Mvc\Model\Query\Builder\Select($params);
  *</code>
@@ -221,13 +231,17 @@ PHP_METHOD(Phalcon_Mvc_Model_Query_Builder_Select, __construct){
 	}
 
 	if (params && Z_TYPE_P(params) == IS_ARRAY) {
-		zval cache = {}, conditions = {}, bind_params = {}, bind_types = {}, models = {}, index = {}, columns = {}, group_clause = {}, joins = {};
+		zval cache = {}, with = {}, conditions = {}, bind_params = {}, bind_types = {}, models = {}, index = {}, columns = {}, group_clause = {}, joins = {};
 		zval having_clause = {}, order_clause = {}, limit_clause = {}, offset_clause = {}, limit = {}, offset = {}, for_update = {}, shared_lock = {};
 
 		if (phalcon_array_isset_fetch_str(&cache, params, SL("cache"), PH_READONLY)) {
 			phalcon_update_property(getThis(), SL("_cache"), &cache);
 		}
 
+		if (phalcon_array_isset_fetch_str(&with, params, SL("with"), PH_READONLY)) {
+			phalcon_update_property(getThis(), SL("_with"), &with);
+		}
+
 		/**
 		 * Process conditions
 		 */
@@ -658,6 +672,37 @@ PHP_METHOD(Phalcon_Mvc_Model_Query_Builder_Select, cache){
 	RETURN_THIS();
 }
 
+/**
+ * Sets the relations to eager load into the records returned by the query
+ *
+ *<code>
+ * $builder->with(array('robotsParts.parts', 'owner'));
+ *</code>
+ *
+ * @param string|array $with
+ * @return Phalcon\Mvc\Model\Query\Builder\Select
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Query_Builder_Select, with){
+
+	zval *with;
+
+	phalcon_fetch_params(0, 1, 0, &with);
+
+	phalcon_update_property(getThis(), SL("_with"), with);
+	RETURN_THIS();
+}
+
+/**
+ * Returns the relations to eager load
+ *
+ * @return string|array
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Query_Builder_Select, getWith){
+
+
+	RETURN_MEMBER(getThis(), "_with");
+}
+
 /**
  * Returns a PHQL statement built based on the builder parameters
  *
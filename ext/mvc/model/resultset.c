@@ -20,6 +20,7 @@
 #include "mvc/model/resultset.h"
 #include "mvc/model/resultsetinterface.h"
 #include "mvc/model/exception.h"
+#include "mvc/model/manager.h"
 #include "di/injectable.h"
 
 #ifdef PHALCON_USE_PHP_JSON
@@ -75,6 +76,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset, offsetGet);
 PHP_METHOD(Phalcon_Mvc_Model_Resultset, offsetSet);
 PHP_METHOD(Phalcon_Mvc_Model_Resultset, offsetUnset);
 PHP_METHOD(Phalcon_Mvc_Model_Resultset, getType);
+PHP_METHOD(Phalcon_Mvc_Model_Resultset, setType);
 PHP_METHOD(Phalcon_Mvc_Model_Resultset, getFirst);
 PHP_METHOD(Phalcon_Mvc_Model_Resultset, getLast);
 PHP_METHOD(Phalcon_Mvc_Model_Resultset, setIsFresh);
@@ -89,6 +91,10 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset, filter);
 PHP_METHOD(Phalcon_Mvc_Model_Resultset, update);
 PHP_METHOD(Phalcon_Mvc_Model_Resultset, jsonSerialize);
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_resultset_settype, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, type, IS_LONG, 0)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_model_resultset_sethydratemode, 0, 0, 1)
 	ZEND_ARG_INFO(0, hydrateMode)
 ZEND_END_ARG_INFO()
@@ -117,6 +123,7 @@ static const zend_function_entry phalcon_mvc_model_resultset_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Model_Resultset, offsetSet, arginfo_arrayaccess_offsetset, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Resultset, offsetUnset, arginfo_arrayaccess_offsetunset, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Resultset, getType, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Model_Resultset, setType, arginfo_phalcon_mvc_model_resultset_settype, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Resultset, getFirst, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Resultset, getLast, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Model_Resultset, setIsFresh, arginfo_phalcon_mvc_model_resultsetinterface_setisfresh, ZEND_ACC_PUBLIC)
@@ -145,6 +152,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Resultset){
 	zend_declare_property_null(phalcon_mvc_model_resultset_ce, SL("_cache"), ZEND_ACC_PROTECTED);
 	zend_declare_property_bool(phalcon_mvc_model_resultset_ce, SL("_isFresh"), 1, ZEND_ACC_PROTECTED);
 	zend_declare_property_long(phalcon_mvc_model_resultset_ce, SL("_pointer"), -1, ZEND_ACC_PROTECTED);
+	zend_declare_property_long(phalcon_mvc_model_resultset_ce, SL("_streamPointer"), -1, ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_resultset_ce, SL("_count"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_resultset_ce, SL("_activeRow"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_resultset_ce, SL("_rows"), ZEND_ACC_PROTECTED);
@@ -153,6 +161,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Resultset){
 
 	zend_declare_class_constant_long(phalcon_mvc_model_resultset_ce, SL("TYPE_RESULT_FULL"),    PHALCON_MVC_MODEL_RESULTSET_TYPE_FULL);
 	zend_declare_class_constant_long(phalcon_mvc_model_resultset_ce, SL("TYPE_RESULT_PARTIAL"), PHALCON_MVC_MODEL_RESULTSET_TYPE_PARTIAL);
+	zend_declare_class_constant_long(phalcon_mvc_model_resultset_ce, SL("TYPE_RESULT_STREAM"),  PHALCON_MVC_MODEL_RESULTSET_TYPE_STREAM);
 	zend_declare_class_constant_long(phalcon_mvc_model_resultset_ce, SL("HYDRATE_RECORDS"), 0);
 	zend_declare_class_constant_long(phalcon_mvc_model_resultset_ce, SL("HYDRATE_OBJECTS"), 2);
 	zend_declare_class_constant_long(phalcon_mvc_model_resultset_ce, SL("HYDRATE_ARRAYS"), 1);
@@ -193,10 +202,19 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset, key){
  */
 PHP_METHOD(Phalcon_Mvc_Model_Resultset, rewind){
 
-	zval type = {}, result = {}, active_row = {}, rows = {}, r = {};
+	zval type = {}, result = {}, active_row = {}, rows = {}, r = {}, stream_pointer = {};
 
 	phalcon_read_property(&type, getThis(), SL("_type"), PH_NOISY|PH_READONLY);
-	if (zend_is_true(&type)) {
+	if (PHALCON_IS_LONG(&type, PHALCON_MVC_MODEL_RESULTSET_TYPE_STREAM)) {
+		/**
+		 * Streaming resultsets are forward-only, only the first row can be returned again
+		 */
+		phalcon_read_property(&stream_pointer, getThis(), SL("_streamPointer"), PH_NOISY|PH_READONLY);
+		if (phalcon_get_intval(&stream_pointer) > 0) {
+			PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Streaming resultsets are forward-only and cannot be rewound");
+			return;
+		}
+	} else if (zend_is_true(&type)) {
 
 		/**
 		 * Here, the resultset act as a result that is fetched one by one
@@ -239,7 +257,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset, rewind){
  */
 PHP_METHOD(Phalcon_Mvc_Model_Resultset, seek){
 
-	zval *position, type = {}, result = {}, rows = {}, pointer = {}, is_different = {};
+	zval *position, type = {}, result = {}, rows = {}, pointer = {}, is_different = {}, stream_pointer = {};
 	HashTable *ah0;
 	long i;
 
@@ -256,7 +274,17 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset, seek){
 
 		phalcon_read_property(&type, getThis(), SL("_type"), PH_NOISY|PH_READONLY);
 
-		if (zend_is_true(&type)) {
+		if (PHALCON_IS_LONG(&type, PHALCON_MVC_MODEL_RESULTSET_TYPE_STREAM)) {
+			/**
+			 * Rows are skipped by 'valid', streaming resultsets only move forward
+			 */
+			phalcon_read_property(&stream_pointer, getThis(), SL("_streamPointer"), PH_NOISY|PH_READONLY);
+			if (phalcon_get_intval(position) < phalcon_get_intval(&stream_pointer)) {
+				PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Streaming resultsets are forward-only and cannot seek backwards");
+				return;
+			}
+			phalcon_update_property(getThis(), SL("_pointer"), position);
+		} else if (zend_is_true(&type)) {
 			/**
 			 * Here, the resultset is fetched one by one because is large
 			 */
@@ -322,7 +350,13 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset, count){
 		ZVAL_LONG(&count, 0);
 
 		phalcon_read_property(&type, getThis(), SL("_type"), PH_NOISY|PH_READONLY);
-		if (zend_is_true(&type)) {
+		if (PHALCON_IS_LONG(&type, PHALCON_MVC_MODEL_RESULTSET_TYPE_STREAM)) {
+			/**
+			 * Unbuffered results don't know how many rows they have until they are read
+			 */
+			PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Streaming resultsets cannot be counted");
+			return;
+		} else if (zend_is_true(&type)) {
 			/**
 			 * Here, the resultset act as a result that is fetched one by one
 			 */
@@ -455,6 +489,38 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset, getType){
 	RETURN_MEMBER(getThis(), "_type");
 }
 
+/**
+ * Changes the internal type of data retrieval, this is only allowed before the resultset is traversed.
+ * Streaming resultsets (TYPE_RESULT_STREAM) read the rows forward-only without keeping them in memory
+ *
+ *<code>
+ * $robots->setType(Phalcon\Mvc\Model\Resultset::TYPE_RESULT_STREAM);
+ *</code>
+ *
+ * @param int $type
+ * @return Phalcon\Mvc\Model\Resultset
+ */
+PHP_METHOD(Phalcon_Mvc_Model_Resultset, setType){
+
+	zval *type, active_row = {};
+
+	phalcon_fetch_params(0, 1, 0, &type);
+
+	if (Z_TYPE_P(type) != IS_LONG || Z_LVAL_P(type) < PHALCON_MVC_MODEL_RESULTSET_TYPE_FULL || Z_LVAL_P(type) > PHALCON_MVC_MODEL_RESULTSET_TYPE_STREAM) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Invalid resultset type");
+		return;
+	}
+
+	phalcon_read_property(&active_row, getThis(), SL("_activeRow"), PH_NOISY|PH_READONLY);
+	if (Z_TYPE(active_row) != IS_NULL) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "The resultset type cannot be changed once it has been traversed");
+		return;
+	}
+
+	phalcon_update_property(getThis(), SL("_type"), type);
+	RETURN_THIS();
+}
+
 /**
  * Get first row in the resultset
  *
@@ -679,6 +745,9 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset, delete){
 			 * Rollback the transaction
 			 */
 			PHALCON_MM_CALL_METHOD(NULL, &connection, "rollback");
+			if (phalcon_mvc_model_manager_identity_rollback(&record) == FAILURE) {
+				RETURN_MM();
+			}
 
 			ZVAL_BOOL(&transaction, 0);
 			break;
@@ -827,6 +896,10 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset, update){
 			 * Rollback the transaction
 			 */
 			PHALCON_CALL_METHOD(NULL, &connection, "rollback");
+			if (phalcon_mvc_model_manager_identity_rollback(&record) == FAILURE) {
+				zval_ptr_dtor(&record);
+				return;
+			}
 
 			ZVAL_FALSE(&transaction);
 			zval_ptr_dtor(&record);
@@ -28,5 +28,6 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Resultset);
 
 #define PHALCON_MVC_MODEL_RESULTSET_TYPE_FULL       0
 #define PHALCON_MVC_MODEL_RESULTSET_TYPE_PARTIAL    1
+#define PHALCON_MVC_MODEL_RESULTSET_TYPE_STREAM     2
 
 #endif /* PHALCON_MVC_MODEL_RESULTSET_H */
@@ -23,6 +23,8 @@
 #include "mvc/model/row.h"
 #include "mvc/model/exception.h"
 #include "mvc/model.h"
+#include "mvc/model/manager.h"
+#include "mvc/model/metadata.h"
 
 #include <ext/pdo/php_pdo_driver.h>
 
@@ -37,6 +39,7 @@
 #include "kernel/string.h"
 #include "kernel/variables.h"
 #include "kernel/exception.h"
+#include "kernel/framework/orm.h"
 
 #include "internal/arginfo.h"
 
@@ -84,6 +87,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Resultset_Complex){
 	zend_declare_property_null(phalcon_mvc_model_resultset_complex_ce, SL("_rowsModels"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_resultset_complex_ce, SL("_rowsObjects"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_resultset_complex_ce, SL("_rowsArrays"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_resultset_complex_ce, SL("_hydrationPlans"), ZEND_ACC_PROTECTED);
 
 	return SUCCESS;
 }
@@ -156,7 +160,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset_Complex, valid){
 	zend_class_entry *ce;
 	zend_string *str_key;
 	ulong idx;
-	int i_type, is_partial, i_hydrate_mode;
+	int i_type, is_partial, is_stream, i_hydrate_mode, flag = SUCCESS;
 
 	PHALCON_MM_INIT();
 
@@ -167,6 +171,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset_Complex, valid){
 	phalcon_read_property(&type, getThis(), SL("_type"), PH_NOISY|PH_READONLY);
 	i_type = (Z_TYPE(type) == IS_LONG) ? Z_LVAL(type) : phalcon_get_intval(&type);
 	is_partial = (i_type == PHALCON_MVC_MODEL_RESULTSET_TYPE_PARTIAL);
+	is_stream = (i_type == PHALCON_MVC_MODEL_RESULTSET_TYPE_STREAM);
 
 	if (Z_TYPE(source_model) == IS_OBJECT) {
 		ce = Z_OBJCE(source_model);
@@ -174,7 +179,53 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset_Complex, valid){
 		ce = phalcon_mvc_model_ce;
 	}
 
-	if (is_partial) {
+	if (is_stream) {
+		zval result = {}, stream_pointer = {};
+		long skip;
+
+		/**
+		 * Streaming resultsets fetch every row once, nothing is kept except the active row
+		 */
+		phalcon_read_property(&stream_pointer, getThis(), SL("_streamPointer"), PH_NOISY|PH_READONLY);
+		skip = phalcon_get_intval(&key) - phalcon_get_intval(&stream_pointer);
+		if (skip == 0) {
+			phalcon_read_property(&active_row, getThis(), SL("_activeRow"), PH_NOISY|PH_READONLY);
+			RETURN_MM_BOOL(Z_TYPE(active_row) == IS_OBJECT || Z_TYPE(active_row) == IS_ARRAY);
+		}
+
+		if (skip < 0) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Streaming resultsets are forward-only and cannot seek backwards");
+			return;
+		}
+
+		phalcon_update_property(getThis(), SL("_streamPointer"), &key);
+
+		phalcon_read_property(&result, getThis(), SL("_result"), PH_NOISY|PH_READONLY);
+		if (Z_TYPE(result) == IS_OBJECT) {
+			while (skip-- > 0) {
+				zval_ptr_dtor(&row);
+				PHALCON_CALL_METHOD_FLAG(flag, &row, &result, "fetch");
+				if (flag == FAILURE) {
+					RETURN_MM();
+				}
+				if (Z_TYPE(row) != IS_ARRAY) {
+					zval statement = {};
+					/**
+					 * Release the cursor as soon as the last row is read
+					 */
+					PHALCON_MM_CALL_METHOD(&statement, &result, "getinternalresult");
+					PHALCON_MM_ADD_ENTRY(&statement);
+					if (Z_TYPE(statement) == IS_OBJECT) {
+						PHALCON_MM_CALL_METHOD(NULL, &statement, "closecursor");
+					}
+					break;
+				}
+			}
+			PHALCON_MM_ADD_ENTRY(&row);
+		} else {
+			ZVAL_FALSE(&row);
+		}
+	} else if (is_partial) {
 		/**
 		 * The result is bigger than 32 rows so it's retrieved one by one
 		 */
@@ -223,7 +274,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset_Complex, valid){
 		/**
 		 * The result type=1 so we need to build every row
 		 */
-		if (!is_partial) {
+		if (!is_partial && !is_stream) {
 			/**
 			 * The row is already built so we just assign it to the activeRow
 			 */
@@ -345,7 +396,7 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset_Complex, valid){
 				switch (i_hydrate_mode) {
 
 					case 0: {
-						zval instance = {};
+						zval instance = {}, column_key = {}, hydration_plan = {}, identity_manager = {}, identity_key = {};
 
 						/**
 						 * Get the base instance
@@ -356,9 +407,61 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset_Complex, valid){
 						}
 
 						/**
-						 * Assign the values to the attributes using a column map
+						 * The hydration plan of every column is resolved once, it is false if the records
+						 * must be cloned by the model itself
 						 */
-						PHALCON_MM_CALL_CE_STATIC(&value, ce, "cloneresultmap", &instance, &row_model, &column_map, &dirty_state, &source_model);
+						if (str_key) {
+							ZVAL_STR(&column_key, str_key);
+						} else {
+							ZVAL_LONG(&column_key, idx);
+						}
+						if (!phalcon_property_array_isset_fetch(&hydration_plan, getThis(), SL("_hydrationPlans"), &column_key, PH_READONLY)) {
+							zend_function *fbc = zend_hash_str_find_ptr(&ce->function_table, SL("cloneresultmap"));
+
+							ZVAL_FALSE(&hydration_plan);
+							if (Z_TYPE(source_model) == IS_OBJECT && Z_TYPE(instance) == IS_OBJECT && Z_OBJCE(instance) == ce
+								&& fbc && fbc->type == ZEND_INTERNAL_FUNCTION && fbc->common.scope == phalcon_mvc_model_ce) {
+								zval meta_data = {}, plan = {}, native = {};
+
+								PHALCON_MM_CALL_METHOD(&meta_data, &source_model, "getmodelsmetadata");
+								PHALCON_MM_ADD_ENTRY(&meta_data);
+								if (instanceof_function(Z_OBJCE(meta_data), phalcon_mvc_model_metadata_ce)) {
+									PHALCON_MM_CALL_METHOD(&plan, &meta_data, "gethydrationplan", &source_model, &column_map);
+									PHALCON_MM_ADD_ENTRY(&plan);
+									if (phalcon_array_isset_fetch_str(&native, &plan, SL("native"), PH_READONLY) && zend_is_true(&native)) {
+										ZVAL_COPY_VALUE(&hydration_plan, &plan);
+									}
+								}
+							}
+							phalcon_update_property_array(getThis(), SL("_hydrationPlans"), &column_key, &hydration_plan);
+						}
+
+						if (Z_TYPE(hydration_plan) == IS_ARRAY) {
+							/**
+							 * Records kept by the identity map are reused, streams keep no record
+							 */
+							if (PHALCON_GLOBAL(orm).enable_identity_map && !is_stream) {
+								flag = phalcon_mvc_model_manager_identity_fetch(&value, &identity_manager, &identity_key, &instance, &row_model);
+								PHALCON_MM_ADD_ENTRY(&identity_manager);
+								PHALCON_MM_ADD_ENTRY(&identity_key);
+								if (flag == FAILURE) {
+									zval_ptr_dtor(&value);
+									RETURN_MM();
+								}
+							}
+							if (Z_TYPE(value) != IS_OBJECT) {
+								if (phalcon_orm_hydrate(&value, &instance, &row_model, &hydration_plan, &dirty_state, &source_model) == FAILURE) {
+									zval_ptr_dtor(&value);
+									RETURN_MM();
+								}
+								phalcon_mvc_model_manager_identity_store(&identity_manager, &identity_key, &value);
+							}
+						} else {
+							/**
+							 * Assign the values to the attributes using a column map
+							 */
+							PHALCON_MM_CALL_CE_STATIC(&value, ce, "cloneresultmap", &instance, &row_model, &column_map, &dirty_state, &source_model);
+						}
 						PHALCON_MM_ADD_ENTRY(&value);
 						break;
 					}
@@ -431,22 +534,24 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset_Complex, valid){
 		if (Z_TYPE(active_row) == IS_OBJECT && phalcon_method_exists_ex(&active_row, SL("afterfetch")) == SUCCESS) {
 			PHALCON_MM_CALL_METHOD(NULL, &active_row, "afterfetch");
 		}
-		switch (i_hydrate_mode) {
-			case 0:
-			{
-				phalcon_update_property_array(getThis(), SL("_rowsModels"), &key, &active_row);
-				break;
-			}
-			case 1:
-			{
-				phalcon_update_property_array(getThis(), SL("_rowsArrays"), &key, &active_row);
-				break;
-			}
-			case 2:
-			default:
-			{
-				phalcon_update_property_array(getThis(), SL("_rowsObjects"), &key, &active_row);
-				break;
+		if (!is_stream) {
+			switch (i_hydrate_mode) {
+				case 0:
+				{
+					phalcon_update_property_array(getThis(), SL("_rowsModels"), &key, &active_row);
+					break;
+				}
+				case 1:
+				{
+					phalcon_update_property_array(getThis(), SL("_rowsArrays"), &key, &active_row);
+					break;
+				}
+				case 2:
+				default:
+				{
+					phalcon_update_property_array(getThis(), SL("_rowsObjects"), &key, &active_row);
+					break;
+				}
 			}
 		}
 		/**
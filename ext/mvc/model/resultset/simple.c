@@ -22,6 +22,8 @@
 #include "mvc/model/resultsetinterface.h"
 #include "mvc/model/exception.h"
 #include "mvc/model.h"
+#include "mvc/model/manager.h"
+#include "mvc/model/metadata.h"
 
 #include <ext/pdo/php_pdo_driver.h>
 
@@ -35,6 +37,7 @@
 #include "kernel/concat.h"
 #include "kernel/exception.h"
 #include "kernel/variables.h"
+#include "kernel/framework/orm.h"
 
 #include "internal/arginfo.h"
 
@@ -86,6 +89,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Resultset_Simple){
 	zend_declare_property_null(phalcon_mvc_model_resultset_simple_ce, SL("_columnMap"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_resultset_simple_ce, SL("_rowsModels"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_model_resultset_simple_ce, SL("_rowsObjects"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_model_resultset_simple_ce, SL("_hydrationPlan"), ZEND_ACC_PROTECTED);
 
 	return SUCCESS;
 }
@@ -138,8 +142,10 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset_Simple, __construct){
 PHP_METHOD(Phalcon_Mvc_Model_Resultset_Simple, valid){
 
 	zval key = {}, type = {}, row = {}, rows = {}, dirty_state = {}, hydrate_mode = {}, column_map = {};
-	zval source_model = {}, model = {}, active_row = {}, rows_objects = {};
+	zval source_model = {}, model = {}, active_row = {}, rows_objects = {}, hydration_plan = {};
+	zval identity_manager = {}, identity_key = {};
 	zend_class_entry *ce;
+	int is_stream, flag = SUCCESS;
 
 	PHALCON_MM_INIT();
 
@@ -147,7 +153,54 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset_Simple, valid){
 	PHALCON_MM_ADD_ENTRY(&key);
 
 	phalcon_read_property(&type, getThis(), SL("_type"), PH_NOISY|PH_READONLY);
-	if (zend_is_true(&type)) {
+	is_stream = PHALCON_IS_LONG(&type, PHALCON_MVC_MODEL_RESULTSET_TYPE_STREAM);
+	if (is_stream) {
+		zval result = {}, stream_pointer = {};
+		long skip;
+
+		/**
+		 * Streaming resultsets fetch every row once, nothing is kept except the active row
+		 */
+		phalcon_read_property(&stream_pointer, getThis(), SL("_streamPointer"), PH_NOISY|PH_READONLY);
+		skip = phalcon_get_intval(&key) - phalcon_get_intval(&stream_pointer);
+		if (skip == 0) {
+			phalcon_read_property(&active_row, getThis(), SL("_activeRow"), PH_NOISY|PH_READONLY);
+			RETURN_MM_BOOL(Z_TYPE(active_row) == IS_OBJECT || Z_TYPE(active_row) == IS_ARRAY);
+		}
+
+		if (skip < 0) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_model_exception_ce, "Streaming resultsets are forward-only and cannot seek backwards");
+			return;
+		}
+
+		phalcon_update_property(getThis(), SL("_streamPointer"), &key);
+
+		phalcon_read_property(&result, getThis(), SL("_result"), PH_NOISY|PH_READONLY);
+		if (Z_TYPE(result) == IS_OBJECT) {
+			while (skip-- > 0) {
+				zval_ptr_dtor(&row);
+				PHALCON_CALL_METHOD_FLAG(flag, &row, &result, "fetch");
+				if (flag == FAILURE) {
+					RETURN_MM();
+				}
+				if (Z_TYPE(row) != IS_ARRAY) {
+					zval statement = {};
+					/**
+					 * Release the cursor as soon as the last row is read
+					 */
+					PHALCON_MM_CALL_METHOD(&statement, &result, "getinternalresult");
+					PHALCON_MM_ADD_ENTRY(&statement);
+					if (Z_TYPE(statement) == IS_OBJECT) {
+						PHALCON_MM_CALL_METHOD(NULL, &statement, "closecursor");
+					}
+					break;
+				}
+			}
+			PHALCON_MM_ADD_ENTRY(&row);
+		} else {
+			ZVAL_FALSE(&row);
+		}
+	} else if (zend_is_true(&type)) {
 		if (!phalcon_property_array_isset_fetch(&row, getThis(), SL("_rows"), &key, PH_READONLY)) {
 			zval result = {};
 			phalcon_read_property(&result, getThis(), SL("_result"), PH_NOISY|PH_READONLY);
@@ -224,12 +277,64 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset_Simple, valid){
 				 */
 				phalcon_read_property(&model, getThis(), SL("_model"), PH_NOISY|PH_READONLY);
 
+				/**
+				 * The hydration plan is resolved once, it is false if the records must be cloned
+				 * by the model itself
+				 */
+				phalcon_read_property(&hydration_plan, getThis(), SL("_hydrationPlan"), PH_NOISY|PH_READONLY);
+				if (Z_TYPE(hydration_plan) == IS_NULL) {
+					zend_function *fbc = zend_hash_str_find_ptr(&ce->function_table, SL("cloneresultmap"));
+
+					ZVAL_FALSE(&hydration_plan);
+					if (Z_TYPE(source_model) == IS_OBJECT && Z_TYPE(model) == IS_OBJECT && Z_OBJCE(model) == ce
+						&& fbc && fbc->type == ZEND_INTERNAL_FUNCTION && fbc->common.scope == phalcon_mvc_model_ce) {
+						zval meta_data = {}, plan = {}, native = {};
+
+						PHALCON_MM_CALL_METHOD(&meta_data, &source_model, "getmodelsmetadata");
+						PHALCON_MM_ADD_ENTRY(&meta_data);
+						if (instanceof_function(Z_OBJCE(meta_data), phalcon_mvc_model_metadata_ce)) {
+							PHALCON_MM_CALL_METHOD(&plan, &meta_data, "gethydrationplan", &source_model, &column_map);
+							PHALCON_MM_ADD_ENTRY(&plan);
+							if (phalcon_array_isset_fetch_str(&native, &plan, SL("native"), PH_READONLY) && zend_is_true(&native)) {
+								ZVAL_COPY_VALUE(&hydration_plan, &plan);
+							}
+						}
+					}
+					phalcon_update_property(getThis(), SL("_hydrationPlan"), &hydration_plan);
+				}
+
+				/**
+				 * Records kept by the identity map are reused, cloneResultMap looks them up by itself.
+				 * Streams keep no record, registering each row would make the map hold all of them
+				 */
+				if (PHALCON_GLOBAL(orm).enable_identity_map && !is_stream && Z_TYPE(hydration_plan) == IS_ARRAY) {
+					int status = phalcon_mvc_model_manager_identity_fetch(&active_row, &identity_manager, &identity_key, &model, &row);
+					PHALCON_MM_ADD_ENTRY(&identity_manager);
+					PHALCON_MM_ADD_ENTRY(&identity_key);
+					if (status == FAILURE) {
+						zval_ptr_dtor(&active_row);
+						RETURN_MM();
+					}
+				}
+
 				/**
 				 * Performs the standard hydration based on objects
 				 */
-				PHALCON_MM_CALL_CE_STATIC(&active_row, ce, "cloneresultmap", &model, &row, &column_map, &dirty_state, &source_model);
+				if (Z_TYPE(hydration_plan) == IS_ARRAY) {
+					if (Z_TYPE(active_row) != IS_OBJECT) {
+						if (phalcon_orm_hydrate(&active_row, &model, &row, &hydration_plan, &dirty_state, &source_model) == FAILURE) {
+							zval_ptr_dtor(&active_row);
+							RETURN_MM();
+						}
+						phalcon_mvc_model_manager_identity_store(&identity_manager, &identity_key, &active_row);
+					}
+				} else {
+					PHALCON_MM_CALL_CE_STATIC(&active_row, ce, "cloneresultmap", &model, &row, &column_map, &dirty_state, &source_model);
+				}
 				PHALCON_MM_ADD_ENTRY(&active_row);
-				phalcon_update_property_array(getThis(), SL("_rowsModels"), &key, &active_row);
+				if (!is_stream) {
+					phalcon_update_property_array(getThis(), SL("_rowsModels"), &key, &active_row);
+				}
 			}
 			break;
 
@@ -241,7 +346,9 @@ PHP_METHOD(Phalcon_Mvc_Model_Resultset_Simple, valid){
 				 */
 				PHALCON_MM_CALL_CE_STATIC(&active_row, ce, "cloneresultmaphydrate", &row, &column_map, &hydrate_mode, &source_model);
 				PHALCON_MM_ADD_ENTRY(&active_row);
-				phalcon_update_property_array(getThis(), SL("_rowsModels"), &key, &active_row);
+				if (!is_stream) {
+					phalcon_update_property_array(getThis(), SL("_rowsObjects"), &key, &active_row);
+				}
 			}
 			break;
 	}
@@ -22,7 +22,10 @@
 #include "mvc/model/transaction/exception.h"
 #include "mvc/model/transaction/failed.h"
 #include "mvc/model/transaction/managerinterface.h"
+#include "mvc/model/manager.h"
 #include "di/injectable.h"
+#include "db/router.h"
+#include "db/pool.h"
 
 #include "kernel/main.h"
 #include "kernel/memory.h"
@@ -139,6 +142,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Model_Transaction){
 PHP_METHOD(Phalcon_Mvc_Model_Transaction, __construct){
 
 	zval *dependency_injector, *auto_begin = NULL, *s = NULL, service = {}, connection = {};
+	int status;
 
 	phalcon_fetch_params(0, 1, 2, &dependency_injector, &auto_begin, &s);
 
@@ -164,6 +168,34 @@ PHP_METHOD(Phalcon_Mvc_Model_Transaction, __construct){
 	PHALCON_CALL_METHOD(&connection, dependency_injector, "get", &service);
 	zval_ptr_dtor(&service);
 
+	/**
+	 * Transactions always run on the primary of a router
+	 */
+	if (Z_TYPE(connection) == IS_OBJECT && instanceof_function(Z_OBJCE(connection), phalcon_db_router_ce)) {
+		zval router = {};
+		ZVAL_COPY_VALUE(&router, &connection);
+		ZVAL_NULL(&connection);
+		PHALCON_CALL_METHOD_FLAG(status, &connection, &router, "getwriteconnection");
+		zval_ptr_dtor(&router);
+		if (status == FAILURE) {
+			return;
+		}
+	}
+
+	/**
+	 * With a pool the transaction runs on the connection of the current task
+	 */
+	if (Z_TYPE(connection) == IS_OBJECT && instanceof_function(Z_OBJCE(connection), phalcon_db_pool_ce)) {
+		zval pool = {};
+		ZVAL_COPY_VALUE(&pool, &connection);
+		ZVAL_NULL(&connection);
+		PHALCON_CALL_METHOD_FLAG(status, &connection, &pool, "get");
+		zval_ptr_dtor(&pool);
+		if (status == FAILURE) {
+			return;
+		}
+	}
+
 	phalcon_update_property(getThis(), SL("_connection"), &connection);
 	if (zend_is_true(auto_begin)) {
 		PHALCON_CALL_METHOD(NULL, &connection, "begin");
@@ -261,6 +293,13 @@ PHP_METHOD(Phalcon_Mvc_Model_Transaction, rollback){
 
 	PHALCON_CALL_METHOD(&success, &connection, "rollback");
 
+	/**
+	 * Records kept by the identity map could hold changes that were rolled back
+	 */
+	if (phalcon_mvc_model_manager_identity_rollback(getThis()) == FAILURE) {
+		return;
+	}
+
 	if (!zend_is_true(nothrowerror) && zend_is_true(&success)) {
 		object_init_ex(&i0, phalcon_mvc_model_transaction_failed_ce);
 		PHALCON_CALL_METHOD(NULL, &i0, "__construct", &rollback_message, &rollback_record, rollback_code);
@@ -27,6 +27,11 @@
 #include "diinterface.h"
 #include "di/injectable.h"
 #include "http/requestinterface.h"
+#include "http/request.h"
+#include "cache/backendinterface.h"
+#ifdef PHALCON_CACHE_YAC
+#include "cache/yac.h"
+#endif
 #include "debug.h"
 
 #include <main/SAPI.h>
@@ -103,6 +108,9 @@ PHP_METHOD(Phalcon_Mvc_Router, setDefaultController);
 PHP_METHOD(Phalcon_Mvc_Router, getDefaultController);
 PHP_METHOD(Phalcon_Mvc_Router, setControllerName);
 PHP_METHOD(Phalcon_Mvc_Router, getControllerName);
+PHP_METHOD(Phalcon_Mvc_Router, exportRoutes);
+PHP_METHOD(Phalcon_Mvc_Router, importRoutes);
+PHP_METHOD(Phalcon_Mvc_Router, useCache);
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_router___construct, 0, 0, 0)
 	ZEND_ARG_TYPE_INFO(0, defaultRoutes, _IS_BOOL, 1)
@@ -124,6 +132,16 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_router_notfound, 0, 0, 1)
 	ZEND_ARG_TYPE_INFO(0, paths, IS_ARRAY, 0)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_router_importroutes, 0, 0, 1)
+	ZEND_ARG_TYPE_INFO(0, image, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_router_usecache, 0, 0, 2)
+	ZEND_ARG_TYPE_INFO(0, version, IS_STRING, 0)
+	ZEND_ARG_OBJ_INFO(0, builder, Closure, 0)
+	ZEND_ARG_INFO(0, cache)
+ZEND_END_ARG_INFO()
+
 static const zend_function_entry phalcon_mvc_router_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Router, __construct, arginfo_phalcon_mvc_router___construct, ZEND_ACC_PUBLIC|ZEND_ACC_CTOR)
 	PHP_ME(Phalcon_Mvc_Router, getRewriteUri, NULL, ZEND_ACC_PUBLIC)
@@ -154,9 +172,370 @@ static const zend_function_entry phalcon_mvc_router_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Router, getDefaultController, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Router, setControllerName, arginfo_phalcon_routerinterface_sethandlername, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Router, getControllerName, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Router, exportRoutes, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Router, importRoutes, arginfo_phalcon_mvc_router_importroutes, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Router, useCache, arginfo_phalcon_mvc_router_usecache, ZEND_ACC_PUBLIC)
 	PHP_FE_END
 };
 
+#define PHALCON_MVC_ROUTER_INDEX_NONE     0
+#define PHALCON_MVC_ROUTER_INDEX_SEGMENT  1
+#define PHALCON_MVC_ROUTER_INDEX_STATIC   2
+
+/**
+ * Reads a route property straight from Phalcon\Mvc\Router\Route, routes of other classes go through
+ * their getter as they may override it
+ */
+#define PHALCON_MVC_ROUTER_ROUTE_READ(result, route, property, getter) \
+	do { \
+		if (Z_OBJCE_P(route) == phalcon_mvc_router_route_ce) { \
+			phalcon_read_property(result, route, SL(property), PH_READONLY); \
+		} else { \
+			PHALCON_MM_CALL_METHOD(result, route, getter); \
+			PHALCON_MM_ADD_ENTRY(result); \
+		} \
+	} while (0)
+
+/**
+ * Route and router properties kept in a routes image, see exportRoutes()
+ */
+static const char *phalcon_mvc_router_route_image_properties[] = {
+	"_pattern", "_compiledPattern", "_paths", "_methods", "_prefix", "_hostname", "_id", "_name",
+	"_defaultNamespace", "_defaultModule", "_defaultController", "_defaultAction", "_defaultParams",
+	"_caseSensitive", "_mode", NULL
+};
+
+static const char *phalcon_mvc_router_image_properties[] = {
+	"_uriSource", "_removeExtraSlashes", "_notFoundPaths", "_defaultNamespace", "_defaultModule",
+	"_defaultHandler", "_defaultAction", "_defaultParams", "_caseSensitive", "_mode", NULL
+};
+
+typedef struct _phalcon_mvc_router_candidates {
+	HashTable *routes;
+	HashPosition position;
+	HashTable *lists[3];
+	uint32_t cursors[3];
+	int indexed;
+} phalcon_mvc_router_candidates;
+
+/**
+ * Computes the key used to place a compiled pattern in the routes index.
+ *
+ * Plain patterns are indexed by their full lowercased text. Regular expressions
+ * are indexed by the first path segment of their literal prefix; anything that
+ * cannot be reduced safely (alternations, extended mode, non-ASCII) is left out.
+ */
+static int phalcon_mvc_router_index_key(zval *key, zval *compiled_pattern)
+{
+	const char *str, *body, *end, *p, *slash;
+	size_t len, literal_len;
+	int depth = 0;
+
+	if (Z_TYPE_P(compiled_pattern) != IS_STRING || !Z_STRLEN_P(compiled_pattern)) {
+		return PHALCON_MVC_ROUTER_INDEX_NONE;
+	}
+
+	str = Z_STRVAL_P(compiled_pattern);
+	len = Z_STRLEN_P(compiled_pattern);
+
+	/**
+	 * Same rule used by handle(): without '^' the pattern is compared as a string
+	 */
+	if (len <= 3 || str[1] != '^') {
+		ZVAL_STR(key, zend_string_tolower(Z_STR_P(compiled_pattern)));
+		return PHALCON_MVC_ROUTER_INDEX_STATIC;
+	}
+
+	if (str[0] != '#') {
+		return PHALCON_MVC_ROUTER_INDEX_NONE;
+	}
+
+	/**
+	 * Look for the closing delimiter, extended mode makes whitespace meaningless
+	 */
+	end = str + len - 1;
+	while (end > str + 1 && *end != '#') {
+		if (*end == 'x') {
+			return PHALCON_MVC_ROUTER_INDEX_NONE;
+		}
+		end--;
+	}
+
+	if (end <= str + 1) {
+		return PHALCON_MVC_ROUTER_INDEX_NONE;
+	}
+
+	body = str + 2;
+
+	/**
+	 * A top-level alternation means the pattern has no common prefix
+	 */
+	for (p = body; p < end; p++) {
+		if (*p == '\\') {
+			p++;
+			continue;
+		}
+		if (*p == '[') {
+			p++;
+			if (p < end && *p == '^') {
+				p++;
+			}
+			if (p < end && *p == ']') {
+				p++;
+			}
+			while (p < end && *p != ']') {
+				if (*p == '\\') {
+					p++;
+				}
+				p++;
+			}
+			continue;
+		}
+		if (*p == '(') {
+			depth++;
+		} else if (*p == ')') {
+			depth--;
+		} else if (*p == '|' && depth <= 0) {
+			return PHALCON_MVC_ROUTER_INDEX_NONE;
+		}
+	}
+
+	for (p = body; p < end; p++) {
+		if (!*p || (unsigned char)*p >= 0x80 || strchr("\\.[](){}*+?|^$", *p)) {
+			break;
+		}
+	}
+
+	literal_len = p - body;
+
+	/**
+	 * A quantifier makes the previous character optional
+	 */
+	if (literal_len && p < end && (*p == '*' || *p == '?' || *p == '{' || *p == '+')) {
+		literal_len--;
+	}
+
+	if (literal_len < 2 || body[0] != '/') {
+		return PHALCON_MVC_ROUTER_INDEX_NONE;
+	}
+
+	slash = memchr(body + 1, '/', literal_len - 1);
+	if (!slash) {
+		return PHALCON_MVC_ROUTER_INDEX_NONE;
+	}
+
+	ZVAL_STRINGL(key, body, slash - body);
+	zend_str_tolower(Z_STRVAL_P(key), Z_STRLEN_P(key));
+
+	return PHALCON_MVC_ROUTER_INDEX_SEGMENT;
+}
+
+static void phalcon_mvc_router_index_append(zval *buckets, zval *key, zend_ulong position)
+{
+	zval *bucket, empty = {};
+
+	if ((bucket = zend_hash_find(Z_ARRVAL_P(buckets), Z_STR_P(key))) == NULL) {
+		array_init(&empty);
+		bucket = zend_hash_update(Z_ARRVAL_P(buckets), Z_STR_P(key), &empty);
+	}
+
+	add_next_index_long(bucket, position);
+}
+
+/**
+ * Builds the routes index: static patterns, first-segment buckets and the
+ * routes that must always be checked, every list in insertion order.
+ *
+ * Routes are placed by their getCompiledPattern(), subclasses overriding it must return the same
+ * pattern until reConfigure() is called again
+ */
+static int phalcon_mvc_router_build_index(zval *index, zval *routes)
+{
+	zval static_routes = {}, segment_routes = {}, wildcard_routes = {}, *route;
+	zend_string *str_key;
+	zend_ulong idx;
+
+	array_init_size(index, 5);
+
+	phalcon_array_update_str_long(index, SL("version"), PHALCON_GLOBAL(routes_version), 0);
+
+	if (Z_TYPE_P(routes) != IS_ARRAY) {
+		phalcon_array_update_str_long(index, SL("count"), 0, 0);
+		return SUCCESS;
+	}
+
+	phalcon_array_update_str_long(index, SL("count"), zend_hash_num_elements(Z_ARRVAL_P(routes)), 0);
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(routes), idx, str_key, route) {
+		if (str_key || Z_TYPE_P(route) != IS_OBJECT) {
+			/* Only plain lists of routes can be indexed */
+			return SUCCESS;
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	array_init(&static_routes);
+	array_init(&segment_routes);
+	array_init(&wildcard_routes);
+
+	ZEND_HASH_FOREACH_NUM_KEY_VAL(Z_ARRVAL_P(routes), idx, route) {
+		zval pattern = {}, key = {};
+
+		if (Z_OBJCE_P(route) == phalcon_mvc_router_route_ce) {
+			phalcon_read_property(&pattern, route, SL("_compiledPattern"), PH_COPY);
+		} else if (phalcon_call_method(&pattern, route, "getcompiledpattern", 0, NULL) == FAILURE) {
+			zval_ptr_dtor(&static_routes);
+			zval_ptr_dtor(&segment_routes);
+			zval_ptr_dtor(&wildcard_routes);
+			return FAILURE;
+		}
+
+		switch (phalcon_mvc_router_index_key(&key, &pattern)) {
+			case PHALCON_MVC_ROUTER_INDEX_STATIC:
+				phalcon_mvc_router_index_append(&static_routes, &key, idx);
+				zval_ptr_dtor(&key);
+				break;
+
+			case PHALCON_MVC_ROUTER_INDEX_SEGMENT:
+				phalcon_mvc_router_index_append(&segment_routes, &key, idx);
+				zval_ptr_dtor(&key);
+				break;
+
+			default:
+				add_next_index_long(&wildcard_routes, idx);
+				break;
+		}
+		zval_ptr_dtor(&pattern);
+	} ZEND_HASH_FOREACH_END();
+
+	phalcon_array_update_str(index, SL("static"), &static_routes, 0);
+	phalcon_array_update_str(index, SL("segments"), &segment_routes, 0);
+	phalcon_array_update_str(index, SL("wildcard"), &wildcard_routes, 0);
+	return SUCCESS;
+}
+
+/**
+ * Same comparison as Phalcon\Http\Request::isMethod() for an already known method
+ */
+static int phalcon_mvc_router_match_method(zval *methods, zval *http_method)
+{
+	zval *method;
+
+	if (Z_TYPE_P(methods) == IS_STRING) {
+		return PHALCON_IS_EQUAL(methods, http_method);
+	}
+
+	if (Z_TYPE_P(methods) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(methods), method) {
+			if (PHALCON_IS_EQUAL(method, http_method)) {
+				return 1;
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	return 0;
+}
+
+/**
+ * Prepares the list of routes to check for an URI, in reversed order. Falls back
+ * to a full scan when the index cannot be used
+ */
+static void phalcon_mvc_router_candidates_init(phalcon_mvc_router_candidates *candidates, zval *index, zval *routes, zval *uri)
+{
+	zval static_routes = {}, segment_routes = {}, wildcard_routes = {}, *bucket;
+	zend_string *lower_uri;
+	size_t segment_len;
+	int i;
+
+	memset(candidates, 0, sizeof(phalcon_mvc_router_candidates));
+	candidates->routes = Z_ARRVAL_P(routes);
+
+	if (!index || Z_TYPE_P(uri) != IS_STRING
+		|| !phalcon_array_isset_fetch_str(&wildcard_routes, index, SL("wildcard"), PH_READONLY)) {
+		zend_hash_internal_pointer_end_ex(candidates->routes, &candidates->position);
+		return;
+	}
+
+	/**
+	 * Case-insensitive PCRE in UTF-8 mode folds some non-ASCII characters to
+	 * ASCII, the first segment must be plain ASCII to be looked up
+	 */
+	for (segment_len = 1; segment_len < Z_STRLEN_P(uri) && Z_STRVAL_P(uri)[segment_len] != '/'; segment_len++) {
+		if ((unsigned char)Z_STRVAL_P(uri)[segment_len] >= 0x80) {
+			zend_hash_internal_pointer_end_ex(candidates->routes, &candidates->position);
+			return;
+		}
+	}
+
+	candidates->indexed = 1;
+	candidates->lists[0] = Z_ARRVAL(wildcard_routes);
+
+	lower_uri = zend_string_tolower(Z_STR_P(uri));
+
+	phalcon_array_isset_fetch_str(&static_routes, index, SL("static"), PH_READONLY);
+	if ((bucket = zend_hash_find(Z_ARRVAL(static_routes), lower_uri)) != NULL) {
+		candidates->lists[1] = Z_ARRVAL_P(bucket);
+	}
+
+	if (Z_STRLEN_P(uri) > 1 && ZSTR_VAL(lower_uri)[0] == '/') {
+		phalcon_array_isset_fetch_str(&segment_routes, index, SL("segments"), PH_READONLY);
+		if ((bucket = zend_hash_str_find(Z_ARRVAL(segment_routes), ZSTR_VAL(lower_uri), segment_len)) != NULL) {
+			candidates->lists[2] = Z_ARRVAL_P(bucket);
+		}
+	}
+
+	zend_string_release(lower_uri);
+
+	for (i = 0; i < 3; i++) {
+		if (candidates->lists[i]) {
+			candidates->cursors[i] = zend_hash_num_elements(candidates->lists[i]);
+		}
+	}
+}
+
+/**
+ * Returns the next route to check, merging the index lists from the most
+ * recently added route to the oldest one
+ */
+static zval *phalcon_mvc_router_candidates_next(phalcon_mvc_router_candidates *candidates)
+{
+	zval *route, *position;
+	zend_long best;
+	int i, best_list;
+
+	if (!candidates->indexed) {
+		route = zend_hash_get_current_data_ex(candidates->routes, &candidates->position);
+		if (route) {
+			zend_hash_move_backwards_ex(candidates->routes, &candidates->position);
+		}
+		return route;
+	}
+
+	while (1) {
+		best = -1;
+		best_list = -1;
+
+		for (i = 0; i < 3; i++) {
+			if (candidates->cursors[i]) {
+				position = zend_hash_index_find(candidates->lists[i], candidates->cursors[i] - 1);
+				if (position && Z_LVAL_P(position) > best) {
+					best = Z_LVAL_P(position);
+					best_list = i;
+				}
+			}
+		}
+
+		if (best_list < 0) {
+			return NULL;
+		}
+
+		candidates->cursors[best_list]--;
+
+		if ((route = zend_hash_index_find(candidates->routes, best)) != NULL) {
+			return route;
+		}
+	}
+}
+
 /**
  * Phalcon\Mvc\Router initializer
  */
@@ -167,6 +546,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Router){
 	zend_declare_property_null(phalcon_mvc_router_ce, SL("_uriSource"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_router_ce, SL("_routes"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_router_ce, SL("_routesNameLookup"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_router_ce, SL("_routesIndex"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_router_ce, SL("_matchedRoute"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_router_ce, SL("_matches"), ZEND_ACC_PROTECTED);
 	zend_declare_property_bool(phalcon_mvc_router_ce, SL("_wasMatched"), 0, ZEND_ACC_PROTECTED);
@@ -422,6 +802,11 @@ PHP_METHOD(Phalcon_Mvc_Router, getDefaults){
 /**
  * Handles routing information received from the rewrite engine
  *
+ * The routes are indexed by their static pattern or the first segment of their
+ * literal prefix, the index is rebuilt lazily after add(), mount() or clear().
+ * When an events manager is attached every route is checked so the per-route
+ * events are still fired
+ *
  *<code>
  * //Read the info from the rewrite engine
  * $router->handle();
@@ -437,6 +822,8 @@ PHP_METHOD(Phalcon_Mvc_Router, handle){
 	zval *uri = NULL, real_uri = {}, status = {}, removeextraslashes = {}, handled_uri = {}, route_found = {}, params = {}, service = {}, dependency_injector = {}, request = {}, debug_message = {}, event_name = {};
 	zval all_case_sensitive = {}, current_host_name = {}, routes = {}, *route = NULL, matches = {}, parts = {}, namespace_name = {}, default_namespace = {}, module = {}, default_module = {}, exact = {};
 	zval controller = {}, default_handler = {}, action = {}, default_action = {}, mode = {}, http_method = {}, action_name = {}, params_str = {}, str_params = {}, params_merge = {}, default_params = {};
+	zval events_manager = {}, event_callbacks = {}, routes_index = {}, routes_count = {}, routes_version = {}, *candidate;
+	phalcon_mvc_router_candidates candidates;
 	zend_string *str_key;
 	ulong idx;
 
@@ -510,17 +897,49 @@ PHP_METHOD(Phalcon_Mvc_Router, handle){
 	 * Routes are traversed in reversed order
 	 */
 	phalcon_read_property(&routes, getThis(), SL("_routes"), PH_NOISY|PH_READONLY);
+	if (Z_TYPE(routes) != IS_ARRAY) {
+		array_init(&routes);
+		PHALCON_MM_ADD_ENTRY(&routes);
+	}
+
+	phalcon_read_property(&all_case_sensitive, getThis(), SL("_caseSensitive"), PH_READONLY);
 
-	PHALCON_MM_CALL_METHOD(&all_case_sensitive, getThis(), "getcasesensitive");
-	PHALCON_MM_ADD_ENTRY(&all_case_sensitive);
+	/**
+	 * Per-route events and debug output need every route to be visited, otherwise
+	 * only the routes the index selects for this URI are checked
+	 */
+	phalcon_read_property(&events_manager, getThis(), SL("_eventsManager"), PH_READONLY);
+	phalcon_read_property(&event_callbacks, getThis(), SL("_eventCallbacks"), PH_READONLY);
+	if (Z_TYPE(events_manager) == IS_NULL && !PHALCON_IS_NOT_EMPTY(&event_callbacks) && !PHALCON_GLOBAL(debug).enable_debug) {
+		/**
+		 * The index is rebuilt when a route was added, removed or changed since it was built
+		 */
+		phalcon_read_property(&routes_index, getThis(), SL("_routesIndex"), PH_READONLY);
+		if (Z_TYPE(routes_index) != IS_ARRAY
+			|| !phalcon_array_isset_fetch_str(&routes_count, &routes_index, SL("count"), PH_READONLY)
+			|| !phalcon_array_isset_fetch_str(&routes_version, &routes_index, SL("version"), PH_READONLY)
+			|| Z_LVAL(routes_count) != zend_hash_num_elements(Z_ARRVAL(routes))
+			|| (zend_ulong) Z_LVAL(routes_version) != PHALCON_GLOBAL(routes_version)) {
+			if (phalcon_mvc_router_build_index(&routes_index, &routes) == FAILURE) {
+				zval_ptr_dtor(&routes_index);
+				RETURN_MM();
+			}
+			phalcon_update_property(getThis(), SL("_routesIndex"), &routes_index);
+			PHALCON_MM_ADD_ENTRY(&routes_index);
+		}
+		phalcon_mvc_router_candidates_init(&candidates, &routes_index, &routes, &handled_uri);
+	} else {
+		phalcon_mvc_router_candidates_init(&candidates, NULL, &routes, &handled_uri);
+	}
 
-	ZEND_HASH_REVERSE_FOREACH_VAL(Z_ARRVAL(routes), route) {
+	while ((candidate = phalcon_mvc_router_candidates_next(&candidates)) != NULL) {
 		zval case_sensitive = {}, methods = {}, match_method = {}, hostname = {}, prefix = {}, regex_host_name = {}, matched = {};
 		zval pattern = {}, case_pattern = {}, before_match = {}, before_match_params = {}, paths = {};
 		zval converters = {}, *position;
 
-		PHALCON_MM_CALL_METHOD(&case_sensitive, route, "getcasesensitive");
-		PHALCON_MM_ADD_ENTRY(&case_sensitive);
+		route = candidate;
+
+		PHALCON_MVC_ROUTER_ROUTE_READ(&case_sensitive, route, "_caseSensitive", "getcasesensitive");
 		if (Z_TYPE(case_sensitive) == IS_NULL) {
 			ZVAL_COPY_VALUE(&case_sensitive, &all_case_sensitive);
 		}
@@ -528,25 +947,27 @@ PHP_METHOD(Phalcon_Mvc_Router, handle){
 		/**
 		 * Look for HTTP method constraints
 		 */
-		PHALCON_MM_CALL_METHOD(&methods, route, "gethttpmethods");
+		PHALCON_MVC_ROUTER_ROUTE_READ(&methods, route, "_methods", "gethttpmethods");
 		if (Z_TYPE(methods) != IS_NULL) {
-			PHALCON_MM_ADD_ENTRY(&methods);
 			/**
 			 * Check if the current method is allowed by the route
 			 */
-			PHALCON_MM_CALL_METHOD(&match_method, &request, "ismethod", &methods);
+			if (Z_OBJCE(request) == phalcon_http_request_ce) {
+				ZVAL_BOOL(&match_method, phalcon_mvc_router_match_method(&methods, &http_method));
+			} else {
+				PHALCON_MM_CALL_METHOD(&match_method, &request, "ismethod", &methods);
+				PHALCON_MM_ADD_ENTRY(&match_method);
+			}
 			if (PHALCON_IS_FALSE(&match_method)) {
 				continue;
 			}
-			PHALCON_MM_ADD_ENTRY(&match_method);
 		}
 
 		/**
 		 * Look for hostname constraints
 		 */
-		PHALCON_MM_CALL_METHOD(&hostname, route, "gethostname");
+		PHALCON_MVC_ROUTER_ROUTE_READ(&hostname, route, "_hostname", "gethostname");
 		if (Z_TYPE(hostname) != IS_NULL) {
-			PHALCON_MM_ADD_ENTRY(&hostname);
 			/**
 			 * No HTTP_HOST, maybe in CLI mode?
 			 */
@@ -584,8 +1005,7 @@ PHP_METHOD(Phalcon_Mvc_Router, handle){
 		/**
 		 * Look for hostname constraints
 		 */
-		PHALCON_MM_CALL_METHOD(&prefix, route, "getprefix");
-		PHALCON_MM_ADD_ENTRY(&prefix);
+		PHALCON_MVC_ROUTER_ROUTE_READ(&prefix, route, "_prefix", "getprefix");
 		if (PHALCON_IS_NOT_EMPTY(&prefix)) {
 			if (unlikely(PHALCON_GLOBAL(debug).enable_debug)) {
 				PHALCON_CONCAT_SV(&debug_message, "--Route prefix: ", &prefix);
@@ -608,8 +1028,7 @@ PHP_METHOD(Phalcon_Mvc_Router, handle){
 		/**
 		 * If the route has parentheses use preg_match
 		 */
-		PHALCON_MM_CALL_METHOD(&pattern, route, "getcompiledpattern");
-		PHALCON_MM_ADD_ENTRY(&pattern);
+		PHALCON_MVC_ROUTER_ROUTE_READ(&pattern, route, "_compiledPattern", "getcompiledpattern");
 
 		if (unlikely(PHALCON_GLOBAL(debug).enable_debug)) {
 			PHALCON_CONCAT_SV(&debug_message, "--Route Pattern: ", &pattern);
@@ -637,9 +1056,8 @@ PHP_METHOD(Phalcon_Mvc_Router, handle){
 		if (zend_is_true(&route_found)) {
 			PHALCON_MM_ZVAL_STRING(&event_name, "router:matchedRoute");
 			PHALCON_MM_CALL_METHOD(NULL, getThis(), "fireevent", &event_name, route);
-			PHALCON_MM_CALL_METHOD(&before_match, route, "getbeforematch");
+			PHALCON_MVC_ROUTER_ROUTE_READ(&before_match, route, "_beforeMatch", "getbeforematch");
 			if (Z_TYPE(before_match) != IS_NULL) {
-				PHALCON_MM_ADD_ENTRY(&before_match);
 				/**
 				 * Check first if the callback is callable
 				 */
@@ -675,8 +1093,7 @@ PHP_METHOD(Phalcon_Mvc_Router, handle){
 				/**
 				 * Start from the default paths
 				 */
-				PHALCON_MM_CALL_METHOD(&paths, route, "getpaths");
-				PHALCON_MM_ADD_ENTRY(&paths);
+				PHALCON_MVC_ROUTER_ROUTE_READ(&paths, route, "_paths", "getpaths");
 				PHALCON_MM_ZVAL_DUP(&parts, &paths);
 
 				if (unlikely(PHALCON_GLOBAL(debug).enable_debug)) {
@@ -693,8 +1110,7 @@ PHP_METHOD(Phalcon_Mvc_Router, handle){
 					/**
 					 * Get the route converters if any
 					 */
-					PHALCON_MM_CALL_METHOD(&converters, route, "getconverters");
-					PHALCON_MM_ADD_ENTRY(&converters);
+					PHALCON_MVC_ROUTER_ROUTE_READ(&converters, route, "_converters", "getconverters");
 
 					ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(paths), idx, str_key, position) {
 						zval tmp = {}, match_position = {}, converter = {}, parameters = {}, converted_part = {};
@@ -736,8 +1152,7 @@ PHP_METHOD(Phalcon_Mvc_Router, handle){
 					/**
 					 * Get the route converters if any
 					 */
-					PHALCON_MM_CALL_METHOD(&converters, route, "getconverters");
-					PHALCON_MM_ADD_ENTRY(&converters);
+					PHALCON_MVC_ROUTER_ROUTE_READ(&converters, route, "_converters", "getconverters");
 
 					ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(paths), idx, str_key, position) {
 						zval tmp = {}, converter = {}, parameters = {}, converted_part = {};
@@ -771,7 +1186,7 @@ PHP_METHOD(Phalcon_Mvc_Router, handle){
 			PHALCON_MM_ZVAL_STRING(&event_name, "router:notMatchedRoute");
 			PHALCON_MM_CALL_METHOD(NULL, getThis(), "fireevent", &event_name, route);
 		}
-	} ZEND_HASH_FOREACH_END();
+	}
 
 	/**
 	 * Update the wasMatched property indicating if the route was matched
@@ -784,6 +1199,12 @@ PHP_METHOD(Phalcon_Mvc_Router, handle){
 	if (!zend_is_true(&route_found)) {
 		phalcon_update_property_null(getThis(), SL("_matches"));
 		phalcon_update_property_null(getThis(), SL("_matchedRoute"));
+
+		/* The defaults are taken from the last route in the traversal, the first one added */
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(routes), route) {
+			break;
+		} ZEND_HASH_FOREACH_END();
+
 		phalcon_read_property(&parts, getThis(), SL("_notFoundPaths"), PH_READONLY);
 		if (Z_TYPE(parts) != IS_NULL) {
 			ZVAL_TRUE(&route_found);
@@ -1019,6 +1440,7 @@ PHP_METHOD(Phalcon_Mvc_Router, add){
 	PHALCON_CALL_METHOD(NULL, return_value, "__construct", pattern, paths, http_methods, regex);
 
 	phalcon_update_property_array_append(getThis(), SL("_routes"), return_value);
+	phalcon_update_property_null(getThis(), SL("_routesIndex"));
 }
 
 static void phalcon_mvc_router_add_helper(INTERNAL_FUNCTION_PARAMETERS, zend_string *method)
@@ -1208,6 +1630,7 @@ PHP_METHOD(Phalcon_Mvc_Router, mount){
 	} else {
 		phalcon_update_property(getThis(), SL("_routes"), &group_routes);
 	}
+	phalcon_update_property_null(getThis(), SL("_routesIndex"));
 	zval_ptr_dtor(&group_routes);
 	zval_ptr_dtor(&before_match);
 	zval_ptr_dtor(&hostname);
@@ -1248,7 +1671,7 @@ PHP_METHOD(Phalcon_Mvc_Router, clear){
 
 	phalcon_update_property_empty_array(getThis(), SL("_routes"));
 	phalcon_update_property_empty_array(getThis(), SL("_routesNameLookup"));
-
+	phalcon_update_property_null(getThis(), SL("_routesIndex"));
 }
 
 /**
@@ -1321,14 +1744,31 @@ PHP_METHOD(Phalcon_Mvc_Router, getRouteById){
 }
 
 /**
- * Returns a route object by its name
+ * Checks the name lookup was built over the current routes and their names
+ */
+static int phalcon_mvc_router_name_lookup_valid(zval *lookup, zval *routes)
+{
+	zval version = {}, count = {};
+
+	return Z_TYPE_P(lookup) == IS_ARRAY
+		&& phalcon_array_isset_fetch_str(&version, lookup, SL("version"), PH_READONLY)
+		&& phalcon_array_isset_fetch_str(&count, lookup, SL("count"), PH_READONLY)
+		&& (zend_ulong) Z_LVAL(version) == PHALCON_GLOBAL(route_names_version)
+		&& Z_LVAL(count) == (Z_TYPE_P(routes) == IS_ARRAY ? zend_hash_num_elements(Z_ARRVAL_P(routes)) : 0);
+}
+
+/**
+ * Returns a route object by its name, the first route added with a name wins
+ *
+ * The names are looked up in a map built at once, rebuilt when routes are added or renamed.
+ * Subclasses overriding getName() must not return a different name afterwards
  *
  * @param string $name
  * @return Phalcon\Mvc\Router\Route
  */
 PHP_METHOD(Phalcon_Mvc_Router, getRouteByName){
 
-	zval *name, routes = {}, *route, routes_name_lookup = {};
+	zval *name, routes = {}, *route, routes_name_lookup = {}, names = {}, lookup = {}, found = {};
 
 	phalcon_fetch_params(0, 1, 0, &name);
 
@@ -1337,27 +1777,55 @@ PHP_METHOD(Phalcon_Mvc_Router, getRouteByName){
 		convert_to_string(name);
 	}
 
+	phalcon_read_property(&routes, getThis(), SL("_routes"), PH_NOISY|PH_READONLY);
 	phalcon_read_property(&routes_name_lookup, getThis(), SL("_routesNameLookup"), PH_NOISY|PH_READONLY);
-	if (PHALCON_IS_NOT_EMPTY(name) && (route = zend_hash_find(Z_ARRVAL(routes_name_lookup), Z_STR_P(name))) != NULL) {
-		RETURN_CTOR(route);
+
+	if (PHALCON_IS_NOT_EMPTY(name) && phalcon_mvc_router_name_lookup_valid(&routes_name_lookup, &routes)) {
+		if (phalcon_array_isset_fetch_str(&names, &routes_name_lookup, SL("names"), PH_READONLY)
+			&& Z_TYPE(names) == IS_ARRAY && (route = zend_hash_find(Z_ARRVAL(names), Z_STR_P(name))) != NULL) {
+			RETURN_CTOR(route);
+		}
+		RETURN_FALSE;
 	}
 
-	phalcon_read_property(&routes, getThis(), SL("_routes"), PH_NOISY|PH_READONLY);
+	/**
+	 * Index every named route at once, so the next lookups don't need to walk the routes again
+	 */
+	array_init(&names);
+
 	if (Z_TYPE(routes) == IS_ARRAY) {
 		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(routes), route) {
 			zval route_name = {};
-			PHALCON_CALL_METHOD(&route_name, route, "getname");
+			if (Z_TYPE_P(route) == IS_OBJECT && Z_OBJCE_P(route) == phalcon_mvc_router_route_ce) {
+				phalcon_read_property(&route_name, route, SL("_name"), PH_COPY);
+			} else {
+				PHALCON_CALL_METHOD(&route_name, route, "getname");
+			}
 			convert_to_string(&route_name);
-			if (PHALCON_IS_NOT_EMPTY(&route_name)) {
-				phalcon_update_property_array_string(getThis(), SL("_routesNameLookup"), Z_STR(route_name), route);
+
+			if (PHALCON_IS_NOT_EMPTY(&route_name) && !zend_hash_exists(Z_ARRVAL(names), Z_STR(route_name))) {
+				phalcon_array_update(&names, &route_name, route, PH_COPY);
 			}
 
-			if (phalcon_is_equal(&route_name, name)) {
-				RETURN_CTOR(route);
+			if (Z_TYPE(found) == IS_UNDEF && phalcon_is_equal(&route_name, name)) {
+				ZVAL_COPY_VALUE(&found, route);
 			}
+			zval_ptr_dtor(&route_name);
 		} ZEND_HASH_FOREACH_END();
 	}
 
+	array_init_size(&lookup, 3);
+	phalcon_array_update_str_long(&lookup, SL("version"), PHALCON_GLOBAL(route_names_version), 0);
+	phalcon_array_update_str_long(&lookup, SL("count"), Z_TYPE(routes) == IS_ARRAY ? zend_hash_num_elements(Z_ARRVAL(routes)) : 0, 0);
+	phalcon_array_update_str(&lookup, SL("names"), &names, 0);
+
+	phalcon_update_property(getThis(), SL("_routesNameLookup"), &lookup);
+	zval_ptr_dtor(&lookup);
+
+	if (Z_TYPE(found) != IS_UNDEF) {
+		RETURN_CTOR(&found);
+	}
+
 	RETURN_FALSE;
 }
 
@@ -1419,3 +1887,257 @@ PHP_METHOD(Phalcon_Mvc_Router, getControllerName){
 
 	RETURN_MEMBER(getThis(), "_handler");
 }
+
+/**
+ * Exports the routes and the router settings as a plain array, with the patterns
+ * already compiled, so it can be stored in a cache and restored with importRoutes()
+ *
+ *<code>
+ * $image = $router->exportRoutes();
+ *
+ * $router = new Phalcon\Mvc\Router(false);
+ * $router->importRoutes($image);
+ *</code>
+ *
+ * @return array
+ */
+PHP_METHOD(Phalcon_Mvc_Router, exportRoutes){
+
+	zval routes = {}, list = {}, routes_data = {}, index = {}, *route, value = {};
+	const char **property;
+	int flag;
+
+	phalcon_read_property(&routes, getThis(), SL("_routes"), PH_NOISY|PH_READONLY);
+
+	array_init(&list);
+	array_init(&routes_data);
+
+	if (Z_TYPE(routes) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_VAL(Z_ARRVAL(routes), route) {
+			zval data = {}, before_match = {}, url_generator = {}, converters = {}, pattern = {};
+
+			if (Z_TYPE_P(route) != IS_OBJECT || !instanceof_function(Z_OBJCE_P(route), phalcon_mvc_router_route_ce)) {
+				zval_ptr_dtor(&list);
+				zval_ptr_dtor(&routes_data);
+				PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_router_exception_ce, "Only Phalcon\\Mvc\\Router\\Route routes can be exported");
+				return;
+			}
+
+			/**
+			 * Closures cannot be stored outside the current request
+			 */
+			phalcon_read_property(&before_match, route, SL("_beforeMatch"), PH_READONLY);
+			phalcon_read_property(&url_generator, route, SL("_urlGenerator"), PH_READONLY);
+			phalcon_read_property(&converters, route, SL("_converters"), PH_READONLY);
+			if (Z_TYPE(before_match) != IS_NULL || Z_TYPE(url_generator) != IS_NULL || PHALCON_IS_NOT_EMPTY(&converters)) {
+				zval_ptr_dtor(&list);
+				zval_ptr_dtor(&routes_data);
+				phalcon_read_property(&pattern, route, SL("_pattern"), PH_READONLY);
+				PHALCON_THROW_EXCEPTION_FORMAT(phalcon_mvc_router_exception_ce, "The route '%s' uses callbacks and cannot be exported", Z_TYPE(pattern) == IS_STRING ? Z_STRVAL(pattern) : "");
+				return;
+			}
+
+			array_init(&data);
+			for (property = phalcon_mvc_router_route_image_properties; *property; property++) {
+				phalcon_read_property(&value, route, *property, strlen(*property), PH_READONLY);
+				if (Z_TYPE(value) != IS_NULL) {
+					phalcon_array_update_str(&data, *property, strlen(*property), &value, PH_COPY);
+				}
+			}
+
+			phalcon_array_append(&routes_data, &data, 0);
+			phalcon_array_append(&list, route, PH_COPY);
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	/**
+	 * The index is built over the list of routes as it will be imported
+	 */
+	flag = phalcon_mvc_router_build_index(&index, &list);
+	zval_ptr_dtor(&list);
+	if (flag == FAILURE) {
+		zval_ptr_dtor(&index);
+		zval_ptr_dtor(&routes_data);
+		return;
+	}
+
+	array_init_size(return_value, 3);
+	phalcon_array_update_str(return_value, SL("routes"), &routes_data, 0);
+	phalcon_array_update_str(return_value, SL("index"), &index, 0);
+
+	for (property = phalcon_mvc_router_image_properties; *property; property++) {
+		phalcon_read_property(&value, getThis(), *property, strlen(*property), PH_READONLY);
+		phalcon_array_update_str(return_value, *property, strlen(*property), &value, PH_COPY);
+	}
+}
+
+/**
+ * Replaces the routes and the router settings with an image created by exportRoutes().
+ * The routes are restored without compiling their patterns again
+ *
+ * @param array $image
+ * @return Phalcon\Mvc\Router
+ */
+PHP_METHOD(Phalcon_Mvc_Router, importRoutes){
+
+	zval *image, routes_data = {}, index = {}, routes = {}, names = {}, routes_name_lookup = {}, unique_id = {}, value = {}, *data;
+	const char **property;
+	zend_long max_id = -1;
+
+	phalcon_fetch_params(0, 1, 0, &image);
+
+	if (!phalcon_array_isset_fetch_str(&routes_data, image, SL("routes"), PH_READONLY) || Z_TYPE(routes_data) != IS_ARRAY) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_router_exception_ce, "Invalid routes image");
+		return;
+	}
+
+	array_init_size(&routes, zend_hash_num_elements(Z_ARRVAL(routes_data)));
+	array_init(&names);
+
+	ZEND_HASH_FOREACH_VAL(Z_ARRVAL(routes_data), data) {
+		zval route = {}, route_id = {}, route_name = {};
+
+		if (Z_TYPE_P(data) != IS_ARRAY) {
+			zval_ptr_dtor(&routes);
+			zval_ptr_dtor(&names);
+			PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_router_exception_ce, "Invalid routes image");
+			return;
+		}
+
+		object_init_ex(&route, phalcon_mvc_router_route_ce);
+
+		for (property = phalcon_mvc_router_route_image_properties; *property; property++) {
+			if (phalcon_array_isset_fetch_str(&value, data, *property, strlen(*property), PH_READONLY)) {
+				phalcon_update_property(&route, *property, strlen(*property), &value);
+			}
+		}
+
+		if (phalcon_array_isset_fetch_str(&route_id, data, SL("_id"), PH_READONLY) && Z_TYPE(route_id) == IS_LONG && Z_LVAL(route_id) > max_id) {
+			max_id = Z_LVAL(route_id);
+		}
+
+		/**
+		 * The first route with a name wins, as in getRouteByName()
+		 */
+		if (phalcon_array_isset_fetch_str(&route_name, data, SL("_name"), PH_READONLY) && PHALCON_IS_NOT_EMPTY_STRING(&route_name)
+			&& !zend_hash_exists(Z_ARRVAL(names), Z_STR(route_name))) {
+			phalcon_array_update(&names, &route_name, &route, PH_COPY);
+		}
+
+		phalcon_array_append(&routes, &route, 0);
+	} ZEND_HASH_FOREACH_END();
+
+	array_init_size(&routes_name_lookup, 3);
+	phalcon_array_update_str_long(&routes_name_lookup, SL("version"), PHALCON_GLOBAL(route_names_version), 0);
+	phalcon_array_update_str_long(&routes_name_lookup, SL("count"), zend_hash_num_elements(Z_ARRVAL(routes)), 0);
+	phalcon_array_update_str(&routes_name_lookup, SL("names"), &names, 0);
+
+	phalcon_update_property(getThis(), SL("_routes"), &routes);
+	phalcon_update_property(getThis(), SL("_routesNameLookup"), &routes_name_lookup);
+	zval_ptr_dtor(&routes);
+	zval_ptr_dtor(&routes_name_lookup);
+
+	/**
+	 * The routes of the image are the ones the index was built over, it is valid from now
+	 */
+	if (phalcon_array_isset_fetch_str(&index, image, SL("index"), PH_READONLY) && Z_TYPE(index) == IS_ARRAY) {
+		zval current = {};
+		ZVAL_DUP(&current, &index);
+		phalcon_array_update_str_long(&current, SL("version"), PHALCON_GLOBAL(routes_version), 0);
+		phalcon_update_property(getThis(), SL("_routesIndex"), &current);
+		zval_ptr_dtor(&current);
+	} else {
+		phalcon_update_property_null(getThis(), SL("_routesIndex"));
+	}
+
+	for (property = phalcon_mvc_router_image_properties; *property; property++) {
+		if (phalcon_array_isset_fetch_str(&value, image, *property, strlen(*property), PH_READONLY)) {
+			phalcon_update_property(getThis(), *property, strlen(*property), &value);
+		}
+	}
+
+	/**
+	 * Routes created later must not reuse the ids of the imported ones
+	 */
+	phalcon_read_static_property_ce(&unique_id, phalcon_mvc_router_route_ce, SL("_uniqueId"), PH_READONLY);
+	if (Z_TYPE(unique_id) != IS_LONG || Z_LVAL(unique_id) <= max_id) {
+		ZVAL_LONG(&unique_id, max_id + 1);
+		phalcon_update_static_property_ce(phalcon_mvc_router_route_ce, SL("_uniqueId"), &unique_id);
+	}
+
+	RETURN_THIS();
+}
+
+/**
+ * Loads the routes from a cache, the builder is only called to define them when
+ * the cache doesn't have an image for the given version yet. By default the
+ * image is kept in shared memory by Phalcon\Cache\Yac so every worker reuses it
+ *
+ *<code>
+ * $router = new Phalcon\Mvc\Router(false);
+ * $router->useCache('v1', function ($router) {
+ *     $router->add('/about', 'About::index');
+ *     $router->mount(new BlogRoutes());
+ * });
+ *</code>
+ *
+ * @param string $version
+ * @param Closure $builder
+ * @param Phalcon\Cache\BackendInterface|string $cache
+ * @return boolean true if the routes were loaded from the cache
+ */
+PHP_METHOD(Phalcon_Mvc_Router, useCache){
+
+	zval *version, *builder, *cache = NULL, backend = {}, hash = {}, key = {}, image = {}, lifetime = {};
+	zend_class_entry *ce0 = NULL;
+
+	phalcon_fetch_params(1, 2, 1, &version, &builder, &cache);
+
+	if (cache && Z_TYPE_P(cache) == IS_STRING) {
+		PHALCON_MM_CALL_METHOD(&backend, getThis(), "getresolveservice", cache);
+		PHALCON_MM_ADD_ENTRY(&backend);
+		PHALCON_MM_VERIFY_INTERFACE(&backend, phalcon_cache_backendinterface_ce);
+	} else if (cache && Z_TYPE_P(cache) == IS_OBJECT) {
+		PHALCON_MM_VERIFY_INTERFACE_EX(cache, phalcon_cache_backendinterface_ce, phalcon_mvc_router_exception_ce);
+		ZVAL_COPY_VALUE(&backend, cache);
+	} else {
+#ifdef PHALCON_CACHE_YAC
+		ce0 = phalcon_cache_yac_ce;
+#endif
+		if (ce0 && PHALCON_GLOBAL(cache).enable_yac) {
+			object_init_ex(&backend, ce0);
+			PHALCON_MM_ADD_ENTRY(&backend);
+			PHALCON_MM_CALL_METHOD(NULL, &backend, "__construct");
+		}
+	}
+
+	phalcon_md5(&hash, version);
+	PHALCON_CONCAT_SV(&key, "router", &hash);
+	PHALCON_MM_ADD_ENTRY(&key);
+	zval_ptr_dtor(&hash);
+
+	if (Z_TYPE(backend) == IS_OBJECT) {
+		PHALCON_MM_CALL_METHOD(&image, &backend, "get", &key);
+		PHALCON_MM_ADD_ENTRY(&image);
+		if (Z_TYPE(image) == IS_ARRAY) {
+			PHALCON_MM_CALL_METHOD(NULL, getThis(), "importroutes", &image);
+			RETURN_MM_TRUE;
+		}
+	}
+
+	PHALCON_MM_CALL_USER_FUNC(NULL, builder, getThis());
+
+	if (Z_TYPE(backend) == IS_OBJECT) {
+		PHALCON_MM_CALL_METHOD(&image, getThis(), "exportroutes");
+		PHALCON_MM_ADD_ENTRY(&image);
+
+		ZVAL_LONG(&lifetime, 0);
+		if (instanceof_function(Z_OBJCE(backend), phalcon_cache_backendinterface_ce)) {
+			PHALCON_MM_CALL_METHOD(NULL, &backend, "save", &key, &image, &lifetime);
+		} else {
+			PHALCON_MM_CALL_METHOD(NULL, &backend, "set", &key, &image, &lifetime);
+		}
+	}
+
+	RETURN_MM_FALSE;
+}
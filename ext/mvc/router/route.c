@@ -61,6 +61,7 @@ PHP_METHOD(Phalcon_Mvc_Router_Route, getPattern);
 PHP_METHOD(Phalcon_Mvc_Router_Route, getCompiledPattern);
 PHP_METHOD(Phalcon_Mvc_Router_Route, getPaths);
 PHP_METHOD(Phalcon_Mvc_Router_Route, getReversedPaths);
+PHP_METHOD(Phalcon_Mvc_Router_Route, getReversedTemplate);
 PHP_METHOD(Phalcon_Mvc_Router_Route, setHttpMethods);
 PHP_METHOD(Phalcon_Mvc_Router_Route, getHttpMethods);
 PHP_METHOD(Phalcon_Mvc_Router_Route, setPrefix);
@@ -136,6 +137,7 @@ static const zend_function_entry phalcon_mvc_router_route_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Router_Route, getCompiledPattern, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Router_Route, getPaths, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Router_Route, getReversedPaths, NULL, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Router_Route, getReversedTemplate, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Router_Route, setHttpMethods, arginfo_phalcon_mvc_router_routeinterface_sethttpmethods, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Router_Route, getHttpMethods, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Router_Route, setPrefix, arginfo_phalcon_mvc_router_route_setprefix, ZEND_ACC_PUBLIC)
@@ -173,6 +175,7 @@ PHALCON_INIT_CLASS(Phalcon_Mvc_Router_Route){
 	zend_declare_property_null(phalcon_mvc_router_route_ce, SL("_pattern"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_router_route_ce, SL("_compiledPattern"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_router_route_ce, SL("_paths"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_mvc_router_route_ce, SL("_reversedTemplate"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_router_route_ce, SL("_methods"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_router_route_ce, SL("_prefix"), ZEND_ACC_PROTECTED);
 	zend_declare_property_null(phalcon_mvc_router_route_ce, SL("_hostname"), ZEND_ACC_PROTECTED);
@@ -432,6 +435,7 @@ PHP_METHOD(Phalcon_Mvc_Router_Route, via){
 	phalcon_fetch_params(0, 1, 0, &http_methods);
 
 	phalcon_update_property(getThis(), SL("_methods"), http_methods);
+	PHALCON_GLOBAL(routes_version)++;
 	RETURN_THIS();
 }
 
@@ -600,10 +604,13 @@ PHP_METHOD(Phalcon_Mvc_Router_Route, reConfigure){
 	phalcon_update_property(getThis(), SL("_compiledPattern"), &compiled_pattern);
 	zval_ptr_dtor(&compiled_pattern);
 
+	PHALCON_GLOBAL(routes_version)++;
+
 	/**
 	 * Update the route's paths
 	 */
 	phalcon_update_property(getThis(), SL("_paths"), &route_paths);
+	phalcon_update_property_null(getThis(), SL("_reversedTemplate"));
 	if (unlikely(PHALCON_GLOBAL(debug).enable_debug)) {
 		ZVAL_STRING(&debug_message, "Update Route paths: ");
 		PHALCON_DEBUG_LOG(&debug_message);
@@ -643,6 +650,7 @@ PHP_METHOD(Phalcon_Mvc_Router_Route, setName){
 	phalcon_fetch_params(0, 1, 0, &name);
 
 	phalcon_update_property(getThis(), SL("_name"), name);
+	PHALCON_GLOBAL(route_names_version)++;
 	RETURN_THIS();
 }
 
@@ -745,6 +753,36 @@ PHP_METHOD(Phalcon_Mvc_Router_Route, getReversedPaths){
 	} ZEND_HASH_FOREACH_END();
 }
 
+/**
+ * Returns the pattern split into literal segments (even positions) and the names of the
+ * parameters replacing its placeholders (odd positions), it's built once and reused by
+ * Phalcon\Mvc\Url to generate the URIs of the route
+ *
+ *<code>
+ * $route = new \Phalcon\Mvc\Router\Route('/posts/{year}/{title}', 'Posts::show');
+ * print_r($route->getReversedTemplate()); // array('posts/', 'year', '/', 'title', '')
+ *</code>
+ *
+ * @return array
+ */
+PHP_METHOD(Phalcon_Mvc_Router_Route, getReversedTemplate){
+
+	zval pattern = {}, paths = {};
+
+	phalcon_read_property(return_value, getThis(), SL("_reversedTemplate"), PH_COPY);
+	if (Z_TYPE_P(return_value) != IS_NULL) {
+		return;
+	}
+
+	phalcon_read_property(&pattern, getThis(), SL("_pattern"), PH_READONLY);
+	PHALCON_CALL_METHOD(&paths, getThis(), "getreversedpaths");
+
+	phalcon_compile_reversed_pattern(return_value, &pattern, &paths);
+	zval_ptr_dtor(&paths);
+
+	phalcon_update_property(getThis(), SL("_reversedTemplate"), return_value);
+}
+
 /**
  * Sets a set of HTTP methods that constraint the matching of the route (alias of via)
  *
@@ -763,6 +801,7 @@ PHP_METHOD(Phalcon_Mvc_Router_Route, setHttpMethods){
 	phalcon_fetch_params(0, 1, 0, &http_methods);
 
 	phalcon_update_property(getThis(), SL("_methods"), http_methods);
+	PHALCON_GLOBAL(routes_version)++;
 	RETURN_THIS();
 }
 
@@ -22,6 +22,7 @@
 #include "mvc/urlinterface.h"
 #include "mvc/url/exception.h"
 #include "mvc/routerinterface.h"
+#include "mvc/router/route.h"
 #include "diinterface.h"
 #include "di/injectable.h"
 
@@ -64,6 +65,7 @@ PHP_METHOD(Phalcon_Mvc_Url, getStaticBaseUri);
 PHP_METHOD(Phalcon_Mvc_Url, setBasePath);
 PHP_METHOD(Phalcon_Mvc_Url, getBasePath);
 PHP_METHOD(Phalcon_Mvc_Url, get);
+PHP_METHOD(Phalcon_Mvc_Url, getMultiple);
 PHP_METHOD(Phalcon_Mvc_Url, getStatic);
 PHP_METHOD(Phalcon_Mvc_Url, path);
 PHP_METHOD(Phalcon_Mvc_Url, isLocal);
@@ -76,6 +78,11 @@ ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_url_getstatic, 0, 0, 0)
 	ZEND_ARG_INFO(0, uri)
 ZEND_END_ARG_INFO()
 
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_url_getmultiple, 0, 0, 2)
+	ZEND_ARG_TYPE_INFO(0, uri, IS_ARRAY, 0)
+	ZEND_ARG_TYPE_INFO(0, params, IS_ARRAY, 0)
+ZEND_END_ARG_INFO()
+
 ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_mvc_url_islocal, 0, 0, 1)
 	ZEND_ARG_TYPE_INFO(0, uri, IS_STRING, 0)
 ZEND_END_ARG_INFO()
@@ -88,6 +95,7 @@ static const zend_function_entry phalcon_mvc_url_method_entry[] = {
 	PHP_ME(Phalcon_Mvc_Url, setBasePath, arginfo_phalcon_mvc_urlinterface_setbasepath, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Url, getBasePath, NULL, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Url, get, arginfo_phalcon_mvc_urlinterface_get, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Mvc_Url, getMultiple, arginfo_phalcon_mvc_url_getmultiple, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Url, getStatic, arginfo_phalcon_mvc_url_getstatic, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Url, path, arginfo_phalcon_mvc_urlinterface_path, ZEND_ACC_PUBLIC)
 	PHP_ME(Phalcon_Mvc_Url, isLocal, arginfo_phalcon_mvc_url_islocal, ZEND_ACC_PUBLIC)
@@ -251,6 +259,159 @@ PHP_METHOD(Phalcon_Mvc_Url, getBasePath){
 	RETURN_MEMBER(getThis(), "_basePath");
 }
 
+/**
+ * Obtains a route by its name from the router, the router is taken from the DI the first time
+ */
+static int phalcon_mvc_url_get_route(zval *route, zval *object, zval *route_name)
+{
+	zval router = {}, dependency_injector = {}, service = {}, exception_message = {};
+	int flag;
+
+	phalcon_read_property(&router, object, SL("_router"), PH_COPY);
+
+	/**
+	 * Check if the router has not previously set
+	 */
+	if (Z_TYPE(router) != IS_OBJECT) {
+		zval_ptr_dtor(&router);
+		ZVAL_UNDEF(&router);
+
+		PHALCON_CALL_METHOD_FLAG(flag, &dependency_injector, object, "getdi");
+		if (flag == FAILURE) {
+			return FAILURE;
+		}
+
+		if (!zend_is_true(&dependency_injector)) {
+			zval_ptr_dtor(&dependency_injector);
+			PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_url_exception_ce, "A dependency injector container is required to obtain the \"url\" service");
+			return FAILURE;
+		}
+
+		ZVAL_STR(&service, IS(router));
+
+		PHALCON_CALL_METHOD_FLAG(flag, &router, &dependency_injector, "getshared", &service);
+		zval_ptr_dtor(&dependency_injector);
+		if (flag == FAILURE) {
+			return FAILURE;
+		}
+
+		if (Z_TYPE(router) != IS_OBJECT || !instanceof_function(Z_OBJCE(router), phalcon_mvc_routerinterface_ce)) {
+			zval_ptr_dtor(&router);
+			PHALCON_THROW_EXCEPTION_STR(phalcon_mvc_url_exception_ce, "The injected service 'router' is not valid");
+			return FAILURE;
+		}
+		phalcon_update_property(object, SL("_router"), &router);
+	}
+
+	PHALCON_CALL_METHOD_FLAG(flag, route, &router, "getroutebyname", route_name);
+	zval_ptr_dtor(&router);
+	if (flag == FAILURE) {
+		return FAILURE;
+	}
+
+	if (Z_TYPE_P(route) != IS_OBJECT) {
+		zval_ptr_dtor(route);
+		ZVAL_UNDEF(route);
+		PHALCON_CONCAT_SVS(&exception_message, "Cannot obtain a route using the name \"", route_name, "\"");
+		PHALCON_THROW_EXCEPTION_ZVAL(phalcon_mvc_url_exception_ce, &exception_message);
+		zval_ptr_dtor(&exception_message);
+		return FAILURE;
+	}
+
+	return SUCCESS;
+}
+
+/**
+ * Builds the URI of a route, Phalcon\Mvc\Router\Route objects reuse their reversed template
+ * so the base URI and the parameters are written in a single buffer
+ */
+static int phalcon_mvc_url_route_uri(zval *return_value, zval *route, zval *base_uri, zval *uri)
+{
+	zval paths = {}, generator = {}, arguments = {}, has_hostname = {}, hostname = {}, prefix = {}, template = {};
+	int is_route = (Z_OBJCE_P(route) == phalcon_mvc_router_route_ce), flag = SUCCESS;
+
+	/**
+	 * Return the Url Generator
+	 */
+	if (is_route) {
+		phalcon_read_property(&generator, route, SL("_urlGenerator"), PH_COPY);
+	} else {
+		PHALCON_CALL_METHOD_FLAG(flag, &generator, route, "geturlgenerator");
+		if (flag == FAILURE) {
+			return FAILURE;
+		}
+	}
+
+	if (phalcon_is_callable(&generator) || (Z_TYPE(generator) == IS_OBJECT && instanceof_function(Z_OBJCE(generator), zend_ce_closure))) {
+		/**
+		 * Return the reversed paths
+		 */
+		PHALCON_CALL_METHOD_FLAG(flag, &paths, route, "getreversedpaths");
+		if (flag == FAILURE) {
+			zval_ptr_dtor(&generator);
+			return FAILURE;
+		}
+
+		array_init_size(&arguments, 3);
+		phalcon_array_append(&arguments, base_uri, PH_COPY);
+		phalcon_array_append(&arguments, &paths, 0);
+		phalcon_array_append(&arguments, uri, PH_COPY);
+		flag = phalcon_call_user_func_array(return_value, &generator, &arguments);
+		zval_ptr_dtor(&arguments);
+		zval_ptr_dtor(&generator);
+		return flag;
+	}
+	zval_ptr_dtor(&generator);
+
+	if (phalcon_array_isset_fetch_str(&has_hostname, uri, SL("hostname"), PH_READONLY) && zend_is_true(&has_hostname)) {
+		PHALCON_CALL_METHOD_FLAG(flag, &hostname, route, "gethostname");
+		if (flag == FAILURE) {
+			return FAILURE;
+		}
+		PHALCON_CONCAT_VV(&prefix, &hostname, base_uri);
+		zval_ptr_dtor(&hostname);
+	} else {
+		ZVAL_COPY(&prefix, base_uri);
+	}
+
+	if (is_route) {
+		phalcon_read_property(&template, route, SL("_reversedTemplate"), PH_COPY);
+		if (Z_TYPE(template) != IS_ARRAY) {
+			zval_ptr_dtor(&template);
+			PHALCON_CALL_METHOD_FLAG(flag, &template, route, "getreversedtemplate");
+		}
+	} else {
+		zval pattern = {};
+		PHALCON_CALL_METHOD_FLAG(flag, &pattern, route, "getpattern");
+		if (flag == SUCCESS) {
+			PHALCON_CALL_METHOD_FLAG(flag, &paths, route, "getreversedpaths");
+			if (flag == SUCCESS) {
+				phalcon_compile_reversed_pattern(&template, &pattern, &paths);
+			}
+		}
+		zval_ptr_dtor(&pattern);
+		zval_ptr_dtor(&paths);
+	}
+
+	if (flag == FAILURE) {
+		zval_ptr_dtor(&prefix);
+		return FAILURE;
+	}
+
+	/**
+	 * Replace the patterns by its variables
+	 */
+	if (Z_TYPE(template) == IS_ARRAY) {
+		phalcon_render_reversed_pattern(return_value, &template, uri, &prefix);
+	} else {
+		ZVAL_COPY(return_value, &prefix);
+	}
+	zval_ptr_dtor(&template);
+	zval_ptr_dtor(&prefix);
+
+	return SUCCESS;
+}
+
 /**
  * Generates a URL
  *
@@ -272,9 +433,8 @@ PHP_METHOD(Phalcon_Mvc_Url, getBasePath){
  */
 PHP_METHOD(Phalcon_Mvc_Url, get){
 
-	zval *uri = NULL, *args = NULL, *_local = NULL, local = {}, base_uri = {}, dependency_injector = {};
-	zval service = {}, route_name = {}, exception_message = {}, realuri = {};
-	zval paths = {}, matched = {}, regexp = {}, generator = {}, arguments = {};
+	zval *uri = NULL, *args = NULL, *_local = NULL, local = {}, base_uri = {};
+	zval route_name = {}, realuri = {}, matched = {}, regexp = {};
 
 	phalcon_fetch_params(1, 0, 3, &uri, &args, &local);
 
@@ -320,88 +480,25 @@ PHP_METHOD(Phalcon_Mvc_Url, get){
 			PHALCON_MM_ZVAL_COPY(&realuri, uri);
 		}
 	} else if (Z_TYPE_P(uri) == IS_ARRAY) {
-		zval router = {}, route = {};
+		zval route = {};
 
 		if (!phalcon_array_isset_fetch_str(&route_name, uri, SL("for"), PH_READONLY)) {
 			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_url_exception_ce, "It's necessary to define the route name with the parameter \"for\"");
 			return;
 		}
 
-		phalcon_read_property(&router, getThis(), SL("_router"), PH_COPY);
-
-		/**
-		 * Check if the router has not previously set
-		 */
-		if (Z_TYPE(router) != IS_OBJECT) {
-			PHALCON_MM_CALL_METHOD(&dependency_injector, getThis(), "getdi");
-			PHALCON_MM_ADD_ENTRY(&dependency_injector);
-			if (!zend_is_true(&dependency_injector)) {
-				PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_url_exception_ce, "A dependency injector container is required to obtain the \"url\" service");
-				return;
-			}
-
-			ZVAL_STR(&service, IS(router));
-
-			PHALCON_MM_CALL_METHOD(&router, &dependency_injector, "getshared", &service);
-			PHALCON_MM_ADD_ENTRY(&router);
-			PHALCON_MM_VERIFY_INTERFACE(&router, phalcon_mvc_routerinterface_ce);
-			phalcon_update_property(getThis(), SL("_router"), &router);
-		}
-
 		/**
 		 * Every route is uniquely identified by a name
 		 */
-		PHALCON_MM_CALL_METHOD(&route, &router, "getroutebyname", &route_name);
-		PHALCON_MM_ADD_ENTRY(&route);
-		if (Z_TYPE(route) != IS_OBJECT) {
-			PHALCON_CONCAT_SVS(&exception_message, "Cannot obtain a route using the name \"", &route_name, "\"");
-			PHALCON_MM_ADD_ENTRY(&exception_message);
-			PHALCON_MM_THROW_EXCEPTION_ZVAL(phalcon_mvc_url_exception_ce, &exception_message);
-			return;
+		if (phalcon_mvc_url_get_route(&route, getThis(), &route_name) == FAILURE) {
+			RETURN_MM();
 		}
+		PHALCON_MM_ADD_ENTRY(&route);
 
-		/**
-		 * Return the reversed paths
-		 */
-		PHALCON_MM_CALL_METHOD(&paths, &route, "getreversedpaths");
-		PHALCON_MM_ADD_ENTRY(&paths);
-
-		/**
-		 * Return the Url Generator
-		 */
-		PHALCON_MM_CALL_METHOD(&generator, &route, "geturlgenerator");
-		PHALCON_MM_ADD_ENTRY(&generator);
-
-		if (phalcon_is_callable(&generator) || (Z_TYPE(generator) == IS_OBJECT && instanceof_function(Z_OBJCE(generator), zend_ce_closure))) {
-			array_init_size(&arguments, 3);
-			phalcon_array_append(&arguments, &base_uri, PH_COPY);
-			phalcon_array_append(&arguments, &paths, PH_COPY);
-			phalcon_array_append(&arguments, uri, PH_COPY);
-			PHALCON_MM_ADD_ENTRY(&arguments);
-			PHALCON_MM_CALL_USER_FUNC_ARRAY(&realuri, &generator, &arguments);
-			PHALCON_MM_ADD_ENTRY(&realuri);
-		} else {
-			zval pattern = {}, processed_uri = {}, has_hostname = {};
-			PHALCON_MM_CALL_METHOD(&pattern, &route, "getpattern");
-			PHALCON_MM_ADD_ENTRY(&pattern);
-
-			/**
-			 * Replace the patterns by its variables
-			 */
-			phalcon_replace_paths(&processed_uri, &pattern, &paths, uri);
-			PHALCON_MM_ADD_ENTRY(&processed_uri);
-
-			if (phalcon_array_isset_fetch_str(&has_hostname, uri, SL("hostname"), PH_READONLY) && zend_is_true(&has_hostname)) {
-				zval hostname = {};
-				PHALCON_MM_CALL_METHOD(&hostname, &route, "gethostname");
-				PHALCON_MM_ADD_ENTRY(&hostname);
-				PHALCON_CONCAT_VVV(&realuri, &hostname, &base_uri, &processed_uri);
-				PHALCON_MM_ADD_ENTRY(&realuri);
-			} else {
-				PHALCON_CONCAT_VV(&realuri, &base_uri, &processed_uri);
-				PHALCON_MM_ADD_ENTRY(&realuri);
-			}
+		if (phalcon_mvc_url_route_uri(&realuri, &route, &base_uri, uri) == FAILURE) {
+			RETURN_MM();
 		}
+		PHALCON_MM_ADD_ENTRY(&realuri);
 	}
 
 	if (zend_is_true(args)) {
@@ -422,6 +519,70 @@ PHP_METHOD(Phalcon_Mvc_Url, get){
 	RETURN_MM_CTOR(&realuri);
 }
 
+/**
+ * Generates many URLs for the same route, the route is resolved only once and every
+ * element of $params is merged with $uri to replace the placeholders of the pattern
+ *
+ *<code>
+ * $urls = $url->getMultiple(array('for' => 'blog-post'), array(
+ *     array('year' => '2012', 'title' => 'some-cool-stuff'),
+ *     array('year' => '2013', 'title' => 'other-cool-stuff'),
+ * ));
+ *</code>
+ *
+ * @param array $uri
+ * @param array $params
+ * @return array
+ */
+PHP_METHOD(Phalcon_Mvc_Url, getMultiple){
+
+	zval *uri, *params_list, *params, base_uri = {}, route_name = {}, route = {};
+	zend_string *str_key;
+	ulong idx;
+
+	phalcon_fetch_params(1, 2, 0, &uri, &params_list);
+
+	if (!phalcon_array_isset_fetch_str(&route_name, uri, SL("for"), PH_READONLY)) {
+		PHALCON_MM_THROW_EXCEPTION_STR(phalcon_mvc_url_exception_ce, "It's necessary to define the route name with the parameter \"for\"");
+		return;
+	}
+
+	PHALCON_MM_CALL_METHOD(&base_uri, getThis(), "getbaseuri");
+	PHALCON_MM_ADD_ENTRY(&base_uri);
+
+	if (phalcon_mvc_url_get_route(&route, getThis(), &route_name) == FAILURE) {
+		RETURN_MM();
+	}
+	PHALCON_MM_ADD_ENTRY(&route);
+
+	array_init_size(return_value, zend_hash_num_elements(Z_ARRVAL_P(params_list)));
+
+	ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL_P(params_list), idx, str_key, params) {
+		zval merged = {}, realuri = {};
+		int flag;
+
+		if (Z_TYPE_P(params) == IS_ARRAY) {
+			phalcon_fast_array_merge(&merged, uri, params);
+		} else {
+			ZVAL_COPY(&merged, uri);
+		}
+
+		flag = phalcon_mvc_url_route_uri(&realuri, &route, &base_uri, &merged);
+		zval_ptr_dtor(&merged);
+		if (flag == FAILURE) {
+			RETURN_MM();
+		}
+
+		if (str_key) {
+			phalcon_array_update_string(return_value, str_key, &realuri, 0);
+		} else {
+			phalcon_array_update_long(return_value, idx, &realuri, 0);
+		}
+	} ZEND_HASH_FOREACH_END();
+
+	RETURN_MM();
+}
+
 /**
  * Generates a URL for a static resource
  *
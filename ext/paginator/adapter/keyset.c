@@ -0,0 +1,712 @@
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2014 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  |          ZhuZongXin <dreamsxin@qq.com>                                 |
+  +------------------------------------------------------------------------+
+*/
+
+#include "paginator/adapter/keyset.h"
+#include "paginator/adapter.h"
+#include "paginator/adapterinterface.h"
+#include "paginator/exception.h"
+#include "mvc/model/query/builderinterface.h"
+#include "mvc/model/managerinterface.h"
+
+#include <ext/pdo/php_pdo_driver.h>
+#include <ext/standard/php_string.h>
+#include <zend_smart_str.h>
+
+#include "kernel/main.h"
+#include "kernel/memory.h"
+#include "kernel/object.h"
+#include "kernel/array.h"
+#include "kernel/exception.h"
+#include "kernel/operators.h"
+#include "kernel/fcall.h"
+#include "kernel/concat.h"
+#include "kernel/string.h"
+
+#include "internal/arginfo.h"
+#include "interned-strings.h"
+
+/**
+ * Phalcon\Paginator\Adapter\Keyset
+ *
+ * Keyset (seek) pagination using a PHQL query builder as source of data.
+ *
+ * Instead of skipping rows with OFFSET, every page continues from the keys of the
+ * last row of the previous one, so deep pages cost the same as the first. The keys
+ * must be an ordered, unique and not nullable tuple (usually ending with the primary
+ * key) and they define the ORDER BY of the builder. Pages are addressed by opaque
+ * cursors instead of page numbers, and no COUNT(*) is executed.
+ *
+ *<code>
+ *  $builder = $this->modelsManager->createBuilder()
+ *                   ->columns('id, name')
+ *                   ->from('Robots');
+ *
+ *  $paginator = new Phalcon\Paginator\Adapter\Keyset(array(
+ *      "builder" => $builder,
+ *      "keys" => array("name", "id"),
+ *      "limit"=> 20,
+ *      "cursor" => $this->request->getQuery("cursor")
+ *  ));
+ *
+ *  $page = $paginator->getPaginate();
+ *  echo '<a href="?cursor=', $page->next, '">Next</a>';
+ *</code>
+ */
+zend_class_entry *phalcon_paginator_adapter_keyset_ce;
+
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, __construct);
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, getPaginate);
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, setCursor);
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, getCursor);
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, setQueryBuilder);
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, getQueryBuilder);
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_paginator_adapter_keyset___construct, 0, 0, 1)
+	ZEND_ARG_INFO(0, config)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_paginator_adapter_keyset_setcursor, 0, 0, 1)
+	ZEND_ARG_INFO(0, cursor)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_phalcon_paginator_adapter_keyset_setquerybuilder, 0, 0, 1)
+	ZEND_ARG_INFO(0, queryBuilder)
+ZEND_END_ARG_INFO()
+
+static const zend_function_entry phalcon_paginator_adapter_keyset_method_entry[] = {
+	PHP_ME(Phalcon_Paginator_Adapter_Keyset, __construct, arginfo_phalcon_paginator_adapter_keyset___construct, ZEND_ACC_PUBLIC|ZEND_ACC_CTOR)
+	PHP_ME(Phalcon_Paginator_Adapter_Keyset, getPaginate, arginfo_phalcon_paginator_adapterinterface_getpaginate, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Paginator_Adapter_Keyset, setCursor, arginfo_phalcon_paginator_adapter_keyset_setcursor, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Paginator_Adapter_Keyset, getCursor, arginfo_empty, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Paginator_Adapter_Keyset, setQueryBuilder, arginfo_phalcon_paginator_adapter_keyset_setquerybuilder, ZEND_ACC_PUBLIC)
+	PHP_ME(Phalcon_Paginator_Adapter_Keyset, getQueryBuilder, arginfo_empty, ZEND_ACC_PUBLIC)
+	PHP_FE_END
+};
+
+/**
+ * Phalcon\Paginator\Adapter\Keyset initializer
+ */
+PHALCON_INIT_CLASS(Phalcon_Paginator_Adapter_Keyset){
+
+	PHALCON_REGISTER_CLASS_EX(Phalcon\\Paginator\\Adapter, Keyset, paginator_adapter_keyset, phalcon_paginator_adapter_ce, phalcon_paginator_adapter_keyset_method_entry, 0);
+
+	zend_declare_property_null(phalcon_paginator_adapter_keyset_ce, SL("_builder"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_paginator_adapter_keyset_ce, SL("_keys"), ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_paginator_adapter_keyset_ce, SL("_cursor"), ZEND_ACC_PROTECTED);
+	zend_declare_property_bool(phalcon_paginator_adapter_keyset_ce, SL("_estimate"), 0, ZEND_ACC_PROTECTED);
+	zend_declare_property_null(phalcon_paginator_adapter_keyset_ce, SL("_totalItems"), ZEND_ACC_PROTECTED);
+
+	zend_class_implements(phalcon_paginator_adapter_keyset_ce, 1, phalcon_paginator_adapterinterface_ce);
+
+	return SUCCESS;
+}
+
+/**
+ * Reads the value of a key column from a row, "Robots.id" and "[id]" are read as "id"
+ */
+static int phalcon_paginator_adapter_keyset_read_key(zval *return_value, zval *row, zend_string *column)
+{
+	const char *name = ZSTR_VAL(column), *dot;
+	size_t len = ZSTR_LEN(column);
+
+	if ((dot = zend_memrchr(name, '.', len)) != NULL) {
+		len -= dot - name + 1;
+		name = dot + 1;
+	}
+
+	if (len > 1 && name[0] == '[' && name[len - 1] == ']') {
+		name++;
+		len -= 2;
+	}
+
+	if (Z_TYPE_P(row) == IS_ARRAY) {
+		if (phalcon_array_isset_fetch_str(return_value, row, name, len, PH_COPY)) {
+			return SUCCESS;
+		}
+	} else if (Z_TYPE_P(row) == IS_OBJECT) {
+		if (phalcon_isset_property(row, name, len)) {
+			phalcon_read_property(return_value, row, name, len, PH_COPY);
+			return SUCCESS;
+		}
+	}
+
+	PHALCON_THROW_EXCEPTION_FORMAT(phalcon_paginator_exception_ce, "Key '%s' is not present in the paginated rows", ZSTR_VAL(column));
+	return FAILURE;
+}
+
+/**
+ * Collects the values of the keys of a row
+ */
+static int phalcon_paginator_adapter_keyset_values(zval *values, zval *row, zval *keys)
+{
+	zend_string *column;
+
+	array_init(values);
+	ZEND_HASH_FOREACH_STR_KEY(Z_ARRVAL_P(keys), column) {
+		zval value = {};
+		if (phalcon_paginator_adapter_keyset_read_key(&value, row, column) == FAILURE) {
+			zval_ptr_dtor(values);
+			ZVAL_UNDEF(values);
+			return FAILURE;
+		}
+		phalcon_array_append(values, &value, 0);
+	} ZEND_HASH_FOREACH_END();
+
+	return SUCCESS;
+}
+
+/**
+ * Builds the cursor pointing after ("a") or before ("b") the given key values
+ */
+static void phalcon_paginator_adapter_keyset_encode(zval *return_value, const char *direction, zval *values)
+{
+	zval payload = {}, json = {}, encoded = {};
+	size_t len;
+
+	array_init_size(&payload, 2);
+	add_next_index_string(&payload, direction);
+	phalcon_array_append(&payload, values, PH_COPY);
+
+	phalcon_json_encode(&json, &payload, 0);
+	zval_ptr_dtor(&payload);
+
+	phalcon_base64_encode(&encoded, &json);
+	zval_ptr_dtor(&json);
+
+	/* URL-safe alphabet without padding, so cursors can travel in query strings as they are */
+	len = Z_STRLEN(encoded);
+	php_strtr(Z_STRVAL(encoded), len, "+/", "-_", 2);
+	while (len && Z_STRVAL(encoded)[len - 1] == '=') {
+		len--;
+	}
+
+	ZVAL_STRINGL(return_value, Z_STRVAL(encoded), len);
+	zval_ptr_dtor(&encoded);
+}
+
+/**
+ * Decodes a cursor into the values of the keys, rejecting anything we did not produce
+ */
+static int phalcon_paginator_adapter_keyset_decode(zval *values, int *backward, zval *token, zval *keys)
+{
+	zval padded = {}, json = {}, payload = {}, direction = {}, *value;
+	zend_string *str;
+	size_t len;
+	int status = FAILURE;
+
+	if (Z_TYPE_P(token) != IS_STRING || !Z_STRLEN_P(token)) {
+		return FAILURE;
+	}
+
+	len = Z_STRLEN_P(token);
+	str = zend_string_alloc(len + 3, 0);
+	memcpy(ZSTR_VAL(str), Z_STRVAL_P(token), len);
+	php_strtr(ZSTR_VAL(str), len, "-_", "+/", 2);
+	while (len % 4) {
+		ZSTR_VAL(str)[len++] = '=';
+	}
+	ZSTR_VAL(str)[len] = '\0';
+	ZSTR_LEN(str) = len;
+	ZVAL_NEW_STR(&padded, str);
+
+	phalcon_base64_decode(&json, &padded);
+	zval_ptr_dtor(&padded);
+
+	if (Z_TYPE(json) == IS_STRING) {
+		phalcon_json_decode(&payload, &json, 1);
+	}
+	zval_ptr_dtor(&json);
+
+	if (Z_TYPE(payload) == IS_ARRAY
+		&& phalcon_array_isset_fetch_long(&direction, &payload, 0, PH_READONLY) && Z_TYPE(direction) == IS_STRING
+		&& Z_STRLEN(direction) == 1 && (Z_STRVAL(direction)[0] == 'a' || Z_STRVAL(direction)[0] == 'b')
+		&& phalcon_array_isset_fetch_long(values, &payload, 1, PH_COPY)
+	) {
+		if (Z_TYPE_P(values) == IS_ARRAY && zend_hash_num_elements(Z_ARRVAL_P(values)) == zend_hash_num_elements(Z_ARRVAL_P(keys))) {
+			status = SUCCESS;
+			ZEND_HASH_FOREACH_VAL(Z_ARRVAL_P(values), value) {
+				if (Z_TYPE_P(value) <= IS_NULL || Z_TYPE_P(value) >= IS_ARRAY) {
+					status = FAILURE;
+					break;
+				}
+			} ZEND_HASH_FOREACH_END();
+		}
+
+		*backward = Z_STRVAL(direction)[0] == 'b';
+
+		if (status == FAILURE) {
+			zval_ptr_dtor(values);
+			ZVAL_UNDEF(values);
+		}
+	}
+
+	zval_ptr_dtor(&payload);
+	return status;
+}
+
+/**
+ * Builds the seek predicate "(k1 > :a) OR (k1 = :a AND k2 > :b)", the expanded form of
+ * "(k1, k2) > (:a, :b)" which PHQL cannot express and which also allows mixed directions
+ */
+static void phalcon_paginator_adapter_keyset_seek(zval *conditions, zval *bind_params, zval *keys, zval *values, int backward)
+{
+	smart_str sql = {0};
+	zend_string *column;
+	zval *ascending;
+	uint32_t i, j, count;
+
+	array_init(bind_params);
+	count = zend_hash_num_elements(Z_ARRVAL_P(keys));
+
+	for (i = 0; i < count; i++) {
+		if (i) {
+			smart_str_appends(&sql, " OR ");
+		}
+		smart_str_appendc(&sql, '(');
+
+		j = 0;
+		ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(keys), column, ascending) {
+			zval *value = zend_hash_index_find(Z_ARRVAL_P(values), j);
+			char placeholder[32];
+			int len = snprintf(placeholder, sizeof(placeholder), "kp%u_%u", i, j);
+
+			if (j) {
+				smart_str_appends(&sql, " AND ");
+			}
+			smart_str_append(&sql, column);
+			if (j < i) {
+				smart_str_appends(&sql, " = ");
+			} else {
+				smart_str_appends(&sql, zend_is_true(ascending) != backward ? " > " : " < ");
+			}
+			smart_str_appendc(&sql, ':');
+			smart_str_appendl(&sql, placeholder, len);
+			smart_str_appendc(&sql, ':');
+
+			phalcon_array_update_str(bind_params, placeholder, len, value, PH_COPY);
+
+			if (j++ == i) {
+				break;
+			}
+		} ZEND_HASH_FOREACH_END();
+
+		smart_str_appendc(&sql, ')');
+	}
+
+	smart_str_0(&sql);
+	ZVAL_STR(conditions, sql.s);
+}
+
+/**
+ * Builds the ORDER BY clause out of the keys, reversed when walking backwards
+ */
+static void phalcon_paginator_adapter_keyset_order(zval *order, zval *keys, int backward)
+{
+	smart_str sql = {0};
+	zend_string *column;
+	zval *ascending;
+
+	ZEND_HASH_FOREACH_STR_KEY_VAL(Z_ARRVAL_P(keys), column, ascending) {
+		if (sql.s) {
+			smart_str_appends(&sql, ", ");
+		}
+		smart_str_append(&sql, column);
+		smart_str_appends(&sql, zend_is_true(ascending) != backward ? " ASC" : " DESC");
+	} ZEND_HASH_FOREACH_END();
+
+	smart_str_0(&sql);
+	ZVAL_STR(order, sql.s);
+}
+
+/**
+ * Phalcon\Paginator\Adapter\Keyset
+ *
+ *<code>
+ *  $paginator = new Phalcon\Paginator\Adapter\Keyset(array(
+ *      "builder" => $builder,
+ *      "keys" => array("createdAt" => "DESC", "id" => "DESC"),
+ *      "limit"=> 50,
+ *      "estimate" => true
+ *  ));
+ *</code>
+ *
+ * @param array $config
+ */
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, __construct){
+
+	zval *config, builder = {}, keys = {}, normalized = {}, limit = {}, cursor = {}, estimate = {}, total_items = {}, *direction;
+	zend_string *str_key;
+	ulong idx;
+
+	phalcon_fetch_params(0, 1, 0, &config);
+
+	if (!phalcon_array_isset_fetch_str(&builder, config, SL("builder"), PH_READONLY)) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_paginator_exception_ce, "Parameter 'builder' is required");
+		return;
+	}
+
+	PHALCON_VERIFY_INTERFACE_EX(&builder, phalcon_mvc_model_query_builderinterface_ce, phalcon_paginator_exception_ce);
+
+	phalcon_update_property(getThis(), SL("_builder"), &builder);
+
+	if (!phalcon_array_isset_fetch_str(&keys, config, SL("keys"), PH_READONLY)) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_paginator_exception_ce, "Parameter 'keys' is required");
+		return;
+	}
+
+	/* Normalize to column => ascending */
+	array_init(&normalized);
+	if (Z_TYPE(keys) == IS_STRING && Z_STRLEN(keys)) {
+		phalcon_array_update_str_bool(&normalized, Z_STRVAL(keys), Z_STRLEN(keys), 1, 0);
+	} else if (Z_TYPE(keys) == IS_ARRAY) {
+		ZEND_HASH_FOREACH_KEY_VAL(Z_ARRVAL(keys), idx, str_key, direction) {
+			if (!str_key) {
+				if (Z_TYPE_P(direction) != IS_STRING || !Z_STRLEN_P(direction)) {
+					zval_ptr_dtor(&normalized);
+					PHALCON_THROW_EXCEPTION_STR(phalcon_paginator_exception_ce, "Keys must be column names");
+					return;
+				}
+				phalcon_array_update_str_bool(&normalized, Z_STRVAL_P(direction), Z_STRLEN_P(direction), 1, 0);
+			} else if (Z_TYPE_P(direction) == IS_STRING && !strcasecmp(Z_STRVAL_P(direction), "ASC")) {
+				phalcon_array_update_str_bool(&normalized, ZSTR_VAL(str_key), ZSTR_LEN(str_key), 1, 0);
+			} else if (Z_TYPE_P(direction) == IS_STRING && !strcasecmp(Z_STRVAL_P(direction), "DESC")) {
+				phalcon_array_update_str_bool(&normalized, ZSTR_VAL(str_key), ZSTR_LEN(str_key), 0, 0);
+			} else {
+				zval_ptr_dtor(&normalized);
+				PHALCON_THROW_EXCEPTION_FORMAT(phalcon_paginator_exception_ce, "The direction of key '%s' must be 'ASC' or 'DESC'", ZSTR_VAL(str_key));
+				return;
+			}
+		} ZEND_HASH_FOREACH_END();
+	}
+
+	if (!zend_hash_num_elements(Z_ARRVAL(normalized))) {
+		zval_ptr_dtor(&normalized);
+		PHALCON_THROW_EXCEPTION_STR(phalcon_paginator_exception_ce, "Parameter 'keys' must contain at least one column");
+		return;
+	}
+
+	phalcon_update_property(getThis(), SL("_keys"), &normalized);
+	zval_ptr_dtor(&normalized);
+
+	if (!phalcon_array_isset_fetch_str(&limit, config, SL("limit"), PH_READONLY)) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_paginator_exception_ce, "Parameter 'limit' is required");
+		return;
+	}
+
+	if (phalcon_get_intval(&limit) < 1) {
+		PHALCON_THROW_EXCEPTION_STR(phalcon_paginator_exception_ce, "'limit' should be positive");
+		return;
+	}
+
+	phalcon_update_property(getThis(), SL("_limitRows"), &limit);
+
+	if (phalcon_array_isset_fetch_str(&cursor, config, SL("cursor"), PH_READONLY)) {
+		phalcon_update_property(getThis(), SL("_cursor"), &cursor);
+	}
+
+	if (phalcon_array_isset_fetch_str(&estimate, config, SL("estimate"), PH_READONLY)) {
+		phalcon_update_property_bool(getThis(), SL("_estimate"), zend_is_true(&estimate));
+	}
+
+	if (phalcon_array_isset_fetch_str(&total_items, config, SL("totalItems"), PH_READONLY) && Z_TYPE(total_items) == IS_LONG) {
+		phalcon_update_property(getThis(), SL("_totalItems"), &total_items);
+	}
+}
+
+/**
+ * Set the cursor of the page to return, as found in the 'next' or 'before' properties of a page
+ *
+ * @param string $cursor
+ * @return Phalcon\Paginator\Adapter\Keyset $this Fluent interface
+ */
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, setCursor){
+
+	zval *cursor;
+
+	phalcon_fetch_params(0, 1, 0, &cursor);
+
+	phalcon_update_property(getThis(), SL("_cursor"), cursor);
+
+	RETURN_THIS();
+}
+
+/**
+ * Get the cursor of the page to return
+ *
+ * @return string
+ */
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, getCursor){
+
+	RETURN_MEMBER(getThis(), "_cursor");
+}
+
+/**
+ * Set query builder object
+ *
+ * @param Phalcon\Mvc\Model\Query\BuilderInterface $builder
+ *
+ * @return Phalcon\Paginator\Adapter\Keyset $this Fluent interface
+ */
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, setQueryBuilder){
+
+	zval *query_builder;
+
+	phalcon_fetch_params(0, 1, 0, &query_builder);
+	PHALCON_VERIFY_INTERFACE_EX(query_builder, phalcon_mvc_model_query_builderinterface_ce, phalcon_paginator_exception_ce);
+
+	phalcon_update_property(getThis(), SL("_builder"), query_builder);
+
+	RETURN_THIS();
+}
+
+/**
+ * Get query builder object
+ *
+ * @return Phalcon\Mvc\Model\Query\BuilderInterface $builder
+ */
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, getQueryBuilder){
+
+	RETURN_MEMBER(getThis(), "_builder");
+}
+
+/**
+ * Returns a slice of the resultset to show in the pagination
+ *
+ * The page has the properties 'items', 'current' (the cursor used), 'next' and 'before'
+ * (the cursors of the adjacent pages, null when there are none) and 'total_items'.
+ * Totals are only known when passed as 'totalItems' or when 'estimate' is enabled, in
+ * which case they are read from the table statistics (MySQL and PostgreSQL) and
+ * ignore the conditions of the builder.
+ *
+ * @return \stdClass
+ */
+PHP_METHOD(Phalcon_Paginator_Adapter_Keyset, getPaginate){
+
+	zval event_name = {}, original_builder = {}, builder = {}, keys = {}, limit = {}, cursor = {}, values = {};
+	zval conditions = {}, bind_params = {}, order = {}, fetch_limit = {}, query = {}, resultset = {}, items = {};
+	zval next = {}, before = {}, rowcount = {}, estimate = {}, page = {}, *row;
+	long int i_limit;
+	int backward = 0, has_more = 0, count;
+
+	PHALCON_MM_INIT();
+
+	PHALCON_MM_ZVAL_STRING(&event_name, "pagination:beforeGetPaginate");
+	PHALCON_MM_CALL_METHOD(NULL, getThis(), "fireevent", &event_name);
+
+	phalcon_read_property(&original_builder, getThis(), SL("_builder"), PH_READONLY);
+	phalcon_read_property(&keys, getThis(), SL("_keys"), PH_READONLY);
+	phalcon_read_property(&limit, getThis(), SL("_limitRows"), PH_READONLY);
+	phalcon_read_property(&cursor, getThis(), SL("_cursor"), PH_READONLY);
+
+	i_limit = phalcon_get_intval(&limit);
+	if (i_limit < 1) {
+		/* This should never happen unless someone deliberately modified the properties of the object */
+		i_limit = 10;
+	}
+
+	if (PHALCON_IS_NOT_EMPTY(&cursor)) {
+		if (phalcon_paginator_adapter_keyset_decode(&values, &backward, &cursor, &keys) == FAILURE) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_paginator_exception_ce, "The pagination cursor is not valid");
+			return;
+		}
+		PHALCON_MM_ADD_ENTRY(&values);
+	}
+
+	/* Make a copy of the original builder to leave it as it is */
+	if (phalcon_clone(&builder, &original_builder) == FAILURE) {
+		RETURN_MM();
+	}
+	PHALCON_MM_ADD_ENTRY(&builder);
+
+	if (Z_TYPE(values) == IS_ARRAY) {
+		phalcon_paginator_adapter_keyset_seek(&conditions, &bind_params, &keys, &values, backward);
+		PHALCON_MM_ADD_ENTRY(&conditions);
+		PHALCON_MM_ADD_ENTRY(&bind_params);
+		PHALCON_MM_CALL_METHOD(NULL, &builder, "andwhere", &conditions, &bind_params);
+	}
+
+	phalcon_paginator_adapter_keyset_order(&order, &keys, backward);
+	PHALCON_MM_ADD_ENTRY(&order);
+	PHALCON_MM_CALL_METHOD(NULL, &builder, "orderby", &order);
+
+	/* One extra row tells whether there is a page beyond this one */
+	ZVAL_LONG(&fetch_limit, i_limit + 1);
+	PHALCON_MM_CALL_METHOD(NULL, &builder, "limit", &fetch_limit);
+
+	PHALCON_MM_CALL_METHOD(&query, &builder, "getquery");
+	PHALCON_MM_ADD_ENTRY(&query);
+
+	PHALCON_MM_CALL_METHOD(&resultset, &query, "execute");
+	PHALCON_MM_ADD_ENTRY(&resultset);
+
+	PHALCON_MM_CALL_FUNCTION(&items, "iterator_to_array", &resultset, &PHALCON_GLOBAL(z_false));
+	PHALCON_MM_ADD_ENTRY(&items);
+
+	count = zend_hash_num_elements(Z_ARRVAL(items));
+	if (count > i_limit) {
+		has_more = 1;
+		zend_hash_index_del(Z_ARRVAL(items), i_limit);
+		count--;
+	}
+
+	if (backward) {
+		zval reversed = {};
+		PHALCON_MM_CALL_FUNCTION(&reversed, "array_reverse", &items);
+		PHALCON_MM_ADD_ENTRY(&reversed);
+		ZVAL_COPY_VALUE(&items, &reversed);
+	}
+
+	/**
+	 * Walking forward there is a next page when the extra row was found and a previous
+	 * one whenever we came from a cursor; walking backwards it is the other way around
+	 */
+	if (count) {
+		if (backward || has_more) {
+			zval last = {};
+			row = zend_hash_index_find(Z_ARRVAL(items), count - 1);
+			if (phalcon_paginator_adapter_keyset_values(&last, row, &keys) == FAILURE) {
+				RETURN_MM();
+			}
+			phalcon_paginator_adapter_keyset_encode(&next, "a", &last);
+			zval_ptr_dtor(&last);
+			PHALCON_MM_ADD_ENTRY(&next);
+		}
+		if (backward ? has_more : Z_TYPE(values) == IS_ARRAY) {
+			zval first = {};
+			row = zend_hash_index_find(Z_ARRVAL(items), 0);
+			if (phalcon_paginator_adapter_keyset_values(&first, row, &keys) == FAILURE) {
+				RETURN_MM();
+			}
+			phalcon_paginator_adapter_keyset_encode(&before, "b", &first);
+			zval_ptr_dtor(&first);
+			PHALCON_MM_ADD_ENTRY(&before);
+		}
+	} else if (Z_TYPE(values) == IS_ARRAY) {
+		/* Stepped past either end, the way back starts from the cursor itself */
+		if (backward) {
+			phalcon_paginator_adapter_keyset_encode(&next, "a", &values);
+			PHALCON_MM_ADD_ENTRY(&next);
+		} else {
+			phalcon_paginator_adapter_keyset_encode(&before, "b", &values);
+			PHALCON_MM_ADD_ENTRY(&before);
+		}
+	}
+
+	phalcon_read_property(&rowcount, getThis(), SL("_totalItems"), PH_READONLY);
+	phalcon_read_property(&estimate, getThis(), SL("_estimate"), PH_READONLY);
+
+	if (Z_TYPE(rowcount) != IS_LONG && zend_is_true(&estimate)) {
+		zval dependency_injector = {}, service_name = {}, models_manager = {}, models = {}, model_name = {}, model = {};
+		zval connection = {}, type = {}, source = {}, schema = {}, sql = {}, table = {}, params = {}, fetch_mode = {}, row_count = {};
+
+		PHALCON_MM_CALL_METHOD(&dependency_injector, &query, "getdi");
+		PHALCON_MM_ADD_ENTRY(&dependency_injector);
+		if (Z_TYPE(dependency_injector) != IS_OBJECT) {
+			PHALCON_MM_THROW_EXCEPTION_STR(phalcon_paginator_exception_ce, "A dependency injection object is required to access internal services");
+			return;
+		}
+
+		ZVAL_STR(&service_name, IS(modelsManager));
+
+		PHALCON_MM_CALL_METHOD(&models_manager, &dependency_injector, "getshared", &service_name);
+		PHALCON_MM_ADD_ENTRY(&models_manager);
+		PHALCON_MM_VERIFY_INTERFACE(&models_manager, phalcon_mvc_model_managerinterface_ce);
+
+		PHALCON_MM_CALL_METHOD(&models, &builder, "getfrom");
+		PHALCON_MM_ADD_ENTRY(&models);
+
+		if (Z_TYPE(models) == IS_ARRAY) {
+			phalcon_array_get_current(&model_name, &models);
+		} else {
+			ZVAL_COPY(&model_name, &models);
+		}
+		PHALCON_MM_ADD_ENTRY(&model_name);
+
+		PHALCON_MM_CALL_METHOD(&model, &models_manager, "load", &model_name);
+		PHALCON_MM_ADD_ENTRY(&model);
+		PHALCON_MM_CALL_METHOD(&connection, &model, "getreadconnection");
+		PHALCON_MM_ADD_ENTRY(&connection);
+		PHALCON_MM_CALL_METHOD(&source, &model, "getsource");
+		PHALCON_MM_ADD_ENTRY(&source);
+		PHALCON_MM_CALL_METHOD(&schema, &model, "getschema");
+		PHALCON_MM_ADD_ENTRY(&schema);
+		PHALCON_MM_CALL_METHOD(&type, &connection, "gettype");
+		PHALCON_MM_ADD_ENTRY(&type);
+
+		array_init(&params);
+		PHALCON_MM_ADD_ENTRY(&params);
+
+		if (PHALCON_IS_STRING(&type, "mysql")) {
+			/* TABLE_ROWS is the InnoDB estimate refreshed by ANALYZE TABLE */
+			if (PHALCON_IS_NOT_EMPTY(&schema)) {
+				PHALCON_MM_ZVAL_STRING(&sql, "SELECT TABLE_ROWS AS rowcount FROM information_schema.TABLES WHERE TABLE_SCHEMA = ? AND TABLE_NAME = ?");
+				phalcon_array_append(&params, &schema, PH_COPY);
+			} else {
+				PHALCON_MM_ZVAL_STRING(&sql, "SELECT TABLE_ROWS AS rowcount FROM information_schema.TABLES WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ?");
+			}
+			phalcon_array_append(&params, &source, PH_COPY);
+		} else if (PHALCON_IS_STRING(&type, "pgsql")) {
+			/* reltuples is maintained by VACUUM and ANALYZE, -1 until the table was analyzed */
+			PHALCON_MM_ZVAL_STRING(&sql, "SELECT CAST(reltuples AS BIGINT) AS rowcount FROM pg_class WHERE oid = to_regclass(?)");
+			if (PHALCON_IS_NOT_EMPTY(&schema)) {
+				PHALCON_CONCAT_VSV(&table, &schema, ".", &source);
+			} else {
+				ZVAL_COPY(&table, &source);
+			}
+			phalcon_array_append(&params, &table, 0);
+		}
+
+		if (Z_TYPE(sql) == IS_STRING) {
+			ZVAL_LONG(&fetch_mode, PDO_FETCH_ASSOC);
+			PHALCON_MM_CALL_METHOD(&row_count, &connection, "fetchone", &sql, &fetch_mode, &params);
+			PHALCON_MM_ADD_ENTRY(&row_count);
+
+			if (Z_TYPE(row_count) == IS_ARRAY && phalcon_array_isset_fetch_str(&rowcount, &row_count, SL("rowcount"), PH_READONLY) && Z_TYPE(rowcount) > IS_NULL) {
+				ZVAL_LONG(&rowcount, MAX(phalcon_get_intval(&rowcount), 0));
+			} else {
+				ZVAL_NULL(&rowcount);
+			}
+		}
+	}
+
+	object_init(&page);
+	PHALCON_MM_ADD_ENTRY(&page);
+	phalcon_update_property(&page, SL("items"), &items);
+	phalcon_update_property(&page, SL("current"), &cursor);
+	phalcon_update_property(&page, SL("next"), &next);
+	phalcon_update_property(&page, SL("before"), &before);
+	phalcon_update_property_long(&page, SL("limit"), i_limit);
+	if (Z_TYPE(rowcount) == IS_LONG) {
+		phalcon_update_property(&page, SL("total_items"), &rowcount);
+		phalcon_update_property(&page, SL("totalItems"), &rowcount);
+	} else {
+		phalcon_update_property_null(&page, SL("total_items"));
+		phalcon_update_property_null(&page, SL("totalItems"));
+	}
+
+	PHALCON_MM_ZVAL_STRING(&event_name, "pagination:afterGetPaginate");
+	PHALCON_MM_CALL_METHOD(return_value, getThis(), "fireevent", &event_name, &page);
+
+	if (Z_TYPE_P(return_value) < IS_ARRAY) {
+		zval_ptr_dtor(return_value);
+		RETURN_MM_CTOR(&page);
+	}
+	RETURN_MM();
+}
@@ -114,6 +114,10 @@ PHP_INI_BEGIN()
 	STD_PHP_INI_BOOLEAN("phalcon.orm.exception_on_failed_save", "0",    PHP_INI_ALL,    OnUpdateBool, orm.exception_on_failed_save, zend_phalcon_globals, phalcon_globals)
 	/* Enables/Disables literals in PHQL */
 	STD_PHP_INI_BOOLEAN("phalcon.orm.enable_literals",          "1",    PHP_INI_ALL,    OnUpdateBool, orm.enable_literals,          zend_phalcon_globals, phalcon_globals)
+	/* Enables/Disables the PHQL intermediate representation and SQL cache */
+	STD_PHP_INI_BOOLEAN("phalcon.orm.enable_statement_cache",   "0",    PHP_INI_ALL,    OnUpdateBool, orm.enable_statement_cache,   zend_phalcon_globals, phalcon_globals)
+	/* Enables/Disables the identity map of the models manager */
+	STD_PHP_INI_BOOLEAN("phalcon.orm.enable_identity_map",      "0",    PHP_INI_ALL,    OnUpdateBool, orm.enable_identity_map,      zend_phalcon_globals, phalcon_globals)
 	/* Enables/Disables property method */
 	STD_PHP_INI_BOOLEAN("phalcon.orm.enable_property_method",   "1",    PHP_INI_ALL,    OnUpdateBool, orm.enable_property_method,   zend_phalcon_globals, phalcon_globals)
 	/* Enables/Disables auto convert column value follow database data type */
@@ -542,12 +546,14 @@ static PHP_MINIT_FUNCTION(phalcon)
 	PHALCON_INIT(Phalcon_Cache_Frontend_None);
 	PHALCON_INIT(Phalcon_Cache_Frontend_Base64);
 	PHALCON_INIT(Phalcon_Cache_Frontend_Igbinary);
+	PHALCON_INIT(Phalcon_Cache_Frontend_Binary);
 	PHALCON_INIT(Phalcon_Tag);
 	PHALCON_INIT(Phalcon_Tag_Select);
 	PHALCON_INIT(Phalcon_Paginator_Adapter);
 	PHALCON_INIT(Phalcon_Paginator_Adapter_Model);
 	PHALCON_INIT(Phalcon_Paginator_Adapter_NativeArray);
 	PHALCON_INIT(Phalcon_Paginator_Adapter_QueryBuilder);
+	PHALCON_INIT(Phalcon_Paginator_Adapter_Keyset);
 	PHALCON_INIT(Phalcon_Paginator_Adapter_DbBuilder);
 	PHALCON_INIT(Phalcon_Paginator_Adapter_Sql);
 	PHALCON_INIT(Phalcon_Validation);
@@ -596,6 +602,11 @@ static PHP_MINIT_FUNCTION(phalcon)
 	PHALCON_INIT(Phalcon_Db_Builder_Update);
 	PHALCON_INIT(Phalcon_Db_Builder_Insert);
 	PHALCON_INIT(Phalcon_Db_Builder_Delete);
+	PHALCON_INIT(Phalcon_Db_Router);
+	PHALCON_INIT(Phalcon_Db_Pool);
+#if PHALCON_USE_ASYNC
+	PHALCON_INIT(Phalcon_Db_Async_Postgresql);
+#endif
 	PHALCON_INIT(Phalcon_Kernel);
 	PHALCON_INIT(Phalcon_Debug);
 	PHALCON_INIT(Phalcon_Debug_Dump);
@@ -731,6 +742,9 @@ static PHP_MINIT_FUNCTION(phalcon)
 	PHALCON_INIT(Phalcon_Mvc_Model_MetaData_Mongo);
 #endif
 	PHALCON_INIT(Phalcon_Mvc_Model_MetaData_Cache);
+#ifdef PHALCON_CACHE_YAC
+	PHALCON_INIT(Phalcon_Mvc_Model_MetaData_Shm);
+#endif
 	PHALCON_INIT(Phalcon_Mvc_Model_MetaData_Memory);
 	PHALCON_INIT(Phalcon_Mvc_Model_MetaData_Strategy_Annotations);
 	PHALCON_INIT(Phalcon_Mvc_Model_MetaData_Strategy_Introspection);
@@ -876,6 +890,7 @@ static PHP_MSHUTDOWN_FUNCTION(phalcon){
 	phalcon_deinitialize_memory();
 
 	assert(PHALCON_GLOBAL(orm).ast_cache == NULL);
+	assert(PHALCON_GLOBAL(orm).statement_cache == NULL);
 #ifdef PHALCON_CACHE_YAC
 	if (PHALCON_GLOBAL(cache).enable_yac) {
 		phalcon_cache_yac_storage_shutdown();
@@ -981,6 +996,9 @@ static PHP_RINIT_FUNCTION(phalcon)
 
 static PHP_RSHUTDOWN_FUNCTION(phalcon){
 
+	/* Models managers still alive forget their identity map */
+	PHALCON_GLOBAL(orm).identity_map_request++;
+
 	if (PHALCON_GLOBAL(aop).enable_aop) {
 		int i;
 		zend_array_destroy(PHALCON_GLOBAL(aop).pointcuts_table);
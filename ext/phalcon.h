@@ -60,6 +60,7 @@
 #include "cache/exception.h"
 #include "cache/frontendinterface.h"
 #include "cache/frontend/base64.h"
+#include "cache/frontend/binary.h"
 #include "cache/frontend/data.h"
 #include "cache/frontend/igbinary.h"
 #include "cache/frontend/json.h"
@@ -120,6 +121,9 @@
 #include "db/builder/update.h"
 #include "db/builder/insert.h"
 #include "db/builder/delete.h"
+#include "db/router.h"
+#include "db/pool.h"
+#include "db/async/postgresql.h"
 
 #include "debug.h"
 #include "debug/exception.h"
@@ -297,6 +301,7 @@
 #include "mvc/model/metadata/redis.h"
 #include "mvc/model/metadata/mongo.h"
 #include "mvc/model/metadata/cache.h"
+#include "mvc/model/metadata/shm.h"
 #include "mvc/model/metadata/strategy/annotations.h"
 #include "mvc/model/metadata/strategy/introspection.h"
 #include "mvc/model/query.h"
@@ -359,6 +364,7 @@
 #include "paginator/adapter/model.h"
 #include "paginator/adapter/nativearray.h"
 #include "paginator/adapter/querybuilder.h"
+#include "paginator/adapter/keyset.h"
 #include "paginator/adapter/dbbuilder.h"
 #include "paginator/adapter/sql.h"
 #include "paginator/exception.h"
@@ -51,6 +51,11 @@ typedef struct _phalcon_debug_options {
 /** ORM options */
 typedef struct _phalcon_orm_options {
 	HashTable *ast_cache;
+	HashTable *statement_cache;
+	zend_long statement_cache_version;
+	zend_long statement_cache_hits;
+	zend_long statement_cache_misses;
+	zend_ulong identity_map_request;
 	int cache_level;
 	zend_bool events;
 	zend_bool virtual_foreign_keys;
@@ -60,6 +65,8 @@ typedef struct _phalcon_orm_options {
 	zend_bool exception_on_failed_save;
 	zend_bool enable_literals;
 	zend_bool enable_ast_cache;
+	zend_bool enable_statement_cache;
+	zend_bool enable_identity_map;
 	zend_bool enable_property_method;
 	zend_bool enable_auto_convert;
 	zend_bool allow_update_primary;
@@ -312,6 +319,12 @@ ZEND_BEGIN_MODULE_GLOBALS(phalcon)
 	/** Max recursion control */
 	unsigned int recursive_lock;
 
+	/** Routes version, changed by the route setters of the pattern and the methods to rebuild the routers index */
+	zend_ulong routes_version;
+
+	/** Route names version, changed by Phalcon\Mvc\Router\Route::setName() to rebuild the routers name lookup */
+	zend_ulong route_names_version;
+
 	/** Security */
 	phalcon_security_options security;
 
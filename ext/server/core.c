@@ -21,6 +21,8 @@
 #include "server/core.h"
 
 #include <sys/select.h>
+#include <sys/wait.h>
+#include <time.h>
 
 void phalcon_server_init_log(struct phalcon_server_context *ctx)
 {
@@ -83,6 +85,16 @@ void phalcon_server_init_signal(struct phalcon_server_context *ctx)
 		phalcon_server_exit_cleanup(ctx);
 	}
 
+	if(sigaddset(&siglist, SIGHUP) == -1) {
+		perror("Unable to add SIGHUP signal to signal list");
+		phalcon_server_exit_cleanup(ctx);
+	}
+
+	if(sigaddset(&siglist, SIGCHLD) == -1) {
+		perror("Unable to add SIGCHLD signal to signal list");
+		phalcon_server_exit_cleanup(ctx);
+	}
+
 	if(pthread_sigmask(SIG_BLOCK, &siglist, NULL) != 0) {
 		perror("Unable to change signal mask");
 		phalcon_server_exit_cleanup(ctx);
@@ -152,6 +164,14 @@ struct phalcon_server_conn_context *phalcon_server_alloc_context(struct phalcon_
 	ret->fd = 0;
 	ret->fd_added = 0;
 	ret->next_idx = -1;
+	ret->user_data = NULL;
+	ret->response = NULL;
+	ret->keepalive = 0;
+	ret->output_head = NULL;
+	ret->output_tail = NULL;
+	ret->timer.prev = NULL;
+	ret->timer.next = NULL;
+	ret->timer.kind = PHALCON_SERVER_TIMER_NONE;
 
 	ret->pool = pool;
 
@@ -185,6 +205,311 @@ struct phalcon_server_conn_context *phalcon_server_get_context(struct phalcon_se
 	return ret;
 }
 
+static void phalcon_server_output_push(struct phalcon_server_conn_context *client_ctx, struct phalcon_server_output_chunk *chunk)
+{
+	chunk->next = NULL;
+	if (client_ctx->output_tail) {
+		client_ctx->output_tail->next = chunk;
+	} else {
+		client_ctx->output_head = chunk;
+	}
+	client_ctx->output_tail = chunk;
+}
+
+static void phalcon_server_output_shift(struct phalcon_server_conn_context *client_ctx)
+{
+	struct phalcon_server_output_chunk *chunk = client_ctx->output_head;
+
+	client_ctx->output_head = chunk->next;
+	if (!client_ctx->output_head) {
+		client_ctx->output_tail = NULL;
+	}
+
+	if (chunk->str) {
+		zend_string_release(chunk->str);
+	}
+	if (chunk->fd >= 0) {
+		close(chunk->fd);
+	}
+	efree(chunk);
+}
+
+/**
+ * Queues a string, it's referenced instead of copied
+ */
+void phalcon_server_output_append_string(struct phalcon_server_conn_context *client_ctx, zend_string *str)
+{
+	struct phalcon_server_output_chunk *chunk;
+
+	if (!ZSTR_LEN(str)) {
+		return;
+	}
+
+	chunk = emalloc(sizeof(struct phalcon_server_output_chunk));
+	chunk->str = zend_string_copy(str);
+	chunk->fd = -1;
+	chunk->offset = 0;
+	chunk->length = ZSTR_LEN(str);
+
+	phalcon_server_output_push(client_ctx, chunk);
+}
+
+/**
+ * Queues a region of a file to be sent with sendfile(), the descriptor is closed once sent
+ */
+void phalcon_server_output_append_file(struct phalcon_server_conn_context *client_ctx, int fd, off_t offset, size_t length)
+{
+	struct phalcon_server_output_chunk *chunk;
+
+	if (!length) {
+		close(fd);
+		return;
+	}
+
+	chunk = emalloc(sizeof(struct phalcon_server_output_chunk));
+	chunk->str = NULL;
+	chunk->fd = fd;
+	chunk->offset = offset;
+	chunk->length = length;
+
+	phalcon_server_output_push(client_ctx, chunk);
+}
+
+/**
+ * Writes the queued output, consecutive strings are gathered with writev() and files are
+ * sent with sendfile(). Returns 1 when everything was written, 0 when the socket would
+ * block and -1 on error
+ */
+int phalcon_server_output_flush(struct phalcon_server_conn_context *client_ctx)
+{
+	struct phalcon_server_output_chunk *chunk;
+	struct iovec iov[PHALCON_SERVER_MAX_IOVECS];
+	ssize_t ret;
+	int n;
+
+	while ((chunk = client_ctx->output_head) != NULL) {
+		if (chunk->fd >= 0) {
+			ret = sendfile(client_ctx->fd, chunk->fd, &chunk->offset, chunk->length);
+			if (ret < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+			}
+			if (ret == 0) {
+				/* The file is shorter than announced */
+				return -1;
+			}
+
+			chunk->length -= ret;
+			if (!chunk->length) {
+				phalcon_server_output_shift(client_ctx);
+			}
+			continue;
+		}
+
+		for (n = 0; chunk && chunk->fd < 0 && n < PHALCON_SERVER_MAX_IOVECS; chunk = chunk->next, n++) {
+			iov[n].iov_base = ZSTR_VAL(chunk->str) + chunk->offset;
+			iov[n].iov_len = chunk->length;
+		}
+
+		ret = writev(client_ctx->fd, iov, n);
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+		}
+
+		while (ret > 0) {
+			chunk = client_ctx->output_head;
+			if ((size_t)ret >= chunk->length) {
+				ret -= chunk->length;
+				phalcon_server_output_shift(client_ctx);
+			} else {
+				chunk->offset += ret;
+				chunk->length -= ret;
+				ret = 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+void phalcon_server_output_free(struct phalcon_server_conn_context *client_ctx)
+{
+	while (client_ctx->output_head) {
+		phalcon_server_output_shift(client_ctx);
+	}
+}
+
+static uint64_t phalcon_server_timer_now()
+{
+	struct timespec ts;
+
+#ifdef CLOCK_MONOTONIC_COARSE
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+	return ts.tv_sec;
+}
+
+static struct phalcon_server_timer_wheel *phalcon_server_timer_wheel_init()
+{
+	struct phalcon_server_timer_wheel *wheel;
+	int i, j;
+
+	wheel = calloc(1, sizeof(struct phalcon_server_timer_wheel));
+	assert(wheel);
+
+	wheel->now = phalcon_server_timer_now();
+	for (i = 0; i < PHALCON_SERVER_WHEEL_LEVELS; i++) {
+		for (j = 0; j < PHALCON_SERVER_WHEEL_SIZE; j++) {
+			wheel->slots[i][j].prev = &wheel->slots[i][j];
+			wheel->slots[i][j].next = &wheel->slots[i][j];
+		}
+	}
+	pthread_mutex_init(&wheel->lock, NULL);
+
+	return wheel;
+}
+
+static void phalcon_server_timer_unlink(struct phalcon_server_timer *timer)
+{
+	if (timer->next) {
+		timer->prev->next = timer->next;
+		timer->next->prev = timer->prev;
+		timer->prev = NULL;
+		timer->next = NULL;
+	}
+}
+
+static void phalcon_server_timer_link(struct phalcon_server_timer_wheel *wheel, struct phalcon_server_timer *timer)
+{
+	struct phalcon_server_timer *head;
+	uint64_t delta, max = (uint64_t)(PHALCON_SERVER_WHEEL_SIZE - 1) << PHALCON_SERVER_WHEEL_BITS;
+
+	if (timer->expires < wheel->now) {
+		timer->expires = wheel->now;
+	}
+
+	delta = timer->expires - wheel->now;
+	if (delta > max) {
+		timer->expires = wheel->now + max;
+		delta = max;
+	}
+
+	if (delta < PHALCON_SERVER_WHEEL_SIZE) {
+		head = &wheel->slots[0][timer->expires & PHALCON_SERVER_WHEEL_MASK];
+	} else {
+		head = &wheel->slots[1][(timer->expires >> PHALCON_SERVER_WHEEL_BITS) & PHALCON_SERVER_WHEEL_MASK];
+	}
+
+	timer->prev = head->prev;
+	timer->next = head;
+	head->prev->next = timer;
+	head->prev = timer;
+}
+
+/**
+ * Arms (or rearms) the timer of a connection, a header timer keeps its original deadline so
+ * a client sending the headers slowly can't extend it
+ */
+void phalcon_server_timer_arm(struct phalcon_server_context *ctx, struct phalcon_server_conn_context *client_ctx, int kind)
+{
+	struct phalcon_server_timer_wheel *wheel = ctx->wheel;
+	int timeout;
+
+	switch (kind) {
+		case PHALCON_SERVER_TIMER_HEADER:
+			timeout = ctx->header_timeout;
+			break;
+		case PHALCON_SERVER_TIMER_BODY:
+			timeout = ctx->body_timeout;
+			break;
+		case PHALCON_SERVER_TIMER_KEEPALIVE:
+			timeout = ctx->keepalive_timeout;
+			break;
+		default:
+			timeout = 0;
+			break;
+	}
+
+	if (!wheel) {
+		return;
+	}
+
+	pthread_mutex_lock(&wheel->lock);
+	if (kind == PHALCON_SERVER_TIMER_HEADER && client_ctx->timer.kind == kind && client_ctx->timer.next) {
+		pthread_mutex_unlock(&wheel->lock);
+		return;
+	}
+
+	phalcon_server_timer_unlink(&client_ctx->timer);
+	client_ctx->timer.kind = kind;
+	if (timeout > 0) {
+		client_ctx->timer.expires = wheel->now + timeout;
+		phalcon_server_timer_link(wheel, &client_ctx->timer);
+	}
+	pthread_mutex_unlock(&wheel->lock);
+}
+
+void phalcon_server_timer_disarm(struct phalcon_server_context *ctx, struct phalcon_server_conn_context *client_ctx)
+{
+	struct phalcon_server_timer_wheel *wheel = ctx->wheel;
+
+	if (!wheel) {
+		return;
+	}
+
+	pthread_mutex_lock(&wheel->lock);
+	phalcon_server_timer_unlink(&client_ctx->timer);
+	client_ctx->timer.kind = PHALCON_SERVER_TIMER_NONE;
+	pthread_mutex_unlock(&wheel->lock);
+}
+
+/**
+ * Moves the wheel up to the current second. Expired connections are shut down, the socket
+ * then reports a hang up and the connection is released by its own handler
+ */
+static void phalcon_server_timer_wheel_advance(struct phalcon_server_context *ctx, struct phalcon_server_timer_wheel *wheel)
+{
+	struct phalcon_server_timer *head, *timer;
+	struct phalcon_server_conn_context *client_ctx;
+	uint64_t now = phalcon_server_timer_now();
+
+	pthread_mutex_lock(&wheel->lock);
+	while (wheel->now < now) {
+		wheel->now++;
+
+		/* Cascade the timers of the upper level when the first level completes a turn */
+		if (!(wheel->now & PHALCON_SERVER_WHEEL_MASK)) {
+			head = &wheel->slots[1][(wheel->now >> PHALCON_SERVER_WHEEL_BITS) & PHALCON_SERVER_WHEEL_MASK];
+			while ((timer = head->next) != head) {
+				phalcon_server_timer_unlink(timer);
+				phalcon_server_timer_link(wheel, timer);
+			}
+		}
+
+		head = &wheel->slots[0][wheel->now & PHALCON_SERVER_WHEEL_MASK];
+		while ((timer = head->next) != head) {
+			phalcon_server_timer_unlink(timer);
+			if (timer->expires > wheel->now) {
+				phalcon_server_timer_link(wheel, timer);
+				continue;
+			}
+
+			client_ctx = (struct phalcon_server_conn_context *)((char *)timer - XtOffsetOf(struct phalcon_server_conn_context, timer));
+			phalcon_server_log_printf(ctx, "Socket %d timed out (%d)\n", client_ctx->fd, timer->kind);
+			timer->kind = PHALCON_SERVER_TIMER_NONE;
+			shutdown(client_ctx->fd, SHUT_RDWR);
+		}
+	}
+	pthread_mutex_unlock(&wheel->lock);
+}
+
 int phalcon_server_init_single_server(struct phalcon_server_context *ctx, struct in_addr ip, uint16_t port)
 {
 	struct sockaddr_in addr;
@@ -206,6 +531,13 @@ int phalcon_server_init_single_server(struct phalcon_server_context *ctx, struct
 		phalcon_server_exit_cleanup(ctx);
 	}
 
+#ifdef SO_REUSEPORT
+	if(ctx->reuseport && setsockopt(serverfd, SOL_SOCKET, SO_REUSEPORT, &value, sizeof(value)) == -1) {
+		perror("Unable to set socket reuseport option");
+		phalcon_server_exit_cleanup(ctx);
+	}
+#endif
+
 	memset(&addr, 0, addrlen);
 	addr.sin_family = AF_INET;
 	addr.sin_port = htons(port);
@@ -241,6 +573,15 @@ void phalcon_server_init_server(struct phalcon_server_context *ctx)
 		port = ctx->la[i].param_port;
 
 		ctx->la[i].listen_fd = phalcon_server_init_single_server(ctx, ip, port);
+
+		/**
+		 * With SO_REUSEPORT every worker binds its own socket and gets its own accept queue,
+		 * the master only checks that the address can be bound
+		 */
+		if (ctx->reuseport) {
+			close(ctx->la[i].listen_fd);
+			ctx->la[i].listen_fd = -1;
+		}
 	}
 
 	limits.rlim_cur = RLIM_INFINITY;
@@ -315,6 +656,10 @@ static void phalcon_server_worker_threadpool_destroy(struct phalcon_server_conte
 
 /* Thread end */
 
+static void phalcon_server_wakeup_handler(int signum)
+{
+}
+
 void phalcon_server_process_clients(struct phalcon_server_context *ctx, void *arg)
 {
 	struct phalcon_server_worker_data *mydata = (struct phalcon_server_worker_data *)arg;
@@ -329,8 +674,13 @@ void phalcon_server_process_clients(struct phalcon_server_context *ctx, void *ar
 	int cpu_id = mydata->cpu_id;;
 	int ep_fd;
 	int i;
+	int generation = mydata->generation;
+	time_t drain_start = 0;
+	sigset_t siglist, waitlist;
+	struct sigaction sa;
 
 	struct phalcon_server_conn_context *listen_ctx;
+	struct phalcon_server_conn_context *listen_ctxs[32];
 
 	ret = phalcon_server_bind_process_cpu(cpu_id);
 	if (ret < 0) {
@@ -338,15 +688,40 @@ void phalcon_server_process_clients(struct phalcon_server_context *ctx, void *ar
 		phalcon_server_exit_cleanup(ctx);
 	}
 
+	/**
+	 * SIGUSR1 only interrupts epoll_pwait(), the master sends it to make a worker drain
+	 */
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = phalcon_server_wakeup_handler;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGUSR1, &sa, NULL);
+
+	sigemptyset(&siglist);
+	sigaddset(&siglist, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &siglist, &waitlist);
+	sigdelset(&waitlist, SIGUSR1);
+
 	ctx->pool = phalcon_server_init_pool(PHALCON_SERVER_MAX_CONNS_PER_WORKER);
 
+	if (ctx->header_timeout > 0 || ctx->body_timeout > 0 || ctx->keepalive_timeout > 0) {
+		ctx->wheel = phalcon_server_timer_wheel_init();
+	}
+
 	if ((ep_fd = epoll_create(PHALCON_SERVER_MAX_CONNS_PER_WORKER)) < 0) {
 		perror("Unable to create epoll FD");
 		phalcon_server_exit_cleanup(ctx);
 	}
 
+#if PHALCON_USE_THREADPOOL
+	FD_ZERO(&listen_fds);
+#endif
 	for (i = 0; i < ctx->la_num; i++) {
+		if (ctx->reuseport) {
+			ctx->la[i].listen_fd = phalcon_server_init_single_server(ctx, ctx->la[i].listenip, ctx->la[i].param_port);
+		}
+
 		listen_ctx = phalcon_server_alloc_context(ctx->pool);
+		listen_ctxs[i] = listen_ctx;
 
 		listen_ctx->fd = ctx->la[i].listen_fd;
 		listen_ctx->handler = ctx->accept ? ctx->accept : phalcon_server_builtin_process_accept;
@@ -374,7 +749,46 @@ void phalcon_server_process_clients(struct phalcon_server_context *ctx, void *ar
 		int i;
 		int events;
 
-		num_events = epoll_wait(ep_fd, evts, PHALCON_SERVER_EVENTS_PER_BATCH, -1);
+		/**
+		 * A newer worker took this slot, stop accepting and finish the open connections
+		 */
+		if (unlikely(mydata->generation != generation)) {
+			if (!drain_start) {
+				drain_start = time(NULL);
+				for (i = 0; i < ctx->la_num; i++) {
+					epoll_ctl(ep_fd, EPOLL_CTL_DEL, listen_ctxs[i]->fd, &evt);
+#if PHALCON_USE_THREADPOOL
+					FD_CLR(listen_ctxs[i]->fd, &listen_fds);
+#endif
+					if (ctx->reuseport) {
+						uint64_t accepted;
+
+						/**
+						 * The connections queued on an own socket are dropped when it is closed,
+						 * accept them until the queue is empty
+						 */
+						do {
+							accepted = ctx->wdata[cpu_id].acceptcnt;
+							listen_ctxs[i]->events = EPOLLIN;
+							listen_ctxs[i]->handler(ctx, listen_ctxs[i]);
+						} while (ctx->wdata[cpu_id].acceptcnt != accepted);
+
+						close(listen_ctxs[i]->fd);
+					}
+				}
+				phalcon_server_log_printf(ctx, "Worker on cpu %d is draining\n", cpu_id);
+			}
+			if (ctx->pool->allocated <= ctx->la_num || time(NULL) - drain_start >= PHALCON_SERVER_DRAIN_TIMEOUT) {
+				break;
+			}
+		}
+
+		num_events = epoll_pwait(ep_fd, evts, PHALCON_SERVER_EVENTS_PER_BATCH, (drain_start || ctx->wheel) ? 1000 : -1, &waitlist);
+
+		if (ctx->wheel) {
+			phalcon_server_timer_wheel_advance(ctx, ctx->wheel);
+		}
+
 		if (num_events < 0) {
 			if (errno == EINTR)
 				continue;
@@ -424,34 +838,122 @@ void phalcon_server_process_clients(struct phalcon_server_context *ctx, void *ar
 #endif
 }
 
+static void phalcon_server_spawn_worker(struct phalcon_server_context *ctx, int i)
+{
+	int pid;
+
+	if ( (pid = fork()) < 0) {
+		perror("Unable to fork child process");
+		phalcon_server_exit_cleanup(ctx);
+	} else if( pid == 0) {
+		ctx->wdata[i].process = getpid();
+		ctx->cpu_id = ctx->wdata[i].cpu_id ;
+		phalcon_server_process_clients(ctx, (void *)&(ctx->wdata[i]));
+		exit(0);
+	}
+
+	ctx->wdata[i].process = pid;
+	ctx->wdata[i].spawned = time(NULL);
+	ctx->wdata[i].respawn_at = 0;
+}
+
 void phalcon_server_init_workers(struct phalcon_server_context *ctx)
 {
-	int i, pid;
+	int i;
 
 	ctx->wdata = mmap(NULL, ctx->num_workers * sizeof(struct phalcon_server_worker_data),
 		     PROT_READ|PROT_WRITE,
 		     MAP_ANON|MAP_SHARED,
 		     -1, 0);
 
-	memset(ctx->wdata, 0, ctx->num_workers * sizeof(struct phalcon_server_worker_data));
-
-	if (ctx->wdata == NULL) {
+	if (ctx->wdata == MAP_FAILED) {
+		ctx->wdata = NULL;
 		perror("Unable to mmap shared global wdata");
 		phalcon_server_exit_cleanup(ctx);
 	}
 
+	memset(ctx->wdata, 0, ctx->num_workers * sizeof(struct phalcon_server_worker_data));
+
 	for(i = 0; i < ctx->num_workers; i++) {
 		ctx->wdata[i].trancnt = 0;
 		ctx->wdata[i].cpu_id = i + ctx->start_cpu;
 
-		if ( (pid = fork()) < 0) {
-			perror("Unable to fork child process");
-			phalcon_server_exit_cleanup(ctx);
-		} else if( pid == 0) {
-			ctx->wdata[i].process = getpid();
-			ctx->cpu_id = ctx->wdata[i].cpu_id ;
-			phalcon_server_process_clients(ctx, (void *)&(ctx->wdata[i]));
-			exit(0);
+		phalcon_server_spawn_worker(ctx, i);
+	}
+}
+
+/**
+ * Starts a new generation of workers, the old ones stop accepting and exit once their
+ * connections are finished. A worker of an older generation still draining is terminated.
+ *
+ * The new workers are forked from the master as it is, the application it was started with
+ * and the files it loaded are not read again: changes of the code need a restart
+ */
+void phalcon_server_reload_workers(struct phalcon_server_context *ctx)
+{
+	int i;
+	pid_t old;
+
+	for(i = 0; i < ctx->num_workers; i++) {
+		old = ctx->wdata[i].process;
+		ctx->wdata[i].generation++;
+		phalcon_server_spawn_worker(ctx, i);
+		if (ctx->wdata[i].draining) {
+			kill(ctx->wdata[i].draining, SIGTERM);
+		}
+		ctx->wdata[i].draining = old;
+		if (old) {
+			kill(old, SIGUSR1);
+		}
+	}
+}
+
+/**
+ * Reaps the exited workers and replaces the ones that died unexpectedly, a worker dying right
+ * after its start is replaced after a delay doubled on every crash
+ */
+static void phalcon_server_reap_workers(struct phalcon_server_context *ctx)
+{
+	pid_t pid;
+	int status, i;
+
+	while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+		for(i = 0; i < ctx->num_workers; i++) {
+			if (ctx->wdata[i].draining == pid) {
+				ctx->wdata[i].draining = 0;
+				break;
+			}
+			if (ctx->wdata[i].process == pid && !ctx->wdata[i].shutdown) {
+				ctx->wdata[i].process = 0;
+				if (time(NULL) - ctx->wdata[i].spawned < PHALCON_SERVER_RESPAWN_MIN_UPTIME) {
+					ctx->wdata[i].respawn_delay = ctx->wdata[i].respawn_delay ? MIN(ctx->wdata[i].respawn_delay * 2, PHALCON_SERVER_RESPAWN_MAX_DELAY) : 1;
+				} else {
+					ctx->wdata[i].respawn_delay = 0;
+				}
+				if (ctx->wdata[i].respawn_delay) {
+					phalcon_server_log_printf(ctx, "Worker %d exited, restarting it in %d seconds\n", pid, ctx->wdata[i].respawn_delay);
+					ctx->wdata[i].respawn_at = time(NULL) + ctx->wdata[i].respawn_delay;
+				} else {
+					phalcon_server_log_printf(ctx, "Worker %d exited, restarting it\n", pid);
+					phalcon_server_spawn_worker(ctx, i);
+				}
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * Replaces the crashed workers whose restart delay elapsed
+ */
+static void phalcon_server_respawn_workers(struct phalcon_server_context *ctx)
+{
+	time_t now = time(NULL);
+	int i;
+
+	for(i = 0; i < ctx->num_workers; i++) {
+		if (ctx->wdata[i].respawn_at && ctx->wdata[i].respawn_at <= now && !ctx->wdata[i].shutdown) {
+			phalcon_server_spawn_worker(ctx, i);
 		}
 	}
 }
@@ -537,6 +1039,8 @@ void phalcon_server_builtin_process_accept(struct phalcon_server_context *ctx, s
 
 		client_ctx->fd_added = 1;
 		ctx->wdata[cpu_id].acceptcnt++;
+
+		phalcon_server_timer_arm(ctx, client_ctx, PHALCON_SERVER_TIMER_HEADER);
 	}
 
 	goto back;
@@ -573,6 +1077,16 @@ void phalcon_server_do_stats(struct phalcon_server_context *ctx)
 		phalcon_server_exit_cleanup(ctx);
 	}
 
+	if(sigaddset(&siglist, SIGHUP) == -1) {
+		perror("Unable to add SIGHUP signal to stats signal list");
+		phalcon_server_exit_cleanup(ctx);
+	}
+
+	if(sigaddset(&siglist, SIGCHLD) == -1) {
+		perror("Unable to add SIGCHLD signal to stats signal list");
+		phalcon_server_exit_cleanup(ctx);
+	}
+
 	FILE *p = fdopen(ctx->pfd, "w");
 
 	while(1) {
@@ -600,6 +1114,12 @@ void phalcon_server_do_stats(struct phalcon_server_context *ctx)
 
 			fprintf(p, "\tRequest/s %8"PRIu64",%8"PRIu64"\n", acceptcnt, trancnt);
 
+			phalcon_server_respawn_workers(ctx);
+
+		} else if(signum == SIGHUP) {
+			phalcon_server_reload_workers(ctx);
+		} else if(signum == SIGCHLD) {
+			phalcon_server_reap_workers(ctx);
 		} else if(signum == SIGINT) {
 			phalcon_server_stop_workers(ctx);
 			break;
@@ -624,6 +1144,10 @@ void phalcon_server_stop_workers(struct phalcon_server_context *ctx)
 				phalcon_server_log_printf(ctx, "kill process %d\n", ctx->wdata[i].process);
 				kill(ctx->wdata[i].process, SIGTERM);
 			}
+			if (ctx->wdata[i].draining) {
+				phalcon_server_log_printf(ctx, "kill process %d\n", ctx->wdata[i].draining);
+				kill(ctx->wdata[i].draining, SIGTERM);
+			}
 		}
 	}
 }
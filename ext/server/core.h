@@ -48,6 +48,9 @@
 #include <netinet/ip.h>
 #include <arpa/inet.h>
 #include <sys/un.h>
+#include <sys/uio.h>
+#include <sys/stat.h>
+#include <sys/sendfile.h>
 #include <pthread.h>
 
 #if HAVE_EPOLL
@@ -60,10 +63,19 @@
 
 #define PHALCON_SERVER_MAX_CONNS_PER_WORKER		8192
 #define PHALCON_SERVER_MAX_BUFSIZE				2048
+#define PHALCON_SERVER_MAX_IOVECS				64
 
 #define PHALCON_SERVER_EVENTS_PER_BATCH			64
 #define PHALCON_SERVER_ACCEPT_PER_LISTEN_EVENT	1
 #define PHALCON_SERVER_MAX_WORKER_THREADS		4
+#define PHALCON_SERVER_DRAIN_TIMEOUT			30
+#define PHALCON_SERVER_RESPAWN_MIN_UPTIME		1
+#define PHALCON_SERVER_RESPAWN_MAX_DELAY		32
+
+#define PHALCON_SERVER_WHEEL_BITS				8
+#define PHALCON_SERVER_WHEEL_SIZE				(1 << PHALCON_SERVER_WHEEL_BITS)
+#define PHALCON_SERVER_WHEEL_MASK				(PHALCON_SERVER_WHEEL_SIZE - 1)
+#define PHALCON_SERVER_WHEEL_LEVELS				2
 
 typedef struct phalcon_server_conn_context phalcon_server_conn_context_t;
 typedef struct phalcon_server_context phalcon_server_context_t;
@@ -78,6 +90,38 @@ struct pahlcon_server_socket_address {
     socklen_t len;
 };
 
+/* Timer linked in a slot of the wheel, times are in seconds */
+struct phalcon_server_timer {
+	struct phalcon_server_timer *prev;
+	struct phalcon_server_timer *next;
+	uint64_t expires;
+	int kind;
+};
+
+enum {
+	PHALCON_SERVER_TIMER_NONE,
+	PHALCON_SERVER_TIMER_HEADER,
+	PHALCON_SERVER_TIMER_BODY,
+	PHALCON_SERVER_TIMER_KEEPALIVE
+};
+
+/* Hierarchical timer wheel, the first level has one slot per second and every slot of the
+ * next level covers a whole turn of the previous one */
+struct phalcon_server_timer_wheel {
+	uint64_t now;
+	struct phalcon_server_timer slots[PHALCON_SERVER_WHEEL_LEVELS][PHALCON_SERVER_WHEEL_SIZE];
+	pthread_mutex_t lock;
+};
+
+/* A piece of response waiting to be written, either a string or a file region */
+struct phalcon_server_output_chunk {
+	zend_string *str;
+	int fd;
+	off_t offset;
+	size_t length;
+	struct phalcon_server_output_chunk *next;
+};
+
 struct phalcon_server_conn_context {
 	int fd;
 	int fd_added;
@@ -90,7 +134,11 @@ struct phalcon_server_conn_context {
 	int next_idx;
 	char buf[PHALCON_SERVER_MAX_BUFSIZE];
 	void *user_data;
+	int keepalive;
 	zend_string *response;
+	struct phalcon_server_output_chunk *output_head;
+	struct phalcon_server_output_chunk *output_tail;
+	struct phalcon_server_timer timer;
 	phalcon_server_context_pool_t *pool;
 } *arr;
 
@@ -135,6 +183,11 @@ struct phalcon_server_worker_data {
 	uint64_t read_cnt;
 	uint64_t write_cnt;
 	int shutdown;
+	int generation;
+	pid_t draining;
+	time_t spawned;
+	time_t respawn_at;
+	int respawn_delay;
 #if PHALCON_USE_THREADPOOL
 	pthread_t main_thread;
 	pthread_t worker_threads[PHALCON_SERVER_MAX_WORKER_THREADS];
@@ -147,6 +200,11 @@ struct phalcon_server_context {
 	int num_workers;
 	int start_cpu;
 	int la_num;
+	int reuseport;
+	int header_timeout;
+	int body_timeout;
+	int keepalive_timeout;
+	struct phalcon_server_timer_wheel *wheel;
 	int pfd;
 	FILE *log_file;
 	zend_string *log_path;
@@ -167,12 +225,21 @@ void phalcon_server_init_workers(struct phalcon_server_context *ctx);
 void phalcon_server_do_stats(struct phalcon_server_context *ctx);
 void phalcon_server_exit_cleanup(struct phalcon_server_context *ctx);
 void phalcon_server_stop_workers(struct phalcon_server_context *ctx);
+void phalcon_server_reload_workers(struct phalcon_server_context *ctx);
 
 void phalcon_server_client_close(struct phalcon_server_conn_context *client_ctx);
 struct phalcon_server_conn_context *phalcon_server_alloc_context(struct phalcon_server_context_pool *pool);
 void phalcon_server_free_context(struct phalcon_server_conn_context *client_ctx);
 struct phalcon_server_conn_context *phalcon_server_get_context(struct phalcon_server_context_pool *pool, int fd);
 
+void phalcon_server_output_append_string(struct phalcon_server_conn_context *client_ctx, zend_string *str);
+void phalcon_server_output_append_file(struct phalcon_server_conn_context *client_ctx, int fd, off_t offset, size_t length);
+int phalcon_server_output_flush(struct phalcon_server_conn_context *client_ctx);
+void phalcon_server_output_free(struct phalcon_server_conn_context *client_ctx);
+
+void phalcon_server_timer_arm(struct phalcon_server_context *ctx, struct phalcon_server_conn_context *client_ctx, int kind);
+void phalcon_server_timer_disarm(struct phalcon_server_context *ctx, struct phalcon_server_conn_context *client_ctx);
+
 void phalcon_server_builtin_process_accept(struct phalcon_server_context *ctx, struct phalcon_server_conn_context * listen_ctx);
 
 static inline int phalcon_server_get_cpu_num(){
@@ -22,6 +22,7 @@
 #include "server/core.h"
 #include "server/exception.h"
 #include "server/utils.h"
+#include "http/response.h"
 
 #include "kernel/main.h"
 #include "kernel/memory.h"
@@ -48,10 +49,22 @@
  *		}
  *	}
  *
- *	$server = new Phalcon\Server\Http('127.0.0.1', 8989);
+ *	$server = new Phalcon\Server\Http(array('host' => '127.0.0.1', 'port' => 8989, 'keepalive' => true));
  *  $server->start($application);
  *
  *</code>
+ *
+ * Requests pipelined on a keep-alive connection are handled in order. With the 'stream' option
+ * the request body is passed to the application as a php://temp stream instead of a string.
+ *
+ * Every worker is a process pinned to a CPU, with the 'reuseport' option each one binds its own
+ * SO_REUSEPORT socket. The master restarts the workers that die, and on SIGHUP starts new
+ * workers while the old ones stop accepting and finish their connections. The new workers are
+ * forked from the running master, so a reload doesn't load changed code: restart the server.
+ *
+ * Idle connections are closed by the 'timeout' option, in seconds: 'header' to receive the
+ * request headers (10), 'body' between two reads of the body or two writes of the response (30)
+ * and 'keepalive' between two requests (5), 0 disables a timeout
  */
 zend_class_entry *phalcon_server_http_ce;
 
@@ -119,7 +132,7 @@ PHALCON_INIT_CLASS(Phalcon_Server_Http){
  */
 PHP_METHOD(Phalcon_Server_Http, __construct){
 
-	zval *config, verbose = {}, worker = {}, log_path = {}, host = {}, port = {};
+	zval *config, verbose = {}, worker = {}, log_path = {}, host = {}, port = {}, keepalive = {}, stream = {}, reuseport = {}, timeout = {}, value = {};
 	phalcon_server_http_object *intern;
 	int num_workers = 2;
 
@@ -133,6 +146,34 @@ PHP_METHOD(Phalcon_Server_Http, __construct){
 		intern->ctx.enable_verbose = zend_is_true(&verbose);
 	}
 
+	if (phalcon_array_isset_fetch_str(&keepalive, config, SL("keepalive"), PH_READONLY)) {
+		intern->enable_keepalive = zend_is_true(&keepalive);
+	}
+
+	if (phalcon_array_isset_fetch_str(&stream, config, SL("stream"), PH_READONLY)) {
+		intern->enable_stream = zend_is_true(&stream);
+	}
+
+	intern->ctx.header_timeout = 10;
+	intern->ctx.body_timeout = 30;
+	intern->ctx.keepalive_timeout = 5;
+
+	if (phalcon_array_isset_fetch_str(&timeout, config, SL("timeout"), PH_READONLY) && Z_TYPE(timeout) == IS_ARRAY) {
+		if (phalcon_array_isset_fetch_str(&value, &timeout, SL("header"), PH_READONLY)) {
+			intern->ctx.header_timeout = phalcon_get_intval(&value);
+		}
+		if (phalcon_array_isset_fetch_str(&value, &timeout, SL("body"), PH_READONLY)) {
+			intern->ctx.body_timeout = phalcon_get_intval(&value);
+		}
+		if (phalcon_array_isset_fetch_str(&value, &timeout, SL("keepalive"), PH_READONLY)) {
+			intern->ctx.keepalive_timeout = phalcon_get_intval(&value);
+		}
+	}
+
+	if (phalcon_array_isset_fetch_str(&reuseport, config, SL("reuseport"), PH_READONLY)) {
+		intern->ctx.reuseport = zend_is_true(&reuseport);
+	}
+
 	if (phalcon_array_isset_fetch_str(&worker, config, SL("worker"), PH_READONLY) && Z_TYPE(worker) == IS_LONG) {
 		num_workers = Z_LVAL(worker);
 	}
@@ -164,14 +205,33 @@ char *http_200="HTTP/1.0 200 OK\r\n"
 	"\r\n"
 	"<html><body><h1>200 OK</h1>\nEverything is fine.\n</body></html>\n";
 
+static char *http_400="HTTP/1.1 400 Bad Request\r\n"
+	"Connection: close\r\n"
+	"Content-Length: 0\r\n"
+	"\r\n";
+
+static void phalcon_server_http_free_client(struct phalcon_server_context *ctx, struct phalcon_server_conn_context *client_ctx)
+{
+	phalcon_server_timer_disarm(ctx, client_ctx);
+
+	if (client_ctx->user_data) {
+		phalcon_http_parser_data_free((phalcon_http_parser_data *)client_ctx->user_data);
+		client_ctx->user_data = NULL;
+	}
+
+	phalcon_server_output_free(client_ctx);
+
+	phalcon_server_client_close(client_ctx);
+	phalcon_server_free_context(client_ctx);
+}
+
 void phalcon_server_http_process_write(struct phalcon_server_context *ctx, struct phalcon_server_conn_context *client_ctx)
 {
 	int ep_fd, fd;
 	int events = client_ctx->events;
 	int cpu_id = client_ctx->cpu_id;
-	int old_len, ret;
+	int ret;
 	struct epoll_event evt;
-	phalcon_server_http_object *intern;
 
 	ep_fd = client_ctx->ep_fd;
 	fd = client_ctx->fd;
@@ -183,30 +243,28 @@ void phalcon_server_http_process_write(struct phalcon_server_context *ctx, struc
 		goto free_back;
 	}
 
-	old_len = ZSTR_LEN(client_ctx->response);
-	if (ZSTR_LEN(client_ctx->response)) {
-		ret = write(fd, ZSTR_VAL(client_ctx->response), old_len);
+	if (client_ctx->output_head) {
+		ret = phalcon_server_output_flush(client_ctx);
 		if (ret < 0) {
 			ctx->wdata[cpu_id].write_cnt++;
 			perror("process_write() can't write client socket");
 			goto free_back;
 		}
-		if (ret < old_len) {
-			zend_string *new_response = zend_string_alloc(old_len - ret, 0);
-			memcpy(ZSTR_VAL(new_response), ZSTR_VAL(client_ctx->response) + ret, old_len - ret);
-			zend_string_release(client_ctx->response);
-			client_ctx->response = new_response;
+		if (ret == 0) {
+			/**
+			 * The socket buffer is full, continue when it's writable again
+			 */
+			phalcon_server_timer_arm(ctx, client_ctx, PHALCON_SERVER_TIMER_BODY);
+
+			client_ctx->handler = ctx->write;
 			evt.events = EPOLLOUT | EPOLLHUP | EPOLLERR;
 			evt.data.ptr = client_ctx;
 			ret = epoll_ctl(ep_fd, EPOLL_CTL_MOD, fd, &evt);
 			if (ret < 0) {
-				perror("Unable to add client socket read event to epoll");
+				perror("Unable to add client socket write event to epoll");
 				goto free_back;
 			}
 			goto back;
-		} else {
-			zend_string_release(client_ctx->response);
-			client_ctx->response = NULL;
 		}
 	} else {
 		ret = write(fd, http_200, strlen(http_200));
@@ -215,16 +273,21 @@ void phalcon_server_http_process_write(struct phalcon_server_context *ctx, struc
 			perror("process_write() can't write client socket");
 			goto free_back;
 		}
+		client_ctx->keepalive = 0;
 	}
 
-	phalcon_server_log_printf(ctx, "Write %d to socket %d\n", ret, fd);
+	phalcon_server_log_printf(ctx, "Write completed to socket %d\n", fd);
 
 	ctx->wdata[cpu_id].trancnt++;
 
-	intern = phalcon_server_http_object_from_ctx(ctx);
-	if (!intern->enable_keepalive)
+	/**
+	 * The last request asked to close the connection, or keep-alive is disabled
+	 */
+	if (!client_ctx->keepalive)
 		goto free_back;
 
+	phalcon_server_timer_arm(ctx, client_ctx, client_ctx->user_data ? PHALCON_SERVER_TIMER_HEADER : PHALCON_SERVER_TIMER_KEEPALIVE);
+
 	client_ctx->handler = ctx->read;
 
 	evt.events = EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLET;
@@ -239,16 +302,233 @@ void phalcon_server_http_process_write(struct phalcon_server_context *ctx, struc
 	goto back;
 
 free_back:
-	// __sync_synchronize();
-	phalcon_server_client_close(client_ctx);
-	// __sync_synchronize();
-	phalcon_server_free_context(client_ctx);
+	phalcon_server_http_free_client(ctx, client_ctx);
 
 back:
 	return;
 }
 
-extern struct http_parser_settings http_parser_request_settings;
+/**
+ * Pauses the parser at the end of every message, so the requests pipelined in the same read
+ * are handed to the application one by one
+ */
+static int phalcon_server_http_on_message_complete(http_parser *p)
+{
+	phalcon_http_parser_on_message_complete(p);
+	http_parser_pause(p, 1);
+	return 0;
+}
+
+/**
+ * Writes the request body into a temporary stream, it stays in memory up to 2MB and
+ * then is moved to a temporary file
+ */
+static int phalcon_server_http_on_body_stream(http_parser *p, const char *at, size_t length)
+{
+	phalcon_http_parser_data *data = (phalcon_http_parser_data *)p->data;
+
+	data->state = HTTP_PARSER_STATE_BODY;
+	if (!data->body_stream) {
+		data->body_stream = php_stream_temp_new();
+		if (!data->body_stream) {
+			return 1;
+		}
+	}
+
+	if (php_stream_write(data->body_stream, at, length) != length) {
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * The parser hands the data of a chunked body to on_body already decoded, the chunk boundaries
+ * are not used: the chunk callbacks are left unset on purpose
+ */
+static struct http_parser_settings phalcon_server_http_request_settings = {
+	.on_message_begin = phalcon_http_parser_on_message_begin,
+	.on_url = phalcon_http_parser_on_url,
+	.on_status = phalcon_http_parser_on_status,
+	.on_header_field = phalcon_http_parser_on_header_field,
+	.on_header_value = phalcon_http_parser_on_header_value,
+	.on_headers_complete = phalcon_http_parser_on_headers_complete,
+	.on_body = phalcon_http_parser_on_body,
+	.on_message_complete = phalcon_server_http_on_message_complete,
+	.on_chunk_header = NULL,
+	.on_chunk_complete = NULL
+};
+
+static struct http_parser_settings phalcon_server_http_stream_settings = {
+	.on_message_begin = phalcon_http_parser_on_message_begin,
+	.on_url = phalcon_http_parser_on_url,
+	.on_status = phalcon_http_parser_on_status,
+	.on_header_field = phalcon_http_parser_on_header_field,
+	.on_header_value = phalcon_http_parser_on_header_value,
+	.on_headers_complete = phalcon_http_parser_on_headers_complete,
+	.on_body = phalcon_server_http_on_body_stream,
+	.on_message_complete = phalcon_server_http_on_message_complete,
+	.on_chunk_header = NULL,
+	.on_chunk_complete = NULL
+};
+
+/**
+ * Passes a complete request to the application and queues its response on the connection,
+ * the content is referenced and a file set with Phalcon\Http\Response::setFileToSend() is
+ * sent with sendfile()
+ */
+static void phalcon_server_http_handle_request(struct phalcon_server_context *ctx, struct phalcon_server_conn_context *client_ctx, phalcon_http_parser_data *parser_data)
+{
+	zval data = {}, url = {}, response = {}, header = {}, headers = {}, content = {}, file = {};
+	phalcon_server_http_object *intern;
+	zend_string *output;
+	size_t content_length = 0;
+	int flag = 0, keepalive, protocol_version, file_fd = -1;
+
+	intern = phalcon_server_http_object_from_ctx(ctx);
+
+	/**
+	 * The application may take longer than the client timeouts
+	 */
+	phalcon_server_timer_disarm(ctx, client_ctx);
+
+	keepalive = intern->enable_keepalive && http_should_keep_alive(parser_data->parser);
+	protocol_version = parser_data->parser->http_major * 100 + parser_data->parser->http_minor;
+
+	array_init(&data);
+
+	phalcon_array_update_str(&data, SL("header"), &parser_data->head, PH_COPY);
+
+	if (parser_data->url.s) {
+		ZVAL_STR(&url, parser_data->url.s);
+		phalcon_array_update_str(&data, SL("url"), &url, PH_COPY);
+	}
+
+	if (parser_data->body_stream) {
+		zval body = {};
+		php_stream_seek(parser_data->body_stream, 0, SEEK_SET);
+		php_stream_to_zval(parser_data->body_stream, &body);
+		parser_data->body_stream = NULL;
+		phalcon_array_update_str(&data, SL("body"), &body, 0);
+	} else if (parser_data->body.s) {
+		zval body = {};
+		ZVAL_STR(&body, parser_data->body.s);
+		phalcon_array_update_str(&data, SL("body"), &body, PH_COPY);
+	}
+
+	/**
+	 * Every request starts with an empty identity map, the models manager outlives the request
+	 */
+	PHALCON_GLOBAL(orm).identity_map_request++;
+
+	PHALCON_CALL_METHOD_FLAG(flag, &response, &intern->application, "handle", &data);
+	zval_ptr_dtor(&data);
+
+	if (flag != FAILURE && Z_TYPE(response) == IS_OBJECT) {
+		PHALCON_CALL_METHOD_FLAG(flag, &header, &response, "getheaders");
+		if (flag != FAILURE && Z_TYPE(header) == IS_OBJECT) {
+			PHALCON_CALL_METHOD_FLAG(flag, &headers, &header, "tostring");
+		}
+		zval_ptr_dtor(&header);
+
+		if (flag != FAILURE) {
+			PHALCON_CALL_METHOD_FLAG(flag, &content, &response, "getcontent");
+		}
+
+		if (flag != FAILURE && Z_TYPE(content) != IS_STRING && instanceof_function(Z_OBJCE(response), phalcon_http_response_ce)) {
+			phalcon_read_property(&file, &response, SL("_file"), PH_READONLY);
+			if (Z_TYPE(file) == IS_STRING && Z_STRLEN(file)) {
+				struct stat st;
+				file_fd = open(Z_STRVAL(file), O_RDONLY);
+				if (file_fd >= 0 && (fstat(file_fd, &st) < 0 || !S_ISREG(st.st_mode))) {
+					close(file_fd);
+					file_fd = -1;
+				}
+				if (file_fd >= 0) {
+					content_length = st.st_size;
+				}
+			}
+		}
+	}
+	zval_ptr_dtor(&response);
+
+	if (flag == FAILURE && EG(exception)) {
+		zval ex = {};
+		zval_ptr_dtor(&content);
+		ZVAL_UNDEF(&content);
+		ZVAL_OBJ(&ex, EG(exception));
+		phalcon_read_property(&content, &ex, SL("message"), PH_COPY);
+		zend_clear_exception();
+	}
+
+	if (Z_TYPE(content) == IS_STRING) {
+		content_length = Z_STRLEN(content);
+	}
+
+	output = phalcon_server_http_get_headers(Z_TYPE(headers) == IS_STRING && Z_STR(headers) ? Z_STRVAL(headers) : NULL, protocol_version, keepalive, content_length);
+	phalcon_server_output_append_string(client_ctx, output);
+	zend_string_release(output);
+
+	if (file_fd >= 0) {
+		phalcon_server_output_append_file(client_ctx, file_fd, 0, content_length);
+	} else if (Z_TYPE(content) == IS_STRING) {
+		phalcon_server_output_append_string(client_ctx, Z_STR(content));
+	}
+	zval_ptr_dtor(&headers);
+	zval_ptr_dtor(&content);
+
+	client_ctx->keepalive = keepalive;
+}
+
+/**
+ * Feeds the bytes read from a connection to its parser, every complete request is handled
+ * as soon as it's parsed, an incomplete one keeps its parser until the next read
+ */
+static int phalcon_server_http_parse(struct phalcon_server_context *ctx, struct phalcon_server_conn_context *client_ctx, const char *buf, size_t len)
+{
+	phalcon_server_http_object *intern;
+	phalcon_http_parser_data *parser_data;
+	size_t nparsed;
+
+	intern = phalcon_server_http_object_from_ctx(ctx);
+
+	while (len > 0) {
+		if (!client_ctx->user_data) {
+			client_ctx->user_data = phalcon_http_parser_data_new(intern->enable_stream ? &phalcon_server_http_stream_settings : &phalcon_server_http_request_settings, HTTP_REQUEST);
+		}
+		parser_data = (phalcon_http_parser_data *)client_ctx->user_data;
+
+		nparsed = http_parser_execute(parser_data->parser, parser_data->settings, buf, len);
+		buf += nparsed;
+		len -= nparsed;
+
+		phalcon_server_log_printf(ctx, "Parser state %d, parsed %zu from socket %d\n", parser_data->state, nparsed, client_ctx->fd);
+
+		if (HTTP_PARSER_ERRNO(parser_data->parser) == HPE_PAUSED) {
+			http_parser_pause(parser_data->parser, 0);
+
+			phalcon_server_http_handle_request(ctx, client_ctx, parser_data);
+			phalcon_http_parser_data_free(parser_data);
+			client_ctx->user_data = NULL;
+
+			/**
+			 * Requests after one that closes the connection are ignored
+			 */
+			if (!client_ctx->keepalive) {
+				return SUCCESS;
+			}
+			continue;
+		}
+
+		if (HTTP_PARSER_ERRNO(parser_data->parser) != HPE_OK) {
+			phalcon_server_log_printf(ctx, "Parser error %s on socket %d\n", http_errno_name(HTTP_PARSER_ERRNO(parser_data->parser)), client_ctx->fd);
+			return FAILURE;
+		}
+	}
+
+	return SUCCESS;
+}
+
 static void phalcon_server_http_process_read(struct phalcon_server_context *ctx, struct phalcon_server_conn_context *client_ctx)
 {
 	int ep_fd, fd;
@@ -273,115 +553,82 @@ static void phalcon_server_http_process_read(struct phalcon_server_context *ctx,
 
 	phalcon_server_log_printf(ctx, "Process read event[%02x] on socket %d\n", events, fd);
 
-    ret = read(fd, buf, PHALCON_SERVER_MAX_BUFSIZE);
-	client_ctx->data_len = ret;
-	if (ret < 0) {
-		ctx->wdata[cpu_id].read_cnt++;
-		perror("process_read() can't read client socket");
-		goto free_back;
-	} else if (ret == 0) {
-		phalcon_server_log_printf(ctx, "Socket %d is closed\n", fd);
-		goto free_back;
-	} else {
-		phalcon_http_parser_data *parser_data;
-		if (!client_ctx->user_data) {
-			client_ctx->user_data = phalcon_http_parser_data_new(&http_parser_request_settings, HTTP_REQUEST);
-		}
-		parser_data = (phalcon_http_parser_data *)client_ctx->user_data;
+	client_ctx->keepalive = 1;
 
-		http_parser_execute(parser_data->parser, parser_data->settings, buf, ret);
-
-		phalcon_server_log_printf(ctx, "Parser state %d, request from socket %d\n", parser_data->parser->state, fd);
-        if (parser_data->parser->state >= HTTP_PARSER_STATE_END || ret < PHALCON_SERVER_MAX_BUFSIZE) {
-			zval data, url = {}, response = {}, content = {};
-			phalcon_server_http_object *intern;
-			int flag = 0;
-
-			array_init(&data);
-
-			phalcon_array_update_str(&data, SL("header"), &parser_data->head, PH_COPY);
-
-			ZVAL_STR(&url, parser_data->url.s);
-			phalcon_array_update_str(&data, SL("url"), &url, PH_COPY);
-			if (parser_data->body.s) {
-				zval body = {};
-				ZVAL_STR(&body, parser_data->body.s);
-				phalcon_array_update_str(&data, SL("body"), &body, PH_COPY);
+	/**
+	 * The socket is edge triggered, so read until it's drained
+	 */
+	while (1) {
+		ret = read(fd, buf, PHALCON_SERVER_MAX_BUFSIZE);
+		client_ctx->data_len = ret;
+		if (ret < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				break;
 			}
-
-			intern = phalcon_server_http_object_from_ctx(ctx);
-			PHALCON_CALL_METHOD_FLAG(flag, &response, &intern->application, "handle", &data);
-			phalcon_http_parser_data_free(parser_data);
-			zval_ptr_dtor(&data);
-			client_ctx->user_data = NULL;
-			if (flag != FAILURE) {
-				zval header = {};
-				PHALCON_CALL_METHOD_FLAG(flag, &header, &response, "getheaders");
-				if (flag != FAILURE) {
-					zval ret = {};
-					PHALCON_CALL_METHOD_FLAG(flag, &ret, &header, "tostring");
-					if (flag != FAILURE) {
-						client_ctx->response = phalcon_server_http_get_headers(Z_STRVAL(ret));
-						zval_ptr_dtor(&ret);
-					} else {
-						client_ctx->response = phalcon_server_http_get_headers(NULL);
-					}
-					zval_ptr_dtor(&header);
-				} else {
-					client_ctx->response = phalcon_server_http_get_headers(NULL);
-				}
-			} else {
-				client_ctx->response = phalcon_server_http_get_headers(NULL);
+			if (errno == EINTR) {
+				continue;
 			}
-			if (flag == FAILURE) {
-				if (EG(exception)) {
-					zval ex, msg;
-					ZVAL_OBJ(&ex, EG(exception));
-					phalcon_read_property(&msg, &ex, SL("message"), PH_NOISY|PH_READONLY);
-					if (Z_TYPE(msg) == IS_STRING) {
-						PHALCON_SERVER_STRING_APPEND(client_ctx->response, Z_STR(msg));
-					}
-					zend_clear_exception();
-				}
-			} else {
-				PHALCON_CALL_METHOD_FLAG(flag, &content, &response, "getcontent");
-				if (Z_TYPE(content) == IS_STRING) {
-					PHALCON_SERVER_STRING_APPEND(client_ctx->response, Z_STR(content));
-				}
-				zval_ptr_dtor(&content);
-				zval_ptr_dtor(&response);
-			}
-			client_ctx->handler = ctx->write;
-			evt.events = EPOLLOUT | EPOLLHUP | EPOLLERR;
-			evt.data.ptr = client_ctx;
-			ret = epoll_ctl(ep_fd, EPOLL_CTL_MOD, fd, &evt);
-			if (ret < 0) {
-				perror("Unable to add client socket write event to epoll");
+			ctx->wdata[cpu_id].read_cnt++;
+			perror("process_read() can't read client socket");
+			goto free_back;
+		} else if (ret == 0) {
+			phalcon_server_log_printf(ctx, "Socket %d is closed\n", fd);
+			if (!client_ctx->output_head) {
 				goto free_back;
 			}
-			goto back;
-        }
+			client_ctx->keepalive = 0;
+			break;
+		}
 
 		phalcon_server_log_printf(ctx, "Read %d from socket %d\n", ret, fd);
-		client_ctx->handler = ctx->read;
-		evt.events = EPOLLIN | EPOLLERR | EPOLLET;
-		evt.data.ptr = client_ctx;
 
-		ret = epoll_ctl(ep_fd, EPOLL_CTL_MOD, fd, &evt);
-		if (ret < 0) {
-			perror("Unable to add client socket read event to epoll");
-			goto free_back;
+		if (phalcon_server_http_parse(ctx, client_ctx, buf, ret) == FAILURE) {
+			zend_string *bad_request = zend_string_init(http_400, strlen(http_400), 0);
+			phalcon_server_output_append_string(client_ctx, bad_request);
+			zend_string_release(bad_request);
+			client_ctx->keepalive = 0;
+			break;
 		}
+
+		if (!client_ctx->keepalive) {
+			break;
+		}
+	}
+
+	/**
+	 * Try to send the responses right away, the write handler waits for EPOLLOUT if the
+	 * socket can't take all of them
+	 */
+	if (client_ctx->output_head) {
+		client_ctx->events = 0;
+		ctx->write(ctx, client_ctx);
+		goto back;
+	}
+
+	/**
+	 * The headers must arrive within the header timeout, while the body only has to keep
+	 * coming within the body timeout
+	 */
+	if (client_ctx->user_data) {
+		phalcon_http_parser_data *parser_data = (phalcon_http_parser_data *)client_ctx->user_data;
+		phalcon_server_timer_arm(ctx, client_ctx, parser_data->state < HTTP_PARSER_STATE_HEADER_END ? PHALCON_SERVER_TIMER_HEADER : PHALCON_SERVER_TIMER_BODY);
+	}
+
+	client_ctx->handler = ctx->read;
+	evt.events = EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLET;
+	evt.data.ptr = client_ctx;
+
+	ret = epoll_ctl(ep_fd, EPOLL_CTL_MOD, fd, &evt);
+	if (ret < 0) {
+		perror("Unable to add client socket read event to epoll");
+		goto free_back;
 	}
 
 	goto back;
 
 free_back:
 	phalcon_server_log_printf(ctx, "cpu[%d] close socket %d\n", cpu_id, client_ctx->fd);
-	//__sync_synchronize();
-	phalcon_server_client_close(client_ctx);
-	//__sync_synchronize();
-	phalcon_server_free_context(client_ctx);
+	phalcon_server_http_free_client(ctx, client_ctx);
 
 back:
 	return;
@@ -28,6 +28,7 @@
 typedef struct _phalcon_server_http_object {
 	struct phalcon_server_context ctx;
 	int enable_keepalive;
+	int enable_stream;
 	zval application;
 	zend_object std;
 } phalcon_server_http_object;
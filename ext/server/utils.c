@@ -21,6 +21,7 @@
 #include "server/utils.h"
 
 #include <main/SAPI.h>
+#include <strings.h>
 #include <ext/date/php_date.h>
 
 typedef struct _http_response_status_code_pair {
@@ -127,7 +128,7 @@ static void append_http_status_line(smart_str *buffer, int protocol_version, int
 	smart_str_appendl_ex(buffer, "\r\n", 2, persistent);
 }
 
-static void append_essential_headers(smart_str* buffer)
+static void append_essential_headers(smart_str* buffer, int keepalive)
 {
 	struct timeval tv = {0};
 
@@ -139,15 +140,40 @@ static void append_essential_headers(smart_str* buffer)
 		zend_string_release(dt);
 	}
 
-	smart_str_appendl_ex(buffer, "Connection: close\r\n", sizeof("Connection: close\r\n") - 1, 0);
+	if (keepalive) {
+		smart_str_appendl_ex(buffer, "Connection: keep-alive\r\n", sizeof("Connection: keep-alive\r\n") - 1, 0);
+	} else {
+		smart_str_appendl_ex(buffer, "Connection: close\r\n", sizeof("Connection: close\r\n") - 1, 0);
+	}
 }
 
-zend_string *phalcon_server_http_get_headers(char* headers)
+static int has_header(const char *headers, size_t len, const char *name, size_t name_len)
+{
+	size_t i;
+
+	for (i = 0; i + name_len <= len; i++) {
+		if ((i == 0 || headers[i - 1] == '\n') && !strncasecmp(headers + i, name, name_len)) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Builds the status line and the headers of a response, the Content-Length header is added
+ * when the application did not send it so that the connection can be reused
+ */
+zend_string *phalcon_server_http_get_headers(char* headers, int protocol_version, int keepalive, size_t content_length)
 {
 	sapi_header_struct *h;
 	zend_llist_position pos;
 	smart_str buffer = {0};
-	int protocol_version = 100;
+	int has_content_length = 0;
+
+	if (protocol_version < 100) {
+		protocol_version = 100;
+	}
 
 	if (SG(sapi_headers).http_status_line) {
 		smart_str_appends(&buffer, SG(sapi_headers).http_status_line);
@@ -156,18 +182,29 @@ zend_string *phalcon_server_http_get_headers(char* headers)
 		append_http_status_line(&buffer, protocol_version, SG(sapi_headers).http_response_code, 0);
 	}
 
-	append_essential_headers(&buffer);
+	append_essential_headers(&buffer, keepalive);
 
 	h = (sapi_header_struct*)zend_llist_get_first_ex(&SG(sapi_headers).headers, &pos);
 	while (h) {
 		if (h->header_len) {
 			smart_str_appendl(&buffer, h->header, h->header_len);
 			smart_str_appendl(&buffer, "\r\n", 2);
+			if (!has_content_length) {
+				has_content_length = has_header(h->header, h->header_len, SL("Content-Length:"));
+			}
 		}
 		h = (sapi_header_struct*)zend_llist_get_next_ex(&SG(sapi_headers).headers, &pos);
 	}
 	if (headers) {
 		smart_str_appends(&buffer, headers);
+		if (!has_content_length) {
+			has_content_length = has_header(headers, strlen(headers), SL("Content-Length:"));
+		}
+	}
+	if (!has_content_length) {
+		smart_str_appendl(&buffer, "Content-Length: ", sizeof("Content-Length: ") - 1);
+		smart_str_append_unsigned(&buffer, content_length);
+		smart_str_appendl(&buffer, "\r\n", 2);
 	}
 	smart_str_appendl(&buffer, "\r\n", 2);
 	smart_str_0(&buffer);
@@ -29,6 +29,6 @@
 extern char *http_200;
 extern char *http_200_keepalive;
 
-zend_string *phalcon_server_http_get_headers(char *headers);
+zend_string *phalcon_server_http_get_headers(char *headers, int protocol_version, int keepalive, size_t content_length);
 
 #endif /* PHALCON_SERVER_UTILS_H */
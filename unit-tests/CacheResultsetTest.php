@@ -40,7 +40,7 @@ class CacheResultsetTest extends PHPUnit\Framework\TestCase
 		}
 	}
 
-	protected function _getCache($adapter='File')
+	protected function _getCache($adapter='File', $frontend='Data')
 	{
 		if (!file_exists('unit-tests/cache/')) {
 			mkdir("unit-tests/cache/", 0766);
@@ -66,7 +66,8 @@ class CacheResultsetTest extends PHPUnit\Framework\TestCase
 		$di->set('modelsQueryBuilder', 'Phalcon\Mvc\Model\Query\Builder');
 		$di->set('modelsCriteria', 'Phalcon\\Mvc\\Model\\Criteria');
 
-		$frontCache = new Phalcon\Cache\Frontend\Data(array(
+		$frontClass = 'Phalcon\\Cache\\Frontend\\'.$frontend;
+		$frontCache = new $frontClass(array(
 			'lifetime' => 3600
 		));
 
@@ -124,6 +125,38 @@ class CacheResultsetTest extends PHPUnit\Framework\TestCase
 
 	}
 
+	public function testMysqlCacheResultsetBinary()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configMysql)) {
+			$this->markTestSkipped('Test skipped');
+			return;
+		}
+
+		$cache = $this->_getCache('File', 'Binary');
+
+		$this->_di->set('db', function() use ($configMysql) {
+			return new Phalcon\Db\Adapter\Pdo\Mysql($configMysql);
+		}, true);
+
+		$cache->save('test-resultset', Robots::find(array('order' => 'id')));
+
+		$this->assertTrue(file_exists('unit-tests/cache/test-resultset'));
+
+		$robots = $cache->get('test-resultset');
+
+		$this->assertEquals(get_class($robots), 'Phalcon\Mvc\Model\Resultset\Simple');
+		$this->assertEquals(count($robots), 3);
+		$this->assertEquals($robots->count(), 3);
+		$this->assertEquals($robots->getFirst()->id, 1);
+
+		$cache->save('test-resultset', Robots::findFirst(2));
+
+		$robot = $cache->get('test-resultset');
+		$this->assertEquals(get_class($robot), 'Robots');
+		$this->assertEquals($robot->id, 2);
+	}
+
 	public function testPostgresqlCacheResultsetNormal()
 	{
 		require 'unit-tests/config.db.php';
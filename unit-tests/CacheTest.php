@@ -270,6 +270,144 @@ class CacheTest extends PHPUnit\Framework\TestCase
 		$this->assertEquals(3, $cache->get('foo'));
 	}
 
+	public function testMemoryCacheMultiple()
+	{
+		$frontCache = new Phalcon\Cache\Frontend\Data(array(
+			'lifetime' => 10
+		));
+
+		$cache = new Phalcon\Cache\Backend\Memory($frontCache, array('prefix' => 'unit'));
+
+		$this->assertTrue($cache->saveMultiple(array('foo' => 'bar', 'num' => 5, 'data' => array(1, 2, 3))));
+
+		$this->assertEquals($cache->get('foo'), 'bar');
+		$this->assertEquals($cache->getMultiple(array('foo', 'num', 'data', 'missing'), false), array(
+			'foo' => 'bar',
+			'num' => 5,
+			'data' => array(1, 2, 3),
+			'missing' => false,
+		));
+
+		$this->assertTrue($cache->deleteMultiple(array('foo', 'data')));
+		$this->assertEquals($cache->getMultiple(array('foo', 'num', 'data')), array(
+			'foo' => null,
+			'num' => 5,
+			'data' => null,
+		));
+	}
+
+	public function testMemoryCacheGetOrCompute()
+	{
+		$frontCache = new Phalcon\Cache\Frontend\Data(array('lifetime' => 10));
+		$cache = new Phalcon\Cache\Backend\Memory($frontCache);
+
+		$computed = 0;
+		$computer = function ($key) use (&$computed) {
+			$computed++;
+			return 'value-' . $key;
+		};
+
+		$this->assertEquals($cache->getOrCompute('foo', $computer, 10, array('beta' => 0)), 'value-foo');
+		$this->assertEquals($cache->getOrCompute('foo', $computer, 10, array('beta' => 0)), 'value-foo');
+		$this->assertEquals($computed, 1);
+		$this->assertFalse($cache->exists('foo:lock'));
+
+		// Another worker is refreshing an expired entry, the stale content is served
+		$cache->save('bar', array('old', 0.0, microtime(true) - 1), 60);
+		$cache->save('bar:lock', 1, 10);
+		$this->assertEquals($cache->getOrCompute('bar', $computer, 10, array('stale' => 30)), 'old');
+		$this->assertEquals($computed, 1);
+
+		// Without a stale window the worker gives up waiting and computes it
+		$this->assertEquals($cache->getOrCompute('bar', $computer, 10, array('wait' => 0)), 'value-bar');
+		$this->assertEquals($computed, 2);
+
+		$this->assertEquals($cache->getComputeStats(), array(
+			'misses' => 1,
+			'computes' => 2,
+			'hits' => 1,
+			'staleServes' => 1,
+			'lockTimeouts' => 1,
+		));
+
+		// The lock expired while computing and another worker took it, it is not released
+		$computer = function ($key) use ($cache) {
+			$cache->delete($key . ':lock');
+			$cache->save($key . ':lock', 'other-worker', 10);
+			return 'value-' . $key;
+		};
+
+		$this->assertEquals($cache->getOrCompute('baz', $computer, 10), 'value-baz');
+		$this->assertEquals($cache->get('baz:lock'), 'other-worker');
+	}
+
+	public function testMemoryCacheTags()
+	{
+		$frontCache = new Phalcon\Cache\Frontend\Data(array('lifetime' => 10));
+		$cache = new Phalcon\Cache\Backend\Memory($frontCache);
+
+		$this->assertTrue($cache->saveTagged('robot-1', array('name' => 'Astro Boy'), array('robots', 'user-1')));
+		$this->assertTrue($cache->saveTagged('robot-2', 'Terminator', array('robots')));
+		$this->assertTrue($cache->saveTagged('user-1', 'Phalcon', array('user-1')));
+
+		$this->assertEquals($cache->getTagged('robot-1'), array('name' => 'Astro Boy'));
+		$this->assertEquals($cache->getTagged('robot-2'), 'Terminator');
+
+		$this->assertTrue($cache->invalidateTags(array('robots')));
+		$this->assertNull($cache->getTagged('robot-1'));
+		$this->assertFalse($cache->getTagged('robot-2', false));
+		$this->assertEquals($cache->getTagged('user-1'), 'Phalcon');
+
+		// Stored again after the invalidation it takes the new version
+		$cache->saveTagged('robot-2', 'T-1000', array('robots'));
+		$this->assertEquals($cache->getTagged('robot-2'), 'T-1000');
+
+		$cache->invalidateTags(array('user-1'));
+		$this->assertNull($cache->getTagged('user-1'));
+		$this->assertEquals($cache->getTagged('robot-2'), 'T-1000');
+	}
+
+	public function testDataFileCacheMultiple()
+	{
+		$frontCache = new Phalcon\Cache\Frontend\Data(array('lifetime' => 10));
+
+		$cache = new Phalcon\Cache\Backend\File($frontCache, array(
+			'cacheDir' => 'unit-tests/cache/',
+		));
+
+		$this->assertTrue($cache->saveMultiple(array('test-multi-a' => 'a', 'test-multi-b' => array('b'))));
+		$this->assertEquals($cache->getMultiple(array('test-multi-a', 'test-multi-b', 'test-multi-c')), array(
+			'test-multi-a' => 'a',
+			'test-multi-b' => array('b'),
+			'test-multi-c' => null,
+		));
+
+		$this->assertTrue($cache->deleteMultiple(array('test-multi-a', 'test-multi-b')));
+		$this->assertFalse($cache->exists('test-multi-a'));
+	}
+
+	public function testMultipleCacheGetMultiple()
+	{
+		$frontCache = new Phalcon\Cache\Frontend\Data(array('lifetime' => 10));
+
+		$fast = new Phalcon\Cache\Backend\Memory($frontCache);
+		$slow = new Phalcon\Cache\Backend\Memory($frontCache);
+
+		$fast->save('foo', 'fast');
+		$slow->saveMultiple(array('foo' => 'slow', 'bar' => 'slow'));
+
+		$cache = new Phalcon\Cache\Multiple(array($fast, $slow));
+
+		$this->assertEquals($cache->getMultiple(array('foo', 'bar', 'baz'), 'none'), array(
+			'foo' => 'fast',
+			'bar' => 'slow',
+			'baz' => 'none',
+		));
+
+		$cache->deleteMultiple(array('foo', 'bar'));
+		$this->assertEquals($cache->getMultiple(array('foo', 'bar')), array('foo' => null, 'bar' => null));
+	}
+
 	private function _prepareIgbinary()
 	{
 
@@ -342,6 +480,111 @@ class CacheTest extends PHPUnit\Framework\TestCase
 
 	}
 
+	public function testBinaryFileCache()
+	{
+		$frontCache = new Phalcon\Cache\Frontend\Binary(array('lifetime' => 600));
+
+		$cache = new Phalcon\Cache\Backend\File($frontCache, array(
+			'cacheDir' => 'unit-tests/cache/',
+ 			'prefix' => 'unit'
+		));
+
+		$object = new stdClass;
+		$object->name = 'Astro Boy';
+		$object->tags = array('robot', 'mechanical');
+
+		$rows = array();
+		for ($i = 0; $i < 50; $i++) {
+			$rows[] = array('id' => $i, 'name' => 'Robot '.$i, 'type' => 'mechanical', 'year' => 1950 + $i, 'price' => $i * 1.5);
+		}
+
+		$data = array(
+			'null'     => null,
+			'array'    => array(1, 2, 3, 4 => 5),
+			'string',
+			123.45,
+			-6,
+			PHP_INT_MAX,
+			-PHP_INT_MAX - 1,
+			true,
+			false,
+			null,
+			0,
+			"",
+			str_repeat('long value ', 100),
+			'object'   => $object,
+			'iterator' => new ArrayObject(array(1, 2, 3)),
+			'rows'     => $rows
+		);
+
+		$cache->save('test-data', $data);
+		$this->assertEquals($cache->get('test-data'), $data);
+
+		$cache->save('test-data', "sure, nothing interesting");
+		$this->assertEquals($cache->get('test-data'), "sure, nothing interesting");
+
+		// Repeated keys and values are only written once
+		$this->assertLessThan(strlen(serialize($rows)) / 2, strlen($frontCache->beforeStore($rows)));
+		$this->assertLessThan(strlen(json_encode($rows)), strlen($frontCache->beforeStore($rows)));
+
+		$this->assertFalse(@$frontCache->afterRetrieve(substr($frontCache->beforeStore($rows), 0, -1)));
+		$this->assertFalse(@$frontCache->afterRetrieve(serialize($rows)));
+
+		$this->assertTrue($cache->delete('test-data'));
+
+		// Properties looking like a list are still restored as properties
+		$object = new stdClass;
+		$object->{'0'} = 'zero';
+		$object->{'1'} = 'one';
+
+		$restored = $frontCache->afterRetrieve($frontCache->beforeStore($object));
+		$this->assertInstanceOf('stdClass', $restored);
+		$this->assertEquals($restored, $object);
+		$this->assertEquals($restored->{'1'}, 'one');
+
+		// No back-references, the same object is restored as two copies
+		$restored = $frontCache->afterRetrieve($frontCache->beforeStore(array($object, $object)));
+		$this->assertEquals($restored[0], $restored[1]);
+		$this->assertNotSame($restored[0], $restored[1]);
+	}
+
+	public function testBinaryAgainstIgbinary()
+	{
+		if (!extension_loaded('igbinary')) {
+			$this->markTestSkipped('Warning: igbinary extension is not loaded');
+			return;
+		}
+
+		$frontCache = new Phalcon\Cache\Frontend\Binary(array('lifetime' => 600));
+
+		$rows = array();
+		for ($i = 0; $i < 1000; $i++) {
+			$rows[] = array('id' => $i, 'name' => 'Robot '.$i, 'type' => 'mechanical', 'year' => 1950 + $i % 50, 'price' => $i * 1.5);
+		}
+
+		$binary = $frontCache->beforeStore($rows);
+		$igbinary = igbinary_serialize($rows);
+
+		$this->assertEquals($frontCache->afterRetrieve($binary), igbinary_unserialize($igbinary));
+		// Both deduplicate the keys, the sizes have to stay close
+		$this->assertLessThan(strlen($igbinary) * 1.25, strlen($binary));
+
+		$start = microtime(true);
+		for ($i = 0; $i < 100; $i++) {
+			$frontCache->afterRetrieve($frontCache->beforeStore($rows));
+		}
+		$elapsedBinary = microtime(true) - $start;
+
+		$start = microtime(true);
+		for ($i = 0; $i < 100; $i++) {
+			igbinary_unserialize(igbinary_serialize($rows));
+		}
+		$elapsedIgbinary = microtime(true) - $start;
+
+		// Loose bound, only a regression by an order of magnitude has to fail
+		$this->assertLessThan($elapsedIgbinary * 5, $elapsedBinary);
+	}
+
 	protected function _prepareApc()
 	{
 
@@ -1303,6 +1546,72 @@ class CacheTest extends PHPUnit\Framework\TestCase
 		$this->assertEquals(87, $cache->decrement('decrement', 10));
 	}
 
+	public function testYacCounters()
+	{
+		if (!class_exists('Phalcon\Cache\Yac')) {
+			$this->markTestSkipped('Class `Phalcon\Cache\Yac` is not exists');
+			return false;
+		}
+		if (!ini_get('phalcon.cache.enable_yac_cli')) {
+			$this->markTestSkipped('Warning: phalcon.cache.enable_yac_cli is not enbale');
+			return false;
+		}
+
+		$yac = new Phalcon\Cache\Yac('unit');
+
+		$yac->delete('counter');
+		$this->assertEquals(1, $yac->increment('counter'));
+		$this->assertEquals(6, $yac->increment('counter', 5));
+		$this->assertEquals(4, $yac->decrement('counter', 2));
+		$this->assertEquals(4, $yac->get('counter'));
+
+		$this->assertFalse($yac->cas('counter', 5, 10));
+		$this->assertTrue($yac->cas('counter', 4, 10));
+		$this->assertEquals(10, $yac->get('counter'));
+
+		// A plain integer is turned into a counter holding it
+		$yac->set('counter', 7);
+		$this->assertEquals(8, $yac->increment('counter'));
+		$this->assertEquals(10, $yac->increment('counter', 2));
+		$this->assertEquals(10, $yac->get('counter'));
+
+		// Workers converting the same integer at once don't lose increments
+		if (function_exists('pcntl_fork')) {
+			$yac->set('counter', 100);
+
+			$children = array();
+			for ($i = 0; $i < 4; $i++) {
+				$pid = pcntl_fork();
+				if ($pid === 0) {
+					for ($j = 0; $j < 250; $j++) {
+						$yac->increment('counter');
+					}
+					exit(0);
+				}
+				$children[] = $pid;
+			}
+			foreach ($children as $pid) {
+				pcntl_waitpid($pid, $status);
+			}
+
+			$this->assertEquals(1100, $yac->get('counter'));
+		}
+
+		$yac->set('counter', 'string');
+		$this->assertFalse($yac->increment('counter'));
+		$this->assertFalse($yac->cas('counter', 10, 11));
+		$this->assertTrue($yac->delete('counter'));
+
+		$key = str_repeat('long-key-', 20);
+		$this->assertTrue($yac->set($key, 'long-val'));
+		$this->assertEquals('long-val', $yac->get($key));
+		$this->assertFalse($yac->get(substr($key, 0, -1) . 'x'));
+		$this->assertEquals(1, $yac->increment($key . 'hits'));
+		$this->assertEquals(2, $yac->increment($key . 'hits'));
+		$yac->delete(array($key, $key . 'hits'));
+		$this->assertFalse($yac->get($key));
+	}
+
 	public function testDataYacCache()
 	{
 		if (!class_exists('Phalcon\Cache\Yac')) {
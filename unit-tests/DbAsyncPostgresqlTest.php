@@ -0,0 +1,108 @@
+<?php
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2012 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+
+class DbAsyncPostgresqlTest extends PHPUnit\Framework\TestCase
+{
+
+	public function testQueries()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configPostgresql) || !class_exists('Phalcon\Db\Async\Postgresql') || !function_exists('pg_connect_poll')) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$connection = new Phalcon\Db\Async\Postgresql($configPostgresql);
+
+		$rows = $connection->query('SELECT id, name FROM robots WHERE id <= $1 ORDER BY id', array(2));
+		$this->assertCount(2, $rows);
+		$this->assertEquals($rows[0]['id'], 1);
+
+		$row = $connection->fetchOne('SELECT COUNT(*) AS total FROM robots');
+		$this->assertTrue($row['total'] > 0);
+		$this->assertFalse($connection->fetchOne('SELECT id FROM robots WHERE id < 0'));
+
+		$this->assertTrue($connection->begin());
+		$this->assertTrue($connection->isUnderTransaction());
+		$this->assertTrue($connection->execute('UPDATE robots SET name = name WHERE id <= $1', array(2)));
+		$this->assertEquals($connection->affectedRows(), 2);
+		$this->assertTrue($connection->rollback());
+		$this->assertFalse($connection->isUnderTransaction());
+
+		$this->assertEquals($connection->escapeString("Astro'Boy"), "'Astro''Boy'");
+
+		try {
+			$connection->query('SELECT * FROM no_such_table');
+			$this->assertTrue(false);
+		} catch (Phalcon\Db\Exception $e) {
+			$this->assertTrue(true);
+		}
+
+		$this->assertEquals($connection->fetchOne('SELECT 1 AS one'), array('one' => 1));
+		$this->assertTrue($connection->close());
+	}
+
+	public function testConcurrentQueries()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configPostgresql) || !class_exists('Phalcon\Db\Async\Postgresql') || !function_exists('pg_connect_poll')) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$start = microtime(true);
+
+		$tasks = array();
+		for ($i = 0; $i < 4; $i++) {
+			$tasks[] = Phalcon\Async\Task::async(function() use ($configPostgresql, $i) {
+				$connection = new Phalcon\Db\Async\Postgresql($configPostgresql);
+				return $connection->fetchOne('SELECT pg_sleep(0.3), $1::int AS n', array($i));
+			});
+		}
+
+		$numbers = array();
+		foreach ($tasks as $task) {
+			$row = Phalcon\Async\Task::await($task);
+			$numbers[] = (int) $row['n'];
+		}
+
+		$this->assertEquals($numbers, array(0, 1, 2, 3));
+		$this->assertTrue(microtime(true) - $start < 1.0);
+
+		$connection = new Phalcon\Db\Async\Postgresql($configPostgresql);
+		$connection->connect();
+
+		$first = Phalcon\Async\Task::async(function() use ($connection) {
+			return $connection->fetchOne('SELECT pg_sleep(0.1)');
+		});
+		$second = Phalcon\Async\Task::async(function() use ($connection) {
+			try {
+				$connection->fetchOne('SELECT 1');
+				return false;
+			} catch (Phalcon\Db\Exception $e) {
+				return true;
+			}
+		});
+
+		Phalcon\Async\Task::await($first);
+		$this->assertTrue(Phalcon\Async\Task::await($second));
+	}
+
+}
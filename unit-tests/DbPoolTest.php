@@ -0,0 +1,204 @@
+<?php
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2012 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+
+class DbPoolTest extends PHPUnit\Framework\TestCase
+{
+
+	public function setUp()
+	{
+		spl_autoload_register(array($this, 'modelsAutoloader'));
+	}
+
+	public function tearDown()
+	{
+		spl_autoload_unregister(array($this, 'modelsAutoloader'));
+	}
+
+	public function modelsAutoloader($className)
+	{
+		if (file_exists('unit-tests/models/'.$className.'.php')) {
+			require 'unit-tests/models/'.$className.'.php';
+		}
+	}
+
+	public function testPoolSqlite()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configSqlite)) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$pool = new Phalcon\Db\Pool(array(
+			'adapter' => 'Phalcon\Db\Adapter\Pdo\Sqlite',
+			'descriptor' => $configSqlite,
+			'max' => 2,
+			'timeout' => 0
+		));
+
+		$connection = $pool->get();
+		$this->assertInstanceOf('Phalcon\Db\Adapter\Pdo\Sqlite', $connection);
+		$this->assertSame($pool->get(), $connection);
+
+		$other = $pool->checkout();
+		$this->assertNotSame($other, $connection);
+		$this->assertEquals($pool->getStatus(), array('idle' => 0, 'busy' => 2, 'bound' => 1, 'max' => 2));
+
+		try {
+			$pool->checkout();
+			$this->assertTrue(false);
+		} catch (Phalcon\Db\Exception $e) {
+			$this->assertEquals($e->getMessage(), 'The pool is exhausted, its 2 connections are in use');
+		}
+
+		$pool->release($other);
+		$this->assertEquals($pool->getStatus(), array('idle' => 1, 'busy' => 1, 'bound' => 1, 'max' => 2));
+		$this->assertSame($pool->checkout(), $other);
+
+		$other->begin();
+		$pool->release($other);
+		$this->assertFalse($other->isUnderTransaction());
+
+		try {
+			$pool->release($other);
+			$this->assertTrue(false);
+		} catch (Phalcon\Db\Exception $e) {
+			$this->assertTrue(true);
+		}
+
+		$pool->release();
+		$this->assertEquals($pool->getStatus(), array('idle' => 2, 'busy' => 0, 'bound' => 0, 'max' => 2));
+		$this->assertEquals($pool->evict(), 0);
+
+		$pool->close();
+		$this->assertEquals($pool->getStatus(), array('idle' => 0, 'busy' => 0, 'bound' => 0, 'max' => 2));
+
+		$pool = new Phalcon\Db\Pool(array(
+			'adapter' => 'Phalcon\Db\Adapter\Pdo\Sqlite',
+			'descriptor' => $configSqlite,
+			'idleTimeout' => 0
+		));
+
+		$pool->release($pool->checkout());
+		usleep(1000);
+		$this->assertEquals($pool->evict(), 1);
+
+		if (!class_exists('Phalcon\Async\Task')) {
+			return;
+		}
+
+		// A task waiting for a connection gets the one given back
+		$pool = new Phalcon\Db\Pool(array(
+			'adapter' => 'Phalcon\Db\Adapter\Pdo\Sqlite',
+			'descriptor' => $configSqlite,
+			'max' => 1,
+			'timeout' => 5
+		));
+
+		$connection = $pool->checkout();
+		$task = Phalcon\Async\Task::async(function() use ($pool) {
+			return $pool->checkout();
+		});
+
+		$timer = new Phalcon\Async\Timer(10);
+		$timer->awaitTimeout();
+
+		$start = microtime(true);
+		$pool->release($connection);
+		$this->assertSame(Phalcon\Async\Task::await($task), $connection);
+		$this->assertLessThan(1, microtime(true) - $start);
+	}
+
+	public function testPoolModelsSqlite()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configSqlite)) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		Phalcon\Di::reset();
+
+		$di = new Phalcon\Di();
+
+		$di->set('modelsManager', function(){
+			return new Phalcon\Mvc\Model\Manager();
+		}, true);
+
+		$di->set('modelsMetadata', function(){
+			return new Phalcon\Mvc\Model\Metadata\Memory();
+		}, true);
+
+		$di->set('modelsQuery', 'Phalcon\Mvc\Model\Query');
+		$di->set('modelsQueryBuilder', 'Phalcon\Mvc\Model\Query\Builder');
+		$di->set('modelsCriteria', 'Phalcon\\Mvc\\Model\\Criteria');
+
+		$di->set('connection', function() use ($configSqlite) {
+			return new Phalcon\Db\Adapter\Pdo\Sqlite($configSqlite);
+		});
+
+		$di->set('db', function() {
+			return new Phalcon\Db\Pool(array('service' => 'connection'));
+		}, true);
+
+		$this->assertInstanceOf('Robots', Robots::findFirst());
+
+		$pool = $di->getShared('db');
+		$this->assertEquals($pool->getStatus(), array('idle' => 0, 'busy' => 1, 'bound' => 1, 'max' => 10));
+
+		// A shared service is built again for every connection of the pool
+		$di->set('sharedConnection', function() use ($configSqlite) {
+			return new Phalcon\Db\Adapter\Pdo\Sqlite($configSqlite);
+		}, true);
+
+		$sharedPool = new Phalcon\Db\Pool(array('service' => 'sharedConnection'));
+		$first = $sharedPool->checkout();
+		$second = $sharedPool->checkout();
+		$this->assertNotSame($first, $second);
+		$sharedPool->close();
+
+		if (!class_exists('Phalcon\Async\Task')) {
+			return;
+		}
+
+		$main = $pool->get();
+		$tasks = array();
+		for ($i = 0; $i < 3; $i++) {
+			$tasks[] = Phalcon\Async\Task::async(function() use ($pool) {
+				$robot = Robots::findFirst();
+				$timer = new Phalcon\Async\Timer(5);
+				$timer->awaitTimeout();
+				return spl_object_hash($pool->get());
+			});
+		}
+
+		$hashes = array();
+		foreach ($tasks as $task) {
+			$hashes[] = Phalcon\Async\Task::await($task);
+		}
+
+		$this->assertCount(3, array_unique($hashes));
+		$this->assertFalse(in_array(spl_object_hash($main), $hashes));
+
+		$pool->evict();
+		$this->assertEquals($pool->getStatus(), array('idle' => 3, 'busy' => 1, 'bound' => 1, 'max' => 10));
+	}
+
+}
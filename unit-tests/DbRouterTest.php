@@ -0,0 +1,218 @@
+<?php
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2012 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+
+class DbRouterTest extends PHPUnit\Framework\TestCase
+{
+
+	public function setUp()
+	{
+		spl_autoload_register(array($this, 'modelsAutoloader'));
+	}
+
+	public function tearDown()
+	{
+		spl_autoload_unregister(array($this, 'modelsAutoloader'));
+	}
+
+	public function modelsAutoloader($className)
+	{
+		if (file_exists('unit-tests/models/'.$className.'.php')) {
+			require 'unit-tests/models/'.$className.'.php';
+		}
+	}
+
+	protected function _getDI($configSqlite, $replicas, $options = array())
+	{
+
+		Phalcon\Di::reset();
+
+		$di = new Phalcon\Di();
+
+		$di->set('modelsManager', function(){
+			return new Phalcon\Mvc\Model\Manager();
+		}, true);
+
+		$di->set('modelsMetadata', function(){
+			return new Phalcon\Mvc\Model\Metadata\Memory();
+		}, true);
+
+		$di->set('modelsQuery', 'Phalcon\Mvc\Model\Query');
+		$di->set('modelsQueryBuilder', 'Phalcon\Mvc\Model\Query\Builder');
+		$di->set('modelsCriteria', 'Phalcon\\Mvc\\Model\\Criteria');
+
+		$di->set('dbPrimary', function() use ($configSqlite) {
+			return new Phalcon\Db\Adapter\Pdo\Sqlite($configSqlite);
+		}, true);
+
+		$di->set('dbReplica1', function() use ($configSqlite) {
+			return new Phalcon\Db\Adapter\Pdo\Sqlite($configSqlite);
+		}, true);
+
+		$di->set('dbReplica2', function() use ($configSqlite) {
+			return new Phalcon\Db\Adapter\Pdo\Sqlite($configSqlite);
+		}, true);
+
+		$di->set('dbBroken', function() {
+			return new Phalcon\Db\Adapter\Pdo\Sqlite(array('dbname' => '/non-existent/path/phalcon_test.sqlite'));
+		}, true);
+
+		$di->set('db', function() use ($replicas, $options) {
+			return new Phalcon\Db\Router(array_merge(array(
+				'primary' => 'dbPrimary',
+				'replicas' => $replicas
+			), $options));
+		}, true);
+
+		return $di;
+	}
+
+	public function testRouterSqlite()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configSqlite)) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$this->_executeRoundRobin($configSqlite);
+		$this->_executeStickiness($configSqlite);
+		$this->_executeEjection($configSqlite);
+		$this->_executeModels($configSqlite);
+	}
+
+	protected function _executeRoundRobin($configSqlite)
+	{
+		$di = $this->_getDI($configSqlite, array(
+			'dbReplica1' => array('weight' => 2),
+			'dbReplica2'
+		));
+
+		$router = $di->getShared('db');
+
+		$served = array();
+		for ($i = 0; $i < 6; $i++) {
+			$connection = $router->getReadConnection();
+			$this->assertInstanceOf('Phalcon\Db\Adapter\Pdo\Sqlite', $connection);
+			$served[] = $router->getLastReplica();
+		}
+
+		$this->assertEquals($served, array('dbReplica1', 'dbReplica2', 'dbReplica1', 'dbReplica1', 'dbReplica2', 'dbReplica1'));
+		$this->assertSame($router->getReadConnection(), $di->getShared('dbReplica1'));
+
+		$status = $router->getStatus();
+		$this->assertEquals($status['dbReplica1']['weight'], 2);
+		$this->assertTrue($status['dbReplica1']['healthy']);
+		$this->assertTrue($status['dbReplica1']['connected']);
+		$this->assertTrue(is_float($status['dbReplica1']['latency']));
+	}
+
+	protected function _executeStickiness($configSqlite)
+	{
+		$di = $this->_getDI($configSqlite, array('dbReplica1', 'dbReplica2'), array('stickiness' => 60));
+
+		$router = $di->getShared('db');
+
+		$router->getReadConnection();
+		$this->assertEquals($router->getLastReplica(), 'dbReplica1');
+
+		$primary = $router->getWriteConnection();
+		$this->assertSame($primary, $di->getShared('dbPrimary'));
+
+		// Nothing was written yet
+		$this->assertSame($router->getReadConnection(), $di->getShared('dbReplica2'));
+
+		$this->assertTrue($primary->execute("UPDATE robots SET name = name WHERE id = 0"));
+		$this->assertSame($router->getReadConnection(), $primary);
+		$this->assertNull($router->getLastReplica());
+
+		$di = $this->_getDI($configSqlite, array('dbReplica1'), array('stickiness' => 60));
+
+		$router = $di->getShared('db');
+		$router->markWrite();
+		$this->assertSame($router->getReadConnection(), $di->getShared('dbPrimary'));
+
+		$di = $this->_getDI($configSqlite, array('dbReplica1'), array('stickiness' => 0));
+
+		$router = $di->getShared('db');
+
+		$primary = $router->getWriteConnection();
+		$this->assertSame($router->getReadConnection(), $di->getShared('dbReplica1'));
+
+		$primary->begin();
+		$this->assertSame($router->getReadConnection(), $primary);
+		$primary->rollback();
+	}
+
+	protected function _executeEjection($configSqlite)
+	{
+		$di = $this->_getDI($configSqlite, array(
+			'dbBroken' => array('weight' => 10),
+			'dbReplica1'
+		), array('backoff' => 30));
+
+		$router = $di->getShared('db');
+
+		$this->assertSame($router->getReadConnection(), $di->getShared('dbReplica1'));
+		$this->assertEquals($router->getLastReplica(), 'dbReplica1');
+
+		$status = $router->getStatus();
+		$this->assertFalse($status['dbBroken']['healthy']);
+		$this->assertEquals($status['dbBroken']['failures'], 1);
+		$this->assertTrue($status['dbBroken']['ejectedFor'] > 25);
+
+		$router->getReadConnection();
+		$this->assertEquals($router->getLastReplica(), 'dbReplica1');
+
+		$this->assertEquals($router->check(), array('dbBroken' => false, 'dbReplica1' => true));
+
+		$router->eject('dbReplica1');
+
+		$this->assertSame($router->getReadConnection(), $di->getShared('dbPrimary'));
+		$this->assertNull($router->getLastReplica());
+
+		$router->restore('dbReplica1');
+		$router->getReadConnection();
+		$this->assertEquals($router->getLastReplica(), 'dbReplica1');
+	}
+
+	protected function _executeModels($configSqlite)
+	{
+		$di = $this->_getDI($configSqlite, array('dbReplica1'), array('stickiness' => 60));
+
+		$router = $di->getShared('db');
+
+		$robot = Robots::findFirst();
+		$this->assertInstanceOf('Robots', $robot);
+		$this->assertEquals($router->getLastReplica(), 'dbReplica1');
+
+		$transaction = new Phalcon\Mvc\Model\Transaction($di);
+		$this->assertSame($transaction->getConnection(), $di->getShared('dbPrimary'));
+
+		// Asking for the primary doesn't move the reads to it
+		$this->assertTrue(Robots::count() > 0);
+		$this->assertEquals($router->getLastReplica(), 'dbReplica1');
+
+		$transaction->getConnection()->begin();
+		$this->assertTrue(Robots::count() > 0);
+		$this->assertNull($router->getLastReplica());
+		$transaction->getConnection()->rollback();
+	}
+
+}
@@ -110,6 +110,105 @@ class DbTest extends PHPUnit\Framework\TestCase
 
 	}
 
+	/**
+	 * @medium
+	 */
+	public function testDbStatementCache()
+	{
+		require 'unit-tests/config.db.php';
+
+		if (empty($configMysql)) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$connection = new Phalcon\Db\Adapter\Pdo\Mysql(array_merge($configMysql, array('statementCacheSize' => 2)));
+
+		$result = $connection->query("SELECT * FROM personas WHERE estado = ? LIMIT 1", array('A'));
+		$first = $result->fetch();
+
+		// The statement is still held by the first result
+		$result2 = $connection->query("SELECT * FROM personas WHERE estado = ? LIMIT 1", array('A'));
+		$this->assertEquals($result2->fetch(), $first);
+		unset($result, $result2);
+
+		$result = $connection->query("SELECT * FROM personas WHERE estado = ? LIMIT 1", array('A'));
+		$this->assertEquals($result->fetch(), $first);
+		unset($result);
+
+		$stats = $connection->getStatementCacheStats();
+		$this->assertEquals($stats['hits'], 1);
+		$this->assertEquals($stats['misses'], 2);
+		$this->assertEquals($stats['entries'], 1);
+
+		$connection->query("SELECT 1");
+		$connection->query("SELECT 2");
+
+		$stats = $connection->getStatementCacheStats();
+		$this->assertEquals($stats['entries'], 2);
+
+		// Changing the schema through query() discards the cached statements too
+		$connection->execute("CREATE TEMPORARY TABLE statement_cache (a INT)");
+		$connection->execute("INSERT INTO statement_cache VALUES (1)");
+		$this->assertEquals($connection->query("SELECT * FROM statement_cache")->fetch(PDO::FETCH_ASSOC), array('a' => 1));
+
+		$connection->query("ALTER TABLE statement_cache ADD b INT DEFAULT 2");
+
+		$stats = $connection->getStatementCacheStats();
+		$this->assertEquals($stats['entries'], 0);
+
+		$this->assertEquals($connection->query("SELECT * FROM statement_cache")->fetch(PDO::FETCH_ASSOC), array('a' => 1, 'b' => 2));
+
+		$stats = $connection->getStatementCacheStats();
+		$this->assertEquals($stats['entries'], 1);
+
+		$connection->close();
+
+		$stats = $connection->getStatementCacheStats();
+		$this->assertEquals($stats['entries'], 0);
+	}
+
+	/**
+	 * @medium
+	 */
+	public function testDbInsertMultiple()
+	{
+		require 'unit-tests/config.db.php';
+
+		if (empty($configMysql)) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$connection = new Phalcon\Db\Adapter\Pdo\Mysql($configMysql);
+		$connection->delete("personas", "cedula LIKE 'MULTI%'");
+
+		$rows = array();
+		for ($i = 0; $i < 5; $i++) {
+			$rows[] = array('MULTI' . $i, 1, 'MULTIPLE', 100, 'X');
+		}
+
+		$columns = array('cedula', 'tipo_documento_id', 'nombres', 'cupo', 'estado');
+		$this->assertEquals($connection->insertMultiple('personas', $rows, $columns, array('chunkSize' => 2)), 5);
+
+		$row = $connection->fetchOne("SELECT COUNT(*) AS rowcount FROM personas WHERE cedula LIKE 'MULTI%'");
+		$this->assertEquals($row['rowcount'], 5);
+
+		$rows = array(
+			array('cedula' => 'MULTI0', 'tipo_documento_id' => 1, 'nombres' => 'UPSERTED', 'cupo' => 100, 'estado' => 'X'),
+			array('cedula' => 'MULTI9', 'tipo_documento_id' => 1, 'nombres' => 'UPSERTED', 'cupo' => 100, 'estado' => 'X'),
+		);
+		$connection->insertMultiple('personas', $rows, null, array('conflict' => array('cedula'), 'update' => array('nombres')));
+
+		$row = $connection->fetchOne("SELECT COUNT(*) AS rowcount FROM personas WHERE cedula LIKE 'MULTI%' AND nombres = 'UPSERTED'");
+		$this->assertEquals($row['rowcount'], 2);
+
+		$row = $connection->fetchOne("SELECT COUNT(*) AS rowcount FROM personas WHERE cedula LIKE 'MULTI%'");
+		$this->assertEquals($row['rowcount'], 6);
+
+		$connection->delete("personas", "cedula LIKE 'MULTI%'");
+	}
+
 	protected function _executeTests($connection)
 	{
 
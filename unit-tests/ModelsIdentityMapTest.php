@@ -0,0 +1,163 @@
+<?php
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2012 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+
+class ModelsIdentityMapTest extends PHPUnit\Framework\TestCase
+{
+
+	public function setUp()
+	{
+		spl_autoload_register(array($this, 'modelsAutoloader'));
+		Phalcon\Mvc\Model::setup(array('identityMap' => true));
+	}
+
+	public function tearDown()
+	{
+		Phalcon\Mvc\Model::setup(array('identityMap' => false));
+		spl_autoload_unregister(array($this, 'modelsAutoloader'));
+	}
+
+	public function modelsAutoloader($className)
+	{
+		if (file_exists('unit-tests/models/'.$className.'.php')) {
+			require 'unit-tests/models/'.$className.'.php';
+		}
+	}
+
+	protected function _getDI()
+	{
+
+		Phalcon\Di::reset();
+
+		$di = new Phalcon\Di();
+
+		$di->set('modelsManager', function(){
+			return new Phalcon\Mvc\Model\Manager();
+		}, true);
+
+		$di->set('modelsMetadata', function(){
+			return new Phalcon\Mvc\Model\Metadata\Memory();
+		}, true);
+
+		$di->set('modelsQuery', 'Phalcon\Mvc\Model\Query');
+		$di->set('modelsQueryBuilder', 'Phalcon\Mvc\Model\Query\Builder');
+		$di->set('modelsCriteria', 'Phalcon\\Mvc\\Model\\Criteria');
+
+		$di->set('transactionManager', function(){
+			return new Phalcon\Mvc\Model\Transaction\Manager();
+		}, true);
+
+		return $di;
+	}
+
+	public function testModelsMysql()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configMysql)) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$di = $this->_getDI();
+
+		$di->set('db', function(){
+			require 'unit-tests/config.db.php';
+			return new Phalcon\Db\Adapter\Pdo\Mysql($configMysql);
+		}, true);
+
+		$this->_executeTests($di);
+	}
+
+	public function testModelsSqlite()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configSqlite)) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$di = $this->_getDI();
+
+		$di->set('db', function(){
+			require 'unit-tests/config.db.php';
+			return new Phalcon\Db\Adapter\Pdo\Sqlite($configSqlite);
+		}, true);
+
+		$this->_executeTests($di);
+	}
+
+	protected function _executeTests($di)
+	{
+		$manager = $di->getShared('modelsManager');
+
+		$robot = Robots::findFirst(1);
+		$this->assertEquals($robot->id, 1);
+
+		$this->assertSame($manager->getIdentity('Robots', 1), $robot);
+		$this->assertSame($manager->getIdentity('Robots', '1'), $robot);
+		$this->assertSame($manager->getIdentity('Robots', array(1)), $robot);
+		$this->assertNull($manager->getIdentity('Robots', 0));
+
+		// Records are kept apart by the connection service they were read from
+		$this->assertSame($manager->getIdentity('Robots', 1, 'db'), $robot);
+		$this->assertNull($manager->getIdentity('Robots', 1, 'dbShard'));
+
+		$this->assertSame(Robots::findFirst(1), $robot);
+		$this->assertSame(Robots::findFirst('id = 1'), $robot);
+		$this->assertSame(Robots::find(array('order' => 'id'))->getFirst(), $robot);
+
+		$robotPart = RobotsParts::findFirst('robots_id = 1');
+		$this->assertSame($robotPart->getRobots(), $robot);
+
+		$manager->removeIdentity($robot);
+		$this->assertNull($manager->getIdentity('Robots', 1));
+
+		$other = Robots::findFirst(1);
+		$this->assertNotSame($other, $robot);
+		$this->assertSame($manager->getIdentity('Robots', 1), $other);
+
+		$manager->addIdentity($robot);
+		$this->assertSame(Robots::findFirst(1), $robot);
+
+		$manager->clearIdentityMap('RobotsParts');
+		$this->assertSame($manager->getIdentity('Robots', 1), $robot);
+
+		$manager->clearIdentityMap('Robots');
+		$this->assertNull($manager->getIdentity('Robots', 1));
+
+		$robot = Robots::findFirst(1);
+		$this->assertSame($manager->getIdentity('Robots', 1), $robot);
+
+		$transaction = $di->getShared('transactionManager')->get();
+		try {
+			$transaction->rollback();
+			$this->assertTrue(false);
+		} catch (Phalcon\Mvc\Model\Transaction\Failed $e) {
+			$this->assertNull($manager->getIdentity('Robots', 1));
+		}
+
+		// The adapter knows nothing about the models, only the ORM rollbacks clear the identity map
+		$robot = Robots::findFirst(1);
+		$this->assertSame($manager->getIdentity('Robots', 1), $robot);
+
+		$di->getShared('db')->begin();
+		$di->getShared('db')->rollback();
+		$this->assertSame($manager->getIdentity('Robots', 1), $robot);
+	}
+}
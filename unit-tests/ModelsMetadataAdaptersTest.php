@@ -469,4 +469,58 @@ class ModelsMetadataAdaptersTest extends PHPUnit\Framework\TestCase
 
 		Robots::findFirst();
 	}
+
+	public function testMetadataShm()
+	{
+		if (!class_exists('Phalcon\Mvc\Model\Metadata\Shm')) {
+			$this->markTestSkipped('Class `Phalcon\Mvc\Model\Metadata\Shm` is not exists');
+			return;
+		}
+
+		require 'unit-tests/config.db.php';
+		if (empty($configMysql)) {
+			$this->markTestSkipped('Test skipped');
+			return;
+		}
+
+		$di = $this->_getDI();
+
+		$di->set('modelsMetadata', function(){
+			return new Phalcon\Mvc\Model\Metadata\Shm(array(
+				'prefix' => 'my-local-app'
+			));
+		});
+
+		$metaData = $di->getShared('modelsMetadata');
+
+		$metaData->reset();
+		$version = $metaData->getVersion();
+
+		$this->assertTrue($metaData->isEmpty());
+
+		Robots::findFirst();
+
+		$this->assertEquals($metaData->read('meta-robots-robots'), $this->_data['meta-robots-robots']);
+		$this->assertEquals($metaData->read('map-robots-robots'), $this->_data['map-robots-robots']);
+
+		$this->assertFalse($metaData->isEmpty());
+
+		//A new instance reads the indexes from the shared memory
+		$shared = new Phalcon\Mvc\Model\Metadata\Shm(array(
+			'prefix' => 'my-local-app'
+		));
+		$this->assertEquals($shared->getVersion(), $version);
+		$this->assertEquals($shared->getAttributes(new Robots()), $this->_data['meta-robots-robots'][0]);
+		$this->assertEquals($shared->getDataTypes(new Robots()), $this->_data['meta-robots-robots'][4]);
+		$this->assertEquals($shared->getIdentityField(new Robots()), 'id');
+		$this->assertEquals($shared->getColumnMap(new Robots()), $this->_data['map-robots-robots'][0]);
+		$this->assertTrue($shared->isEmpty());
+
+		$metaData->reset();
+		$this->assertTrue($metaData->isEmpty());
+		$this->assertEquals($metaData->getVersion(), $version + 1);
+		$this->assertNull($metaData->read('meta-robots-robots'));
+
+		Robots::findFirst();
+	}
 }
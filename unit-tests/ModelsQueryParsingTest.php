@@ -8128,4 +8128,37 @@ class ModelsQueryParsingTest extends PHPUnit\Framework\TestCase
 		$this->assertEquals($query->parse(), $expected);
 	}
 
+	public function testStatementCache()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configPostgresql)) {
+			$this->markTestSkipped('Test skipped');
+			return;
+		}
+
+		$di = $this->_getDI();
+
+		ini_set('phalcon.orm.enable_statement_cache', 1);
+		Query::clearCache();
+
+		$stats = Query::getCacheStats();
+
+		$query = new Query('SELECT r.id, r.name FROM Robots r WHERE r.id > :id:int:');
+		$query->setDI($di);
+		$intermediate = $query->parse();
+		$models = $query->getModels();
+
+		$query = new Query('SELECT r.id, r.name FROM Robots r WHERE r.id > :id:int:');
+		$query->setDI($di);
+		$this->assertEquals($query->parse(), $intermediate);
+		$this->assertEquals($query->getBindTypes(), array('id' => Phalcon\Db\Column::BIND_PARAM_INT));
+		$this->assertEquals($query->getModels(), $models);
+
+		$current = Query::getCacheStats();
+		$this->assertEquals($current['hits'], $stats['hits'] + 1);
+		$this->assertEquals($current['misses'], $stats['misses'] + 1);
+
+		ini_set('phalcon.orm.enable_statement_cache', 0);
+	}
+
 }
@@ -80,6 +80,7 @@ class ModelsRelationsTest extends PHPUnit\Framework\TestCase
 		$this->_executeTestsRenamed($di);
 		$this->_testIssue938($di);
 		$this->_testIssue2244($di);
+		$this->_testEagerLoading($di);
 	}
 
 	public function testModelsPostgresql()
@@ -120,6 +121,7 @@ class ModelsRelationsTest extends PHPUnit\Framework\TestCase
 		$this->_executeTestsNormal($di);
 		$this->_executeTestsRenamed($di);
 		$this->_testIssue938($di);
+		$this->_testEagerLoading($di);
 	}
 
 	public function _executeTestsNormal($di)
@@ -385,4 +387,62 @@ class ModelsRelationsTest extends PHPUnit\Framework\TestCase
 		$this->assertEquals(get_class($robotsParts), 'Phalcon\Mvc\Model\Resultset\Simple');
 		$this->assertEquals(count($robotsParts), 3);
 	}
+
+	protected function _testEagerLoading($di)
+	{
+		$robots = RelationsRobots::find(array(
+			'order' => 'id',
+			'with' => array('relationsRobotsParts.relationsParts', 'relationsParts')
+		));
+		$this->assertTrue(count($robots) > 0);
+
+		foreach ($robots as $robot) {
+			$robotsParts = $robot->relationsRobotsParts;
+			$this->assertEquals(get_class($robotsParts), 'Phalcon\Mvc\Model\Resultset\Simple');
+			$this->assertEquals(count($robotsParts), $robot->countRelationsRobotsParts());
+
+			foreach ($robotsParts as $robotPart) {
+				$this->assertEquals($robotPart->robots_id, $robot->id);
+				$this->assertEquals(get_class($robotPart->relationsParts), 'RelationsParts');
+				$this->assertEquals($robotPart->relationsParts->id, $robotPart->parts_id);
+			}
+
+			$parts = $robot->relationsParts;
+			$this->assertEquals(get_class($parts), 'Phalcon\Mvc\Model\Resultset\Simple');
+			$this->assertEquals(count($parts), count($robot->getRelationsParts()));
+		}
+
+		$robot = RelationsRobots::query()->orderBy('id')->with('relationsRobotsParts')->execute()->getFirst();
+		$this->assertEquals(count($robot->relationsRobotsParts), 3);
+
+		$robotsParts = $di->getShared('modelsManager')->createBuilder()
+			->from('RelationsRobotsParts')
+			->with(array('relationsRobots' => 'relationsRobotsParts'))
+			->getQuery()
+			->execute();
+		foreach ($robotsParts as $robotPart) {
+			$this->assertEquals($robotPart->relationsRobots->id, $robotPart->robots_id);
+			$this->assertEquals(count($robotPart->relationsRobots->relationsRobotsParts), $robotPart->relationsRobots->countRelationsRobotsParts());
+		}
+
+		// More values than a statement accepts are sent in chunks, missing parents are kept as null
+		$parts = array();
+		for ($i = 1; $i <= 1200; $i++) {
+			$part = new RelationsRobotsParts();
+			$part->robots_id = $i;
+			$part->parts_id = 1;
+			$parts[] = $part;
+		}
+		$di->getShared('modelsManager')->eagerLoad($parts, 'relationsRobots');
+		$this->assertEquals(get_class($parts[0]->relationsRobots), 'RelationsRobots');
+		$this->assertEquals($parts[0]->relationsRobots->id, 1);
+		$this->assertNull($parts[1199]->relationsRobots);
+
+		try {
+			RelationsRobots::find(array('with' => 'unknownRelation'));
+			$this->assertTrue(false);
+		} catch (Phalcon\Mvc\Model\Exception $e) {
+			$this->assertEquals($e->getMessage(), 'There is no defined relations for the model "RelationsRobots" using alias "unknownrelation"');
+		}
+	}
 }
@@ -548,6 +548,62 @@ class ModelsResultsetTest extends PHPUnit\Framework\TestCase
 		$this->assertFalse(isset($robots[0]));
 	}
 
+	public function testResultsetStreamMysql()
+	{
+		if (!$this->_prepareTestMysql()) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$robots = Robots::find(array(
+			'order' => 'id',
+			'stream' => true
+		));
+
+		$this->assertEquals($robots->getType(), Phalcon\Mvc\Model\Resultset::TYPE_RESULT_STREAM);
+
+		$number = 0;
+		foreach ($robots as $key => $robot) {
+			$this->assertEquals($key, $number);
+			$this->assertEquals($robot->id, $number + 1);
+			$this->assertTrue($robots->valid());
+			$number++;
+		}
+		$this->assertEquals($number, 3);
+		$this->assertFalse($robots->current());
+
+		try {
+			$robots->rewind();
+			$this->assertFalse(true);
+		}
+		catch(Exception $e){
+			$this->assertEquals($e->getMessage(), 'Streaming resultsets are forward-only and cannot be rewound');
+		}
+
+		try {
+			count($robots);
+			$this->assertFalse(true);
+		}
+		catch(Exception $e){
+			$this->assertEquals($e->getMessage(), 'Streaming resultsets cannot be counted');
+		}
+
+		//The connection is free to run other queries once the rows were read
+		$this->assertEquals(count(Robots::find()), 3);
+
+		$robots = Robots::find(array(
+			'order' => 'id',
+			'stream' => true
+		));
+
+		$robots->seek(2);
+		$this->assertTrue($robots->valid());
+		$this->assertEquals($robots->current()->id, 3);
+
+		$robots->next();
+		$this->assertFalse($robots->valid());
+	}
+
 	public function testResultsetCloneResultMap()
 	{
 		if (!$this->_prepareTestMysql()) {
@@ -558,4 +614,36 @@ class ModelsResultsetTest extends PHPUnit\Framework\TestCase
 		$robots = Resultset\Robots::find(array('limit' => 1));
 		$this->assertEquals(get_class($robots[0]), 'ArrayObject');
 	}
+
+	public function testResultsetHydrateAllMysql()
+	{
+		if (!$this->_prepareTestMysql()) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$rows = Phalcon\Di::getDefault()->getShared('db')->fetchAll('SELECT * FROM robots ORDER BY id', Phalcon\Db::FETCH_ASSOC);
+
+		$robots = Robots::hydrateAll($rows);
+		$this->assertEquals(count($robots), 3);
+		foreach ($robots as $number => $robot) {
+			$this->assertInstanceOf('Robots', $robot);
+			$this->assertEquals($robot->id, $number + 1);
+			$this->assertEquals($robot->getDirtyState(), Phalcon\Mvc\Model::DIRTY_STATE_PERSISTENT);
+			$this->assertEquals($robot->getSnapshotData(), $rows[$number]);
+			$this->assertEquals($robot->getUniqueParams(), array('pha_id' => $number + 1));
+		}
+
+		$robots = Robots::find(array('order' => 'id'));
+		$this->assertEquals($robots[2]->name, $rows[2]['name']);
+		$this->assertEquals($robots[2]->getUniqueKey(), 'id= :pha_id:');
+
+		try {
+			Robots::hydrateAll(array('unknown'));
+			$this->assertFalse(true);
+		}
+		catch(Exception $e){
+			$this->assertEquals($e->getMessage(), 'Every row to hydrate must be an array');
+		}
+	}
 }
\ No newline at end of file
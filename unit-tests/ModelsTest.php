@@ -94,6 +94,7 @@ class ModelsTest extends PHPUnit\Framework\TestCase
 		$this->_executeTestsNormal($di);
 		$this->_executeTestsRenamed($di);
 		$this->_executeTestRawValue($di);
+		$this->_executeTestsBatch($di);
 
 		$this->issue1534($di);
 		$this->issue886($di);
@@ -140,6 +141,63 @@ class ModelsTest extends PHPUnit\Framework\TestCase
 		$this->issue886($di);
 	}
 
+	protected function _executeTestsBatch($di)
+	{
+		$cedula = 'CELL' . mt_rand(0, 99999);
+
+		$personas = Personas::batchCreate(array(
+			array('cedula' => $cedula . 'A', 'tipo_documento_id' => 1, 'nombres' => 'BATCH', 'telefono' => '1', 'cupo' => 100, 'estado' => 'X'),
+			array('cedula' => $cedula . 'B', 'tipo_documento_id' => 1, 'nombres' => 'BATCH', 'telefono' => '1', 'cupo' => 100, 'estado' => 'X'),
+		));
+		$this->assertEquals(count($personas), 2);
+		$this->assertEquals(Personas::count("nombres = 'BATCH'"), 2);
+
+		$personas[0]->nombres = 'BATCH UPSERT';
+		$personas = Personas::batchSave(array(
+			$personas[0],
+			array('cedula' => $cedula . 'C', 'tipo_documento_id' => 1, 'nombres' => 'BATCH', 'telefono' => '1', 'cupo' => 100, 'estado' => 'X'),
+		));
+		$this->assertEquals(count($personas), 2);
+		$this->assertEquals(Personas::count("nombres = 'BATCH UPSERT'"), 1);
+		$this->assertEquals(Personas::count("nombres LIKE 'BATCH%'"), 3);
+
+		// Arrays carrying the key of an existing row are updates
+		$personas = Personas::batchSave(array(
+			array('cedula' => $cedula . 'A', 'tipo_documento_id' => 1, 'nombres' => 'BATCH ARRAY', 'telefono' => '1', 'cupo' => 100, 'estado' => 'X'),
+			array('cedula' => $cedula . 'D', 'tipo_documento_id' => 1, 'nombres' => 'BATCH', 'telefono' => '1', 'cupo' => 100, 'estado' => 'X'),
+		));
+		$this->assertEquals($personas[0]->getOperationMade(), Phalcon\Mvc\Model::OP_UPDATE);
+		$this->assertEquals($personas[1]->getOperationMade(), Phalcon\Mvc\Model::OP_CREATE);
+		$this->assertEquals(Personas::count("nombres = 'BATCH ARRAY'"), 1);
+
+		// The records are written through one connection
+		$persona = new Personas();
+		$persona->setTransaction($di->get('db'));
+		try {
+			Personas::batchCreate(array(
+				array('cedula' => $cedula . 'E', 'tipo_documento_id' => 1, 'nombres' => 'BATCH', 'telefono' => '1', 'cupo' => 100, 'estado' => 'X'),
+				$persona,
+			));
+			$this->assertTrue(false);
+		} catch (Phalcon\Mvc\Model\Exception $e) {
+			$this->assertEquals($e->getMessage(), 'All the records of the batch must belong to the same transaction');
+		}
+
+		$di->get('db')->delete("personas", "nombres LIKE 'BATCH%'");
+
+		// Natural keys are known after the insert, generated identities aren't read back
+		$this->assertEquals($personas[1]->getDirtyState(), Phalcon\Mvc\Model::DIRTY_STATE_PERSISTENT);
+
+		$robots = Robots::batchCreate(array(
+			array('name' => 'Batch Robot', 'type' => 'mechanical', 'year' => 2000),
+		));
+		$this->assertEquals(count($robots), 1);
+		$this->assertNull($robots[0]->id);
+		$this->assertEquals($robots[0]->getDirtyState(), Phalcon\Mvc\Model::DIRTY_STATE_TRANSIENT);
+
+		$di->get('db')->delete("robots", "name = 'Batch Robot'");
+	}
+
 	protected function issue1534($di)
 	{
 		$db = $di->getShared('db');
@@ -0,0 +1,254 @@
+<?php
+
+/*
+  +------------------------------------------------------------------------+
+  | Phalcon Framework                                                      |
+  +------------------------------------------------------------------------+
+  | Copyright (c) 2011-2012 Phalcon Team (http://www.phalconphp.com)       |
+  +------------------------------------------------------------------------+
+  | This source file is subject to the New BSD License that is bundled     |
+  | with this package in the file docs/LICENSE.txt.                        |
+  |                                                                        |
+  | If you did not receive a copy of the license and are unable to         |
+  | obtain it through the world-wide-web, please send an email             |
+  | to license@phalconphp.com so we can send you a copy immediately.       |
+  +------------------------------------------------------------------------+
+  | Authors: Andres Gutierrez <andres@phalconphp.com>                      |
+  |          Eduar Carvajal <eduar@phalconphp.com>                         |
+  +------------------------------------------------------------------------+
+*/
+
+class ModelsUnitOfWorkTest extends PHPUnit\Framework\TestCase
+{
+
+	public function setUp()
+	{
+		spl_autoload_register(array($this, 'modelsAutoloader'));
+	}
+
+	public function tearDown()
+	{
+		spl_autoload_unregister(array($this, 'modelsAutoloader'));
+	}
+
+	public function modelsAutoloader($className)
+	{
+		if (file_exists('unit-tests/models/'.$className.'.php')) {
+			require 'unit-tests/models/'.$className.'.php';
+		}
+	}
+
+	protected function _getDI()
+	{
+
+		Phalcon\Di::reset();
+
+		$di = new Phalcon\Di();
+
+		$di->set('modelsManager', function(){
+			return new Phalcon\Mvc\Model\Manager();
+		}, true);
+
+		$di->set('modelsMetadata', function(){
+			return new Phalcon\Mvc\Model\Metadata\Memory();
+		}, true);
+
+		$di->set('modelsQuery', 'Phalcon\Mvc\Model\Query');
+		$di->set('modelsQueryBuilder', 'Phalcon\Mvc\Model\Query\Builder');
+		$di->set('modelsCriteria', 'Phalcon\\Mvc\\Model\\Criteria');
+
+		return $di;
+	}
+
+	public function testModelsMysql()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configMysql)) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$di = $this->_getDI();
+
+		$di->set('db', function(){
+			require 'unit-tests/config.db.php';
+			return new Phalcon\Db\Adapter\Pdo\Mysql($configMysql);
+		}, true);
+
+		$this->_executeTests($di);
+	}
+
+	public function testModelsSqlite()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configSqlite)) {
+			$this->markTestSkipped("Skipped");
+			return;
+		}
+
+		$di = $this->_getDI();
+
+		$di->set('db', function(){
+			require 'unit-tests/config.db.php';
+			return new Phalcon\Db\Adapter\Pdo\Sqlite($configSqlite);
+		}, true);
+
+		$this->_executeTests($di);
+	}
+
+	protected function _executeTests($di)
+	{
+		$manager = $di->getShared('modelsManager');
+
+		$tracer = array();
+
+		$eventsManager = new Phalcon\Events\Manager();
+		$eventsManager->attach('db', function($event, $connection) use (&$tracer) {
+			if ($event->getType() == 'beforeQuery') {
+				$tracer[] = $connection->getSqlStatement();
+			}
+		});
+
+		$connection = $di->getShared('db');
+		$connection->setEventsManager($eventsManager);
+
+		$this->assertFalse($manager->isInUnitOfWork());
+		$this->assertSame($manager->beginUnitOfWork(), $manager);
+		$this->assertTrue($manager->isInUnitOfWork());
+
+		$robots = array();
+		foreach (Robots::find(array('order' => 'id')) as $robot) {
+			$robots[$robot->id] = $robot->year;
+			$robot->year = $robot->year + 100;
+			$this->assertTrue($robot->save());
+		}
+		$this->assertEquals(count($robots), 3);
+
+		// Nothing is written before the flush
+		foreach ($robots as $id => $year) {
+			$this->assertEquals(Robots::findFirst($id)->year, $year);
+		}
+
+		$tracer = array();
+		$this->assertTrue($manager->flush());
+		$this->assertFalse($manager->isInUnitOfWork());
+
+		// The three updates share one statement
+		$updates = preg_grep('/^UPDATE /', $tracer);
+		$this->assertEquals(count($updates), 1);
+
+		foreach ($robots as $id => $year) {
+			$this->assertEquals(Robots::findFirst($id)->year, $year + 100);
+		}
+
+		// Discarded writes
+		$manager->beginUnitOfWork();
+		$robot = Robots::findFirst(1);
+		$robot->year = 1;
+		$this->assertTrue($robot->save());
+		$manager->clearUnitOfWork();
+		$this->assertFalse($manager->isInUnitOfWork());
+		$this->assertTrue($manager->flush());
+		$this->assertEquals(Robots::findFirst(1)->year, $robots[1] + 100);
+
+		// Dynamic update is off, all the columns are written and the records still share a statement
+		$manager->beginUnitOfWork();
+		foreach (Robots::find(array('order' => 'id')) as $robot) {
+			$robot->year = $robots[$robot->id];
+			if ($robot->id == 3) {
+				$robot->type = 'android';
+			}
+			$this->assertTrue($robot->save());
+		}
+
+		$tracer = array();
+		$this->assertTrue($manager->flush());
+		$this->assertEquals(count(preg_grep('/^UPDATE /', $tracer)), 1);
+
+		foreach ($robots as $id => $year) {
+			$this->assertEquals(Robots::findFirst($id)->year, $year);
+		}
+
+		$robot = Robots::findFirst(3);
+		$this->assertEquals($robot->type, 'android');
+		$robot->type = 'cyborg';
+		$this->assertTrue($robot->save());
+
+		// Inserts are written one by one and get their identity after the commit
+		$total = Robots::count();
+
+		$manager->beginUnitOfWork();
+
+		$inserted = array();
+		for ($i = 0; $i < 2; $i++) {
+			$robot = new Robots();
+			$robot->name = 'Deferred '.$i;
+			$robot->type = 'mechanical';
+			$robot->year = 2000 + $i;
+			$this->assertTrue($robot->save());
+			$this->assertNull($robot->id);
+			$this->assertEquals($robot->getDirtyState(), Phalcon\Mvc\Model::DIRTY_STATE_TRANSIENT);
+			$inserted[] = $robot;
+		}
+		$this->assertEquals(Robots::count(), $total);
+
+		$tracer = array();
+		$this->assertTrue($manager->flush());
+		$this->assertEquals(count(preg_grep('/^INSERT /', $tracer)), 2);
+		$this->assertEquals(Robots::count(), $total + 2);
+
+		foreach ($inserted as $robot) {
+			$this->assertTrue($robot->id > 0);
+			$this->assertEquals($robot->getDirtyState(), Phalcon\Mvc\Model::DIRTY_STATE_PERSISTENT);
+			$this->assertEquals(Robots::findFirst($robot->id)->name, $robot->name);
+			$this->assertTrue($robot->delete());
+		}
+
+		// A failed statement rolls back the whole flush and leaves the records untouched
+		$manager->beginUnitOfWork();
+
+		$updated = array();
+
+		foreach (Robots::find(array('order' => 'id')) as $robot) {
+			$robot->year = $robots[$robot->id] + 100;
+			$this->assertTrue($robot->save());
+			$updated[] = $robot;
+		}
+
+		$robot = new Robots();
+		$robot->name = 'Deferred';
+		$robot->type = 'mechanical';
+		$robot->year = 2000;
+		$this->assertTrue($robot->save());
+
+		$duplicated = new Robots();
+		$duplicated->id = 1;
+		$duplicated->name = 'Duplicated';
+		$duplicated->type = 'mechanical';
+		$duplicated->year = 2000;
+		$this->assertTrue($duplicated->save());
+
+		try {
+			$manager->flush();
+			$this->assertTrue(false);
+		} catch (Exception $e) {
+			$this->assertTrue(true);
+		}
+
+		$this->assertTrue($manager->isInUnitOfWork());
+		$manager->clearUnitOfWork();
+
+		$this->assertEquals(Robots::count(), $total);
+		foreach ($robots as $id => $year) {
+			$this->assertEquals(Robots::findFirst($id)->year, $year);
+		}
+
+		foreach ($updated as $record) {
+			$this->assertEquals($record->year, $robots[$record->id] + 100);
+		}
+
+		$this->assertNull($robot->id);
+		$this->assertEquals($robot->getDirtyState(), Phalcon\Mvc\Model::DIRTY_STATE_TRANSIENT);
+		$this->assertEquals($duplicated->getDirtyState(), Phalcon\Mvc\Model::DIRTY_STATE_TRANSIENT);
+	}
+}
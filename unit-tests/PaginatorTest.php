@@ -463,6 +463,105 @@ class PaginatorTest extends PHPUnit\Framework\TestCase
 		$this->assertEquals($bind_types, array('rawsql' => PDO::PARAM_STR , 'estado' => PDO::PARAM_STR));
 	}
 
+	public function testKeysetPaginator()
+	{
+		require 'unit-tests/config.db.php';
+		if (empty($configPostgresql)) {
+			$this->markTestSkipped('Test skipped');
+			return;
+		}
+
+		$di = $this->_loadDI();
+
+		$expected = array();
+		$rows = $di['modelsManager']->createBuilder()
+					->columns('cedula, nombres')
+					->from('Personnes')
+					->orderBy('cedula')
+					->limit(30)
+					->getQuery()
+					->execute();
+		foreach ($rows as $row) {
+			$expected[] = $row->cedula;
+		}
+
+		$builder = $di['modelsManager']->createBuilder()
+					->columns('cedula, nombres')
+					->from('Personnes');
+
+		$paginator = new Phalcon\Paginator\Adapter\Keyset(array(
+			"builder" => $builder,
+			"keys" => array("cedula"),
+			"limit"=> 10
+		));
+
+		//First page
+		$page = $paginator->getPaginate();
+
+		$this->assertEquals(get_class($page), 'stdClass');
+		$this->assertEquals(count($page->items), 10);
+		$this->assertEquals($page->items[0]->cedula, $expected[0]);
+		$this->assertEquals($page->items[9]->cedula, $expected[9]);
+		$this->assertNull($page->current);
+		$this->assertNull($page->before);
+		$this->assertNotNull($page->next);
+		$this->assertNull($page->total_items);
+
+		//Forward
+		$paginator->setCursor($page->next);
+		$page = $paginator->getPaginate();
+
+		$this->assertEquals(count($page->items), 10);
+		$this->assertEquals($page->items[0]->cedula, $expected[10]);
+		$this->assertNotNull($page->before);
+
+		$paginator->setCursor($page->next);
+		$page = $paginator->getPaginate();
+
+		$this->assertEquals($page->items[0]->cedula, $expected[20]);
+		$this->assertEquals($page->items[9]->cedula, $expected[29]);
+
+		//Backward
+		$paginator->setCursor($page->before);
+		$page = $paginator->getPaginate();
+
+		$this->assertEquals(count($page->items), 10);
+		$this->assertEquals($page->items[0]->cedula, $expected[10]);
+		$this->assertEquals($page->items[9]->cedula, $expected[19]);
+
+		$paginator->setCursor($page->before);
+		$page = $paginator->getPaginate();
+
+		$this->assertEquals($page->items[0]->cedula, $expected[0]);
+		$this->assertNull($page->before);
+		$this->assertNotNull($page->next);
+
+		//Descending keys
+		$paginator = new Phalcon\Paginator\Adapter\Keyset(array(
+			"builder" => $builder,
+			"keys" => array("cedula" => "DESC"),
+			"limit"=> 5,
+			"estimate" => true
+		));
+
+		$page = $paginator->getPaginate();
+		$this->assertEquals(count($page->items), 5);
+		$this->assertTrue($page->items[0]->cedula > $page->items[4]->cedula);
+		$this->assertTrue(is_int($page->total_items));
+
+		$paginator->setCursor($page->next);
+		$next = $paginator->getPaginate();
+		$this->assertTrue($page->items[4]->cedula > $next->items[0]->cedula);
+
+		try {
+			$paginator->setCursor('not-a-cursor');
+			$paginator->getPaginate();
+			$this->assertTrue(false);
+		} catch (Phalcon\Paginator\Exception $e) {
+			$this->assertEquals($e->getMessage(), 'The pagination cursor is not valid');
+		}
+	}
+
 	public function testSqlPaginator()
 	{
 		require 'unit-tests/config.db.php';
@@ -18,6 +18,23 @@
   +------------------------------------------------------------------------+
 */
 
+class RouterMvcTestRouter extends Phalcon\Mvc\Router
+{
+	public function attach($route)
+	{
+		$this->_routes[] = $route;
+		return $route;
+	}
+}
+
+class RouterMvcTestRoute extends Phalcon\Mvc\Router\Route
+{
+	public function getHttpMethods()
+	{
+		return 'POST';
+	}
+}
+
 class RouterMvcTest extends PHPUnit\Framework\TestCase
 {
 
@@ -360,6 +377,17 @@ class RouterMvcTest extends PHPUnit\Framework\TestCase
 		$this->assertEquals($usersAdd, $router->getRouteByName('usersAdd'));
 		$this->assertEquals($usersFind, $router->getRouteById(0));
 
+		// Missing names are answered from the lookup until a route is added or renamed
+		$this->assertFalse($router->getRouteByName('usersEdit'));
+		$usersEdit = $router->add('/api/users/edit')->setName('usersEdit');
+		$this->assertEquals($usersEdit, $router->getRouteByName('usersEdit'));
+		$usersEdit->setName('usersUpdate');
+		$this->assertFalse($router->getRouteByName('usersEdit'));
+		$this->assertEquals($usersEdit, $router->getRouteByName('usersUpdate'));
+
+		// The first route added with a name wins
+		$router->add('/api/users/create')->setName('usersAdd');
+		$this->assertEquals($usersAdd, $router->getRouteByName('usersAdd'));
 	}
 
 	public function testExtraSlashes()
@@ -1037,4 +1065,126 @@ class RouterMvcTest extends PHPUnit\Framework\TestCase
 			$this->assertEquals($router->getActionName(), $paths['action']);
 		}
 	}
+
+	public function testRoutesIndex()
+	{
+		Phalcon\Mvc\Router\Route::reset();
+
+		$router = new Phalcon\Mvc\Router(false);
+
+		for ($i = 0; $i < 500; $i++) {
+			$router->add('/section'.$i.'/{id:[0-9]+}', array(
+				'controller' => 'section'.$i,
+				'action' => 'show',
+			));
+		}
+
+		$router->add('/about', 'About::index');
+		$router->add('/About/team', 'About::team');
+		$router->add('#^/(about|team)/([0-9]+)$#', array(
+			'controller' => 1,
+			'action' => 'number',
+		));
+
+		$this->assertTrue($router->handle('/section250/10'));
+		$this->assertEquals($router->getControllerName(), 'section250');
+		$this->assertEquals($router->getParams(), array('id' => '10'));
+
+		$this->assertFalse($router->handle('/section250/abc'));
+
+		$this->assertTrue($router->handle('/about'));
+		$this->assertEquals($router->getControllerName(), 'about');
+		$this->assertEquals($router->getActionName(), 'index');
+
+		$this->assertTrue($router->handle('/About/team'));
+		$this->assertEquals($router->getActionName(), 'team');
+
+		$this->assertTrue($router->handle('/team/5'));
+		$this->assertEquals($router->getControllerName(), 'team');
+		$this->assertEquals($router->getActionName(), 'number');
+
+		// The most recently added route still wins
+		$router->add('/section250/{id:[0-9]+}', array(
+			'controller' => 'override',
+			'action' => 'show',
+		));
+
+		$this->assertTrue($router->handle('/section250/10'));
+		$this->assertEquals($router->getControllerName(), 'override');
+
+		// Changing a route already indexed moves it to its new bucket
+		$contact = $router->add('/contact', 'Contact::index');
+		$this->assertTrue($router->handle('/contact'));
+		$contact->reConfigure('/reach-us', 'Contact::index');
+		$this->assertFalse($router->handle('/contact'));
+		$this->assertTrue($router->handle('/reach-us'));
+		$this->assertEquals($router->getControllerName(), 'contact');
+
+		$router->clear();
+		$this->assertFalse($router->handle('/section250/10'));
+
+		// Routes of other classes are matched through their getters
+		$router = new RouterMvcTestRouter(false);
+		$router->attach(new RouterMvcTestRoute('/posted', 'Posted::index'));
+		$_SERVER['REQUEST_METHOD'] = 'GET';
+		$this->assertFalse($router->handle('/posted'));
+		$_SERVER['REQUEST_METHOD'] = 'POST';
+		$this->assertTrue($router->handle('/posted'));
+		$this->assertEquals($router->getControllerName(), 'posted');
+		unset($_SERVER['REQUEST_METHOD']);
+	}
+
+	public function testExportRoutes()
+	{
+		Phalcon\Mvc\Router\Route::reset();
+
+		$router = new Phalcon\Mvc\Router(false);
+		$router->add('/about', 'About::index')->setName('about');
+		$router->add('/about-us', 'About::index')->setName('about');
+		$router->add('/blog/{year}/{title}', array(
+			'controller' => 'blog',
+			'action' => 'show',
+		))->via('GET');
+		$router->notFound(array('controller' => 'errors', 'action' => 'show404'));
+
+		$image = $router->exportRoutes();
+		$this->assertTrue(is_array($image));
+		$this->assertEquals(count($image['routes']), 3);
+
+		$restored = new Phalcon\Mvc\Router(false);
+		$restored->importRoutes($image);
+
+		$this->assertEquals(count($restored->getRoutes()), 3);
+		$this->assertEquals($restored->getRouteByName('about')->getPattern(), '/about');
+		$this->assertEquals($router->getRouteByName('about')->getPattern(), '/about');
+
+		$_SERVER['REQUEST_METHOD'] = 'GET';
+		$this->assertTrue($restored->handle('/blog/2014/hello'));
+		$this->assertEquals($restored->getControllerName(), 'blog');
+		$this->assertEquals($restored->getParams(), array('year' => '2014', 'title' => 'hello'));
+
+		$restored->handle('/missing');
+		$this->assertEquals($restored->getControllerName(), 'errors');
+
+		$route = $restored->add('/contact', 'Contact::index');
+		$this->assertTrue($route->getRouteId() > 1);
+
+		$cache = new Phalcon\Cache\Backend\Memory(new Phalcon\Cache\Frontend\Data());
+
+		$calls = 0;
+		$builder = function ($router) use (&$calls) {
+			$calls++;
+			$router->add('/about', 'About::index');
+		};
+
+		$router = new Phalcon\Mvc\Router(false);
+		$this->assertFalse($router->useCache('v1', $builder, $cache));
+
+		$router = new Phalcon\Mvc\Router(false);
+		$this->assertTrue($router->useCache('v1', $builder, $cache));
+		$this->assertEquals($calls, 1);
+
+		$this->assertTrue($router->handle('/about'));
+		$this->assertEquals($router->getControllerName(), 'about');
+	}
 }
@@ -46,4 +46,38 @@ class UrlTest extends PHPUnit\Framework\TestCase
 		$url = $di->url->get(array('for' => 'test', 'hostname' => true, 'controller' => 'index', 'action' => 'test'));
 		$this->assertEquals($url, 'phalconphp.com/index/test');
 	}
+
+	public function testGetMultiple()
+	{
+		Phalcon\Di::reset();
+
+		$di = new Phalcon\Di();
+
+		$di['router'] = function() {
+			$router = new \Phalcon\Mvc\Router(FALSE);
+			$router->add('/blog/{year}/{title}', 'Blog::show')->setName('blog-post');
+			return $router;
+		};
+
+		$di->set('url', function(){
+			$url = new Phalcon\Mvc\Url();
+			$url->setBaseUri('/');
+			return $url;
+		});
+
+		$route = $di->router->getRouteByName('blog-post');
+		$this->assertEquals($route->getReversedTemplate(), array('blog/', 'year', '/', 'title', ''));
+
+		$url = $di->url->get(array('for' => 'blog-post', 'year' => 2012, 'title' => 'some-cool-stuff'));
+		$this->assertEquals($url, '/blog/2012/some-cool-stuff');
+
+		$urls = $di->url->getMultiple(array('for' => 'blog-post', 'year' => 2012), array(
+			'first' => array('title' => 'some-cool-stuff'),
+			'second' => array('year' => 2013, 'title' => 'other-cool-stuff'),
+		));
+		$this->assertEquals($urls, array(
+			'first' => '/blog/2012/some-cool-stuff',
+			'second' => '/blog/2013/other-cool-stuff',
+		));
+	}
 }